@@ -88,13 +88,32 @@ insert_zfs(EFI_HANDLE handle, uint64_t guid)
         STAILQ_INSERT_TAIL(&zfsinfo, zi, zi_link);
 }
 
+static void
+efi_zfs_probe_disk(pdinfo_t *hd)
+{
+	pdinfo_t *pd;
+	char devname[SPECNAMELEN + 1];
+	uint64_t guid;
+
+	STAILQ_FOREACH(pd, &hd->pd_part, pd_link) {
+
+		snprintf(devname, sizeof(devname), "%s%dp%d:",
+		    efipart_hddev.dv_name, hd->pd_unit, pd->pd_unit);
+
+		if (zfs_probe_dev(devname, &guid) == 0) {
+			insert_zfs(pd->pd_handle, guid);
+
+			if (efi_zfs_is_preferred(pd->pd_handle))
+				pool_guid = guid;
+		}
+	}
+}
+
 void
 efi_zfs_probe(void)
 {
 	pdinfo_list_t *hdi;
-	pdinfo_t *hd, *pd = NULL;
-	char devname[SPECNAMELEN + 1];
-        uint64_t guid;
+	pdinfo_t *hd, *pd, *boot_disk = NULL;
 
 	hdi = efiblk_get_pdinfo_list(&efipart_hddev);
 	STAILQ_INIT(&zfsinfo);
@@ -104,20 +123,35 @@ efi_zfs_probe(void)
 	 * device with loader binary, now we need to search for the
 	 * same device and if it is part of the zfs pool, we record the
 	 * pool GUID for currdev setup.
+	 *
+	 * Tasting a pool label means reading all four copies of it, so
+	 * probing every partition of a large disk shelf is slow.  The
+	 * firmware already tells us which disk we were booted from, so
+	 * taste that disk first; with the boot pool identified, the
+	 * loader environment variable zfs_probe_bootdisk_only (settable
+	 * from the command line or iPXE) may be used to skip the rest
+	 * of the disks entirely.  That scan only discovers additional
+	 * pools, which a root pool confined to the boot disk does not
+	 * need.
 	 */
 	STAILQ_FOREACH(hd, hdi, pd_link) {
 		STAILQ_FOREACH(pd, &hd->pd_part, pd_link) {
+			if (efi_zfs_is_preferred(pd->pd_handle)) {
+				boot_disk = hd;
+				break;
+			}
+		}
+		if (boot_disk != NULL)
+			break;
+	}
+	if (boot_disk != NULL)
+		efi_zfs_probe_disk(boot_disk);
 
-			snprintf(devname, sizeof(devname), "%s%dp%d:",
-			    efipart_hddev.dv_name, hd->pd_unit, pd->pd_unit);
-
-                        if (zfs_probe_dev(devname, &guid) == 0) {
-                                insert_zfs(pd->pd_handle, guid);
-
-                                if (efi_zfs_is_preferred(pd->pd_handle))
-                                        pool_guid = guid;
-                        }
+	if (pool_guid != 0 && getenv("zfs_probe_bootdisk_only") != NULL)
+		return;
 
-		}
+	STAILQ_FOREACH(hd, hdi, pd_link) {
+		if (hd != boot_disk)
+			efi_zfs_probe_disk(hd);
 	}
 }
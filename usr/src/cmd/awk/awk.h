@@ -126,6 +126,7 @@ typedef struct Cell {
 		/* type info: STR|NUM|ARR|FCN|FLD|CON|DONTFREE|CONVC|CONVO */
 	char	*fmt;
 		/* CONVFMT/OFMT value used to convert from number */
+	unsigned int chash;	/* hash of nval, set when entered in a table */
 	struct Cell *cnext;	/* ptr to next if chained */
 } Cell;
 
@@ -376,7 +377,7 @@ extern	void	envinit(char **);
 extern	void	freesymtab(Cell *);
 extern	void	freeelem(Cell *, const char *);
 extern	void	funnyvar(Cell *, const char *);
-extern	int	hash(const char *, int);
+extern	unsigned int	hash(const char *);
 extern	Awkfloat *ARGC;
 
 /* run.c */
@@ -260,13 +260,15 @@ freeelem(Cell *ap, const char *s)	/* free elem s from ap (i.e., ap["s"] */
 {
 	Array *tp;
 	Cell *p, *prev = NULL;
+	unsigned int fh;
 	int h;
 
 	/*LINTED align*/
 	tp = (Array *)ap->sval;
-	h = hash(s, tp->size);
+	fh = hash(s);
+	h = fh % tp->size;
 	for (p = tp->tab[h]; p != NULL; prev = p, p = p->cnext)
-		if (strcmp(s, p->nval) == 0) {
+		if (p->chash == fh && strcmp(s, p->nval) == 0) {
 			if (prev == NULL)	/* 1st one */
 				tp->tab[h] = p->cnext;
 			else			/* middle somewhere */
@@ -300,10 +302,11 @@ setsymtab(const char *n, const char *s, Awkfloat f, unsigned int t, Array *tp)
 	p->tval = t;
 	p->csub = CUNK;
 	p->ctype = OCELL;
+	p->chash = hash(n);
 	tp->nelem++;
 	if (tp->nelem > FULLTAB * tp->size)
 		rehash(tp);
-	h = hash(n, tp->size);
+	h = p->chash % tp->size;
 	p->cnext = tp->tab[h];
 	tp->tab[h] = p;
 	dprintf(("setsymtab set %p: n=%s s=\"%s\" f=%g t=%o\n",
@@ -311,14 +314,14 @@ setsymtab(const char *n, const char *s, Awkfloat f, unsigned int t, Array *tp)
 	return (p);
 }
 
-int
-hash(const char *s, int n)	/* form hash value for string s */
+unsigned int
+hash(const char *s)	/* form full hash value for string s */
 {
 	unsigned int hashval;
 
 	for (hashval = 0; *s != '\0'; s++)
 		hashval = (*s + 31 * hashval);
-	return (hashval % n);
+	return (hashval);
 }
 
 static void
@@ -334,7 +337,7 @@ rehash(Array *tp)	/* rehash items in small table into big one */
 	for (i = 0; i < tp->size; i++) {
 		for (cp = tp->tab[i]; cp != NULL; cp = op) {
 			op = cp->cnext;
-			nh = hash(cp->nval, nsz);
+			nh = cp->chash % nsz;
 			cp->cnext = np[nh];
 			np[nh] = cp;
 		}
@@ -348,11 +351,17 @@ Cell *
 lookup(const char *s, Array *tp)	/* look for s in tp */
 {
 	Cell *p;
+	unsigned int fh;
 	int h;
 
-	h = hash(s, tp->size);
+	/*
+	 * Each cell carries the full hash of its name, so collisions within
+	 * a chain are rejected without walking the strings.
+	 */
+	fh = hash(s);
+	h = fh % tp->size;
 	for (p = tp->tab[h]; p != NULL; p = p->cnext) {
-		if (strcmp(s, p->nval) == 0)
+		if (p->chash == fh && strcmp(s, p->nval) == 0)
 			return (p);	/* found it */
 	}
 	return (NULL);			/* not found */
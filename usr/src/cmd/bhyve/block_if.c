@@ -83,7 +83,13 @@ __FBSDID("$FreeBSD$");
 /* Enlarge to keep pace with the virtio-block ring size */
 #define BLOCKIF_NUMTHR	16
 #endif
-#define BLOCKIF_MAXREQ	(BLOCKIF_RING_MAX + BLOCKIF_NUMTHR)
+/*
+ * The worker pool servicing a device can be deepened (up to BLOCKIF_MAXTHR)
+ * via the "threads" option, so that guests issuing many concurrent I/Os can
+ * keep a comparable number of requests in flight against the backing store.
+ */
+#define BLOCKIF_MAXTHR	128
+#define BLOCKIF_MAXREQ	(BLOCKIF_RING_MAX + BLOCKIF_MAXTHR)
 
 enum blockop {
 	BOP_READ,
@@ -135,7 +141,8 @@ struct blockif_ctxt {
 	int			bc_psectsz;
 	int			bc_psectoff;
 	int			bc_closing;
-	pthread_t		bc_btid[BLOCKIF_NUMTHR];
+	int			bc_nthr;
+	pthread_t		bc_btid[BLOCKIF_MAXTHR];
 	pthread_mutex_t		bc_mtx;
 	pthread_cond_t		bc_cond;
 	blockif_resize_cb	*bc_resize_cb;
@@ -559,6 +566,7 @@ blockif_open(nvlist_t *nvl, const char *ident)
 	int extra, fd, i, sectsz;
 	int ro, candelete, geom, ssopt, pssopt;
 	int nodelete;
+	int nthr;
 
 #ifndef WITHOUT_CAPSICUM
 	cap_rights_t rights;
@@ -575,6 +583,7 @@ blockif_open(nvlist_t *nvl, const char *ident)
 #endif
 	ro = 0;
 	nodelete = 0;
+	nthr = BLOCKIF_NUMTHR;
 
 	if (get_config_bool_node_default(nvl, "nocache", false))
 		extra |= O_DIRECT;
@@ -607,6 +616,16 @@ blockif_open(nvlist_t *nvl, const char *ident)
 		}
 	}
 
+	ssval = get_config_value_node(nvl, "threads");
+	if (ssval != NULL) {
+		nthr = strtol(ssval, &cp, 10);
+		if (cp == ssval || *cp != '\0' || nthr < 1 ||
+		    nthr > BLOCKIF_MAXTHR) {
+			EPRINTLN("Invalid thread count \"%s\"", ssval);
+			goto err;
+		}
+	}
+
 	path = get_config_value_node(nvl, "path");
 	if (path == NULL) {
 		EPRINTLN("Missing \"path\" for block device.");
@@ -794,6 +813,7 @@ blockif_open(nvlist_t *nvl, const char *ident)
 	bc->bc_wce = wce;
 #endif
 	bc->bc_rdonly = ro;
+	bc->bc_nthr = nthr;
 	bc->bc_size = size;
 	bc->bc_sectsz = sectsz;
 	bc->bc_psectsz = psectsz;
@@ -808,7 +828,7 @@ blockif_open(nvlist_t *nvl, const char *ident)
 		TAILQ_INSERT_HEAD(&bc->bc_freeq, &bc->bc_reqs[i], be_link);
 	}
 
-	for (i = 0; i < BLOCKIF_NUMTHR; i++) {
+	for (i = 0; i < bc->bc_nthr; i++) {
 		pthread_create(&bc->bc_btid[i], NULL, blockif_thr, bc);
 		snprintf(tname, sizeof(tname), "blk-%s-%d", ident, i);
 		pthread_set_name_np(bc->bc_btid[i], tname);
@@ -1051,7 +1071,7 @@ blockif_close(struct blockif_ctxt *bc)
 		mevent_disable(bc->bc_resize_event);
 	pthread_mutex_unlock(&bc->bc_mtx);
 	pthread_cond_broadcast(&bc->bc_cond);
-	for (i = 0; i < BLOCKIF_NUMTHR; i++)
+	for (i = 0; i < bc->bc_nthr; i++)
 		pthread_join(bc->bc_btid[i], &jval);
 
 	/* XXX Cancel queued i/o's ??? */
@@ -47,6 +47,7 @@
 
 #include <errno.h>
 #include <fcntl.h>
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
@@ -120,6 +121,7 @@ struct pci_viona_softc {
 	char		vsc_linkname[MAXLINKNAMELEN];
 	uint32_t	vsc_feature_mask;
 	uint16_t	vsc_vq_size;
+	int		vsc_cpu_affinity[VIONA_MAXQ];
 
 	uint32_t	vsc_features;
 	uint8_t		vsc_macaddr[6];
@@ -277,6 +279,20 @@ pci_viona_ring_init(struct pci_viona_softc *sc, uint64_t pfn)
 
 	if (error != 0) {
 		WPRINTF(("ioctl viona ring %u init failed %d\n", qnum, errno));
+		return;
+	}
+
+	if (sc->vsc_cpu_affinity[qnum] != -1) {
+		vioc_ring_affinity_t vra = {
+			.ra_index = qnum,
+			.ra_cpuid = sc->vsc_cpu_affinity[qnum],
+		};
+
+		error = ioctl(sc->vsc_vnafd, VNA_IOC_RING_SET_AFFINITY, &vra);
+		if (error != 0) {
+			WPRINTF(("ioctl viona ring %u affinity failed %d\n",
+			    qnum, errno));
+		}
 	}
 }
 
@@ -329,12 +345,17 @@ pci_viona_legacy_config(nvlist_t *nvl, const char *opt)
 static int
 pci_viona_parse_opts(struct pci_viona_softc *sc, nvlist_t *nvl)
 {
+	static const char *cpu_opts[] = { "rx_cpu", "tx_cpu" };
 	const char *value;
 	int err = 0;
+	uint_t i;
 
 	sc->vsc_vq_size = VIONA_RINGSZ;
 	sc->vsc_feature_mask = 0;
 	sc->vsc_linkname[0] = '\0';
+	for (i = 0; i < VIONA_MAXQ; i++) {
+		sc->vsc_cpu_affinity[i] = -1;
+	}
 
 	value = get_config_value_node(nvl, "feature_mask");
 	if (value != NULL) {
@@ -373,6 +394,24 @@ pci_viona_parse_opts(struct pci_viona_softc *sc, nvlist_t *nvl)
 		}
 	}
 
+	for (i = 0; i < nitems(cpu_opts); i++) {
+		value = get_config_value_node(nvl, cpu_opts[i]);
+		if (value != NULL) {
+			long num;
+
+			errno = 0;
+			num = strtol(value, NULL, 0);
+			if (errno != 0 || num < 0 || num > INT_MAX) {
+				fprintf(stderr,
+				    "viona: invalid %s '%s'", cpu_opts[i],
+				    value);
+				err = -1;
+			} else {
+				sc->vsc_cpu_affinity[i] = (int)num;
+			}
+		}
+	}
+
 	value = get_config_value_node(nvl, "vnic");
 	if (value == NULL) {
 		fprintf(stderr, "viona: vnic name required");
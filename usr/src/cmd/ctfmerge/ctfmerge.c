@@ -45,6 +45,7 @@ static uint_t g_nctf;
 #define	CTFMERGE_USAGE	2
 
 #define	CTFMERGE_DEFAULT_NTHREADS	8
+#define	CTFMERGE_MAX_NTHREADS		1024
 
 static void __attribute__((__noreturn__))
 ctfmerge_fatal(const char *fmt, ...)
@@ -321,11 +322,24 @@ main(int argc, char *argv[])
 	uint_t flags = 0;
 	ctf_merge_t *cmh;
 	ctf_file_t *ofp;
-	long argj;
+	long argj, onln;
 	char *eptr;
 
 	g_progname = basename(argv[0]);
 
+	/*
+	 * The merge is a pairwise tree performed by a pool of worker threads
+	 * (see lib/mergeq).  Size the pool to the machine by default so that
+	 * full-gate builds, which generally don't pass -j, get the benefit of
+	 * large build hosts; -j still overrides.
+	 */
+	onln = sysconf(_SC_NPROCESSORS_ONLN);
+	if (onln > CTFMERGE_MAX_NTHREADS) {
+		nthreads = CTFMERGE_MAX_NTHREADS;
+	} else if (onln > 0) {
+		nthreads = (uint_t)onln;
+	}
+
 	/*
 	 * We support a subset of the old CTF merge flags, mostly for
 	 * compatibility.
@@ -345,7 +359,7 @@ main(int argc, char *argv[])
 			errno = 0;
 			argj = strtol(optarg, &eptr, 10);
 			if (errno != 0 || argj == LONG_MAX ||
-			    argj > 1024 || *eptr != '\0') {
+			    argj > CTFMERGE_MAX_NTHREADS || *eptr != '\0') {
 				ctfmerge_fatal("invalid argument for -j: %s\n",
 				    optarg);
 			}
@@ -505,6 +505,63 @@ dlmgmt_getnext(void *argp, void *retp, size_t *sz, zoneid_t zoneid,
 	retvalp->lr_err = err;
 }
 
+/*
+ * The batched variant of dlmgmt_getnext().  Fill the return buffer with up
+ * to ld_maxlinks links starting after ld_linkid so that a walk of the whole
+ * repository costs one door call per DLMGMT_GETNEXTMANY_NLINKS links rather
+ * than one per link.  The link name is included so that the libdladm walk
+ * can also satisfy name lookups without additional DLMGMT_CMD_GETNAME calls.
+ */
+/* ARGSUSED */
+static void
+dlmgmt_getnextmany(void *argp, void *retp, size_t *sz, zoneid_t zoneid,
+    ucred_t *cred)
+{
+	dlmgmt_door_getnextmany_t	*getnext = argp;
+	dlmgmt_getnextmany_retval_t	*retvalp = retp;
+	dlmgmt_link_t			link, *linkp;
+	dlmgmt_getnextmany_link_t	*lep;
+	avl_index_t			where;
+	uint_t				maxlinks, nlinks = 0;
+
+	maxlinks = getnext->ld_maxlinks;
+	if (maxlinks > DLMGMT_GETNEXTMANY_NLINKS)
+		maxlinks = DLMGMT_GETNEXTMANY_NLINKS;
+
+	/*
+	 * Hold the reader lock to access the link
+	 */
+	dlmgmt_table_lock(B_FALSE);
+
+	link.ll_linkid = (getnext->ld_linkid + 1);
+	if ((linkp = avl_find(&dlmgmt_id_avl, &link, &where)) == NULL)
+		linkp = avl_nearest(&dlmgmt_id_avl, where, AVL_AFTER);
+
+	for (; linkp != NULL && nlinks < maxlinks;
+	    linkp = AVL_NEXT(&dlmgmt_id_avl, linkp)) {
+		if (!link_is_visible(linkp, zoneid))
+			continue;
+		if (!(linkp->ll_class & getnext->ld_class) ||
+		    !(linkp->ll_flags & getnext->ld_flags) ||
+		    !DATALINK_MEDIA_ACCEPTED(getnext->ld_dmedia,
+		    linkp->ll_media))
+			continue;
+
+		lep = &retvalp->lr_links[nlinks++];
+		lep->le_linkid = linkp->ll_linkid;
+		lep->le_class = linkp->ll_class;
+		lep->le_media = linkp->ll_media;
+		lep->le_flags = linkp->ll_flags;
+		(void) strlcpy(lep->le_link, linkp->ll_link,
+		    sizeof (lep->le_link));
+	}
+
+	dlmgmt_table_unlock();
+
+	retvalp->lr_nlinks = nlinks;
+	retvalp->lr_err = (nlinks == 0) ? ENOENT : 0;
+}
+
 /* ARGSUSED */
 static void
 dlmgmt_upcall_getattr(void *argp, void *retp, size_t *sz, zoneid_t zoneid,
@@ -1374,6 +1431,8 @@ static dlmgmt_door_info_t i_dlmgmt_door_info_tbl[] = {
 	    sizeof (dlmgmt_zoneboot_retval_t), dlmgmt_zoneboot },
 	{ DLMGMT_CMD_ZONEHALT, sizeof (dlmgmt_door_zonehalt_t),
 	    sizeof (dlmgmt_zonehalt_retval_t), dlmgmt_zonehalt },
+	{ DLMGMT_CMD_GETNEXTMANY, sizeof (dlmgmt_door_getnextmany_t),
+	    sizeof (dlmgmt_getnextmany_retval_t), dlmgmt_getnextmany },
 	{ 0, 0, 0, NULL }
 };
 
@@ -209,6 +209,52 @@ static stacks_entry_t **stacks_hash;
 static stacks_entry_t **stacks_array;
 static size_t stacks_array_size;
 
+#define	STACKS_SYM_HSIZE	511
+
+typedef struct stacks_sym {
+	struct stacks_sym	*ss_next;
+	uintptr_t		ss_addr;
+	char			ss_name[1];	/* empty: lookup failed */
+} stacks_sym_t;
+#define	STACKS_SYM_SIZE(x)	OFFSETOF(stacks_sym_t, ss_name[(x) + 1])
+
+/* only set while stacks_run() is sorting; entries are UM_GC'd */
+static stacks_sym_t **stacks_sym_hash;
+
+/*
+ * Memoized mdb_lookup_by_addr().  Sorting the final array compares
+ * stacks frame by frame by symbol name, so the same PCs are resolved
+ * many times over, and each miss walks the symbol table of every
+ * loaded module.  Cache the result of each resolution (including
+ * failures) for the duration of the sort.  Returns NULL if the address
+ * does not resolve to a symbol.
+ */
+static const char *
+stacks_sym_lookup(uintptr_t addr)
+{
+	stacks_sym_t **ssp, *ss;
+	char buf[MDB_SYM_NAMLEN];
+	size_t len;
+
+	for (ssp = &stacks_sym_hash[(addr >> 2) % STACKS_SYM_HSIZE];
+	    (ss = *ssp) != NULL; ssp = &ss->ss_next) {
+		if (ss->ss_addr == addr)
+			return (ss->ss_name[0] != '\0' ? ss->ss_name : NULL);
+	}
+
+	if (mdb_lookup_by_addr(addr, MDB_SYM_FUZZY, buf, sizeof (buf),
+	    NULL) == -1)
+		buf[0] = '\0';
+
+	len = strlen(buf);
+	ss = mdb_zalloc(STACKS_SYM_SIZE(len), UM_SLEEP | UM_GC);
+	ss->ss_addr = addr;
+	bcopy(buf, ss->ss_name, len + 1);
+	*ssp = ss;
+
+	return (ss->ss_name[0] != '\0' ? ss->ss_name : NULL);
+}
+
 static size_t
 stacks_hash_entry(stacks_entry_t *sep)
 {
@@ -269,9 +315,6 @@ stacks_entry_comp_impl(stacks_entry_t *l, stacks_entry_t *r,
 		return (-1);
 
 	for (idx = 0; idx < depth; idx++) {
-		char lbuf[MDB_SYM_NAMLEN];
-		char rbuf[MDB_SYM_NAMLEN];
-
 		int rval;
 		uintptr_t laddr = l->se_stack[idx];
 		uintptr_t raddr = r->se_stack[idx];
@@ -279,13 +322,14 @@ stacks_entry_comp_impl(stacks_entry_t *l, stacks_entry_t *r,
 		if (laddr == raddr)
 			continue;
 
-		if (forsort &&
-		    mdb_lookup_by_addr(laddr, MDB_SYM_FUZZY,
-		    lbuf, sizeof (lbuf), NULL) != -1 &&
-		    mdb_lookup_by_addr(raddr, MDB_SYM_FUZZY,
-		    rbuf, sizeof (rbuf), NULL) != -1 &&
-		    (rval = strcmp(lbuf, rbuf)) != 0)
-			return (rval);
+		if (forsort) {
+			const char *lname = stacks_sym_lookup(laddr);
+			const char *rname = stacks_sym_lookup(raddr);
+
+			if (lname != NULL && rname != NULL &&
+			    (rval = strcmp(lname, rname)) != 0)
+				return (rval);
+		}
 
 		if (laddr > raddr)
 			return (1);
@@ -511,8 +555,17 @@ stacks_run(int verbose, mdb_pipe_t *tlist)
 		    (cur - stacks_array), stacks_array_size);
 		return (DCMD_ERR);
 	}
+	/*
+	 * The sort comparator resolves frame PCs to symbol names; give
+	 * it a memoization table for the duration of the sort.  The
+	 * table and its entries are garbage-collected when the dcmd
+	 * completes, so an interrupted qsort() leaks nothing.
+	 */
+	stacks_sym_hash = mdb_zalloc(STACKS_SYM_HSIZE *
+	    sizeof (*stacks_sym_hash), UM_SLEEP | UM_GC);
 	qsort(stacks_array, si.si_entries, sizeof (*stacks_array),
 	    stacks_entry_comp);
+	stacks_sym_hash = NULL;
 
 	/* Now that we're done, free the hash table */
 	stacks_hash = NULL;
@@ -2217,6 +2217,7 @@ kmastat_cache(uintptr_t addr, const kmem_cache_t *cp, kmastat_args_t *kap)
 	kmastat_vmem_t *kv;
 	datafmt_t *dfp = kmemfmt;
 	int magsize;
+	int lgrp;
 
 	int avail, alloc, total;
 	size_t meminuse = (cp->cache_slab_create - cp->cache_slab_destroy) *
@@ -2228,8 +2229,12 @@ kmastat_cache(uintptr_t addr, const kmem_cache_t *cp, kmastat_args_t *kap)
 
 	magsize = kmem_get_magsize(cp);
 
-	alloc = cp->cache_slab_alloc + cp->cache_full.ml_alloc;
-	avail = cp->cache_full.ml_total * magsize;
+	alloc = cp->cache_slab_alloc;
+	avail = 0;
+	for (lgrp = 0; lgrp < NLGRPS_MAX; lgrp++) {
+		alloc += cp->cache_full[lgrp].ml_alloc;
+		avail += cp->cache_full[lgrp].ml_total * magsize;
+	}
 	total = cp->cache_buftotal;
 
 	(void) mdb_pwalk("kmem_cpu_cache", cpu_alloc, &alloc, addr);
@@ -771,13 +771,88 @@ bufctlcmp(const kmem_bufctl_audit_t **lhs, const kmem_bufctl_audit_t **rhs)
 	return (0);
 }
 
+/*
+ * The hash walker visits one bufctl per allocated buffer, and the bufctl
+ * chains lead all over the bufctl caches.  Reading them one at a time is
+ * ruinous against a crash dump, where every mdb_vread() is a seek into the
+ * dump file, so we fetch them in rounds: all of the outstanding chain
+ * pointers are sorted and then read in large address-ordered windows, each
+ * window satisfying every bufctl that falls inside it with a single read.
+ * Since bufctls are densely packed in their own caches, a window typically
+ * covers hundreds of them.  Each round's bufctls yield the chain pointers
+ * for the next round, and a round can never be larger than its predecessor,
+ * so the arrays are sized once, from the number of non-empty buckets.
+ */
+#define	KMEM_HASH_WINDOW	(32 * 1024)
+
 typedef struct kmem_hash_walk {
-	uintptr_t *kmhw_table;
-	size_t kmhw_nelems;
-	size_t kmhw_pos;
-	kmem_bufctl_t kmhw_cur;
+	uintptr_t *kmhw_addrs;		/* bufctl addresses in this round */
+	kmem_bufctl_t *kmhw_bufs;	/* bufctl contents, same order */
+	size_t kmhw_max;		/* capacity of the round arrays */
+	size_t kmhw_cnt;		/* bufctls fetched this round */
+	size_t kmhw_pos;		/* next bufctl to hand out */
+	uintptr_t *kmhw_pend;		/* chain pointers for next round */
+	size_t kmhw_npend;
+	char *kmhw_win;			/* bulk read buffer */
 } kmem_hash_walk_t;
 
+static int
+kmem_hash_walk_fetch(kmem_hash_walk_t *kmhw)
+{
+	uintptr_t *addrs, *tmp;
+	size_t n = kmhw->kmhw_npend;
+	size_t i, j;
+
+	tmp = kmhw->kmhw_addrs;
+	kmhw->kmhw_addrs = kmhw->kmhw_pend;
+	kmhw->kmhw_pend = tmp;
+	addrs = kmhw->kmhw_addrs;
+
+	qsort(addrs, n, sizeof (uintptr_t), addrcmp);
+
+	for (i = 0; i < n; i = j) {
+		uintptr_t base = addrs[i];
+		size_t len;
+
+		for (j = i + 1; j < n; j++) {
+			if (addrs[j] - base > KMEM_HASH_WINDOW)
+				break;
+		}
+
+		len = (addrs[j - 1] - base) + sizeof (kmem_bufctl_t);
+
+		if (mdb_vread(kmhw->kmhw_win, len, base) != -1) {
+			size_t k;
+
+			for (k = i; k < j; k++) {
+				bcopy(kmhw->kmhw_win + (addrs[k] - base),
+				    &kmhw->kmhw_bufs[k],
+				    sizeof (kmem_bufctl_t));
+			}
+			continue;
+		}
+
+		/*
+		 * The window straddled something unreadable; fall back to
+		 * reading this window's bufctls individually.
+		 */
+		for (; i < j; i++) {
+			if (mdb_vread(&kmhw->kmhw_bufs[i],
+			    sizeof (kmem_bufctl_t), addrs[i]) == -1) {
+				mdb_warn("couldn't read kmem_bufctl_t at "
+				    "addr %p", addrs[i]);
+				return (WALK_ERR);
+			}
+		}
+	}
+
+	kmhw->kmhw_cnt = n;
+	kmhw->kmhw_pos = 0;
+	kmhw->kmhw_npend = 0;
+
+	return (WALK_NEXT);
+}
+
 int
 kmem_hash_walk_init(mdb_walk_state_t *wsp)
 {
@@ -787,6 +862,7 @@ kmem_hash_walk_init(mdb_walk_state_t *wsp)
 	uintptr_t haddr, addr = wsp->walk_addr;
 	size_t nelems;
 	size_t hsize;
+	size_t i;
 
 	if (addr == 0) {
 		mdb_warn("kmem_hash doesn't support global walks\n");
@@ -803,22 +879,46 @@ kmem_hash_walk_init(mdb_walk_state_t *wsp)
 		return (WALK_DONE);		/* nothing to do */
 	}
 
-	kmhw = mdb_zalloc(sizeof (kmem_hash_walk_t), UM_SLEEP);
-	kmhw->kmhw_cur.bc_next = NULL;
-	kmhw->kmhw_pos = 0;
-
-	kmhw->kmhw_nelems = nelems = c.cache_hash_mask + 1;
+	nelems = c.cache_hash_mask + 1;
 	hsize = nelems * sizeof (uintptr_t);
 	haddr = (uintptr_t)c.cache_hash_table;
 
-	kmhw->kmhw_table = hash = mdb_alloc(hsize, UM_SLEEP);
+	hash = mdb_alloc(hsize, UM_SLEEP);
 	if (mdb_vread(hash, hsize, haddr) == -1) {
 		mdb_warn("failed to read hash table at %p", haddr);
 		mdb_free(hash, hsize);
-		mdb_free(kmhw, sizeof (kmem_hash_walk_t));
 		return (WALK_ERR);
 	}
 
+	kmhw = mdb_zalloc(sizeof (kmem_hash_walk_t), UM_SLEEP);
+
+	/*
+	 * Seed the first round with the non-empty bucket heads; no later
+	 * round can have more entries than this one.
+	 */
+	for (i = 0; i < nelems; i++) {
+		if (hash[i] != 0)
+			kmhw->kmhw_max++;
+	}
+
+	if (kmhw->kmhw_max != 0) {
+		kmhw->kmhw_addrs = mdb_alloc(kmhw->kmhw_max *
+		    sizeof (uintptr_t), UM_SLEEP);
+		kmhw->kmhw_pend = mdb_alloc(kmhw->kmhw_max *
+		    sizeof (uintptr_t), UM_SLEEP);
+		kmhw->kmhw_bufs = mdb_alloc(kmhw->kmhw_max *
+		    sizeof (kmem_bufctl_t), UM_SLEEP);
+		kmhw->kmhw_win = mdb_alloc(KMEM_HASH_WINDOW +
+		    sizeof (kmem_bufctl_t), UM_SLEEP);
+
+		for (i = 0; i < nelems; i++) {
+			if (hash[i] != 0)
+				kmhw->kmhw_pend[kmhw->kmhw_npend++] = hash[i];
+		}
+	}
+
+	mdb_free(hash, hsize);
+
 	wsp->walk_data = kmhw;
 
 	return (WALK_NEXT);
@@ -828,23 +928,24 @@ int
 kmem_hash_walk_step(mdb_walk_state_t *wsp)
 {
 	kmem_hash_walk_t *kmhw = wsp->walk_data;
-	uintptr_t addr = 0;
+	kmem_bufctl_t *bc;
+	uintptr_t addr;
 
-	if ((addr = (uintptr_t)kmhw->kmhw_cur.bc_next) == 0) {
-		while (kmhw->kmhw_pos < kmhw->kmhw_nelems) {
-			if ((addr = kmhw->kmhw_table[kmhw->kmhw_pos++]) != 0)
-				break;
-		}
-	}
-	if (addr == 0)
-		return (WALK_DONE);
+	if (kmhw->kmhw_pos == kmhw->kmhw_cnt) {
+		if (kmhw->kmhw_npend == 0)
+			return (WALK_DONE);
 
-	if (mdb_vread(&kmhw->kmhw_cur, sizeof (kmem_bufctl_t), addr) == -1) {
-		mdb_warn("couldn't read kmem_bufctl_t at addr %p", addr);
-		return (WALK_ERR);
+		if (kmem_hash_walk_fetch(kmhw) != WALK_NEXT)
+			return (WALK_ERR);
 	}
 
-	return (wsp->walk_callback(addr, &kmhw->kmhw_cur, wsp->walk_cbdata));
+	addr = kmhw->kmhw_addrs[kmhw->kmhw_pos];
+	bc = &kmhw->kmhw_bufs[kmhw->kmhw_pos++];
+
+	if (bc->bc_next != NULL)
+		kmhw->kmhw_pend[kmhw->kmhw_npend++] = (uintptr_t)bc->bc_next;
+
+	return (wsp->walk_callback(addr, bc, wsp->walk_cbdata));
 }
 
 void
@@ -855,7 +956,17 @@ kmem_hash_walk_fini(mdb_walk_state_t *wsp)
 	if (kmhw == NULL)
 		return;
 
-	mdb_free(kmhw->kmhw_table, kmhw->kmhw_nelems * sizeof (uintptr_t));
+	if (kmhw->kmhw_max != 0) {
+		mdb_free(kmhw->kmhw_addrs,
+		    kmhw->kmhw_max * sizeof (uintptr_t));
+		mdb_free(kmhw->kmhw_pend,
+		    kmhw->kmhw_max * sizeof (uintptr_t));
+		mdb_free(kmhw->kmhw_bufs,
+		    kmhw->kmhw_max * sizeof (kmem_bufctl_t));
+		mdb_free(kmhw->kmhw_win, KMEM_HASH_WINDOW +
+		    sizeof (kmem_bufctl_t));
+	}
+
 	mdb_free(kmhw, sizeof (kmem_hash_walk_t));
 }
 
@@ -951,7 +1062,13 @@ kmem_estimate_allocated(uintptr_t addr, const kmem_cache_t *cp)
 	    (mdb_walk_cb_t)kmem_estimate_slab, &cache_est, addr);
 
 	if ((magsize = kmem_get_magsize(cp)) != 0) {
-		size_t mag_est = cp->cache_full.ml_total * magsize;
+		size_t full_total = 0;
+		size_t mag_est;
+		int lgrp;
+
+		for (lgrp = 0; lgrp < NLGRPS_MAX; lgrp++)
+			full_total += cp->cache_full[lgrp].ml_total;
+		mag_est = full_total * magsize;
 
 		if (cache_est >= mag_est) {
 			cache_est -= mag_est;
@@ -984,9 +1101,10 @@ kmem_read_magazines(kmem_cache_t *cp, uintptr_t addr, int ncpus,
 {
 	kmem_magazine_t *kmp, *mp;
 	void **maglist = NULL;
-	int i, cpu;
+	int i, cpu, lgrp;
 	size_t magsize, magmax, magbsize;
 	size_t magcnt = 0;
+	size_t full_total = 0;
 
 	/*
 	 * Read the magtype out of the cache, after verifying the pointer's
@@ -1003,16 +1121,18 @@ kmem_read_magazines(kmem_cache_t *cp, uintptr_t addr, int ncpus,
 	/*
 	 * There are several places where we need to go buffer hunting:
 	 * the per-CPU loaded magazine, the per-CPU spare full magazine,
-	 * and the full magazine list in the depot.
+	 * and the per-lgroup full magazine lists in the depot.
 	 *
 	 * For an upper bound on the number of buffers in the magazine
 	 * layer, we have the number of magazines on the cache_full
-	 * list plus at most two magazines per CPU (the loaded and the
+	 * lists plus at most two magazines per CPU (the loaded and the
 	 * spare).  Toss in 100 magazines as a fudge factor in case this
 	 * is live (the number "100" comes from the same fudge factor in
 	 * crash(8)).
 	 */
-	magmax = (cp->cache_full.ml_total + 2 * ncpus + 100) * magsize;
+	for (lgrp = 0; lgrp < NLGRPS_MAX; lgrp++)
+		full_total += cp->cache_full[lgrp].ml_total;
+	magmax = (full_total + 2 * ncpus + 100) * magsize;
 	magbsize = offsetof(kmem_magazine_t, mag_round[magsize]);
 
 	if (magbsize >= PAGESIZE / 2) {
@@ -1027,17 +1147,20 @@ kmem_read_magazines(kmem_cache_t *cp, uintptr_t addr, int ncpus,
 		goto fail;
 
 	/*
-	 * First up: the magazines in the depot (i.e. on the cache_full list).
+	 * First up: the magazines in the depot (i.e. on the cache_full
+	 * lists, one per lgroup).
 	 */
-	for (kmp = cp->cache_full.ml_list; kmp != NULL; ) {
-		READMAG_ROUNDS(magsize);
-		kmp = mp->mag_next;
+	for (lgrp = 0; lgrp < NLGRPS_MAX; lgrp++) {
+		for (kmp = cp->cache_full[lgrp].ml_list; kmp != NULL; ) {
+			READMAG_ROUNDS(magsize);
+			kmp = mp->mag_next;
 
-		if (kmp == cp->cache_full.ml_list)
-			break; /* cache_full list loop detected */
+			if (kmp == cp->cache_full[lgrp].ml_list)
+				break; /* cache_full list loop detected */
+		}
 	}
 
-	dprintf(("cache_full list done\n"));
+	dprintf(("cache_full lists done\n"));
 
 	/*
 	 * Now whip through the CPUs, snagging the loaded magazines
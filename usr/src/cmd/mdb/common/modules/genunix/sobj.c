@@ -682,16 +682,18 @@ turnstile(uintptr_t addr, uint_t flags, int argc, const mdb_arg_t *argv)
 /*
  * Macros and structure definition copied from turnstile.c.
  * This is unfortunate, but half the macros we need aren't usable from
- * within mdb anyway.
+ * within mdb anyway.  The hash size is scaled with the platform's CPU
+ * count, so we read turnstile_hash_size from the kernel and fall back
+ * to the historical size on older kernels that lack the variable.
  */
-#define	TURNSTILE_HASH_SIZE	128		/* must be power of 2 */
-#define	TURNSTILE_HASH_MASK	(TURNSTILE_HASH_SIZE - 1)
-#define	TURNSTILE_SOBJ_HASH(sobj)	\
-	((((int)sobj >> 2) + ((int)sobj >> 9)) & TURNSTILE_HASH_MASK)
+#define	TURNSTILE_HASH_SIZE	128		/* historical default */
+#define	TURNSTILE_SOBJ_HASH(sobj, mask)	\
+	((((int)sobj >> 2) + ((int)sobj >> 9)) & (mask))
 
 typedef struct turnstile_chain {
 	turnstile_t	*tc_first;	/* first turnstile on hash chain */
 	disp_lock_t	tc_lock;	/* lock for this hash chain */
+	uint_t		tc_count;	/* active turnstiles on hash chain */
 } turnstile_chain_t;
 
 /*
@@ -706,6 +708,7 @@ sobj2ts(uintptr_t addr, uint_t flags, int argc, const mdb_arg_t *argv)
 	GElf_Sym	sym;
 	int		isupi;
 	int		ttoff;
+	int		tshash_size;
 	uintptr_t	ttable;
 	turnstile_t	ts, *tsp;
 	turnstile_chain_t tc;
@@ -718,7 +721,11 @@ sobj2ts(uintptr_t addr, uint_t flags, int argc, const mdb_arg_t *argv)
 		return (DCMD_ERR);
 	}
 	isupi = addr - (uintptr_t)sym.st_value < sym.st_size;
-	ttoff = (isupi ? 0 : TURNSTILE_HASH_SIZE) + TURNSTILE_SOBJ_HASH(addr);
+
+	if (mdb_readvar(&tshash_size, "turnstile_hash_size") == -1)
+		tshash_size = TURNSTILE_HASH_SIZE;
+	ttoff = (isupi ? 0 : tshash_size) +
+	    TURNSTILE_SOBJ_HASH(addr, tshash_size - 1);
 
 	if (mdb_lookup_by_name("turnstile_table", &sym) == -1) {
 		mdb_warn("unable to reference turnstile_table");
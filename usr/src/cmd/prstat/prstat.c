@@ -1093,6 +1093,99 @@ prstat_scandir(DIR *procdir)
 	fd_update();
 }
 
+/*
+ * Collect processes from the /proc/psinfo snapshot file, which returns the
+ * psinfo and usage of every visible process in one read, instead of opening
+ * and reading two files per process per interval.  Returns -1 if the running
+ * kernel does not provide the file or it could not be read; the caller then
+ * falls back to walking /proc.  Only usable when aggregate per-process data
+ * suffices; the per-lwp output modes still read lpsinfo/lusage per process.
+ */
+static int
+prstat_snapshot(void)
+{
+	static int fd = -2;		/* -2 untried, -1 unsupported */
+	prheader_t header;
+	lwp_info_t *lwp;
+	char *buf, *ptr;
+	size_t entsz, bufsz;
+	long nent, nlwps, i;
+	pid_t pid;
+	id_t lwpid;
+	ssize_t n;
+
+	if (fd == -2 && (fd = open("/proc/psinfo", O_RDONLY)) == -1)
+		fd = -1;
+	if (fd == -1)
+		return (-1);
+
+	if (pread(fd, &header, sizeof (header), 0) != sizeof (header))
+		return (-1);
+
+	/*
+	 * The snapshot is regenerated on every read, so the whole file must
+	 * be fetched in a single read; retry with a bigger buffer if more
+	 * processes appeared in the meantime.
+	 */
+	for (;;) {
+		nent = header.pr_nent;
+		entsz = header.pr_entsize;
+		bufsz = sizeof (prheader_t) + (nent + nent / 8 + 32) * entsz;
+		buf = Malloc(bufsz);
+		if ((n = pread(fd, buf, bufsz, 0)) <
+		    (ssize_t)sizeof (prheader_t)) {
+			free(buf);
+			return (-1);
+		}
+		(void) memcpy(&header, buf, sizeof (header));
+		if (header.pr_entsize == entsz && sizeof (prheader_t) +
+		    header.pr_nent * entsz <= (size_t)n)
+			break;
+		free(buf);
+	}
+	nent = header.pr_nent;
+
+	total_procs = 0;
+	total_lwps = 0;
+	total_cpu = 0;
+	total_mem = 0;
+
+	convert_zone(&zone_tbl);
+	ptr = buf + sizeof (prheader_t);
+	for (i = 0; i < nent; i++, ptr += entsz) {
+		/*LINTED ALIGNMENT*/
+		prbulkpsinfo_t *bpsp = (prbulkpsinfo_t *)ptr;
+		psinfo_t *psinfo = &bpsp->pr_psinfo;
+
+		pid = psinfo->pr_pid;
+		if (pid == 0 || pid == 2 || pid == 3)
+			continue;	/* skip sched, pageout and fsflush */
+		if (has_element(&pid_tbl, pid) == 0)
+			continue;	/* check if we really want this pid */
+		if (!has_uid(&ruid_tbl, psinfo->pr_uid) ||
+		    !has_uid(&euid_tbl, psinfo->pr_euid) ||
+		    !has_element(&prj_tbl, psinfo->pr_projid) ||
+		    !has_element(&tsk_tbl, psinfo->pr_taskid) ||
+		    !has_zone(&zone_tbl, psinfo->pr_zoneid))
+			continue;
+		if (!has_element(&cpu_tbl, psinfo->pr_lwp.pr_onpro) ||
+		    !has_element(&set_tbl, psinfo->pr_lwp.pr_bindpset) ||
+		    !has_element(&lgr_tbl, psinfo->pr_lwp.pr_lgrp))
+			continue;
+		nlwps = psinfo->pr_nlwp + psinfo->pr_nzomb;
+		add_proc(psinfo);
+		if (opts.o_outpmode & OPT_MSACCT) {
+			lwpid = psinfo->pr_lwp.pr_lwpid;
+			if ((lwp = lwpid_get(pid, lwpid)) != NULL)
+				lwp_update(lwp, pid, lwpid, &bpsp->pr_usage);
+		}
+		total_procs++;
+		total_lwps += nlwps;
+	}
+	free(buf);
+	return (0);
+}
+
 /*
  * This procedure removes all dead lwps from the linked list of all lwps.
  * It also creates linked list of ids if necessary.
@@ -1663,7 +1756,9 @@ main(int argc, char **argv)
 			sigwinch = 0;
 			(void) signal(SIGWINCH, sig_handler);
 		}
-		prstat_scandir(procdir);
+		if ((opts.o_outpmode & (OPT_LWPS | OPT_PSETS)) ||
+		    prstat_snapshot() != 0)
+			prstat_scandir(procdir);
 		list_refresh(&lwps);
 		if (print_movecur)
 			(void) putp(movecur);
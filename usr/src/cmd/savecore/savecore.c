@@ -52,6 +52,7 @@
 #include <sys/stat.h>
 #include <sys/resource.h>
 #include <bzip2/bzlib.h>
+#include <lz4.h>
 #include <sys/fm/util.h>
 #include <fm/libfmevent.h>
 #include <sys/int_fmtio.h>
@@ -385,7 +386,7 @@ read_dumphdr(void)
 		    dumphdr.dump_wordsize, DUMP_WORDSIZE);
 
 	if (datahdr.dump_datahdr_magic == DUMP_DATAHDR_MAGIC) {
-		if (datahdr.dump_datahdr_version != DUMP_DATAHDR_VERSION)
+		if (datahdr.dump_datahdr_version > DUMP_DATAHDR_VERSION)
 			logprint(SC_SL_NONE | SC_IF_VERBOSE | SC_EXIT_PEND,
 			    "dump data version (%d) != %s data version (%d)",
 			    datahdr.dump_datahdr_version, progname,
@@ -696,6 +697,7 @@ typedef struct stream {
 	int bound;
 	int nout;
 	char *blkbuf;
+	char *lz4buf;
 	blockhdr_t blocks;
 	pgcnt_t pagenum;
 	pgcnt_t curpage;
@@ -964,6 +966,100 @@ lzjbblock(int corefd, stream_t *s, char *block, size_t blocksz)
 	}
 }
 
+/*
+ * Process one lz4 block.
+ * The block layout is the same as parallel lzjb; only the page codec
+ * differs. A record of exactly pagesize bytes is an incompressible
+ * page stored raw.
+ */
+static void
+lz4block(int corefd, stream_t *s, char *block, size_t blocksz)
+{
+	int in = 0;
+	int csize;
+	int doflush;
+	char *out;
+	dumpcsize_t sc;
+	dumpstreamhdr_t sh;
+
+	if (!s->init) {
+		s->init = 1;
+		if (s->blkbuf == NULL)
+			s->blkbuf = Zalloc(coreblksize);
+		if (s->lz4buf == NULL)
+			s->lz4buf = Zalloc(pagesize);
+		s->state = STREAMSTART;
+	}
+	while (in < blocksz) {
+		switch (s->state) {
+		case STREAMSTART:
+			(void) memcpy(&sh, block + in, sizeof (sh));
+			in += sizeof (sh);
+			if (strcmp(DUMP_STREAM_MAGIC, sh.stream_magic) != 0)
+				logprint(SC_SL_ERR | SC_EXIT_ERR,
+				    "LZ4 STREAMSTART: bad stream header");
+			if (sh.stream_npages > datahdr.dump_maxrange)
+				logprint(SC_SL_ERR | SC_EXIT_ERR,
+				    "LZ4 STREAMSTART: bad range: %d > %d",
+				    sh.stream_npages, datahdr.dump_maxrange);
+			s->pagenum = sh.stream_pagenum;
+			s->npages = sh.stream_npages;
+			s->curpage = s->pagenum;
+			s->nout = 0;
+			s->done = 0;
+			s->state = STREAMPAGES;
+			break;
+		case STREAMPAGES:
+			(void) memcpy(&sc, block + in, cs);
+			in += cs;
+			csize = DUMP_GET_CSIZE(sc);
+			if (csize > pagesize)
+				logprint(SC_SL_ERR | SC_EXIT_ERR,
+				    "LZ4 STREAMPAGES: bad csize=%d", csize);
+
+			out =  s->blkbuf + PTOB(s->nout);
+			if (csize == pagesize) {
+				/* incompressible page stored raw */
+				(void) memcpy(out, block + in, pagesize);
+			} else {
+				/*
+				 * Copy to an aligned buffer;
+				 * lz4_decompress reads the leading
+				 * size word directly.
+				 */
+				(void) memcpy(s->lz4buf, block + in, csize);
+				if (lz4_decompress(s->lz4buf, out, csize,
+				    pagesize, 0) != 0)
+					logprint(SC_SL_ERR | SC_EXIT_ERR,
+					    "LZ4 STREAMPAGES: decompress "
+					    "failed");
+			}
+
+			in += csize;
+			atomic_inc_64(&saved);
+
+			doflush = 0;
+			if (s->nout == 0 && iszpage(out)) {
+				doflush = 1;
+				atomic_inc_64(&zpages);
+			} else if (++s->nout >= BTOP(coreblksize) ||
+			    isblkbnd(s->curpage + s->nout)) {
+				doflush = 1;
+			}
+			if (++s->done >= s->npages) {
+				s->state = STREAMSTART;
+				doflush = 1;
+			}
+			if (doflush) {
+				putpage(corefd, s->blkbuf, s->curpage, s->nout);
+				s->nout = 0;
+				s->curpage = s->pagenum + s->done;
+			}
+			break;
+		}
+	}
+}
+
 /* bzlib library reports errors with this callback */
 void
 bz_internal_error(int errcode)
@@ -1121,11 +1217,15 @@ runstreams(void *arg)
 				b = deqh(&s->blocks);
 				(void) pthread_mutex_unlock(&lock);
 
-				if (datahdr.dump_clevel < DUMP_CLEVEL_BZIP2)
-					lzjbblock(t->corefd, s, b->block,
+				if (datahdr.dump_clevel == DUMP_CLEVEL_BZIP2)
+					bz2block(t->corefd, s, b->block,
+					    b->size);
+				else if (datahdr.dump_clevel ==
+				    DUMP_CLEVEL_LZ4)
+					lz4block(t->corefd, s, b->block,
 					    b->size);
 				else
-					bz2block(t->corefd, s, b->block,
+					lzjbblock(t->corefd, s, b->block,
 					    b->size);
 
 				(void) pthread_mutex_lock(&lock);
@@ -1165,11 +1265,11 @@ runstreams(void *arg)
  * be processing a crash file from a remote machine, which may have
  * more CPUs.
  *
- * When the kernel uses parallel lzjb or parallel bzip2, we expect a
- * series of 128KB blocks of compression data. In this case, each
- * block has a "tag", in the range 1-4095. Each block is handed off to
- * to the threads running "runstreams". The dump format is either lzjb
- * or bzip2, never a mixture. These threads, in turn, process the
+ * When the kernel uses parallel lzjb, lz4 or parallel bzip2, we
+ * expect a series of 128KB blocks of compression data. In this case,
+ * each block has a "tag", in the range 1-4095. Each block is handed
+ * off to the threads running "runstreams". The dump format is lzjb,
+ * lz4 or bzip2, never a mixture. These threads, in turn, process the
  * compression data for groups of pages. Groups of pages are delimited
  * by a "stream header", which indicates a starting pfn and number of
  * pages. When a stream block has been read, the condition variable
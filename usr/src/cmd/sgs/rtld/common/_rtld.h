@@ -146,6 +146,7 @@ struct fct {
 #define	AL_CNT_DEPCLCT	10		/* load_finish() */
 #define	AL_CNT_RTLDINFO	1		/* RTLDINFO() */
 #define	AL_CNT_FPNODE	4		/* FPNODE() */
+#define	AL_CNT_DIRCACHE	64		/* dircache_fill() */
 #define	AL_CNT_LMLISTS	20		/* lm_lists */
 #define	AL_CNT_LMNOW	8		/* lm_now */
 #define	AL_CNT_RELBIND	20		/* relocation binding */
@@ -376,6 +377,7 @@ struct pdesc {
 	const char	*pd_pname;	/* path name - may be expanded */
 	const char	*pd_oname;	/* original name - unexpanded */
 	void		*pd_info;	/* possible auxiliary information */
+	void		*pd_dcp;	/* directory content cache */
 	size_t		pd_plen;	/* path name length */
 	uint_t		pd_flags;	/* descriptor specific flags */
 };
@@ -732,6 +734,9 @@ extern Rt_map		*load_one(Lm_list *, Aliste, Alist *, Rt_map *, int,
 			    uint_t, Grp_hdl **, int *);
 extern const char	*load_trace(Lm_list *, Pdesc *, Rt_map *, Fdesc *);
 extern void		nfavl_insert(const char *, avl_index_t);
+extern int		dircache_exists(Pdesc *, const char *);
+extern void		dircache_flush(void);
+extern void		dircache_free(Pdesc *);
 extern void		*nu_map(Lm_list *, caddr_t, size_t, int, int);
 extern Fct		*map_obj(Lm_list *, Fdesc *, size_t, const char *, int,
 			    Rej_desc *);
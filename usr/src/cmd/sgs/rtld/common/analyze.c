@@ -1536,6 +1536,25 @@ find_file(Lm_list *lml, Rt_map *clmp, uint_t flags, Fdesc *fdp, Rej_desc *rej,
 		}
 	}
 
+	/*
+	 * If this directory's content has been cached, avoid constructing and
+	 * probing path names that are known not to exist.  The cache is
+	 * bypassed for ldd(1) search tracing, and when an object search
+	 * auditor is present, as the auditor may redirect the search.
+	 */
+	if (((lml->lm_flags & LML_FLG_TRC_SEARCH) == 0) &&
+	    (((lml->lm_tflags | AFLAGS(clmp)) & LML_TFLG_AUD_OBJSEARCH) == 0) &&
+	    (dircache_exists(pdp, oname) == 0)) {
+		/*
+		 * As with a "not-found" AVL rejection, let dlopen() and
+		 * dlsym() fall backs know that a negative cache produced
+		 * this failure.
+		 */
+		if (in_nfavl)
+			(*in_nfavl)++;
+		return (0);
+	}
+
 	/*
 	 * Protect ourselves from building an invalid pathname.
 	 */
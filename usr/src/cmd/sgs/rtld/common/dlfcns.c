@@ -918,6 +918,7 @@ dlmopen_intn(Lm_list *lml, const char *path, int mode, Rt_map *clmp,
 		avl_tree_t	*oavlt = nfavl;
 
 		nfavl = NULL;
+		dircache_flush();
 		ghp = dlmopen_core(lml, olml, path, mode, clmp, flags, orig,
 		    NULL);
 
@@ -1454,6 +1455,7 @@ dlsym_intn(void *handle, const char *name, Rt_map *clmp, Rt_map **dlmp)
 		avl_tree_t	*oavlt = nfavl;
 
 		nfavl = NULL;
+		dircache_flush();
 		error = dlsym_core(handle, name, clmp, dlmp, NULL);
 
 		/*
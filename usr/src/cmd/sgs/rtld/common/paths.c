@@ -36,15 +36,170 @@
  */
 
 #include	<stdio.h>
+#include	<stdlib.h>
 #include	<unistd.h>
 #include	<limits.h>
 #include	<fcntl.h>
 #include	<string.h>
+#include	<dirent.h>
 #include	<debug.h>
 #include	<conv.h>
 #include	"_rtld.h"
 #include	"msg.h"
 
+/*
+ * Directory content caching.  When a simple filename is searched for along a
+ * list of directories (runpaths, environment paths, and the defaults), every
+ * directory that doesn't contain the file costs a failed open(2).  Processes
+ * with many dependencies probe the same directories over and over, and as the
+ * "not-found" AVL tree only records complete path names, each new dependency
+ * repeats the storm.
+ *
+ * To compensate, cache the content of each absolute search path directory the
+ * first time it is searched, as a sorted array of entry name hashes.  A
+ * membership test can then reject most nonexistent files without leaving
+ * ld.so.1.  A hash collision can only cause a file to be probed, never
+ * skipped.  In keeping with the "not-found" AVL tree, the dlopen() and
+ * dlsym() fall backs invalidate these caches (by bumping the generation) in
+ * case the file system has changed since the caches were created.
+ */
+typedef struct {
+	Alist		*dc_entries;	/* sorted entry name hashes */
+	uint_t		dc_gen;		/* generation at fill time */
+	uint_t		dc_flags;
+} Dircache;
+
+#define	FLG_DC_NOCACHE	0x1		/* dir unreadable - always probe */
+
+static uint_t	dircache_gen = 0;
+
+/*
+ * qsort(3c) entry name hash comparison function.
+ */
+static int
+dircache_cmp(const void *v1, const void *v2)
+{
+	uint_t	h1 = *(const uint_t *)v1, h2 = *(const uint_t *)v2;
+
+	if (h1 < h2)
+		return (-1);
+	if (h1 > h2)
+		return (1);
+	return (0);
+}
+
+static void
+dircache_fill(Dircache *dcp, const char *dname)
+{
+	DIR		*dir;
+	struct dirent	*dirent;
+
+	if ((dir = opendir(dname)) == NULL) {
+		dcp->dc_flags |= FLG_DC_NOCACHE;
+		return;
+	}
+	while ((dirent = readdir(dir)) != NULL) {
+		uint_t	hash = sgs_str_hash(dirent->d_name);
+
+		if (alist_append(&dcp->dc_entries, &hash, sizeof (uint_t),
+		    AL_CNT_DIRCACHE) == NULL) {
+			(void) closedir(dir);
+			dcp->dc_flags |= FLG_DC_NOCACHE;
+			return;
+		}
+	}
+	(void) closedir(dir);
+
+	if (dcp->dc_entries)
+		qsort(dcp->dc_entries->al_data, dcp->dc_entries->al_nitems,
+		    sizeof (uint_t), dircache_cmp);
+}
+
+/*
+ * Determine whether a simple filename can exist in the directory described
+ * by the given path descriptor.  Returns 0 only if the file is known not to
+ * exist; a return of 1 means the caller must probe the file itself.
+ */
+int
+dircache_exists(Pdesc *pdp, const char *fname)
+{
+	Dircache	*dcp;
+	uint_t		hash, lo, hi, nitems;
+	uint_t		*harr;
+
+	/*
+	 * Only cache absolute directories, as relative search paths change
+	 * meaning should the process change directory (see file_open()).
+	 */
+	if (pdp->pd_pname[0] != '/')
+		return (1);
+
+	if ((dcp = pdp->pd_dcp) == NULL) {
+		if ((dcp = calloc(sizeof (Dircache), 1)) == NULL)
+			return (1);
+		pdp->pd_dcp = dcp;
+		dcp->dc_gen = dircache_gen;
+		dircache_fill(dcp, pdp->pd_pname);
+	} else if (dcp->dc_gen != dircache_gen) {
+		/*
+		 * The cache has been invalidated - refill it.
+		 */
+		if (dcp->dc_entries) {
+			free(dcp->dc_entries);
+			dcp->dc_entries = NULL;
+		}
+		dcp->dc_flags = 0;
+		dcp->dc_gen = dircache_gen;
+		dircache_fill(dcp, pdp->pd_pname);
+	}
+
+	if (dcp->dc_flags & FLG_DC_NOCACHE)
+		return (1);
+	if (dcp->dc_entries == NULL)
+		return (0);
+
+	hash = sgs_str_hash(fname);
+	harr = (uint_t *)dcp->dc_entries->al_data;
+	nitems = dcp->dc_entries->al_nitems;
+	lo = 0;
+	hi = nitems;
+	while (lo < hi) {
+		uint_t	mid = (lo + hi) / 2;
+
+		if (harr[mid] < hash)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return ((lo < nitems) && (harr[lo] == hash));
+}
+
+/*
+ * Invalidate all directory content caches.  Existing caches are refilled the
+ * next time their directory is searched.
+ */
+void
+dircache_flush(void)
+{
+	dircache_gen++;
+}
+
+/*
+ * Release the cache associated with a path descriptor that is being removed.
+ */
+void
+dircache_free(Pdesc *pdp)
+{
+	Dircache	*dcp;
+
+	if ((dcp = pdp->pd_dcp) == NULL)
+		return;
+	if (dcp->dc_entries)
+		free(dcp->dc_entries);
+	free(dcp);
+	pdp->pd_dcp = NULL;
+}
+
 /*
  * Default and secure dependency search path initialization.
  */
@@ -312,8 +312,14 @@ remove_so(Lm_list *lml, Rt_map *lmp, Rt_map *clmp)
 	/*
 	 * Deallocate any remaining cruft and free the link-map.
 	 */
-	if (RLIST(lmp))
+	if (RLIST(lmp)) {
+		Aliste	idx;
+		Pdesc	*pdp;
+
+		for (ALIST_TRAVERSE(RLIST(lmp), idx, pdp))
+			dircache_free(pdp);
 		remove_alist(&RLIST(lmp), 1);
+	}
 
 	if (AUDITORS(lmp))
 		audit_desc_cleanup(lmp);
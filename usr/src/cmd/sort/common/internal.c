@@ -294,17 +294,123 @@ rqs_start:
 	}
 }
 
+/*
+ * Parallel internal sorting, requested via -p.  The line array is divided
+ * into contiguous slices, each of which is radix quicksorted by its own
+ * thread; the sorted slices are then merged back into place.  Ties during
+ * the merge go to the lower-numbered slice, so the result is deterministic.
+ * Slices below PARALLEL_MIN_LINES lines aren't worth the thread creation
+ * and merge overhead, and additional threads beyond PARALLEL_MAX_THREADS
+ * yield little once the merge cost is paid.
+ */
+#define	PARALLEL_MAX_THREADS	16
+#define	PARALLEL_MIN_LINES	4096
+
+typedef struct sort_slice {
+	line_rec_t	**ss_array;
+	ssize_t		ss_size;
+	int		(*ss_collate_fcn)(line_rec_t *, line_rec_t *, ssize_t,
+	    flag_t);
+	flag_t		ss_coll_flags;
+} sort_slice_t;
+
+static void *
+parallel_sort_worker(void *arg)
+{
+	sort_slice_t *ss = arg;
+
+	rqs_algorithm(ss->ss_array, ss->ss_size, 0, ss->ss_collate_fcn,
+	    ss->ss_coll_flags);
+	return (NULL);
+}
+
+/*
+ * Merge the sorted slices into a scratch array, then copy the result back
+ * over the original line array.  The fan-in is at most
+ * PARALLEL_MAX_THREADS, so a linear scan of the slice heads is competitive
+ * with a tournament tree and considerably simpler.
+ */
 static void
-radix_quicksort(stream_t *C, flag_t coll_flags)
+merge_sorted_slices(line_rec_t **X, ssize_t n, sort_slice_t *slices,
+    int nslices)
 {
+	line_rec_t **out = safe_realloc(NULL, n * sizeof (line_rec_t *));
+	ssize_t pos[PARALLEL_MAX_THREADS] = { 0 };
+	ssize_t i;
+	int j, best;
+
+	for (i = 0; i < n; i++) {
+		best = -1;
+		for (j = 0; j < nslices; j++) {
+			if (pos[j] >= slices[j].ss_size)
+				continue;
+			if (best == -1 ||
+			    slices[j].ss_collate_fcn(
+			    slices[j].ss_array[pos[j]],
+			    slices[best].ss_array[pos[best]], 0,
+			    slices[j].ss_coll_flags) < 0)
+				best = j;
+		}
+		ASSERT(best != -1);
+		out[i] = slices[best].ss_array[pos[best]];
+		pos[best]++;
+	}
+
+	(void) memcpy(X, out, n * sizeof (line_rec_t *));
+	free(out);
+}
+
+static void
+radix_quicksort(sort_t *S, stream_t *C, flag_t coll_flags)
+{
+	int (*collate_fcn)(line_rec_t *, line_rec_t *, ssize_t, flag_t);
+	line_rec_t **X = C->s_type.LA.s_array;
+	ssize_t n = C->s_type.LA.s_array_size;
+	sort_slice_t slices[PARALLEL_MAX_THREADS];
+	thread_t tids[PARALLEL_MAX_THREADS];
+	ssize_t slice_size;
+	int nt, i;
+
 	ASSERT((C->s_status & STREAM_SOURCE_MASK) == STREAM_ARRAY);
 
 	if (C->s_element_size == sizeof (char))
-		rqs_algorithm(C->s_type.LA.s_array, C->s_type.LA.s_array_size,
-		    0, collated, coll_flags);
+		collate_fcn = collated;
 	else
-		rqs_algorithm(C->s_type.LA.s_array, C->s_type.LA.s_array_size,
-		    0, collated_wide, coll_flags);
+		collate_fcn = collated_wide;
+
+	nt = MIN(S->m_parallel_sorts, PARALLEL_MAX_THREADS);
+
+	if (nt <= 1 || n < PARALLEL_MIN_LINES || n < nt) {
+		rqs_algorithm(X, n, 0, collate_fcn, coll_flags);
+		return;
+	}
+
+	slice_size = n / nt;
+	for (i = 0; i < nt; i++) {
+		slices[i].ss_array = X + i * slice_size;
+		slices[i].ss_size = (i == nt - 1) ?
+		    n - i * slice_size : slice_size;
+		slices[i].ss_collate_fcn = collate_fcn;
+		slices[i].ss_coll_flags = coll_flags;
+
+		if (thr_create(NULL, 0, parallel_sort_worker, &slices[i],
+		    0, &tids[i]) != 0) {
+			/*
+			 * If no more threads are available, sort the slice
+			 * in the calling thread; the merge doesn't care who
+			 * sorted it.
+			 */
+			(void) parallel_sort_worker(&slices[i]);
+			tids[i] = 0;
+		}
+	}
+
+	for (i = 0; i < nt; i++) {
+		if (tids[i] != 0)
+			(void) thr_join(tids[i], NULL, NULL);
+	}
+
+	merge_sorted_slices(X, n, slices, nt);
 }
 
 void
@@ -406,7 +512,7 @@ internal_sort(sort_t *S)
 			}
 		}
 
-		radix_quicksort(sort_stream, coll_flags);
+		radix_quicksort(S, sort_stream, coll_flags);
 
 #ifndef DEBUG_NO_CACHE_TEMP
 		/*
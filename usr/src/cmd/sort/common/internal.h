@@ -38,6 +38,7 @@ extern "C" {
 #include <unistd.h>
 #include <fcntl.h>
 #include <limits.h>
+#include <thread.h>
 
 #include "statistics.h"
 #include "streams.h"
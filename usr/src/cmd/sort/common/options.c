@@ -73,8 +73,8 @@
  * is, before the closing -n is seen), a narrower set of options is permitted.
  * We specify this smaller set of options in OLD_SPEC_OPTIONS_STRING.
  */
-#define	OPTIONS_STRING		"cmuo:T:z:dfiMnrbt:k:S:0123456789"
-#define	OLD_SPEC_OPTIONS_STRING	"bdfiMnrcmuo:T:z:t:k:S:"
+#define	OPTIONS_STRING		"cmuo:T:z:dfiMnrbt:k:S:p:0123456789"
+#define	OLD_SPEC_OPTIONS_STRING	"bdfiMnrcmuo:T:z:t:k:S:p:"
 
 #define	OPTIONS_OLDSPEC		0x1	/* else new-style spec */
 #define	OPTIONS_STARTSPEC	0x2	/* else end spec */
@@ -332,6 +332,7 @@ parse_old_field_spec(sort_t *S, int argc, char *argv[])
 			case 't':
 			case 'k':
 			case 'S':
+			case 'p':
 				/*
 				 * Options with arguments.
 				 */
@@ -503,6 +504,16 @@ options(sort_t *S, int argc, char *argv[])
 				(void) parse_new_field_spec(S, optarg);
 				break;
 
+			case 'p':
+				/*
+				 * Number of threads used for the internal
+				 * sort; zero or one requests the historic
+				 * single-threaded behaviour.
+				 */
+				S->m_parallel_sorts = (uint_t)strtol(optarg,
+				    (char **)NULL, 10);
+				break;
+
 			case 'S':
 				S->m_memory_limit = strtomem(optarg);
 #ifdef DEBUG
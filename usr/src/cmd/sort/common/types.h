@@ -278,6 +278,8 @@ typedef struct sort {
 	flag_t		m_input_from_stdin;
 	flag_t		m_output_to_stdout;
 	flag_t		m_verbose;
+
+	uint_t		m_parallel_sorts;
 } sort_t;
 
 #ifdef	__cplusplus
@@ -432,8 +432,8 @@ usage()
 {
 	(void) fprintf(stderr,
 	    gettext("usage: %s [-cmu] [-o output] [-T directory] [-S mem]"
-	    " [-z recsz]\n\t[-dfiMnr] [-b] [-t char] [-k keydef]"
-	    " [+pos1 [-pos2]] files...\n"), CMDNAME);
+	    " [-z recsz]\n\t[-p threads] [-dfiMnr] [-b] [-t char]"
+	    " [-k keydef] [+pos1 [-pos2]] files...\n"), CMDNAME);
 	exit(E_USAGE);
 }
 
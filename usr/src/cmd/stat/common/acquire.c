@@ -60,6 +60,41 @@ kstat_lookup_read(kstat_ctl_t *kc, char *module,
 	return (ksp);
 }
 
+/*
+ * kstat_lookup() walks the entire chain, and acquire_cpus() needs three
+ * lookups per CPU per interval; on large systems running at sub-second
+ * intervals those linear searches dominate the cost of a snapshot.  Cache
+ * the per-CPU kstat pointers between snapshots.  Pointers into the chain
+ * remain valid until kstat_chain_update() reports a new chain id, at
+ * which point acquire_snapshot() discards the cache.
+ */
+struct cpu_kstat_cache {
+	kstat_t	*cc_info;	/* cpu_info:<n> */
+	kstat_t	*cc_vm;		/* cpu:<n>:vm */
+	kstat_t	*cc_sys;	/* cpu:<n>:sys */
+};
+
+static struct cpu_kstat_cache *cpu_cache;
+static size_t cpu_cache_nr;
+static kid_t cpu_cache_kcid = -1;
+
+static kstat_t *
+cpu_kstat_lookup_read(kstat_ctl_t *kc, kstat_t **cache, char *module,
+		int instance, char *name)
+{
+	kstat_t *ksp;
+
+	if (cache != NULL && *cache != NULL)
+		ksp = *cache;
+	else if ((ksp = kstat_lookup(kc, module, instance, name)) == NULL)
+		return (NULL);
+	if (kstat_read(kc, ksp, NULL) == -1)
+		return (NULL);
+	if (cache != NULL)
+		*cache = ksp;
+	return (ksp);
+}
+
 /*
  * Note: the following helpers do not clean up on the failure case,
  * because it is left to the free_snapshot() in the acquire_snapshot()
@@ -76,9 +111,19 @@ acquire_cpus(struct snapshot *ss, kstat_ctl_t *kc)
 	if (ss->s_cpus == NULL)
 		goto out;
 
+	if (cpu_cache == NULL) {
+		cpu_cache = calloc(ss->s_nr_cpus,
+		    sizeof (struct cpu_kstat_cache));
+		if (cpu_cache != NULL)
+			cpu_cache_nr = ss->s_nr_cpus;
+	}
+
 	for (i = 0; i < ss->s_nr_cpus; i++) {
+		struct cpu_kstat_cache *cc;
 		kstat_t *ksp;
 
+		cc = (i < cpu_cache_nr) ? &cpu_cache[i] : NULL;
+
 		ss->s_cpus[i].cs_id = ID_NO_CPU;
 		ss->s_cpus[i].cs_state = p_online(i, P_STATUS);
 		/* If no valid CPU is present, move on to the next one */
@@ -86,7 +131,9 @@ acquire_cpus(struct snapshot *ss, kstat_ctl_t *kc)
 			continue;
 		ss->s_cpus[i].cs_id = i;
 
-		if ((ksp = kstat_lookup_read(kc, "cpu_info", i, NULL)) == NULL)
+		if ((ksp = cpu_kstat_lookup_read(kc,
+		    (cc == NULL) ? NULL : &cc->cc_info,
+		    "cpu_info", i, NULL)) == NULL)
 			goto out;
 
 		(void) pset_assign(PS_QUERY, i, &ss->s_cpus[i].cs_pset_id);
@@ -96,13 +143,17 @@ acquire_cpus(struct snapshot *ss, kstat_ctl_t *kc)
 		if (!CPU_ACTIVE(&ss->s_cpus[i]))
 			continue;
 
-		if ((ksp = kstat_lookup_read(kc, "cpu", i, "vm")) == NULL)
+		if ((ksp = cpu_kstat_lookup_read(kc,
+		    (cc == NULL) ? NULL : &cc->cc_vm,
+		    "cpu", i, "vm")) == NULL)
 			goto out;
 
 		if (kstat_copy(ksp, &ss->s_cpus[i].cs_vm))
 			goto out;
 
-		if ((ksp = kstat_lookup_read(kc, "cpu", i, "sys")) == NULL)
+		if ((ksp = cpu_kstat_lookup_read(kc,
+		    (cc == NULL) ? NULL : &cc->cc_sys,
+		    "cpu", i, "sys")) == NULL)
 			goto out;
 
 		if (kstat_copy(ksp, &ss->s_cpus[i].cs_sys))
@@ -321,6 +372,14 @@ retry:
 			fail(1, "kstat_chain_update failed");
 	}
 
+	/* a new chain invalidates any cached kstat pointers */
+	if (kc->kc_chain_id != cpu_cache_kcid) {
+		if (cpu_cache != NULL)
+			(void) memset(cpu_cache, 0,
+			    cpu_cache_nr * sizeof (struct cpu_kstat_cache));
+		cpu_cache_kcid = kc->kc_chain_id;
+	}
+
 	if (!err && (types & SNAP_INTERRUPTS))
 		err = acquire_intrs(ss, kc);
 
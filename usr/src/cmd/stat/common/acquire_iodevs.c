@@ -572,6 +572,48 @@ acquire_iodev_errors(struct snapshot *ss, kstat_ctl_t *kc)
 	return (0);
 }
 
+static int
+acquire_iodev_latencies(struct snapshot *ss, kstat_ctl_t *kc)
+{
+	kstat_t *ksp;
+
+	for (ksp = kc->kc_chain; ksp; ksp = ksp->ks_next) {
+		char kstat_name[KSTAT_STRLEN];
+		char *dname = kstat_name;
+		char *ename = ksp->ks_name;
+		struct iodev_snapshot *iodev;
+
+		if (ksp->ks_type != KSTAT_TYPE_NAMED)
+			continue;
+		if (strncmp(ksp->ks_class, "disk_latency", 12) != 0)
+			continue;
+
+		/*
+		 * The latency kstats follow the error kstat naming
+		 * convention (i.e., drivername,lat), so strip at the
+		 * comma just as acquire_iodev_errors() does.
+		 */
+		while (*ename && *ename != ',') {
+			*dname = *ename;
+			dname++;
+			ename++;
+		}
+		*dname = '\0';
+
+		iodev = find_iodev_by_name(ss->s_iodevs, kstat_name);
+
+		if (iodev == NULL)
+			continue;
+
+		if (kstat_read(kc, ksp, NULL) == -1)
+			return (errno);
+		if (kstat_copy(ksp, &iodev->is_latencies) == -1)
+			return (errno);
+	}
+
+	return (0);
+}
+
 static void
 get_ids(struct iodev_snapshot *iodev, const char *pretty)
 {
@@ -1068,6 +1110,11 @@ acquire_iodevs(struct snapshot *ss, kstat_ctl_t *kc, struct iodev_filter *df)
 			goto out;
 	}
 
+	if (ss->s_types & SNAP_IODEV_LATENCIES) {
+		if ((err = acquire_iodev_latencies(ss, kc)) != 0)
+			goto out;
+	}
+
 	if ((err = acquire_iodev_stats(ss->s_iodevs, kc)) != 0)
 		goto out;
 
@@ -1116,6 +1163,7 @@ free_iodev(struct iodev_snapshot *iodev)
 	}
 
 	free(iodev->is_errors.ks_data);
+	free(iodev->is_latencies.ks_data);
 	free(iodev->is_pretty);
 	free(iodev->is_dname);
 	free(iodev->is_devid);
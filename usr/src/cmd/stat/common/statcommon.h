@@ -88,7 +88,9 @@ enum snapshot_types {
 	/* pretty names for iodevs */
 	SNAP_IODEV_PRETTY	= 1 << 9,
 	/* devid for iodevs */
-	SNAP_IODEV_DEVID	= 1 << 10
+	SNAP_IODEV_DEVID	= 1 << 10,
+	/* disk latency histograms */
+	SNAP_IODEV_LATENCIES	= 1 << 11
 };
 
 struct cpu_snapshot {
@@ -181,6 +183,8 @@ struct iodev_snapshot {
 	kstat_io_t is_stats;
 	/* iodev error stats */
 	kstat_t is_errors;
+	/* iodev latency histograms */
+	kstat_t is_latencies;
 	/* creation time of the stats */
 	hrtime_t is_crtime;
 	/* time at which iodev snapshot was taken */
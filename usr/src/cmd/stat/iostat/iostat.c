@@ -61,6 +61,7 @@
 #define	DISK_EXTENDED_ERRORS	0x0010
 #define	DISK_IOPATH_LI		0x0020	/* LunInitiator */
 #define	DISK_IOPATH_LTI		0x0040	/* LunTargetInitiator */
+#define	DISK_LATENCIES		0x0080	/* latency percentiles */
 
 #define	DISK_NORMAL		(DISK_OLD | DISK_NEW)
 #define	DISK_IO_MASK		(DISK_OLD | DISK_NEW | DISK_EXTENDED)
@@ -71,6 +72,21 @@
 
 #define	NUMBER_OF_ERR_COUNTERS	3
 
+/*
+ * Latency percentiles reported for -L, as fractions of the I/O count.
+ */
+#define	NUMBER_OF_LAT_PERCENTILES	3
+
+static const double lat_percentiles[NUMBER_OF_LAT_PERCENTILES] = {
+	0.50, 0.95, 0.99
+};
+
+/*
+ * The latency histogram buckets are named for their lower bounds, which
+ * are powers of two; 64 slots covers every bound a uint64_t can express.
+ */
+#define	NUMBER_OF_LAT_BUCKETS	64
+
 /*
  * It's really a pseudo-gigabyte. We use 1000000000 bytes so that the disk
  * labels don't look bad. 1GB is really 1073741824 bytes.
@@ -180,6 +196,7 @@ static void print_cpu_hdr2(void);
 static void print_tty_data(void);
 static void print_cpu_data(void);
 static void print_err_hdr(void);
+static void print_lat_hdr(void);
 static void print_disk_header(void);
 static void hdrout(void);
 static void disk_errors(void);
@@ -194,6 +211,8 @@ static void show_all_disks(void);
 static void show_first_disk(void);
 static void show_other_disks(void);
 static void show_disk_errors(void *, void *, void *);
+static void compute_latencies(struct iodev_snapshot *,
+    struct iodev_snapshot *, double *);
 static void write_core_header(void);
 static int  fzero(double value);
 static int  safe_strtoi(char const *val, char *errmsg);
@@ -237,6 +256,8 @@ main(int argc, char **argv)
 	}
 	if (do_disk & DISK_ERROR_MASK)
 		types |= SNAP_IODEV_ERRORS;
+	if (do_disk & DISK_LATENCIES)
+		types |= SNAP_IODEV_LATENCIES;
 	if (do_partitions || do_partitions_only)
 		df.if_allowed_types |= IODEV_PARTITION;
 	if (do_conversions)
@@ -361,6 +382,7 @@ main(int argc, char **argv)
 
 #define	DISK_LEN	11
 #define	DISK_ERROR_LEN	16
+#define	DISK_LAT_LEN	21
 #define	DEVICE_LEN	7
 
 /*ARGSUSED*/
@@ -509,6 +531,8 @@ write_core_header(void)
 			follow_space_ct = dh_len - (lead_space_ct + edevlen);
 			if (do_disk & DISK_ERRORS)
 				follow_space_ct -= DISK_ERROR_LEN;
+			if (do_disk & DISK_LATENCIES)
+				follow_space_ct -= DISK_LAT_LEN;
 			if ((do_disk & DISK_EXTENDED) && do_conversions)
 				follow_space_ct -= DEVICE_LEN;
 
@@ -535,6 +559,8 @@ printxhdr(void)
 		setup(write_core_header);
 	if (do_disk & DISK_ERRORS)
 		setup(print_err_hdr);
+	if (do_disk & DISK_LATENCIES)
+		setup(print_lat_hdr);
 
 	if (do_conversions) {
 		setup(do_newline);
@@ -558,6 +584,74 @@ printxhdr(void)
 	}
 }
 
+/*
+ * Estimate latency percentiles for the interval from the device's
+ * latency histogram kstat.  Each named entry is a log-scale bucket
+ * named for its lower bound in microseconds ("r_us_1024"), maintained
+ * by the driver; aggregate the read/write/flush deltas by bound and
+ * report each percentile as the upper bound of the bucket it falls in,
+ * in milliseconds.  Devices without the kstat report all zeroes.
+ */
+static void
+compute_latencies(struct iodev_snapshot *old, struct iodev_snapshot *new,
+    double *latms)
+{
+	uint64_t counts[NUMBER_OF_LAT_BUCKETS];
+	kstat_named_t *knp, *oknp = NULL;
+	uint64_t total = 0;
+	uint_t i;
+	int b, p;
+
+	for (p = 0; p < NUMBER_OF_LAT_PERCENTILES; p++)
+		latms[p] = 0.0;
+
+	if (new->is_latencies.ks_data == NULL)
+		return;
+
+	knp = KSTAT_NAMED_PTR(&new->is_latencies);
+	if (old != NULL && old->is_latencies.ks_data != NULL &&
+	    old->is_latencies.ks_ndata == new->is_latencies.ks_ndata)
+		oknp = KSTAT_NAMED_PTR(&old->is_latencies);
+
+	bzero(counts, sizeof (counts));
+
+	for (i = 0; i < new->is_latencies.ks_ndata; i++) {
+		u_longlong_t lb;
+		uint64_t count;
+
+		if (knp[i].data_type != KSTAT_DATA_UINT64)
+			continue;
+		if (sscanf(knp[i].name, "%*1[rwf]_us_%llu", &lb) != 1)
+			continue;
+
+		count = knp[i].value.ui64;
+		if (oknp != NULL && strcmp(oknp[i].name, knp[i].name) == 0)
+			count = ull_delta(oknp[i].value.ui64, count);
+
+		/* bucket b spans [2^(b-1), 2^b) microseconds */
+		for (b = 0; lb != 0 && b < NUMBER_OF_LAT_BUCKETS - 1; b++)
+			lb >>= 1;
+
+		counts[b] += count;
+		total += count;
+	}
+
+	if (total == 0)
+		return;
+
+	for (p = 0; p < NUMBER_OF_LAT_PERCENTILES; p++) {
+		double need = (double)total * lat_percentiles[p];
+		uint64_t cum = 0;
+
+		for (b = 0; b < NUMBER_OF_LAT_BUCKETS - 1; b++) {
+			cum += counts[b];
+			if ((double)cum >= need && cum != 0)
+				break;
+		}
+		latms[p] = (double)(1ULL << b) / 1000.0;
+	}
+}
+
 /*
  * Write out a line for this disk - note that show_disk writes out
  * full lines or blocks for each selected disk.
@@ -566,7 +660,9 @@ static void
 show_disk(void *v1, void *v2, void *data)
 {
 	uint32_t err_counters[NUMBER_OF_ERR_COUNTERS];
+	double lat_ms[NUMBER_OF_LAT_PERCENTILES];
 	boolean_t display_err_counters = do_disk & DISK_ERRORS;
+	boolean_t display_latencies = do_disk & DISK_LATENCIES;
 	struct iodev_snapshot *old = (struct iodev_snapshot *)v1;
 	struct iodev_snapshot *new = (struct iodev_snapshot *)v2;
 	int *count = (int *)data;
@@ -835,6 +931,7 @@ show_disk(void *v1, void *v2, void *data)
 			    (toterrs == 0)) {
 				doit = 0;
 				display_err_counters = B_FALSE;
+				display_latencies = B_FALSE;
 			} else if (do_conversions == 0) {
 				if (do_raw == 0) {
 					push_out("%-*.*s",
@@ -890,6 +987,17 @@ show_disk(void *v1, void *v2, void *data)
 		push_out(efstr, toterrs);
 	}
 
+	if (display_latencies) {
+		char	*lfstr;
+		int	p;
+
+		compute_latencies(old, new, lat_ms);
+
+		lfstr = (do_raw == 0) ? "%6.2f " : "%.2f";
+		for (p = 0; p < NUMBER_OF_LAT_PERCENTILES; p++)
+			push_out(lfstr, lat_ms[p]);
+	}
+
 	if (suppress_zero == 0 || doit == 1) {
 		if ((do_disk & (DISK_EXTENDED | DISK_ERRORS)) &&
 		    do_conversions) {
@@ -943,7 +1051,7 @@ static void
 usage(void)
 {
 	(void) fprintf(stderr,
-	    "Usage: iostat [-cCdDeEiImMnpPrstxXYz] "
+	    "Usage: iostat [-cCdDeEiILmMnpPrstxXYz] "
 	    " [-l n] [-T d|u] [disk ...] [interval [count]]\n"
 	    "\t\t-c:	report percentage of time system has spent\n"
 	    "\t\t\tin user/system/dtrace/idle mode\n"
@@ -958,6 +1066,8 @@ usage(void)
 	    "\t\t-I:	report the counts in each interval,\n"
 	    "\t\t\tinstead of rates, where applicable\n"
 	    "\t\t-l n:	Limit the number of disks to n\n"
+	    "\t\t-L:	display latency percentiles (implies -x),\n"
+	    "\t\t\tfor devices with latency histogram kstats\n"
 	    "\t\t-m:	Display mount points (most useful with -p)\n"
 	    "\t\t-M:	Display data throughput in MB/sec "
 	    "instead of Kb/sec\n"
@@ -1083,7 +1193,7 @@ do_args(int argc, char **argv)
 	extern char	*optarg;
 	extern int	optind;
 
-	while ((c = getopt(argc, argv, "tdDxXYCciIpPnmMeEszrT:l:")) != EOF)
+	while ((c = getopt(argc, argv, "tdDxXYCciILpPnmMeEszrT:l:")) != EOF)
 		switch (c) {
 		case 't':
 			do_tty++;
@@ -1118,6 +1228,9 @@ do_args(int argc, char **argv)
 		case 'I':
 			do_interval++;
 			break;
+		case 'L':
+			do_disk |= DISK_LATENCIES;
+			break;
 		case 'p':
 			do_partitions++;
 			break;
@@ -1193,6 +1306,10 @@ do_args(int argc, char **argv)
 	    !(do_disk & PRINT_VERTICAL))
 		do_disk |= DISK_EXTENDED;
 
+	/* latency percentiles (-L) are extra -x columns */
+	if (do_disk & DISK_LATENCIES)
+		do_disk |= DISK_EXTENDED;
+
 	/*
 	 * If conflicting options take the preferred
 	 * -D and -x result in -x
@@ -1286,6 +1403,15 @@ do_format(void)
 		} else
 			(void) sprintf(header, "s/w,h/w,trn,tot");
 	}
+	if (do_disk & DISK_LATENCIES) {
+		if (do_raw == 0) {
+			(void) strcat(header, "   p50    p95    p99 ");
+		} else {
+			if (*header != '\0')
+				(void) strcat(header, ",");
+			(void) strcat(header, "p50,p95,p99");
+		}
+	}
 	switch (do_disk & DISK_IO_MASK) {
 		case DISK_OLD:
 			if (do_raw == 0)
@@ -1704,6 +1830,21 @@ print_err_hdr(void)
 	push_out("---- errors --- ");
 }
 
+/*
+ * Emit the centered banner over the latency percentile columns when -L
+ * is specified.
+ */
+static void
+print_lat_hdr(void)
+{
+	if (do_raw) {
+		push_out("latency");
+		return;
+	}
+
+	push_out("---- latency (ms) -- ");
+}
+
 /*
  * Emit the header string when -e is specified.
  */
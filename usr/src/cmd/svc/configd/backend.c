@@ -88,6 +88,20 @@ typedef struct backend_totals {
 	backend_spent_t	bt_exec;	/* time spent executing SQL */
 } backend_totals_t;
 
+/*
+ * Each backend_new_id() refill reserves a block of this many ids with a
+ * single SELECT/UPDATE pair, and later allocations are served from memory.
+ * Ids still in the block when a transaction rolls back (or when svc.configd
+ * exits) are discarded; the id spaces are 32 bits wide, so the waste is
+ * harmless.
+ */
+#define	BACKEND_ID_BLOCK	8
+
+typedef struct backend_idcache {
+	uint32_t	bic_next;	/* next id to hand out */
+	uint32_t	bic_left;	/* ids remaining in the block */
+} backend_idcache_t;
+
 /*
  * There are times when svcadm asks configd to move the BACKEND_TYPE_NORMAL
  * repository to volatile storage.  See backend_switch().  When the
@@ -110,6 +124,8 @@ typedef struct sqlite_backend {
 	backend_type_t	be_type;	/* type of db */
 	hrtime_t	be_lastcheck;	/* time of last read-only check */
 	backend_totals_t be_totals[2];	/* one for reading, one for writing */
+	sqlite_vm	*be_vms[BACKEND_STMT_MAX];  /* compiled statements */
+	backend_idcache_t be_ids[BACKEND_ID_INVALID];	/* reserved id blocks */
 } sqlite_backend_t;
 
 struct backend_tx {
@@ -145,6 +161,25 @@ struct backend_idx_info {
 	const char *bxi_cols;
 };
 
+/*
+ * SQL text for the statements cached by backend_tx_run_prepared(), indexed
+ * by enum backend_statement.  These are the statements a transaction commit
+ * executes once per property or value row; everything else goes through
+ * the plain text interfaces.  Note that the value_tbl statement assumes an
+ * upgraded (value-ordered) schema, which is safe because the repository is
+ * upgraded before it accepts its first write.
+ */
+static const char *backend_stmt_sql[BACKEND_STMT_MAX] = {
+	"INSERT INTO prop_lnk_tbl "
+	"    (lnk_pg_id, lnk_gen_id, lnk_prop_name, lnk_prop_type, "
+	"    lnk_val_id) "
+	"VALUES (?, ?, ?, ?, ?);",
+
+	"INSERT INTO value_tbl (value_id, value_type, value_value, "
+	"    value_order) "
+	"VALUES (?, ?, ?, ?);"
+};
+
 /* Definitions for the flight recorder: */
 
 typedef enum be_flight_type {
@@ -621,6 +656,35 @@ backend_error(sqlite_backend_t *be, int error, char *errmsg)
 	}
 }
 
+/*
+ * Throw away the compiled statements cached on be.  This must be done
+ * before be_db is closed or replaced, since the virtual machines hold
+ * references to it.
+ */
+static void
+backend_statements_flush(sqlite_backend_t *be)
+{
+	int idx;
+
+	for (idx = 0; idx < BACKEND_STMT_MAX; idx++) {
+		if (be->be_vms[idx] != NULL) {
+			(void) sqlite_finalize(be->be_vms[idx], NULL);
+			be->be_vms[idx] = NULL;
+		}
+	}
+}
+
+/*
+ * Throw away any ids still reserved on be.  This must be done whenever a
+ * transaction rolls back, since the UPDATE which reserved the block may
+ * have been undone, and whenever be_db is replaced.
+ */
+static void
+backend_idcache_flush(sqlite_backend_t *be)
+{
+	(void) memset(be->be_ids, 0, sizeof (be->be_ids));
+}
+
 static void
 backend_backup_cleanup(const char **out_arg, ssize_t out_sz)
 {
@@ -1324,6 +1388,8 @@ backend_check_readonly(sqlite_backend_t *be, int writing, hrtime_t t)
 	} else {
 		flight_recorder_event(BE_FLIGHT_EV_TRANS_RW,
 		    BE_FLIGHT_ST_SWITCH);
+		backend_statements_flush(be);
+		backend_idcache_flush(be);
 		sqlite_close(be->be_db);
 		be->be_db = new;
 	}
@@ -1414,6 +1480,8 @@ static void
 backend_destroy(sqlite_backend_t *be)
 {
 	if (be->be_db != NULL) {
+		backend_statements_flush(be);
+		backend_idcache_flush(be);
 		sqlite_close(be->be_db);
 		be->be_db = NULL;
 	}
@@ -1684,6 +1752,8 @@ backend_switch(int dir)
 				result = REP_PROTOCOL_FAIL_NO_RESOURCES;
 				sqlite_close(new);
 			} else {
+				backend_statements_flush(be);
+				backend_idcache_flush(be);
 				sqlite_close(be->be_db);
 				be->be_db = new;
 				if (dir) {
@@ -2154,6 +2224,8 @@ backend_tx_end(backend_tx_t *tx)
 		 */
 		new = sqlite_open(be->be_path, 0600, NULL);
 		if (new != NULL) {
+			backend_statements_flush(be);
+			backend_idcache_flush(be);
 			sqlite_close(be->be_db);
 			be->be_db = new;
 		}
@@ -2230,6 +2302,7 @@ backend_tx_rollback(backend_tx_t *tx)
 		tx->bt_full = 1;
 	(void) backend_error(be, r, errmsg);
 
+	backend_idcache_flush(be);
 	backend_tx_end(tx);
 }
 
@@ -2265,6 +2338,7 @@ backend_tx_commit(backend_tx_t *tx)
 		if (r2 != REP_PROTOCOL_SUCCESS)
 			backend_panic("cannot rollback failed commit");
 
+		backend_idcache_flush(be);
 		backend_tx_end(tx);
 		return (r);
 	}
@@ -2310,10 +2384,23 @@ backend_new_id(backend_tx_t *tx, enum id_space id)
 	char *errmsg;
 	int ret;
 	sqlite_backend_t *be;
+	backend_idcache_t *bic;
 	hrtime_t ts, vts;
 
 	assert(tx != NULL && tx->bt_be != NULL && !tx->bt_readonly);
 	be = tx->bt_be;
+	bic = &be->be_ids[id];
+
+	/*
+	 * Serve the id from the reserved block when we can.  The block was
+	 * reserved by this transaction or by an earlier committed one, and
+	 * the cache is flushed on rollback, so an id is never handed out
+	 * twice.
+	 */
+	if (bic->bic_left > 0) {
+		bic->bic_left--;
+		return (bic->bic_next++);
+	}
 
 	info.rs_out = &new_id;
 	info.rs_result = REP_PROTOCOL_FAIL_NOT_FOUND;
@@ -2322,8 +2409,10 @@ backend_new_id(backend_tx_t *tx, enum id_space id)
 	vts = gethrvtime();
 	ret = sqlite_exec_printf(be->be_db,
 	    "SELECT id_next FROM id_tbl WHERE (id_name = '%q');"
-	    "UPDATE id_tbl SET id_next = id_next + 1 WHERE (id_name = '%q');",
-	    run_single_int_callback, &info, &errmsg, name, name);
+	    "UPDATE id_tbl SET id_next = id_next + %d "
+	    "    WHERE (id_name = '%q');",
+	    run_single_int_callback, &info, &errmsg, name,
+	    BACKEND_ID_BLOCK, name);
 	UPDATE_TOTALS(be, bt_exec, ts, vts);
 	if (ret == SQLITE_FULL)
 		tx->bt_full = 1;
@@ -2334,9 +2423,90 @@ backend_new_id(backend_tx_t *tx, enum id_space id)
 		return (0);
 	}
 
+	bic->bic_next = new_id + 1;
+	bic->bic_left = BACKEND_ID_BLOCK - 1;
+
 	return (new_id);
 }
 
+/*
+ * Runs one of the cached statements (see backend_stmt_sql, above),
+ * binding argv[0 .. argc - 1] to its parameters in order.  A NULL
+ * argument binds SQL NULL.  The compiled statement is kept on the
+ * backend for reuse, so the SQL text is only parsed once per database
+ * handle; note that this bypasses the -t trace hook, which only sees
+ * SQL executed as text.
+ *
+ * Returns
+ *   _NO_RESOURCES - out of memory
+ *   _SUCCESS
+ */
+int
+backend_tx_run_prepared(backend_tx_t *tx, enum backend_statement stmt,
+    int argc, const char **argv)
+{
+	char *errmsg = NULL;
+	const char *unused;
+	const char **vals;
+	const char **names;
+	int columns;
+	int idx;
+	int ret = SQLITE_OK;
+	sqlite_vm *vm;
+	sqlite_backend_t *be;
+	hrtime_t ts, vts;
+
+	assert(tx != NULL && tx->bt_be != NULL && !tx->bt_readonly);
+	assert(stmt >= 0 && stmt < BACKEND_STMT_MAX);
+	be = tx->bt_be;
+
+	ts = gethrtime();
+	vts = gethrvtime();
+
+	if ((vm = be->be_vms[stmt]) == NULL) {
+		ret = sqlite_compile(be->be_db, backend_stmt_sql[stmt],
+		    &unused, &vm, &errmsg);
+		if (ret != SQLITE_OK) {
+			UPDATE_TOTALS(be, bt_exec, ts, vts);
+			if (ret == SQLITE_FULL)
+				tx->bt_full = 1;
+			return (backend_error(be, ret, errmsg));
+		}
+		be->be_vms[stmt] = vm;
+	}
+
+	for (idx = 0; idx < argc; idx++) {
+		ret = sqlite_bind(vm, idx + 1, argv[idx], -1, 1);
+		if (ret != SQLITE_OK)
+			break;
+	}
+
+	if (ret != SQLITE_OK) {
+		(void) sqlite_reset(vm, NULL);
+		UPDATE_TOTALS(be, bt_exec, ts, vts);
+		return (backend_error(be, ret, NULL));
+	}
+
+	while ((ret = sqlite_step(vm, &columns, &vals, &names)) == SQLITE_ROW)
+		;
+
+	/*
+	 * sqlite_reset() reports the result of the execution and leaves
+	 * the virtual machine ready for another round of binding.  If it
+	 * fails, throw the compiled statement away; the next caller will
+	 * recompile it against the current schema.
+	 */
+	ret = sqlite_reset(vm, &errmsg);
+	UPDATE_TOTALS(be, bt_exec, ts, vts);
+	if (ret == SQLITE_FULL)
+		tx->bt_full = 1;
+	if (ret != SQLITE_OK) {
+		(void) sqlite_finalize(vm, NULL);
+		be->be_vms[stmt] = NULL;
+	}
+	return (backend_error(be, ret, errmsg));
+}
+
 /*
  * Returns
  *   _NO_RESOURCES - out of memory
@@ -1644,6 +1644,52 @@ property_get_value(repcache_client_t *cp, const void *in, size_t insz,
 		*outsz = sizeof (out->rpr_response);
 }
 
+/*
+ * Fails with:
+ *	_UNKNOWN_ID - an id does not designate an active register
+ *	_NOT_SET - The property group is not set
+ *	_DELETED - The property group has been deleted
+ *	_TYPE_MISMATCH - The object is not a property group
+ *	_NOT_APPLICABLE - The property group is composed
+ *	_PERMISSION_DENIED - The property group is read protected
+ *	_TRUNCATED - The encoded properties do not fit in the response
+ *	_NO_RESOURCES - Out of memory
+ *
+ * Succeeds with:
+ *	_SUCCESS - The response holds every property of the group.
+ */
+/*ARGSUSED*/
+static void
+propertygrp_get_all(repcache_client_t *cp, const void *in, size_t insz,
+    void *out_arg, size_t *outsz, void *arg)
+{
+	const struct rep_protocol_propertygrp_request *rpr = in;
+	struct rep_protocol_contents_response *out = out_arg;
+	repcache_entity_t *ep;
+
+	assert(*outsz == sizeof (*out));
+
+	ep = entity_find(cp, rpr->rpr_entityid);
+	if (ep == NULL) {
+		out->rpr_response = REP_PROTOCOL_FAIL_UNKNOWN_ID;
+		*outsz = sizeof (out->rpr_response);
+		return;
+	}
+
+	out->rpr_response = rc_node_get_pg_contents(&ep->re_node, out,
+	    outsz);
+
+	entity_release(ep);
+
+	/*
+	 * If we fail, we only return the response code.
+	 * If we succeed, rc_node_get_pg_contents has shortened *outsz
+	 * to only include the bytes in use.
+	 */
+	if (out->rpr_response != REP_PROTOCOL_SUCCESS)
+		*outsz = sizeof (out->rpr_response);
+}
+
 static rep_protocol_responseid_t
 propertygrp_notify(repcache_client_t *cp,
     struct rep_protocol_propertygrp_request *rpr, int *out_fd)
@@ -2134,6 +2180,12 @@ typedef void protocol_handler_fdret_f(repcache_client_t *, const void *in,
 		    sizeof (struct rep_protocol_value_response), 0	\
 	}
 
+#define	PROTO_CONTENTS_OUT(p, f, in) {					\
+		p, #p, &(f), NULL, NULL,				\
+		    sizeof (in),					\
+		    sizeof (struct rep_protocol_contents_response), 0	\
+	}
+
 #define	PROTO_PANIC(p)	{ p, #p, NULL, NULL, NULL, 0, 0, PROTO_FLAG_PANIC }
 #define	PROTO_END()	{ 0, NULL, NULL, NULL, NULL, 0, 0, PROTO_FLAG_PANIC }
 
@@ -2229,6 +2281,9 @@ static struct protocol_entry {
 	PROTO(REP_PROTOCOL_SWITCH,			repository_switch,
 	    struct rep_protocol_switch_request),
 
+	PROTO_CONTENTS_OUT(REP_PROTOCOL_PROPERTYGRP_GET_ALL,
+	    propertygrp_get_all, struct rep_protocol_propertygrp_request),
+
 	PROTO_END()
 };
 #undef PROTO
@@ -698,6 +698,8 @@ int rc_node_get_parent(rc_node_ptr_t *, uint32_t, rc_node_ptr_t *);
 int rc_node_get_property_type(rc_node_ptr_t *, rep_protocol_value_type_t *);
 int rc_node_get_property_value(rc_node_ptr_t *,
     struct rep_protocol_value_response *, size_t *);
+int rc_node_get_pg_contents(rc_node_ptr_t *,
+    struct rep_protocol_contents_response *, size_t *);
 int rc_node_create_child(rc_node_ptr_t *, uint32_t, const char *,
     rc_node_ptr_t *);
 int rc_node_create_child_pg(rc_node_ptr_t *, uint32_t, const char *,
@@ -821,7 +823,21 @@ enum id_space {
 	BACKEND_ID_INVALID	/* always illegal */
 };
 
+/*
+ * Statements executed once per property or value row during transaction
+ * commits and imports are kept compiled on the database handle, and run
+ * through backend_tx_run_prepared() with their arguments bound in place
+ * of re-parsing the SQL text each time.
+ */
+enum backend_statement {
+	BACKEND_STMT_PROP_LNK_INSERT,
+	BACKEND_STMT_VALUE_INSERT,
+	BACKEND_STMT_MAX	/* always last */
+};
+
 uint32_t backend_new_id(backend_tx_t *, enum id_space);
+int backend_tx_run_prepared(backend_tx_t *, enum backend_statement, int,
+    const char **);
 int backend_tx_run_update(backend_tx_t *, const char *, ...);
 int backend_tx_run_update_changed(backend_tx_t *, const char *, ...);
 int backend_tx_run_single_int(backend_tx_t *tx, backend_query_t *q,
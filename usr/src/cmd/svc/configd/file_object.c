@@ -2093,6 +2093,32 @@ object_copy_string(void *data_arg, int columns, char **vals, char **names)
 	return (BACKEND_CALLBACK_CONTINUE);
 }
 
+struct snapshot_name_info {
+	char		**sni_service;
+	char		**sni_instance;
+};
+
+/*ARGSUSED*/
+static int
+object_snapshot_copy_names(void *data_arg, int columns, char **vals,
+    char **names)
+{
+	struct snapshot_name_info *info = data_arg;
+
+	assert(columns == 2);
+
+	if (vals[0] == NULL || vals[1] == NULL)
+		return (BACKEND_CALLBACK_ABORT);
+
+	if ((*info->sni_service = strdup(vals[0])) == NULL)
+		return (BACKEND_CALLBACK_ABORT);
+
+	if ((*info->sni_instance = strdup(vals[1])) == NULL)
+		return (BACKEND_CALLBACK_ABORT);
+
+	return (BACKEND_CALLBACK_CONTINUE);
+}
+
 struct snaplevel_add_info {
 	backend_query_t *sai_q;
 	uint32_t	sai_level_id;
@@ -2138,19 +2164,21 @@ object_snapshot_add_level(backend_tx_t *tx, uint32_t snap_id,
 		return (REP_PROTOCOL_FAIL_NO_RESOURCES);
 	}
 
-	result = backend_tx_run_update(tx,
+	/*
+	 * The level insert produces no rows, so it can ride along with the
+	 * pg query in a single grouped statement.
+	 */
+	q = backend_query_alloc();
+	backend_query_add(q,
 	    "INSERT INTO snaplevel_tbl "
 	    "    (snap_id, snap_level_num, snap_level_id, "
 	    "    snap_level_service_id, snap_level_service, "
 	    "    snap_level_instance_id, snap_level_instance) "
-	    "VALUES (%d, %d, %d, %d, %Q, %d, %Q);",
-	    snap_id, snap_level_num, data.sai_level_id, svc_id, svc_name,
-	    inst_id, inst_name);
-
-	q = backend_query_alloc();
-	backend_query_add(q,
+	    "VALUES (%d, %d, %d, %d, %Q, %d, %Q); "
 	    "SELECT pg_id, pg_name, pg_type, pg_flags, pg_gen_id FROM pg_tbl "
 	    "WHERE (pg_parent_id = %d);",
+	    snap_id, snap_level_num, data.sai_level_id, svc_id, svc_name,
+	    inst_id, inst_name,
 	    (inst_name != NULL)? inst_id : svc_id);
 
 	data.sai_q = backend_query_alloc();
@@ -2194,7 +2222,42 @@ object_snapshot_do_take(uint32_t instid, const char *inst_name,
 		goto fail;
 	}
 
-	if (svc_name == NULL) {
+	if (svc_name == NULL && inst_name == NULL) {
+		struct snapshot_name_info ninfo;
+
+		/*
+		 * Look up both names in a single round trip; this is the
+		 * common case, since object_snapshot_attach() never has
+		 * them on hand.
+		 */
+		ninfo.sni_service = &svc_name_alloc;
+		ninfo.sni_instance = &inst_name_alloc;
+
+		q = backend_query_alloc();
+		backend_query_add(q,
+		    "SELECT svc_name, instance_name "
+		    "FROM service_tbl, instance_tbl "
+		    "WHERE (svc_id = %d AND instance_id = %d)",
+		    svcid, instid);
+		result = backend_tx_run(tx, q, object_snapshot_copy_names,
+		    &ninfo);
+		backend_query_free(q);
+
+		if (result == REP_PROTOCOL_DONE) {
+			result = REP_PROTOCOL_FAIL_NO_RESOURCES;
+			goto fail;
+		}
+		if (result == REP_PROTOCOL_SUCCESS &&
+		    (svc_name_alloc == NULL || inst_name_alloc == NULL))
+			backend_panic("unable to find names for instance "
+			    "id %d\n", instid);
+
+		if (result != REP_PROTOCOL_SUCCESS)
+			goto fail;
+
+		svc_name = svc_name_alloc;
+		inst_name = inst_name_alloc;
+	} else if (svc_name == NULL) {
 		q = backend_query_alloc();
 		backend_query_add(q,
 		    "SELECT svc_name FROM service_tbl "
@@ -192,6 +192,13 @@ tx_process_cmds(tx_commit_data_t *data)
 	uint32_t val_id = 0;
 	uint8_t type[3];
 
+	char pg_id_str[16];
+	char gen_str[16];
+	char val_id_str[16];
+	char order_str[16];
+	char vtype[2];
+	const char *argv[5];
+
 	backend_query_t *q;
 	int do_delete;
 
@@ -224,6 +231,13 @@ tx_process_cmds(tx_commit_data_t *data)
 	else
 		return (r);
 
+	/*
+	 * The pg and generation ids are common to every row we insert
+	 * below, so render them once for the prepared statements.
+	 */
+	(void) snprintf(pg_id_str, sizeof (pg_id_str), "%u", data->txc_pg_id);
+	(void) snprintf(gen_str, sizeof (gen_str), "%u", data->txc_gen);
+
 	for (idx = 0; idx < count; idx++) {
 		elem = &data->txc_cmds[idx];
 
@@ -273,14 +287,16 @@ tx_process_cmds(tx_commit_data_t *data)
 		type[1] = REP_PROTOCOL_SUBTYPE(elem->tx_cmd->rptc_type);
 		type[2] = 0;
 
+		argv[0] = pg_id_str;
+		argv[1] = gen_str;
+		argv[2] = elem->tx_prop;
+		argv[3] = (const char *)type;
+
 		if (elem->tx_nvalues == 0) {
-			r = backend_tx_run_update(data->txc_tx,
-			    "INSERT INTO prop_lnk_tbl"
-			    "    (lnk_pg_id, lnk_gen_id, "
-			    "    lnk_prop_name, lnk_prop_type, lnk_val_id) "
-			    "VALUES ( %d, %d, '%q', '%q', NULL );",
-			    data->txc_pg_id, data->txc_gen, elem->tx_prop,
-			    type);
+			argv[4] = NULL;		/* lnk_val_id is NULL */
+
+			r = backend_tx_run_prepared(data->txc_tx,
+			    BACKEND_STMT_PROP_LNK_INSERT, 5, argv);
 		} else {
 			uint32_t *v, i = 0;
 			const char *str;
@@ -288,16 +304,19 @@ tx_process_cmds(tx_commit_data_t *data)
 			val_id = backend_new_id(data->txc_tx, BACKEND_ID_VALUE);
 			if (val_id == 0)
 				return (REP_PROTOCOL_FAIL_NO_RESOURCES);
-			r = backend_tx_run_update(data->txc_tx,
-			    "INSERT INTO prop_lnk_tbl "
-			    "    (lnk_pg_id, lnk_gen_id, "
-			    "    lnk_prop_name, lnk_prop_type, lnk_val_id) "
-			    "VALUES ( %d, %d, '%q', '%q', %d );",
-			    data->txc_pg_id, data->txc_gen, elem->tx_prop,
-			    type, val_id);
+
+			(void) snprintf(val_id_str, sizeof (val_id_str),
+			    "%u", val_id);
+			argv[4] = val_id_str;
+
+			r = backend_tx_run_prepared(data->txc_tx,
+			    BACKEND_STMT_PROP_LNK_INSERT, 5, argv);
 
 			v = elem->tx_values;
 
+			vtype[0] = (char)elem->tx_cmd->rptc_type;
+			vtype[1] = 0;
+
 			for (i = 0; i < elem->tx_nvalues; i++) {
 				str = (const char *)&v[1];
 
@@ -312,13 +331,15 @@ tx_process_cmds(tx_commit_data_t *data)
 				 * it is upgraded as soon as the repository
 				 * is writable.
 				 */
-				r = backend_tx_run_update(data->txc_tx,
-				    "INSERT INTO value_tbl (value_id, "
-				    "value_type, value_value, "
-				    "value_order) VALUES (%d, '%c', "
-				    "'%q', '%d');\n",
-				    val_id, elem->tx_cmd->rptc_type,
-				    str, i);
+				(void) snprintf(order_str, sizeof (order_str),
+				    "%u", i);
+				argv[0] = val_id_str;
+				argv[1] = vtype;
+				argv[2] = str;
+				argv[3] = order_str;
+
+				r = backend_tx_run_prepared(data->txc_tx,
+				    BACKEND_STMT_VALUE_INSERT, 4, argv);
 				if (r != REP_PROTOCOL_SUCCESS)
 					break;
 
@@ -6171,6 +6171,144 @@ rc_node_get_property_value(rc_node_ptr_t *npp,
 	return (ret);
 }
 
+/*
+ * Encode every property of the property group npp references into *out,
+ * as a sequence of TX_SIZE()-aligned REP_PROTOCOL_TX_ENTRY_NEW
+ * transaction commands, in the same order an iterator would visit them.
+ *
+ * The per-property read authorization checks are all made against the
+ * parent property group (see rc_node_property_may_read()), so a single
+ * read-protection check up front covers everything we return.  If the
+ * group is read protected we fail wholesale, and the client falls back
+ * to reading it property by property so that the finer-grained checks
+ * (and their audit events) apply.
+ *
+ * Fails with
+ *   _NOT_SET - npp is reset
+ *   _DELETED - npp's node has been deleted
+ *   _TYPE_MISMATCH - npp's node is not a property group
+ *   _NOT_APPLICABLE - npp's node is a composed property group
+ *   _PERMISSION_DENIED - the group is read protected
+ *   _NO_RESOURCES - out of memory
+ *   _TRUNCATED - the encoded properties do not fit in *out
+ *
+ * We shorten *sz_out to only include the bytes in use.
+ */
+int
+rc_node_get_pg_contents(rc_node_ptr_t *npp,
+    struct rep_protocol_contents_response *out, size_t *sz_out)
+{
+	rc_node_t *np;
+	rc_node_t *cp;
+	uint8_t *data = out->rpr_contents;
+	size_t used = 0;
+	int ret;
+
+	assert(*sz_out == sizeof (*out));
+
+	RC_NODE_PTR_GET_CHECK_AND_HOLD(np, npp);
+
+	if (np->rn_id.rl_type == REP_PROTOCOL_ENTITY_CPROPERTYGRP) {
+		rc_node_rele(np);
+		return (REP_PROTOCOL_FAIL_NOT_APPLICABLE);
+	}
+
+	if (np->rn_id.rl_type != REP_PROTOCOL_ENTITY_PROPERTYGRP) {
+		rc_node_rele(np);
+		return (REP_PROTOCOL_FAIL_TYPE_MISMATCH);
+	}
+
+	if (!client_is_privileged()) {
+#ifdef NATIVE_BUILD
+		ret = REP_PROTOCOL_FAIL_PERMISSION_DENIED;
+#else
+		ret = rc_node_pg_check_read_protect(np);
+#endif
+		if (ret != REP_PROTOCOL_SUCCESS) {
+			rc_node_rele(np);
+			return (ret);
+		}
+	}
+	rc_node_rele(np);
+
+	RC_NODE_PTR_GET_CHECK_AND_LOCK(np, npp);
+
+	ret = rc_node_fill_children(np, REP_PROTOCOL_ENTITY_PROPERTY);
+	if (ret != REP_PROTOCOL_SUCCESS) {
+		(void) pthread_mutex_unlock(&np->rn_lock);
+		return (ret);
+	}
+
+	for (cp = uu_list_first(np->rn_children); cp != NULL;
+	    cp = uu_list_next(np->rn_children, cp)) {
+		struct rep_protocol_transaction_cmd *cmd;
+		const char *v;
+		uint8_t *vdata;
+		size_t sz, len, count;
+
+		if (cp->rn_id.rl_type != REP_PROTOCOL_ENTITY_PROPERTY)
+			continue;
+
+		(void) pthread_mutex_lock(&cp->rn_lock);
+
+		/*
+		 * Work out the encoded size first: the name, then a
+		 * (length, bytes) pair per value.
+		 */
+		len = strlen(cp->rn_name) + 1;
+		sz = TX_SIZE(len);
+		for (count = cp->rn_values_count, v = cp->rn_values;
+		    count > 0; --count) {
+			size_t vlen = strlen(v) + 1;
+
+			sz += TX_SIZE(sizeof (uint32_t) + vlen);
+			v += vlen;
+		}
+
+		if (used + TX_SIZE(REP_PROTOCOL_TRANSACTION_CMD_SIZE(sz)) >
+		    sizeof (out->rpr_contents)) {
+			(void) pthread_mutex_unlock(&cp->rn_lock);
+			(void) pthread_mutex_unlock(&np->rn_lock);
+			return (REP_PROTOCOL_FAIL_TRUNCATED);
+		}
+
+		/* don't leak our stack into the alignment padding */
+		(void) memset(data + used, 0,
+		    TX_SIZE(REP_PROTOCOL_TRANSACTION_CMD_SIZE(sz)));
+
+		/* LINTED alignment */
+		cmd = (struct rep_protocol_transaction_cmd *)(data + used);
+		cmd->rptc_action = REP_PROTOCOL_TX_ENTRY_NEW;
+		cmd->rptc_type = cp->rn_valtype;
+		cmd->rptc_size = REP_PROTOCOL_TRANSACTION_CMD_SIZE(sz);
+		cmd->rptc_name_len = len;
+		(void) memcpy(cmd->rptc_data, cp->rn_name, len);
+
+		vdata = &cmd->rptc_data[TX_SIZE(len)];
+		for (count = cp->rn_values_count, v = cp->rn_values;
+		    count > 0; --count) {
+			size_t vlen = strlen(v) + 1;
+
+			/* LINTED alignment */
+			*(uint32_t *)vdata = vlen;
+			(void) memcpy(vdata + sizeof (uint32_t), v, vlen);
+			vdata += TX_SIZE(sizeof (uint32_t) + vlen);
+			v += vlen;
+		}
+
+		(void) pthread_mutex_unlock(&cp->rn_lock);
+
+		used += TX_SIZE(REP_PROTOCOL_TRANSACTION_CMD_SIZE(sz));
+	}
+	(void) pthread_mutex_unlock(&np->rn_lock);
+
+	out->rpr_size = used;
+	*sz_out = offsetof(struct rep_protocol_contents_response,
+	    rpr_contents[used]);
+
+	return (REP_PROTOCOL_SUCCESS);
+}
+
 int
 rc_iter_next_value(rc_node_iter_t *iter,
     struct rep_protocol_value_response *out, size_t *sz_out, int repeat)
@@ -780,6 +780,74 @@ path_to_str(int *path, char **cpp, size_t *sz)
 }
 
 
+/*
+ * Find the up instance in v's dependency subtree which came up last,
+ * i.e. the dependency which determined when v could start.  Group and
+ * service vertices are descended through; the dependency graph is
+ * acyclic, so the recursion terminates.
+ */
+static graph_vertex_t *
+latest_up_dependency(graph_vertex_t *v)
+{
+	graph_edge_t *e;
+	graph_vertex_t *latest = NULL, *cand;
+
+	assert(MUTEX_HELD(&dgraph_lock));
+
+	for (e = uu_list_first(v->gv_dependencies);
+	    e != NULL;
+	    e = uu_list_next(v->gv_dependencies, e)) {
+		cand = e->ge_vertex;
+
+		/* exclusions don't gate when v could start */
+		if (cand->gv_type == GVT_GROUP &&
+		    cand->gv_depgroup == DEPGRP_EXCLUDE_ALL)
+			continue;
+
+		if (cand->gv_type != GVT_INST)
+			cand = latest_up_dependency(cand);
+
+		if (cand == NULL || !up_state(cand->gv_state) ||
+		    cand->gv_online_time == 0)
+			continue;
+
+		if (latest == NULL ||
+		    cand->gv_online_time > latest->gv_online_time)
+			latest = cand;
+	}
+
+	return (latest);
+}
+
+/*
+ * Log the boot critical path: starting from the milestone instance,
+ * repeatedly step to the dependency which came up last.  The resulting
+ * chain is the sequence of services which bounded how quickly the
+ * milestone could be reached; shortening any other service does not
+ * speed up boot.  Times are relative to gethrtime() origin, i.e. boot.
+ */
+static void
+graph_log_critical_path(const char *fmri)
+{
+	graph_vertex_t *v;
+
+	assert(MUTEX_HELD(&dgraph_lock));
+
+	v = vertex_get_by_name(fmri);
+	if (v == NULL || !up_state(v->gv_state))
+		return;
+
+	log_framework(LOG_INFO, "boot critical path (latest dependency "
+	    "first):\n");
+
+	for (; v != NULL; v = latest_up_dependency(v)) {
+		log_framework(LOG_INFO, "boot critical path: %4llu.%03llus "
+		    "%s\n", (u_longlong_t)(v->gv_online_time / NANOSEC),
+		    (u_longlong_t)((v->gv_online_time % NANOSEC) / 1000000),
+		    v->gv_name);
+	}
+}
+
 /*
  * This function along with run_sulogin() implements an exclusion relationship
  * between system/console-login and sulogin.  run_sulogin() will fail if
@@ -838,7 +906,19 @@ graph_post_mu_disable(void)
 static void
 graph_post_mus_online(void)
 {
+	static boolean_t critical_path_logged = B_FALSE;
+
 	graph_runlevel_changed('3', 1);
+
+	/*
+	 * The first time the default boot target comes up is the end of
+	 * boot as far as the graph engine is concerned; report how we
+	 * got here.
+	 */
+	if (!critical_path_logged) {
+		critical_path_logged = B_TRUE;
+		graph_log_critical_path(multi_user_svr_fmri);
+	}
 }
 
 static void
@@ -4801,6 +4881,9 @@ dgraph_set_instance_state(scf_handle_t *h, const char *inst_name,
 	old_state = v->gv_state;
 	v->gv_state = state;
 
+	if (up_state(state) && !up_state(old_state))
+		v->gv_online_time = gethrtime();
+
 	v->gv_reason = states->ps_reason;
 	err = gt_transition(h, v, serr, old_state);
 	if (err == 0 && v->gv_state != old_state) {
@@ -329,6 +329,12 @@ typedef struct graph_vertex {
 
 	int32_t				gv_stn_tset;
 	int32_t				gv_reason;
+
+	/*
+	 * Time (gethrtime()) at which the instance last entered an up
+	 * state.  Used for the boot critical-path report.
+	 */
+	hrtime_t			gv_online_time;
 } graph_vertex_t;
 
 typedef struct graph_edge {
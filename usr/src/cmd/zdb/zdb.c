@@ -3456,6 +3456,9 @@ typedef struct zdb_cb {
 	int		zcb_haderrors;
 	spa_t		*zcb_spa;
 	uint32_t	**zcb_vd_obsolete_counts;
+	uint64_t	*zcb_vd_verify_bytes;
+	uint64_t	*zcb_vd_verify_blocks;
+	uint64_t	zcb_vd_count;
 } zdb_cb_t;
 
 /* test if two DVA offsets from same vdev are within the same metaslab */
@@ -3604,6 +3607,15 @@ zdb_blkptr_done(zio_t *zio)
 	spa->spa_load_verify_ios--;
 	cv_broadcast(&spa->spa_scrub_io_cv);
 
+	if (ioerr == 0 && zcb->zcb_vd_verify_bytes != NULL) {
+		uint64_t vdev = DVA_GET_VDEV(&bp->blk_dva[0]);
+
+		if (vdev < zcb->zcb_vd_count) {
+			zcb->zcb_vd_verify_bytes[vdev] += BP_GET_PSIZE(bp);
+			zcb->zcb_vd_verify_blocks[vdev]++;
+		}
+	}
+
 	if (ioerr && !(zio->io_flags & ZIO_FLAG_SPECULATIVE)) {
 		char blkbuf[BP_SPRINTF_LEN];
 
@@ -4570,6 +4582,14 @@ dump_block_stats(spa_t *spa)
 	if (dump_opt['c'] > 1)
 		flags |= TRAVERSE_PREFETCH_DATA;
 
+	if (dump_opt['c']) {
+		zcb.zcb_vd_count = spa->spa_root_vdev->vdev_children;
+		zcb.zcb_vd_verify_bytes = umem_zalloc(zcb.zcb_vd_count *
+		    sizeof (uint64_t), UMEM_NOFAIL);
+		zcb.zcb_vd_verify_blocks = umem_zalloc(zcb.zcb_vd_count *
+		    sizeof (uint64_t), UMEM_NOFAIL);
+	}
+
 	zcb.zcb_totalasize = metaslab_class_get_alloc(spa_normal_class(spa));
 	zcb.zcb_totalasize += metaslab_class_get_alloc(spa_special_class(spa));
 	zcb.zcb_totalasize += metaslab_class_get_alloc(spa_dedup_class(spa));
@@ -4590,6 +4610,38 @@ dump_block_stats(spa_t *spa)
 		}
 	}
 
+	/*
+	 * Show how much each top-level vdev contributed to the checksum
+	 * verification pass and the rate it sustained, so that a slow disk
+	 * dragging down the pool-wide rate is easy to spot.
+	 */
+	if (dump_opt['c'] && zcb.zcb_vd_count != 0) {
+		uint64_t ms = MAX((gethrtime() - zcb.zcb_start) /
+		    1000 / 1000, 1);
+
+		(void) printf("\nVerification throughput by top-level "
+		    "vdev:\n\n");
+		(void) printf("\t%4s %15s %15s %10s\n",
+		    "vdev", "blocks", "bytes", "MB/s");
+		for (uint64_t v = 0; v < zcb.zcb_vd_count; v++) {
+			if (zcb.zcb_vd_verify_blocks[v] == 0)
+				continue;
+			(void) printf("\t%4llu %15llu %15llu %10llu\n",
+			    (u_longlong_t)v,
+			    (u_longlong_t)zcb.zcb_vd_verify_blocks[v],
+			    (u_longlong_t)zcb.zcb_vd_verify_bytes[v],
+			    (u_longlong_t)(zcb.zcb_vd_verify_bytes[v] *
+			    1000 / ms / 1024 / 1024));
+		}
+
+		umem_free(zcb.zcb_vd_verify_bytes,
+		    zcb.zcb_vd_count * sizeof (uint64_t));
+		umem_free(zcb.zcb_vd_verify_blocks,
+		    zcb.zcb_vd_count * sizeof (uint64_t));
+		zcb.zcb_vd_verify_bytes = NULL;
+		zcb.zcb_vd_verify_blocks = NULL;
+	}
+
 	/*
 	 * Done after zio_wait() since zcb_haderrors is modified in
 	 * zdb_blkptr_done()
@@ -32,6 +32,9 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <strings.h>
+#include <synch.h>
+#include <thread_pool.h>
+#include <unistd.h>
 
 #include <libzfs.h>
 
@@ -48,6 +51,14 @@
  *
  * When finished, we have an AVL tree of ZFS handles.  We go through and execute
  * the provided callback for each one, passing whatever data the user supplied.
+ *
+ * If ZFS_ITER_PARALLEL is set along with ZFS_ITER_RECURSE, the gathering
+ * phase is done by a pool of worker threads: instead of recursing into a
+ * child filesystem in place, its handle is queued for a worker, which adds
+ * it to the tree and queues its own children in turn.  Since the tree is
+ * kept sorted, the output is the same no matter what order the workers get
+ * to the datasets.  The callbacks themselves still run single-threaded once
+ * gathering is complete.
  */
 
 typedef struct zfs_node {
@@ -68,6 +79,14 @@ typedef struct callback_data {
 
 uu_avl_pool_t *avl_pool;
 
+/*
+ * cb_lock protects the AVL tree and the shared property list while worker
+ * threads are gathering datasets; cb_tpool is non-NULL only during a
+ * parallel gather.
+ */
+static mutex_t cb_lock = DEFAULTMUTEX;
+static tpool_t *cb_tpool;
+
 /*
  * Include snaps if they were requested or if this a zfs list where types
  * were not specified and the "listsnapshots" property is set on this pool.
@@ -84,6 +103,43 @@ zfs_include_snapshots(zfs_handle_t *zhp, callback_data_t *cb)
 	return (zpool_get_prop_int(zph, ZPOOL_PROP_LISTSNAPS, NULL));
 }
 
+static int zfs_callback(zfs_handle_t *, void *);
+
+typedef struct zfs_gather_arg {
+	zfs_handle_t	*zg_zhp;
+	callback_data_t	zg_cb;
+} zfs_gather_arg_t;
+
+static void
+zfs_gather_worker(void *arg)
+{
+	zfs_gather_arg_t *zg = arg;
+
+	(void) zfs_callback(zg->zg_zhp, &zg->zg_cb);
+	free(zg);
+}
+
+/*
+ * Hand a child dataset to the gather thread pool rather than recursing into
+ * it in place.  Each task carries a private copy of the callback data so
+ * that the depth accounting doesn't race between workers; the AVL tree and
+ * the property list the copies point to are shared and guarded by cb_lock.
+ */
+static int
+zfs_dispatch_callback(zfs_handle_t *zhp, void *data)
+{
+	zfs_gather_arg_t *zg = safe_malloc(sizeof (zfs_gather_arg_t));
+
+	zg->zg_zhp = zhp;
+	zg->zg_cb = *(callback_data_t *)data;
+	if (tpool_dispatch(cb_tpool, zfs_gather_worker, zg) != 0) {
+		/* no memory for a task; fall back to iterating in place */
+		free(zg);
+		return (zfs_callback(zhp, data));
+	}
+	return (0);
+}
+
 /*
  * Called for each dataset.  If the object is of an appropriate type,
  * add it to the avl tree and recurse over any children as necessary.
@@ -93,8 +149,16 @@ zfs_callback(zfs_handle_t *zhp, void *data)
 {
 	callback_data_t *cb = data;
 	boolean_t should_close = B_TRUE;
-	boolean_t include_snaps = zfs_include_snapshots(zhp, cb);
-	boolean_t include_bmarks = (cb->cb_types & ZFS_TYPE_BOOKMARK);
+	boolean_t include_snaps, include_bmarks;
+
+	/*
+	 * Checking the listsnapshots pool property may cache the result on
+	 * the shared pool handle, so serialize it with the other workers.
+	 */
+	mutex_enter(&cb_lock);
+	include_snaps = zfs_include_snapshots(zhp, cb);
+	mutex_exit(&cb_lock);
+	include_bmarks = (cb->cb_types & ZFS_TYPE_BOOKMARK);
 
 	if ((zfs_get_type(zhp) & cb->cb_types) ||
 	    ((zfs_get_type(zhp) == ZFS_TYPE_SNAPSHOT) && include_snaps)) {
@@ -103,6 +167,7 @@ zfs_callback(zfs_handle_t *zhp, void *data)
 
 		node->zn_handle = zhp;
 		uu_avl_node_init(node, &node->zn_avlnode, avl_pool);
+		mutex_enter(&cb_lock);
 		if (uu_avl_find(cb->cb_avl, node, cb->cb_sortcol,
 		    &idx) == NULL) {
 			if (cb->cb_proplist) {
@@ -115,6 +180,7 @@ zfs_callback(zfs_handle_t *zhp, void *data)
 				    (cb->cb_flags & ZFS_ITER_RECVD_PROPS),
 				    (cb->cb_flags & ZFS_ITER_LITERAL_PROPS))
 				    != 0) {
+					mutex_exit(&cb_lock);
 					free(node);
 					return (-1);
 				}
@@ -124,6 +190,7 @@ zfs_callback(zfs_handle_t *zhp, void *data)
 		} else {
 			free(node);
 		}
+		mutex_exit(&cb_lock);
 	}
 
 	/*
@@ -133,8 +200,15 @@ zfs_callback(zfs_handle_t *zhp, void *data)
 	    ((cb->cb_flags & ZFS_ITER_DEPTH_LIMIT) == 0 ||
 	    cb->cb_depth < cb->cb_depth_limit)) {
 		cb->cb_depth++;
-		if (zfs_get_type(zhp) == ZFS_TYPE_FILESYSTEM)
-			(void) zfs_iter_filesystems(zhp, zfs_callback, data);
+		if (zfs_get_type(zhp) == ZFS_TYPE_FILESYSTEM) {
+			if (cb_tpool != NULL) {
+				(void) zfs_iter_filesystems(zhp,
+				    zfs_dispatch_callback, data);
+			} else {
+				(void) zfs_iter_filesystems(zhp,
+				    zfs_callback, data);
+			}
+		}
 		if (((zfs_get_type(zhp) & (ZFS_TYPE_SNAPSHOT |
 		    ZFS_TYPE_BOOKMARK)) == 0) && include_snaps)
 			(void) zfs_iter_snapshots(zhp,
@@ -432,6 +506,17 @@ zfs_for_each(int argc, char **argv, int flags, zfs_type_t types,
 	if ((cb.cb_avl = uu_avl_create(avl_pool, NULL, UU_DEFAULT)) == NULL)
 		nomem();
 
+	/*
+	 * Gather with a bounded pool of worker threads when asked to; each
+	 * dataset costs an ioctl, and on wide hierarchies issuing them
+	 * concurrently dominates the run time of commands like zfs list.
+	 * If the pool can't be created we simply gather serially.
+	 */
+	if ((flags & ZFS_ITER_PARALLEL) && (flags & ZFS_ITER_RECURSE)) {
+		cb_tpool = tpool_create(1, 2 * sysconf(_SC_NPROCESSORS_ONLN),
+		    0, NULL);
+	}
+
 	if (argc == 0) {
 		/*
 		 * If given no arguments, iterate over all datasets.
@@ -469,6 +554,12 @@ zfs_for_each(int argc, char **argv, int flags, zfs_type_t types,
 		}
 	}
 
+	if (cb_tpool != NULL) {
+		tpool_wait(cb_tpool);
+		tpool_destroy(cb_tpool);
+		cb_tpool = NULL;
+	}
+
 	/*
 	 * At this point we've got our AVL tree full of zfs handles, so iterate
 	 * over each one and execute the real user callback.
@@ -897,6 +897,26 @@ domount(zlog_t *zlogp, const char *fstype, const char *opts,
 	char *argv[6];
 	int status;
 
+	/*
+	 * The lofs mount command is nothing more than a wrapper around
+	 * mount(2), so issue the call directly and save a fork/exec per
+	 * file system.  Zone boots are dominated by lofs mounts, and the
+	 * savings add up when many zones boot at once after a host reboot.
+	 */
+	if (strcmp(fstype, MNTTYPE_LOFS) == 0) {
+		char optbuf[MAX_MNTOPT_STR];
+
+		/* mount(2) may rewrite the option string in place */
+		(void) strlcpy(optbuf, opts, sizeof (optbuf));
+		if (mount(special, directory, MS_OPTIONSTR, MNTTYPE_LOFS,
+		    NULL, 0, optbuf, sizeof (optbuf)) != 0) {
+			zerror(zlogp, B_TRUE, "lofs mount of %s on %s failed",
+			    special, directory);
+			return (-1);
+		}
+		return (0);
+	}
+
 	/*
 	 * We could alternatively have called /usr/sbin/mount -F <fstype>, but
 	 * that would cost us an extra fork/exec without buying us anything.
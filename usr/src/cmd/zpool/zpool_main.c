@@ -4208,8 +4208,11 @@ refresh_iostat(zpool_handle_t *zhp, void *data)
 
 	/*
 	 * If the pool has disappeared, remove it from the list and continue.
+	 * Between intervals we only need fresh vdev stats, so take the
+	 * incremental path; it falls back to a full config refresh whenever
+	 * the pool configuration has changed.
 	 */
-	if (zpool_refresh_stats(zhp, &missing) != 0)
+	if (zpool_refresh_vdev_stats(zhp, &missing) != 0)
 		return (-1);
 
 	if (missing)
@@ -0,0 +1,409 @@
+/*
+ * This file and its contents are supplied under the terms of the
+ * Common Development and Distribution License ("CDDL"), version 1.0.
+ * You may only use this file in accordance with the terms of version
+ * 1.0 of the CDDL.
+ *
+ * A full copy of the text of the CDDL should have accompanied this
+ * source.  A copy of the CDDL is also available via the Internet at
+ * http://www.illumos.org/license/CDDL.
+ */
+
+/*
+ * Copyright 2026 Oxide Computer Company
+ */
+
+/*
+ * SHA-256 block transform using the Intel SHA extensions
+ * (sha256rnds2, sha256msg1, sha256msg2).
+ *
+ * OpenSolaris interface:
+ *	void SHA256TransformBlocksNI(SHA2_CTX *ctx, const void *in,
+ *	    size_t num);
+ *
+ * Processes 'num' (one or more) 512-bit blocks from 'in' and updates
+ * the eight 32-bit words of digest state held in 'ctx'.  The caller is
+ * responsible for ensuring the CPU offers the SHA extensions (see
+ * intel_sha_extensions_present() in sha2.c) and, in the kernel, for
+ * disabling preemption across the call, as this function does not
+ * preserve the FPU state of a preempting thread.  The %xmm registers
+ * used here are saved and restored around the transform in the same
+ * manner as the AES-NI code in aes_intel.s.
+ *
+ * The round structure follows the scheme published by Intel in
+ * "Intel SHA Extensions: New Instructions Supporting the Secure Hash
+ * Algorithm on Intel Architecture Processors" (Gulley, et al., 2013):
+ * the a/b/e/f and c/d/g/h halves of the state are carried in two
+ * registers, two rounds are retired per sha256rnds2, and the message
+ * schedule for rounds 16-63 is derived with sha256msg1/sha256msg2.
+ */
+
+#if defined(lint) || defined(__lint)
+
+#include <sys/types.h>
+#include <sys/sha2.h>
+
+/* ARGSUSED */
+void
+SHA256TransformBlocksNI(SHA2_CTX *ctx, const void *in, size_t num)
+{
+}
+
+#else	/* lint */
+
+#include <sys/asm_linkage.h>
+#include <sys/controlregs.h>
+#ifdef _KERNEL
+#include <sys/machprivregs.h>
+#endif
+
+#ifdef _KERNEL
+	/*
+	 * Note: the CLTS macro clobbers P2 (%rsi) under i86xpv.  That is,
+	 * it calls HYPERVISOR_fpu_taskswitch() which modifies %rsi when it
+	 * uses it to pass P2 to syscall.
+	 * This also occurs with the STTS macro, but we don't care if
+	 * P2 (%rsi) is modified just before function exit.
+	 * The CLTS and STTS macros push and pop P1 (%rdi) already.
+	 */
+#ifdef __xpv
+#define	PROTECTED_CLTS \
+	push	%rsi; \
+	CLTS; \
+	pop	%rsi
+#else
+#define	PROTECTED_CLTS \
+	CLTS
+#endif	/* __xpv */
+
+	/*
+	 * If CR0_TS is not set, save %xmm0 - %xmm7 in the caller-prepared
+	 * stack area at 32(%rsp), otherwise clear CR0_TS.
+	 */
+#define	CLEAR_TS_OR_PUSH_XMM0_TO_XMM7(tmpreg) \
+	movq	%cr0, tmpreg; \
+	testq	$CR0_TS, tmpreg; \
+	jnz	1f; \
+	movaps	%xmm0, 32(%rsp); \
+	movaps	%xmm1, 48(%rsp); \
+	movaps	%xmm2, 64(%rsp); \
+	movaps	%xmm3, 80(%rsp); \
+	movaps	%xmm4, 96(%rsp); \
+	movaps	%xmm5, 112(%rsp); \
+	movaps	%xmm6, 128(%rsp); \
+	movaps	%xmm7, 144(%rsp); \
+	jmp	2f; \
+1: \
+	PROTECTED_CLTS; \
+2:
+
+	/*
+	 * If CR0_TS was not set above, restore %xmm0 - %xmm7, otherwise
+	 * set CR0_TS.
+	 */
+#define	SET_TS_OR_POP_XMM0_TO_XMM7(tmpreg) \
+	testq	$CR0_TS, tmpreg; \
+	jnz	1f; \
+	movaps	32(%rsp), %xmm0; \
+	movaps	48(%rsp), %xmm1; \
+	movaps	64(%rsp), %xmm2; \
+	movaps	80(%rsp), %xmm3; \
+	movaps	96(%rsp), %xmm4; \
+	movaps	112(%rsp), %xmm5; \
+	movaps	128(%rsp), %xmm6; \
+	movaps	144(%rsp), %xmm7; \
+	jmp	2f; \
+1: \
+	STTS(tmpreg); \
+2:
+
+#else
+#define	PROTECTED_CLTS
+#define	CLEAR_TS_OR_PUSH_XMM0_TO_XMM7(tmpreg)
+#define	SET_TS_OR_POP_XMM0_TO_XMM7(tmpreg)
+#endif	/* _KERNEL */
+
+/*
+ * Offset of the SHA-256 state words within SHA2_CTX (following the
+ * 32-bit algotype member and its alignment padding).
+ */
+#define	CTX_STATE_OFFSET	8
+
+/*
+ * Register usage for the transform:
+ *
+ * %xmm0	current message + round constant words (implicit operand
+ *		of sha256rnds2)
+ * %xmm1	state words a, b, e, f
+ * %xmm2	state words c, d, g, h
+ * %xmm3-%xmm6	message schedule
+ * %xmm7	schedule scratch
+ * %rdi		SHA2_CTX pointer (P1)
+ * %rsi		input block pointer (P2)
+ * %rdx		number of blocks remaining (P3)
+ * %rax		SHA-256 round constant table pointer
+ * %r10		saved %cr0 for the TS handling above (kernel only)
+ */
+
+	ENTRY_NP(SHA256TransformBlocksNI)
+	pushq	%rbp
+	movq	%rsp, %rbp
+	andq	$-XMM_ALIGN, %rsp
+	subq	$[XMM_SIZE * 10], %rsp
+	CLEAR_TS_OR_PUSH_XMM0_TO_XMM7(%r10)
+
+	leaq	SHA256_NI_K256(%rip), %rax
+
+	/*
+	 * Load the digest and rearrange its words from the a-h memory
+	 * order into the abef/cdgh register arrangement expected by
+	 * sha256rnds2.
+	 */
+	movdqu	CTX_STATE_OFFSET(%rdi), %xmm1		/* dcba */
+	movdqu	CTX_STATE_OFFSET+16(%rdi), %xmm2	/* hgfe */
+	pshufd	$0xb1, %xmm1, %xmm1			/* cdab */
+	pshufd	$0x1b, %xmm2, %xmm2			/* efgh */
+	movdqa	%xmm1, %xmm7
+	palignr	$8, %xmm2, %xmm1			/* abef */
+	pblendw	$0xf0, %xmm7, %xmm2			/* cdgh */
+
+.align 4
+.Lblock_loop:
+	/* Save the current state for the final addition. */
+	movdqa	%xmm1, (%rsp)
+	movdqa	%xmm2, 16(%rsp)
+
+	/* Rounds 0-3 */
+	movdqu	(%rsi), %xmm0
+	pshufb	SHA256_NI_FLIP_MASK(%rip), %xmm0
+	movdqa	%xmm0, %xmm3
+	paddd	(%rax), %xmm0
+	sha256rnds2 %xmm1, %xmm2
+	pshufd	$0x0e, %xmm0, %xmm0
+	sha256rnds2 %xmm2, %xmm1
+
+	/* Rounds 4-7 */
+	movdqu	16(%rsi), %xmm0
+	pshufb	SHA256_NI_FLIP_MASK(%rip), %xmm0
+	movdqa	%xmm0, %xmm4
+	paddd	16(%rax), %xmm0
+	sha256rnds2 %xmm1, %xmm2
+	pshufd	$0x0e, %xmm0, %xmm0
+	sha256rnds2 %xmm2, %xmm1
+	sha256msg1 %xmm4, %xmm3
+
+	/* Rounds 8-11 */
+	movdqu	32(%rsi), %xmm0
+	pshufb	SHA256_NI_FLIP_MASK(%rip), %xmm0
+	movdqa	%xmm0, %xmm5
+	paddd	32(%rax), %xmm0
+	sha256rnds2 %xmm1, %xmm2
+	pshufd	$0x0e, %xmm0, %xmm0
+	sha256rnds2 %xmm2, %xmm1
+	sha256msg1 %xmm5, %xmm4
+
+	/* Rounds 12-15 */
+	movdqu	48(%rsi), %xmm0
+	pshufb	SHA256_NI_FLIP_MASK(%rip), %xmm0
+	movdqa	%xmm0, %xmm6
+	paddd	48(%rax), %xmm0
+	sha256rnds2 %xmm1, %xmm2
+	movdqa	%xmm6, %xmm7
+	palignr	$4, %xmm5, %xmm7
+	paddd	%xmm7, %xmm3
+	sha256msg2 %xmm6, %xmm3
+	pshufd	$0x0e, %xmm0, %xmm0
+	sha256rnds2 %xmm2, %xmm1
+	sha256msg1 %xmm6, %xmm5
+
+	/* Rounds 16-19 */
+	movdqa	%xmm3, %xmm0
+	paddd	64(%rax), %xmm0
+	sha256rnds2 %xmm1, %xmm2
+	movdqa	%xmm3, %xmm7
+	palignr	$4, %xmm6, %xmm7
+	paddd	%xmm7, %xmm4
+	sha256msg2 %xmm3, %xmm4
+	pshufd	$0x0e, %xmm0, %xmm0
+	sha256rnds2 %xmm2, %xmm1
+	sha256msg1 %xmm3, %xmm6
+
+	/* Rounds 20-23 */
+	movdqa	%xmm4, %xmm0
+	paddd	80(%rax), %xmm0
+	sha256rnds2 %xmm1, %xmm2
+	movdqa	%xmm4, %xmm7
+	palignr	$4, %xmm3, %xmm7
+	paddd	%xmm7, %xmm5
+	sha256msg2 %xmm4, %xmm5
+	pshufd	$0x0e, %xmm0, %xmm0
+	sha256rnds2 %xmm2, %xmm1
+	sha256msg1 %xmm4, %xmm3
+
+	/* Rounds 24-27 */
+	movdqa	%xmm5, %xmm0
+	paddd	96(%rax), %xmm0
+	sha256rnds2 %xmm1, %xmm2
+	movdqa	%xmm5, %xmm7
+	palignr	$4, %xmm4, %xmm7
+	paddd	%xmm7, %xmm6
+	sha256msg2 %xmm5, %xmm6
+	pshufd	$0x0e, %xmm0, %xmm0
+	sha256rnds2 %xmm2, %xmm1
+	sha256msg1 %xmm5, %xmm4
+
+	/* Rounds 28-31 */
+	movdqa	%xmm6, %xmm0
+	paddd	112(%rax), %xmm0
+	sha256rnds2 %xmm1, %xmm2
+	movdqa	%xmm6, %xmm7
+	palignr	$4, %xmm5, %xmm7
+	paddd	%xmm7, %xmm3
+	sha256msg2 %xmm6, %xmm3
+	pshufd	$0x0e, %xmm0, %xmm0
+	sha256rnds2 %xmm2, %xmm1
+	sha256msg1 %xmm6, %xmm5
+
+	/* Rounds 32-35 */
+	movdqa	%xmm3, %xmm0
+	paddd	128(%rax), %xmm0
+	sha256rnds2 %xmm1, %xmm2
+	movdqa	%xmm3, %xmm7
+	palignr	$4, %xmm6, %xmm7
+	paddd	%xmm7, %xmm4
+	sha256msg2 %xmm3, %xmm4
+	pshufd	$0x0e, %xmm0, %xmm0
+	sha256rnds2 %xmm2, %xmm1
+	sha256msg1 %xmm3, %xmm6
+
+	/* Rounds 36-39 */
+	movdqa	%xmm4, %xmm0
+	paddd	144(%rax), %xmm0
+	sha256rnds2 %xmm1, %xmm2
+	movdqa	%xmm4, %xmm7
+	palignr	$4, %xmm3, %xmm7
+	paddd	%xmm7, %xmm5
+	sha256msg2 %xmm4, %xmm5
+	pshufd	$0x0e, %xmm0, %xmm0
+	sha256rnds2 %xmm2, %xmm1
+	sha256msg1 %xmm4, %xmm3
+
+	/* Rounds 40-43 */
+	movdqa	%xmm5, %xmm0
+	paddd	160(%rax), %xmm0
+	sha256rnds2 %xmm1, %xmm2
+	movdqa	%xmm5, %xmm7
+	palignr	$4, %xmm4, %xmm7
+	paddd	%xmm7, %xmm6
+	sha256msg2 %xmm5, %xmm6
+	pshufd	$0x0e, %xmm0, %xmm0
+	sha256rnds2 %xmm2, %xmm1
+	sha256msg1 %xmm5, %xmm4
+
+	/* Rounds 44-47 */
+	movdqa	%xmm6, %xmm0
+	paddd	176(%rax), %xmm0
+	sha256rnds2 %xmm1, %xmm2
+	movdqa	%xmm6, %xmm7
+	palignr	$4, %xmm5, %xmm7
+	paddd	%xmm7, %xmm3
+	sha256msg2 %xmm6, %xmm3
+	pshufd	$0x0e, %xmm0, %xmm0
+	sha256rnds2 %xmm2, %xmm1
+	sha256msg1 %xmm6, %xmm5
+
+	/* Rounds 48-51 */
+	movdqa	%xmm3, %xmm0
+	paddd	192(%rax), %xmm0
+	sha256rnds2 %xmm1, %xmm2
+	movdqa	%xmm3, %xmm7
+	palignr	$4, %xmm6, %xmm7
+	paddd	%xmm7, %xmm4
+	sha256msg2 %xmm3, %xmm4
+	pshufd	$0x0e, %xmm0, %xmm0
+	sha256rnds2 %xmm2, %xmm1
+
+	/* Rounds 52-55 */
+	movdqa	%xmm4, %xmm0
+	paddd	208(%rax), %xmm0
+	sha256rnds2 %xmm1, %xmm2
+	movdqa	%xmm4, %xmm7
+	palignr	$4, %xmm3, %xmm7
+	paddd	%xmm7, %xmm5
+	sha256msg2 %xmm4, %xmm5
+	pshufd	$0x0e, %xmm0, %xmm0
+	sha256rnds2 %xmm2, %xmm1
+
+	/* Rounds 56-59 */
+	movdqa	%xmm5, %xmm0
+	paddd	224(%rax), %xmm0
+	sha256rnds2 %xmm1, %xmm2
+	movdqa	%xmm5, %xmm7
+	palignr	$4, %xmm4, %xmm7
+	paddd	%xmm7, %xmm6
+	sha256msg2 %xmm5, %xmm6
+	pshufd	$0x0e, %xmm0, %xmm0
+	sha256rnds2 %xmm2, %xmm1
+
+	/* Rounds 60-63 */
+	movdqa	%xmm6, %xmm0
+	paddd	240(%rax), %xmm0
+	sha256rnds2 %xmm1, %xmm2
+	pshufd	$0x0e, %xmm0, %xmm0
+	sha256rnds2 %xmm2, %xmm1
+
+	/* Add the starting state back in. */
+	paddd	(%rsp), %xmm1
+	paddd	16(%rsp), %xmm2
+
+	addq	$64, %rsi
+	decq	%rdx
+	jnz	.Lblock_loop
+
+	/* Rearrange the words back into memory order and store. */
+	pshufd	$0x1b, %xmm1, %xmm1			/* feba */
+	pshufd	$0xb1, %xmm2, %xmm2			/* dchg */
+	movdqa	%xmm1, %xmm7
+	pblendw	$0xf0, %xmm2, %xmm1			/* dcba */
+	palignr	$8, %xmm7, %xmm2			/* hgfe */
+	movdqu	%xmm1, CTX_STATE_OFFSET(%rdi)
+	movdqu	%xmm2, CTX_STATE_OFFSET+16(%rdi)
+
+	SET_TS_OR_POP_XMM0_TO_XMM7(%r10)
+	movq	%rbp, %rsp
+	popq	%rbp
+	ret
+	SET_SIZE(SHA256TransformBlocksNI)
+
+/*
+ * The SHA-256 round constants (FIPS 180-2 section 4.2.2), followed by
+ * the pshufb mask that loads big-endian message words into each lane.
+ */
+.align	64
+.type	SHA256_NI_K256, @object
+SHA256_NI_K256:
+	.long	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5
+	.long	0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5
+	.long	0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3
+	.long	0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174
+	.long	0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc
+	.long	0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da
+	.long	0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7
+	.long	0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967
+	.long	0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13
+	.long	0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85
+	.long	0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3
+	.long	0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070
+	.long	0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5
+	.long	0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3
+	.long	0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208
+	.long	0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+.size	SHA256_NI_K256, .-SHA256_NI_K256
+
+.align	16
+.type	SHA256_NI_FLIP_MASK, @object
+SHA256_NI_FLIP_MASK:
+	.quad	0x0405060700010203, 0x0c0d0e0f08090a0b
+.size	SHA256_NI_FLIP_MASK, .-SHA256_NI_FLIP_MASK
+
+#endif	/* lint || __lint */
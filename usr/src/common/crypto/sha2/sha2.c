@@ -54,7 +54,22 @@
 #ifdef _KERNEL
 #include <sys/cmn_err.h>
 
+#if	defined(__amd64)
+#include <sys/cpuvar.h>
+#include <sys/x86_archext.h>	/* x86_featureset, X86FSET_SHA */
+#include <sys/disp.h>		/* kpreempt_disable(), kpreempt_enable */
+#define	KPREEMPT_DISABLE	kpreempt_disable()
+#define	KPREEMPT_ENABLE		kpreempt_enable()
+#endif	/* __amd64 */
+
 #else
+#if	defined(__amd64)
+#include <sys/auxv.h>		/* getisax() */
+#include <sys/auxv_386.h>	/* AV_386_2_SHA bit */
+#define	KPREEMPT_DISABLE
+#define	KPREEMPT_ENABLE
+#endif	/* __amd64 */
+
 #pragma weak SHA256Update = SHA2Update
 #pragma weak SHA384Update = SHA2Update
 #pragma weak SHA512Update = SHA2Update
@@ -75,10 +90,13 @@ static void Encode64(uint8_t *, uint64_t *, size_t);
 
 #if	defined(__amd64)
 #define	SHA512Transform(ctx, in) SHA512TransformBlocks((ctx), (in), 1)
-#define	SHA256Transform(ctx, in) SHA256TransformBlocks((ctx), (in), 1)
+#define	SHA256Transform(ctx, in) SHA256TransformBlocksDispatch((ctx), (in), 1)
 
 void SHA512TransformBlocks(SHA2_CTX *ctx, const void *in, size_t num);
 void SHA256TransformBlocks(SHA2_CTX *ctx, const void *in, size_t num);
+void SHA256TransformBlocksNI(SHA2_CTX *ctx, const void *in, size_t num);
+static void SHA256TransformBlocksDispatch(SHA2_CTX *, const void *, size_t);
+static int intel_sha_extensions_present(void);
 
 #else
 static void SHA256Transform(SHA2_CTX *, const uint8_t *);
@@ -610,6 +628,54 @@ SHA512Transform(SHA2_CTX *ctx, const uint8_t *blk)
 }
 #endif	/* !__amd64 */
 
+#if	defined(__amd64)
+
+/*
+ * Return 1 if executing on a CPU with the Intel SHA extensions,
+ * otherwise 0.  Cache the result, as the CPU can't change.
+ *
+ * Note: the userland version uses getisax().  The kernel version uses
+ * the global variable x86_featureset.
+ */
+static int
+intel_sha_extensions_present(void)
+{
+	static int	cached_result = -1;
+
+	if (cached_result == -1) { /* first time */
+#ifdef _KERNEL
+		cached_result = is_x86_feature(x86_featureset, X86FSET_SHA);
+#else
+		uint_t		ui[2] = { 0, 0 };
+
+		(void) getisax(ui, 2);
+		cached_result = (ui[1] & AV_386_2_SHA) != 0;
+#endif	/* _KERNEL */
+	}
+
+	return (cached_result);
+}
+
+/*
+ * Digest a chain of 512-bit blocks, using the SHA extensions when the
+ * CPU offers them and the scalar assembly implementation otherwise.
+ * The SHA extension transform uses the %xmm registers, which in the
+ * kernel are not saved across preemption, so preemption is disabled
+ * around it (see sha256_intel.s).
+ */
+static void
+SHA256TransformBlocksDispatch(SHA2_CTX *ctx, const void *in, size_t num)
+{
+	if (intel_sha_extensions_present()) {
+		KPREEMPT_DISABLE;
+		SHA256TransformBlocksNI(ctx, in, num);
+		KPREEMPT_ENABLE;
+	} else {
+		SHA256TransformBlocks(ctx, in, num);
+	}
+}
+
+#endif	/* __amd64 */
 
 /*
  * Encode()
@@ -865,7 +931,7 @@ SHA2Update(SHA2_CTX *ctx, const void *inptr, size_t input_len)
 		if (algotype <= SHA256_HMAC_GEN_MECH_INFO_TYPE) {
 			block_count = (input_len - i) >> 6;
 			if (block_count > 0) {
-				SHA256TransformBlocks(ctx, &input[i],
+				SHA256TransformBlocksDispatch(ctx, &input[i],
 				    block_count);
 				i += block_count << 6;
 			}
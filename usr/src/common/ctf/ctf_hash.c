@@ -35,6 +35,11 @@ static const ushort_t _CTF_EMPTY[1] = { 0 };
 int
 ctf_hash_create(ctf_hash_t *hp, ulong_t nelems)
 {
+	static const ushort_t primes[] = {
+		211, 1021, 2053, 4099, 8209, 16411, 32771, 65521
+	};
+	uint_t i;
+
 	if (nelems > USHRT_MAX)
 		return (EOVERFLOW);
 
@@ -49,7 +54,19 @@ ctf_hash_create(ctf_hash_t *hp, ulong_t nelems)
 		return (0);
 	}
 
-	hp->h_nbuckets = 211;		/* use a prime number of hash buckets */
+	/*
+	 * Scale the bucket array with the number of elements so that chains
+	 * stay short for large containers such as the merged kernel CTF; a
+	 * fixed bucket count makes name lookup there effectively linear.
+	 * Buckets cost two bytes apiece, so even the largest table adds at
+	 * most 128K to the container.
+	 */
+	for (i = 0; i < sizeof (primes) / sizeof (primes[0]) - 1; i++) {
+		if (primes[i] >= nelems)
+			break;
+	}
+
+	hp->h_nbuckets = primes[i];	/* use a prime number of hash buckets */
 	hp->h_nelems = nelems + 1;	/* we use index zero as a sentinel */
 	hp->h_free = 1;			/* first free element is index 1 */
 
@@ -951,6 +951,61 @@ real_LZ4_compress(const char *source, char *dest, int isize, int osize)
 #endif
 }
 
+/*
+ * Variant of lz4_compress for callers that must not allocate memory
+ * at call time, such as the crash dump helpers. The scratch context,
+ * of size lz4_compress_ctxlen(), is allocated by the caller up front
+ * and may be reused across calls; it is only touched for the duration
+ * of a call.
+ */
+size_t
+lz4_compress_ctxlen(void)
+{
+#if HEAPMODE
+	return (sizeof (struct refTables));
+#else
+	return (0);
+#endif
+}
+
+size_t
+lz4_compress_ctx(void *ctx, void *s_start, void *d_start, size_t s_len,
+    size_t d_len, int n __unused)
+{
+	uint32_t bufsiz;
+	char *dest = d_start;
+	int result;
+
+	ASSERT(d_len >= sizeof (bufsiz));
+
+#if HEAPMODE
+	(void) memset(ctx, 0, sizeof (struct refTables));
+#endif
+	if (s_len < (size_t)LZ4_64KLIMIT)
+		result = LZ4_compress64kCtx(ctx, s_start,
+		    &dest[sizeof (bufsiz)], s_len, d_len - sizeof (bufsiz));
+	else
+		result = LZ4_compressCtx(ctx, s_start, &dest[sizeof (bufsiz)],
+		    s_len, d_len - sizeof (bufsiz));
+
+	/* Signal an error if the compression routine returned zero. */
+	if (result == 0)
+		return (s_len);
+	bufsiz = result;
+
+	/*
+	 * Encode the compresed buffer size at the start, as in
+	 * lz4_compress above.
+	 */
+#if defined(_KERNEL) || defined(_FAKE_KERNEL)
+	*(uint32_t *)(void *)dest = BE_32(bufsiz);
+#else
+	*(uint32_t *)(void *)dest = htonl(bufsiz);
+#endif
+
+	return (bufsiz + sizeof (bufsiz));
+}
+
 /* Decompression functions */
 
 /*
@@ -25,6 +25,13 @@ extern "C" {
 extern size_t lz4_compress(void *, void *, size_t, size_t, int);
 extern int lz4_decompress(void *, void *, size_t, size_t, int);
 
+/*
+ * Variant of lz4_compress that does no memory allocation; the caller
+ * provides scratch space of lz4_compress_ctxlen() bytes.
+ */
+extern size_t lz4_compress_ctxlen(void);
+extern size_t lz4_compress_ctx(void *, void *, void *, size_t, size_t, int);
+
 #ifdef __cplusplus
 }
 #endif
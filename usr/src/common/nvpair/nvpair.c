@@ -879,13 +879,33 @@ static int
 nvlist_contains_nvp(nvlist_t *nvl, nvpair_t *nvp)
 {
 	nvpriv_t *priv = (nvpriv_t *)(uintptr_t)nvl->nvl_priv;
-	i_nvp_t *curr;
 
 	if (nvp == NULL)
 		return (0);
 
-	for (curr = priv->nvp_list; curr != NULL; curr = curr->nvi_next)
-		if (&curr->nvi_nvp == nvp)
+	/*
+	 * Any pair on this list is on the hash chain for its name's bucket,
+	 * so rather than walking the whole list it suffices to walk that
+	 * one chain, which the resize policy keeps short.
+	 */
+	i_nvp_t **tab = priv->nvp_hashtable;
+
+	if (tab == NULL) {
+		ASSERT3P(priv->nvp_list, ==, NULL);
+		ASSERT0(priv->nvp_nbuckets);
+		ASSERT0(priv->nvp_nentries);
+		return (0);
+	} else {
+		ASSERT(priv->nvp_nbuckets != 0);
+	}
+
+	uint64_t hash = nvt_hash(NVP_NAME(nvp));
+	uint64_t index = hash & (priv->nvp_nbuckets - 1);
+
+	ASSERT3U(index, <, priv->nvp_nbuckets);
+
+	for (i_nvp_t *e = tab[index]; e != NULL; e = e->nvi_hashtable_next)
+		if (&e->nvi_nvp == nvp)
 			return (1);
 
 	return (0);
@@ -1984,54 +2004,61 @@ nvlist_lookup_nvpair_ei_sep(nvlist_t *nvl, const char *name, const char sep,
 		 * o  'sepp' is set to the beginning of the next component,
 		 *    and set to NULL if we have no more components.
 		 *
-		 * Search for nvpair with matching component name.
+		 * Search for nvpair with matching component name.  When the
+		 * component is the NUL-terminated tail of 'name' (the common
+		 * case of a plain name with no index or further components)
+		 * the hash table gives us the answer directly; otherwise
+		 * fall back to walking the list comparing the first 'n'
+		 * bytes of each name.
 		 */
-		for (nvp = nvlist_next_nvpair(nvl, NULL); nvp != NULL;
-		    nvp = nvlist_next_nvpair(nvl, nvp)) {
-
-			/* continue if no match on name */
-			if (strncmp(np, nvpair_name(nvp), n) ||
-			    (strlen(nvpair_name(nvp)) != n))
-				continue;
-
-			/* if indexed, verify type is array oriented */
-			if (idxp && !nvpair_type_is_array(nvp))
+		if (np[n] == '\0') {
+			if (nvl->nvl_priv == 0)
 				goto fail;
-
-			/*
-			 * Full match found, return nvp and idx if this
-			 * was the last component.
-			 */
-			if (sepp == NULL) {
-				if (ret)
-					*ret = nvp;
-				if (ip && idxp)
-					*ip = (int)idx;	/* return index */
-				return (0);		/* found */
+			nvp = nvt_lookup_name(nvl, np);
+		} else {
+			for (nvp = nvlist_next_nvpair(nvl, NULL); nvp != NULL;
+			    nvp = nvlist_next_nvpair(nvl, nvp)) {
+				if (strncmp(np, nvpair_name(nvp), n) == 0 &&
+				    strlen(nvpair_name(nvp)) == n)
+					break;
 			}
+		}
+		if (nvp == NULL)
+			goto fail;		/* 'name' not found */
 
-			/*
-			 * More components: current match must be
-			 * of DATA_TYPE_NVLIST or DATA_TYPE_NVLIST_ARRAY
-			 * to support going deeper.
-			 */
-			if (nvpair_type(nvp) == DATA_TYPE_NVLIST) {
-				nvl = EMBEDDED_NVL(nvp);
-				break;
-			} else if (nvpair_type(nvp) == DATA_TYPE_NVLIST_ARRAY) {
-				(void) nvpair_value_nvlist_array(nvp,
-				    &nva, (uint_t *)&n);
-				if ((n < 0) || (idx >= n))
-					goto fail;
-				nvl = nva[idx];
-				break;
-			}
+		/* if indexed, verify type is array oriented */
+		if (idxp && !nvpair_type_is_array(nvp))
+			goto fail;
 
+		/*
+		 * Full match found, return nvp and idx if this
+		 * was the last component.
+		 */
+		if (sepp == NULL) {
+			if (ret)
+				*ret = nvp;
+			if (ip && idxp)
+				*ip = (int)idx;		/* return index */
+			return (0);			/* found */
+		}
+
+		/*
+		 * More components: current match must be
+		 * of DATA_TYPE_NVLIST or DATA_TYPE_NVLIST_ARRAY
+		 * to support going deeper.
+		 */
+		if (nvpair_type(nvp) == DATA_TYPE_NVLIST) {
+			nvl = EMBEDDED_NVL(nvp);
+		} else if (nvpair_type(nvp) == DATA_TYPE_NVLIST_ARRAY) {
+			(void) nvpair_value_nvlist_array(nvp,
+			    &nva, (uint_t *)&n);
+			if ((n < 0) || (idx >= n))
+				goto fail;
+			nvl = nva[idx];
+		} else {
 			/* type does not support more levels */
 			goto fail;
 		}
-		if (nvp == NULL)
-			goto fail;		/* 'name' not found */
 
 		/* search for match of next component in embedded 'nvl' list */
 	}
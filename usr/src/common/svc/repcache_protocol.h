@@ -338,6 +338,15 @@
  * PROPERTYGRP_TX_COMMIT(entity_id, data) -> result
  *	Gives the actual steps to follow, and attempts to commit them.
  *
+ * PROPERTYGRP_GET_ALL(entity_id) -> result, data
+ *	Returns every property of the property group entity_id references,
+ *	with its type and values, encoded as a sequence of TX_ENTRY_NEW
+ *	transaction commands (the same encoding TX_COMMIT accepts).  This
+ *	lets a client read a whole property group in a single round trip
+ *	instead of iterating it property by property.  Property groups
+ *	whose encoding does not fit in the response fail with _TRUNCATED,
+ *	and the client falls back to iteration.
+ *
  * CLIENT_ADD_NOTIFY(type, pattern) -> result
  *	Adds a new property group name or type pattern to the notify list
  *	(see CLIENT_WAIT).  If successful, takes effect immediately.
@@ -386,7 +395,7 @@ extern "C" {
  * This value should be incremented any time the protocol changes.  When in
  * doubt, bump it.
  */
-#define	REPOSITORY_DOOR_VERSION			(21 + REPOSITORY_DOOR_BASEVER)
+#define	REPOSITORY_DOOR_VERSION			(22 + REPOSITORY_DOOR_BASEVER)
 
 /*
  * flags for rdr_flags
@@ -484,6 +493,8 @@ enum rep_protocol_requestid {
 
 	REP_PROTOCOL_SWITCH,
 
+	REP_PROTOCOL_PROPERTYGRP_GET_ALL,
+
 	REP_PROTOCOL_MAX_REQUEST
 };
 
@@ -863,6 +874,19 @@ struct rep_protocol_value_response {
 	char			rpr_value[2 * REP_PROTOCOL_VALUE_LEN + 1];
 };
 
+/*
+ * Response to PROPERTYGRP_GET_ALL:  rpr_contents holds one TX_SIZE()-
+ * aligned REP_PROTOCOL_TX_ENTRY_NEW rep_protocol_transaction_cmd per
+ * property, in iteration order.
+ */
+#define	REP_PROTOCOL_CONTENTS_LEN	(4 * REP_PROTOCOL_VALUE_LEN)
+
+struct rep_protocol_contents_response {
+	rep_protocol_responseid_t rpr_response;
+	uint32_t	rpr_size;	/* bytes of rpr_contents in use */
+	uint8_t		rpr_contents[REP_PROTOCOL_CONTENTS_LEN];
+};
+
 #ifdef	__cplusplus
 }
 #endif
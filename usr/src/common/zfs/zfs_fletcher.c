@@ -134,8 +134,24 @@
 #include <sys/byteorder.h>
 #include <sys/zio.h>
 #include <sys/spa.h>
+#ifdef _KERNEL
+#include <sys/atomic.h>
+#include <sys/kmem.h>
+#include <sys/kstat.h>
+#include <sys/systm.h>
+#include <sys/time.h>
+#else
+#include <atomic.h>
+#include <string.h>
+#include <strings.h>
+#endif
 #include <zfs_fletcher.h>
 
+#ifndef isspace
+#define	isspace(c)	((c) == ' ' || (c) == '\t' || (c) == '\n' || \
+			(c) == '\r' || (c) == '\f' || (c) == '\013')
+#endif
+
 void
 fletcher_init(zio_cksum_t *zcp)
 {
@@ -210,6 +226,153 @@ fletcher_2_byteswap(const void *buf, size_t size,
 	(void) fletcher_2_incremental_byteswap((void *) buf, size, zcp);
 }
 
+/*
+ * Fletcher-4 implementation selection, modeled on the RAIDZ parity math
+ * framework in vdev_raidz_math.c.  All compiled-in implementations are
+ * listed in fletcher_4_impls[]; at fletcher_4_init() time the supported
+ * subset is benchmarked and the fastest native and byteswap kernels are
+ * installed in fletcher_4_fastest_impl.  Until then, and in contexts
+ * that never call fletcher_4_init() (e.g. libzfs), the scalar
+ * implementation is used.
+ */
+static const fletcher_4_ops_t *fletcher_4_impls[] = {
+	&fletcher_4_scalar_ops,
+	&fletcher_4_superscalar4_ops,
+#if defined(__amd64)
+	&fletcher_4_avx2_ops,
+#endif
+#if defined(__amd64)
+	&fletcher_4_avx512f_ops,
+#endif
+};
+
+/* Select fletcher-4 implementation */
+#define	IMPL_FASTEST	(UINT32_MAX)
+#define	IMPL_CYCLE	(UINT32_MAX - 1)
+#define	IMPL_SCALAR	(0)
+
+#define	FLETCHER_4_IMPL_READ(i)	(*(volatile uint32_t *) &(i))
+
+static uint32_t fletcher_4_impl_chosen = IMPL_SCALAR;
+static uint32_t fletcher_4_user_sel_impl = IMPL_FASTEST;
+
+/* Indicate that the benchmark has been completed */
+static boolean_t fletcher_4_initialized = B_FALSE;
+
+/* Hold all supported implementations */
+static uint32_t fletcher_4_supp_impls_cnt = 0;
+static fletcher_4_ops_t *fletcher_4_supp_impls[ARRAY_SIZE(fletcher_4_impls)];
+
+/* Fletcher-4 ops that contain the fastest methods */
+static fletcher_4_ops_t fletcher_4_fastest_impl = {
+	.name = "fastest"
+};
+
+/*
+ * Returns the fletcher-4 operations to compute a checksum with.  Before
+ * fletcher_4_init() has run only the scalar implementation is safe to
+ * use, since the supported-implementation array is not yet populated.
+ */
+const fletcher_4_ops_t *
+fletcher_4_impl_get(void)
+{
+	const fletcher_4_ops_t *ops = NULL;
+
+	if (!fletcher_4_initialized)
+		return (&fletcher_4_scalar_ops);
+
+	const uint32_t impl = FLETCHER_4_IMPL_READ(fletcher_4_impl_chosen);
+
+	switch (impl) {
+	case IMPL_FASTEST:
+		ops = &fletcher_4_fastest_impl;
+		break;
+	case IMPL_CYCLE:
+		/* Cycle through all supported implementations */
+		ASSERT3U(fletcher_4_supp_impls_cnt, >, 0);
+		static uint32_t cycle_impl_idx = 0;
+		uint32_t idx = (++cycle_impl_idx) % fletcher_4_supp_impls_cnt;
+		ops = fletcher_4_supp_impls[idx];
+		break;
+	default:
+		ASSERT3U(impl, <, fletcher_4_supp_impls_cnt);
+		if (impl < ARRAY_SIZE(fletcher_4_impls))
+			ops = fletcher_4_supp_impls[impl];
+		break;
+	}
+
+	ASSERT3P(ops, !=, NULL);
+
+	return (ops);
+}
+
+static const struct {
+	const char *name;
+	uint32_t sel;
+} fletcher_4_impl_opts[] = {
+		{ "cycle",	IMPL_CYCLE },
+		{ "fastest",	IMPL_FASTEST },
+		{ "scalar",	IMPL_SCALAR }
+};
+
+/*
+ * Function sets desired fletcher-4 implementation.
+ *
+ * If called before fletcher_4_init(), the user preference is saved in
+ * fletcher_4_user_sel_impl and applied during init.  Otherwise the
+ * selection takes effect immediately.
+ *
+ * @val		Name of fletcher-4 implementation to use
+ */
+int
+fletcher_4_impl_set(const char *val)
+{
+	int err = -1;
+	char req_name[FLETCHER_4_IMPL_NAME_MAX];
+	uint32_t impl = FLETCHER_4_IMPL_READ(fletcher_4_user_sel_impl);
+	size_t i;
+
+	/* sanitize input */
+	i = strnlen(val, FLETCHER_4_IMPL_NAME_MAX);
+	if (i == 0 || i == FLETCHER_4_IMPL_NAME_MAX)
+		return (err);
+
+	(void) strlcpy(req_name, val, FLETCHER_4_IMPL_NAME_MAX);
+	while (i > 0 && isspace(req_name[i-1]))
+		i--;
+	req_name[i] = '\0';
+
+	/* Check mandatory options */
+	for (i = 0; i < ARRAY_SIZE(fletcher_4_impl_opts); i++) {
+		if (strcmp(req_name, fletcher_4_impl_opts[i].name) == 0) {
+			impl = fletcher_4_impl_opts[i].sel;
+			err = 0;
+			break;
+		}
+	}
+
+	/* check all supported impl if init() was already called */
+	if (err != 0 && fletcher_4_initialized) {
+		for (i = 0; i < fletcher_4_supp_impls_cnt; i++) {
+			if (strcmp(req_name,
+			    fletcher_4_supp_impls[i]->name) == 0) {
+				impl = i;
+				err = 0;
+				break;
+			}
+		}
+	}
+
+	if (err == 0) {
+		if (fletcher_4_initialized)
+			atomic_swap_32(&fletcher_4_impl_chosen, impl);
+		else
+			atomic_swap_32(&fletcher_4_user_sel_impl, impl);
+	}
+
+	return (err);
+}
+
 int
 fletcher_4_incremental_native(void *buf, size_t size, void *data)
 {
@@ -235,13 +398,38 @@ fletcher_4_incremental_native(void *buf, size_t size, void *data)
 	return (0);
 }
 
+static void
+fletcher_4_native_impl(const void *buf, uint64_t size, zio_cksum_t *zcp)
+{
+	const fletcher_4_ops_t *ops = fletcher_4_impl_get();
+	fletcher_4_ctx_t ctx;
+
+	ops->init_native(&ctx);
+	ops->compute_native(&ctx, buf, size);
+	ops->fini_native(&ctx, zcp);
+}
+
 /*ARGSUSED*/
 void
 fletcher_4_native(const void *buf, size_t size,
     const void *ctx_template, zio_cksum_t *zcp)
 {
-	fletcher_init(zcp);
-	(void) fletcher_4_incremental_native((void *) buf, size, zcp);
+	const uint64_t p2size = P2ALIGN(size, FLETCHER_MIN_SIMD_SIZE);
+
+	ASSERT(IS_P2ALIGNED(size, sizeof (uint32_t)));
+
+	if (size == 0 || p2size == 0) {
+		fletcher_init(zcp);
+		if (size > 0)
+			(void) fletcher_4_incremental_native((void *)buf,
+			    size, zcp);
+	} else {
+		fletcher_4_native_impl(buf, p2size, zcp);
+		if (p2size < size)
+			(void) fletcher_4_incremental_native(
+			    (void *)((char *)buf + p2size), size - p2size,
+			    zcp);
+	}
 }
 
 int
@@ -269,11 +457,427 @@ fletcher_4_incremental_byteswap(void *buf, size_t size, void *data)
 	return (0);
 }
 
+static void
+fletcher_4_byteswap_impl(const void *buf, uint64_t size, zio_cksum_t *zcp)
+{
+	const fletcher_4_ops_t *ops = fletcher_4_impl_get();
+	fletcher_4_ctx_t ctx;
+
+	ops->init_byteswap(&ctx);
+	ops->compute_byteswap(&ctx, buf, size);
+	ops->fini_byteswap(&ctx, zcp);
+}
+
 /*ARGSUSED*/
 void
 fletcher_4_byteswap(const void *buf, size_t size,
     const void *ctx_template, zio_cksum_t *zcp)
 {
-	fletcher_init(zcp);
-	(void) fletcher_4_incremental_byteswap((void *) buf, size, zcp);
+	const uint64_t p2size = P2ALIGN(size, FLETCHER_MIN_SIMD_SIZE);
+
+	ASSERT(IS_P2ALIGNED(size, sizeof (uint32_t)));
+
+	if (size == 0 || p2size == 0) {
+		fletcher_init(zcp);
+		if (size > 0)
+			(void) fletcher_4_incremental_byteswap((void *)buf,
+			    size, zcp);
+	} else {
+		fletcher_4_byteswap_impl(buf, p2size, zcp);
+		if (p2size < size)
+			(void) fletcher_4_incremental_byteswap(
+			    (void *)((char *)buf + p2size), size - p2size,
+			    zcp);
+	}
+}
+
+/*
+ * Scalar implementation, wrapping the original serial recurrence so it
+ * can participate in implementation selection.  It is also the fallback
+ * whenever a buffer is too small or misaligned for the vector kernels.
+ */
+static void
+fletcher_4_scalar_init(fletcher_4_ctx_t *ctx)
+{
+	ZIO_SET_CHECKSUM(&ctx->scalar, 0, 0, 0, 0);
+}
+
+static void
+fletcher_4_scalar_fini(fletcher_4_ctx_t *ctx, zio_cksum_t *zcp)
+{
+	*zcp = ctx->scalar;
+}
+
+static void
+fletcher_4_scalar_native(fletcher_4_ctx_t *ctx, const void *buf,
+    uint64_t size)
+{
+	(void) fletcher_4_incremental_native((void *)buf, size, &ctx->scalar);
+}
+
+static void
+fletcher_4_scalar_byteswap(fletcher_4_ctx_t *ctx, const void *buf,
+    uint64_t size)
+{
+	(void) fletcher_4_incremental_byteswap((void *)buf, size,
+	    &ctx->scalar);
+}
+
+static boolean_t
+fletcher_4_scalar_valid(void)
+{
+	return (B_TRUE);
+}
+
+const fletcher_4_ops_t fletcher_4_scalar_ops = {
+	.init_native = fletcher_4_scalar_init,
+	.fini_native = fletcher_4_scalar_fini,
+	.compute_native = fletcher_4_scalar_native,
+	.init_byteswap = fletcher_4_scalar_init,
+	.fini_byteswap = fletcher_4_scalar_fini,
+	.compute_byteswap = fletcher_4_scalar_byteswap,
+	.valid = fletcher_4_scalar_valid,
+	.name = "scalar"
+};
+
+/*
+ * 4-way superscalar implementation.  The input is split into four
+ * interleaved streams so the additions in each stream are independent
+ * and can issue in parallel on any reasonably wide core; no special
+ * instruction set support is required.  The finalization combines the
+ * per-stream accumulators into the serial checksum; the combination is
+ * exact for any input length that is a multiple of the 16-byte stride.
+ */
+static void
+fletcher_4_superscalar4_init(fletcher_4_ctx_t *ctx)
+{
+	bzero(ctx->superscalar, 4 * sizeof (zfs_fletcher_superscalar_t));
+}
+
+static void
+fletcher_4_superscalar4_fini(fletcher_4_ctx_t *ctx, zio_cksum_t *zcp)
+{
+	uint64_t A, B, C, D;
+
+	A = ctx->superscalar[0].v[0] + ctx->superscalar[0].v[1] +
+	    ctx->superscalar[0].v[2] + ctx->superscalar[0].v[3];
+	B = 0 - ctx->superscalar[0].v[1] - 2 * ctx->superscalar[0].v[2] -
+	    3 * ctx->superscalar[0].v[3] + 4 * ctx->superscalar[1].v[0] +
+	    4 * ctx->superscalar[1].v[1] + 4 * ctx->superscalar[1].v[2] +
+	    4 * ctx->superscalar[1].v[3];
+	C = ctx->superscalar[0].v[2] + 3 * ctx->superscalar[0].v[3] -
+	    6 * ctx->superscalar[1].v[0] - 10 * ctx->superscalar[1].v[1] -
+	    14 * ctx->superscalar[1].v[2] - 18 * ctx->superscalar[1].v[3] +
+	    16 * ctx->superscalar[2].v[0] + 16 * ctx->superscalar[2].v[1] +
+	    16 * ctx->superscalar[2].v[2] + 16 * ctx->superscalar[2].v[3];
+	D = 0 - ctx->superscalar[0].v[3] + 4 * ctx->superscalar[1].v[0] +
+	    10 * ctx->superscalar[1].v[1] + 20 * ctx->superscalar[1].v[2] +
+	    34 * ctx->superscalar[1].v[3] - 48 * ctx->superscalar[2].v[0] -
+	    64 * ctx->superscalar[2].v[1] - 80 * ctx->superscalar[2].v[2] -
+	    96 * ctx->superscalar[2].v[3] + 64 * ctx->superscalar[3].v[0] +
+	    64 * ctx->superscalar[3].v[1] + 64 * ctx->superscalar[3].v[2] +
+	    64 * ctx->superscalar[3].v[3];
+
+	ZIO_SET_CHECKSUM(zcp, A, B, C, D);
+}
+
+static void
+fletcher_4_superscalar4_native(fletcher_4_ctx_t *ctx, const void *buf,
+    uint64_t size)
+{
+	const uint32_t *ip = buf;
+	const uint32_t *ipend = ip + (size / sizeof (uint32_t));
+	uint64_t a, b, c, d;
+	uint64_t a2, b2, c2, d2;
+	uint64_t a3, b3, c3, d3;
+	uint64_t a4, b4, c4, d4;
+
+	a = ctx->superscalar[0].v[0];
+	b = ctx->superscalar[1].v[0];
+	c = ctx->superscalar[2].v[0];
+	d = ctx->superscalar[3].v[0];
+	a2 = ctx->superscalar[0].v[1];
+	b2 = ctx->superscalar[1].v[1];
+	c2 = ctx->superscalar[2].v[1];
+	d2 = ctx->superscalar[3].v[1];
+	a3 = ctx->superscalar[0].v[2];
+	b3 = ctx->superscalar[1].v[2];
+	c3 = ctx->superscalar[2].v[2];
+	d3 = ctx->superscalar[3].v[2];
+	a4 = ctx->superscalar[0].v[3];
+	b4 = ctx->superscalar[1].v[3];
+	c4 = ctx->superscalar[2].v[3];
+	d4 = ctx->superscalar[3].v[3];
+
+	for (; ip < ipend; ip += 4) {
+		a += ip[0];
+		a2 += ip[1];
+		a3 += ip[2];
+		a4 += ip[3];
+		b += a;
+		b2 += a2;
+		b3 += a3;
+		b4 += a4;
+		c += b;
+		c2 += b2;
+		c3 += b3;
+		c4 += b4;
+		d += c;
+		d2 += c2;
+		d3 += c3;
+		d4 += c4;
+	}
+
+	ctx->superscalar[0].v[0] = a;
+	ctx->superscalar[1].v[0] = b;
+	ctx->superscalar[2].v[0] = c;
+	ctx->superscalar[3].v[0] = d;
+	ctx->superscalar[0].v[1] = a2;
+	ctx->superscalar[1].v[1] = b2;
+	ctx->superscalar[2].v[1] = c2;
+	ctx->superscalar[3].v[1] = d2;
+	ctx->superscalar[0].v[2] = a3;
+	ctx->superscalar[1].v[2] = b3;
+	ctx->superscalar[2].v[2] = c3;
+	ctx->superscalar[3].v[2] = d3;
+	ctx->superscalar[0].v[3] = a4;
+	ctx->superscalar[1].v[3] = b4;
+	ctx->superscalar[2].v[3] = c4;
+	ctx->superscalar[3].v[3] = d4;
+}
+
+static void
+fletcher_4_superscalar4_byteswap(fletcher_4_ctx_t *ctx, const void *buf,
+    uint64_t size)
+{
+	const uint32_t *ip = buf;
+	const uint32_t *ipend = ip + (size / sizeof (uint32_t));
+	uint64_t a, b, c, d;
+	uint64_t a2, b2, c2, d2;
+	uint64_t a3, b3, c3, d3;
+	uint64_t a4, b4, c4, d4;
+
+	a = ctx->superscalar[0].v[0];
+	b = ctx->superscalar[1].v[0];
+	c = ctx->superscalar[2].v[0];
+	d = ctx->superscalar[3].v[0];
+	a2 = ctx->superscalar[0].v[1];
+	b2 = ctx->superscalar[1].v[1];
+	c2 = ctx->superscalar[2].v[1];
+	d2 = ctx->superscalar[3].v[1];
+	a3 = ctx->superscalar[0].v[2];
+	b3 = ctx->superscalar[1].v[2];
+	c3 = ctx->superscalar[2].v[2];
+	d3 = ctx->superscalar[3].v[2];
+	a4 = ctx->superscalar[0].v[3];
+	b4 = ctx->superscalar[1].v[3];
+	c4 = ctx->superscalar[2].v[3];
+	d4 = ctx->superscalar[3].v[3];
+
+	for (; ip < ipend; ip += 4) {
+		a += BSWAP_32(ip[0]);
+		a2 += BSWAP_32(ip[1]);
+		a3 += BSWAP_32(ip[2]);
+		a4 += BSWAP_32(ip[3]);
+		b += a;
+		b2 += a2;
+		b3 += a3;
+		b4 += a4;
+		c += b;
+		c2 += b2;
+		c3 += b3;
+		c4 += b4;
+		d += c;
+		d2 += c2;
+		d3 += c3;
+		d4 += c4;
+	}
+
+	ctx->superscalar[0].v[0] = a;
+	ctx->superscalar[1].v[0] = b;
+	ctx->superscalar[2].v[0] = c;
+	ctx->superscalar[3].v[0] = d;
+	ctx->superscalar[0].v[1] = a2;
+	ctx->superscalar[1].v[1] = b2;
+	ctx->superscalar[2].v[1] = c2;
+	ctx->superscalar[3].v[1] = d2;
+	ctx->superscalar[0].v[2] = a3;
+	ctx->superscalar[1].v[2] = b3;
+	ctx->superscalar[2].v[2] = c3;
+	ctx->superscalar[3].v[2] = d3;
+	ctx->superscalar[0].v[3] = a4;
+	ctx->superscalar[1].v[3] = b4;
+	ctx->superscalar[2].v[3] = c4;
+	ctx->superscalar[3].v[3] = d4;
+}
+
+const fletcher_4_ops_t fletcher_4_superscalar4_ops = {
+	.init_native = fletcher_4_superscalar4_init,
+	.fini_native = fletcher_4_superscalar4_fini,
+	.compute_native = fletcher_4_superscalar4_native,
+	.init_byteswap = fletcher_4_superscalar4_init,
+	.fini_byteswap = fletcher_4_superscalar4_fini,
+	.compute_byteswap = fletcher_4_superscalar4_byteswap,
+	.valid = fletcher_4_scalar_valid,
+	.name = "superscalar4"
+};
+
+#if defined(_KERNEL)
+
+/*
+ * Microbenchmark kstat, one pair of entries per supported
+ * implementation showing the measured native and byteswap throughput
+ * in bytes per second.
+ */
+#define	FLETCHER_4_BENCH_NS	(MSEC2NSEC(1))		/* 1ms */
+#define	FLETCHER_4_BENCH_SIZE	(64ULL * 1024ULL)	/* 64 kiB */
+
+static kstat_named_t
+    fletcher_4_bench_stats[2 * ARRAY_SIZE(fletcher_4_impls)];
+static kstat_t *fletcher_4_bench_ksp;
+
+/*
+ * Benchmark one supported implementation and record its throughput in
+ * the kstat.  Returns the measured speed in bytes per second.
+ */
+static uint64_t
+fletcher_4_benchmark_impl(uint32_t impl, char *data, boolean_t native)
+{
+	fletcher_4_ops_t *ops = fletcher_4_supp_impls[impl];
+	hrtime_t t_start, t_diff;
+	uint64_t run_bytes, speed;
+	zio_cksum_t zc;
+	kstat_named_t *knp;
+	fletcher_4_ctx_t ctx;
+	char name[2 * FLETCHER_4_IMPL_NAME_MAX];
+
+	run_bytes = 0;
+	t_start = gethrtime();
+
+	do {
+		if (native) {
+			ops->init_native(&ctx);
+			ops->compute_native(&ctx, data,
+			    FLETCHER_4_BENCH_SIZE);
+			ops->fini_native(&ctx, &zc);
+		} else {
+			ops->init_byteswap(&ctx);
+			ops->compute_byteswap(&ctx, data,
+			    FLETCHER_4_BENCH_SIZE);
+			ops->fini_byteswap(&ctx, &zc);
+		}
+
+		run_bytes += FLETCHER_4_BENCH_SIZE;
+		t_diff = gethrtime() - t_start;
+	} while (t_diff < FLETCHER_4_BENCH_NS);
+
+	speed = run_bytes * NANOSEC / t_diff;
+
+	knp = &fletcher_4_bench_stats[2 * impl + (native ? 0 : 1)];
+	(void) snprintf(name, sizeof (name), "%s_%s", ops->name,
+	    native ? "native" : "byteswap");
+	kstat_named_init(knp, name, KSTAT_DATA_UINT64);
+	knp->value.ui64 = speed;
+
+	return (speed);
+}
+
+/*
+ * Benchmark all supported implementations and install the fastest
+ * native and byteswap kernels in fletcher_4_fastest_impl.
+ */
+static void
+fletcher_4_benchmark(void)
+{
+	uint64_t speed, best_native = 0, best_byteswap = 0;
+	char *data;
+	uint32_t i;
+
+	data = kmem_alloc(FLETCHER_4_BENCH_SIZE, KM_SLEEP);
+	(void) memset(data, 0xAA, FLETCHER_4_BENCH_SIZE);
+
+	for (i = 0; i < fletcher_4_supp_impls_cnt; i++) {
+		fletcher_4_ops_t *ops = fletcher_4_supp_impls[i];
+
+		speed = fletcher_4_benchmark_impl(i, data, B_TRUE);
+		if (speed > best_native) {
+			best_native = speed;
+			fletcher_4_fastest_impl.init_native =
+			    ops->init_native;
+			fletcher_4_fastest_impl.fini_native =
+			    ops->fini_native;
+			fletcher_4_fastest_impl.compute_native =
+			    ops->compute_native;
+		}
+
+		speed = fletcher_4_benchmark_impl(i, data, B_FALSE);
+		if (speed > best_byteswap) {
+			best_byteswap = speed;
+			fletcher_4_fastest_impl.init_byteswap =
+			    ops->init_byteswap;
+			fletcher_4_fastest_impl.fini_byteswap =
+			    ops->fini_byteswap;
+			fletcher_4_fastest_impl.compute_byteswap =
+			    ops->compute_byteswap;
+		}
+	}
+
+	kmem_free(data, FLETCHER_4_BENCH_SIZE);
+}
+
+#endif	/* _KERNEL */
+
+void
+fletcher_4_init(void)
+{
+	fletcher_4_ops_t *curr_impl;
+	int i, c;
+
+	/* Move supported implementations into fletcher_4_supp_impls */
+	for (i = 0, c = 0; i < ARRAY_SIZE(fletcher_4_impls); i++) {
+		curr_impl = (fletcher_4_ops_t *)fletcher_4_impls[i];
+
+		if (curr_impl->valid())
+			fletcher_4_supp_impls[c++] = curr_impl;
+	}
+	membar_producer();	/* complete fletcher_4_supp_impls[] init */
+	fletcher_4_supp_impls_cnt = c;
+
+#if defined(_KERNEL)
+	/* Benchmark all supported implementations */
+	fletcher_4_benchmark();
+
+	fletcher_4_bench_ksp = kstat_create("zfs", 0, "fletcher_4_bench",
+	    "misc", KSTAT_TYPE_NAMED, 2 * fletcher_4_supp_impls_cnt,
+	    KSTAT_FLAG_VIRTUAL);
+	if (fletcher_4_bench_ksp != NULL) {
+		fletcher_4_bench_ksp->ks_data = fletcher_4_bench_stats;
+		kstat_install(fletcher_4_bench_ksp);
+	}
+#else
+	/*
+	 * Skip the benchmark in user space to avoid impacting libzpool
+	 * consumers (zdb, zhack, zinject, ztest).  The last implementation
+	 * is assumed to be the fastest and used by default.
+	 */
+	(void) memcpy(&fletcher_4_fastest_impl,
+	    fletcher_4_supp_impls[fletcher_4_supp_impls_cnt - 1],
+	    sizeof (fletcher_4_fastest_impl));
+	(void) strcpy(fletcher_4_fastest_impl.name, "fastest");
+#endif /* _KERNEL */
+
+	/* Finish initialization */
+	atomic_swap_32(&fletcher_4_impl_chosen, fletcher_4_user_sel_impl);
+	fletcher_4_initialized = B_TRUE;
+}
+
+void
+fletcher_4_fini(void)
+{
+#if defined(_KERNEL)
+	if (fletcher_4_bench_ksp != NULL) {
+		kstat_delete(fletcher_4_bench_ksp);
+		fletcher_4_bench_ksp = NULL;
+	}
+#endif
 }
@@ -50,6 +50,70 @@ void fletcher_4_native(const void *, size_t, const void *, zio_cksum_t *);
 void fletcher_4_byteswap(const void *, size_t, const void *, zio_cksum_t *);
 int fletcher_4_incremental_native(void *, size_t, void *);
 int fletcher_4_incremental_byteswap(void *, size_t, void *);
+void fletcher_4_init(void);
+void fletcher_4_fini(void);
+int fletcher_4_impl_set(const char *);
+
+/*
+ * fletcher-4 implementation selection
+ *
+ * The fletcher-4 checksum can be computed by several vectorized
+ * implementations in addition to the original serial recurrence.  Each
+ * implementation maintains its accumulators in a private context layout;
+ * the union below is large enough for any of them.  The multi-lane
+ * layouts split the input into interleaved streams and combine the lane
+ * accumulators into the serial checksum when finalized, so a context can
+ * only be finalized on a multiple of the lane stride.
+ */
+#define	FLETCHER_MIN_SIMD_SIZE	64
+
+#define	FLETCHER_4_IMPL_NAME_MAX	(16)
+
+typedef struct zfs_fletcher_superscalar {
+	uint64_t v[4];
+} zfs_fletcher_superscalar_t;
+
+typedef struct zfs_fletcher_avx {
+	uint64_t v[4];
+} zfs_fletcher_avx_t;
+
+typedef struct zfs_fletcher_avx512 {
+	uint64_t v[8];
+} zfs_fletcher_avx512_t;
+
+typedef union fletcher_4_ctx {
+	zio_cksum_t scalar;
+	zfs_fletcher_superscalar_t superscalar[4];
+#if defined(__x86)
+	zfs_fletcher_avx_t avx[4];
+	zfs_fletcher_avx512_t avx512[4];
+#endif
+} fletcher_4_ctx_t;
+
+typedef void (*fletcher_4_init_f)(fletcher_4_ctx_t *);
+typedef void (*fletcher_4_fini_f)(fletcher_4_ctx_t *, zio_cksum_t *);
+typedef void (*fletcher_4_compute_f)(fletcher_4_ctx_t *,
+    const void *, uint64_t);
+
+typedef struct fletcher_4_ops {
+	fletcher_4_init_f init_native;
+	fletcher_4_fini_f fini_native;
+	fletcher_4_compute_f compute_native;
+	fletcher_4_init_f init_byteswap;
+	fletcher_4_fini_f fini_byteswap;
+	fletcher_4_compute_f compute_byteswap;
+	boolean_t (*valid)(void);
+	char name[FLETCHER_4_IMPL_NAME_MAX];
+} fletcher_4_ops_t;
+
+extern const fletcher_4_ops_t fletcher_4_scalar_ops;
+extern const fletcher_4_ops_t fletcher_4_superscalar4_ops;
+#if defined(__x86)
+extern const fletcher_4_ops_t fletcher_4_avx2_ops;
+extern const fletcher_4_ops_t fletcher_4_avx512f_ops;
+#endif
+
+const fletcher_4_ops_t *fletcher_4_impl_get(void);
 
 #ifdef	__cplusplus
 }
@@ -0,0 +1,206 @@
+/*
+ * CDDL HEADER START
+ *
+ * The contents of this file are subject to the terms of the
+ * Common Development and Distribution License (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * You can obtain a copy of the license at usr/src/OPENSOLARIS.LICENSE
+ * or http://www.opensolaris.org/os/licensing.
+ * See the License for the specific language governing permissions
+ * and limitations under the License.
+ *
+ * When distributing Covered Code, include this CDDL HEADER in each
+ * file and include the License file at usr/src/OPENSOLARIS.LICENSE.
+ * If applicable, add the following below this CDDL HEADER, with the
+ * fields enclosed by brackets "[]" replaced with your own identifying
+ * information: Portions Copyright [yyyy] [name of copyright owner]
+ *
+ * CDDL HEADER END
+ */
+/*
+ * Copyright (C) 2016 Romain Dolbeau. All rights reserved.
+ */
+#include <sys/isa_defs.h>
+
+#if defined(__amd64)
+
+#include <sys/types.h>
+#include <sys/sysmacros.h>
+#include <sys/byteorder.h>
+#include <sys/spa.h>
+#include <sys/simd.h>
+#include <zfs_fletcher.h>
+
+/*
+ * AVX-512F fletcher-4 kernels, processing eight interleaved 32-bit
+ * input streams per 512-bit register.  Only foundation instructions are
+ * used, so any AVX-512 capable CPU qualifies; the byteswap variant
+ * swaps lanes with shift/mask arithmetic rather than vpshufb, which
+ * would require AVX512BW.
+ */
+
+#define	FLETCHER_4_AVX512_RESTORE_CTX(ctx)				\
+{									\
+	__asm__ __volatile__("vmovdqu64 %0, %%zmm0"			\
+	    :: "m" ((ctx)->avx512[0]));					\
+	__asm__ __volatile__("vmovdqu64 %0, %%zmm1"			\
+	    :: "m" ((ctx)->avx512[1]));					\
+	__asm__ __volatile__("vmovdqu64 %0, %%zmm2"			\
+	    :: "m" ((ctx)->avx512[2]));					\
+	__asm__ __volatile__("vmovdqu64 %0, %%zmm3"			\
+	    :: "m" ((ctx)->avx512[3]));					\
+}
+
+#define	FLETCHER_4_AVX512_SAVE_CTX(ctx)					\
+{									\
+	__asm__ __volatile__("vmovdqu64 %%zmm0, %0"			\
+	    : "=m" ((ctx)->avx512[0]));					\
+	__asm__ __volatile__("vmovdqu64 %%zmm1, %0"			\
+	    : "=m" ((ctx)->avx512[1]));					\
+	__asm__ __volatile__("vmovdqu64 %%zmm2, %0"			\
+	    : "=m" ((ctx)->avx512[2]));					\
+	__asm__ __volatile__("vmovdqu64 %%zmm3, %0"			\
+	    : "=m" ((ctx)->avx512[3]));					\
+}
+
+static void
+fletcher_4_avx512f_init(fletcher_4_ctx_t *ctx)
+{
+	bzero(ctx->avx512, 4 * sizeof (zfs_fletcher_avx512_t));
+}
+
+/*
+ * The lane accumulators are combined into the serial checksum with
+ * per-lane coefficients that depend only on the lane index, not on the
+ * amount of data processed, so a context can be finalized after any
+ * multiple of the 32-byte stride.
+ */
+static void
+fletcher_4_avx512f_fini(fletcher_4_ctx_t *ctx, zio_cksum_t *zcp)
+{
+	static const uint64_t
+	CcA[] = {   0,   0,   1,   3,   6,  10,  15,  21 },
+	CcB[] = {  28,  36,  44,  52,  60,  68,  76,  84 },
+	DcA[] = {   0,   0,   0,   1,   4,  10,  20,  35 },
+	DcB[] = {  56,  84, 120, 164, 216, 276, 344, 420 },
+	DcC[] = { 448, 512, 576, 640, 704, 768, 832, 896 };
+
+	uint64_t A, B, C, D;
+	uint64_t i;
+
+	A = ctx->avx512[0].v[0];
+	B = 8 * ctx->avx512[1].v[0];
+	C = 64 * ctx->avx512[2].v[0] - CcB[0] * ctx->avx512[1].v[0];
+	D = 512 * ctx->avx512[3].v[0] - DcC[0] * ctx->avx512[2].v[0] +
+	    DcB[0] * ctx->avx512[1].v[0];
+
+	for (i = 1; i < 8; i++) {
+		A += ctx->avx512[0].v[i];
+		B += 8 * ctx->avx512[1].v[i] - i * ctx->avx512[0].v[i];
+		C += 64 * ctx->avx512[2].v[i] - CcB[i] * ctx->avx512[1].v[i] +
+		    CcA[i] * ctx->avx512[0].v[i];
+		D += 512 * ctx->avx512[3].v[i] - DcC[i] * ctx->avx512[2].v[i] +
+		    DcB[i] * ctx->avx512[1].v[i] - DcA[i] * ctx->avx512[0].v[i];
+	}
+
+	ZIO_SET_CHECKSUM(zcp, A, B, C, D);
+}
+
+static void
+fletcher_4_avx512f_native(fletcher_4_ctx_t *ctx, const void *buf,
+    uint64_t size)
+{
+	const uint32_t *ip = buf;
+	const uint32_t *ipend = (uint32_t *)((uint8_t *)ip + size);
+
+	kfpu_begin();
+
+	FLETCHER_4_AVX512_RESTORE_CTX(ctx);
+
+	do {
+		__asm__ __volatile__("vpmovzxdq %0, %%zmm4"::"m" (*ip));
+		__asm__ __volatile__("vpaddq %zmm4, %zmm0, %zmm0");
+		__asm__ __volatile__("vpaddq %zmm0, %zmm1, %zmm1");
+		__asm__ __volatile__("vpaddq %zmm1, %zmm2, %zmm2");
+		__asm__ __volatile__("vpaddq %zmm2, %zmm3, %zmm3");
+	} while ((ip += 8) < ipend);
+
+	FLETCHER_4_AVX512_SAVE_CTX(ctx);
+
+	kfpu_end();
+}
+
+static void
+fletcher_4_avx512f_byteswap(fletcher_4_ctx_t *ctx, const void *buf,
+    uint64_t size)
+{
+	static const uint64_t byteswap_mask = 0xFFULL;
+	const uint32_t *ip = buf;
+	const uint32_t *ipend = (uint32_t *)((uint8_t *)ip + size);
+
+	kfpu_begin();
+
+	FLETCHER_4_AVX512_RESTORE_CTX(ctx);
+
+	__asm__ __volatile__("vpbroadcastq %0, %%zmm8"
+	    :: "m" (byteswap_mask));
+	__asm__ __volatile__("vpsllq $8, %zmm8, %zmm9");
+	__asm__ __volatile__("vpsllq $16, %zmm8, %zmm10");
+	__asm__ __volatile__("vpsllq $24, %zmm8, %zmm11");
+
+	do {
+		__asm__ __volatile__("vpmovzxdq %0, %%zmm5"::"m" (*ip));
+
+		__asm__ __volatile__("vpsrlq $24, %zmm5, %zmm6");
+		__asm__ __volatile__("vpandd %zmm8, %zmm6, %zmm6");
+		__asm__ __volatile__("vpsrlq $8, %zmm5, %zmm7");
+		__asm__ __volatile__("vpandd %zmm9, %zmm7, %zmm7");
+		__asm__ __volatile__("vpord %zmm6, %zmm7, %zmm6");
+		__asm__ __volatile__("vpsllq $8, %zmm5, %zmm7");
+		__asm__ __volatile__("vpandd %zmm10, %zmm7, %zmm7");
+		__asm__ __volatile__("vpord %zmm6, %zmm7, %zmm6");
+		__asm__ __volatile__("vpsllq $24, %zmm5, %zmm5");
+		__asm__ __volatile__("vpandd %zmm11, %zmm5, %zmm5");
+		__asm__ __volatile__("vpord %zmm5, %zmm6, %zmm5");
+
+		__asm__ __volatile__("vpaddq %zmm5, %zmm0, %zmm0");
+		__asm__ __volatile__("vpaddq %zmm0, %zmm1, %zmm1");
+		__asm__ __volatile__("vpaddq %zmm1, %zmm2, %zmm2");
+		__asm__ __volatile__("vpaddq %zmm2, %zmm3, %zmm3");
+	} while ((ip += 8) < ipend);
+
+	FLETCHER_4_AVX512_SAVE_CTX(ctx);
+
+	kfpu_end();
+}
+
+static boolean_t
+fletcher_4_avx512f_valid(void)
+{
+	return (kfpu_allowed() && zfs_avx512f_available());
+}
+
+const fletcher_4_ops_t fletcher_4_avx512f_ops = {
+	.init_native = fletcher_4_avx512f_init,
+	.fini_native = fletcher_4_avx512f_fini,
+	.compute_native = fletcher_4_avx512f_native,
+	.init_byteswap = fletcher_4_avx512f_init,
+	.fini_byteswap = fletcher_4_avx512f_fini,
+	.compute_byteswap = fletcher_4_avx512f_byteswap,
+	.valid = fletcher_4_avx512f_valid,
+	.name = "avx512f"
+};
+
+#elif defined(__i386)
+
+/* 32-bit stub, never selected at run time */
+#include <sys/types.h>
+#include <sys/spa.h>
+#include <zfs_fletcher.h>
+
+const fletcher_4_ops_t fletcher_4_avx512f_ops = {
+	.name = "avx512f"
+};
+
+#endif /* defined(__amd64) */
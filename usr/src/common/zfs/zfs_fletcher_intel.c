@@ -0,0 +1,186 @@
+/*
+ * CDDL HEADER START
+ *
+ * The contents of this file are subject to the terms of the
+ * Common Development and Distribution License (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * You can obtain a copy of the license at usr/src/OPENSOLARIS.LICENSE
+ * or http://www.opensolaris.org/os/licensing.
+ * See the License for the specific language governing permissions
+ * and limitations under the License.
+ *
+ * When distributing Covered Code, include this CDDL HEADER in each
+ * file and include the License file at usr/src/OPENSOLARIS.LICENSE.
+ * If applicable, add the following below this CDDL HEADER, with the
+ * fields enclosed by brackets "[]" replaced with your own identifying
+ * information: Portions Copyright [yyyy] [name of copyright owner]
+ *
+ * CDDL HEADER END
+ */
+/*
+ * Copyright (C) 2016 Gvozden Nešković. All rights reserved.
+ */
+#include <sys/isa_defs.h>
+
+#if defined(__amd64)
+
+#include <sys/types.h>
+#include <sys/sysmacros.h>
+#include <sys/byteorder.h>
+#include <sys/spa.h>
+#include <sys/simd.h>
+#include <zfs_fletcher.h>
+
+/*
+ * AVX2 fletcher-4 kernels.  Four interleaved 32-bit input streams are
+ * processed in a single 256-bit register; the accumulator registers are
+ * spilled to the context around each call so the computation can be
+ * resumed chunk by chunk.  The FPU is only held across a single compute
+ * call, keeping preemption latency bounded.
+ */
+
+#define	FLETCHER_4_AVX2_RESTORE_CTX(ctx)				\
+{									\
+	__asm__ __volatile__("vmovdqu %0, %%ymm0"			\
+	    :: "m" ((ctx)->avx[0]));					\
+	__asm__ __volatile__("vmovdqu %0, %%ymm1"			\
+	    :: "m" ((ctx)->avx[1]));					\
+	__asm__ __volatile__("vmovdqu %0, %%ymm2"			\
+	    :: "m" ((ctx)->avx[2]));					\
+	__asm__ __volatile__("vmovdqu %0, %%ymm3"			\
+	    :: "m" ((ctx)->avx[3]));					\
+}
+
+#define	FLETCHER_4_AVX2_SAVE_CTX(ctx)					\
+{									\
+	__asm__ __volatile__("vmovdqu %%ymm0, %0"			\
+	    : "=m" ((ctx)->avx[0]));					\
+	__asm__ __volatile__("vmovdqu %%ymm1, %0"			\
+	    : "=m" ((ctx)->avx[1]));					\
+	__asm__ __volatile__("vmovdqu %%ymm2, %0"			\
+	    : "=m" ((ctx)->avx[2]));					\
+	__asm__ __volatile__("vmovdqu %%ymm3, %0"			\
+	    : "=m" ((ctx)->avx[3]));					\
+}
+
+static void
+fletcher_4_avx2_init(fletcher_4_ctx_t *ctx)
+{
+	bzero(ctx->avx, 4 * sizeof (zfs_fletcher_avx_t));
+}
+
+static void
+fletcher_4_avx2_fini(fletcher_4_ctx_t *ctx, zio_cksum_t *zcp)
+{
+	uint64_t A, B, C, D;
+
+	A = ctx->avx[0].v[0] + ctx->avx[0].v[1] +
+	    ctx->avx[0].v[2] + ctx->avx[0].v[3];
+	B = 0 - ctx->avx[0].v[1] - 2 * ctx->avx[0].v[2] -
+	    3 * ctx->avx[0].v[3] + 4 * ctx->avx[1].v[0] +
+	    4 * ctx->avx[1].v[1] + 4 * ctx->avx[1].v[2] +
+	    4 * ctx->avx[1].v[3];
+	C = ctx->avx[0].v[2] + 3 * ctx->avx[0].v[3] -
+	    6 * ctx->avx[1].v[0] - 10 * ctx->avx[1].v[1] -
+	    14 * ctx->avx[1].v[2] - 18 * ctx->avx[1].v[3] +
+	    16 * ctx->avx[2].v[0] + 16 * ctx->avx[2].v[1] +
+	    16 * ctx->avx[2].v[2] + 16 * ctx->avx[2].v[3];
+	D = 0 - ctx->avx[0].v[3] + 4 * ctx->avx[1].v[0] +
+	    10 * ctx->avx[1].v[1] + 20 * ctx->avx[1].v[2] +
+	    34 * ctx->avx[1].v[3] - 48 * ctx->avx[2].v[0] -
+	    64 * ctx->avx[2].v[1] - 80 * ctx->avx[2].v[2] -
+	    96 * ctx->avx[2].v[3] + 64 * ctx->avx[3].v[0] +
+	    64 * ctx->avx[3].v[1] + 64 * ctx->avx[3].v[2] +
+	    64 * ctx->avx[3].v[3];
+
+	ZIO_SET_CHECKSUM(zcp, A, B, C, D);
+}
+
+static void
+fletcher_4_avx2_native(fletcher_4_ctx_t *ctx, const void *buf, uint64_t size)
+{
+	const uint64_t *ip = buf;
+	const uint64_t *ipend = (uint64_t *)((uint8_t *)ip + size);
+
+	kfpu_begin();
+
+	FLETCHER_4_AVX2_RESTORE_CTX(ctx);
+
+	do {
+		__asm__ __volatile__("vpmovzxdq %0, %%ymm4"::"m" (*ip));
+		__asm__ __volatile__("vpaddq %ymm4, %ymm0, %ymm0");
+		__asm__ __volatile__("vpaddq %ymm0, %ymm1, %ymm1");
+		__asm__ __volatile__("vpaddq %ymm1, %ymm2, %ymm2");
+		__asm__ __volatile__("vpaddq %ymm2, %ymm3, %ymm3");
+	} while ((ip += 2) < ipend);
+
+	FLETCHER_4_AVX2_SAVE_CTX(ctx);
+	__asm__ __volatile__("vzeroupper");
+
+	kfpu_end();
+}
+
+static void
+fletcher_4_avx2_byteswap(fletcher_4_ctx_t *ctx, const void *buf,
+    uint64_t size)
+{
+	static const zfs_fletcher_avx_t mask = {
+		.v = { 0xFFFFFFFF00010203, 0xFFFFFFFF08090A0B,
+		    0xFFFFFFFF00010203, 0xFFFFFFFF08090A0B }
+	};
+	const uint64_t *ip = buf;
+	const uint64_t *ipend = (uint64_t *)((uint8_t *)ip + size);
+
+	kfpu_begin();
+
+	FLETCHER_4_AVX2_RESTORE_CTX(ctx);
+
+	__asm__ __volatile__("vmovdqu %0, %%ymm5" :: "m" (mask));
+
+	do {
+		__asm__ __volatile__("vpmovzxdq %0, %%ymm4"::"m" (*ip));
+		__asm__ __volatile__("vpshufb %ymm5, %ymm4, %ymm4");
+
+		__asm__ __volatile__("vpaddq %ymm4, %ymm0, %ymm0");
+		__asm__ __volatile__("vpaddq %ymm0, %ymm1, %ymm1");
+		__asm__ __volatile__("vpaddq %ymm1, %ymm2, %ymm2");
+		__asm__ __volatile__("vpaddq %ymm2, %ymm3, %ymm3");
+	} while ((ip += 2) < ipend);
+
+	FLETCHER_4_AVX2_SAVE_CTX(ctx);
+	__asm__ __volatile__("vzeroupper");
+
+	kfpu_end();
+}
+
+static boolean_t
+fletcher_4_avx2_valid(void)
+{
+	return (kfpu_allowed() && zfs_avx_available() &&
+	    zfs_avx2_available());
+}
+
+const fletcher_4_ops_t fletcher_4_avx2_ops = {
+	.init_native = fletcher_4_avx2_init,
+	.fini_native = fletcher_4_avx2_fini,
+	.compute_native = fletcher_4_avx2_native,
+	.init_byteswap = fletcher_4_avx2_init,
+	.fini_byteswap = fletcher_4_avx2_fini,
+	.compute_byteswap = fletcher_4_avx2_byteswap,
+	.valid = fletcher_4_avx2_valid,
+	.name = "avx2"
+};
+
+#elif defined(__i386)
+
+/* 32-bit stub, never selected at run time */
+#include <sys/types.h>
+#include <sys/spa.h>
+#include <zfs_fletcher.h>
+
+const fletcher_4_ops_t fletcher_4_avx2_ops = {
+	.name = "avx2"
+};
+
+#endif /* defined(__amd64) */
@@ -48,6 +48,7 @@ int	port_sendn(int [], int [], uint_t, int, void *);
 int	port_get(int, port_event_t *, struct timespec *);
 int	port_getn(int, port_event_t [], uint_t, uint_t *, struct timespec *);
 int	port_alert(int, int, int, void *);
+int	port_coalesce(int, uint_t, uint_t);
 
 #ifdef	__cplusplus
 }
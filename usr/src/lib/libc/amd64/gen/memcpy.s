@@ -64,6 +64,11 @@
  * } else {
  *	Align destination to 16-byte boundary
  *
+ *	If (ERMS is supported && size >= erms threshold &&
+ *	    size <= half of the largest level cache) {
+ *		Use rep movsb (Enhanced REP MOVSB)
+ *	}
+ *
  *      if (NO_SSE) {
  *		If (size > half of the largest level cache) {
  *			Use 8-byte non-temporal stores (64-bytes/loop)
@@ -927,7 +932,21 @@ L(P7Q0):
 	mov    %r11b,-0x1(%rcx)
 	ret   
 
-	.balign 16               
+	.balign 16
+L(erms_move):
+	/*
+	 * Enhanced REP MOVSB.  %rcx is the (16-byte aligned) destination,
+	 * %rdx the source and %r8 the remaining count; %rax already holds
+	 * the return value.
+	 */
+	mov    %rdx,%rsi
+	mov    %rcx,%rdi
+	mov    %r8,%rcx
+	rep
+	movsb
+	ret
+
+	.balign 16
 L(ck_use_sse2):
 	/*
 	 * Align dest to 16 byte boundary. 
@@ -936,7 +955,20 @@ L(ck_use_sse2):
 	jnz    L(ShrtAlignNew)
 
 L(now_qw_aligned):
-	cmpl   $NO_SSE,.memops_method(%rip) 
+	/*
+	 * If the processor has Enhanced REP MOVSB (in which case
+	 * .erms_threshold was lowered from -1 at libc init), use rep movsb
+	 * for moves up to half of the largest level cache; beyond that the
+	 * non-temporal paths below avoid polluting the cache.
+	 */
+	cmpq   .erms_threshold(%rip),%r8
+	jb     9f
+	mov    .largest_level_cache_size(%rip),%r9d
+	shr    %r9		# take half of it
+	cmp    %r9,%r8
+	jle    L(erms_move)
+9:
+	cmpl   $NO_SSE,.memops_method(%rip)
 	je     L(Loop8byte_pre)
 
 	/*
@@ -61,6 +61,11 @@
  * } else {
  *	Align destination to 16-byte boundary
  *
+ *	If (ERMS is supported && size >= erms threshold &&
+ *	    size <= largest level cache) {
+ *		Use rep stosb (Enhanced REP STOSB)
+ *	}
+ *
  *      if (NO_SSE) {
  *		If (size > largest level cache) {
  *			Use 8-byte non-temporal stores (64-bytes/loop)
@@ -454,8 +459,23 @@ L(P7Q0):	mov    %edx,-0x7(%rdi)
 		ret
 
 		.balign 16
-L(ck_align):                      
-		/* 
+L(erms_set):
+		/*
+		 * Enhanced REP STOSB.  %rdi is the (16-byte aligned)
+		 * destination and %r8 the remaining count; the fill byte
+		 * is the low byte of the replicated pattern in %rdx.
+		 * %rax holds the return value and must be preserved.
+		 */
+		mov    %rax,%r9
+		mov    %dl,%al
+		mov    %r8,%rcx
+		rep
+		stosb
+		mov    %r9,%rax
+		ret
+
+L(ck_align):
+		/*
 		 * Align to 16 byte boundary first
 		 */
 	 	lea    L(AliPxQx)(%rip),%r11
@@ -536,6 +556,19 @@ L(A6Q0):	mov    %dx,-0x6(%rdi)
 
 		.balign 16
 L(aligned_now):
+		/*
+		 * If the processor has Enhanced REP STOSB (in which case
+		 * .erms_threshold was lowered from -1 at libc init), use
+		 * rep stosb up to the largest level cache size; beyond
+		 * that the non-temporal paths below avoid polluting the
+		 * cache.
+		 */
+		cmpq   .erms_threshold(%rip),%r8
+		jb     9f
+		mov    .largest_level_cache_size(%rip),%r9d
+		cmp    %r9,%r8
+		jle    L(erms_set)
+9:
 		/*
 		 * Check memops method
 		 */
@@ -173,6 +173,17 @@ __proc64id(void)
 	int use_sse = NO_SSE;
 	struct cpuid_values cpuid_info;
 
+	/*
+	 * Check for Enhanced REP MOVSB/STOSB support.  Both vendors report
+	 * this the same way, so do it before the vendor-specific probing.
+	 */
+	__libc_get_cpuid(0, &cpuid_info, 0);
+	if (cpuid_info.eax >= 7) {
+		__libc_get_cpuid(7, &cpuid_info, 0);
+		if (cpuid_info.ebx & CPUID_INTC_EBX_7_0_ENH_REP_MOV)
+			__set_erms_threshold(ERMS_MIN_SIZE);
+	}
+
 	__libc_get_cpuid(0, &cpuid_info, 0);
 
 	/*
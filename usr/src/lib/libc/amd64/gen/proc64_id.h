@@ -48,6 +48,14 @@ extern "C" {
 #define	USE_SSE4_2	0x10	/* SSE 4.2 */
 #define	USE_BSF		0x20	/* USE BSF class of instructions */
 
+/*
+ * Minimum copy/set size for using Enhanced REP MOVSB/STOSB when the
+ * processor advertises it (CPUID leaf 7 EBX bit 9).  Below this the
+ * unrolled integer/SSE paths win; above it the microcoded string
+ * operations are at least as fast and considerably smaller.
+ */
+#define	ERMS_MIN_SIZE	4096
+
 /*
  * Cache size defaults for Core 2 Duo
  */
@@ -63,10 +71,12 @@ extern "C" {
 
 #ifdef _ASM
 	.extern .memops_method
+	.extern .erms_threshold
 #else
 
 void __libc_get_cpuid(int cpuid_function, void *out_reg, int cache_index);
 void __intel_set_memops_method(long sse_level);
+void __set_erms_threshold(long threshold);
 void __set_cache_sizes(long l1_cache_size, long l2_cache_size,
     long largest_level_cache);
 
@@ -44,6 +44,7 @@
 	.global .memops_method
 	.global .amd64cache1, .amd64cache1half, .amd64cache2, .amd64cache2half
 	.global .largest_level_cache_size
+	.global .erms_threshold
 
 
 /*
@@ -62,6 +63,15 @@
 .largest_level_cache_size:
 		.int	AMD_DFLT_L2_CACHE_SIZE
 
+/*
+ * Minimum size at which memcpy/memset use rep movsb/stosb.  Defaults to -1
+ * (unsigned compares against it never succeed) and is lowered by
+ * __set_erms_threshold() when the processor supports Enhanced REP MOVSB.
+ */
+	.balign	8
+.erms_threshold:
+		.quad	-1
+
 /*
  * Get cpuid data.
  * (void)__libc_get_cpuid(int cpuid_function, void *out_reg, int cache_index )
@@ -91,6 +101,15 @@
 	ret
 	SET_SIZE(__intel_set_memops_method)
 
+/*
+ * Set minimum size for using Enhanced REP MOVSB/STOSB.
+ * void __set_erms_threshold(long threshold);
+ */
+	ENTRY(__set_erms_threshold)
+	mov	%rdi,.erms_threshold(%rip)
+	ret
+	SET_SIZE(__set_erms_threshold)
+
 /*
  * Set cache info global variables used by various libc primitives.
  * __set_cache_sizes(long l1_cache_size, long l2_cache_size,
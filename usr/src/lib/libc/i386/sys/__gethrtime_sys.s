@@ -0,0 +1,30 @@
+/*
+ * This file and its contents are supplied under the terms of the
+ * Common Development and Distribution License ("CDDL"), version 1.0.
+ * You may only use this file in accordance with the terms of version
+ * 1.0 of the CDDL.
+ *
+ * A full copy of the text of the CDDL should have accompanied this
+ * source.  A copy of the CDDL is also available via the Internet at
+ * http://www.illumos.org/license/CDDL.
+ */
+
+	.file	"__gethrtime_sys.s"
+
+#include <sys/asm_linkage.h>
+#include "SYS.h"
+
+/*
+ * hrtime_t
+ * __gethrtime_sys(void)
+ *
+ * Fast-trap fallback for gethrtime(), used when the comm page cannot
+ * supply the timestamp (see gethrtime.c).  The trap returns the
+ * 64-bit value in %edx:%eax, which is also the 32-bit ABI convention
+ * for returning a long long, so nothing needs to be moved.
+ */
+
+	ENTRY(__gethrtime_sys)
+	SYSFASTTRAP(GETHRTIME)
+	RET
+	SET_SIZE(__gethrtime_sys)
@@ -505,17 +505,32 @@ typedef struct {
 typedef struct {
 	size_t		tm_size;
 	void		*tm_roots[NTMEMBASE];
+	uint_t		tm_gen;		/* libumem cache-drain generation */
 } tumem_t;
 
 #ifdef _SYSCALL32
 typedef struct {
 	uint32_t	tm_size;
 	caddr32_t	tm_roots[NTMEMBASE];
+	uint32_t	tm_gen;		/* libumem cache-drain generation */
 } tumem32_t;
 #endif
 
 typedef void (*tmem_func_t)(void *, int);
 
+/*
+ * Per-thread cache of small blocks for libc's own malloc(), analogous to
+ * the libumem per-thread cache above.  The roots are per-size-class linked
+ * lists of recently freed blocks and mc_size is the total number of bytes
+ * cached.  See the description in port/gen/malloc.c.
+ */
+#define	NMCACHE		16
+
+typedef struct {
+	size_t		mc_size;	/* total bytes cached */
+	void		*mc_roots[NMCACHE]; /* per-size-class free lists */
+} tmcache_t;
+
 /*
  * Maximum number of read locks allowed for one thread on one rwlock.
  * This could be as large as INT_MAX, but the SUSV3 test suite would
@@ -685,6 +700,7 @@ typedef struct ulwp {
 	tumem_t		ul_tmem;	/* used only by umem */
 	uint_t		ul_ptinherit;	/* pthreads sched inherit value */
 	char		ul_ntoabuf[18];	/* thread-specific inet_ntoa buffer */
+	tmcache_t	ul_mcache;	/* small-block cache for malloc() */
 } ulwp_t;
 
 #define	ul_cursig	ul_cp.s.cursig		/* deferred signal number */
@@ -1277,6 +1293,7 @@ extern	void	finish_init(void);
 extern	void	update_sched(ulwp_t *);
 extern	void	queue_alloc(void);
 extern	void	tmem_exit(void);
+extern	void	mcache_exit(void);
 extern	void	tsd_exit(void);
 extern	void	tsd_free(ulwp_t *);
 extern	void	tls_setup(void);
@@ -98,6 +98,22 @@ port_getn(int port, port_event_t list[], uint_t max, uint_t *nget,
 	return (r.r_val2);
 }
 
+/*
+ * Configure timed event coalescing on a port. A port_getn() retrieval on a
+ * port with coalescing enabled lingers - once the requested number of
+ * events is available - for up to 'usec' microseconds or until 'events'
+ * events have accumulated, whichever comes first, amortizing the retrieval
+ * cost over larger batches. Passing zero for both arguments turns
+ * coalescing off. port_get() is never delayed.
+ */
+int
+port_coalesce(int port, uint_t events, uint_t usec)
+{
+	rval_t	r;
+	r.r_vals = _portfs(PORT_COALESCE, port, events, usec, 0, 0);
+	return (r.r_val1);
+}
+
 int
 port_dissociate(int port, int source, uintptr_t object)
 {
@@ -63,6 +63,7 @@
 #include "lint.h"
 #include "mallint.h"
 #include "mtlib.h"
+#include "thr_uberdata.h"
 
 /*
  * Some abusers of the system (notably java1.2) acquire __malloc_lock
@@ -97,6 +98,104 @@ static void	*_malloc_unlocked(size_t);
 static void *flist[FREESIZE];	/* list of blocks to be freed on next malloc */
 static int freeidx;		/* index of free blocks in flist % FREESIZE */
 
+/*
+ * Per-thread small-block cache.
+ *
+ * Every malloc() and free() serializes on libc_malloc_lock, which makes
+ * the lock the bottleneck in multithreaded processes that have not linked
+ * an alternate malloc library.  Borrowing the per-thread caching design
+ * that libumem uses (see ul_tmem in thr_uberdata.h and section 8.4 of
+ * libumem's big theory statement), each thread keeps recently freed small
+ * blocks on per-size-class linked lists in its ulwp_t.  free() of a small
+ * block pushes it onto the owning thread's list and malloc() of a small
+ * size pops from it, neither taking the lock.  Cached blocks keep BIT0
+ * set in their headers, so to the tree allocator they are indistinguishable
+ * from allocated blocks and are never coalesced; the first word of the
+ * data area links the list.  Each class caches blocks whose rounded size
+ * is exactly (class + 1) * WORDSIZE, so a cache hit always returns a block
+ * of the size the header claims.
+ *
+ * The cache is bounded by MCACHE_MAXSIZE bytes per thread; frees beyond
+ * that fall through to the locked path.  When a thread exits, its cache is
+ * returned to the global pool by mcache_exit(), called from _thrp_exit()
+ * alongside tmem_exit().  As with the libumem cache, blocks cached by
+ * other threads at the time of fork() are not recovered in the child.
+ */
+#define	MCACHE_MAXSIZE	(64 * 1024)		/* max bytes cached/thread */
+#define	MCACHE_MAXCLASS	(NMCACHE * WORDSIZE)	/* largest cached block */
+
+static void *
+mcache_alloc(size_t size)
+{
+	tmcache_t *tcp = &curthread->ul_mcache;
+	void	*buf;
+	size_t	i;
+
+	ROUND(size);
+	if (size == 0)
+		size = WORDSIZE;	/* mirrors _smalloc() */
+	if (size > MCACHE_MAXCLASS)
+		return (NULL);
+
+	i = size / WORDSIZE - 1;
+	if ((buf = tcp->mc_roots[i]) == NULL)
+		return (NULL);
+	tcp->mc_roots[i] = *(void **)buf;
+	tcp->mc_size -= size;
+	return (buf);
+}
+
+static int
+mcache_free(void *old)
+{
+	tmcache_t *tcp = &curthread->ul_mcache;
+	size_t	ts, i;
+
+	ts = SIZE(BLOCK(old));
+	if (!ISBIT0(ts))	/* free already; let the slow path catch it */
+		return (0);
+	CLRBITS01(ts);
+	if (ts == 0 || ts > MCACHE_MAXCLASS ||
+	    tcp->mc_size + ts > MCACHE_MAXSIZE)
+		return (0);
+
+	i = ts / WORDSIZE - 1;
+	if (tcp->mc_roots[i] == old)	/* immediate double free */
+		return (1);
+	*(void **)old = tcp->mc_roots[i];
+	tcp->mc_roots[i] = old;
+	tcp->mc_size += ts;
+	return (1);
+}
+
+/*
+ * Called from _thrp_exit() to return the exiting thread's cached blocks
+ * to the global pool.
+ */
+void
+mcache_exit(void)
+{
+	tmcache_t *tcp = &curthread->ul_mcache;
+	void	*buf, *next;
+	int	i;
+
+	if (tcp->mc_size == 0)
+		return;
+
+	(void) mutex_lock(&libc_malloc_lock);
+	for (i = 0; i < NMCACHE; i++) {
+		buf = tcp->mc_roots[i];
+		while (buf != NULL) {
+			next = *(void **)buf;
+			_free_unlocked(buf);
+			buf = next;
+		}
+		tcp->mc_roots[i] = NULL;
+	}
+	tcp->mc_size = 0;
+	(void) mutex_unlock(&libc_malloc_lock);
+}
+
 /*
  * Interfaces used only by atfork_init() functions.
  */
@@ -169,6 +268,8 @@ malloc(size_t size)
 		return (NULL);
 	}
 	assert_no_libc_locks_held();
+	if ((ret = mcache_alloc(size)) != NULL)
+		return (ret);
 	(void) mutex_lock(&libc_malloc_lock);
 	ret = _malloc_unlocked(size);
 	(void) mutex_unlock(&libc_malloc_lock);
@@ -858,6 +959,10 @@ free(void *old)
 		return;
 	}
 	assert_no_libc_locks_held();
+	if (old == NULL)
+		return;
+	if (mcache_free(old))
+		return;
 	(void) mutex_lock(&libc_malloc_lock);
 	_free_unlocked(old);
 	(void) mutex_unlock(&libc_malloc_lock);
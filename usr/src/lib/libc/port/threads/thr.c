@@ -790,6 +790,7 @@ _thrp_exit()
 	tsd_exit();		/* deallocate thread-specific data */
 	tls_exit();		/* deallocate thread-local storage */
 	tmem_exit();		/* deallocate tmem allocations */
+	mcache_exit();		/* return cached malloc() blocks */
 	heldlock_exit();	/* deal with left-over held locks */
 
 	/* block all signals to finish exiting */
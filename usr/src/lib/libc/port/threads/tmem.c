@@ -52,6 +52,17 @@ _tmem_set_cleanup(tmem_func_t f)
 	tmem_cleanup = f;
 }
 
+/*
+ * Returns a pointer to the calling thread's tmem structure.  This is used
+ * by libumem's per-thread cache drain logic, which must be able to walk
+ * the calling thread's roots from C code.
+ */
+void *
+_tmem_get_current(void)
+{
+	return (&curthread->ul_tmem);
+}
+
 /*
  * This is called by _thrp_exit() to clean up any per-thread allocations that
  * are still hanging around and haven't been cleaned up.
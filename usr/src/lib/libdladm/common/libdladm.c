@@ -131,6 +131,8 @@ dladm_open(dladm_handle_t *handle)
 	(*handle)->dld_fd = dld_fd;
 	(*handle)->door_fd = -1;
 	(*handle)->dld_kcp = NULL;
+	(*handle)->dld_nwalklinks = 0;
+	(*handle)->dld_walklinks = NULL;
 
 	return (DLADM_STATUS_OK);
 }
@@ -144,6 +146,7 @@ dladm_close(dladm_handle_t handle)
 			(void) close(handle->door_fd);
 		if (handle->dld_kcp != NULL)
 			(void) kstat_close(handle->dld_kcp);
+		free(handle->dld_walklinks);
 		free(handle);
 	}
 }
@@ -54,6 +54,12 @@ struct dladm_handle {
 	int dld_fd;	/* file descriptor to DLD_CONTROL_DEV */
 	int door_fd;	/* file descriptor to DLMGMT_DOOR */
 	kstat_ctl_t *dld_kcp;	/* for kstat consumers */
+	/*
+	 * The current batch of links fetched by dladm_walk_datalink_id();
+	 * only valid for the duration of a walk.  See libdlmgmt.c.
+	 */
+	uint_t dld_nwalklinks;
+	struct dlmgmt_getnextmany_link_s *dld_walklinks;
 };
 
 /* DLMGMT_DOOR can only be accessed by libdladm and dlmgmtd */
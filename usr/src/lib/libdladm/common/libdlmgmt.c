@@ -265,27 +265,60 @@ i_dladm_phys_status(dladm_handle_t handle, datalink_id_t linkid,
 }
 
 /*
- * Walk each entry in the data link configuration repository and
- * call fn on the linkid and arg.
+ * Cache the current DLMGMT_CMD_GETNEXTMANY batch on the handle so that
+ * dladm_datalink_id2info() calls made from within a walker callback can be
+ * answered without a DLMGMT_CMD_GETNAME door call per link.  The cache is
+ * only valid for the duration of a dladm_walk_datalink_id() call.
  */
-dladm_status_t
-dladm_walk_datalink_id(int (*fn)(dladm_handle_t, datalink_id_t, void *),
-    dladm_handle_t handle, void *argp, datalink_class_t class,
-    datalink_media_t dmedia, uint32_t flags)
+static void
+i_dladm_walk_cache_update(dladm_handle_t handle,
+    const dlmgmt_getnextmany_link_t *links, uint_t nlinks)
+{
+	if (nlinks > DLMGMT_GETNEXTMANY_NLINKS)
+		nlinks = DLMGMT_GETNEXTMANY_NLINKS;
+
+	if (handle->dld_walklinks == NULL) {
+		handle->dld_walklinks = malloc(DLMGMT_GETNEXTMANY_NLINKS *
+		    sizeof (dlmgmt_getnextmany_link_t));
+		if (handle->dld_walklinks == NULL)
+			return;
+	}
+	(void) memcpy(handle->dld_walklinks, links,
+	    nlinks * sizeof (dlmgmt_getnextmany_link_t));
+	handle->dld_nwalklinks = nlinks;
+}
+
+static dladm_status_t
+i_dladm_walk_cache_lookup(dladm_handle_t handle, datalink_id_t linkid,
+    dlmgmt_getnextmany_link_t *lep)
+{
+	uint_t	i;
+
+	for (i = 0; i < handle->dld_nwalklinks; i++) {
+		if (handle->dld_walklinks[i].le_linkid == linkid) {
+			*lep = handle->dld_walklinks[i];
+			return (DLADM_STATUS_OK);
+		}
+	}
+	return (DLADM_STATUS_NOTFOUND);
+}
+
+/*
+ * Walk the repository one link per door call.  This is only used when
+ * dlmgmtd does not support DLMGMT_CMD_GETNEXTMANY (an older boot
+ * environment's daemon with a newer libdladm).
+ */
+static dladm_status_t
+i_dladm_walk_datalink_id_onebyone(int (*fn)(dladm_handle_t, datalink_id_t,
+    void *), dladm_handle_t handle, void *argp, datalink_class_t class,
+    datalink_media_t dmedia, uint32_t dlmgmt_flags)
 {
 	dlmgmt_door_getnext_t	getnext;
 	dlmgmt_getnext_retval_t	retval;
-	uint32_t		dlmgmt_flags;
 	datalink_id_t		linkid = DATALINK_INVALID_LINKID;
 	dladm_status_t		status = DLADM_STATUS_OK;
 	size_t			sz = sizeof (retval);
 
-	if (fn == NULL)
-		return (DLADM_STATUS_BADARG);
-
-	dlmgmt_flags = (flags & DLADM_OPT_ACTIVE) ? DLMGMT_ACTIVE : 0;
-	dlmgmt_flags |= ((flags & DLADM_OPT_PERSIST) ? DLMGMT_PERSIST : 0);
-
 	getnext.ld_cmd = DLMGMT_CMD_GETNEXT;
 	getnext.ld_class = class;
 	getnext.ld_dmedia = dmedia;
@@ -328,6 +361,113 @@ dladm_walk_datalink_id(int (*fn)(dladm_handle_t, datalink_id_t, void *),
 	return (status);
 }
 
+/*
+ * Walk each entry in the data link configuration repository and
+ * call fn on the linkid and arg.  Links are fetched from dlmgmtd in
+ * batches of up to DLMGMT_GETNEXTMANY_NLINKS so that large repositories
+ * (thousands of VNICs) do not cost one door round-trip per link.
+ */
+dladm_status_t
+dladm_walk_datalink_id(int (*fn)(dladm_handle_t, datalink_id_t, void *),
+    dladm_handle_t handle, void *argp, datalink_class_t class,
+    datalink_media_t dmedia, uint32_t flags)
+{
+	dlmgmt_door_getnextmany_t	getnext;
+	dlmgmt_getnextmany_retval_t	retval;
+	uint32_t		dlmgmt_flags;
+	datalink_id_t		linkid = DATALINK_INVALID_LINKID;
+	dladm_status_t		status = DLADM_STATUS_OK;
+	boolean_t		done = B_FALSE;
+	size_t			sz;
+	uint_t			i;
+
+	if (fn == NULL)
+		return (DLADM_STATUS_BADARG);
+
+	dlmgmt_flags = (flags & DLADM_OPT_ACTIVE) ? DLMGMT_ACTIVE : 0;
+	dlmgmt_flags |= ((flags & DLADM_OPT_PERSIST) ? DLMGMT_PERSIST : 0);
+
+	getnext.ld_cmd = DLMGMT_CMD_GETNEXTMANY;
+	getnext.ld_class = class;
+	getnext.ld_dmedia = dmedia;
+	getnext.ld_flags = dlmgmt_flags;
+	getnext.ld_maxlinks = DLMGMT_GETNEXTMANY_NLINKS;
+	getnext.ld_padding = 0;
+
+	while (!done) {
+		getnext.ld_linkid = linkid;
+		sz = sizeof (retval);
+		status = dladm_door_call(handle, &getnext, sizeof (getnext),
+		    &retval, &sz);
+		if (status != DLADM_STATUS_OK) {
+			/*
+			 * Done with walking. If no next datalink is found,
+			 * return success.
+			 */
+			if (status == DLADM_STATUS_NOTFOUND) {
+				status = DLADM_STATUS_OK;
+			} else if (linkid == DATALINK_INVALID_LINKID) {
+				/*
+				 * An older daemon answers an unknown command
+				 * with a generic EINVAL retval, which
+				 * dladm_door_call() reports as a failure
+				 * since the reply size doesn't match.  Retry
+				 * with the one-link-at-a-time protocol.
+				 */
+				return (i_dladm_walk_datalink_id_onebyone(fn,
+				    handle, argp, class, dmedia,
+				    dlmgmt_flags));
+			}
+			break;
+		}
+
+		/*
+		 * An empty batch reports ENOENT above; treat one anyway as
+		 * the end of the walk so that the loop always advances.
+		 */
+		if (retval.lr_nlinks == 0)
+			break;
+		if (retval.lr_nlinks > DLMGMT_GETNEXTMANY_NLINKS)
+			retval.lr_nlinks = DLMGMT_GETNEXTMANY_NLINKS;
+
+		i_dladm_walk_cache_update(handle, retval.lr_links,
+		    retval.lr_nlinks);
+
+		for (i = 0; i < retval.lr_nlinks; i++) {
+			dlmgmt_getnextmany_link_t	*lep =
+			    &retval.lr_links[i];
+			uint32_t			le_flags =
+			    lep->le_flags;
+
+			linkid = lep->le_linkid;
+			if ((lep->le_class == DATALINK_CLASS_PHYS) &&
+			    (le_flags & DLMGMT_ACTIVE)) {
+				/*
+				 * An active physical link reported by the
+				 * dlmgmtd daemon might not be active
+				 * anymore. Check its real status.
+				 */
+				if (i_dladm_phys_status(handle, linkid,
+				    &le_flags) != DLADM_STATUS_OK) {
+					continue;
+				}
+
+				if (!(dlmgmt_flags & le_flags))
+					continue;
+			}
+
+			if (fn(handle, linkid, argp) ==
+			    DLADM_WALK_TERMINATE) {
+				done = B_TRUE;
+				break;
+			}
+		}
+	}
+
+	handle->dld_nwalklinks = 0;
+	return (status);
+}
+
 /*
  * Get a handle of a copy of the link configuration (kept in the daemon)
  * for the given link so it can be updated later by dladm_write_conf().
@@ -583,16 +723,55 @@ dladm_datalink_id2info(dladm_handle_t handle, datalink_id_t linkid,
     uint32_t *flagp, datalink_class_t *classp, uint32_t *mediap, char *link,
     size_t len)
 {
-	dlmgmt_door_getname_t	getname;
-	dlmgmt_getname_retval_t	retval;
-	dladm_status_t		status;
-	size_t			sz = sizeof (retval);
+	dlmgmt_door_getname_t		getname;
+	dlmgmt_getname_retval_t		retval;
+	dlmgmt_getnextmany_link_t	le;
+	dladm_status_t			status;
+	size_t				sz = sizeof (retval);
 
 	if ((linkid == DATALINK_INVALID_LINKID) || (link != NULL && len == 0) ||
 	    (link == NULL && len != 0)) {
 		return (DLADM_STATUS_BADARG);
 	}
 
+	/*
+	 * If this link is in the batch cached by an in-progress
+	 * dladm_walk_datalink_id() walk, answer from it and save a door
+	 * call; show paths look up the name of each link they walk.
+	 */
+	if (i_dladm_walk_cache_lookup(handle, linkid, &le) ==
+	    DLADM_STATUS_OK) {
+		if (len != 0 && (strlen(le.le_link) + 1 > len))
+			return (DLADM_STATUS_TOOSMALL);
+
+		if (le.le_class == DATALINK_CLASS_PHYS &&
+		    le.le_flags & DLMGMT_ACTIVE) {
+			/*
+			 * An active physical link reported by the dlmgmtd
+			 * daemon might not be active anymore. Check and set
+			 * its real status.
+			 */
+			status = i_dladm_phys_status(handle, linkid,
+			    &le.le_flags);
+			if (status != DLADM_STATUS_OK)
+				return (status);
+		}
+
+		if (link != NULL)
+			(void) strlcpy(link, le.le_link, len);
+		if (classp != NULL)
+			*classp = le.le_class;
+		if (mediap != NULL)
+			*mediap = le.le_media;
+		if (flagp != NULL) {
+			*flagp = le.le_flags & DLMGMT_ACTIVE ?
+			    DLADM_OPT_ACTIVE : 0;
+			*flagp |= (le.le_flags & DLMGMT_PERSIST) ?
+			    DLADM_OPT_PERSIST : 0;
+		}
+		return (DLADM_STATUS_OK);
+	}
+
 	getname.ld_cmd = DLMGMT_CMD_GETNAME;
 	getname.ld_linkid = linkid;
 	if ((status = dladm_door_call(handle, &getname, sizeof (getname),
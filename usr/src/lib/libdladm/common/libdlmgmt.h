@@ -59,6 +59,7 @@ extern "C" {
 #define	DLMGMT_CMD_GETCONFSNAPSHOT	(DLMGMT_CMD_BASE + 12)
 #define	DLMGMT_CMD_ZONEBOOT		(DLMGMT_CMD_BASE + 13)
 #define	DLMGMT_CMD_ZONEHALT		(DLMGMT_CMD_BASE + 14)
+#define	DLMGMT_CMD_GETNEXTMANY		(DLMGMT_CMD_BASE + 15)
 
 typedef struct dlmgmt_door_createid_s {
 	int			ld_cmd;
@@ -156,6 +157,37 @@ typedef struct dlmgmt_getconfsnapshot_retval_s {
 	/* buffer for nvl */
 } dlmgmt_getconfsnapshot_retval_t;
 
+/*
+ * The number of links returned by a single DLMGMT_CMD_GETNEXTMANY call is
+ * capped so that the reply remains a small fixed-size door return buffer;
+ * 64 entries keep it around 3K.
+ */
+#define	DLMGMT_GETNEXTMANY_NLINKS	64
+
+typedef struct dlmgmt_door_getnextmany_s {
+	int			ld_cmd;
+	datalink_id_t		ld_linkid;
+	datalink_class_t	ld_class;
+	uint32_t		ld_flags;
+	datalink_media_t	ld_dmedia;
+	uint_t			ld_maxlinks;
+	uint_t			ld_padding;
+} dlmgmt_door_getnextmany_t;
+
+typedef struct dlmgmt_getnextmany_link_s {
+	datalink_id_t		le_linkid;
+	datalink_class_t	le_class;
+	uint32_t		le_media;
+	uint32_t		le_flags;
+	char			le_link[MAXLINKNAMELEN];
+} dlmgmt_getnextmany_link_t;
+
+typedef struct dlmgmt_getnextmany_retval_s {
+	uint_t			lr_err;
+	uint_t			lr_nlinks;
+	dlmgmt_getnextmany_link_t lr_links[DLMGMT_GETNEXTMANY_NLINKS];
+} dlmgmt_getnextmany_retval_t;
+
 typedef struct dlmgmt_door_zone_s {
 	int			ld_cmd;
 	zoneid_t		ld_zoneid;
@@ -112,6 +112,8 @@ static const struct {
 	{ EDT_ENABLING_ERR, "Failed to enable probe" },
 	{ EDT_NOPROBES, "No probe sites found for declared provider" },
 	{ EDT_CANTLOAD, "Failed to load module" },
+	{ EDT_DOFINVAL, "Saved program file is corrupt or not DOF" },
+	{ EDT_DOFSTALE, "Saved program was generated on a different kernel" },
 };
 
 static const int _dt_nerr = sizeof (_dt_errlist) / sizeof (_dt_errlist[0]);
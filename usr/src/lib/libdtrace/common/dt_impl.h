@@ -532,7 +532,9 @@ enum {
 	EDT_OVERSION,		/* client is requesting deprecated version */
 	EDT_ENABLING_ERR,	/* failed to enable probe */
 	EDT_NOPROBES,		/* no probes sites for declared provider */
-	EDT_CANTLOAD		/* failed to load a module */
+	EDT_CANTLOAD,		/* failed to load a module */
+	EDT_DOFINVAL,		/* saved DOF file is corrupt or foreign */
+	EDT_DOFSTALE		/* saved DOF from a different kernel */
 };
 
 /*
@@ -24,6 +24,7 @@
  * Copyright (c) 2011 by Delphix. All rights reserved.
  */
 
+#include <sys/utsname.h>
 #include <unistd.h>
 #include <strings.h>
 #include <stdlib.h>
@@ -147,20 +148,12 @@ dtrace_program_info(dtrace_hdl_t *dtp, dtrace_prog_t *pgp,
 	}
 }
 
-int
-dtrace_program_exec(dtrace_hdl_t *dtp, dtrace_prog_t *pgp,
-    dtrace_proginfo_t *pip)
+static int
+dt_program_enable(dtrace_hdl_t *dtp, void *dof, int *matchedp)
 {
-	void *dof;
 	int n, err;
 
-	dtrace_program_info(dtp, pgp, pip);
-
-	if ((dof = dtrace_dof_create(dtp, pgp, DTRACE_D_STRIP)) == NULL)
-		return (-1);
-
 	n = dt_ioctl(dtp, DTRACEIOC_ENABLE, dof);
-	dtrace_dof_destroy(dtp, dof);
 
 	if (n == -1) {
 		switch (errno) {
@@ -183,12 +176,211 @@ dtrace_program_exec(dtrace_hdl_t *dtp, dtrace_prog_t *pgp,
 		return (dt_set_errno(dtp, err));
 	}
 
+	*matchedp = n;
+	return (0);
+}
+
+int
+dtrace_program_exec(dtrace_hdl_t *dtp, dtrace_prog_t *pgp,
+    dtrace_proginfo_t *pip)
+{
+	void *dof;
+	int n;
+
+	dtrace_program_info(dtp, pgp, pip);
+
+	if ((dof = dtrace_dof_create(dtp, pgp, DTRACE_D_STRIP)) == NULL)
+		return (-1);
+
+	if (dt_program_enable(dtp, dof, &n) != 0) {
+		dtrace_dof_destroy(dtp, dof);
+		return (-1); /* dt_errno is set for us */
+	}
+
+	dtrace_dof_destroy(dtp, dof);
+
 	if (pip != NULL)
 		pip->dpi_matches += n;
 
 	return (0);
 }
 
+/*
+ * Write a compiled program to the specified file descriptor as DOF so that
+ * it can later be enabled by dtrace_program_load() without recompiling the
+ * source.  The DOF is generated unstripped: the utsname of the compiling
+ * system rides along in a DOF_SECT_UTSNAME section, and the load side uses
+ * it to refuse output saved under a different kernel.  Cache keying beyond
+ * that (e.g. by a hash of the source) is the caller's responsibility.
+ */
+int
+dtrace_program_save(dtrace_hdl_t *dtp, dtrace_prog_t *pgp, int fd)
+{
+	dof_hdr_t *dof;
+	size_t off = 0, len;
+	ssize_t n;
+
+	if ((dof = dtrace_dof_create(dtp, pgp, 0)) == NULL)
+		return (-1); /* dt_errno is set for us */
+
+	len = dof->dofh_filesz;
+
+	while (off < len) {
+		n = write(fd, (char *)dof + off, len - off);
+
+		if (n == -1) {
+			if (errno == EINTR)
+				continue;
+			dtrace_dof_destroy(dtp, dof);
+			return (dt_set_errno(dtp, EDT_FIO));
+		}
+
+		off += n;
+	}
+
+	dtrace_dof_destroy(dtp, dof);
+	return (0);
+}
+
+static int
+dt_program_read(int fd, void *buf, size_t len)
+{
+	size_t off = 0;
+	ssize_t n;
+
+	while (off < len) {
+		n = read(fd, (char *)buf + off, len - off);
+
+		if (n == -1) {
+			if (errno == EINTR)
+				continue;
+			return (-1);
+		}
+
+		if (n == 0)
+			return (-1); /* premature EOF */
+
+		off += n;
+	}
+
+	return (0);
+}
+
+/*
+ * Read a program previously written by dtrace_program_save() and enable it.
+ * The saved form is DOF -- exactly what the kernel consumes at enable time --
+ * so no dtrace_prog_t is reconstructed here: the enabling is submitted
+ * directly, and record and format metadata are subsequently retrieved from
+ * the kernel, just as they are when claiming anonymous tracing state.  The
+ * DOF header identity and the embedded utsname are validated so that output
+ * generated by an incompatible library or under a different kernel fails
+ * cleanly here rather than in the ioctl path.
+ */
+int
+dtrace_program_load(dtrace_hdl_t *dtp, int fd, dtrace_proginfo_t *pip)
+{
+	dof_hdr_t hdr, *dof;
+	dof_sec_t *sp;
+	struct utsname *uts;
+	int n, err = 0;
+	uint_t i;
+
+	if (dt_program_read(fd, &hdr, sizeof (hdr)) != 0)
+		return (dt_set_errno(dtp, EDT_FIO));
+
+	if (hdr.dofh_ident[DOF_ID_MAG0] != DOF_MAG_MAG0 ||
+	    hdr.dofh_ident[DOF_ID_MAG1] != DOF_MAG_MAG1 ||
+	    hdr.dofh_ident[DOF_ID_MAG2] != DOF_MAG_MAG2 ||
+	    hdr.dofh_ident[DOF_ID_MAG3] != DOF_MAG_MAG3 ||
+	    hdr.dofh_ident[DOF_ID_ENCODING] != DOF_ENCODE_NATIVE)
+		return (dt_set_errno(dtp, EDT_DOFINVAL));
+
+	if (hdr.dofh_ident[DOF_ID_VERSION] != DOF_VERSION_1 &&
+	    hdr.dofh_ident[DOF_ID_VERSION] != DOF_VERSION_2)
+		return (dt_set_errno(dtp, EDT_DOFINVAL));
+
+	if (dtp->dt_conf.dtc_ctfmodel == CTF_MODEL_LP64 ?
+	    hdr.dofh_ident[DOF_ID_MODEL] != DOF_MODEL_LP64 :
+	    hdr.dofh_ident[DOF_ID_MODEL] != DOF_MODEL_ILP32)
+		return (dt_set_errno(dtp, EDT_DATAMODEL));
+
+	if (hdr.dofh_ident[DOF_ID_DIFVERS] > dtp->dt_conf.dtc_difversion ||
+	    hdr.dofh_ident[DOF_ID_DIFIREG] > dtp->dt_conf.dtc_difintregs ||
+	    hdr.dofh_ident[DOF_ID_DIFTREG] > dtp->dt_conf.dtc_diftupregs)
+		return (dt_set_errno(dtp, EDT_DIFVERS));
+
+	if (hdr.dofh_hdrsize != sizeof (dof_hdr_t) ||
+	    hdr.dofh_secsize != sizeof (dof_sec_t) ||
+	    hdr.dofh_filesz < sizeof (dof_hdr_t) ||
+	    hdr.dofh_filesz < hdr.dofh_loadsz ||
+	    hdr.dofh_secoff > hdr.dofh_filesz ||
+	    hdr.dofh_secnum > (hdr.dofh_filesz - hdr.dofh_secoff) /
+	    sizeof (dof_sec_t))
+		return (dt_set_errno(dtp, EDT_DOFINVAL));
+
+	if ((dof = dt_alloc(dtp, hdr.dofh_filesz)) == NULL)
+		return (-1); /* dt_errno is set for us */
+
+	bcopy(&hdr, dof, sizeof (hdr));
+
+	if (dt_program_read(fd, (char *)dof + sizeof (hdr),
+	    hdr.dofh_filesz - sizeof (hdr)) != 0) {
+		dt_free(dtp, dof);
+		return (dt_set_errno(dtp, EDT_FIO));
+	}
+
+	/*
+	 * Refuse DOF that was generated under a different kernel.  A saved
+	 * enabling bakes in probe descriptions and DIF compiled against the
+	 * kernel of the system that ran dtrace_program_save(), so a cached
+	 * copy is only good for as long as uname(2) output is unchanged.
+	 */
+	for (i = 0; i < dof->dofh_secnum; i++) {
+		sp = (dof_sec_t *)(uintptr_t)((char *)dof +
+		    dof->dofh_secoff + i * dof->dofh_secsize);
+
+		if (sp->dofs_type != DOF_SECT_UTSNAME)
+			continue;
+
+		if (sp->dofs_offset > hdr.dofh_filesz ||
+		    sp->dofs_size > hdr.dofh_filesz - sp->dofs_offset ||
+		    sp->dofs_size < sizeof (struct utsname)) {
+			err = EDT_DOFINVAL;
+			break;
+		}
+
+		/* LINTED - alignment */
+		uts = (struct utsname *)((char *)dof + sp->dofs_offset);
+
+		if (strcmp(uts->release, dtp->dt_uts.release) != 0 ||
+		    strcmp(uts->version, dtp->dt_uts.version) != 0 ||
+		    strcmp(uts->machine, dtp->dt_uts.machine) != 0)
+			err = EDT_DOFSTALE;
+		break;
+	}
+
+	if (err != 0) {
+		dt_free(dtp, dof);
+		return (dt_set_errno(dtp, err));
+	}
+
+	if (dt_program_enable(dtp, dof, &n) != 0) {
+		dt_free(dtp, dof);
+		return (-1); /* dt_errno is set for us */
+	}
+
+	dt_free(dtp, dof);
+
+	if (pip != NULL) {
+		bzero(pip, sizeof (dtrace_proginfo_t));
+		pip->dpi_descattr = _dtrace_defattr;
+		pip->dpi_stmtattr = _dtrace_defattr;
+		pip->dpi_matches = n;
+	}
+
+	return (0);
+}
+
 static void
 dt_ecbdesc_hold(dtrace_ecbdesc_t *edp)
 {
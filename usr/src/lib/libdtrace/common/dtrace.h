@@ -130,6 +130,9 @@ extern int dtrace_program_exec(dtrace_hdl_t *, dtrace_prog_t *,
     dtrace_proginfo_t *);
 extern void dtrace_program_info(dtrace_hdl_t *, dtrace_prog_t *,
     dtrace_proginfo_t *);
+extern int dtrace_program_save(dtrace_hdl_t *, dtrace_prog_t *, int);
+extern int dtrace_program_load(dtrace_hdl_t *, int,
+    dtrace_proginfo_t *);
 
 #define	DTRACE_D_STRIP	0x01	/* strip non-loadable sections from program */
 #define	DTRACE_D_PROBES	0x02	/* include provider and probe definitions */
@@ -37,6 +37,7 @@
 #include <fcntl.h>
 #include <errno.h>
 #include <poll.h>
+#include <sys/sysmacros.h>
 #include "kstat.h"
 
 /*LINTLIBRARY*/
@@ -166,6 +167,104 @@ kstat_read(kstat_ctl_t *kc, kstat_t *ksp, void *data)
 	return (kcid);
 }
 
+/*
+ * Read every kstat matching 'module' and 'class' (NULL or an empty string
+ * matches anything) and invoke 'func' on each, stopping early if 'func'
+ * returns nonzero.  The kstats handed to 'func' live in a single buffer
+ * filled by one KSTAT_IOC_READ_BULK ioctl -- they are snapshots, not
+ * entries of kc->kc_chain -- and are only valid for the duration of the
+ * callback.  If the kernel does not support bulk reads (or this is a
+ * 32-bit consumer), fall back to reading matching chain entries one at a
+ * time.  Returns the number of kstats processed, or -1 on error.
+ */
+static int
+kstat_read_bulk_slow(kstat_ctl_t *kc, const char *module, const char *class,
+    int (*func)(kstat_t *, void *), void *arg)
+{
+	kstat_t *ksp;
+	int count = 0;
+
+	for (ksp = kc->kc_chain; ksp != NULL; ksp = ksp->ks_next) {
+		if ((module != NULL && module[0] != '\0' &&
+		    strcmp(module, ksp->ks_module) != 0) ||
+		    (class != NULL && class[0] != '\0' &&
+		    strcmp(class, ksp->ks_class) != 0))
+			continue;
+		if (kstat_read(kc, ksp, NULL) == -1)
+			continue;
+		count++;
+		if (func(ksp, arg) != 0)
+			break;
+	}
+	return (count);
+}
+
+int
+kstat_read_bulk(kstat_ctl_t *kc, const char *module, const char *class,
+    int (*func)(kstat_t *, void *), void *arg)
+{
+#ifdef _LP64
+	kstat_bulk_t kb;
+	char *buf;
+	uint64_t i, off;
+	size_t bufsize = 4 * 1024 * 1024;
+	int count = 0;
+
+	(void) memset(&kb, 0, sizeof (kb));
+	if (module != NULL)
+		(void) strlcpy(kb.kb_module, module, KSTAT_STRLEN);
+	if (class != NULL)
+		(void) strlcpy(kb.kb_class, class, KSTAT_STRLEN);
+
+	for (;;) {
+		if ((buf = malloc(bufsize)) == NULL)
+			return (-1);
+
+		kb.kb_buf = (uintptr_t)buf;
+		kb.kb_bufsize = bufsize;
+
+		if (ioctl(kc->kc_kd, KSTAT_IOC_READ_BULK, &kb) != -1)
+			break;
+
+		free(buf);
+
+		if (errno == ENOMEM && kb.kb_bufsize > bufsize) {
+			/*
+			 * Too small; retry with the size the kernel asked
+			 * for, plus headroom for kstats that grow between
+			 * the sizing pass and the retry.
+			 */
+			bufsize = kb.kb_bufsize + (kb.kb_bufsize >> 2);
+			continue;
+		}
+
+		if (errno == ENOTSUP || errno == EINVAL) {
+			return (kstat_read_bulk_slow(kc, module, class,
+			    func, arg));
+		}
+
+		return (-1);
+	}
+
+	for (i = 0, off = 0; i < kb.kb_count; i++) {
+		/* LINTED - alignment */
+		kstat_t *ksp = (kstat_t *)(buf + off);
+
+		count++;
+		if (func(ksp, arg) != 0)
+			break;
+
+		off += P2ROUNDUP(sizeof (kstat_t) + ksp->ks_data_size,
+		    KSTAT_BULK_ALIGN);
+	}
+
+	free(buf);
+	return (count);
+#else
+	return (kstat_read_bulk_slow(kc, module, class, func, arg));
+#endif
+}
+
 kid_t
 kstat_write(kstat_ctl_t *kc, kstat_t *ksp, void *data)
 {
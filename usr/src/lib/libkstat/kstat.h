@@ -47,6 +47,8 @@ typedef struct kstat_ctl {
 extern	kstat_ctl_t	*kstat_open(void);
 extern	int		kstat_close(kstat_ctl_t *);
 extern	kid_t		kstat_read(kstat_ctl_t *, kstat_t *, void *);
+extern	int		kstat_read_bulk(kstat_ctl_t *, const char *,
+    const char *, int (*)(kstat_t *, void *), void *);
 extern	kid_t		kstat_write(kstat_ctl_t *, kstat_t *, void *);
 extern	kid_t		kstat_chain_update(kstat_ctl_t *);
 extern	kstat_t		*kstat_lookup(kstat_ctl_t *, const char *, int,
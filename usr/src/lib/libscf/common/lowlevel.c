@@ -105,6 +105,8 @@ static char index32[128] = {
 #define	assert_nolint(x) assert(x)
 #endif
 
+static void datael_invalidate_contents(scf_datael_t *dp);
+static void scf_contents_rele(scf_pg_contents_t **cpp);
 static void scf_iter_reset_locked(scf_iter_t *iter);
 static void scf_value_reset_locked(scf_value_t *val, int and_destroy);
 
@@ -1052,6 +1054,7 @@ datael_attach(scf_datael_t *dp)
 	assert(MUTEX_HELD(&h->rh_lock));
 
 	dp->rd_reset = 0;		/* setup implicitly resets */
+	datael_invalidate_contents(dp);
 
 	if (h->rh_flags & HANDLE_DEAD)
 		return (scf_set_error(SCF_ERROR_HANDLE_DESTROYED));
@@ -1094,6 +1097,11 @@ iter_attach(scf_iter_t *iter)
 
 	assert(MUTEX_HELD(&h->rh_lock));
 
+	/* setup implicitly resets; don't serve stale cached records */
+	scf_contents_rele(&iter->iter_contents);
+	iter->iter_record = NULL;
+	iter->iter_coffset = 0;
+
 	if (h->rh_flags & HANDLE_DEAD)
 		return (scf_set_error(SCF_ERROR_HANDLE_DESTROYED));
 
@@ -1582,6 +1590,7 @@ datael_destroy(scf_datael_t *dp)
 	rep_protocol_response_t response;
 
 	(void) pthread_mutex_lock(&h->rh_lock);
+	datael_invalidate_contents(dp);
 	uu_list_remove(h->rh_dataels, dp);
 	--h->rh_extrefs;
 
@@ -1631,6 +1640,7 @@ datael_reset_locked(scf_datael_t *dp)
 {
 	assert(MUTEX_HELD(&dp->rd_handle->rh_lock));
 	dp->rd_reset = 1;
+	datael_invalidate_contents(dp);
 }
 
 static void
@@ -1640,6 +1650,7 @@ datael_reset(scf_datael_t *dp)
 
 	(void) pthread_mutex_lock(&h->rh_lock);
 	dp->rd_reset = 1;
+	datael_invalidate_contents(dp);
 	(void) pthread_mutex_unlock(&h->rh_lock);
 }
 
@@ -1652,6 +1663,242 @@ datael_finish_reset(const scf_datael_t *dp_arg)
 		datael_do_reset_locked(dp);
 }
 
+/*
+ * Cached property group contents
+ *
+ * PROPERTYGRP_GET_ALL returns every property of a property group in a
+ * single door call, encoded as a sequence of TX_ENTRY_NEW transaction
+ * commands.  We hang the result off of the property group which fetched
+ * it, and serve property types, names, and values out of it instead of
+ * making a door call apiece.
+ *
+ * No generation numbers are needed to keep the cache coherent.  The
+ * server never modifies an object a client entity references -- changes
+ * create a new object and re-point the entity -- so a fetched blob
+ * describes our entity's object until the entity itself is pointed
+ * somewhere else.  datael_invalidate_contents() is therefore called at
+ * every point where an entity can change what it references.
+ *
+ * Composed, read-protected, and oversized property groups fail the
+ * fetch; we note the failure (to avoid repeating it) and fall back to
+ * the traditional one-call-per-datum protocol.
+ */
+static void
+scf_contents_hold(scf_pg_contents_t *c)
+{
+	c->c_refs++;
+}
+
+static void
+scf_contents_rele(scf_pg_contents_t **cpp)
+{
+	scf_pg_contents_t *c = *cpp;
+
+	*cpp = NULL;
+	if (c != NULL && --c->c_refs == 0)
+		uu_free(c);
+}
+
+static void
+datael_invalidate_contents(scf_datael_t *dp)
+{
+	scf_propertygroup_t *pg;
+	scf_property_t *prop;
+
+	assert(MUTEX_HELD(&dp->rd_handle->rh_lock));
+
+	if (dp->rd_type == REP_PROTOCOL_ENTITY_PROPERTYGRP) {
+		pg = (scf_propertygroup_t *)dp;
+		scf_contents_rele(&pg->rd_contents);
+		pg->rd_contents_failed = 0;
+	} else if (dp->rd_type == REP_PROTOCOL_ENTITY_PROPERTY) {
+		prop = (scf_property_t *)dp;
+		scf_contents_rele(&prop->rd_contents);
+		prop->rd_cached = NULL;
+	}
+}
+
+/*
+ * Checks that a PROPERTYGRP_GET_ALL response is a well-formed sequence
+ * of TX_ENTRY_NEW commands with NUL-terminated names and values, so that
+ * the accessors which later walk the blob cannot escape it.  Returns 0
+ * on success, -1 on failure.
+ */
+static int
+scf_contents_validate(const uint8_t *data, size_t size)
+{
+	const struct rep_protocol_transaction_cmd *cmd;
+	size_t off, sz, payload, nlen, voff, vlen;
+
+	/*
+	 * Note that TX_SIZE() must only be applied to size_t values; the
+	 * uint32_t structure fields are copied out first.
+	 */
+	for (off = 0; off < size; off += TX_SIZE(sz)) {
+		if (size - off < REP_PROTOCOL_TRANSACTION_CMD_MIN_SIZE)
+			return (-1);
+		/* LINTED alignment */
+		cmd = (const struct rep_protocol_transaction_cmd *)(data + off);
+		sz = cmd->rptc_size;
+		if (sz < REP_PROTOCOL_TRANSACTION_CMD_MIN_SIZE ||
+		    sz > size - off || TX_SIZE(sz) > size - off)
+			return (-1);
+		if (cmd->rptc_action != REP_PROTOCOL_TX_ENTRY_NEW)
+			return (-1);
+
+		payload = sz - REP_PROTOCOL_TRANSACTION_CMD_MIN_SIZE;
+		nlen = cmd->rptc_name_len;
+		if (nlen == 0 || nlen > payload ||
+		    cmd->rptc_data[nlen - 1] != 0)
+			return (-1);
+
+		for (voff = TX_SIZE(nlen); voff < payload;
+		    voff += TX_SIZE(sizeof (uint32_t) + vlen)) {
+			if (payload - voff < sizeof (uint32_t))
+				return (-1);
+			/* LINTED alignment */
+			vlen = *(uint32_t *)&cmd->rptc_data[voff];
+			if (vlen == 0 ||
+			    vlen > payload - voff - sizeof (uint32_t) ||
+			    cmd->rptc_data[voff + sizeof (uint32_t) +
+			    vlen - 1] != 0)
+				return (-1);
+		}
+	}
+	return (0);
+}
+
+/*
+ * Walks the records of a cached blob; *offp starts at 0 and should not
+ * be touched between calls.  Returns NULL when the records are
+ * exhausted.
+ */
+static const struct rep_protocol_transaction_cmd *
+scf_contents_next_record(const scf_pg_contents_t *c, size_t *offp)
+{
+	const struct rep_protocol_transaction_cmd *cmd;
+	size_t sz;
+
+	if (*offp >= c->c_size)
+		return (NULL);
+	/* LINTED alignment */
+	cmd = (const struct rep_protocol_transaction_cmd *)
+	    (c->c_data + *offp);
+	sz = cmd->rptc_size;
+	*offp += TX_SIZE(sz);
+	return (cmd);
+}
+
+static const struct rep_protocol_transaction_cmd *
+scf_contents_find_record(const scf_pg_contents_t *c, const char *name)
+{
+	const struct rep_protocol_transaction_cmd *cmd;
+	size_t off = 0;
+
+	while ((cmd = scf_contents_next_record(c, &off)) != NULL) {
+		if (strcmp((const char *)cmd->rptc_data, name) == 0)
+			return (cmd);
+	}
+	return (NULL);
+}
+
+/*
+ * Walks the encoded values of a cached record; *offp starts at 0 and
+ * should not be touched between calls.  Returns NULL when the values
+ * are exhausted.
+ */
+static const char *
+scf_record_next_value(const struct rep_protocol_transaction_cmd *cmd,
+    size_t *offp)
+{
+	size_t payload = cmd->rptc_size -
+	    REP_PROTOCOL_TRANSACTION_CMD_MIN_SIZE;
+	size_t nlen = cmd->rptc_name_len;
+	size_t voff;
+	uint32_t vlen;
+
+	if (*offp == 0)
+		*offp = TX_SIZE(nlen);
+	voff = *offp;
+	if (voff >= payload)
+		return (NULL);
+	/* LINTED alignment */
+	vlen = *(uint32_t *)&cmd->rptc_data[voff];
+	*offp = voff + TX_SIZE(sizeof (uint32_t) + vlen);
+	return ((const char *)&cmd->rptc_data[voff + sizeof (uint32_t)]);
+}
+
+/*
+ * Fills in a value from its encoded (string) form, the same way
+ * scf_iter_next_value() does from a value response.
+ */
+static void
+scf_value_set_cached(scf_value_t *v, rep_protocol_value_type_t type,
+    const char *str)
+{
+	v->value_type = type;
+	if (type != REP_PROTOCOL_TYPE_OPAQUE) {
+		(void) strlcpy(v->value_value, str, sizeof (v->value_value));
+	} else {
+		v->value_size = scf_opaque_decode(v->value_value, str,
+		    sizeof (v->value_value));
+	}
+}
+
+/*
+ * Returns the cached contents of pg, fetching them from the server if we
+ * do not already have them.  Returns NULL (with no error set) if the
+ * contents cannot be fetched; the caller simply proceeds without the
+ * cache.
+ */
+static scf_pg_contents_t *
+datael_fetch_contents_locked(scf_propertygroup_t *pg)
+{
+	scf_handle_t *h = pg->rd_d.rd_handle;
+
+	struct rep_protocol_propertygrp_request request;
+	struct rep_protocol_contents_response response;
+	scf_pg_contents_t *c;
+	ssize_t r;
+
+	assert(MUTEX_HELD(&h->rh_lock));
+
+	if (pg->rd_contents != NULL)
+		return (pg->rd_contents);
+	if (pg->rd_contents_failed)
+		return (NULL);
+
+	request.rpr_request = REP_PROTOCOL_PROPERTYGRP_GET_ALL;
+	request.rpr_entityid = pg->rd_d.rd_entity;
+
+	datael_finish_reset(&pg->rd_d);
+	r = make_door_call(h, &request, sizeof (request),
+	    &response, sizeof (response));
+
+	if (r < (ssize_t)offsetof(struct rep_protocol_contents_response,
+	    rpr_contents) ||
+	    response.rpr_response != REP_PROTOCOL_SUCCESS ||
+	    response.rpr_size > sizeof (response.rpr_contents) ||
+	    (size_t)r < offsetof(struct rep_protocol_contents_response,
+	    rpr_contents[response.rpr_size]) ||
+	    scf_contents_validate(response.rpr_contents,
+	    response.rpr_size) != 0) {
+		pg->rd_contents_failed = 1;
+		return (NULL);
+	}
+
+	c = uu_zalloc(offsetof(scf_pg_contents_t,
+	    c_data[response.rpr_size]));
+	if (c == NULL)
+		return (NULL);		/* we can try again later */
+
+	c->c_refs = 1;
+	c->c_size = response.rpr_size;
+	(void) memcpy(c->c_data, response.rpr_contents, response.rpr_size);
+	pg->rd_contents = c;
+	return (c);
+}
+
 /*
  * Fails with _NOT_BOUND, _CONNECTION_BROKEN, _INTERNAL (server response too
  * big, bad entity id, request not applicable to entity, name too long for
@@ -1715,6 +1962,7 @@ datael_get_parent(const scf_datael_t *dp, scf_datael_t *pp)
 
 	datael_finish_reset(dp);
 	datael_finish_reset(pp);
+	datael_invalidate_contents(pp);
 	r = make_door_call(h, &request, sizeof (request),
 	    &response, sizeof (response));
 	(void) pthread_mutex_unlock(&h->rh_lock);
@@ -1775,6 +2023,7 @@ datael_get_child_composed_locked(const scf_datael_t *dp, const char *name,
 
 	datael_finish_reset(dp);
 	datael_finish_reset(out);
+	datael_invalidate_contents(out);
 
 	/*
 	 * We hold the handle lock across both door calls, so that they
@@ -1853,6 +2102,7 @@ datael_get_child_locked(const scf_datael_t *dp, const char *name,
 
 	datael_finish_reset(dp);
 	datael_finish_reset(out);
+	datael_invalidate_contents(out);
 
 	r = make_door_call(h, &request, sizeof (request),
 	    &response, sizeof (response));
@@ -2078,6 +2328,7 @@ datael_add_pg(const scf_datael_t *dp, const char *name, const char *type,
 
 	datael_finish_reset(dp);
 	datael_finish_reset(cp);
+	datael_invalidate_contents(cp);
 	request.rpr_changeid = handle_next_changeid(h);
 	r = make_door_call(h, &request, sizeof (request),
 	    &response, sizeof (response));
@@ -2201,6 +2452,9 @@ scf_iter_reset_locked(scf_iter_t *iter)
 
 	iter->iter_type = REP_PROTOCOL_ENTITY_NONE;
 	iter->iter_sequence = 1;
+	scf_contents_rele(&iter->iter_contents);
+	iter->iter_record = NULL;
+	iter->iter_coffset = 0;
 }
 
 void
@@ -2231,6 +2485,7 @@ scf_iter_destroy(scf_iter_t *iter)
 	(void) make_door_call(handle, &request, sizeof (request),
 	    &response, sizeof (response));
 
+	scf_contents_rele(&iter->iter_contents);
 	uu_list_remove(handle->rh_iters, iter);
 	--handle->rh_extrefs;
 	handle_unrefed(handle);			/* drops h->rh_lock */
@@ -2350,8 +2605,8 @@ scf_handle_get_scope(scf_handle_t *h, const char *name, scf_scope_t *out)
 }
 
 static int
-datael_setup_iter(scf_iter_t *iter, const scf_datael_t *dp, uint32_t res_type,
-    boolean_t composed)
+datael_setup_iter_locked(scf_iter_t *iter, const scf_datael_t *dp,
+    uint32_t res_type, boolean_t composed)
 {
 	scf_handle_t *h = dp->rd_handle;
 
@@ -2360,10 +2615,8 @@ datael_setup_iter(scf_iter_t *iter, const scf_datael_t *dp, uint32_t res_type,
 
 	ssize_t r;
 
-	if (h != iter->iter_handle)
-		return (scf_set_error(SCF_ERROR_HANDLE_MISMATCH));
+	assert(MUTEX_HELD(&h->rh_lock));
 
-	(void) pthread_mutex_lock(&h->rh_lock);
 	scf_iter_reset_locked(iter);
 	iter->iter_type = res_type;
 
@@ -2379,19 +2632,30 @@ datael_setup_iter(scf_iter_t *iter, const scf_datael_t *dp, uint32_t res_type,
 	r = make_door_call(h, &request, sizeof (request),
 	    &response, sizeof (response));
 
-	if (r < 0) {
-		(void) pthread_mutex_unlock(&h->rh_lock);
+	if (r < 0)
 		DOOR_ERRORS_BLOCK(r);
-	}
-	if (response.rpr_response != REP_PROTOCOL_SUCCESS) {
-		(void) pthread_mutex_unlock(&h->rh_lock);
+	if (response.rpr_response != REP_PROTOCOL_SUCCESS)
 		return (scf_set_error(proto_error(response.rpr_response)));
-	}
 	iter->iter_sequence++;
-	(void) pthread_mutex_unlock(&h->rh_lock);
 	return (SCF_SUCCESS);
 }
 
+static int
+datael_setup_iter(scf_iter_t *iter, const scf_datael_t *dp, uint32_t res_type,
+    boolean_t composed)
+{
+	scf_handle_t *h = dp->rd_handle;
+	int ret;
+
+	if (h != iter->iter_handle)
+		return (scf_set_error(SCF_ERROR_HANDLE_MISMATCH));
+
+	(void) pthread_mutex_lock(&h->rh_lock);
+	ret = datael_setup_iter_locked(iter, dp, res_type, composed);
+	(void) pthread_mutex_unlock(&h->rh_lock);
+	return (ret);
+}
+
 static int
 datael_setup_iter_pgtyped(scf_iter_t *iter, const scf_datael_t *dp,
     const char *pgtype, boolean_t composed)
@@ -2442,7 +2706,7 @@ datael_setup_iter_pgtyped(scf_iter_t *iter, const scf_datael_t *dp,
 }
 
 static int
-datael_iter_next(scf_iter_t *iter, scf_datael_t *out)
+datael_iter_next_locked(scf_iter_t *iter, scf_datael_t *out)
 {
 	scf_handle_t *h = iter->iter_handle;
 
@@ -2450,20 +2714,14 @@ datael_iter_next(scf_iter_t *iter, scf_datael_t *out)
 	struct rep_protocol_response response;
 	ssize_t r;
 
-	if (h != out->rd_handle)
-		return (scf_set_error(SCF_ERROR_HANDLE_MISMATCH));
+	assert(MUTEX_HELD(&h->rh_lock));
 
-	(void) pthread_mutex_lock(&h->rh_lock);
 	if (iter->iter_type == REP_PROTOCOL_ENTITY_NONE ||
-	    iter->iter_sequence == 1) {
-		(void) pthread_mutex_unlock(&h->rh_lock);
+	    iter->iter_sequence == 1)
 		return (scf_set_error(SCF_ERROR_NOT_SET));
-	}
 
-	if (out->rd_type != iter->iter_type) {
-		(void) pthread_mutex_unlock(&h->rh_lock);
+	if (out->rd_type != iter->iter_type)
 		return (scf_set_error(SCF_ERROR_INVALID_ARGUMENT));
-	}
 
 	request.rpr_request = REP_PROTOCOL_ITER_READ;
 	request.rpr_iterid = iter->iter_id;
@@ -2471,28 +2729,38 @@ datael_iter_next(scf_iter_t *iter, scf_datael_t *out)
 	request.rpr_entityid = out->rd_entity;
 
 	datael_finish_reset(out);
+	datael_invalidate_contents(out);
 	r = make_door_call(h, &request, sizeof (request),
 	    &response, sizeof (response));
 
-	if (r < 0) {
-		(void) pthread_mutex_unlock(&h->rh_lock);
+	if (r < 0)
 		DOOR_ERRORS_BLOCK(r);
-	}
 
-	if (response.rpr_response == REP_PROTOCOL_DONE) {
-		(void) pthread_mutex_unlock(&h->rh_lock);
+	if (response.rpr_response == REP_PROTOCOL_DONE)
 		return (0);
-	}
-	if (response.rpr_response != REP_PROTOCOL_SUCCESS) {
-		(void) pthread_mutex_unlock(&h->rh_lock);
+	if (response.rpr_response != REP_PROTOCOL_SUCCESS)
 		return (scf_set_error(proto_error(response.rpr_response)));
-	}
 	iter->iter_sequence++;
-	(void) pthread_mutex_unlock(&h->rh_lock);
 
 	return (1);
 }
 
+static int
+datael_iter_next(scf_iter_t *iter, scf_datael_t *out)
+{
+	scf_handle_t *h = iter->iter_handle;
+	int ret;
+
+	if (h != out->rd_handle)
+		return (scf_set_error(SCF_ERROR_HANDLE_MISMATCH));
+
+	(void) pthread_mutex_lock(&h->rh_lock);
+	ret = datael_iter_next_locked(iter, out);
+	(void) pthread_mutex_unlock(&h->rh_lock);
+
+	return (ret);
+}
+
 int
 scf_iter_scope_services(scf_iter_t *iter, const scf_scope_t *s)
 {
@@ -2605,14 +2873,55 @@ scf_iter_next_pg(scf_iter_t *iter, scf_propertygroup_t *out)
 int
 scf_iter_pg_properties(scf_iter_t *iter, const scf_propertygroup_t *pg)
 {
-	return (datael_setup_iter(iter, &pg->rd_d,
-	    REP_PROTOCOL_ENTITY_PROPERTY, 0));
+	scf_handle_t *h = pg->rd_d.rd_handle;
+	int ret;
+
+	if (h != iter->iter_handle)
+		return (scf_set_error(SCF_ERROR_HANDLE_MISMATCH));
+
+	(void) pthread_mutex_lock(&h->rh_lock);
+	ret = datael_setup_iter_locked(iter, &pg->rd_d,
+	    REP_PROTOCOL_ENTITY_PROPERTY, 0);
+
+	/*
+	 * Since we hold the handle lock across the ITER_START and the
+	 * fetch, the iterator and the cached contents describe the same
+	 * (immutable) object, and the cached records line up with the
+	 * entities ITER_READ will hand out.
+	 */
+	if (ret == SCF_SUCCESS) {
+		iter->iter_contents =
+		    datael_fetch_contents_locked((scf_propertygroup_t *)pg);
+		if (iter->iter_contents != NULL) {
+			scf_contents_hold(iter->iter_contents);
+			iter->iter_coffset = 0;
+		}
+	}
+	(void) pthread_mutex_unlock(&h->rh_lock);
+	return (ret);
 }
 
 int
 scf_iter_next_property(scf_iter_t *iter, scf_property_t *out)
 {
-	return (datael_iter_next(iter, &out->rd_d));
+	scf_handle_t *h = iter->iter_handle;
+	int ret;
+
+	if (h != out->rd_d.rd_handle)
+		return (scf_set_error(SCF_ERROR_HANDLE_MISMATCH));
+
+	(void) pthread_mutex_lock(&h->rh_lock);
+	ret = datael_iter_next_locked(iter, &out->rd_d);
+	if (ret == 1 && iter->iter_contents != NULL) {
+		out->rd_cached = scf_contents_next_record(iter->iter_contents,
+		    &iter->iter_coffset);
+		if (out->rd_cached != NULL) {
+			out->rd_contents = iter->iter_contents;
+			scf_contents_hold(out->rd_contents);
+		}
+	}
+	(void) pthread_mutex_unlock(&h->rh_lock);
+	return (ret);
 }
 
 /*
@@ -2884,8 +3193,27 @@ int
 scf_pg_get_property(const scf_propertygroup_t *pg, const char *name,
     scf_property_t *prop)
 {
-	return (datael_get_child(&pg->rd_d, name, REP_PROTOCOL_ENTITY_PROPERTY,
-	    prop ? &prop->rd_d : NULL, 0));
+	scf_handle_t *h = pg->rd_d.rd_handle;
+	scf_pg_contents_t *c;
+	int ret;
+
+	if (prop == NULL)
+		return (datael_get_child(&pg->rd_d, name,
+		    REP_PROTOCOL_ENTITY_PROPERTY, NULL, 0));
+
+	(void) pthread_mutex_lock(&h->rh_lock);
+	ret = datael_get_child_locked(&pg->rd_d, name,
+	    REP_PROTOCOL_ENTITY_PROPERTY, &prop->rd_d);
+	if (ret == 0 && (c = datael_fetch_contents_locked(
+	    (scf_propertygroup_t *)pg)) != NULL) {
+		prop->rd_cached = scf_contents_find_record(c, name);
+		if (prop->rd_cached != NULL) {
+			prop->rd_contents = c;
+			scf_contents_hold(c);
+		}
+	}
+	(void) pthread_mutex_unlock(&h->rh_lock);
+	return (ret);
 }
 
 void
@@ -3224,6 +3552,13 @@ datael_update(scf_datael_t *dp)
 
 	r = make_door_call(h, &request, sizeof (request),
 	    &response, sizeof (response));
+
+	/*
+	 * On _SUCCESS we now reference a different object; any cached
+	 * contents describe the old one.  (_DONE means no change.)
+	 */
+	if (r >= 0 && response.rpr_response == REP_PROTOCOL_SUCCESS)
+		datael_invalidate_contents(dp);
 	(void) pthread_mutex_unlock(&h->rh_lock);
 
 	if (r < 0)
@@ -3369,6 +3704,7 @@ _scf_notify_wait(scf_propertygroup_t *pg, char *out, size_t sz)
 	    &response, sizeof (response), &dummy);
 
 	(void) pthread_mutex_lock(&h->rh_lock);
+	datael_invalidate_contents(&pg->rd_d);
 	assert(h->rh_fd_users > 0);
 	if (--h->rh_fd_users == 0) {
 		(void) pthread_cond_broadcast(&h->rh_cv);
@@ -3587,6 +3923,11 @@ property_type_locked(const scf_property_t *prop,
 
 	assert(MUTEX_HELD(&h->rh_lock));
 
+	if (prop->rd_cached != NULL) {
+		*out = prop->rd_cached->rptc_type;
+		return (SCF_SUCCESS);
+	}
+
 	request.rpr_request = REP_PROTOCOL_PROPERTY_GET_TYPE;
 	request.rpr_entityid = prop->rd_d.rd_entity;
 
@@ -3663,6 +4004,18 @@ scf_is_compatible_type(scf_type_t base_arg, scf_type_t type_arg)
 ssize_t
 scf_property_get_name(const scf_property_t *prop, char *out, size_t len)
 {
+	scf_handle_t *h = prop->rd_d.rd_handle;
+	ssize_t ret;
+
+	(void) pthread_mutex_lock(&h->rh_lock);
+	if (prop->rd_cached != NULL) {
+		ret = strlcpy(out, (const char *)prop->rd_cached->rptc_data,
+		    len);
+		(void) pthread_mutex_unlock(&h->rh_lock);
+		return (ret);
+	}
+	(void) pthread_mutex_unlock(&h->rh_lock);
+
 	return (datael_get_name(&prop->rd_d, out, len, RP_ENTITY_NAME_NAME));
 }
 
@@ -3730,6 +4083,7 @@ scf_transaction_start(scf_transaction_t *tran, scf_propertygroup_t *pg)
 
 	datael_finish_reset(&tran->tran_pg.rd_d);
 	datael_finish_reset(&pg->rd_d);
+	datael_invalidate_contents(&tran->tran_pg.rd_d);
 
 	r = make_door_call(h, &request, sizeof (request),
 	    &response, sizeof (response));
@@ -4998,6 +5352,29 @@ bad:
 int
 scf_iter_property_values(scf_iter_t *iter, const scf_property_t *prop)
 {
+	scf_handle_t *h = prop->rd_d.rd_handle;
+
+	if (h != iter->iter_handle)
+		return (scf_set_error(SCF_ERROR_HANDLE_MISMATCH));
+
+	(void) pthread_mutex_lock(&h->rh_lock);
+	if (prop->rd_cached != NULL) {
+		/*
+		 * Serve the iteration entirely from the cached record; no
+		 * ITER_START is needed, since we will never ITER_READ_VALUE.
+		 */
+		scf_iter_reset_locked(iter);
+		iter->iter_type = REP_PROTOCOL_ENTITY_VALUE;
+		iter->iter_contents = prop->rd_contents;
+		scf_contents_hold(iter->iter_contents);
+		iter->iter_record = prop->rd_cached;
+		iter->iter_coffset = 0;
+		iter->iter_sequence = 2;
+		(void) pthread_mutex_unlock(&h->rh_lock);
+		return (SCF_SUCCESS);
+	}
+	(void) pthread_mutex_unlock(&h->rh_lock);
+
 	return (datael_setup_iter(iter, &prop->rd_d,
 	    REP_PROTOCOL_ENTITY_VALUE, 0));
 }
@@ -5029,6 +5406,21 @@ scf_iter_next_value(scf_iter_t *iter, scf_value_t *v)
 		return (scf_set_error(SCF_ERROR_INVALID_ARGUMENT));
 	}
 
+	if (iter->iter_record != NULL) {
+		const char *str;
+
+		str = scf_record_next_value(iter->iter_record,
+		    &iter->iter_coffset);
+		if (str == NULL) {
+			(void) pthread_mutex_unlock(&h->rh_lock);
+			return (0);
+		}
+		scf_value_set_cached(v, iter->iter_record->rptc_type, str);
+		iter->iter_sequence++;
+		(void) pthread_mutex_unlock(&h->rh_lock);
+		return (1);
+	}
+
 	request.rpr_request = REP_PROTOCOL_ITER_READ_VALUE;
 	request.rpr_iterid = iter->iter_id;
 	request.rpr_sequence = iter->iter_sequence;
@@ -5081,6 +5473,25 @@ scf_property_get_value(const scf_property_t *prop, scf_value_t *v)
 
 	(void) pthread_mutex_lock(&h->rh_lock);
 
+	if (prop->rd_cached != NULL) {
+		const char *str;
+		size_t voff = 0;
+
+		scf_value_reset_locked(v, 0);
+		if ((str = scf_record_next_value(prop->rd_cached,
+		    &voff)) == NULL) {
+			(void) pthread_mutex_unlock(&h->rh_lock);
+			return (scf_set_error(SCF_ERROR_NOT_FOUND));
+		}
+		scf_value_set_cached(v, prop->rd_cached->rptc_type, str);
+		if (scf_record_next_value(prop->rd_cached, &voff) != NULL) {
+			(void) pthread_mutex_unlock(&h->rh_lock);
+			return (scf_set_error(SCF_ERROR_CONSTRAINT_VIOLATED));
+		}
+		(void) pthread_mutex_unlock(&h->rh_lock);
+		return (SCF_SUCCESS);
+	}
+
 	request.rpr_request = REP_PROTOCOL_PROPERTY_GET_VALUE;
 	request.rpr_entityid = prop->rd_d.rd_entity;
 
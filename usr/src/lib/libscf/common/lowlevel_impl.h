@@ -141,12 +141,31 @@ struct scf_snaplevel {
 	scf_datael_t	rd_d;
 };
 
+/*
+ * Cached property group contents, decoded from a PROPERTYGRP_GET_ALL
+ * response.  The blob is shared by the property group which fetched it
+ * and by any properties and value iterators handed out while it was
+ * current, and is freed when the last reference is released.  All
+ * references are protected by the owning handle's rh_lock.
+ */
+typedef struct scf_pg_contents {
+	uint32_t	c_refs;
+	size_t		c_size;		/* bytes of c_data in use */
+	/* sequence of TX_SIZE()-aligned rep_protocol_transaction_cmds */
+	uint8_t		c_data[1];
+} scf_pg_contents_t;
+
 struct scf_propertygroup {
 	scf_datael_t	rd_d;
+	scf_pg_contents_t *rd_contents;	/* cached contents, or NULL */
+	uint8_t		rd_contents_failed; /* last fetch attempt failed */
 };
 
 struct scf_property {
 	scf_datael_t	rd_d;
+	scf_pg_contents_t *rd_contents;	/* pinned group contents, or NULL */
+	/* our record in rd_contents */
+	const struct rep_protocol_transaction_cmd *rd_cached;
 };
 
 struct scf_value {
@@ -197,6 +216,15 @@ struct scf_iter {
 	uint32_t	iter_id;
 	uint32_t	iter_sequence;
 	uu_list_node_t	iter_node;
+
+	/*
+	 * When iterating from cached property group contents, the pinned
+	 * blob, the record whose values we are walking (value iterators
+	 * only), and the byte offset of the next record or value.
+	 */
+	scf_pg_contents_t *iter_contents;
+	const struct rep_protocol_transaction_cmd *iter_record;
+	size_t		iter_coffset;
 };
 
 #ifdef	__cplusplus
@@ -57,6 +57,71 @@ typedef struct malloc_data {
 #pragma weak free = umem_malloc_free
 #endif /* !_x86 */
 
+/*
+ * C-side view of the per-thread cache structure that libc keeps for us in
+ * the ulwp_t; the generated assembly (see section 8 of the big theory
+ * statement in umem.c) accesses the same layout by offset.  The drain
+ * generation word lives immediately after the roots; _tmem_get_nentries()
+ * tells us how many there are.
+ */
+typedef struct tmem {
+	uintptr_t	tm_size;	/* total bytes cached */
+	void		*tm_roots[1];	/* really _tmem_get_nentries() */
+} tmem_t;
+
+/*
+ * Drain this thread's per-thread cache if it has gone quiet.  The update
+ * thread advances umem_ptc_gen once per update cycle and we record the
+ * generation we last saw each time we come through the C allocation paths.
+ * If we are two or more generations behind, this thread made no uncached
+ * allocation for at least one whole cycle, so we return everything we have
+ * cached to the depot.  Threads that are busy enough to miss the cache
+ * regularly just refresh their generation and keep their cache.
+ *
+ * We only run in the owning thread, so we do not race with the generated
+ * assembly; as with the assembly itself, an async signal handler that
+ * calls malloc() mid-update is not supported (malloc() is not
+ * async-signal-safe).
+ */
+static void
+umem_ptc_drain(void)
+{
+	tmem_t *tp;
+	uint_t gen, *genp;
+	int i, nents;
+	void *buf, *next;
+
+	if (!umem_ptc_enabled)
+		return;
+
+	if ((tp = _tmem_get_current()) == NULL)
+		return;
+
+	nents = _tmem_get_nentries();
+	genp = (uint_t *)&tp->tm_roots[nents];
+
+	gen = umem_ptc_gen;
+	if (gen - *genp < 2) {
+		*genp = gen;
+		return;
+	}
+	*genp = gen;
+
+	if (tp->tm_size == 0)
+		return;
+
+	for (i = 0; i < nents; i++) {
+		buf = tp->tm_roots[i];
+		tp->tm_roots[i] = NULL;
+		while (buf != NULL) {
+			next = *(void **)buf;
+			umem_cache_tmem_cleanup(buf, i);
+			buf = next;
+		}
+	}
+	tp->tm_size = 0;
+}
+
 void *
 umem_malloc(size_t size_arg)
 {
@@ -66,6 +131,9 @@ umem_malloc(size_t size_arg)
 	size_t size;
 
 	malloc_data_t *ret;
+
+	umem_ptc_drain();
+
 	size = size_arg + sizeof (malloc_data_t);
 
 #ifdef _LP64
@@ -378,6 +446,8 @@ process_memalign:
 void
 umem_malloc_free(void *buf)
 {
+	umem_ptc_drain();
+
 	if (buf == NULL)
 		return;
 
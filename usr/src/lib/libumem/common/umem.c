@@ -708,6 +708,16 @@ size_t umem_maxverify;		/* maximum bytes to inspect in debug routines */
 size_t umem_minfirewall;	/* hardware-enforced redzone threshold */
 size_t umem_ptc_size = 1048576;	/* size of per-thread cache (in bytes) */
 
+/*
+ * Per-thread cache drain generation.  The update thread advances this once
+ * per update cycle; a thread that enters the C allocation paths and finds
+ * that it has missed a whole cycle (its recorded generation is two or more
+ * behind) drains its per-thread cache back to the depot.  This keeps
+ * threads that have gone quiet in long-lived daemons from stranding up to
+ * umem_ptc_size bytes each indefinitely.  See umem_ptc_drain() in malloc.c.
+ */
+volatile uint_t umem_ptc_gen;
+
 uint_t umem_flags = 0;
 uintptr_t umem_tmem_off;
 
@@ -3091,7 +3101,7 @@ umem_alloc_sizes_remove(size_t size)
  * this refers to first n umem_caches which makes this a pretty simple indexing
  * job.
  */
-static void
+void
 umem_cache_tmem_cleanup(void *buf, int entry)
 {
 	size_t size;
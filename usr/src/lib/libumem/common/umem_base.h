@@ -101,6 +101,10 @@ extern size_t umem_lite_maxalign;
 extern size_t umem_maxverify;
 extern size_t umem_minfirewall;
 extern size_t umem_ptc_size;
+extern int umem_ptc_enabled;
+extern volatile uint_t umem_ptc_gen;
+
+extern void umem_cache_tmem_cleanup(void *, int);
 
 extern uint32_t umem_flags;
 
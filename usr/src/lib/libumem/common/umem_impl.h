@@ -406,6 +406,7 @@ extern int umem_add(caddr_t, size_t);
  * Private interface with libc for tcumem.
  */
 extern uintptr_t _tmem_get_base(void);
+extern void *_tmem_get_current(void);
 extern int _tmem_get_nentries(void);
 extern void _tmem_set_cleanup(void(*)(void *, int));
 
@@ -83,6 +83,14 @@ umem_update_thread(void *arg)
 			 */
 			(void) mutex_unlock(&umem_update_lock);
 
+			/*
+			 * Advance the per-thread cache drain generation;
+			 * threads that miss a whole cycle will drain their
+			 * caches on their next uncached allocation (see
+			 * umem_ptc_drain()).
+			 */
+			umem_ptc_gen++;
+
 			vmem_update(NULL);
 			/*
 			 * umem_cache_update can use umem_add_update to
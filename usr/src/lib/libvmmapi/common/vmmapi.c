@@ -373,6 +373,25 @@ vm_munmap_memseg(struct vmctx *ctx, vm_paddr_t gpa, size_t len)
 	return (error);
 }
 
+#ifndef	__FreeBSD__
+/*
+ * Pre-populate the nested page tables for [gpa, gpa + len), saving the guest
+ * from taking demand faults when it first touches that memory.
+ */
+int
+vm_populate_memseg(struct vmctx *ctx, vm_paddr_t gpa, size_t len)
+{
+	struct vm_populate populate;
+	int error;
+
+	populate.gpa = gpa;
+	populate.len = len;
+
+	error = ioctl(ctx->fd, VM_POPULATE_MEMSEG, &populate);
+	return (error);
+}
+#endif
+
 int
 vm_mmap_getnext(struct vmctx *ctx, vm_paddr_t *gpa, int *segid,
     vm_ooffset_t *segoff, size_t *len, int *prot, int *flags)
@@ -138,6 +138,9 @@ int	vm_mmap_memseg(struct vmctx *ctx, vm_paddr_t gpa, int segid,
 	    vm_ooffset_t segoff, size_t len, int prot);
 
 int	vm_munmap_memseg(struct vmctx *ctx, vm_paddr_t gpa, size_t len);
+#ifndef	__FreeBSD__
+int	vm_populate_memseg(struct vmctx *ctx, vm_paddr_t gpa, size_t len);
+#endif
 
 #ifndef __FreeBSD__
 int	vm_create(const char *name, uint64_t flags);
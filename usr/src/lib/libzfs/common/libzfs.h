@@ -405,6 +405,7 @@ extern zpool_status_t zpool_import_status(nvlist_t *, char **,
 extern nvlist_t *zpool_get_config(zpool_handle_t *, nvlist_t **);
 extern nvlist_t *zpool_get_features(zpool_handle_t *);
 extern int zpool_refresh_stats(zpool_handle_t *, boolean_t *);
+extern int zpool_refresh_vdev_stats(zpool_handle_t *, boolean_t *);
 extern int zpool_get_errlog(zpool_handle_t *, nvlist_t **);
 extern boolean_t zpool_is_bootable(zpool_handle_t *);
 
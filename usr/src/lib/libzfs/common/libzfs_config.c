@@ -43,6 +43,7 @@
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <stddef.h>
+#include <stdio.h>
 #include <string.h>
 #include <unistd.h>
 #include <libintl.h>
@@ -326,6 +327,152 @@ zpool_refresh_stats(zpool_handle_t *zhp, boolean_t *missing)
 	return (0);
 }
 
+/*
+ * Graft the per-vdev stats nvlists returned by ZFS_IOC_POOL_VDEV_STATS
+ * onto a parsed config.  The stats nvlist maps vdev guids (as decimal
+ * strings) to nvlists holding the same stats pairs the config itself
+ * carries, so splicing is just replacing those pairs in each vdev's
+ * nvlist.  Returns -1 if any vdev in the config has no matching stats,
+ * in which case the caller should fall back to a full refresh.
+ */
+static int
+zpool_splice_vdev_stats(nvlist_t *nv, nvlist_t *stats)
+{
+	uint64_t guid;
+	char guidbuf[32];
+	nvlist_t *vstats, **child;
+	nvpair_t *elem;
+	uint_t c, children;
+
+	if (nvlist_lookup_uint64(nv, ZPOOL_CONFIG_GUID, &guid) != 0)
+		return (-1);
+	(void) snprintf(guidbuf, sizeof (guidbuf), "%llu",
+	    (u_longlong_t)guid);
+	if (nvlist_lookup_nvlist(stats, guidbuf, &vstats) != 0)
+		return (-1);
+
+	for (elem = nvlist_next_nvpair(vstats, NULL); elem != NULL;
+	    elem = nvlist_next_nvpair(vstats, elem)) {
+		if (nvlist_add_nvpair(nv, elem) != 0)
+			return (-1);
+	}
+
+	if (nvlist_lookup_nvlist_array(nv, ZPOOL_CONFIG_CHILDREN,
+	    &child, &children) == 0) {
+		for (c = 0; c < children; c++) {
+			if (zpool_splice_vdev_stats(child[c], stats) != 0)
+				return (-1);
+		}
+	}
+
+	if (nvlist_lookup_nvlist_array(nv, ZPOOL_CONFIG_L2CACHE,
+	    &child, &children) == 0) {
+		for (c = 0; c < children; c++) {
+			if (zpool_splice_vdev_stats(child[c], stats) != 0)
+				return (-1);
+		}
+	}
+
+	if (nvlist_lookup_nvlist_array(nv, ZPOOL_CONFIG_SPARES,
+	    &child, &children) == 0) {
+		for (c = 0; c < children; c++) {
+			if (zpool_splice_vdev_stats(child[c], stats) != 0)
+				return (-1);
+		}
+	}
+
+	return (0);
+}
+
+/*
+ * Lighter-weight variant of zpool_refresh_stats() for callers that only
+ * consume per-vdev statistics, such as zpool iostat between intervals.
+ * As long as the pool configuration hasn't changed (tracked via a config
+ * generation number), only the vdev stats cross the kernel boundary and
+ * they are spliced into a copy of the cached parsed config, avoiding the
+ * regeneration and reparse of the entire config nvlist per interval.
+ * Any surprise -- changed config, unknown ioctl, unmatched vdev --
+ * falls back to zpool_refresh_stats().  Note that pool-level non-vdev
+ * state in the config (e.g. scan progress) is not refreshed here.
+ */
+int
+zpool_refresh_vdev_stats(zpool_handle_t *zhp, boolean_t *missing)
+{
+	zfs_cmd_t zc = { 0 };
+	libzfs_handle_t *hdl = zhp->zpool_hdl;
+	nvlist_t *stats, *config, *nvroot;
+	int error;
+
+	*missing = B_FALSE;
+
+	/*
+	 * Without a cached config there is nothing to splice into.
+	 */
+	if (zhp->zpool_config == NULL)
+		return (zpool_refresh_stats(zhp, missing));
+
+	(void) strcpy(zc.zc_name, zhp->zpool_name);
+	zc.zc_cookie = zhp->zpool_config_gen;
+
+	if (zcmd_alloc_dst_nvlist(hdl, &zc, 0) != 0)
+		return (-1);
+
+	for (;;) {
+		if (ioctl(hdl->libzfs_fd, ZFS_IOC_POOL_VDEV_STATS,
+		    &zc) == 0)
+			break;
+
+		if (errno == ENOMEM) {
+			if (zcmd_expand_dst_nvlist(hdl, &zc) != 0) {
+				zcmd_free_nvlists(&zc);
+				return (-1);
+			}
+		} else {
+			/*
+			 * ESTALE tells us the config has changed and what
+			 * the current generation is; remember it so the
+			 * next interval can use the fast path again.  Any
+			 * other error (including an older kernel that
+			 * lacks the ioctl) just means we take the full
+			 * refresh path.
+			 */
+			zhp->zpool_config_gen =
+			    (errno == ESTALE) ? zc.zc_cookie : 0;
+			zcmd_free_nvlists(&zc);
+			return (zpool_refresh_stats(zhp, missing));
+		}
+	}
+
+	error = zcmd_read_dst_nvlist(hdl, &zc, &stats);
+	zcmd_free_nvlists(&zc);
+	if (error != 0)
+		return (-1);
+
+	/*
+	 * Splice the stats into a duplicate of the cached config so that
+	 * the previous interval's numbers survive in zpool_old_config for
+	 * delta computation.
+	 */
+	if (nvlist_dup(zhp->zpool_config, &config, 0) != 0) {
+		nvlist_free(stats);
+		return (no_memory(hdl));
+	}
+
+	if (nvlist_lookup_nvlist(config, ZPOOL_CONFIG_VDEV_TREE,
+	    &nvroot) != 0 || zpool_splice_vdev_stats(nvroot, stats) != 0) {
+		nvlist_free(config);
+		nvlist_free(stats);
+		return (zpool_refresh_stats(zhp, missing));
+	}
+	nvlist_free(stats);
+
+	nvlist_free(zhp->zpool_old_config);
+	zhp->zpool_old_config = zhp->zpool_config;
+	zhp->zpool_config = config;
+
+	return (0);
+}
+
 /*
  * The following environment variables are undocumented
  * and should be used for testing purposes only:
@@ -292,9 +292,11 @@ zpool_handle(zfs_handle_t *zhp)
 	pool_name = zfs_alloc(zhp->zfs_hdl, len);
 	(void) strlcpy(pool_name, zhp->zfs_name, len);
 
+	mutex_enter(&zhp->zfs_hdl->libzfs_pool_handles_lock);
 	zph = zpool_find_handle(zhp, pool_name, len);
 	if (zph == NULL)
 		zph = zpool_add_handle(zhp, pool_name);
+	mutex_exit(&zhp->zfs_hdl->libzfs_pool_handles_lock);
 
 	free(pool_name);
 	return (zph);
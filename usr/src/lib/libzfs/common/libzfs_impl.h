@@ -67,6 +67,11 @@ struct libzfs_handle {
 	FILE *libzfs_mnttab;
 	FILE *libzfs_sharetab;
 	zpool_handle_t *libzfs_pool_handles;
+	/*
+	 * Protects libzfs_pool_handles so that threads iterating over
+	 * datasets in parallel can create handles concurrently.
+	 */
+	mutex_t libzfs_pool_handles_lock;
 	uu_avl_pool_t *libzfs_ns_avlpool;
 	uu_avl_t *libzfs_ns_avl;
 	uint64_t libzfs_ns_gen;
@@ -125,6 +130,7 @@ struct zpool_handle {
 	size_t zpool_config_size;
 	nvlist_t *zpool_config;
 	nvlist_t *zpool_old_config;
+	uint64_t zpool_config_gen;
 	nvlist_t *zpool_props;
 	diskaddr_t zpool_start_block;
 };
@@ -715,6 +715,8 @@ libzfs_init(void)
 	zpool_prop_init();
 	zpool_feature_init();
 	libzfs_mnttab_init(hdl);
+	(void) mutex_init(&hdl->libzfs_pool_handles_lock,
+	    LOCK_NORMAL | LOCK_ERRORCHECK, NULL);
 
 	if (getenv("ZFS_PROP_DEBUG") != NULL) {
 		hdl->libzfs_prop_debug = B_TRUE;
@@ -749,6 +751,7 @@ libzfs_fini(libzfs_handle_t *hdl)
 		(void) di_devlink_fini(&hdl->libzfs_devlink);
 	zfs_uninit_libshare(hdl);
 	zpool_free_handles(hdl);
+	(void) mutex_destroy(&hdl->libzfs_pool_handles_lock);
 	libzfs_fru_clear(hdl, B_TRUE);
 	namespace_clear(hdl);
 	libzfs_mnttab_fini(hdl);
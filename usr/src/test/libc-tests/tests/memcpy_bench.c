@@ -0,0 +1,193 @@
+/*
+ * This file and its contents are supplied under the terms of the
+ * Common Development and Distribution License ("CDDL"), version 1.0.
+ * You may only use this file in accordance with the terms of version
+ * 1.0 of the CDDL.
+ *
+ * A full copy of the text of the CDDL should have accompanied this
+ * source.  A copy of the CDDL is also available via the Internet at
+ * http://www.illumos.org/license/CDDL.
+ */
+
+/*
+ * Copyright 2026 OmniOS Community Edition (OmniOSce) Association.
+ */
+
+/*
+ * Throughput microbenchmark and correctness check for memcpy(), memmove()
+ * and memset().  The primary purpose is to exercise the size-dispatched
+ * implementations in libc (small unrolled paths, SSE paths, rep movsb/stosb
+ * on processors with ERMS, and the non-temporal paths used above the cache
+ * thresholds) and verify they all produce correct results at and around the
+ * dispatch boundaries.  The bandwidth figures are printed for a human to
+ * eyeball; the exit status only reflects correctness.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <err.h>
+#include <sys/types.h>
+#include <sys/time.h>
+
+/*
+ * Sizes chosen to straddle the libc dispatch points: the unrolled small-copy
+ * cutoffs (128/144 bytes), a typical ERMS threshold (4K), and sizes large
+ * enough to push past last-level-cache based non-temporal thresholds.
+ */
+static const size_t bench_sizes[] = {
+	16, 64, 127, 128, 129, 1024, 4095, 4096, 4097,
+	64 * 1024, 1024 * 1024, 32 * 1024 * 1024
+};
+
+#define	NSIZES		(sizeof (bench_sizes) / sizeof (bench_sizes[0]))
+#define	MAXSIZE		(32 * 1024 * 1024)
+#define	MINLOOPBYTES	(64 * 1024 * 1024)
+
+static int exit_status = EXIT_SUCCESS;
+
+static void
+fill_pattern(uint8_t *buf, size_t len, uint8_t seed)
+{
+	size_t i;
+
+	for (i = 0; i < len; i++)
+		buf[i] = (uint8_t)(seed + i * 7);
+}
+
+static void
+check_pattern(const char *func, const uint8_t *buf, size_t len, uint8_t seed)
+{
+	size_t i;
+
+	for (i = 0; i < len; i++) {
+		if (buf[i] != (uint8_t)(seed + i * 7)) {
+			warnx("%s: mismatch at offset %zu of %zu byte "
+			    "operation", func, i, len);
+			exit_status = EXIT_FAILURE;
+			return;
+		}
+	}
+}
+
+static void
+check_byte(const char *func, const uint8_t *buf, size_t len, uint8_t val)
+{
+	size_t i;
+
+	for (i = 0; i < len; i++) {
+		if (buf[i] != val) {
+			warnx("%s: mismatch at offset %zu of %zu byte "
+			    "operation", func, i, len);
+			exit_status = EXIT_FAILURE;
+			return;
+		}
+	}
+}
+
+/*
+ * Run enough iterations to move at least MINLOOPBYTES so that small sizes
+ * get a measurable amount of work.
+ */
+static size_t
+iterations(size_t size)
+{
+	size_t iters = MINLOOPBYTES / size;
+
+	return (iters > 0 ? iters : 1);
+}
+
+static double
+mbps(size_t size, size_t iters, hrtime_t elapsed)
+{
+	return (((double)size * iters) / ((double)elapsed / NANOSEC) /
+	    (1024.0 * 1024.0));
+}
+
+static void
+bench_memcpy(uint8_t *dst, uint8_t *src, size_t size)
+{
+	size_t i, iters = iterations(size);
+	hrtime_t start;
+
+	fill_pattern(src, size, 0x5a);
+	(void) memset(dst, 0, size);
+
+	start = gethrtime();
+	for (i = 0; i < iters; i++)
+		(void) memcpy(dst, src, size);
+	printf("memcpy  %10zu bytes: %10.1f MB/s\n", size,
+	    mbps(size, iters, gethrtime() - start));
+
+	check_pattern("memcpy", dst, size, 0x5a);
+}
+
+static void
+bench_memmove(uint8_t *dst, uint8_t *src, size_t size)
+{
+	size_t i, iters = iterations(size);
+	hrtime_t start;
+
+	fill_pattern(src, size, 0xa5);
+	(void) memset(dst, 0, size);
+
+	start = gethrtime();
+	for (i = 0; i < iters; i++)
+		(void) memmove(dst, src, size);
+	printf("memmove %10zu bytes: %10.1f MB/s\n", size,
+	    mbps(size, iters, gethrtime() - start));
+
+	check_pattern("memmove", dst, size, 0xa5);
+
+	/*
+	 * Also verify the overlapping case, which takes a different path;
+	 * no timing, just correctness.
+	 */
+	if (size >= 2) {
+		fill_pattern(src, size, 0x33);
+		(void) memmove(src + 1, src, size - 1);
+		check_pattern("memmove (overlap)", src + 1, size - 1, 0x33);
+	}
+}
+
+static void
+bench_memset(uint8_t *dst, size_t size)
+{
+	size_t i, iters = iterations(size);
+	hrtime_t start;
+
+	(void) memset(dst, 0, size);
+
+	start = gethrtime();
+	for (i = 0; i < iters; i++)
+		(void) memset(dst, 0x7e, size);
+	printf("memset  %10zu bytes: %10.1f MB/s\n", size,
+	    mbps(size, iters, gethrtime() - start));
+
+	check_byte("memset", dst, size, 0x7e);
+}
+
+int
+main(void)
+{
+	uint8_t *src, *dst;
+	size_t i;
+
+	src = malloc(MAXSIZE + 1);
+	dst = malloc(MAXSIZE);
+	if (src == NULL || dst == NULL)
+		err(EXIT_FAILURE, "failed to allocate benchmark buffers");
+
+	for (i = 0; i < NSIZES; i++) {
+		bench_memcpy(dst, src, bench_sizes[i]);
+		bench_memmove(dst, src, bench_sizes[i]);
+		bench_memset(dst, bench_sizes[i]);
+	}
+
+	if (exit_status == EXIT_SUCCESS) {
+		printf("All tests passed\n");
+	}
+	free(src);
+	free(dst);
+	return (exit_status);
+}
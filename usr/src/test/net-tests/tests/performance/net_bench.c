@@ -0,0 +1,432 @@
+/*
+ * This file and its contents are supplied under the terms of the
+ * Common Development and Distribution License ("CDDL"), version 1.0.
+ * You may only use this file in accordance with the terms of version
+ * 1.0 of the CDDL.
+ *
+ * A full copy of the text of the CDDL should have accompanied this
+ * source.  A copy of the CDDL is also available via the Internet at
+ * http://www.illumos.org/license/CDDL.
+ */
+
+/*
+ * Network stack benchmark driver.  The process hosts both ends of each
+ * workload: server threads bind to the address given with -a (loopback
+ * by default, or a simnet/vnic address supplied by net_perf(1)), and
+ * client threads drive traffic at it until the deadline expires.  Since
+ * both ends run on the same machine every byte traverses the full
+ * stack twice, so the numbers track the cost of the stack itself rather
+ * than of any particular piece of hardware.
+ *
+ * Four workloads are provided, chosen with -t:
+ *
+ *	stream	bulk TCP transfer over -n connections; ops are bytes,
+ *		so ops_per_sec is goodput in bytes per second.
+ *	rr	single-byte TCP request/response on one connection;
+ *		round trips per second and p99 round-trip latency, which
+ *		exercises the squeue wakeup path on both ends.
+ *	conn	-n threads cycling connect/close against one listener;
+ *		connections per second, which scales with conn_t hash
+ *		insertion, lookup and teardown in ipcl.
+ *	udp	-n threads blasting 64-byte datagrams; sends per second,
+ *		the small-packet rate through the UDP squeue path.
+ *
+ * Each workload ends by emitting the same machine-readable result line
+ * the perf-tests suite uses:
+ *
+ *	bench=<name> ops=<n> ns=<elapsed> ops_per_sec=<rate> p99_ns=<lat>
+ */
+
+#include <sys/types.h>
+#include <sys/time.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <poll.h>
+#include <thread.h>
+#include <synch.h>
+#include <err.h>
+
+#define	NB_MAX_THREADS	64
+#define	NB_SAMPLE_CAP	500000
+#define	NB_STREAM_BUF	65536
+#define	NB_UDP_SIZE	64
+
+static struct sockaddr_in nb_addr;
+static hrtime_t nb_deadline;
+static int nb_nthreads = 4;
+static int nb_duration = 10;
+
+static uint64_t nb_ops[NB_MAX_THREADS];
+static hrtime_t *nb_samples;
+static size_t nb_nsamples;
+
+/*
+ * Record a latency sample; only thread 0 calls this, so no locking is
+ * needed.  Samples beyond the cap still count toward throughput via
+ * nb_ops but are excluded from the percentile.
+ */
+static void
+nb_sample(hrtime_t delta)
+{
+	if (nb_nsamples < NB_SAMPLE_CAP)
+		nb_samples[nb_nsamples++] = delta;
+}
+
+static int
+nb_cmp(const void *l, const void *r)
+{
+	hrtime_t lhs = *(const hrtime_t *)l;
+	hrtime_t rhs = *(const hrtime_t *)r;
+
+	if (lhs < rhs)
+		return (-1);
+	return (lhs > rhs);
+}
+
+static void
+nb_report(const char *name, hrtime_t elapsed)
+{
+	hrtime_t p99 = 0;
+	uint64_t total = 0;
+	double rate = 0.0;
+	int i;
+
+	for (i = 0; i < nb_nthreads; i++)
+		total += nb_ops[i];
+
+	if (nb_nsamples > 0) {
+		size_t idx = (nb_nsamples * 99) / 100;
+
+		qsort(nb_samples, nb_nsamples, sizeof (hrtime_t), nb_cmp);
+		if (idx >= nb_nsamples)
+			idx = nb_nsamples - 1;
+		p99 = nb_samples[idx];
+	}
+	if (elapsed > 0)
+		rate = (double)total * NANOSEC / (double)elapsed;
+
+	(void) printf("bench=%s ops=%llu ns=%lld ops_per_sec=%.0f "
+	    "p99_ns=%lld\n", name, (u_longlong_t)total, (longlong_t)elapsed,
+	    rate, (longlong_t)p99);
+}
+
+static int
+nb_listen(void)
+{
+	int fd, on = 1;
+
+	fd = socket(AF_INET, SOCK_STREAM, 0);
+	if (fd == -1)
+		err(EXIT_FAILURE, "failed to create listen socket");
+	if (setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof (on)) != 0)
+		err(EXIT_FAILURE, "failed to set SO_REUSEADDR");
+	if (bind(fd, (struct sockaddr *)&nb_addr, sizeof (nb_addr)) != 0)
+		err(EXIT_FAILURE, "failed to bind");
+	if (listen(fd, 1024) != 0)
+		err(EXIT_FAILURE, "failed to listen");
+	return (fd);
+}
+
+static int
+nb_connect(void)
+{
+	int fd;
+
+	fd = socket(AF_INET, SOCK_STREAM, 0);
+	if (fd == -1)
+		err(EXIT_FAILURE, "failed to create socket");
+	if (connect(fd, (struct sockaddr *)&nb_addr, sizeof (nb_addr)) != 0)
+		err(EXIT_FAILURE, "failed to connect");
+	return (fd);
+}
+
+/*
+ * stream: the server drains each accepted connection in its own thread;
+ * clients write fixed-size buffers until the deadline.
+ */
+static void *
+stream_drain(void *arg)
+{
+	int fd = (int)(uintptr_t)arg;
+	static char buf[NB_STREAM_BUF];
+
+	while (read(fd, buf, sizeof (buf)) > 0)
+		;
+	(void) close(fd);
+	return (NULL);
+}
+
+static void *
+stream_server(void *arg)
+{
+	int lfd = (int)(uintptr_t)arg;
+	int fd;
+
+	while ((fd = accept(lfd, NULL, NULL)) != -1) {
+		if (thr_create(NULL, 0, stream_drain, (void *)(uintptr_t)fd,
+		    THR_DETACHED, NULL) != 0)
+			err(EXIT_FAILURE, "failed to create drain thread");
+	}
+	return (NULL);
+}
+
+static void *
+stream_client(void *arg)
+{
+	uintptr_t id = (uintptr_t)arg;
+	char buf[NB_STREAM_BUF] = { 0 };
+	int fd = nb_connect();
+
+	while (gethrtime() < nb_deadline) {
+		hrtime_t begin = 0;
+		ssize_t n;
+
+		if (id == 0)
+			begin = gethrtime();
+		n = write(fd, buf, sizeof (buf));
+		if (n == -1)
+			err(EXIT_FAILURE, "stream write failed");
+		if (id == 0)
+			nb_sample(gethrtime() - begin);
+		nb_ops[id] += n;
+	}
+	(void) close(fd);
+	return (NULL);
+}
+
+/*
+ * rr: one connection, single-byte ping-pong.  The server echoes each
+ * byte back; the client measures the full round trip.
+ */
+static void *
+rr_server(void *arg)
+{
+	int lfd = (int)(uintptr_t)arg;
+	int fd;
+	char c;
+
+	fd = accept(lfd, NULL, NULL);
+	if (fd == -1)
+		err(EXIT_FAILURE, "rr accept failed");
+	while (read(fd, &c, 1) == 1) {
+		if (write(fd, &c, 1) != 1)
+			break;
+	}
+	(void) close(fd);
+	return (NULL);
+}
+
+/*ARGSUSED*/
+static void *
+rr_client(void *arg)
+{
+	int fd = nb_connect();
+	int on = 1;
+	char c = 0;
+
+	if (setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof (on)) != 0)
+		err(EXIT_FAILURE, "failed to set TCP_NODELAY");
+
+	while (gethrtime() < nb_deadline) {
+		hrtime_t begin = gethrtime();
+
+		if (write(fd, &c, 1) != 1)
+			err(EXIT_FAILURE, "rr write failed");
+		if (read(fd, &c, 1) != 1)
+			err(EXIT_FAILURE, "rr read failed");
+		nb_sample(gethrtime() - begin);
+		nb_ops[0]++;
+	}
+	(void) close(fd);
+	return (NULL);
+}
+
+/*
+ * conn: the server accepts and immediately closes; clients cycle
+ * connect/close, so each operation inserts, looks up and tears down a
+ * conn_t.
+ */
+static void *
+conn_server(void *arg)
+{
+	int lfd = (int)(uintptr_t)arg;
+	int fd;
+
+	while ((fd = accept(lfd, NULL, NULL)) != -1)
+		(void) close(fd);
+	return (NULL);
+}
+
+static void *
+conn_client(void *arg)
+{
+	uintptr_t id = (uintptr_t)arg;
+
+	while (gethrtime() < nb_deadline) {
+		hrtime_t begin = 0;
+		int fd;
+
+		if (id == 0)
+			begin = gethrtime();
+		fd = nb_connect();
+		(void) close(fd);
+		if (id == 0)
+			nb_sample(gethrtime() - begin);
+		nb_ops[id]++;
+	}
+	return (NULL);
+}
+
+/*
+ * udp: the server drains a bound datagram socket; clients send small
+ * datagrams as fast as the stack accepts them.
+ */
+/*ARGSUSED*/
+static void *
+udp_server(void *arg)
+{
+	char buf[NB_UDP_SIZE];
+	int fd;
+
+	fd = socket(AF_INET, SOCK_DGRAM, 0);
+	if (fd == -1)
+		err(EXIT_FAILURE, "failed to create UDP socket");
+	if (bind(fd, (struct sockaddr *)&nb_addr, sizeof (nb_addr)) != 0)
+		err(EXIT_FAILURE, "failed to bind UDP socket");
+	for (;;) {
+		if (recv(fd, buf, sizeof (buf), 0) == -1)
+			break;
+	}
+	return (NULL);
+}
+
+static void *
+udp_client(void *arg)
+{
+	uintptr_t id = (uintptr_t)arg;
+	char buf[NB_UDP_SIZE] = { 0 };
+	int fd;
+
+	fd = socket(AF_INET, SOCK_DGRAM, 0);
+	if (fd == -1)
+		err(EXIT_FAILURE, "failed to create UDP socket");
+	if (connect(fd, (struct sockaddr *)&nb_addr, sizeof (nb_addr)) != 0)
+		err(EXIT_FAILURE, "failed to connect UDP socket");
+
+	while (gethrtime() < nb_deadline) {
+		hrtime_t begin = 0;
+
+		if (id == 0)
+			begin = gethrtime();
+		if (send(fd, buf, sizeof (buf), 0) == -1)
+			err(EXIT_FAILURE, "UDP send failed");
+		if (id == 0)
+			nb_sample(gethrtime() - begin);
+		nb_ops[id]++;
+	}
+	(void) close(fd);
+	return (NULL);
+}
+
+static void
+usage(void)
+{
+	(void) fprintf(stderr, "usage: net_bench -t stream|rr|conn|udp "
+	    "[-a addr] [-p port] [-n threads] [-d seconds]\n");
+	exit(2);
+}
+
+int
+main(int argc, char *argv[])
+{
+	const char *mode = NULL;
+	const char *addr = "127.0.0.1";
+	void *(*server)(void *) = NULL;
+	void *(*client)(void *) = NULL;
+	thread_t thrs[NB_MAX_THREADS];
+	hrtime_t begin;
+	int port = 5123;
+	int lfd = -1;
+	uintptr_t i;
+	int c;
+
+	while ((c = getopt(argc, argv, "t:a:p:n:d:")) != -1) {
+		switch (c) {
+		case 't':
+			mode = optarg;
+			break;
+		case 'a':
+			addr = optarg;
+			break;
+		case 'p':
+			port = atoi(optarg);
+			break;
+		case 'n':
+			nb_nthreads = atoi(optarg);
+			break;
+		case 'd':
+			nb_duration = atoi(optarg);
+			break;
+		default:
+			usage();
+		}
+	}
+	if (mode == NULL || nb_nthreads < 1 || nb_nthreads > NB_MAX_THREADS ||
+	    nb_duration < 1)
+		usage();
+
+	(void) memset(&nb_addr, 0, sizeof (nb_addr));
+	nb_addr.sin_family = AF_INET;
+	nb_addr.sin_port = htons(port);
+	if (inet_pton(AF_INET, addr, &nb_addr.sin_addr) != 1)
+		errx(EXIT_FAILURE, "invalid address: %s", addr);
+
+	if (strcmp(mode, "stream") == 0) {
+		server = stream_server;
+		client = stream_client;
+	} else if (strcmp(mode, "rr") == 0) {
+		server = rr_server;
+		client = rr_client;
+		nb_nthreads = 1;
+	} else if (strcmp(mode, "conn") == 0) {
+		server = conn_server;
+		client = conn_client;
+	} else if (strcmp(mode, "udp") == 0) {
+		server = udp_server;
+		client = udp_client;
+	} else {
+		usage();
+	}
+
+	nb_samples = calloc(NB_SAMPLE_CAP, sizeof (hrtime_t));
+	if (nb_samples == NULL)
+		err(EXIT_FAILURE, "failed to allocate sample buffer");
+
+	if (server != udp_server)
+		lfd = nb_listen();
+	if (thr_create(NULL, 0, server, (void *)(uintptr_t)lfd, THR_DETACHED,
+	    NULL) != 0)
+		err(EXIT_FAILURE, "failed to create server thread");
+	if (server == udp_server) {
+		/* give the server a moment to bind before clients send */
+		(void) poll(NULL, 0, 100);
+	}
+
+	begin = gethrtime();
+	nb_deadline = begin + (hrtime_t)nb_duration * NANOSEC;
+	for (i = 0; i < nb_nthreads; i++) {
+		if (thr_create(NULL, 0, client, (void *)i, 0, &thrs[i]) != 0)
+			err(EXIT_FAILURE, "failed to create client thread");
+	}
+	for (i = 0; i < nb_nthreads; i++)
+		(void) thr_join(thrs[i], NULL, NULL);
+
+	nb_report(mode, gethrtime() - begin);
+	return (0);
+}
@@ -0,0 +1,116 @@
+/*
+ * This file and its contents are supplied under the terms of the
+ * Common Development and Distribution License ("CDDL"), version 1.0.
+ * You may only use this file in accordance with the terms of version
+ * 1.0 of the CDDL.
+ *
+ * A full copy of the text of the CDDL should have accompanied this
+ * source.  A copy of the CDDL is also available via the Internet at
+ * http://www.illumos.org/license/CDDL.
+ */
+
+#ifndef	_PERF_H
+#define	_PERF_H
+
+/*
+ * Common measurement harness for the perf-tests microbenchmarks.
+ *
+ * Each benchmark records one hrtime_t latency sample per operation (or
+ * per round trip) and finishes by emitting a single machine-readable
+ * result line on stdout:
+ *
+ *	bench=<name> ops=<n> ns=<elapsed> ops_per_sec=<rate> p99_ns=<lat>
+ *
+ * perfcmp(8) consumes these lines to compare runs against a baseline.
+ */
+
+#include <sys/types.h>
+#include <sys/time.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <err.h>
+
+typedef struct perf {
+	const char	*p_name;	/* benchmark name */
+	hrtime_t	*p_samples;	/* per-operation latencies */
+	size_t		p_cap;		/* capacity of p_samples */
+	size_t		p_nsamples;	/* samples recorded */
+	uint64_t	p_ops;		/* operations performed */
+	hrtime_t	p_begin;	/* gethrtime() at perf_start() */
+	hrtime_t	p_elapsed;	/* total measured time */
+} perf_t;
+
+static void
+perf_init(perf_t *p, const char *name, size_t cap)
+{
+	p->p_name = name;
+	p->p_cap = cap;
+	p->p_nsamples = 0;
+	p->p_ops = 0;
+	p->p_elapsed = 0;
+	p->p_samples = calloc(cap, sizeof (hrtime_t));
+	if (p->p_samples == NULL)
+		err(EXIT_FAILURE, "failed to allocate sample buffer");
+}
+
+static void
+perf_start(perf_t *p)
+{
+	p->p_begin = gethrtime();
+}
+
+/*
+ * Record a single sample covering "ops" operations.  Samples beyond the
+ * buffer's capacity still count toward the throughput figures but are
+ * excluded from the latency percentile.
+ */
+static void
+perf_sample(perf_t *p, hrtime_t delta, uint64_t ops)
+{
+	if (p->p_nsamples < p->p_cap)
+		p->p_samples[p->p_nsamples++] = delta;
+	p->p_ops += ops;
+}
+
+static void
+perf_finish(perf_t *p)
+{
+	p->p_elapsed = gethrtime() - p->p_begin;
+}
+
+static int
+perf_cmp(const void *l, const void *r)
+{
+	hrtime_t lhs = *(const hrtime_t *)l;
+	hrtime_t rhs = *(const hrtime_t *)r;
+
+	if (lhs < rhs)
+		return (-1);
+	return (lhs > rhs);
+}
+
+static void
+perf_report(perf_t *p)
+{
+	hrtime_t p99 = 0;
+	double rate = 0.0;
+
+	if (p->p_nsamples > 0) {
+		size_t idx = (p->p_nsamples * 99) / 100;
+
+		qsort(p->p_samples, p->p_nsamples, sizeof (hrtime_t),
+		    perf_cmp);
+		if (idx >= p->p_nsamples)
+			idx = p->p_nsamples - 1;
+		p99 = p->p_samples[idx];
+	}
+	if (p->p_elapsed > 0)
+		rate = (double)p->p_ops * NANOSEC / (double)p->p_elapsed;
+
+	(void) printf("bench=%s ops=%llu ns=%lld ops_per_sec=%.0f "
+	    "p99_ns=%lld\n", p->p_name, (u_longlong_t)p->p_ops,
+	    (longlong_t)p->p_elapsed, rate, (longlong_t)p99);
+	free(p->p_samples);
+}
+
+#endif	/* _PERF_H */
@@ -0,0 +1,76 @@
+/*
+ * This file and its contents are supplied under the terms of the
+ * Common Development and Distribution License ("CDDL"), version 1.0.
+ * You may only use this file in accordance with the terms of version
+ * 1.0 of the CDDL.
+ *
+ * A full copy of the text of the CDDL should have accompanied this
+ * source.  A copy of the CDDL is also available via the Internet at
+ * http://www.illumos.org/license/CDDL.
+ */
+
+/*
+ * Condition variable wakeup latency microbenchmark.  Two threads
+ * ping-pong a byte over a pair of pipes; each round trip consists of
+ * two blocking reads, each satisfied by a cv_signal()-driven wakeup in
+ * the pipe (fifofs) implementation.  The p99 figure is the round-trip
+ * latency, dominated by the time to wake and dispatch a blocked
+ * thread.
+ */
+
+#include <unistd.h>
+#include <thread.h>
+
+#include "perf.h"
+
+#define	CV_ROUNDS	50000
+
+static int cv_ping[2];		/* main -> echo */
+static int cv_pong[2];		/* echo -> main */
+
+static void *
+cv_echo_thread(void *arg __unused)
+{
+	char c;
+	int i;
+
+	for (i = 0; i < CV_ROUNDS; i++) {
+		if (read(cv_ping[0], &c, 1) != 1)
+			err(EXIT_FAILURE, "echo read failed");
+		if (write(cv_pong[1], &c, 1) != 1)
+			err(EXIT_FAILURE, "echo write failed");
+	}
+
+	return (NULL);
+}
+
+int
+main(void)
+{
+	perf_t p;
+	thread_t thr;
+	char c = 'p';
+	int i;
+
+	if (pipe(cv_ping) != 0 || pipe(cv_pong) != 0)
+		err(EXIT_FAILURE, "failed to create pipes");
+	if (thr_create(NULL, 0, cv_echo_thread, NULL, 0, &thr) != 0)
+		err(EXIT_FAILURE, "failed to create thread");
+
+	perf_init(&p, "cv", CV_ROUNDS);
+	perf_start(&p);
+	for (i = 0; i < CV_ROUNDS; i++) {
+		hrtime_t begin = gethrtime();
+
+		if (write(cv_ping[1], &c, 1) != 1)
+			err(EXIT_FAILURE, "write failed");
+		if (read(cv_pong[0], &c, 1) != 1)
+			err(EXIT_FAILURE, "read failed");
+		perf_sample(&p, gethrtime() - begin, 1);
+	}
+	perf_finish(&p);
+	(void) thr_join(thr, NULL, NULL);
+	perf_report(&p);
+
+	return (0);
+}
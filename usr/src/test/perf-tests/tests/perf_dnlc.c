@@ -0,0 +1,77 @@
+/*
+ * This file and its contents are supplied under the terms of the
+ * Common Development and Distribution License ("CDDL"), version 1.0.
+ * You may only use this file in accordance with the terms of version
+ * 1.0 of the CDDL.
+ *
+ * A full copy of the text of the CDDL should have accompanied this
+ * source.  A copy of the CDDL is also available via the Internet at
+ * http://www.illumos.org/license/CDDL.
+ */
+
+/*
+ * Directory name lookup cache microbenchmark.  A six-component
+ * directory chain is created under /var/tmp and the leaf is stat(2)ed
+ * repeatedly; after the first lookup every component is a dnlc hit, so
+ * the loop measures warm lookuppn()/dnlc_lookup() throughput.
+ */
+
+#include <sys/param.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
+
+#include "perf.h"
+
+#define	DNLC_OPS	200000
+#define	DNLC_DEPTH	6
+
+int
+main(void)
+{
+	char path[MAXPATHLEN];
+	char template[] = "/var/tmp/perf_dnlc.XXXXXX";
+	perf_t p;
+	struct stat st;
+	int i, fd;
+
+	if (mkdtemp(template) == NULL)
+		err(EXIT_FAILURE, "failed to create temporary directory");
+	(void) strlcpy(path, template, sizeof (path));
+	for (i = 0; i < DNLC_DEPTH; i++) {
+		(void) strlcat(path, "/d", sizeof (path));
+		if (mkdir(path, 0755) != 0)
+			err(EXIT_FAILURE, "failed to create %s", path);
+	}
+	(void) strlcat(path, "/leaf", sizeof (path));
+	if ((fd = open(path, O_CREAT | O_WRONLY, 0644)) == -1)
+		err(EXIT_FAILURE, "failed to create %s", path);
+	(void) close(fd);
+
+	perf_init(&p, "dnlc", DNLC_OPS);
+	perf_start(&p);
+	for (i = 0; i < DNLC_OPS; i++) {
+		hrtime_t begin = gethrtime();
+
+		if (stat(path, &st) != 0)
+			err(EXIT_FAILURE, "stat of %s failed", path);
+		perf_sample(&p, gethrtime() - begin, 1);
+	}
+	perf_finish(&p);
+	perf_report(&p);
+
+	/*
+	 * Best-effort cleanup, deepest first.
+	 */
+	(void) unlink(path);
+	*strrchr(path, '/') = '\0';
+	while (strlen(path) > strlen(template)) {
+		(void) rmdir(path);
+		*strrchr(path, '/') = '\0';
+	}
+	(void) rmdir(template);
+
+	return (0);
+}
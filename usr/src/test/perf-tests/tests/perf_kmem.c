@@ -0,0 +1,48 @@
+/*
+ * This file and its contents are supplied under the terms of the
+ * Common Development and Distribution License ("CDDL"), version 1.0.
+ * You may only use this file in accordance with the terms of version
+ * 1.0 of the CDDL.
+ *
+ * A full copy of the text of the CDDL should have accompanied this
+ * source.  A copy of the CDDL is also available via the Internet at
+ * http://www.illumos.org/license/CDDL.
+ */
+
+/*
+ * Kernel memory allocator microbenchmark.  Each operation opens and
+ * closes /dev/null, which allocates and frees a file_t from the
+ * file_cache kmem cache (plus the associated fd reservation) on every
+ * trip, so the figure tracks the kmem per-CPU magazine fast path as
+ * seen through the cheapest allocating system call pair.
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "perf.h"
+
+#define	KMEM_OPS	200000
+
+int
+main(void)
+{
+	perf_t p;
+	int i;
+
+	perf_init(&p, "kmem", KMEM_OPS);
+	perf_start(&p);
+	for (i = 0; i < KMEM_OPS; i++) {
+		hrtime_t begin = gethrtime();
+		int fd = open("/dev/null", O_RDONLY);
+
+		if (fd == -1)
+			err(EXIT_FAILURE, "failed to open /dev/null");
+		(void) close(fd);
+		perf_sample(&p, gethrtime() - begin, 1);
+	}
+	perf_finish(&p);
+	perf_report(&p);
+
+	return (0);
+}
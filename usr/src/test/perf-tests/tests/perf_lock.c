@@ -0,0 +1,87 @@
+/*
+ * This file and its contents are supplied under the terms of the
+ * Common Development and Distribution License ("CDDL"), version 1.0.
+ * You may only use this file in accordance with the terms of version
+ * 1.0 of the CDDL.
+ *
+ * A full copy of the text of the CDDL should have accompanied this
+ * source.  A copy of the CDDL is also available via the Internet at
+ * http://www.illumos.org/license/CDDL.
+ */
+
+/*
+ * Kernel lock contention microbenchmark.  All threads share a single
+ * open file and call lseek(2) in a tight loop; every call updates
+ * f_offset under the file's f_tlock mutex, so with more than one
+ * thread the loop measures throughput of a heavily contended kernel
+ * mutex.  Thread 0 additionally records per-operation latencies for
+ * the tail latency figure.
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <thread.h>
+#include <synch.h>
+#include <atomic.h>
+
+#include "perf.h"
+
+#define	LOCK_NTHREADS	8
+#define	LOCK_OPS	100000		/* per thread */
+
+static int lock_fd;
+static perf_t lock_perf;
+static volatile uint64_t lock_ops[LOCK_NTHREADS];
+
+static void *
+lock_thread(void *arg)
+{
+	uintptr_t id = (uintptr_t)arg;
+	int i;
+
+	for (i = 0; i < LOCK_OPS; i++) {
+		hrtime_t begin = 0;
+
+		if (id == 0)
+			begin = gethrtime();
+		if (lseek(lock_fd, 0, SEEK_SET) == -1)
+			err(EXIT_FAILURE, "lseek failed");
+		if (id == 0)
+			perf_sample(&lock_perf, gethrtime() - begin, 0);
+		lock_ops[id]++;
+	}
+
+	return (NULL);
+}
+
+int
+main(void)
+{
+	thread_t thrs[LOCK_NTHREADS];
+	uintptr_t i;
+	uint64_t total = 0;
+
+	lock_fd = open("/dev/null", O_RDONLY);
+	if (lock_fd == -1)
+		err(EXIT_FAILURE, "failed to open /dev/null");
+
+	perf_init(&lock_perf, "lock", LOCK_OPS);
+	perf_start(&lock_perf);
+	for (i = 0; i < LOCK_NTHREADS; i++) {
+		if (thr_create(NULL, 0, lock_thread, (void *)i, 0,
+		    &thrs[i]) != 0) {
+			err(EXIT_FAILURE, "failed to create thread");
+		}
+	}
+	for (i = 0; i < LOCK_NTHREADS; i++)
+		(void) thr_join(thrs[i], NULL, NULL);
+	perf_finish(&lock_perf);
+
+	for (i = 0; i < LOCK_NTHREADS; i++)
+		total += lock_ops[i];
+	lock_perf.p_ops = total;
+	perf_report(&lock_perf);
+
+	(void) close(lock_fd);
+	return (0);
+}
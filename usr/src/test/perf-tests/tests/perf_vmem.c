@@ -0,0 +1,51 @@
+/*
+ * This file and its contents are supplied under the terms of the
+ * Common Development and Distribution License ("CDDL"), version 1.0.
+ * You may only use this file in accordance with the terms of version
+ * 1.0 of the CDDL.
+ *
+ * A full copy of the text of the CDDL should have accompanied this
+ * source.  A copy of the CDDL is also available via the Internet at
+ * http://www.illumos.org/license/CDDL.
+ */
+
+/*
+ * Address space / vmem microbenchmark.  Each operation maps and
+ * unmaps a 64K anonymous segment, exercising as_map()/as_unmap(),
+ * the seg_vn segment driver, and the kernel allocations behind them.
+ * The first page is touched so the map is not entirely lazy.
+ */
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "perf.h"
+
+#define	VMEM_OPS	100000
+#define	VMEM_SIZE	(64 * 1024)
+
+int
+main(void)
+{
+	perf_t p;
+	int i;
+
+	perf_init(&p, "vmem", VMEM_OPS);
+	perf_start(&p);
+	for (i = 0; i < VMEM_OPS; i++) {
+		hrtime_t begin = gethrtime();
+		void *addr = mmap(NULL, VMEM_SIZE, PROT_READ | PROT_WRITE,
+		    MAP_ANON | MAP_PRIVATE, -1, 0);
+
+		if (addr == MAP_FAILED)
+			err(EXIT_FAILURE, "mmap failed");
+		*(volatile char *)addr = 1;
+		if (munmap(addr, VMEM_SIZE) != 0)
+			err(EXIT_FAILURE, "munmap failed");
+		perf_sample(&p, gethrtime() - begin, 1);
+	}
+	perf_finish(&p);
+	perf_report(&p);
+
+	return (0);
+}
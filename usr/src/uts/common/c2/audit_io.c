@@ -369,6 +369,16 @@ au_enqueue(au_kcontext_t *kctx, au_buff_t *m, adr_t *hadrp, adr_t *sadrp,
 	if (kctx == NULL)
 		return;
 
+	/*
+	 * Fill in date and time if needed.  The record is still private to
+	 * this thread, so do the work before taking the queue lock; every
+	 * auditing thread in the zone funnels through this lock, and the
+	 * time encoding was a large fraction of what it used to cover.
+	 */
+	if (hadrp->adr_now) {
+		au_save_time(hadrp, NULL, size);
+	}
+
 	mutex_enter(&(kctx->auk_queue.lock));
 
 	if (!dontblock && (kctx->auk_queue.cnt >= kctx->auk_queue.hiwater) &&
@@ -378,11 +388,6 @@ au_enqueue(au_kcontext_t *kctx, au_buff_t *m, adr_t *hadrp, adr_t *sadrp,
 		return;
 	}
 
-	/* Fill in date and time if needed */
-	if (hadrp->adr_now) {
-		au_save_time(hadrp, NULL, size);
-	}
-
 	/* address will be non-zero only if AUDIT_SEQ set */
 	if (sadrp->adr_now) {
 		kctx->auk_sequence++;
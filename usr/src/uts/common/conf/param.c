@@ -225,11 +225,17 @@ extern void clock_tick_mp_init(void);
 extern void cu_init(void);
 extern void callout_mp_init(void);
 extern void cpu_seq_tbl_init(void);
+extern void turnstile_init(void);
+extern void syscall_lat_init(void);
+extern void lock_cont_init(void);
 
 void	(*init_tbl[])(void) = {
 	system_taskq_init,
 	binit,
 	space_init,
+	turnstile_init,
+	syscall_lat_init,
+	lock_cont_init,
 	dnlc_init,
 	vfsinit,
 	finit,
@@ -336,10 +336,25 @@ crypto_encrypt_prov(crypto_provider_t provider, crypto_session_id_t sid,
 			return (error);
 	}
 
-	KCF_WRAP_ENCRYPT_OPS_PARAMS(&params, KCF_OP_ATOMIC, sid, mech, key,
-	    plaintext, ciphertext, tmpl);
+	/* The fast path for SW providers. */
+	if (CHECK_FASTPATH(crq, real_provider)) {
+		crypto_mechanism_t lmech;
+
+		lmech = *mech;
+		KCF_SET_PROVIDER_MECHNUM(mech->cm_type, real_provider, &lmech);
+
+		error = KCF_PROV_ENCRYPT_ATOMIC(real_provider, sid, &lmech,
+		    key, plaintext, ciphertext, tmpl, KCF_SWFP_RHNDL(crq));
+		KCF_PROV_INCRSTATS(real_provider, error);
+	} else {
+		KCF_WRAP_ENCRYPT_OPS_PARAMS(&params, KCF_OP_ATOMIC, sid, mech,
+		    key, plaintext, ciphertext, tmpl);
+
+		error = kcf_submit_request(real_provider, NULL, crq, &params,
+		    B_FALSE);
+	}
+
 
-	error = kcf_submit_request(real_provider, NULL, crq, &params, B_FALSE);
 	if (pd->pd_prov_type == CRYPTO_LOGICAL_PROVIDER)
 		KCF_PROV_REFRELE(real_provider);
 
@@ -617,10 +632,25 @@ crypto_decrypt_prov(crypto_provider_t provider, crypto_session_id_t sid,
 			return (rv);
 	}
 
-	KCF_WRAP_DECRYPT_OPS_PARAMS(&params, KCF_OP_ATOMIC, sid, mech, key,
-	    ciphertext, plaintext, tmpl);
+	/* The fast path for SW providers. */
+	if (CHECK_FASTPATH(crq, real_provider)) {
+		crypto_mechanism_t lmech;
+
+		lmech = *mech;
+		KCF_SET_PROVIDER_MECHNUM(mech->cm_type, real_provider, &lmech);
+
+		rv = KCF_PROV_DECRYPT_ATOMIC(real_provider, sid, &lmech, key,
+		    ciphertext, plaintext, tmpl, KCF_SWFP_RHNDL(crq));
+		KCF_PROV_INCRSTATS(real_provider, rv);
+	} else {
+		KCF_WRAP_DECRYPT_OPS_PARAMS(&params, KCF_OP_ATOMIC, sid, mech,
+		    key, ciphertext, plaintext, tmpl);
+
+		rv = kcf_submit_request(real_provider, NULL, crq, &params,
+		    B_FALSE);
+	}
+
 
-	rv = kcf_submit_request(real_provider, NULL, crq, &params, B_FALSE);
 	if (pd->pd_prov_type == CRYPTO_LOGICAL_PROVIDER)
 		KCF_PROV_REFRELE(real_provider);
 
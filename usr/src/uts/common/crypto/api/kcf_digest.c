@@ -111,11 +111,26 @@ crypto_digest_prov(crypto_provider_t provider, crypto_session_id_t sid,
 		if (rv != CRYPTO_SUCCESS)
 			return (rv);
 	}
-	KCF_WRAP_DIGEST_OPS_PARAMS(&params, KCF_OP_ATOMIC, sid, mech, NULL,
-	    data, digest);
+	/* The fast path for SW providers. */
+	if (CHECK_FASTPATH(crq, real_provider)) {
+		crypto_mechanism_t lmech;
+
+		lmech = *mech;
+		KCF_SET_PROVIDER_MECHNUM(mech->cm_type, real_provider, &lmech);
+
+		rv = KCF_PROV_DIGEST_ATOMIC(real_provider, sid, &lmech, data,
+		    digest, KCF_SWFP_RHNDL(crq));
+		KCF_PROV_INCRSTATS(real_provider, rv);
+	} else {
+		KCF_WRAP_DIGEST_OPS_PARAMS(&params, KCF_OP_ATOMIC, sid, mech,
+		    NULL, data, digest);
+
+		/* no crypto context to carry between multiple parts. */
+		rv = kcf_submit_request(real_provider, NULL, crq, &params,
+		    B_FALSE);
+	}
+
 
-	/* no crypto context to carry between multiple parts. */
-	rv = kcf_submit_request(real_provider, NULL, crq, &params, B_FALSE);
 	if (pd->pd_prov_type == CRYPTO_LOGICAL_PROVIDER)
 		KCF_PROV_REFRELE(real_provider);
 
@@ -112,9 +112,24 @@ crypto_mac_prov(crypto_provider_t provider, crypto_session_id_t sid,
 			return (rv);
 	}
 
-	KCF_WRAP_MAC_OPS_PARAMS(&params, KCF_OP_ATOMIC, sid, mech, key,
-	    data, mac, tmpl);
-	rv = kcf_submit_request(real_provider, NULL, crq, &params, B_FALSE);
+	/* The fast path for SW providers. */
+	if (CHECK_FASTPATH(crq, real_provider)) {
+		crypto_mechanism_t lmech;
+
+		lmech = *mech;
+		KCF_SET_PROVIDER_MECHNUM(mech->cm_type, real_provider, &lmech);
+
+		rv = KCF_PROV_MAC_ATOMIC(real_provider, sid, &lmech, key,
+		    data, mac, tmpl, KCF_SWFP_RHNDL(crq));
+		KCF_PROV_INCRSTATS(real_provider, rv);
+	} else {
+		KCF_WRAP_MAC_OPS_PARAMS(&params, KCF_OP_ATOMIC, sid, mech,
+		    key, data, mac, tmpl);
+		rv = kcf_submit_request(real_provider, NULL, crq, &params,
+		    B_FALSE);
+	}
+
+
 	if (pd->pd_prov_type == CRYPTO_LOGICAL_PROVIDER)
 		KCF_PROV_REFRELE(real_provider);
 
@@ -236,9 +251,24 @@ crypto_mac_verify_prov(crypto_provider_t provider, crypto_session_id_t sid,
 			return (rv);
 	}
 
-	KCF_WRAP_MAC_OPS_PARAMS(&params, KCF_OP_MAC_VERIFY_ATOMIC, sid, mech,
-	    key, data, mac, tmpl);
-	rv = kcf_submit_request(real_provider, NULL, crq, &params, B_FALSE);
+	/* The fast path for SW providers. */
+	if (CHECK_FASTPATH(crq, real_provider)) {
+		crypto_mechanism_t lmech;
+
+		lmech = *mech;
+		KCF_SET_PROVIDER_MECHNUM(mech->cm_type, real_provider, &lmech);
+
+		rv = KCF_PROV_MAC_VERIFY_ATOMIC(real_provider, sid, &lmech,
+		    key, data, mac, tmpl, KCF_SWFP_RHNDL(crq));
+		KCF_PROV_INCRSTATS(real_provider, rv);
+	} else {
+		KCF_WRAP_MAC_OPS_PARAMS(&params, KCF_OP_MAC_VERIFY_ATOMIC,
+		    sid, mech, key, data, mac, tmpl);
+		rv = kcf_submit_request(real_provider, NULL, crq, &params,
+		    B_FALSE);
+	}
+
+
 	if (pd->pd_prov_type == CRYPTO_LOGICAL_PROVIDER)
 		KCF_PROV_REFRELE(real_provider);
 
@@ -237,6 +237,15 @@ cpupart_lpl_initialize(cpupart_t *cp)
 		cp->cp_lgrploads[i].lpl_id2rset =
 		    kmem_zalloc(sizeof (int) * (sz + 1), KM_SLEEP);
 		cp->cp_lgrploads[i].lpl_lgrpid = i;
+
+		/*
+		 * Idle CPU set, maintained by the dispatcher for leaf lpls
+		 * so that disp_lowpri_cpu() can find an idle CPU without
+		 * scanning. Sized and spread out like cp_haltset.
+		 */
+		bitset_init_fanout(&cp->cp_lgrploads[i].lpl_idleset,
+		    cp_haltset_fanout);
+		bitset_resize(&cp->cp_lgrploads[i].lpl_idleset, max_ncpus);
 	}
 }
 
@@ -257,6 +266,7 @@ cpupart_lpl_teardown(cpupart_t *cp)
 		kmem_free(lpl->lpl_id2rset, sizeof (int) * sz);
 		lpl->lpl_rset = NULL;
 		lpl->lpl_id2rset = NULL;
+		bitset_fini(&lpl->lpl_idleset);
 	}
 	kmem_free(cp->cp_lgrploads, sizeof (lpl_t) * cp->cp_nlgrploads);
 	cp->cp_lgrploads = NULL;
@@ -52,6 +52,7 @@
 #include <sys/cpupart.h>
 #include <sys/lgrp.h>
 #include <sys/pg.h>
+#include <sys/pghw.h>
 #include <sys/cmt.h>
 #include <sys/bitset.h>
 #include <sys/schedctl.h>
@@ -577,10 +578,21 @@ static void
 idle_enter()
 {
 	cpu_t		*cp = CPU;
+	lpl_t		*lpl = cp->cpu_lpl;
 
 	new_cpu_mstate(CMS_IDLE, gethrtime_unscaled());
 	CPU_STATS_ADDQ(cp, sys, idlethread, 1);
 	set_idle_cpu(cp->cpu_id);	/* arch-dependent hook */
+
+	/*
+	 * Advertise this CPU in its leaf lgroup's idle CPU set so that
+	 * disp_lowpri_cpu() can find it without scanning the leaf. The
+	 * set isn't allocated for the bootstrap lpls used during early
+	 * boot and CPU bring-up, and an offlined CPU may idle with no
+	 * lpl at all.
+	 */
+	if (lpl != NULL && bitset_capacity(&lpl->lpl_idleset) != 0)
+		bitset_atomic_add(&lpl->lpl_idleset, cp->cpu_seqid);
 }
 
 /*
@@ -590,6 +602,10 @@ static void
 idle_exit()
 {
 	cpu_t		*cp = CPU;
+	lpl_t		*lpl = cp->cpu_lpl;
+
+	if (lpl != NULL && bitset_capacity(&lpl->lpl_idleset) != 0)
+		bitset_atomic_del(&lpl->lpl_idleset, cp->cpu_seqid);
 
 	new_cpu_mstate(CMS_SYSTEM, gethrtime_unscaled());
 	unset_idle_cpu(cp->cpu_id);	/* arch-dependent hook */
@@ -1177,6 +1193,15 @@ cpu_resched(cpu_t *cp, pri_t tpri)
 #define	RUNQ_MAX_DIFF	2	/* maximum runq length difference */
 #define	RUNQ_LEN(cp, pri)	((cp)->cpu_disp->disp_q[pri].dq_sruncnt)
 
+/*
+ * Additional run queue length difference required before the balancing
+ * in setbackdq() will move a thread to a CPU that does not share a
+ * last-level cache with the preferred CPU.  A cross-cache migration
+ * forfeits whatever cache state the thread has built up, so demand a
+ * larger imbalance to justify it.  Zero restores the old behavior.
+ */
+int	runq_cross_cache_diff = 2;
+
 /*
  * Macro that evaluates to true if it is likely that the thread has cache
  * warmth. This is based on the amount of time that has elapsed since the
@@ -1269,6 +1294,7 @@ setbackdq(kthread_t *tp)
 				qlen -= RUNQ_MAX_DIFF;
 			if (qlen > 0) {
 				cpu_t *newcp;
+				int newqlen;
 
 				if (tp->t_lpl->lpl_lgrpid == LGRP_ROOTID) {
 					newcp = cp->cpu_next_part;
@@ -1276,8 +1302,17 @@ setbackdq(kthread_t *tp)
 					newcp = cp->cpu_next_part;
 				}
 
+				/*
+				 * Moving outside the preferred CPU's
+				 * last-level cache must be justified by
+				 * a correspondingly larger imbalance.
+				 */
+				newqlen = RUNQ_LEN(newcp, tpri);
+				if (!pg_plat_cpus_share(cp, newcp, PGHW_CACHE))
+					newqlen += runq_cross_cache_diff;
+
 				if (smt_should_run(tp, newcp) &&
-				    RUNQ_LEN(newcp, tpri) < qlen) {
+				    newqlen < qlen) {
 					DTRACE_PROBE3(runq__balance,
 					    kthread_t *, tp,
 					    cpu_t *, cp, cpu_t *, newcp);
@@ -2636,6 +2671,34 @@ disp_lowpri_cpu(cpu_t *hint, kthread_t *tp, pri_t tpri)
 
 			klgrpset_add(cur_set, lpl_leaf->lpl_lgrpid);
 
+			/*
+			 * Fast path: if the leaf advertises an idle CPU,
+			 * take it instead of scoring every CPU in the leaf.
+			 * The set is maintained without the dispatcher locks
+			 * (and a CPU can be rehomed while sitting idle), so
+			 * the candidate must be re-verified; on failure just
+			 * fall back to the scan below. bitset_find() starts
+			 * from a pseudo-random position, which also spreads
+			 * concurrent wakeups (e.g. a cv_broadcast() storm)
+			 * across the idle CPUs rather than stampeding the
+			 * first one.
+			 */
+			if (!bitset_is_null(&lpl_leaf->lpl_idleset)) {
+				uint_t cpu_sid =
+				    bitset_find(&lpl_leaf->lpl_idleset);
+
+				if (cpu_sid != (uint_t)-1) {
+					cp = cpu_seq[cpu_sid];
+					if (cp != NULL &&
+					    cp->cpu_lpl == lpl_leaf &&
+					    cpu_score(cp, tp) / 2 ==
+					    CPU_IDLE_PRI) {
+						bestcpu = cp;
+						goto out;
+					}
+				}
+			}
+
 			if (hint->cpu_lpl == lpl_leaf)
 				cp = cpstart = hint;
 			else
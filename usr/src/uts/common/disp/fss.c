@@ -328,6 +328,14 @@ static struct modlinkage modlinkage = {
 #define	FSS_DECAY_USG	96	/* fssusage decay pct for projects */
 #define	FSS_DECAY_BASE	128	/* base for decay percentages above */
 
+/*
+ * Number of update passes after which a repeatedly decayed fsspri value is
+ * treated as fully decayed. Even with the slowest per-pass decay factor
+ * (FSS_DECAY_MAX / FSS_DECAY_BASE) the value has dropped by ten orders of
+ * magnitude by this point, so lazy decay just zeroes it rather than looping.
+ */
+#define	FSS_DECAY_ZERO	128
+
 #define	FSS_NICE_MIN	0
 #define	FSS_NICE_MAX	(2 * NZERO - 1)
 #define	FSS_NICE_RANGE	(FSS_NICE_MAX - FSS_NICE_MIN + 1)
@@ -352,6 +360,31 @@ static time_t	fss_minrun = 2;	/* t_pri becomes 59 within 2 secs */
 static time_t	fss_minslp = 2;	/* min time on sleep queue for hardswap */
 static int	fss_quantum = 11;
 
+/*
+ * Generation count of once-per-second fss_update() passes. Threads that are
+ * sleeping or stopped are no longer visited by each pass; instead they record
+ * the generation their fsspri was last decayed for and catch up lazily via
+ * fss_decay_thread() when they next become runnable.
+ */
+static volatile uint32_t fss_update_gen;
+
+/*
+ * Statistics for the once-per-second update/decay pass, for observing the
+ * latency it induces (the decay and list scans run with various scheduler
+ * locks held).
+ */
+static struct fss_kstat {
+	kstat_named_t	fssk_update_passes;	/* # of fss_update() passes */
+	kstat_named_t	fssk_update_nsec;	/* total pass duration */
+	kstat_named_t	fssk_update_nsec_max;	/* longest pass duration */
+	kstat_named_t	fssk_lazy_decays;	/* threads decayed on access */
+} fss_kstat = {
+	{ "update_passes",	KSTAT_DATA_UINT64 },
+	{ "update_nsec",	KSTAT_DATA_UINT64 },
+	{ "update_nsec_max",	KSTAT_DATA_UINT64 },
+	{ "lazy_decays",	KSTAT_DATA_UINT64 },
+};
+
 static void	fss_newpri(fssproc_t *, boolean_t);
 static void	fss_update(void *);
 static int	fss_update_list(int);
@@ -809,6 +842,46 @@ fss_inactive(kthread_t *t)
 	disp_lock_exit_high(&fsspset->fssps_displock);
 }
 
+/*
+ * Apply any fsspri decay this thread missed while it was asleep or stopped.
+ * fss_update_list() skips such threads and each would have had its fsspri
+ * multiplied by its nice decay factor once per pass, so catch up here based
+ * on the number of passes missed. Called when the thread becomes runnable.
+ */
+static void
+fss_decay_thread(fssproc_t *fssproc)
+{
+	uint32_t gen = fss_update_gen;
+	uint32_t missed = gen - fssproc->fss_updgen;
+	fssproj_t *fssproj;
+	fsspri_t fsspri;
+
+	ASSERT(THREAD_LOCK_HELD(fssproc->fss_tp));
+
+	if (missed == 0)
+		return;
+	fssproc->fss_updgen = gen;
+
+	fssproj = FSSPROC2FSSPROJ(fssproc);
+	if (fssproj == NULL || fssproj->fssp_shares == 0)
+		return;
+
+	fsspri = fssproc->fss_fsspri;
+	if (fsspri == 0)
+		return;
+
+	fss_kstat.fssk_lazy_decays.value.ui64++;
+
+	if (missed >= FSS_DECAY_ZERO) {
+		fssproc->fss_fsspri = 0;
+		return;
+	}
+	while (missed-- != 0 && fsspri != 0)
+		fsspri = (fsspri * fss_nice_decay[fssproc->fss_nice]) /
+		    FSS_DECAY_BASE;
+	fssproc->fss_fsspri = fsspri;
+}
+
 static void
 fss_active(kthread_t *t)
 {
@@ -822,6 +895,8 @@ fss_active(kthread_t *t)
 	fssproj = FSSPROC2FSSPROJ(fssproc);
 	if (fssproj == NULL)	/* if this thread already exited */
 		return;
+
+	fss_decay_thread(fssproc);
 	fsspset = FSSPROJ2FSSPSET(fssproj);
 	fsszone = fssproj->fssp_fsszone;
 	disp_lock_enter_high(&fsspset->fssps_displock);
@@ -845,6 +920,7 @@ static pri_t
 fss_init(id_t cid, int clparmsz, classfuncs_t **clfuncspp)
 {
 	int i;
+	kstat_t *ksp;
 
 	ASSERT(MUTEX_HELD(&cpu_lock));
 
@@ -880,6 +956,14 @@ fss_init(id_t cid, int clparmsz, classfuncs_t **clfuncspp)
 		    (FSS_NICE_RANGE - 1);
 	}
 
+	ksp = kstat_create("unix", 0, "fss_update", "misc", KSTAT_TYPE_NAMED,
+	    sizeof (fss_kstat) / sizeof (kstat_named_t),
+	    KSTAT_FLAG_VIRTUAL);
+	if (ksp != NULL) {
+		ksp->ks_data = &fss_kstat;
+		kstat_install(ksp);
+	}
+
 	return (fss_maxglobpri);
 }
 
@@ -1307,6 +1391,10 @@ fss_update(void *arg)
 	int i;
 	int new_marker = -1;
 	static int fss_update_marker;
+	hrtime_t start = gethrtime();
+	hrtime_t duration;
+
+	fss_update_gen++;
 
 	/*
 	 * Decay and update usages for all projects.
@@ -1339,6 +1427,12 @@ fss_update(void *arg)
 	if (new_marker != -1)
 		fss_update_marker = new_marker;
 
+	duration = gethrtime() - start;
+	fss_kstat.fssk_update_passes.value.ui64++;
+	fss_kstat.fssk_update_nsec.value.ui64 += duration;
+	if (duration > fss_kstat.fssk_update_nsec_max.value.ui64)
+		fss_kstat.fssk_update_nsec_max.value.ui64 = duration;
+
 	(void) timeout(fss_update, arg, hz);
 }
 
@@ -1362,6 +1456,20 @@ fss_update_list(int i)
 	for (fssproc = fss_listhead[i].fss_next; fssproc != &fss_listhead[i];
 	    fssproc = fssproc->fss_next) {
 		t = fssproc->fss_tp;
+
+		/*
+		 * Skip sleeping and stopped threads without taking the
+		 * thread lock; they decay lazily via fss_decay_thread()
+		 * when they next become runnable, so the cost of this
+		 * pass stays proportional to the number of runnable
+		 * threads rather than all threads in the class. t_state
+		 * is read unlocked: a thread that wakes right after the
+		 * check just applies this pass's decay itself, and one
+		 * that goes to sleep after it is handled below as before.
+		 */
+		if (t->t_state == TS_SLEEP || t->t_state == TS_STOPPED)
+			continue;
+
 		/*
 		 * Lock the thread and verify the state.
 		 */
@@ -1386,6 +1494,7 @@ fss_update_list(int i)
 			    FSS_DECAY_BASE;
 			fssproc->fss_fsspri = fsspri;
 		}
+		fssproc->fss_updgen = fss_update_gen;
 
 		if (t->t_schedctl && schedctl_get_nopreempt(t))
 			goto next;
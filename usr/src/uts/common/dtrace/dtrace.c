@@ -123,6 +123,7 @@ size_t		dtrace_actions_max = (16 * 1024);
 size_t		dtrace_retain_max = 1024;
 dtrace_optval_t	dtrace_helper_actions_max = 1024;
 dtrace_optval_t	dtrace_helper_providers_max = 32;
+int		dtrace_agghashshift = 3;	/* 1/8 of buffer is buckets */
 dtrace_optval_t	dtrace_dstate_defsize = (1 * 1024 * 1024);
 size_t		dtrace_strsize_default = 256;
 dtrace_optval_t	dtrace_cleanrate_default = 9900990;		/* 101 hz */
@@ -2426,7 +2427,7 @@ dtrace_aggregate(dtrace_aggregation_t *agg, dtrace_buffer_t *dbuf,
 	uint32_t i, ndx, size, fsize;
 	uint32_t align = sizeof (uint64_t) - 1;
 	dtrace_aggbuffer_t *agb;
-	dtrace_aggkey_t *key;
+	dtrace_aggkey_t *key, *prev = NULL;
 	uint32_t hashval = 0, limit, isstr;
 	caddr_t tomax, data, kdata;
 	dtrace_actkind_t action;
@@ -2471,9 +2472,16 @@ dtrace_aggregate(dtrace_aggregation_t *agg, dtrace_buffer_t *dbuf,
 		 * We just kludge up approximately 1/8th of the size to be
 		 * buckets.  If this guess ends up being routinely
 		 * off-the-mark, we may need to dynamically readjust this
-		 * based on past performance.
+		 * based on past performance.  The fraction can be tuned
+		 * via dtrace_agghashshift for workloads whose key
+		 * cardinality makes the default a poor fit.
 		 */
-		uintptr_t hashsize = (buf->dtb_size >> 3) / sizeof (uintptr_t);
+		int shift = dtrace_agghashshift;
+		uintptr_t hashsize;
+
+		if (shift < 1 || shift > 16)
+			shift = 3;
+		hashsize = (buf->dtb_size >> shift) / sizeof (uintptr_t);
 
 		if ((uintptr_t)agb - hashsize * sizeof (dtrace_aggkey_t *) <
 		    (uintptr_t)tomax || hashsize == 0) {
@@ -2540,7 +2548,8 @@ dtrace_aggregate(dtrace_aggregation_t *agg, dtrace_buffer_t *dbuf,
 	 */
 	ndx = hashval % agb->dtagb_hashsize;
 
-	for (key = agb->dtagb_hash[ndx]; key != NULL; key = key->dtak_next) {
+	for (key = agb->dtagb_hash[ndx]; key != NULL;
+	    prev = key, key = key->dtak_next) {
 		ASSERT((caddr_t)key >= tomax);
 		ASSERT((caddr_t)key < tomax + buf->dtb_size);
 
@@ -2581,8 +2590,19 @@ dtrace_aggregate(dtrace_aggregation_t *agg, dtrace_buffer_t *dbuf,
 
 		/*
 		 * This is a hit:  we need to apply the aggregator to
-		 * the value at this key.
+		 * the value at this key.  First move the key to the
+		 * front of its chain; with the skewed key popularity
+		 * typical of always-on profiling, this keeps hot keys
+		 * near the head and shortens the average chain walk.
+		 * (We own this CPU's buffer with interrupts disabled,
+		 * so the relink cannot race with anything.)
 		 */
+		if (prev != NULL) {
+			prev->dtak_next = key->dtak_next;
+			key->dtak_next = agb->dtagb_hash[ndx];
+			agb->dtagb_hash[ndx] = key;
+		}
+
 		agg->dtag_aggregate((uint64_t *)(kdata + size), expr, arg);
 		return;
 next:
@@ -16922,6 +16942,31 @@ dtrace_ioctl(dev_t dev, int cmd, intptr_t arg, int md, cred_t *cr, int *rv)
 			return (ENOENT);
 		}
 
+		/*
+		 * If there is nothing in this buffer -- no data, drops or
+		 * errors -- don't bother cross calling to switch it:  an
+		 * empty snapshot is indistinguishable from one taken an
+		 * instant earlier.  On large machines this spares a cross
+		 * call and a buffer switch per idle CPU per switch/aggrate
+		 * interval.  The unsynchronized reads are safe:  anything
+		 * recorded concurrently is simply consumed next interval.
+		 */
+		if (buf->dtb_offset == 0 && buf->dtb_drops == 0 &&
+		    buf->dtb_errors == 0) {
+			mutex_exit(&dtrace_lock);
+
+			desc.dtbd_size = 0;
+			desc.dtbd_drops = 0;
+			desc.dtbd_errors = 0;
+			desc.dtbd_oldest = 0;
+			desc.dtbd_timestamp = dtrace_gethrtime();
+
+			if (copyout(&desc, (void *)arg, sizeof (desc)) != 0)
+				return (EFAULT);
+
+			return (0);
+		}
+
 		cached = buf->dtb_tomax;
 		ASSERT(!(buf->dtb_flags & DTRACEBUF_NOSWITCH));
 
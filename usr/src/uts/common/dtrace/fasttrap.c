@@ -2157,9 +2157,22 @@ fasttrap_attach(dev_info_t *devi, ddi_attach_cmd_t cmd)
 	 * Conjure up the tracepoints hashtable...
 	 */
 	nent = ddi_getprop(DDI_DEV_T_ANY, devi, DDI_PROP_DONTPASS,
-	    "fasttrap-hash-size", FASTTRAP_TPOINTS_DEFAULT_SIZE);
+	    "fasttrap-hash-size", 0);
 
-	if (nent == 0 || nent > 0x1000000)
+	if (nent == 0) {
+		/*
+		 * In the absence of an explicit fasttrap-hash-size, scale
+		 * the table with the tracepoint limit rather than using a
+		 * fixed size:  tracing many USDT-heavy processes at once
+		 * can reach the limit, and the old fixed default then left
+		 * long chains for the probe-path lookup to walk.
+		 */
+		nent = fasttrap_max / 8;
+		if (nent < FASTTRAP_TPOINTS_DEFAULT_SIZE)
+			nent = FASTTRAP_TPOINTS_DEFAULT_SIZE;
+	}
+
+	if (nent > 0x1000000)
 		nent = FASTTRAP_TPOINTS_DEFAULT_SIZE;
 
 	if (ISP2(nent))
@@ -39,6 +39,7 @@
 #include <sys/user.h>
 #include <sys/errno.h>
 #include <sys/vnode.h>
+#include <sys/vfs.h>
 #include <sys/mman.h>
 #include <sys/kmem.h>
 #include <sys/proc.h>
@@ -46,6 +47,7 @@
 #include <sys/policy.h>
 #include <sys/cmn_err.h>
 #include <sys/systm.h>
+#include <sys/kstat.h>
 #include <sys/elf.h>
 #include <sys/vmsystm.h>
 #include <sys/debug.h>
@@ -89,6 +91,8 @@ static int getelfphdr(vnode_t *, cred_t *, const Ehdr *, uint_t, caddr_t *,
     size_t *);
 static int getelfshdr(vnode_t *, cred_t *, const Ehdr *, uint_t, uint_t,
     caddr_t *, size_t *, caddr_t *, size_t *);
+static int getelfhdrs(vnode_t *, cred_t *, Ehdr *, uint_t *, uint_t *,
+    uint_t *, caddr_t *, size_t *);
 static size_t elfsize(const Ehdr *, uint_t, const caddr_t, uintptr_t *);
 static int mapelfexec(vnode_t *, Ehdr *, uint_t, caddr_t, Phdr **, Phdr **,
     Phdr **, Phdr **, Phdr *, caddr_t *, caddr_t *, intptr_t *, uintptr_t *,
@@ -208,10 +212,8 @@ mapexec_brand(vnode_t *vp, uarg_t *args, Ehdr *ehdr, Addr *uphdr_vaddr,
 		return (error);
 	}
 
-	if ((error = getelfhead(vp, CRED(), ehdr, &nshdrs, &shstrndx,
-	    &nphdrs)) != 0 ||
-	    (error = getelfphdr(vp, CRED(), ehdr, nphdrs, &phdrbase,
-	    &phdrsize)) != 0) {
+	if ((error = getelfhdrs(vp, CRED(), ehdr, &nshdrs, &shstrndx,
+	    &nphdrs, &phdrbase, &phdrsize)) != 0) {
 		uprintf("%s: Cannot read %s\n", exec_file, args->pathname);
 		return (error);
 	}
@@ -323,10 +325,8 @@ elfexec(vnode_t *vp, execa_t *uap, uarg_t *args, intpdata_t *idatap,
 	/*
 	 * Obtain ELF and program header information.
 	 */
-	if ((error = getelfhead(vp, CRED(), ehdrp, &nshdrs, &shstrndx,
-	    &nphdrs)) != 0 ||
-	    (error = getelfphdr(vp, CRED(), ehdrp, nphdrs, &phdrbase,
-	    &phdrsize)) != 0)
+	if ((error = getelfhdrs(vp, CRED(), ehdrp, &nshdrs, &shstrndx,
+	    &nphdrs, &phdrbase, &phdrsize)) != 0)
 		goto out;
 
 	/*
@@ -783,10 +783,8 @@ elfexec(vnode_t *vp, execa_t *uap, uarg_t *args, intpdata_t *idatap,
 		 */
 		kmem_free(phdrbase, phdrsize);
 		phdrbase = NULL;
-		if ((error = getelfhead(nvp, CRED(), ehdrp, &nshdrs,
-		    &shstrndx, &nphdrs)) != 0 ||
-		    (error = getelfphdr(nvp, CRED(), ehdrp, nphdrs, &phdrbase,
-		    &phdrsize)) != 0) {
+		if ((error = getelfhdrs(nvp, CRED(), ehdrp, &nshdrs,
+		    &shstrndx, &nphdrs, &phdrbase, &phdrsize)) != 0) {
 			VN_RELE(nvp);
 			uprintf("%s: Cannot read %s\n", exec_file, dlnp);
 			goto bad;
@@ -1299,22 +1297,300 @@ getelfshdr(vnode_t *vp, cred_t *credp, const Ehdr *ehdr, uint_t nshdrs,
 	return (0);
 }
 
-int
-elfreadhdr(vnode_t *vp, cred_t *credp, Ehdr *ehdrp, uint_t *nphdrs,
-    caddr_t *phbasep, size_t *phsizep)
+/*
+ * Cache of validated ELF and program headers for frequently executed
+ * binaries, keyed by vnode and validated by file size and modification
+ * time.  Repeated execs of a hot executable (and of its interpreter,
+ * which is ld.so.1 for nearly every dynamic binary) skip rereading and
+ * revalidating the headers.  The cache holds its vnodes, as the dnlc
+ * does, so it is kept small, entries are evicted LRU to bound the
+ * number of pinned vnodes, and dounmount() purges the entries of an
+ * unmounting file system so the holds cannot make its unmount fail.
+ */
+#define	ELF_HDR_CACHE_SIZE	16
+
+typedef struct elf_hdr_cache {
+	vnode_t		*ehc_vp;	/* held; NULL for an empty entry */
+	u_offset_t	ehc_size;	/* va_size at insert time */
+	timestruc_t	ehc_mtime;	/* va_mtime at insert time */
+	hrtime_t	ehc_lastuse;	/* for LRU eviction */
+	Ehdr		ehc_ehdr;
+	uint_t		ehc_nshdrs;
+	uint_t		ehc_shstrndx;
+	uint_t		ehc_nphdrs;
+	caddr_t		ehc_phbase;
+	size_t		ehc_phsize;
+} elf_hdr_cache_t;
+
+static elf_hdr_cache_t elf_hdr_cache[ELF_HDR_CACHE_SIZE];
+static kmutex_t elf_hdr_cache_lock;
+static kstat_t *elf_hdr_cache_ksp;
+static uint_t elf_hdr_cache_ents;	/* occupied entries; lock to modify */
+
+#ifndef	_ELF32_COMPAT
+int elf_hdr_cache_disable = 0;
+#else
+extern int elf_hdr_cache_disable;
+#endif
+
+static struct elf_hdr_cache_kstat {
+	kstat_named_t	ehck_hits;
+	kstat_named_t	ehck_misses;
+	kstat_named_t	ehck_evictions;
+} elf_hdr_cache_stats = {
+	{ "hits",		KSTAT_DATA_UINT64 },
+	{ "misses",		KSTAT_DATA_UINT64 },
+	{ "evictions",		KSTAT_DATA_UINT64 },
+};
+
+void
+elf_hdr_cache_init(void)
+{
+	kstat_t *ksp;
+
+	ksp = kstat_create("elfexec", 0,
+#ifdef	_ELF32_COMPAT
+	    "elf32_hdr_cache",
+#else
+	    "elf_hdr_cache",
+#endif
+	    "misc", KSTAT_TYPE_NAMED,
+	    sizeof (elf_hdr_cache_stats) / sizeof (kstat_named_t),
+	    KSTAT_FLAG_VIRTUAL);
+	if (ksp != NULL) {
+		ksp->ks_data = &elf_hdr_cache_stats;
+		kstat_install(ksp);
+	}
+	elf_hdr_cache_ksp = ksp;
+}
+
+/*
+ * Release every cache entry whose vnode belongs to vfsp, or every entry
+ * when vfsp is NULL.  Called (through elf_hdr_cache_purge_hook) from
+ * dounmount() so that the cache's vnode holds cannot leave a file
+ * system busy forever, and with a NULL vfsp when the cache has been
+ * disabled or the module is unloading.
+ */
+void
+elf_hdr_cache_purge_vfsp(struct vfs *vfsp)
+{
+	elf_hdr_cache_t *ehc;
+	vnode_t *vps[ELF_HDR_CACHE_SIZE];
+	caddr_t phbases[ELF_HDR_CACHE_SIZE];
+	size_t phsizes[ELF_HDR_CACHE_SIZE];
+	int i, n = 0;
+
+	mutex_enter(&elf_hdr_cache_lock);
+	for (i = 0; i < ELF_HDR_CACHE_SIZE; i++) {
+		ehc = &elf_hdr_cache[i];
+		if (ehc->ehc_vp == NULL ||
+		    (vfsp != NULL && ehc->ehc_vp->v_vfsp != vfsp))
+			continue;
+		vps[n] = ehc->ehc_vp;
+		phbases[n] = ehc->ehc_phbase;
+		phsizes[n] = ehc->ehc_phsize;
+		n++;
+		bzero(ehc, sizeof (*ehc));
+		elf_hdr_cache_ents--;
+	}
+	mutex_exit(&elf_hdr_cache_lock);
+
+	/*
+	 * Release the vnodes after dropping the lock; releasing the last
+	 * hold can call back into the file system.
+	 */
+	for (i = 0; i < n; i++) {
+		kmem_free(phbases[i], phsizes[i]);
+		VN_RELE(vps[i]);
+	}
+}
+
+void
+elf_hdr_cache_fini(void)
+{
+	if (elf_hdr_cache_ksp != NULL) {
+		kstat_delete(elf_hdr_cache_ksp);
+		elf_hdr_cache_ksp = NULL;
+	}
+
+	elf_hdr_cache_purge_vfsp(NULL);
+}
+
+static int
+elf_hdr_cache_lookup(vnode_t *vp, const vattr_t *vap, Ehdr *ehdr,
+    uint_t *nshdrs, uint_t *shstrndx, uint_t *nphdrs, caddr_t *phbasep,
+    size_t *phsizep)
 {
+	elf_hdr_cache_t *ehc;
+	caddr_t phbase;
+	int i;
+
+	mutex_enter(&elf_hdr_cache_lock);
+	for (i = 0; i < ELF_HDR_CACHE_SIZE; i++) {
+		ehc = &elf_hdr_cache[i];
+		if (ehc->ehc_vp == vp)
+			break;
+	}
+	if (i == ELF_HDR_CACHE_SIZE) {
+		elf_hdr_cache_stats.ehck_misses.value.ui64++;
+		mutex_exit(&elf_hdr_cache_lock);
+		return (-1);
+	}
+
+	if (vap->va_size != ehc->ehc_size ||
+	    vap->va_mtime.tv_sec != ehc->ehc_mtime.tv_sec ||
+	    vap->va_mtime.tv_nsec != ehc->ehc_mtime.tv_nsec) {
+		/*
+		 * The executable changed since its headers were cached;
+		 * toss the entry and reread them.
+		 */
+		vnode_t *ovp = ehc->ehc_vp;
+		caddr_t ophbase = ehc->ehc_phbase;
+		size_t ophsize = ehc->ehc_phsize;
+
+		bzero(ehc, sizeof (*ehc));
+		elf_hdr_cache_ents--;
+		elf_hdr_cache_stats.ehck_misses.value.ui64++;
+		mutex_exit(&elf_hdr_cache_lock);
+		kmem_free(ophbase, ophsize);
+		VN_RELE(ovp);
+		return (-1);
+	}
+
+	/*
+	 * Hand the caller its own copy of the program headers since the
+	 * entry may be evicted as soon as the lock is dropped.
+	 */
+	if ((phbase = kmem_alloc(ehc->ehc_phsize, KM_NOSLEEP)) == NULL) {
+		elf_hdr_cache_stats.ehck_misses.value.ui64++;
+		mutex_exit(&elf_hdr_cache_lock);
+		return (-1);
+	}
+	bcopy(ehc->ehc_phbase, phbase, ehc->ehc_phsize);
+	*ehdr = ehc->ehc_ehdr;
+	*nshdrs = ehc->ehc_nshdrs;
+	*shstrndx = ehc->ehc_shstrndx;
+	*nphdrs = ehc->ehc_nphdrs;
+	*phbasep = phbase;
+	*phsizep = ehc->ehc_phsize;
+	ehc->ehc_lastuse = gethrtime();
+	elf_hdr_cache_stats.ehck_hits.value.ui64++;
+	mutex_exit(&elf_hdr_cache_lock);
+	return (0);
+}
+
+static void
+elf_hdr_cache_insert(vnode_t *vp, const vattr_t *vap, const Ehdr *ehdr,
+    uint_t nshdrs, uint_t shstrndx, uint_t nphdrs, const caddr_t phbase,
+    size_t phsize)
+{
+	elf_hdr_cache_t *ehc, *victim = NULL;
+	vnode_t *ovp = NULL;
+	caddr_t nphbase, ophbase = NULL;
+	size_t ophsize = 0;
+	int i;
+
+	if ((nphbase = kmem_alloc(phsize, KM_NOSLEEP)) == NULL)
+		return;
+	bcopy(phbase, nphbase, phsize);
+	VN_HOLD(vp);
+
+	mutex_enter(&elf_hdr_cache_lock);
+	for (i = 0; i < ELF_HDR_CACHE_SIZE; i++) {
+		ehc = &elf_hdr_cache[i];
+		if (ehc->ehc_vp == vp) {
+			/*
+			 * Another exec of the same binary beat us here;
+			 * keep its entry.
+			 */
+			mutex_exit(&elf_hdr_cache_lock);
+			kmem_free(nphbase, phsize);
+			VN_RELE(vp);
+			return;
+		}
+		if (victim == NULL || (victim->ehc_vp != NULL &&
+		    (ehc->ehc_vp == NULL ||
+		    ehc->ehc_lastuse < victim->ehc_lastuse)))
+			victim = ehc;
+	}
+	if (victim->ehc_vp != NULL) {
+		ovp = victim->ehc_vp;
+		ophbase = victim->ehc_phbase;
+		ophsize = victim->ehc_phsize;
+		elf_hdr_cache_stats.ehck_evictions.value.ui64++;
+	} else {
+		elf_hdr_cache_ents++;
+	}
+	victim->ehc_vp = vp;
+	victim->ehc_size = vap->va_size;
+	victim->ehc_mtime = vap->va_mtime;
+	victim->ehc_lastuse = gethrtime();
+	victim->ehc_ehdr = *ehdr;
+	victim->ehc_nshdrs = nshdrs;
+	victim->ehc_shstrndx = shstrndx;
+	victim->ehc_nphdrs = nphdrs;
+	victim->ehc_phbase = nphbase;
+	victim->ehc_phsize = phsize;
+	mutex_exit(&elf_hdr_cache_lock);
+
+	if (ovp != NULL) {
+		kmem_free(ophbase, ophsize);
+		VN_RELE(ovp);
+	}
+}
+
+/*
+ * Obtain the ELF header along with the entire program header, consulting
+ * the header cache first and inserting on a miss.
+ */
+static int
+getelfhdrs(vnode_t *vp, cred_t *credp, Ehdr *ehdr, uint_t *nshdrs,
+    uint_t *shstrndx, uint_t *nphdrs, caddr_t *phbasep, size_t *phsizep)
+{
+	vattr_t vattr;
+	boolean_t havattr = B_FALSE;
 	int error;
-	uint_t nshdrs, shstrndx;
 
-	if ((error = getelfhead(vp, credp, ehdrp, &nshdrs, &shstrndx,
+	if (elf_hdr_cache_disable == 0) {
+		vattr.va_mask = AT_SIZE | AT_MTIME;
+		if (VOP_GETATTR(vp, &vattr, 0, credp, NULL) == 0) {
+			havattr = B_TRUE;
+			if (elf_hdr_cache_lookup(vp, &vattr, ehdr, nshdrs,
+			    shstrndx, nphdrs, phbasep, phsizep) == 0)
+				return (0);
+		}
+	} else if (elf_hdr_cache_ents != 0) {
+		/*
+		 * Disabling the cache must also drop the vnode holds of
+		 * entries inserted while it was enabled; the unlocked
+		 * check keeps the disabled path away from the cache lock.
+		 */
+		elf_hdr_cache_purge_vfsp(NULL);
+	}
+
+	if ((error = getelfhead(vp, credp, ehdr, nshdrs, shstrndx,
 	    nphdrs)) != 0 ||
-	    (error = getelfphdr(vp, credp, ehdrp, *nphdrs, phbasep,
-	    phsizep)) != 0) {
+	    (error = getelfphdr(vp, credp, ehdr, *nphdrs, phbasep,
+	    phsizep)) != 0)
 		return (error);
-	}
+
+	if (havattr)
+		elf_hdr_cache_insert(vp, &vattr, ehdr, *nshdrs, *shstrndx,
+		    *nphdrs, *phbasep, *phsizep);
+
 	return (0);
 }
 
+int
+elfreadhdr(vnode_t *vp, cred_t *credp, Ehdr *ehdrp, uint_t *nphdrs,
+    caddr_t *phbasep, size_t *phsizep)
+{
+	uint_t nshdrs, shstrndx;
+
+	return (getelfhdrs(vp, credp, ehdrp, &nshdrs, &shstrndx, nphdrs,
+	    phbasep, phsizep));
+}
+
 static int
 mapelfexec(
 	vnode_t *vp,
@@ -2582,16 +2858,50 @@ static struct modlinkage modlinkage = {
 	NULL
 };
 
+/*
+ * dounmount() purges the ELF header caches through a hook since genunix
+ * cannot call into an exec module directly; the native and 32-bit caches
+ * hide behind a single entry point.
+ */
+static void
+elf_hdr_cache_purge(struct vfs *vfsp)
+{
+	elf_hdr_cache_purge_vfsp(vfsp);
+#ifdef	_LP64
+	elf32_hdr_cache_purge_vfsp(vfsp);
+#endif
+}
+
 int
 _init(void)
 {
-	return (mod_install(&modlinkage));
+	int error;
+
+	if ((error = mod_install(&modlinkage)) != 0)
+		return (error);
+
+	elf_hdr_cache_init();
+#ifdef	_LP64
+	elf32_hdr_cache_init();
+#endif
+	elf_hdr_cache_purge_hook = elf_hdr_cache_purge;
+	return (0);
 }
 
 int
 _fini(void)
 {
-	return (mod_remove(&modlinkage));
+	int error;
+
+	if ((error = mod_remove(&modlinkage)) != 0)
+		return (error);
+
+	elf_hdr_cache_purge_hook = NULL;
+	elf_hdr_cache_fini();
+#ifdef	_LP64
+	elf32_hdr_cache_fini();
+#endif
+	return (0);
 }
 
 int
@@ -92,6 +92,9 @@ typedef struct {
 #define	elfnote	elf32note
 #define	elfcore	elf32core
 #define	elfreadhdr		elf32readhdr
+#define	elf_hdr_cache_init	elf32_hdr_cache_init
+#define	elf_hdr_cache_fini	elf32_hdr_cache_fini
+#define	elf_hdr_cache_purge_vfsp	elf32_hdr_cache_purge_vfsp
 #define	mapexec_brand		mapexec32_brand
 #define	setup_note_header	setup_note_header32
 #define	write_elfnotes		write_elfnotes32
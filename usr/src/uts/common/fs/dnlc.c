@@ -183,6 +183,16 @@ uint64_t dnlc_max_nentries_cnt = 0; /* statistic on times we failed */
 #define	DNLC_LONG_CHAIN 8
 uint_t dnlc_long_chain = DNLC_LONG_CHAIN;
 
+/*
+ * Maximum age in seconds of a negative cache entry. Once a negative
+ * entry has been cached for longer than this, a lookup treats it as
+ * a miss and evicts it, forcing the file system to re-check whether
+ * the name now exists. Setting this to 0 disables negative entry
+ * aging, restoring the old behaviour where negative entries live
+ * until explicitly removed or reclaimed.
+ */
+uint_t dnlc_neg_ttl = 60;
+
 /*
  * ncstats has been deprecated, due to the integer size of the counters
  * which can easily overflow in the dnlc.
@@ -223,6 +233,10 @@ struct nc_stats ncs = {
 	{ "dir_fini_purge",		KSTAT_DATA_UINT64 },
 	{ "dir_reclaim_last",		KSTAT_DATA_UINT64 },
 	{ "dir_reclaim_any",		KSTAT_DATA_UINT64 },
+
+	/* negative entry aging */
+
+	{ "negative_cache_expired",	KSTAT_DATA_UINT64 },
 };
 
 static int doingcache = 1;
@@ -378,7 +392,7 @@ dnlc_init()
 	nc_hash = kmem_zalloc(nc_hashsz * sizeof (*nc_hash), KM_SLEEP);
 	for (i = 0; i < nc_hashsz; i++) {
 		hp = (nc_hash_t *)&nc_hash[i];
-		mutex_init(&hp->hash_lock, NULL, MUTEX_DEFAULT, NULL);
+		rw_init(&hp->hash_lock, NULL, RW_DEFAULT, NULL);
 		hp->hash_next = (ncache_t *)hp;
 		hp->hash_prev = (ncache_t *)hp;
 	}
@@ -460,13 +474,14 @@ dnlc_enter(vnode_t *dp, const char *name, vnode_t *vp)
 	VN_HOLD_DNLC(dp);
 	ncp->vp = vp;
 	VN_HOLD_DNLC(vp);
+	ncp->negtime = gethrestime_sec();
 	bcopy(name, ncp->name, namlen);
 	ncp->hash = hash;
 	hp = &nc_hash[hash & nc_hashmask];
 
-	mutex_enter(&hp->hash_lock);
+	rw_enter(&hp->hash_lock, RW_WRITER);
 	if (dnlc_search(dp, name, namlen, hash) != NULL) {
-		mutex_exit(&hp->hash_lock);
+		rw_exit(&hp->hash_lock);
 		ncstats.dbl_enters++;
 		ncs.ncs_dbl_enters.value.ui64++;
 		VN_RELE_DNLC(dp);
@@ -480,7 +495,7 @@ dnlc_enter(vnode_t *dp, const char *name, vnode_t *vp)
 	 * Insert back into the hash chain.
 	 */
 	nc_inshash(ncp, hp);
-	mutex_exit(&hp->hash_lock);
+	rw_exit(&hp->hash_lock);
 	ncstats.enters++;
 	ncs.ncs_enters.value.ui64++;
 	TRACE_2(TR_FAC_NFS, TR_DNLC_ENTER_END,
@@ -534,23 +549,25 @@ dnlc_update(vnode_t *dp, const char *name, vnode_t *vp)
 	VN_HOLD_DNLC(dp);
 	ncp->vp = vp;
 	VN_HOLD_DNLC(vp);
+	ncp->negtime = gethrestime_sec();
 	bcopy(name, ncp->name, namlen);
 	ncp->hash = hash;
 	hp = &nc_hash[hash & nc_hashmask];
 
-	mutex_enter(&hp->hash_lock);
+	rw_enter(&hp->hash_lock, RW_WRITER);
 	if ((tcp = dnlc_search(dp, name, namlen, hash)) != NULL) {
 		if (tcp->vp != vp) {
 			tvp = tcp->vp;
 			tcp->vp = vp;
-			mutex_exit(&hp->hash_lock);
+			tcp->negtime = ncp->negtime;
+			rw_exit(&hp->hash_lock);
 			VN_RELE_DNLC(tvp);
 			ncstats.enters++;
 			ncs.ncs_enters.value.ui64++;
 			TRACE_2(TR_FAC_NFS, TR_DNLC_ENTER_END,
 			    "dnlc_update_end:(%S) %d", "done", ncstats.enters);
 		} else {
-			mutex_exit(&hp->hash_lock);
+			rw_exit(&hp->hash_lock);
 			VN_RELE_DNLC(vp);
 			ncstats.dbl_enters++;
 			ncs.ncs_dbl_enters.value.ui64++;
@@ -566,7 +583,7 @@ dnlc_update(vnode_t *dp, const char *name, vnode_t *vp)
 	 * insert the new entry, since it is not in dnlc yet
 	 */
 	nc_inshash(ncp, hp);
-	mutex_exit(&hp->hash_lock);
+	rw_exit(&hp->hash_lock);
 	ncstats.enters++;
 	ncs.ncs_enters.value.ui64++;
 	TRACE_2(TR_FAC_NFS, TR_DNLC_ENTER_END,
@@ -603,7 +620,7 @@ dnlc_lookup(vnode_t *dp, const char *name)
 	DNLCHASH(name, dp, hash, namlen);
 	depth = 1;
 	hp = &nc_hash[hash & nc_hashmask];
-	mutex_enter(&hp->hash_lock);
+	rw_enter(&hp->hash_lock, RW_READER);
 
 	for (ncp = hp->hash_next; ncp != (ncache_t *)hp;
 	    ncp = ncp->hash_next) {
@@ -611,11 +628,34 @@ dnlc_lookup(vnode_t *dp, const char *name)
 		    ncp->dp == dp &&
 		    ncp->namlen == namlen &&
 		    bcmp(ncp->name, name, namlen) == 0) {
+			/*
+			 * A negative entry which has outlived its welcome
+			 * is treated as a miss and evicted, so a stale
+			 * non-existence claim can't linger indefinitely.
+			 */
+			if (ncp->vp == DNLC_NO_VNODE && dnlc_neg_ttl != 0 &&
+			    gethrestime_sec() - ncp->negtime >
+			    (time_t)dnlc_neg_ttl) {
+				rw_exit(&hp->hash_lock);
+				dnlc_remove(dp, name);
+				ncs.ncs_neg_expired.value.ui64++;
+				ncstats.misses++;
+				ncs.ncs_misses.value.ui64++;
+				TRACE_4(TR_FAC_NFS, TR_DNLC_LOOKUP_END,
+				    "dnlc_lookup_end:%S %d vp %x name %s",
+				    "miss", ncstats.misses, NULL, name);
+				return (NULL);
+			}
+
 			/*
 			 * Move this entry to the head of its hash chain
-			 * if it's not already close.
+			 * if it's not already close.  Lookups normally
+			 * only hold the bucket lock as reader; the move
+			 * is skipped rather than waited for if the
+			 * upgrade is contested.
 			 */
-			if (depth > NC_MOVETOFRONT) {
+			if (depth > NC_MOVETOFRONT &&
+			    rw_tryupgrade(&hp->hash_lock)) {
 				ncache_t *next = ncp->hash_next;
 				ncache_t *prev = ncp->hash_prev;
 
@@ -636,7 +676,7 @@ dnlc_lookup(vnode_t *dp, const char *name)
 			 */
 			vp = ncp->vp;
 			VN_HOLD_CALLER(vp);
-			mutex_exit(&hp->hash_lock);
+			rw_exit(&hp->hash_lock);
 			ncstats.hits++;
 			ncs.ncs_hits.value.ui64++;
 			if (vp == DNLC_NO_VNODE) {
@@ -650,7 +690,7 @@ dnlc_lookup(vnode_t *dp, const char *name)
 		depth++;
 	}
 
-	mutex_exit(&hp->hash_lock);
+	rw_exit(&hp->hash_lock);
 	ncstats.misses++;
 	ncs.ncs_misses.value.ui64++;
 	TRACE_4(TR_FAC_NFS, TR_DNLC_LOOKUP_END,
@@ -675,19 +715,19 @@ dnlc_remove(vnode_t *dp, const char *name)
 	DNLCHASH(name, dp, hash, namlen);
 	hp = &nc_hash[hash & nc_hashmask];
 
-	mutex_enter(&hp->hash_lock);
+	rw_enter(&hp->hash_lock, RW_WRITER);
 	if (ncp = dnlc_search(dp, name, namlen, hash)) {
 		/*
 		 * Free up the entry
 		 */
 		nc_rmhash(ncp);
-		mutex_exit(&hp->hash_lock);
+		rw_exit(&hp->hash_lock);
 		VN_RELE_DNLC(ncp->vp);
 		VN_RELE_DNLC(ncp->dp);
 		dnlc_free(ncp);
 		return;
 	}
-	mutex_exit(&hp->hash_lock);
+	rw_exit(&hp->hash_lock);
 }
 
 /*
@@ -710,7 +750,7 @@ dnlc_purge()
 
 	for (nch = nc_hash; nch < &nc_hash[nc_hashsz]; nch++) {
 		index = 0;
-		mutex_enter(&nch->hash_lock);
+		rw_enter(&nch->hash_lock, RW_WRITER);
 		ncp = nch->hash_next;
 		while (ncp != (ncache_t *)nch) {
 			ncache_t *np;
@@ -726,7 +766,7 @@ dnlc_purge()
 			if (index == DNLC_MAX_RELE)
 				break;
 		}
-		mutex_exit(&nch->hash_lock);
+		rw_exit(&nch->hash_lock);
 
 		/* Release holds on all the vnodes now that we have no locks */
 		for (i = 0; i < index; i++) {
@@ -763,7 +803,7 @@ dnlc_purge_vp(vnode_t *vp)
 
 	for (nch = nc_hash; nch < &nc_hash[nc_hashsz]; nch++) {
 		index = 0;
-		mutex_enter(&nch->hash_lock);
+		rw_enter(&nch->hash_lock, RW_WRITER);
 		ncp = nch->hash_next;
 		while (ncp != (ncache_t *)nch) {
 			ncache_t *np;
@@ -782,7 +822,7 @@ dnlc_purge_vp(vnode_t *vp)
 			}
 			ncp = np;
 		}
-		mutex_exit(&nch->hash_lock);
+		rw_exit(&nch->hash_lock);
 
 		/* Release holds on all the vnodes now that we have no locks */
 		while (index) {
@@ -823,7 +863,7 @@ dnlc_purge_vfsp(vfs_t *vfsp, int count)
 
 	for (nch = nc_hash; nch < &nc_hash[nc_hashsz]; nch++) {
 		index = 0;
-		mutex_enter(&nch->hash_lock);
+		rw_enter(&nch->hash_lock, RW_WRITER);
 		ncp = nch->hash_next;
 		while (ncp != (ncache_t *)nch) {
 			ncache_t *np;
@@ -849,7 +889,7 @@ dnlc_purge_vfsp(vfs_t *vfsp, int count)
 			}
 			ncp = np;
 		}
-		mutex_exit(&nch->hash_lock);
+		rw_exit(&nch->hash_lock);
 		/* Release holds on all the vnodes now that we have no locks */
 		for (i = 0; i < index; i++) {
 			VN_RELE_DNLC(nc_rele[i]);
@@ -899,7 +939,7 @@ dnlc_fs_purge1(vnodeops_t *vop)
 		dnlc_purge_fs1_rotor = hp;
 		if (hp->hash_next == (ncache_t *)hp)
 			continue;
-		mutex_enter(&hp->hash_lock);
+		rw_enter(&hp->hash_lock, RW_WRITER);
 		for (ncp = hp->hash_prev;
 		    ncp != (ncache_t *)hp;
 		    ncp = ncp->hash_prev) {
@@ -910,14 +950,14 @@ dnlc_fs_purge1(vnodeops_t *vop)
 		}
 		if (ncp != (ncache_t *)hp) {
 			nc_rmhash(ncp);
-			mutex_exit(&hp->hash_lock);
+			rw_exit(&hp->hash_lock);
 			VN_RELE_DNLC(ncp->dp);
 			VN_RELE_DNLC(vp)
 			dnlc_free(ncp);
 			ncs.ncs_purge_total.value.ui64++;
 			return (1);
 		}
-		mutex_exit(&hp->hash_lock);
+		rw_exit(&hp->hash_lock);
 	} while (hp != end);
 	return (0);
 }
@@ -1040,7 +1080,7 @@ do_dnlc_reduce_cache(void *reduce_percent)
 			return;
 		}
 
-		mutex_enter(&hp->hash_lock);
+		rw_enter(&hp->hash_lock, RW_WRITER);
 		for (cnt = 0, ncp = hp->hash_prev; ncp != (ncache_t *)hp;
 		    ncp = ncp->hash_prev, cnt++) {
 			vp = ncp->vp;
@@ -1067,7 +1107,7 @@ do_dnlc_reduce_cache(void *reduce_percent)
 		}
 		/* check for race and continue */
 		if (hp->hash_next == (ncache_t *)hp) {
-			mutex_exit(&hp->hash_lock);
+			rw_exit(&hp->hash_lock);
 			continue;
 		}
 
@@ -1079,7 +1119,7 @@ found:
 		 * Remove from hash chain.
 		 */
 		nc_rmhash(ncp);
-		mutex_exit(&hp->hash_lock);
+		rw_exit(&hp->hash_lock);
 		VN_RELE_DNLC(vp);
 		VN_RELE_DNLC(ncp->dp);
 		dnlc_free(ncp);
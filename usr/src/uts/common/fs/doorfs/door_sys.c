@@ -343,6 +343,7 @@ static int door_overflow(kthread_t *, caddr_t, size_t, door_desc_t *, uint_t);
 static int door_args(kthread_t *, int);
 static int door_results(kthread_t *, caddr_t, size_t, door_desc_t *, uint_t);
 static int door_copy(struct as *, caddr_t, caddr_t, uint_t);
+static int door_copy_range(struct as *, caddr_t, caddr_t, size_t);
 static void	door_server_exit(proc_t *, kthread_t *);
 static void	door_release_server(door_node_t *, kthread_t *);
 static kthread_t	*door_get_server(door_node_t *);
@@ -2498,6 +2499,19 @@ door_args(kthread_t *server, int is_private)
 			dest = st->d_layout.dl_datap;
 			base = (uintptr_t)dest;
 
+			/*
+			 * Try to lock the whole destination region down at
+			 * once and copy straight through; this amortizes
+			 * the page locking cost over the full argument
+			 * region.  If that isn't possible, fall back to the
+			 * page-at-a-time path below.
+			 */
+			error = door_copy_range(as, src, dest, len);
+			if (error > 0)
+				return (error);
+			else if (error == 0)
+				len = 0;	/* all copied; skip loop */
+
 			/*
 			 * Copy data directly into server.  We proceed
 			 * downward from the top of the stack, to mimic
@@ -3083,6 +3097,77 @@ door_copy(struct as *as, caddr_t src, caddr_t dest, uint_t len)
 	return (error);
 }
 
+/*
+ * Transfer an argument region from the client into the server's address
+ * space, locking the whole destination range down with a single
+ * as_pagelock() rather than paying a lock/unlock round trip per page as
+ * door_copy() does.  Returns an errno value, or -1 if the range could
+ * not be locked as a unit (e.g. no shadow page list was available), in
+ * which case the caller should fall back to the page-at-a-time path.
+ */
+static int
+door_copy_range(struct as *as, caddr_t src, caddr_t dest, size_t len)
+{
+	caddr_t	rdest;
+	caddr_t	kaddr;
+	page_t	**pplist;
+	size_t	rlen;
+	size_t	off;
+	size_t	pgidx;
+	int	error = 0;
+
+	off = (uintptr_t)dest & PAGEOFFSET;	/* offset within first page */
+	rdest = (caddr_t)((uintptr_t)dest &
+	    (uintptr_t)PAGEMASK);	/* Page boundary */
+	rlen = P2ROUNDUP(off + len, PAGESIZE);
+
+	/*
+	 * Lock down the whole destination region.  If it can't be locked
+	 * as a unit (crosses into unmapped space, hits the guard page,
+	 * etc.), let the caller take the per-page path, which fails at
+	 * the precise page involved.
+	 */
+	if (as_pagelock(as, &pplist, rdest, rlen, S_WRITE) != 0)
+		return (-1);
+	if (pplist == NULL) {
+		/*
+		 * No shadow page list; finding each page_t would cost as
+		 * much as door_copy() anyway.
+		 */
+		as_pageunlock(as, pplist, rdest, rlen, S_WRITE);
+		return (-1);
+	}
+
+	for (pgidx = 0; len != 0; pgidx++) {
+		size_t	amount = MIN(len, PAGESIZE - off);
+		page_t	*pp = pplist[pgidx];
+
+		if (kpm_enable)
+			kaddr = (caddr_t)hat_kpm_mapin(pp, (struct kpme *)NULL);
+		else
+			kaddr = (caddr_t)ppmapin(pp, PROT_READ | PROT_WRITE,
+			    (caddr_t)-1);
+
+		if (copyin_nowatch(src, kaddr + off, amount) != 0)
+			error = EFAULT;
+
+		if (kpm_enable)
+			hat_kpm_mapout(pp, (struct kpme *)NULL, kaddr);
+		else
+			ppmapout(kaddr);
+
+		if (error != 0)
+			break;
+
+		src += amount;
+		len -= amount;
+		off = 0;
+	}
+
+	as_pageunlock(as, pplist, rdest, rlen, S_WRITE);
+	return (error);
+}
+
 /*
  * General kernel upcall using doors
  *	Returns 0 on success, errno for failures.
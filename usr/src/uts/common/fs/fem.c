@@ -421,6 +421,16 @@ fem_release(struct fem_list *sp)
  * method, the corresponding 'head' routine should unearth the base method
  * and invoke it directly rather than bypassing the function.
  *
+ * Note that these routines are only ever reached while a monitor stack is
+ * (or was very recently) installed.  When the first monitor is pushed onto
+ * an object, fem_push_node() swaps the object's operations vector to point
+ * at this table; when the last monitor is removed, remove_node() restores
+ * the underlying file system's operations vector, so objects without
+ * monitors dispatch their operations directly and pay no interposition
+ * cost at all.  The femh_list == NULL case below only covers the window
+ * where a caller loaded the old operations vector just as the last monitor
+ * was being removed.
+ *
  * All the functions are virtually the same, save for names, types & args.
  *  1. get a reference to the monitor stack for this object.
  *  2. store the top of stack into the femarg structure.
@@ -3048,6 +3058,14 @@ fem_push_node(
 				fem_unlock(hd);
 			} else {
 				hd->femh_list = list;
+				/*
+				 * Publish the list before swinging the
+				 * object's operations vector over to the
+				 * interposition table; a 'head' routine
+				 * entered via the new vector must find
+				 * the list installed.
+				 */
+				membar_producer();
 				*baseops = FEM_HEAD(type);
 				retry = 0;
 			}
@@ -3155,6 +3173,14 @@ remove_node(struct fem_list *sp, void **baseops, void *opset, void *datap)
 	}
 	if (--(sp->feml_tos) == 1) { /* Empty, restore ops */
 		*baseops = sp->feml_nodes[1].fn_op.anon;
+		/*
+		 * The restored operations vector must be globally visible
+		 * before the caller unpublishes the (now empty) list, so
+		 * that a 'head' routine which raced in on the old vector
+		 * and finds femh_list == NULL reads the restored base ops
+		 * rather than recursing into itself.
+		 */
+		membar_producer();
 	}
 	return (0);
 }
@@ -3187,7 +3213,11 @@ fem_remove_node(struct fem_head *fh, void **baseops, void *opset, void *datap)
 				 */
 				fem_release(sp);
 				fh->femh_list = NULL;
-				/* XXX - Do we need a membar_producer() call? */
+				/*
+				 * No barrier needed here; remove_node()
+				 * issued a membar_producer() after it
+				 * restored the base operations vector.
+				 */
 			}
 			fem_unlock(fh);
 		} else {
@@ -210,9 +210,11 @@ hsfs_read(struct vnode *vp, struct uio *uiop, int ioflag, struct cred *cred,
 		 */
 		size_t nbytes;
 		offset_t mapon;
+		offset_t off;
 		size_t n;
 		uint_t flags;
 
+		off = uiop->uio_loffset & (offset_t)MAXBMASK;
 		mapon = uiop->uio_loffset & MAXBOFFSET;
 		diff = filesize - uiop->uio_loffset;
 		nbytes = (size_t)MIN(MAXBSIZE - mapon, uiop->uio_resid);
@@ -222,10 +224,19 @@ hsfs_read(struct vnode *vp, struct uio *uiop, int ioflag, struct cred *cred,
 			return (0);
 		}
 
-		base = segmap_getmapflt(segkmap, vp,
-		    (u_offset_t)uiop->uio_loffset, n, 1, S_READ);
+		if (vpm_enable) {
+			/*
+			 * Copy data directly through the kpm mappings
+			 * of the cached pages, bypassing segmap.
+			 */
+			error = vpm_data_copy(vp, (u_offset_t)(off + mapon),
+			    n, uiop, 1, NULL, 0, S_READ);
+		} else {
+			base = segmap_getmapflt(segkmap, vp,
+			    (u_offset_t)uiop->uio_loffset, n, 1, S_READ);
 
-		error = uiomove(base + mapon, n, UIO_READ, uiop);
+			error = uiomove(base + mapon, n, UIO_READ, uiop);
+		}
 
 		if (error == 0) {
 			/*
@@ -238,9 +249,20 @@ hsfs_read(struct vnode *vp, struct uio *uiop, int ioflag, struct cred *cred,
 			else
 				flags = 0;
 
-			error = segmap_release(segkmap, base, flags);
-		} else
-			(void) segmap_release(segkmap, base, 0);
+			if (vpm_enable) {
+				error = vpm_sync_pages(vp, (u_offset_t)off,
+				    n, flags);
+			} else {
+				error = segmap_release(segkmap, base, flags);
+			}
+		} else {
+			if (vpm_enable) {
+				(void) vpm_sync_pages(vp, (u_offset_t)off,
+				    n, 0);
+			} else {
+				(void) segmap_release(segkmap, base, 0);
+			}
+		}
 	} while (error == 0 && uiop->uio_resid > 0);
 
 	return (error);
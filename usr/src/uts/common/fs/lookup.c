@@ -54,6 +54,9 @@
 #include <sys/sysmacros.h>
 #include <sys/debug.h>
 #include <sys/dirent.h>
+#include <sys/kmem.h>
+#include <sys/kstat.h>
+#include <sys/atomic.h>
 #include <c2/audit.h>
 #include <sys/zone.h>
 #include <sys/dnlc.h>
@@ -62,6 +65,272 @@
 /* Controls whether paths are stored with vnodes. */
 int vfs_vnode_path = 1;
 
+/*
+ * Full path lookup cache.
+ *
+ * Pathname resolution walks a name one component at a time, paying a
+ * directory access check and a dnlc or VOP_LOOKUP probe per component.
+ * For workloads that repeatedly open the same deep paths this adds up,
+ * so successfully resolved paths are also remembered whole, keyed on
+ * (root vnode, starting vnode, pathname, credential), and a repeat
+ * lookup of the same key is satisfied with a single hash probe.
+ *
+ * Correctness is maintained with a global generation number. Every
+ * rename, remove, rmdir and mount-over event (see the vnevent hooks in
+ * vnode.c) bumps the generation, and entries cached under an older
+ * generation are treated as misses and discarded. This is coarse - any
+ * namespace change invalidates the whole cache - but namespace changes
+ * are rare next to opens of hot paths, and the hit/miss kstats below
+ * make the tradeoff observable. Unmount purges the cache outright so
+ * cached references never hold a file system busy.
+ *
+ * Because a hit bypasses the per-component directory access checks, an
+ * entry is only served to the credential that originally walked the
+ * path, and entries expire after pathcache_ttl seconds so a permission
+ * change on an intermediate directory (which bumps no generation) is
+ * honored within a bounded window. Lookups that are audited, want the
+ * parent vnode, want the resolved path, or do not follow symlinks
+ * bypass the cache entirely.
+ *
+ * That bounded window is still a change to permission semantics: with
+ * the cache on, revoking search permission on an intermediate
+ * directory can take up to pathcache_ttl seconds to be enforced for
+ * paths already cached. The cache therefore ships disabled and is
+ * opted into by administrators who accept that window.
+ */
+int pathcache_enable = 0;
+uint_t pathcache_ttl = 30;	/* max entry age in seconds */
+
+#define	PC_NHASH	256	/* number of hash buckets; power of two */
+#define	PC_CHAINLEN	4	/* max entries per bucket */
+
+typedef struct pathcache_ent {
+	struct pathcache_ent *pc_next;	/* hash chain, MRU first */
+	vnode_t		*pc_vp;		/* result vnode, held */
+	vnode_t		*pc_rootvp;	/* root vnode key, held */
+	vnode_t		*pc_startvp;	/* starting vnode key, held */
+	cred_t		*pc_cr;		/* credential key, held */
+	uint64_t	pc_gen;		/* pathcache_gen when cached */
+	time_t		pc_time;	/* when cached, for pathcache_ttl */
+	size_t		pc_len;		/* length of pc_path */
+	char		pc_path[1];	/* variable length pathname */
+} pathcache_ent_t;
+
+typedef struct pathcache_bucket {
+	pathcache_ent_t	*pb_chain;
+	kmutex_t	pb_lock;
+} pathcache_bucket_t;
+
+static pathcache_bucket_t pathcache_hash[PC_NHASH];
+static volatile uint64_t pathcache_gen;
+
+static struct pathcache_stats {
+	kstat_named_t	pcs_hits;
+	kstat_named_t	pcs_misses;
+	kstat_named_t	pcs_inserts;
+	kstat_named_t	pcs_evictions;
+	kstat_named_t	pcs_invalidations;
+} pathcache_stats = {
+	{ "hits",		KSTAT_DATA_UINT64 },
+	{ "misses",		KSTAT_DATA_UINT64 },
+	{ "inserts",		KSTAT_DATA_UINT64 },
+	{ "evictions",		KSTAT_DATA_UINT64 },
+	{ "invalidations",	KSTAT_DATA_UINT64 },
+};
+
+static int
+pathcache_hashval(vnode_t *startvp, const char *path, size_t len)
+{
+	int hash = (int)(uintptr_t)startvp >> 3;
+
+	while (len-- != 0)
+		hash = (hash << 4) + hash + *path++;
+	return (hash & (PC_NHASH - 1));
+}
+
+/*
+ * Free an entry which has been unlinked from its hash chain. The vnode
+ * and credential releases can block, so callers must have dropped the
+ * bucket lock.
+ */
+static void
+pathcache_free(pathcache_ent_t *pcp)
+{
+	VN_RELE(pcp->pc_vp);
+	VN_RELE(pcp->pc_rootvp);
+	VN_RELE(pcp->pc_startvp);
+	crfree(pcp->pc_cr);
+	kmem_free(pcp, sizeof (pathcache_ent_t) + pcp->pc_len);
+}
+
+/*
+ * Look for a previously resolved path. Returns the held result vnode,
+ * or NULL on a miss. Stale entries found along the way are discarded.
+ */
+static vnode_t *
+pathcache_lookup(vnode_t *rootvp, vnode_t *startvp, const char *path,
+    size_t len, cred_t *cr)
+{
+	pathcache_bucket_t *pbp;
+	pathcache_ent_t *pcp, **prevpp;
+	pathcache_ent_t *dead = NULL;
+	vnode_t *vp = NULL;
+
+	pbp = &pathcache_hash[pathcache_hashval(startvp, path, len)];
+	mutex_enter(&pbp->pb_lock);
+	prevpp = &pbp->pb_chain;
+	while ((pcp = *prevpp) != NULL) {
+		if (pcp->pc_gen != pathcache_gen ||
+		    gethrestime_sec() - pcp->pc_time > (time_t)pathcache_ttl) {
+			*prevpp = pcp->pc_next;
+			pcp->pc_next = dead;
+			dead = pcp;
+			continue;
+		}
+		if (pcp->pc_len == len && pcp->pc_startvp == startvp &&
+		    pcp->pc_rootvp == rootvp && pcp->pc_cr == cr &&
+		    bcmp(pcp->pc_path, path, len) == 0) {
+			/*
+			 * Move the entry to the front of its chain so
+			 * eviction takes the coldest entry.
+			 */
+			*prevpp = pcp->pc_next;
+			pcp->pc_next = pbp->pb_chain;
+			pbp->pb_chain = pcp;
+			vp = pcp->pc_vp;
+			VN_HOLD(vp);
+			break;
+		}
+		prevpp = &pcp->pc_next;
+	}
+	mutex_exit(&pbp->pb_lock);
+
+	while ((pcp = dead) != NULL) {
+		dead = pcp->pc_next;
+		pathcache_free(pcp);
+	}
+	if (vp != NULL)
+		pathcache_stats.pcs_hits.value.ui64++;
+	else
+		pathcache_stats.pcs_misses.value.ui64++;
+	return (vp);
+}
+
+/*
+ * Remember a successful resolution of path to vp. Holds are taken here
+ * on the vnodes and credential; the caller keeps its own references.
+ * gen is the caller's pre-walk snapshot of pathcache_gen: the entry
+ * must be stamped with the generation in effect before the walk began,
+ * not the current one, so that a rename or remove that fired while the
+ * walk was in progress (and may have made its result stale) still
+ * invalidates the entry.
+ */
+static void
+pathcache_insert(vnode_t *rootvp, vnode_t *startvp, const char *path,
+    size_t len, cred_t *cr, vnode_t *vp, uint64_t gen)
+{
+	pathcache_bucket_t *pbp;
+	pathcache_ent_t *pcp, *tcp, **prevpp;
+	int depth;
+
+	/*
+	 * Already invalidated; don't bother caching a dead entry.
+	 */
+	if (gen != pathcache_gen)
+		return;
+
+	pcp = kmem_alloc(sizeof (pathcache_ent_t) + len, KM_NOSLEEP);
+	if (pcp == NULL)
+		return;
+	pcp->pc_vp = vp;
+	VN_HOLD(vp);
+	pcp->pc_rootvp = rootvp;
+	VN_HOLD(rootvp);
+	pcp->pc_startvp = startvp;
+	VN_HOLD(startvp);
+	pcp->pc_cr = cr;
+	crhold(cr);
+	pcp->pc_gen = gen;
+	pcp->pc_time = gethrestime_sec();
+	pcp->pc_len = len;
+	bcopy(path, pcp->pc_path, len);
+
+	pbp = &pathcache_hash[pathcache_hashval(startvp, path, len)];
+	mutex_enter(&pbp->pb_lock);
+	pcp->pc_next = pbp->pb_chain;
+	pbp->pb_chain = pcp;
+
+	/*
+	 * Trim the chain back to PC_CHAINLEN entries, dropping from
+	 * the cold end.
+	 */
+	depth = 1;
+	prevpp = &pcp->pc_next;
+	while ((tcp = *prevpp) != NULL) {
+		if (++depth > PC_CHAINLEN) {
+			*prevpp = tcp->pc_next;
+			mutex_exit(&pbp->pb_lock);
+			pathcache_free(tcp);
+			pathcache_stats.pcs_evictions.value.ui64++;
+			mutex_enter(&pbp->pb_lock);
+			break;
+		}
+		prevpp = &tcp->pc_next;
+	}
+	mutex_exit(&pbp->pb_lock);
+	pathcache_stats.pcs_inserts.value.ui64++;
+}
+
+/*
+ * A rename, remove, rmdir or mount has changed the namespace; existing
+ * entries may now resolve incorrectly, so expire them all. Called from
+ * the vnevent hooks in vnode.c.
+ */
+void
+pathcache_inval(void)
+{
+	atomic_inc_64((uint64_t *)&pathcache_gen);
+	pathcache_stats.pcs_invalidations.value.ui64++;
+}
+
+/*
+ * Drop every cached entry and its vnode holds. Called from dounmount()
+ * so the cache never keeps a file system busy.
+ */
+void
+pathcache_purge(void)
+{
+	pathcache_bucket_t *pbp;
+	pathcache_ent_t *pcp, *dead;
+	int i;
+
+	for (i = 0; i < PC_NHASH; i++) {
+		pbp = &pathcache_hash[i];
+		mutex_enter(&pbp->pb_lock);
+		dead = pbp->pb_chain;
+		pbp->pb_chain = NULL;
+		mutex_exit(&pbp->pb_lock);
+		while ((pcp = dead) != NULL) {
+			dead = pcp->pc_next;
+			pathcache_free(pcp);
+		}
+	}
+}
+
+void
+pathcache_init(void)
+{
+	kstat_t *ksp;
+
+	ksp = kstat_create("unix", 0, "pathcache", "misc", KSTAT_TYPE_NAMED,
+	    sizeof (pathcache_stats) / sizeof (kstat_named_t),
+	    KSTAT_FLAG_VIRTUAL);
+	if (ksp) {
+		ksp->ks_data = (void *)&pathcache_stats;
+		kstat_install(ksp);
+	}
+}
+
 int
 lookupname(
 	char *fnamep,
@@ -147,6 +416,11 @@ lookuppnatcred(
 	vnode_t *vp;	/* current directory vp */
 	vnode_t *rootvp;
 	proc_t *p = curproc;
+	char *savepath = NULL;
+	size_t savelen = 0;
+	uint64_t gen = 0;
+	int cacheable;
+	int error;
 
 	if (pnp->pn_pathlen == 0)
 		return (ENOENT);
@@ -175,8 +449,67 @@ lookuppnatcred(
 		} while (pnp->pn_path[0] == '/');
 	}
 
-	return (lookuppnvp(pnp, rpnp, followlink, dirvpp,
-	    compvpp, rootvp, vp, cr));
+	/*
+	 * Try the full path lookup cache. Only plain, symlink-following
+	 * lookups of the component vnode are eligible; anything wanting
+	 * the parent vnode, the resolved path, or per-component audit
+	 * records takes the long way.
+	 */
+	cacheable = (pathcache_enable && followlink == FOLLOW &&
+	    dirvpp == NULL && rpnp == NULL && !AU_AUDITING());
+	if (cacheable) {
+		vnode_t *cvp;
+
+		cvp = pathcache_lookup(rootvp, vp, pnp->pn_path,
+		    pnp->pn_pathlen, cr);
+		if (cvp != NULL) {
+			VN_RELE(vp);
+			if (rootvp != rootdir)
+				VN_RELE(rootvp);
+			pn_setlast(pnp);
+			if (compvpp != NULL)
+				*compvpp = cvp;
+			else
+				VN_RELE(cvp);
+			return (0);
+		}
+
+		/*
+		 * Snapshot the path, the key vnodes, and the
+		 * invalidation generation now: lookuppnvp() consumes
+		 * its holds and may rewrite the pathname while
+		 * expanding symlinks, and the entry must carry the
+		 * pre-walk generation so a namespace change during the
+		 * walk invalidates it (see pathcache_insert()).
+		 */
+		if (compvpp != NULL) {
+			savelen = pnp->pn_pathlen;
+			savepath = kmem_alloc(savelen, KM_NOSLEEP);
+			if (savepath != NULL) {
+				gen = pathcache_gen;
+				bcopy(pnp->pn_path, savepath, savelen);
+				VN_HOLD(vp);
+				if (rootvp != rootdir)
+					VN_HOLD(rootvp);
+			}
+		}
+	}
+
+	if (savepath == NULL) {
+		return (lookuppnvp(pnp, rpnp, followlink, dirvpp,
+		    compvpp, rootvp, vp, cr));
+	}
+
+	error = lookuppnvp(pnp, rpnp, followlink, dirvpp,
+	    compvpp, rootvp, vp, cr);
+	if (error == 0)
+		pathcache_insert(rootvp, vp, savepath, savelen, cr, *compvpp,
+		    gen);
+	VN_RELE(vp);
+	if (rootvp != rootdir)
+		VN_RELE(rootvp);
+	kmem_free(savepath, savelen);
+	return (error);
 }
 
 int
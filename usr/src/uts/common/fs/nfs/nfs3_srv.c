@@ -89,6 +89,7 @@ static void	vattr_to_wcc_data(struct vattr *, struct vattr *, wcc_data *);
 static int	rdma_setup_read_data3(READ3args *, READ3resok *);
 
 extern int nfs_loaned_buffers;
+extern uint_t nfs_loaned_buffers_min;
 
 u_longlong_t nfs3_srv_caller_id;
 
@@ -1002,8 +1003,9 @@ rfs3_read(READ3args *args, READ3res *resp, struct exportinfo *exi,
 		rdma_used = 1;
 	}
 
-	/* use loaned buffers for TCP */
-	loaned_buffers = (nfs_loaned_buffers && !rdma_used) ? 1 : 0;
+	/* use loaned buffers for large TCP reads */
+	loaned_buffers = (nfs_loaned_buffers && !rdma_used &&
+	    args->count >= nfs_loaned_buffers_min) ? 1 : 0;
 
 	if (is_system_labeled()) {
 		bslabel_t *clabel = req->rq_label;
@@ -2023,7 +2023,7 @@ noasync:
 	 * Indicate that no one is trying to fill this entry and
 	 * it still needs to be filled.
 	 */
-	rdc->flags &= ~RDDIR;
+	rdc->flags &= ~(RDDIR | RDDIRRA);
 	rdc->flags |= RDDIRREQ;
 	rddir4_cache_rele(rp, rdc);
 	mutex_exit(&rp->r_statelock);
@@ -94,6 +94,7 @@ static int rfs4_maxlock_tries = RFS4_MAXLOCK_TRIES;
 static clock_t  rfs4_lock_delay = RFS4_LOCK_DELAY;
 extern struct svc_ops rdma_svc_ops;
 extern int nfs_loaned_buffers;
+extern uint_t nfs_loaned_buffers_min;
 /* End of Tunables */
 
 static int rdma_setup_read_data4(READ4args *, READ4res *);
@@ -2248,6 +2249,193 @@ nfs4_ntov_table_free(struct nfs4_ntov_table *ntovp,
 	kmem_free(ntovp->na, sizeof (union nfs4_attr_u) * nfs4_ntov_map_size);
 }
 
+/*
+ * GETATTR result cache.
+ *
+ * Metadata-heavy clients issue GETATTR compounds for the same files
+ * far more often than those files change, and the cost is all in
+ * attribute assembly (a vnode op per requested attribute group) and
+ * XDR encoding. Since the NFSv4 change attribute is derived from
+ * ctime, a previously encoded attrlist is still exactly what the
+ * protocol would return as long as the file's ctime and the requested
+ * bitmap are unchanged, so finished encodings are remembered keyed on
+ * (filehandle, ctime, bitmap) and repeated requests are answered with
+ * a copy of the cached bytes. Any modification a client could observe
+ * moves ctime and therefore the key; attributes that can change
+ * without a ctime update (atime, file system space and quota counts)
+ * disqualify a request from caching, as do referrals and pseudo
+ * export namespaces whose change attribute also follows the export
+ * list. Entries are displaced by newer ones on hash collision, so the
+ * cache needs no explicit invalidation and holds no vnode references.
+ */
+int rfs4_attrcache_enable = 1;
+uint64_t rfs4_attrcache_hits;
+uint64_t rfs4_attrcache_misses;
+
+#define	RFS4_AC_NBUCKET		256	/* must be power of 2 */
+#define	RFS4_AC_CHAINLEN	4
+
+#define	RFS4_AC_VOLATILE	(FATTR4_TIME_ACCESS_MASK | \
+	FATTR4_RDATTR_ERROR_MASK | FATTR4_SPACE_AVAIL_MASK | \
+	FATTR4_SPACE_FREE_MASK | FATTR4_SPACE_TOTAL_MASK | \
+	FATTR4_FILES_AVAIL_MASK | FATTR4_FILES_FREE_MASK | \
+	FATTR4_FILES_TOTAL_MASK | FATTR4_QUOTA_AVAIL_HARD_MASK | \
+	FATTR4_QUOTA_AVAIL_SOFT_MASK | FATTR4_QUOTA_USED_MASK)
+
+typedef struct rfs4_attr_cent {
+	struct rfs4_attr_cent *ac_next;
+	uint_t		ac_hash;
+	bitmap4		ac_breq;	/* requested attribute bitmap */
+	timestruc_t	ac_ctime;	/* ctime the result encodes */
+	uint_t		ac_fhlen;
+	char		ac_fh[NFS4_FHSIZE];
+	bitmap4		ac_attrmask;	/* cached fattr4 contents */
+	uint_t		ac_len;
+	char		*ac_attrs;
+} rfs4_attr_cent_t;
+
+typedef struct rfs4_attr_bucket {
+	rfs4_attr_cent_t *ab_chain;
+	kmutex_t	ab_lock;
+} rfs4_attr_bucket_t;
+
+static rfs4_attr_bucket_t rfs4_attr_cache[RFS4_AC_NBUCKET];
+
+static uint_t
+rfs4_attrcache_hashval(nfs_fh4 *fh, bitmap4 breq, timestruc_t *ct)
+{
+	uint_t hash = (uint_t)(breq ^ (breq >> 32)) +
+	    (uint_t)ct->tv_sec + (uint_t)ct->tv_nsec;
+	char *cp = fh->nfs_fh4_val;
+	uint_t len = fh->nfs_fh4_len;
+
+	while (len-- != 0)
+		hash = (hash << 4) + hash + (uint_t)*cp++;
+	return (hash);
+}
+
+/*
+ * Decide whether a GETATTR result may be served from or entered into
+ * the cache.
+ */
+static bool_t
+rfs4_attrcache_cacheable(struct compound_state *cs, bitmap4 breq,
+    struct nfs4_svgetit_arg *sargp)
+{
+	if (rfs4_attrcache_enable == 0)
+		return (FALSE);
+	if ((breq & FATTR4_CHANGE_MASK) == 0 ||
+	    (breq & RFS4_AC_VOLATILE) != 0)
+		return (FALSE);
+	if ((sargp->vap->va_mask & AT_CTIME) == 0)
+		return (FALSE);
+
+	/*
+	 * The change attribute of visible directories in a pseudo
+	 * export also moves when the export list does, without any
+	 * ctime update, so such results can't be keyed on ctime.
+	 */
+	if (cs->exi == NULL || cs->exi->exi_visible != NULL)
+		return (FALSE);
+	if (cs->fh.nfs_fh4_len > NFS4_FHSIZE)
+		return (FALSE);
+	return (TRUE);
+}
+
+static bool_t
+rfs4_attrcache_get(struct compound_state *cs, bitmap4 breq,
+    timestruc_t *ct, fattr4 *fattrp)
+{
+	rfs4_attr_bucket_t *abp;
+	rfs4_attr_cent_t *acp;
+	char *attrs = NULL;
+	uint_t hash;
+
+	hash = rfs4_attrcache_hashval(&cs->fh, breq, ct);
+	abp = &rfs4_attr_cache[hash & (RFS4_AC_NBUCKET - 1)];
+	mutex_enter(&abp->ab_lock);
+	for (acp = abp->ab_chain; acp != NULL; acp = acp->ac_next) {
+		if (acp->ac_hash == hash && acp->ac_breq == breq &&
+		    acp->ac_ctime.tv_sec == ct->tv_sec &&
+		    acp->ac_ctime.tv_nsec == ct->tv_nsec &&
+		    acp->ac_fhlen == cs->fh.nfs_fh4_len &&
+		    bcmp(acp->ac_fh, cs->fh.nfs_fh4_val,
+		    acp->ac_fhlen) == 0) {
+			if (acp->ac_len != 0) {
+				attrs = kmem_alloc(acp->ac_len, KM_NOSLEEP);
+				if (attrs == NULL)
+					break;
+				bcopy(acp->ac_attrs, attrs, acp->ac_len);
+			}
+			fattrp->attrmask = acp->ac_attrmask;
+			fattrp->attrlist4_len = acp->ac_len;
+			fattrp->attrlist4 = attrs;
+			mutex_exit(&abp->ab_lock);
+			atomic_inc_64(&rfs4_attrcache_hits);
+			return (TRUE);
+		}
+	}
+	mutex_exit(&abp->ab_lock);
+	atomic_inc_64(&rfs4_attrcache_misses);
+	return (FALSE);
+}
+
+static void
+rfs4_attrcache_cent_free(rfs4_attr_cent_t *acp)
+{
+	if (acp->ac_len != 0)
+		kmem_free(acp->ac_attrs, acp->ac_len);
+	kmem_free(acp, sizeof (*acp));
+}
+
+static void
+rfs4_attrcache_put(struct compound_state *cs, bitmap4 breq,
+    timestruc_t *ct, fattr4 *fattrp)
+{
+	rfs4_attr_bucket_t *abp;
+	rfs4_attr_cent_t *acp, *tcp, **prevpp;
+	int depth;
+
+	acp = kmem_zalloc(sizeof (*acp), KM_NOSLEEP);
+	if (acp == NULL)
+		return;
+	if (fattrp->attrlist4_len != 0) {
+		acp->ac_attrs = kmem_alloc(fattrp->attrlist4_len, KM_NOSLEEP);
+		if (acp->ac_attrs == NULL) {
+			kmem_free(acp, sizeof (*acp));
+			return;
+		}
+		bcopy(fattrp->attrlist4, acp->ac_attrs,
+		    fattrp->attrlist4_len);
+	}
+	acp->ac_hash = rfs4_attrcache_hashval(&cs->fh, breq, ct);
+	acp->ac_breq = breq;
+	acp->ac_ctime = *ct;
+	acp->ac_fhlen = cs->fh.nfs_fh4_len;
+	bcopy(cs->fh.nfs_fh4_val, acp->ac_fh, acp->ac_fhlen);
+	acp->ac_attrmask = fattrp->attrmask;
+	acp->ac_len = fattrp->attrlist4_len;
+
+	abp = &rfs4_attr_cache[acp->ac_hash & (RFS4_AC_NBUCKET - 1)];
+	mutex_enter(&abp->ab_lock);
+	acp->ac_next = abp->ab_chain;
+	abp->ab_chain = acp;
+
+	/* Trim the chain from the cold end */
+	depth = 1;
+	prevpp = &acp->ac_next;
+	while ((tcp = *prevpp) != NULL) {
+		if (++depth > RFS4_AC_CHAINLEN) {
+			*prevpp = tcp->ac_next;
+			mutex_exit(&abp->ab_lock);
+			rfs4_attrcache_cent_free(tcp);
+			return;
+		}
+		prevpp = &tcp->ac_next;
+	}
+	mutex_exit(&abp->ab_lock);
+}
+
 /*
  * do_rfs4_op_getattr gets the system attrs and converts into fattr4.
  */
@@ -2420,6 +2608,7 @@ rfs4_op_getattr(nfs_argop4 *argop, nfs_resop4 *resop, struct svc_req *req,
 
 		status = bitmap4_get_sysattrs(&sarg);
 		if (status == NFS4_OK) {
+			bool_t cacheable = FALSE;
 
 			/* Is this a referral? */
 			if (vn_is_nfs_reparse(cs->vp, cs->cr)) {
@@ -2428,10 +2617,25 @@ rfs4_op_getattr(nfs_argop4 *argop, nfs_resop4 *resop, struct svc_req *req,
 					sarg.vap->va_type = VLNK;
 				else
 					sarg.is_referral = B_TRUE;
+			} else {
+				cacheable = rfs4_attrcache_cacheable(cs,
+				    args->attr_request, &sarg);
 			}
 
-			status = do_rfs4_op_getattr(args->attr_request,
-			    &resp->obj_attributes, &sarg);
+			if (cacheable && rfs4_attrcache_get(cs,
+			    args->attr_request, &sarg.vap->va_ctime,
+			    &resp->obj_attributes)) {
+				status = NFS4_OK;
+			} else {
+				status = do_rfs4_op_getattr(
+				    args->attr_request,
+				    &resp->obj_attributes, &sarg);
+				if (cacheable && status == NFS4_OK)
+					rfs4_attrcache_put(cs,
+					    args->attr_request,
+					    &sarg.vap->va_ctime,
+					    &resp->obj_attributes);
+			}
 		}
 	}
 	*cs->statusp = resp->status = status;
@@ -3285,8 +3489,9 @@ rfs4_op_read(nfs_argop4 *argop, nfs_resop4 *resop, struct svc_req *req,
 		rdma_used = 1;
 	}
 
-	/* use loaned buffers for TCP */
-	loaned_buffers = (nfs_loaned_buffers && !rdma_used) ? 1 : 0;
+	/* use loaned buffers for large TCP reads */
+	loaned_buffers = (nfs_loaned_buffers && !rdma_used &&
+	    args->count >= nfs_loaned_buffers_min) ? 1 : 0;
 
 	va.va_mask = AT_MODE|AT_SIZE|AT_UID;
 	verror = VOP_GETATTR(vp, &va, 0, cs->cr, &ct);
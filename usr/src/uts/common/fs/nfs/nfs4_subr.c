@@ -66,6 +66,8 @@ static const struct clstat4 clstat4_tmpl = {
 	{ "referlinks",	KSTAT_DATA_UINT64 },
 	{ "clgets",	KSTAT_DATA_UINT64 },
 	{ "cltoomany",	KSTAT_DATA_UINT64 },
+	{ "rddirra",	KSTAT_DATA_UINT64 },
+	{ "rddirrahit",	KSTAT_DATA_UINT64 },
 #ifdef DEBUG
 	{ "clalloc",	KSTAT_DATA_UINT64 },
 	{ "noresponse",	KSTAT_DATA_UINT64 },
@@ -2641,6 +2643,7 @@ rddir4_cache_alloc(int flags)
 		 * A readdir is required so set the flag.
 		 */
 		rc->flags = RDDIRREQ;
+		rc->rahead = 0;
 		cv_init(&rc->cv, NULL, CV_DEFAULT, NULL);
 		rc->error = 0;
 		mutex_init(&rdip->lock, NULL, MUTEX_DEFAULT, NULL);
@@ -349,6 +349,18 @@ static int nfs4_create_misses = 0;
 
 static int nfs4_readdir_cache_shorts = 0;
 static int nfs4_readdir_readahead = 0;
+#endif
+
+/*
+ * Number of READDIR chunks to keep in flight ahead of the reader.
+ * Directory cookies are opaque, so a chunk can only be requested once
+ * the reply carrying its cookie arrives; depth greater than one is
+ * achieved by chaining the next request from the completion of the
+ * previous one.  Zero or one gives the old single-chunk readahead.
+ */
+int nfs4_readdir_ra_depth = 4;
+
+#ifdef DEBUG
 
 static int nfs4_bio_do_stop = 0;
 
@@ -8918,9 +8930,12 @@ nfs4_readdir(vnode_t *vp, struct uio *uiop, cred_t *cr, int *eofp,
 	rnode4_t *rp;
 	rddir4_cache *rdc;
 	rddir4_cache *rrdc;
+	struct nfs4_clnt *nfscl;
 
 	if (nfs_zone() != VTOMI4(vp)->mi_zone)
 		return (EIO);
+	nfscl = zone_getspecific(nfs4clnt_zone_key, nfs_zone());
+	ASSERT(nfscl != NULL);
 	rp = VTOR4(vp);
 
 	ASSERT(nfs_rw_lock_held(&rp->r_rwlock, RW_READER));
@@ -8979,6 +8994,17 @@ nfs4_readdir(vnode_t *vp, struct uio *uiop, cred_t *cr, int *eofp,
 		return (EINTR);
 	}
 
+	/*
+	 * If the readahead machinery fetched (or is fetching) this
+	 * entry before the application asked for it, count the hit.
+	 * An entry that failed and needs to be refilled is a miss.
+	 */
+	if (rdc->flags & RDDIRRA) {
+		rdc->flags &= ~RDDIRRA;
+		if (!(rdc->flags & RDDIRREQ))
+			nfscl->nfscl_stat.rddirrahit.value.ui64++;
+	}
+
 	/*
 	 * Check to see if we need to fill this entry in.
 	 */
@@ -9084,7 +9110,9 @@ nfs4_readdir(vnode_t *vp, struct uio *uiop, cred_t *cr, int *eofp,
 	 */
 	if (rrdc->flags & RDDIRREQ) {
 		rrdc->flags &= ~RDDIRREQ;
-		rrdc->flags |= RDDIR;
+		rrdc->flags |= RDDIR | RDDIRRA;
+		rrdc->rahead = nfs4_readdir_ra_depth - 1;
+		nfscl->nfscl_stat.rddirra.value.ui64++;
 		rddir4_cache_rele(rp, rdc);
 		mutex_exit(&rp->r_statelock);
 #ifdef DEBUG
@@ -9107,7 +9135,11 @@ static int
 do_nfs4readdir(vnode_t *vp, rddir4_cache *rdc, cred_t *cr)
 {
 	int error;
+	int count, rahead;
+	offset_t ncookie;
 	rnode4_t *rp;
+	rddir4_cache *nrdc;
+	struct nfs4_clnt *nfscl;
 
 	ASSERT(nfs_zone() == VTOMI4(vp)->mi_zone);
 
@@ -9127,9 +9159,45 @@ do_nfs4readdir(vnode_t *vp, rddir4_cache *rdc, cred_t *cr)
 	error = rdc->error;
 	if (error)
 		rdc->flags |= RDDIRREQ;
+
+	/*
+	 * If this entry was filled as a readahead with chain budget
+	 * remaining, start on the next chunk now instead of waiting
+	 * for the application to get here.  The cookie for the next
+	 * chunk only became known with this reply, so this is the
+	 * earliest it could have been requested.
+	 */
+	rahead = (error == 0 && !rdc->eof) ? rdc->rahead : 0;
+	ncookie = rdc->nfs4_ncookie;
+	count = rdc->buflen;
 	rddir4_cache_rele(rp, rdc);
 	mutex_exit(&rp->r_statelock);
 
+	if (rahead > 0 &&
+	    nfs_rw_enter_sig(&rp->r_rwlock, RW_READER, INTR4(vp)) == 0) {
+		mutex_enter(&rp->r_statelock);
+		nrdc = rddir4_cache_lookup(rp, ncookie, count);
+		if (nrdc != NULL) {
+			if (nrdc->flags & RDDIRREQ) {
+				nrdc->flags &= ~RDDIRREQ;
+				nrdc->flags |= RDDIR | RDDIRRA;
+				nrdc->rahead = rahead - 1;
+				mutex_exit(&rp->r_statelock);
+				nfscl = zone_getspecific(nfs4clnt_zone_key,
+				    nfs_zone());
+				ASSERT(nfscl != NULL);
+				nfscl->nfscl_stat.rddirra.value.ui64++;
+				nfs4_async_readdir(vp, nrdc, cr,
+				    do_nfs4readdir);
+				nfs_rw_exit(&rp->r_rwlock);
+				return (error);
+			}
+			rddir4_cache_rele(rp, nrdc);
+		}
+		mutex_exit(&rp->r_statelock);
+		nfs_rw_exit(&rp->r_rwlock);
+	}
+
 	return (error);
 }
 
@@ -114,7 +114,17 @@ list_t		nfssrv_globals_list;
 krwlock_t	nfssrv_globals_rwl;
 
 kmem_cache_t *nfs_xuio_cache;
-int nfs_loaned_buffers = 0;
+
+/*
+ * Zero-copy READ replies: when enabled, large TCP reads borrow the
+ * file system's cached buffers (VOP_REQZCBUF) and the reply mblks
+ * reference them directly all the way down the stack instead of
+ * copying the data out. Reads smaller than nfs_loaned_buffers_min
+ * bytes still use the copy path, since for them the setup and the
+ * deferred VOP_RETZCBUF cost more than the copy they save.
+ */
+int nfs_loaned_buffers = 1;
+uint_t nfs_loaned_buffers_min = 32 * 1024;
 
 /* array of paths passed-in from nfsd command-line; stored in nvlist */
 char		**rfs4_dss_newpaths;
@@ -703,6 +703,33 @@ portfs(int opcode, uintptr_t a0, uintptr_t a1, uintptr_t a2, uintptr_t a3,
 			port_remove_alert(&pp->port_queue);
 		break;
 	}
+	case	PORT_COALESCE:
+	{
+		/*
+		 * Configure timed event coalescing for this port.
+		 * a1 is the batching target (number of events) and a2 the
+		 * slack time in microseconds a port_getn() caller is willing
+		 * to linger once the first event is available. Both zero
+		 * turns coalescing off; enabling requires a target of at
+		 * least two events and a non-zero slack of at most a second.
+		 */
+		port_queue_t	*portq = &pp->port_queue;
+		uint_t		nevents = (uint_t)a1;
+		uint_t		slack = (uint_t)a2;
+
+		if ((nevents == 0 && slack != 0) ||
+		    (nevents != 0 && (slack == 0 || nevents < 2)) ||
+		    nevents > pp->port_max_events || slack > MICROSEC) {
+			error = EINVAL;
+			break;
+		}
+		mutex_enter(&portq->portq_mutex);
+		portq->portq_coal_events = nevents;
+		portq->portq_coal_slack = (uint64_t)slack *
+		    (NANOSEC / MICROSEC);
+		mutex_exit(&portq->portq_mutex);
+		break;
+	}
 	default:
 		error = EINVAL;
 		break;
@@ -1179,6 +1206,9 @@ port_getn(port_t *pp, port_event_t *uevp, uint_t max, uint_t *nget,
 	int		flag;
 	timespec_t	rqtime;
 	timespec_t	*rqtp = NULL;
+	uint_t		nwait;
+	int		coal_armed = 0;
+	timespec_t	coal_rqtime;
 	portget_t	*pgetp;
 	void		*results;
 	model_t		model = get_udatamodel();
@@ -1238,6 +1268,18 @@ port_getn(port_t *pp, port_event_t *uevp, uint_t max, uint_t *nget,
 
 	portq->portq_thrcnt++;
 
+	/*
+	 * With coalescing enabled (see PORT_COALESCE) the caller is willing
+	 * to wait for more than the requested number of events, up to the
+	 * port's batching target, provided the extra wait once the request
+	 * is satisfiable stays below the configured slack. port_get()
+	 * (PORTGET_ONE) can only take a single event and is never delayed.
+	 */
+	nwait = *nget;
+	if (portq->portq_coal_slack != 0 && !(flag & PORTGET_ONE) &&
+	    max > nwait && portq->portq_coal_events > nwait)
+		nwait = MIN(portq->portq_coal_events, max);
+
 	/*
 	 * Now check if the completed events satisfy the
 	 * "wait" requirements of the current thread:
@@ -1257,7 +1299,7 @@ port_getn(port_t *pp, port_event_t *uevp, uint_t max, uint_t *nget,
 		 * are added to the queue.
 		 */
 		if (((portq->portq_flags & PORTQ_WAIT_EVENTS) == 0) &&
-		    (portq->portq_nent >= *nget)) {
+		    (portq->portq_nent >= nwait)) {
 			/* some new events arrived ...check them */
 			goto portnowait;
 		}
@@ -1266,7 +1308,7 @@ port_getn(port_t *pp, port_event_t *uevp, uint_t max, uint_t *nget,
 		pgt->pgt_flags |= PORTGET_WAIT_EVENTS;
 	} else {
 		/* check if enough events are available ... */
-		if (portq->portq_nent >= *nget)
+		if (portq->portq_nent >= nwait)
 			goto portnowait;
 		/*
 		 * There are not enough events available to satisfy
@@ -1317,7 +1359,7 @@ port_getn(port_t *pp, port_event_t *uevp, uint_t max, uint_t *nget,
 		 */
 
 		if ((portq->portq_getn  == 0) &&
-		    ((portq)->portq_nent >= *nget) &&
+		    ((portq)->portq_nent >= nwait) &&
 		    (!((pgt)->pgt_flags & PORTGET_WAIT_EVENTS) ||
 		    !((portq)->portq_flags & PORTQ_WAIT_EVENTS)))
 			break;
@@ -1327,10 +1369,38 @@ port_getn(port_t *pp, port_event_t *uevp, uint_t max, uint_t *nget,
 			break;
 		}
 
+		/*
+		 * The events requested by the caller are present but the
+		 * port's batching target is not reached yet; bound the
+		 * remaining wait by the coalescing slack so the added
+		 * latency stays capped. When the slack expires the thread
+		 * reaps whatever has been gathered so far.
+		 */
+		if (nwait > *nget && !coal_armed &&
+		    portq->portq_nent >= *nget) {
+			timespec_t	now;
+
+			coal_rqtime.tv_sec = portq->portq_coal_slack / NANOSEC;
+			coal_rqtime.tv_nsec =
+			    portq->portq_coal_slack % NANOSEC;
+			gethrestime(&now);
+			timespecadd(&coal_rqtime, &now);
+			if (rqtp == NULL ||
+			    coal_rqtime.tv_sec < rqtp->tv_sec ||
+			    (coal_rqtime.tv_sec == rqtp->tv_sec &&
+			    coal_rqtime.tv_nsec < rqtp->tv_nsec)) {
+				rqtp = &coal_rqtime;
+				timecheck = timechanged;
+			}
+			coal_armed = 1;
+		}
+
 		rval = cv_waituntil_sig(&pgetp->portget_cv, &portq->portq_mutex,
 		    rqtp, timecheck);
 
 		if (rval <= 0) {
+			if (rval < 0 && rqtp == &coal_rqtime)
+				break;	/* slack expired; reap the batch */
 			error = (rval == 0) ? EINTR : ETIME;
 			break;
 		}
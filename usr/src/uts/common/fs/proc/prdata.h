@@ -108,6 +108,7 @@ typedef struct prcommon {
 typedef enum prnodetype {
 	PR_PROCDIR,		/* /proc				*/
 	PR_SELF,		/* /proc/self				*/
+	PR_ALLPSINFO,		/* /proc/psinfo				*/
 	PR_PIDDIR,		/* /proc/<pid>				*/
 	PR_AS,			/* /proc/<pid>/as			*/
 	PR_CTL,			/* /proc/<pid>/ctl			*/
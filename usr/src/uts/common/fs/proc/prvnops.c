@@ -244,9 +244,10 @@ propen(vnode_t **vpp, int flag, cred_t *cr, caller_context_t *ct)
 	prnode_t *npnp = NULL;
 
 	/*
-	 * Nothing to do for the /proc directory itself.
+	 * Nothing to do for the /proc directory itself, nor for the
+	 * process-table snapshot file, which has no associated process.
 	 */
-	if (type == PR_PROCDIR)
+	if (type == PR_PROCDIR || type == PR_ALLPSINFO)
 		return (0);
 
 	/*
@@ -435,9 +436,10 @@ prclose(vnode_t *vp, int flag, int count, offset_t offset, cred_t *cr,
 	user_t *up;
 
 	/*
-	 * Nothing to do for the /proc directory itself.
+	 * Nothing to do for the /proc directory itself, nor for the
+	 * process-table snapshot file, which has no associated process.
 	 */
-	if (type == PR_PROCDIR)
+	if (type == PR_PROCDIR || type == PR_ALLPSINFO)
 		return (0);
 
 	ASSERT(type != PR_OBJECT && type != PR_FD &&
@@ -602,11 +604,12 @@ static int pr_read_inval(), pr_read_as(), pr_read_status(),
 	pr_read_gwindows(), pr_read_asrs(),
 #endif
 	pr_read_piddir(), pr_read_pidfile(), pr_read_opagedata(),
-	pr_read_fdinfo();
+	pr_read_fdinfo(), pr_read_allpsinfo();
 
 static int (*pr_read_function[PR_NFILES])() = {
 	pr_read_inval,		/* /proc				*/
 	pr_read_inval,		/* /proc/self				*/
+	pr_read_allpsinfo,	/* /proc/psinfo				*/
 	pr_read_piddir,		/* /proc/<pid> (old /proc read())	*/
 	pr_read_as,		/* /proc/<pid>/as			*/
 	pr_read_inval,		/* /proc/<pid>/ctl			*/
@@ -820,6 +823,134 @@ pr_read_psinfo(prnode_t *pnp, uio_t *uiop, cred_t *cr)
 	return (error);
 }
 
+/*
+ * Gather the equivalent of the /proc/<pid>/usage contents for one process
+ * on behalf of pr_read_allpsinfo().  The caller holds p->p_lock.
+ */
+static void
+pr_bulkusage(proc_t *p, prhusage_t *pup)
+{
+	kthread_t *t;
+
+	ASSERT(MUTEX_HELD(&p->p_lock));
+
+	bzero(pup, sizeof (*pup));
+	pup->pr_tstamp = gethrtime();
+
+	pup->pr_count  = p->p_defunct;
+	pup->pr_create = p->p_mstart;
+	pup->pr_term   = p->p_mterm;
+
+	pup->pr_rtime    = p->p_mlreal;
+	pup->pr_utime    = p->p_acct[LMS_USER];
+	pup->pr_stime    = p->p_acct[LMS_SYSTEM];
+	pup->pr_ttime    = p->p_acct[LMS_TRAP];
+	pup->pr_tftime   = p->p_acct[LMS_TFAULT];
+	pup->pr_dftime   = p->p_acct[LMS_DFAULT];
+	pup->pr_kftime   = p->p_acct[LMS_KFAULT];
+	pup->pr_ltime    = p->p_acct[LMS_USER_LOCK];
+	pup->pr_slptime  = p->p_acct[LMS_SLEEP];
+	pup->pr_wtime    = p->p_acct[LMS_WAIT_CPU];
+	pup->pr_stoptime = p->p_acct[LMS_STOPPED];
+
+	pup->pr_minf  = p->p_ru.minflt;
+	pup->pr_majf  = p->p_ru.majflt;
+	pup->pr_nswap = p->p_ru.nswap;
+	pup->pr_inblk = p->p_ru.inblock;
+	pup->pr_oublk = p->p_ru.oublock;
+	pup->pr_msnd  = p->p_ru.msgsnd;
+	pup->pr_mrcv  = p->p_ru.msgrcv;
+	pup->pr_sigs  = p->p_ru.nsignals;
+	pup->pr_vctx  = p->p_ru.nvcsw;
+	pup->pr_ictx  = p->p_ru.nivcsw;
+	pup->pr_sysc  = p->p_ru.sysc;
+	pup->pr_ioch  = p->p_ru.ioch;
+
+	/*
+	 * Add the usage information for each active lwp.
+	 */
+	if ((t = p->p_tlist) != NULL && p->p_stat != SZOMB) {
+		do {
+			if (t->t_proc_flag & TP_LWPEXIT)
+				continue;
+			pup->pr_count++;
+			praddusage(t, pup);
+		} while ((t = t->t_forw) != p->p_tlist);
+	}
+}
+
+/*
+ * Read the process-table snapshot file, /proc/psinfo: a prheader followed
+ * by one prbulkpsinfo entry (psinfo + usage) for every process visible
+ * where this instance of /proc is mounted.  Like the per-process psinfo
+ * and usage files, the snapshot is world-readable.  It is rebuilt on
+ * every read, so consumers should fetch it with a single large read.
+ */
+/* ARGSUSED */
+static int
+pr_read_allpsinfo(prnode_t *pnp, uio_t *uiop, cred_t *cr)
+{
+	zoneid_t zoneid;
+	prheader_t *php;
+	prbulkpsinfo_t *bpsp;
+	prhusage_t *pup;
+	proc_t *p;
+	size_t size, maxent, nent = 0;
+	offset_t n;
+	int error;
+	extern uint_t nproc;
+
+	ASSERT(pnp->pr_type == PR_ALLPSINFO);
+
+	zoneid = VTOZONE(PTOV(pnp))->zone_id;
+
+	/*
+	 * Size the snapshot for the processes that exist now.  Processes
+	 * created while the table is being walked are not included; a
+	 * consumer polling this file could equally have sampled just
+	 * before they were created.
+	 */
+	maxent = nproc;
+	size = sizeof (prheader_t) + maxent * LSPAN(prbulkpsinfo_t);
+	php = kmem_zalloc(size, KM_SLEEP);
+	pup = kmem_zalloc(sizeof (*pup), KM_SLEEP);
+	php->pr_entsize = LSPAN(prbulkpsinfo_t);
+
+	bpsp = (prbulkpsinfo_t *)(php + 1);
+	for (n = 0; n < v.v_proc && nent < maxent; n++) {
+		/*
+		 * Skip processes not visible where this /proc was
+		 * mounted, as pr_readdir_procdir() does.
+		 */
+		mutex_enter(&pidlock);
+		if ((p = pid_entry(n)) == NULL || p->p_stat == SIDL ||
+		    (zoneid != GLOBAL_ZONEID &&
+		    p->p_zone->zone_id != zoneid) ||
+		    secpolicy_basic_procinfo(CRED(), p, curproc) != 0) {
+			mutex_exit(&pidlock);
+			continue;
+		}
+		mutex_enter(&p->p_lock);
+		mutex_exit(&pidlock);
+
+		prgetpsinfo(p, &bpsp->pr_psinfo);
+		pr_bulkusage(p, pup);
+		mutex_exit(&p->p_lock);
+
+		prcvtusage(pup, &bpsp->pr_usage);
+		bpsp = (prbulkpsinfo_t *)((caddr_t)bpsp +
+		    LSPAN(prbulkpsinfo_t));
+		nent++;
+	}
+	php->pr_nent = nent;
+
+	error = pr_uioread(php, sizeof (prheader_t) +
+	    nent * LSPAN(prbulkpsinfo_t), uiop);
+	kmem_free(pup, sizeof (*pup));
+	kmem_free(php, size);
+	return (error);
+}
+
 static int
 pr_read_fdinfo(prnode_t *pnp, uio_t *uiop, cred_t *cr)
 {
@@ -1892,11 +2023,12 @@ static int pr_read_status_32(),
 #if defined(__sparc)
 	pr_read_gwindows_32(),
 #endif
-	pr_read_opagedata_32();
+	pr_read_opagedata_32(), pr_read_allpsinfo_32();
 
 static int (*pr_read_function_32[PR_NFILES])() = {
 	pr_read_inval,		/* /proc				*/
 	pr_read_inval,		/* /proc/self				*/
+	pr_read_allpsinfo_32,	/* /proc/psinfo				*/
 	pr_read_piddir,		/* /proc/<pid> (old /proc read())	*/
 	pr_read_as,		/* /proc/<pid>/as			*/
 	pr_read_inval,		/* /proc/<pid>/ctl			*/
@@ -2066,6 +2198,64 @@ pr_read_psinfo_32(prnode_t *pnp, uio_t *uiop, cred_t *cr)
 	return (error);
 }
 
+/*
+ * The _ILP32 version of pr_read_allpsinfo(); see the comments there.
+ */
+/* ARGSUSED */
+static int
+pr_read_allpsinfo_32(prnode_t *pnp, uio_t *uiop, cred_t *cr)
+{
+	zoneid_t zoneid;
+	prheader32_t *php;
+	prbulkpsinfo32_t *bpsp;
+	prhusage_t *pup;
+	proc_t *p;
+	size_t size, maxent, nent = 0;
+	offset_t n;
+	int error;
+	extern uint_t nproc;
+
+	ASSERT(pnp->pr_type == PR_ALLPSINFO);
+
+	zoneid = VTOZONE(PTOV(pnp))->zone_id;
+
+	maxent = nproc;
+	size = sizeof (prheader32_t) + maxent * LSPAN32(prbulkpsinfo32_t);
+	php = kmem_zalloc(size, KM_SLEEP);
+	pup = kmem_zalloc(sizeof (*pup), KM_SLEEP);
+	php->pr_entsize = LSPAN32(prbulkpsinfo32_t);
+
+	bpsp = (prbulkpsinfo32_t *)(php + 1);
+	for (n = 0; n < v.v_proc && nent < maxent; n++) {
+		mutex_enter(&pidlock);
+		if ((p = pid_entry(n)) == NULL || p->p_stat == SIDL ||
+		    (zoneid != GLOBAL_ZONEID &&
+		    p->p_zone->zone_id != zoneid) ||
+		    secpolicy_basic_procinfo(CRED(), p, curproc) != 0) {
+			mutex_exit(&pidlock);
+			continue;
+		}
+		mutex_enter(&p->p_lock);
+		mutex_exit(&pidlock);
+
+		prgetpsinfo32(p, &bpsp->pr_psinfo);
+		pr_bulkusage(p, pup);
+		mutex_exit(&p->p_lock);
+
+		prcvtusage32(pup, &bpsp->pr_usage);
+		bpsp = (prbulkpsinfo32_t *)((caddr_t)bpsp +
+		    LSPAN32(prbulkpsinfo32_t));
+		nent++;
+	}
+	php->pr_nent = nent;
+
+	error = pr_uioread(php, sizeof (prheader32_t) +
+	    nent * LSPAN32(prbulkpsinfo32_t), uiop);
+	kmem_free(pup, sizeof (*pup));
+	kmem_free(php, size);
+	return (error);
+}
+
 static int
 pr_read_lpsinfo_32(prnode_t *pnp, uio_t *uiop, cred_t *cr)
 {
@@ -3097,6 +3287,24 @@ prgetattr(vnode_t *vp, vattr_t *vap, int flags, cred_t *cr,
 		return (0);
 	}
 
+	/*
+	 * The /proc/psinfo snapshot file also has no prcommon member.
+	 * Its size is only an estimate: the set of visible processes can
+	 * change before the file is read.
+	 */
+	if (type == PR_ALLPSINFO) {
+		vap->va_uid = 0;
+		vap->va_gid = 0;
+		vap->va_nodeid = (ino64_t)PR_ALLPSINFO;
+		gethrestime(&now);
+		vap->va_atime = vap->va_mtime = vap->va_ctime = now;
+		vap->va_nlink = 1;
+		vap->va_size = PR_OBJSIZE(prheader32_t, prheader_t) +
+		    nproc * PR_OBJSPAN(prbulkpsinfo32_t, prbulkpsinfo_t);
+		vap->va_nblocks = btod(vap->va_size);
+		return (0);
+	}
+
 	/* A subset of prlock(pnp...) */
 	p = pr_p_lock(pnp);
 	mutex_exit(&pr_pidlock);
@@ -3445,6 +3653,7 @@ praccess(vnode_t *vp, int mode, int flags, cred_t *cr, caller_context_t *ct)
 
 	switch (type) {
 	case PR_PROCDIR:
+	case PR_ALLPSINFO:
 		break;
 
 	case PR_OBJECT:
@@ -3541,6 +3750,7 @@ static vnode_t *pr_lookup_notdir(), *pr_lookup_procdir(), *pr_lookup_piddir(),
 static vnode_t *(*pr_lookup_function[PR_NFILES])() = {
 	pr_lookup_procdir,	/* /proc				*/
 	pr_lookup_notdir,	/* /proc/self				*/
+	pr_lookup_notdir,	/* /proc/psinfo				*/
 	pr_lookup_piddir,	/* /proc/<pid>				*/
 	pr_lookup_notdir,	/* /proc/<pid>/as			*/
 	pr_lookup_notdir,	/* /proc/<pid>/ctl			*/
@@ -3744,6 +3954,9 @@ pr_lookup_procdir(vnode_t *dp, char *comp)
 	if (strcmp(comp, "self") == 0) {
 		pnp = prgetnode(dp, PR_SELF);
 		return (PTOV(pnp));
+	} else if (strcmp(comp, "psinfo") == 0) {
+		pnp = prgetnode(dp, PR_ALLPSINFO);
+		return (PTOV(pnp));
 	} else {
 		pid = 0;
 		while ((c = *comp++) != '\0') {
@@ -4897,6 +5110,7 @@ prgetnode(vnode_t *dp, prnodetype_t type)
 	case PR_USAGE:
 	case PR_LUSAGE:
 	case PR_LWPUSAGE:
+	case PR_ALLPSINFO:
 		pnp->pr_mode = 0444;	/* read-only by all */
 		break;
 
@@ -4988,6 +5202,7 @@ static int pr_readdir_notdir(), pr_readdir_procdir(), pr_readdir_piddir(),
 static int (*pr_readdir_function[PR_NFILES])() = {
 	pr_readdir_procdir,	/* /proc				*/
 	pr_readdir_notdir,	/* /proc/self				*/
+	pr_readdir_notdir,	/* /proc/psinfo				*/
 	pr_readdir_piddir,	/* /proc/<pid>				*/
 	pr_readdir_notdir,	/* /proc/<pid>/as			*/
 	pr_readdir_notdir,	/* /proc/<pid>/ctl			*/
@@ -5941,6 +6156,7 @@ prinactive(vnode_t *vp, cred_t *cr, caller_context_t *ct)
 	case PR_FD:
 	case PR_FDINFO:
 	case PR_SELF:
+	case PR_ALLPSINFO:
 	case PR_PATH:
 		/* These are not linked into the usual lists */
 		ASSERT(vp->v_count == 1);
@@ -220,8 +220,17 @@ smb2sr_newrq(smb_request_t *sr)
 	sr->sr_time_submitted = gethrtime();
 	sr->sr_state = SMB_REQ_STATE_SUBMITTED;
 	smb_srqueue_waitq_enter(sr->session->s_srqueue);
-	(void) taskq_dispatch(sr->sr_server->sv_worker_pool,
-	    smb2_tq_work, sr, TQ_SLEEP);
+	if (sr->smb2_cmd_code == SMB2_OPLOCK_BREAK) {
+		/*
+		 * Oplock break acks must not wait behind requests
+		 * that may be blocked waiting for this very ack,
+		 * so bypass the per-session worker limit.
+		 */
+		(void) taskq_dispatch(sr->sr_server->sv_worker_pool,
+		    smb2_tq_work, sr, TQ_SLEEP);
+	} else {
+		smb_session_disp_request(sr, smb2_tq_work);
+	}
 	return (0);
 
 drop:
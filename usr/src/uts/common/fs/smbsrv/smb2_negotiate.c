@@ -59,15 +59,23 @@ uint32_t smb2srv_capabilities =
  *
  * smb2_max_rwsize is what we put in the SMB2 negotiate response to tell
  * the client the largest read and write request size we'll support.
- * For now, we're using contiguous allocations, so keep this at 64KB
- * so that (even with message overhead) allocations stay below 128KB,
- * avoiding kmem_alloc -> page_create_va thrashing.
+ * Large requests and read replies use chains of cluster mbufs with
+ * vectored VOP I/O over them (see smb_mbuf_alloc_chain), so this is
+ * no longer held down by contiguous allocation concerns.  It must
+ * stay no more than half smb2_tcp_bufsize, and (with MCLBYTES
+ * clusters) no more than MAX_IOVEC * MCLBYTES.
+ *
+ * smb2_enc_rwsize is the limit for sessions that may use encryption,
+ * where in-place decryption and the encrypted reply path still use
+ * contiguous buffers, so keep those at the traditional 64KB to avoid
+ * kmem_alloc -> page_create_va thrashing.
  *
  * smb2_max_trans is the largest "transact" send or receive, which is
  * used for directory listings and info set/get operations.
  */
 uint32_t smb2_tcp_bufsize = (1<<22);	/* 4MB */
-uint32_t smb2_max_rwsize = (1<<16);	/* 64KB */
+uint32_t smb2_max_rwsize = (1<<20);	/* 1MB */
+uint32_t smb2_enc_rwsize = (1<<16);	/* 64KB */
 uint32_t smb2_max_trans  = (1<<16);	/* 64KB */
 
 /*
@@ -854,6 +862,9 @@ smb2_negotiate_common(smb_request_t *sr, uint16_t version)
 		max_rwsize = smb2_max_rwsize;
 	else
 		max_rwsize = smb2_old_rwsize;
+	if ((s->srv_cap & SMB2_CAP_ENCRYPTION) != 0 &&
+	    max_rwsize > smb2_enc_rwsize)
+		max_rwsize = smb2_enc_rwsize;
 
 	rc = smb_mbc_encodef(
 	    &sr->reply,
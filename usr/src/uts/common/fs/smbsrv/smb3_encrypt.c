@@ -211,6 +211,15 @@ smb3_decrypt_sr(smb_request_t *sr)
 		return (-1);
 	}
 
+	/*
+	 * In-place decryption needs the flat receive buffer that
+	 * smb_request_alloc always uses for encryption-capable
+	 * sessions; a chain here means a misbehaving client.
+	 */
+	if (sr->sr_request_buf == NULL) {
+		return (-1);
+	}
+
 	tlen = SMB3_TFORM_HDR_SIZE - SMB3_NONCE_OFFS;
 	offset = mbc->chain_offset + SMB3_NONCE_OFFS;
 	resid = mbc->max_bytes - offset;
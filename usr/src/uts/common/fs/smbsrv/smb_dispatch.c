@@ -596,8 +596,17 @@ smb1sr_newrq(smb_request_t *sr)
 	sr->sr_time_submitted = gethrtime();
 	sr->sr_state = SMB_REQ_STATE_SUBMITTED;
 	smb_srqueue_waitq_enter(sr->session->s_srqueue);
-	(void) taskq_dispatch(sr->sr_server->sv_worker_pool,
-	    smb1_tq_work, sr, TQ_SLEEP);
+	if (sr->smb_com == SMB_COM_LOCKING_ANDX) {
+		/*
+		 * May carry an oplock break ack, which must not wait
+		 * behind requests that may be blocked waiting for it,
+		 * so bypass the per-session worker limit.
+		 */
+		(void) taskq_dispatch(sr->sr_server->sv_worker_pool,
+		    smb1_tq_work, sr, TQ_SLEEP);
+	} else {
+		smb_session_disp_request(sr, smb1_tq_work);
+	}
 
 	return (0);
 }
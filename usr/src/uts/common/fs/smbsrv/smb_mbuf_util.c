@@ -174,39 +174,85 @@ smb_mbuf_kmem_ref(void *p, uint_t sz, int incr)
 	return (0);
 }
 
+/*
+ * Allocate a chain of (cluster-sized) mbufs to hold len bytes, with
+ * m_len set in each so the chain covers exactly len.  Used for large
+ * requests and replies, where one contiguous kmem allocation would
+ * be large enough to cause page_create_va thrashing.
+ */
+struct mbuf *
+smb_mbuf_alloc_chain(int len)
+{
+	struct mbuf	*mhead = NULL;
+	struct mbuf	**mtail = &mhead;
+	struct mbuf	*m;
+	int		count;
+
+	ASSERT(len > 0);
+	while (len > 0) {
+		count = MIN(len, MCLBYTES);
+		MGET(m, M_WAIT, MT_DATA);
+		if (count > MLEN) {
+			MCLGET(m, M_WAIT);
+		}
+		m->m_len = count;
+		*mtail = m;
+		mtail = &m->m_next;
+		len -= count;
+	}
+	return (mhead);
+}
+
 /*
  * Allocate enough mbufs to accommodate the residual count in uio,
  * and setup the uio_iov to point to them.
  *
  * This is used by the various SMB read code paths.  That code is
- * going to do a disk read into this buffer, so we'd like it to be
- * large and contiguous.  Use an external (M_EXT) buffer.
+ * going to do a disk read into these buffers via the uio, so build
+ * a chain of clusters and let the VOP layer do vectored I/O over
+ * them, rather than one very large contiguous allocation.
  */
 struct mbuf *
 smb_mbuf_allocate(struct uio *uio)
 {
-	mbuf_t	*m = 0;
+	mbuf_t	*m;
+	mbuf_t	*mhead;
+	struct iovec *iovp = uio->uio_iov;
 	int	len = uio->uio_resid;
-
-	MGET(m, M_WAIT, MT_DATA);
-	if (len > MCLBYTES) {
-		/* Like MCLGET(), but bigger buf. */
+	int	iovcnt = 0;
+
+	if (len > MAX_IOVEC * MCLBYTES) {
+		/*
+		 * Larger than the iovec array can describe as a
+		 * chain of clusters (should not happen with sane
+		 * settings of smb2_max_rwsize).  Use one external
+		 * (M_EXT) buffer like we always did for this.
+		 */
+		MGET(m, M_WAIT, MT_DATA);
 		m->m_ext.ext_buf = kmem_zalloc(len, KM_SLEEP);
 		m->m_data = m->m_ext.ext_buf;
 		m->m_flags |= M_EXT;
 		m->m_ext.ext_size = len;
 		m->m_ext.ext_ref = smb_mbuf_kmem_ref;
-	} else if (len > MLEN) {
-		/* Use the kmem cache. */
-		MCLGET(m, M_WAIT);
+		m->m_len = len;
+
+		uio->uio_iov->iov_base = m->m_data;
+		uio->uio_iov->iov_len = m->m_len;
+		uio->uio_iovcnt = 1;
+
+		return (m);
 	}
-	m->m_len = len;
 
-	uio->uio_iov->iov_base = m->m_data;
-	uio->uio_iov->iov_len = m->m_len;
-	uio->uio_iovcnt = 1;
+	mhead = smb_mbuf_alloc_chain(len);
+	for (m = mhead; m != NULL; m = m->m_next) {
+		iovp->iov_base = m->m_data;
+		iovp->iov_len = m->m_len;
+		iovp++;
+		iovcnt++;
+	}
+	uio->uio_iovcnt = iovcnt;
 
-	return (m);
+	return (mhead);
 }
 
 /*
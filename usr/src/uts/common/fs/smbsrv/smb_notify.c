@@ -280,6 +280,14 @@ smb_notify_act2(smb_request_t *sr)
 		return (NT_STATUS_INVALID_HANDLE);
 	nc = &of->f_notify;
 
+	/*
+	 * This request is about to park without a worker thread,
+	 * possibly for a very long time, so give its worker pool
+	 * slot back now.  Must do this while we still own the SR;
+	 * once it's on nc_waiters it can be freed at any time.
+	 */
+	smb_session_disp_release(sr);
+
 	mutex_enter(&of->f_mutex);
 
 	/*
@@ -411,9 +411,14 @@ smb_request_init_command_mbuf(smb_request_t *sr)
 {
 
 	/*
-	 * Setup mbuf using the buffer we allocated.
+	 * Setup mbuf using the buffer we allocated, unless this is
+	 * a large request received into an mbuf chain, in which case
+	 * the command MBC was already setup in smb_request_alloc.
 	 */
-	MBC_ATTACH_BUF(&sr->command, sr->sr_request_buf, sr->sr_req_length);
+	if (sr->sr_request_buf != NULL) {
+		MBC_ATTACH_BUF(&sr->command, sr->sr_request_buf,
+		    sr->sr_req_length);
+	}
 
 	sr->command.flags = 0;
 	sr->command.shadow_of = NULL;
@@ -480,6 +485,89 @@ smb_request_cancel(smb_request_t *sr)
 	}
 }
 
+/*
+ * Per-session limit on worker pool usage.
+ *
+ * SMB2 clients can have very deep credit windows, and with thousands
+ * of connected sessions, letting every session submit its whole window
+ * to the worker pool at once allows a few busy clients to occupy the
+ * entire pool, starving the rest and creating enormous numbers of
+ * threads.  Cap the number of taskq jobs each session may have in
+ * flight; requests over the cap wait (FIFO) on s_tq_waitq and are
+ * submitted as earlier ones complete.
+ *
+ * Messages the blocked requests may themselves be waiting for
+ * (oplock break ack, cancel) must not queue behind them, so the
+ * dispatch code submits those directly rather than through here.
+ * Requests that park for a long wait without a worker thread
+ * (change notify) give their slot back via smb_session_disp_release.
+ */
+int smb_session_worker_max = 64;	/* Zero disables the cap. */
+
+/*
+ * Submit a request to the worker pool, subject to the per-session
+ * limit above.  Called from the session reader thread.
+ */
+void
+smb_session_disp_request(smb_request_t *sr, task_func_t func)
+{
+	smb_session_t	*session = sr->session;
+	uint32_t	max = smb_session_worker_max;
+
+	if (max != 0) {
+		mutex_enter(&session->s_tq_mutex);
+		if (session->s_tq_active >= max) {
+			sr->sr_tq_func = func;
+			list_insert_tail(&session->s_tq_waitq, sr);
+			session->s_tq_waiting++;
+			mutex_exit(&session->s_tq_mutex);
+			return;
+		}
+		session->s_tq_active++;
+		sr->sr_tq_counted = B_TRUE;
+		mutex_exit(&session->s_tq_mutex);
+	}
+
+	(void) taskq_dispatch(sr->sr_server->sv_worker_pool,
+	    func, sr, TQ_SLEEP);
+}
+
+/*
+ * Give up this request's worker pool slot, either because the request
+ * is done (called via smb_request_free) or because it's parking for a
+ * long wait without a worker thread (change notify).  If another
+ * request on this session is waiting for a slot, hand the slot
+ * directly to the oldest waiter.  Note that requests on s_tq_waitq
+ * are on s_req_list too (from smb_request_alloc), so session
+ * tear-down waits for them like any other request.
+ */
+void
+smb_session_disp_release(smb_request_t *sr)
+{
+	smb_session_t	*session = sr->session;
+	smb_request_t	*nsr = NULL;
+
+	mutex_enter(&session->s_tq_mutex);
+	if (!sr->sr_tq_counted) {
+		mutex_exit(&session->s_tq_mutex);
+		return;
+	}
+	sr->sr_tq_counted = B_FALSE;
+	nsr = list_remove_head(&session->s_tq_waitq);
+	if (nsr != NULL) {
+		session->s_tq_waiting--;
+		nsr->sr_tq_counted = B_TRUE;
+	} else {
+		session->s_tq_active--;
+	}
+	mutex_exit(&session->s_tq_mutex);
+
+	if (nsr != NULL) {
+		(void) taskq_dispatch(session->s_server->sv_worker_pool,
+		    nsr->sr_tq_func, nsr, TQ_SLEEP);
+	}
+}
+
 /*
  * smb_session_receiver
  *
@@ -587,8 +675,6 @@ smb_session_reader(smb_session_t *session)
 	smb_server_t	*sv;
 	smb_request_t	*sr = NULL;
 	smb_xprt_t	hdr;
-	uint8_t		*req_buf;
-	uint32_t	resid;
 	int		rc;
 
 	sv = session->s_server;
@@ -638,10 +724,22 @@ smb_session_reader(smb_session_t *session)
 		if ((sr = smb_request_alloc(session, hdr.xh_length)) == NULL)
 			break;
 
-		req_buf = (uint8_t *)sr->sr_request_buf;
-		resid = hdr.xh_length;
-
-		rc = smb_sorecv(session->sock, req_buf, resid);
+		if (sr->sr_request_buf != NULL) {
+			rc = smb_sorecv(session->sock,
+			    sr->sr_request_buf, hdr.xh_length);
+		} else {
+			/* Large request; receive into the mbuf chain. */
+			struct mbuf *m;
+
+			rc = 0;
+			for (m = sr->command.chain; m != NULL;
+			    m = m->m_next) {
+				rc = smb_sorecv(session->sock,
+				    m->m_data, m->m_len);
+				if (rc != 0)
+					break;
+			}
+		}
 		if (rc) {
 			smb_request_free(sr);
 			break;
@@ -754,6 +852,10 @@ smb_session_create(ksocket_t new_so, uint16_t port, smb_server_t *sv,
 
 	mutex_init(&session->s_credits_mutex, NULL, MUTEX_DEFAULT, NULL);
 
+	mutex_init(&session->s_tq_mutex, NULL, MUTEX_DEFAULT, NULL);
+	list_create(&session->s_tq_waitq, sizeof (smb_request_t),
+	    offsetof(smb_request_t, sr_tq_lnd));
+
 	smb_slist_constructor(&session->s_req_list, sizeof (smb_request_t),
 	    offsetof(smb_request_t, sr_session_lnd));
 
@@ -869,6 +971,11 @@ smb_session_delete(smb_session_t *session)
 
 	mutex_destroy(&session->s_credits_mutex);
 
+	ASSERT(session->s_tq_active == 0);
+	ASSERT(session->s_tq_waiting == 0);
+	list_destroy(&session->s_tq_waitq);
+	mutex_destroy(&session->s_tq_mutex);
+
 	smb_slist_destructor(&session->s_req_list);
 	smb_llist_destructor(&session->s_tree_list);
 	smb_llist_destructor(&session->s_user_list);
@@ -1370,8 +1477,24 @@ smb_request_alloc(smb_session_t *session, int req_length)
 	sr->command.max_bytes = req_length;
 	sr->reply.max_bytes = session->reply_max_bytes;
 	sr->sr_req_length = req_length;
-	if (req_length)
-		sr->sr_request_buf = kmem_alloc(req_length, KM_SLEEP);
+	if (req_length != 0) {
+		if (req_length <= SMB_REQ_MAX_SIZE ||
+		    (session->srv_cap & SMB2_CAP_ENCRYPTION) != 0) {
+			sr->sr_request_buf = kmem_alloc(req_length, KM_SLEEP);
+		} else {
+			/*
+			 * Large multi-credit request.  Receive into a
+			 * chain of cluster mbufs rather than one large
+			 * contiguous allocation.  Sessions that may
+			 * use encryption stay with the flat buffer,
+			 * which in-place decryption requires.  See
+			 * smb3_decrypt_sr, smb3_decrypt_final.
+			 */
+			MBC_ATTACH_MBUF(&sr->command,
+			    smb_mbuf_alloc_chain(req_length));
+			sr->command.max_bytes = req_length;
+		}
+	}
 	sr->sr_magic = SMB_REQ_MAGIC;
 	sr->sr_state = SMB_REQ_STATE_INITIALIZING;
 
@@ -1396,6 +1519,8 @@ smb_request_alloc(smb_session_t *session, int req_length)
 		/* Disallow new requests in these states. */
 		if (sr->sr_request_buf)
 			kmem_free(sr->sr_request_buf, sr->sr_req_length);
+		if (sr->command.chain)
+			m_freem(sr->command.chain);
 		sr->session = NULL;
 		sr->sr_magic = 0;
 		mutex_destroy(&sr->sr_mutex);
@@ -1439,6 +1564,9 @@ smb_request_free(smb_request_t *sr)
 	smb_llist_flush(&sr->session->s_tree_list);
 	smb_llist_flush(&sr->session->s_user_list);
 
+	/* Pass our worker pool slot (if any) to the next waiter. */
+	smb_session_disp_release(sr);
+
 	smb_slist_remove(&sr->session->s_req_list, sr);
 
 	sr->session = NULL;
@@ -508,6 +508,9 @@ sonode_constructor(void *buf, void *cdrarg, int kmflags)
 	so->so_krecv_cb = NULL;
 	so->so_krecv_arg = NULL;
 
+	so->so_kaio_notify = NULL;
+	so->so_kaio = NULL;
+
 	return (0);
 }
 
@@ -665,6 +668,11 @@ sonode_fini(struct sonode *so)
 	so->so_krecv_cb = NULL;
 	so->so_krecv_arg = NULL;
 
+	/* Async I/O state is torn down before the last ksocket reference */
+	ASSERT(so->so_kaio == NULL);
+	so->so_kaio_notify = NULL;
+	so->so_kaio = NULL;
+
 	ASSERT(list_is_empty(&so->so_acceptq_list));
 	ASSERT(list_is_empty(&so->so_acceptq_defer));
 	ASSERT(!list_link_active(&so->so_acceptq_node));
@@ -815,6 +815,39 @@ again1:
 					more = 0;
 					goto done;
 				}
+				/*
+				 * Bulk dequeue: if the message was consumed
+				 * in full and the caller still wants data,
+				 * keep claiming queued M_DATA messages
+				 * instead of paying a so_lock round trip
+				 * for each one. The queue can be walked
+				 * without so_lock as there can only be one
+				 * reader; the accounting for everything
+				 * claimed here is settled in a single pass
+				 * below. Atomic (datagram) sockets must
+				 * return one message at a time.
+				 */
+				while (mp == NULL && savemp == NULL &&
+				    !(so->so_mode & SM_ATOMIC) &&
+				    oobmark == 0 && !(flags & MSG_PEEK) &&
+				    uiop->uio_resid > 0 &&
+				    (nmp = so->so_rcv_q_head) != NULL &&
+				    DB_TYPE(nmp) == M_DATA &&
+				    !(DB_FLAGS(nmp) & DBLK_UIOA)) {
+					ASSERT(nmp->b_prev != NULL);
+					last_tail = nmp->b_prev;
+					nmp->b_prev = NULL;
+					so->so_rcv_q_head = nmp->b_next;
+					if (so->so_rcv_q_head == NULL)
+						so->so_rcv_q_last_head = NULL;
+					nmp->b_next = NULL;
+					mp = socopyoutuio(nmp, uiop, INFPSZ,
+					    &error);
+					if (error != 0) {
+						more = 0;
+						goto done;
+					}
+				}
 				ASSERT(oldresid >= uiop->uio_resid);
 				copied = oldresid - uiop->uio_resid;
 				if (oldresid > uiop->uio_resid)
@@ -1384,7 +1417,7 @@ socket_init_common(struct sonode *so, struct sonode *pso, int flags, cred_t *cr)
 		}
 	}
 
-	if (uioasync.enabled)
+	if (uioasync.enabled || uioa_swcopy)
 		sod_sock_init(so);
 
 	/* put an extra reference on the socket for the protocol */
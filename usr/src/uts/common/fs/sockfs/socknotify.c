@@ -76,6 +76,7 @@ so_notify_connected(struct sonode *so)
 
 	if (IS_KERNEL_SOCKET(so)) {
 		KSOCKET_CALLBACK(so, connected, 0);
+		KSOCKET_AIO_NOTIFY(so, SO_KAIO_SEND);
 		mutex_exit(&so->so_lock);
 	} else {
 		socket_sendsig(so, SOCKETSIG_WRITE);
@@ -102,6 +103,7 @@ so_notify_disconnecting(struct sonode *so)
 
 	if (IS_KERNEL_SOCKET(so)) {
 		KSOCKET_CALLBACK(so, cantsendmore, 0);
+		KSOCKET_AIO_NOTIFY(so, SO_KAIO_SEND);
 		mutex_exit(&so->so_lock);
 	} else {
 		if (sigev != 0)
@@ -137,6 +139,7 @@ so_notify_disconnected(struct sonode *so, boolean_t connfailed, int error)
 		} else {
 			KSOCKET_CALLBACK(so, connectfailed, error);
 		}
+		KSOCKET_AIO_NOTIFY(so, SO_KAIO_RECV | SO_KAIO_SEND);
 		mutex_exit(&so->so_lock);
 	} else {
 		if (sigev != 0)
@@ -173,6 +176,7 @@ so_notify_writable(struct sonode *so)
 
 	if (IS_KERNEL_SOCKET(so)) {
 		KSOCKET_CALLBACK(so, cansend, 0);
+		KSOCKET_AIO_NOTIFY(so, SO_KAIO_SEND);
 		mutex_exit(&so->so_lock);
 	} else {
 		socket_sendsig(so, SOCKETSIG_WRITE);
@@ -199,6 +203,7 @@ so_notify_data(struct sonode *so, size_t qlen)
 
 	if (IS_KERNEL_SOCKET(so)) {
 		KSOCKET_CALLBACK(so, newdata, qlen);
+		KSOCKET_AIO_NOTIFY(so, SO_KAIO_RECV);
 		mutex_exit(&so->so_lock);
 	} else {
 		socket_sendsig(so, SOCKETSIG_READ);
@@ -227,6 +232,7 @@ so_notify_error(struct sonode *so)
 
 	if (IS_KERNEL_SOCKET(so)) {
 		KSOCKET_CALLBACK(so, error, 0);
+		KSOCKET_AIO_NOTIFY(so, SO_KAIO_RECV | SO_KAIO_SEND);
 		mutex_exit(&so->so_lock);
 	} else {
 		socket_sendsig(so, SOCKETSIG_WRITE|SOCKETSIG_READ);
@@ -298,6 +304,7 @@ so_notify_eof(struct sonode *so)
 
 	if (IS_KERNEL_SOCKET(so)) {
 		KSOCKET_CALLBACK(so, cantrecvmore, 0);
+		KSOCKET_AIO_NOTIFY(so, SO_KAIO_RECV);
 		mutex_exit(&so->so_lock);
 	} else {
 		if (sigev != 0)
@@ -687,8 +687,19 @@ accept(int sock, struct sockaddr *name, socklen_t *namelenp, int version,
 
 	ASSERT(MUTEX_NOT_HELD(&nso->so_lock));
 	if (namelen != 0) {
+		struct sockaddr_storage addrbuf;
+
+		/*
+		 * The peer address fits on the stack for all common
+		 * address families; only fall back to kmem_alloc for
+		 * transports with oversized addresses.
+		 */
 		addrlen = so->so_max_addr_len;
-		addrp = (struct sockaddr *)kmem_alloc(addrlen, KM_SLEEP);
+		if (addrlen <= sizeof (addrbuf))
+			addrp = (struct sockaddr *)&addrbuf;
+		else
+			addrp = (struct sockaddr *)kmem_alloc(addrlen,
+			    KM_SLEEP);
 
 		if ((error = socket_getpeername(nso, (struct sockaddr *)addrp,
 		    &addrlen, B_TRUE, CRED())) == 0) {
@@ -698,7 +709,8 @@ accept(int sock, struct sockaddr *name, socklen_t *namelenp, int version,
 			ASSERT(error == EINVAL || error == ENOTCONN);
 			error = ECONNABORTED;
 		}
-		kmem_free(addrp, so->so_max_addr_len);
+		if (addrp != (struct sockaddr *)&addrbuf)
+			kmem_free(addrp, so->so_max_addr_len);
 	}
 
 	if (error) {
@@ -2047,6 +2059,20 @@ sockconfig(int cmd, void *arg1, void *arg2, void *arg3, void *arg4)
  * to copy the data from the filesystem into our temporary network buffer.
  *
  * To disable caching, set sendfile_max_size to 0.
+ *
+ * Sendfile with cached pipelined reads.
+ * ------------------------------------
+ *
+ * The one copy scheme above reads and transmits in lock step, so a
+ * single thread never overlaps filesystem reads with network transmit.
+ * For large transfers that overlap is worth more than avoiding the
+ * thread hand-off: setting sendfile_async_size to a non-zero value
+ * routes copy-mode (non zero-copy) transfers of at least that many
+ * bytes through the same producer/consumer machinery as direct I/O,
+ * except that the reads go through the page cache. Reading sequentially
+ * through the cache also lets the filesystem drive its own readahead
+ * (e.g. ZFS prefetch), so the reader thread rarely waits for the disk.
+ * Zero-copy (segmap/vpm) transfers are not affected by this tunable.
  */
 
 uint_t sendfile_read_size = 1024 * 1024;
@@ -2057,6 +2083,11 @@ struct sendfile_stats sf_stats;
 struct sendfile_queue *snfq;
 clock_t snfq_timeout;
 off64_t sendfile_max_size;
+/*
+ * Copy-mode transfers of at least sendfile_async_size bytes are pipelined
+ * through the snfq reader threads (see above). Zero disables pipelining.
+ */
+off64_t sendfile_async_size;
 
 static void snf_enque(snf_req_t *, mblk_t *);
 static mblk_t *snf_deque(snf_req_t *);
@@ -2180,9 +2211,12 @@ snf_async_read(snf_req_t *sr)
 
 	/*
 	 * Ignore the error for filesystems that doesn't support DIRECTIO.
+	 * Cached requests leave the page cache (and its readahead) alone.
 	 */
-	(void) VOP_IOCTL(fp->f_vnode, _FIODIRECTIO, DIRECTIO_ON, 0,
-	    kcred, NULL, NULL);
+	if (sr->sr_operation == READ_OP) {
+		(void) VOP_IOCTL(fp->f_vnode, _FIODIRECTIO, DIRECTIO_ON, 0,
+		    kcred, NULL, NULL);
+	}
 
 	vp = sr->sr_vp;
 	if (vp->v_type == VSOCK) {
@@ -2243,8 +2277,10 @@ snf_async_read(snf_req_t *sr)
 		size -= ret_size;
 		fileoff += ret_size;
 	}
-	(void) VOP_IOCTL(fp->f_vnode, _FIODIRECTIO, DIRECTIO_OFF, 0,
-	    kcred, NULL, NULL);
+	if (sr->sr_operation == READ_OP) {
+		(void) VOP_IOCTL(fp->f_vnode, _FIODIRECTIO, DIRECTIO_OFF, 0,
+		    kcred, NULL, NULL);
+	}
 	mutex_enter(&sr->sr_lock);
 	sr->sr_read_error = error;
 	sr->sr_read_error |= SR_READ_DONE;
@@ -2309,7 +2345,14 @@ create_thread(int operation, struct vnode *vp, file_t *fp,
 	 * store sd_qn_maxpsz into sr_maxpsz while we have stream head.
 	 * stream might be closed before thread returns from snf_async_read.
 	 */
-	if (stp != NULL && stp->sd_qn_maxpsz > 0) {
+	if (operation == READ_OP_CACHED) {
+		/*
+		 * Cached reads are not bound by the stream head; read in
+		 * sendfile_read_size chunks so each mblk handed to the
+		 * writer is worth the pipelining overhead.
+		 */
+		sr->sr_maxpsz = MAX(MAXBSIZE, sendfile_read_size);
+	} else if (stp != NULL && stp->sd_qn_maxpsz > 0) {
 		sr->sr_maxpsz = MIN(MAXBSIZE, stp->sd_qn_maxpsz);
 	} else {
 		sr->sr_maxpsz = MAXBSIZE;
@@ -2349,7 +2392,7 @@ create_thread(int operation, struct vnode *vp, file_t *fp,
 
 int
 snf_direct_io(file_t *fp, file_t *rfp, u_offset_t fileoff, u_offset_t size,
-    ssize_t *count)
+    int operation, ssize_t *count)
 {
 	snf_req_t *sr;
 	mblk_t *mp;
@@ -2366,7 +2409,7 @@ snf_direct_io(file_t *fp, file_t *rfp, u_offset_t fileoff, u_offset_t size,
 
 	vp = fp->f_vnode;
 	fflag = fp->f_flag;
-	if ((sr = create_thread(READ_OP, vp, rfp, fileoff, size)) == NULL)
+	if ((sr = create_thread(operation, vp, rfp, fileoff, size)) == NULL)
 		return (EAGAIN);
 
 	/*
@@ -2936,7 +2979,7 @@ sosendfile64(file_t *fp, file_t *rfp, const struct ksendfilevec64 *sfv,
 	if (sfv_len > sendfile_max_size) {
 		sf_stats.ss_file_not_cached++;
 		error = snf_direct_io(fp, rfp, sfv_off, (u_offset_t)sfv_len,
-		    &count);
+		    READ_OP, &count);
 		goto out;
 	}
 	fvp = rfp->f_vnode;
@@ -2985,6 +3028,15 @@ sosendfile64(file_t *fp, file_t *rfp, const struct ksendfilevec64 *sfv,
 		sf_stats.ss_file_segmap++;
 		error = snf_segmap(fp, fvp, sfv_off, (u_offset_t)sfv_len,
 		    &count, ((sfv->sfv_flag & SFV_NOWAIT) != 0));
+	} else if (sendfile_async_size > 0 && sfv_len >= sendfile_async_size) {
+		/*
+		 * Large copy-mode transfer; overlap the cached reads with
+		 * the transmit instead of doing them in lock step.
+		 */
+		VOP_RWUNLOCK(fvp, V_WRITELOCK_FALSE, NULL);
+		sf_stats.ss_file_cached_async++;
+		error = snf_direct_io(fp, rfp, sfv_off, (u_offset_t)sfv_len,
+		    READ_OP_CACHED, &count);
 	} else {
 		if (vp->v_type == VSOCK && stp == NULL) {
 			sonode_t *so = VTOSO(vp);
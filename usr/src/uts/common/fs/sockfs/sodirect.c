@@ -54,6 +54,17 @@
 
 static struct kmem_cache *sock_sod_cache;
 
+/*
+ * Historically uioa was withheld from loopback connections because the
+ * pre-sockfs-rewrite TCP fusion code had its own synchronous-streams
+ * receive path that bypassed the socket receive queue.  Fused
+ * connections now deliver through so_queue_msg() like everything else,
+ * so there is no longer a reason to leave their receive-side copyout
+ * on the CPU when a dcopy engine is available.  This tunable restores
+ * the old exclusion if needed.
+ */
+boolean_t sod_loopback_enabled = B_TRUE;
+
 /*
  * This function is called at the beginning of recvmsg().
  *
@@ -76,8 +87,9 @@ sod_rcv_init(struct sonode *so, int flags, struct uio **uiopp)
 	mutex_enter(&so->so_lock);
 	if (uiop->uio_resid >= uioasync.mincnt &&
 	    sodp != NULL && sodp->sod_enabled &&
-	    uioasync.enabled && !(flags & MSG_PEEK) &&
-	    !so->so_proto_props.sopp_loopback && so->so_filter_active == 0 &&
+	    (uioasync.enabled || uioa_swcopy) && !(flags & MSG_PEEK) &&
+	    (sod_loopback_enabled || !so->so_proto_props.sopp_loopback) &&
+	    so->so_filter_active == 0 &&
 	    !(so->so_state & SS_CANTRCVMORE)) {
 		/*
 		 * Big enough I/O for uioa min setup and an sodirect socket
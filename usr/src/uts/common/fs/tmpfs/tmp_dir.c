@@ -53,7 +53,7 @@ static int tdiraddentry(struct tmpnode *, struct tmpnode *, char *,
 
 
 #define	T_HASH_SIZE	8192		/* must be power of 2 */
-#define	T_MUTEX_SIZE	64
+#define	T_MUTEX_SIZE	512
 
 /* Non-static so compilers won't constant-fold these away. */
 clock_t tmpfs_rename_backoff_delay = 1;
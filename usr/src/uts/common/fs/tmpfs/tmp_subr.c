@@ -38,6 +38,7 @@
 #include <sys/cred.h>
 #include <sys/kmem.h>
 #include <sys/atomic.h>
+#include <sys/cpuvar.h>
 #include <sys/policy.h>
 #include <sys/fs/tmp.h>
 #include <sys/fs/tmpnode.h>
@@ -98,13 +99,66 @@ tmp_sticky_remove_access(struct tmpnode *dir, struct tmpnode *entry,
 	return (0);
 }
 
+/*
+ * tmp_kmemspace is charged by every tmpfs metadata allocation and free
+ * in the system, and a single atomic counter becomes a contended cache
+ * line when many threads create and remove files at once.  Updates are
+ * therefore accumulated in an array of cache line sized cells indexed
+ * by CPU, and a cell is only folded into tmp_kmemspace once it has
+ * soaked up TMP_KMEM_SLACK bytes of change in either direction.
+ * tmp_kmemspace thus holds the aggregated value, accurate to within
+ * TMP_KMEM_NCELL * TMP_KMEM_SLACK bytes; tmp_kmem_inuse() folds the
+ * cells back in for callers wanting a precise figure.  The limit check
+ * in tmp_memalloc() can overshoot tmpfs_maxkmem by the same bound,
+ * which is a few MB against a limit that defaults to a quarter of
+ * kernel memory.
+ */
+#define	TMP_KMEM_NCELL	64		/* must be power of 2 */
+#define	TMP_KMEM_SLACK	(32 * KILOBYTE)
+
+typedef struct tmp_kmem_cell {
+	long	tkc_space;
+	char	tkc_pad[64 - sizeof (long)];
+} tmp_kmem_cell_t;
+
+static tmp_kmem_cell_t tmp_kmem_cell[TMP_KMEM_NCELL];
+
+static void
+tmp_kmem_charge(long size)
+{
+	tmp_kmem_cell_t *tkc;
+	long space;
+
+	tkc = &tmp_kmem_cell[CPU_SEQID & (TMP_KMEM_NCELL - 1)];
+	space = (long)atomic_add_long_nv((ulong_t *)&tkc->tkc_space, size);
+	if (space >= TMP_KMEM_SLACK || space <= -TMP_KMEM_SLACK) {
+		atomic_add_long((ulong_t *)&tkc->tkc_space, -space);
+		atomic_add_long(&tmp_kmemspace, space);
+	}
+}
+
+/*
+ * Current tmpfs kernel memory usage, with the unflushed per-CPU cells
+ * folded in.
+ */
+size_t
+tmp_kmem_inuse(void)
+{
+	long space = (long)tmp_kmemspace;
+	int ix;
+
+	for (ix = 0; ix < TMP_KMEM_NCELL; ix++)
+		space += tmp_kmem_cell[ix].tkc_space;
+	return (space > 0 ? (size_t)space : 0);
+}
+
 /*
  * Allocate zeroed memory if tmpfs_maxkmem has not been exceeded
  * or the 'musthave' flag is set.  'musthave' allocations should
  * always be subordinate to normal allocations so that tmpfs_maxkmem
- * can't be exceeded by more than a few KB.  Example: when creating
- * a new directory, the tmpnode is a normal allocation; if that
- * succeeds, the dirents for "." and ".." are 'musthave' allocations.
+ * can't be exceeded by much.  Example: when creating a new directory,
+ * the tmpnode is a normal allocation; if that succeeds, the dirents
+ * for "." and ".." are 'musthave' allocations.
  */
 void *
 tmp_memalloc(size_t size, int musthave)
@@ -112,11 +166,11 @@ tmp_memalloc(size_t size, int musthave)
 	static time_t last_warning;
 	time_t now;
 
-	if (atomic_add_long_nv(&tmp_kmemspace, size) < tmpfs_maxkmem ||
-	    musthave)
+	if (tmp_kmemspace + size < tmpfs_maxkmem || musthave) {
+		tmp_kmem_charge((long)size);
 		return (kmem_zalloc(size, KM_SLEEP));
+	}
 
-	atomic_add_long(&tmp_kmemspace, -size);
 	now = gethrestime_sec();
 	if (last_warning != now) {
 		last_warning = now;
@@ -129,7 +183,7 @@ void
 tmp_memfree(void *cp, size_t size)
 {
 	kmem_free(cp, size);
-	atomic_add_long(&tmp_kmemspace, -size);
+	tmp_kmem_charge(-(long)size);
 }
 
 /*
@@ -39,6 +39,7 @@
 #include <sys/mode.h>
 #include <sys/errno.h>
 #include <sys/kmem.h>
+#include <sys/atomic.h>
 #include <vm/seg.h>
 #include <vm/seg_map.h>
 #include <vm/anon.h>
@@ -88,9 +89,7 @@ tmp_resv(
 	 * update statistics
 	 */
 	if (pagecreate) {
-		mutex_enter(&tm->tm_contents);
-		tm->tm_anonmem += pages;
-		mutex_exit(&tm->tm_contents);
+		atomic_add_long(&tm->tm_anonmem, pages);
 
 		TRACE_2(TR_FAC_VM, TR_ANON_TMPFS, "anon tmpfs:%p %lu",
 		    tp, delta);
@@ -115,9 +114,7 @@ tmp_unresv(
 
 	anon_unresv_zone(delta, tm->tm_vfsp->vfs_zone);
 
-	mutex_enter(&tm->tm_contents);
-	tm->tm_anonmem -= btopr(delta);
-	mutex_exit(&tm->tm_contents);
+	atomic_add_long(&tm->tm_anonmem, -(long)btopr(delta));
 
 	TRACE_2(TR_FAC_VM, TR_ANON_TMPFS, "anon tmpfs:%p %lu", tp, delta);
 }
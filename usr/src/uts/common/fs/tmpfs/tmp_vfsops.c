@@ -646,8 +646,8 @@ tmp_statvfs(struct vfs *vfsp, struct statvfs64 *sbp)
 	 * available to tmpfs.  This is fairly inaccurate since it doesn't
 	 * take into account the names stored in the directory entries.
 	 */
-	if (tmpfs_maxkmem > tmp_kmemspace)
-		sbp->f_ffree = (tmpfs_maxkmem - tmp_kmemspace) /
+	if (tmpfs_maxkmem > tmp_kmem_inuse())
+		sbp->f_ffree = (tmpfs_maxkmem - tmp_kmem_inuse()) /
 		    (sizeof (struct tmpnode) + sizeof (struct tdirent));
 	else
 		sbp->f_ffree = 0;
@@ -3040,9 +3040,18 @@ ud_rdip(struct ud_inode *ip, struct uio *uio, int32_t ioflag, cred_t *cr)
 		}
 #endif
 
-		base = segmap_getmapflt(segkmap, vp, (off + mapon),
-		    (uint32_t)n, 1, S_READ);
-		error = uiomove(base + mapon, (long)n, UIO_READ, uio);
+		if (vpm_enable) {
+			/*
+			 * Copy data through the kpm mappings of the
+			 * cached pages, bypassing segmap.
+			 */
+			error = vpm_data_copy(vp, (off + mapon),
+			    (uint_t)n, uio, 1, NULL, 0, S_READ);
+		} else {
+			base = segmap_getmapflt(segkmap, vp, (off + mapon),
+			    (uint32_t)n, 1, S_READ);
+			error = uiomove(base + mapon, (long)n, UIO_READ, uio);
+		}
 
 		flags = 0;
 		if (!error) {
@@ -3065,9 +3074,17 @@ ud_rdip(struct ud_inode *ip, struct uio *uio, int32_t ioflag, cred_t *cr)
 				flags &= ~SM_ASYNC;
 				flags |= SM_WRITE;
 			}
-			error = segmap_release(segkmap, base, flags);
-		} else    {
-			(void) segmap_release(segkmap, base, flags);
+			if (vpm_enable) {
+				error = vpm_sync_pages(vp, off, n, flags);
+			} else {
+				error = segmap_release(segkmap, base, flags);
+			}
+		} else {
+			if (vpm_enable) {
+				(void) vpm_sync_pages(vp, off, n, flags);
+			} else {
+				(void) segmap_release(segkmap, base, flags);
+			}
 		}
 
 #ifndef __lock_lint
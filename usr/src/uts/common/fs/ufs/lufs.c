@@ -128,6 +128,71 @@ struct delta_kstats {
 uint64_t delta_stats[DT_MAX];
 uint64_t roll_stats[DT_MAX];
 
+/*
+ * Per-log occupancy kstat ("ufs_log:<minor>:occupancy"), for sizing
+ * the log.  If "used" stays close to "logsize" under load, metadata
+ * operations are stalling in logmap_make_space and a larger log
+ * would help.
+ */
+struct occ_kstats {
+	kstat_named_t	oc_logsize;
+	kstat_named_t	oc_used;
+	kstat_named_t	oc_resv;
+	kstat_named_t	oc_maxresv;
+};
+
+static const struct occ_kstats occ_kstats_template = {
+	{ "logsize",	KSTAT_DATA_UINT64 },
+	{ "used",	KSTAT_DATA_UINT64 },
+	{ "reserved",	KSTAT_DATA_UINT64 },
+	{ "maxresv",	KSTAT_DATA_UINT64 }
+};
+
+static int
+lufs_occ_kstat_update(kstat_t *ksp, int rw)
+{
+	ml_unit_t	*ul = ksp->ks_private;
+	struct occ_kstats *ocp = ksp->ks_data;
+	off_t		used;
+
+	if (rw == KSTAT_WRITE)
+		return (EACCES);
+
+	/*
+	 * Unlocked snapshot of the circular log occupancy;
+	 * this is observability only, so a racy read is fine.
+	 */
+	if (ul->un_tail_lof >= ul->un_head_lof)
+		used = ul->un_tail_lof - ul->un_head_lof;
+	else
+		used = (ul->un_eol_lof - ul->un_head_lof) +
+		    (ul->un_tail_lof - ul->un_bol_lof);
+
+	ocp->oc_logsize.value.ui64 = ul->un_logsize;
+	ocp->oc_used.value.ui64 = used;
+	ocp->oc_resv.value.ui64 = ul->un_resv;
+	ocp->oc_maxresv.value.ui64 = ul->un_maxresv;
+	return (0);
+}
+
+static void
+lufs_occ_kstat_init(ml_unit_t *ul)
+{
+	kstat_t	*ksp;
+
+	ksp = kstat_create("ufs_log", getminor(ul->un_dev), "occupancy",
+	    "ufs", KSTAT_TYPE_NAMED,
+	    sizeof (occ_kstats_template) / sizeof (kstat_named_t), 0);
+	if (ksp != NULL) {
+		bcopy(&occ_kstats_template, ksp->ks_data,
+		    sizeof (occ_kstats_template));
+		ksp->ks_private = ul;
+		ksp->ks_update = lufs_occ_kstat_update;
+		kstat_install(ksp);
+	}
+	ul->un_occ_ksp = ksp;
+}
+
 /*
  * General logging kstats
  */
@@ -253,6 +318,11 @@ lufs_unsnarf(ufsvfs_t *ufsvfsp)
 	if (ul->un_matamap)
 		ul->un_matamap = map_put(ul->un_matamap);
 
+	if (ul->un_occ_ksp != NULL) {
+		kstat_delete(ul->un_occ_ksp);
+		ul->un_occ_ksp = NULL;
+	}
+
 	mutex_destroy(&ul->un_log_mutex);
 	mutex_destroy(&ul->un_state_mutex);
 
@@ -393,6 +463,7 @@ lufs_snarf(ufsvfs_t *ufsvfsp, struct fs *fs, int ronly)
 		ul->un_matamap = map_get(ul, matamaptype, DELTAMAP_NHASH);
 	mutex_init(&ul->un_log_mutex, NULL, MUTEX_DEFAULT, NULL);
 	mutex_init(&ul->un_state_mutex, NULL, MUTEX_DEFAULT, NULL);
+	lufs_occ_kstat_init(ul);
 
 	/*
 	 * Aquire the ufs_scan_lock before linking the mtm data
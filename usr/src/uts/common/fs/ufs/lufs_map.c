@@ -226,10 +226,21 @@ deltamap_add(
 	int32_t		hnb;
 	mapentry_t	*me;
 	mapentry_t	**mep;
+	mapentry_t	*free_me;
 
 	ASSERT(((mtm->mtm_debug & MT_CHECK_MAP) == 0) ||
 	    map_check_linkage(mtm));
 
+	/*
+	 * Most calls add a single delta, so get (and zero) the first
+	 * mapentry before taking the map mutex.  This keeps allocation
+	 * out of the hot mtm_mutex hold time in the common case, where
+	 * concurrent metadata updates all funnel through this lock.
+	 * If the delta turns out to be a duplicate, free it below.
+	 */
+	free_me = kmem_cache_alloc(mapentry_cache, KM_SLEEP);
+	bzero(free_me, sizeof (mapentry_t));
+
 	mutex_enter(&mtm->mtm_mutex);
 
 	for (hnb = 0; nb; nb -= hnb, mof += hnb) {
@@ -293,17 +304,23 @@ deltamap_add(
 		delta_stats[dtyp]++;
 
 		/*
-		 * get a mapentry
+		 * get a mapentry; usually the one allocated above.
 		 * May need to drop & re-grab the mtm_mutex
 		 * and then recheck for a duplicate
 		 */
-		me = kmem_cache_alloc(mapentry_cache, KM_NOSLEEP);
-		if (me == NULL) {
-			mutex_exit(&mtm->mtm_mutex);
-			me = kmem_cache_alloc(mapentry_cache, KM_SLEEP);
-			mutex_enter(&mtm->mtm_mutex);
+		if (free_me != NULL) {
+			me = free_me;
+			free_me = NULL;
+		} else {
+			me = kmem_cache_alloc(mapentry_cache, KM_NOSLEEP);
+			if (me == NULL) {
+				mutex_exit(&mtm->mtm_mutex);
+				me = kmem_cache_alloc(mapentry_cache,
+				    KM_SLEEP);
+				mutex_enter(&mtm->mtm_mutex);
+			}
+			bzero(me, sizeof (mapentry_t));
 		}
-		bzero(me, sizeof (mapentry_t));
 
 		/*
 		 * initialize and put in deltamap
@@ -326,6 +343,9 @@ deltamap_add(
 	}
 	mutex_exit(&mtm->mtm_mutex);
 
+	if (free_me != NULL)
+		kmem_cache_free(mapentry_cache, free_me);
+
 	ASSERT(((mtm->mtm_debug & MT_CHECK_MAP) == 0) ||
 	    map_check_linkage(mtm));
 }
@@ -3003,6 +3003,14 @@ vfs_mnttab_modtimeupd()
 	vfs_mnttab_writeop();
 }
 
+/*
+ * The elfexec module's ELF header cache holds the vnodes of cached
+ * executables; it registers this hook at load time so dounmount() can
+ * purge the entries of the unmounting file system (genunix cannot call
+ * into an exec module directly).
+ */
+void (*elf_hdr_cache_purge_hook)(struct vfs *) = NULL;
+
 int
 dounmount(struct vfs *vfsp, int flag, cred_t *cr)
 {
@@ -3018,9 +3026,16 @@ dounmount(struct vfs *vfsp, int flag, cred_t *cr)
 	ASSERT(coveredvp == NULL || vn_vfswlock_held(coveredvp));
 
 	/*
-	 * Purge all dnlc entries for this vfs.
+	 * Purge all dnlc entries for this vfs, drop the full path
+	 * lookup cache and any cached ELF headers so they hold no
+	 * vnodes from this file system, and force out any releases
+	 * parked for deferred inactivation.
 	 */
 	(void) dnlc_purge_vfsp(vfsp, 0);
+	pathcache_purge();
+	if (elf_hdr_cache_purge_hook != NULL)
+		(*elf_hdr_cache_purge_hook)(vfsp);
+	vn_rele_drain();
 
 	/* For forcible umount, skip VFS_SYNC() since it may hang */
 	if ((flag & MS_FORCE) == 0)
@@ -4247,6 +4262,8 @@ vfsinit(void)
 	xattr_init();
 
 	reparse_point_init();
+
+	pathcache_init();
 }
 
 vfs_t *
@@ -69,9 +69,12 @@
 #include <sys/fcntl.h>
 #include <fs/fs_subr.h>
 #include <sys/taskq.h>
+#include <sys/cpuvar.h>
+#include <sys/disp.h>
 #include <fs/fs_reparse.h>
 #include <sys/time.h>
 #include <sys/sdt.h>
+#include <sys/zone.h>
 
 /* Determine if this vnode is a file that is read-only */
 #define	ISROFILE(vp)	\
@@ -229,6 +232,41 @@ ushort_t vttoif_tab[] = {
 
 kmem_cache_t *vn_cache;
 
+/*
+ * Deferred batched inactivation.
+ *
+ * When vn_rele_defer is set, vn_rele() does not call VOP_INACTIVE()
+ * inline on the last release.  Instead the vnode is parked in a
+ * per-CPU cell, and once a cell fills up the whole batch is handed to
+ * the vn_inactive taskq.  File churn workloads that release vnodes
+ * from many threads at once then pay one taskq dispatch per
+ * VN_DEFER_NBATCH releases rather than a VOP_INACTIVE (and whatever
+ * file system locking it entails) on every unlink.  File systems must
+ * already tolerate a delayed inactive call racing with a fresh hold
+ * (see vn_rele_async()), so deferral introduces no new races; it only
+ * delays when the space of unlinked files is reclaimed, which is why
+ * it is off by default.  dounmount() calls vn_rele_drain() so pending
+ * inactives can never keep a file system busy.
+ */
+int vn_rele_defer = 0;
+
+#define	VN_DEFER_NCELL	64		/* must be power of 2 */
+#define	VN_DEFER_NBATCH	32
+
+typedef struct vn_defer_cell {
+	kmutex_t	vdc_lock;
+	int		vdc_cnt;
+	vnode_t		*vdc_vp[VN_DEFER_NBATCH];
+} vn_defer_cell_t;
+
+typedef struct vn_defer_batch {
+	int		vdb_cnt;
+	vnode_t		*vdb_vp[VN_DEFER_NBATCH];
+} vn_defer_batch_t;
+
+static vn_defer_cell_t vn_defer_cell[VN_DEFER_NCELL];
+static taskq_t *vn_inactive_taskq;
+
 
 /*
  * Vnode operations vector.
@@ -824,6 +862,80 @@ done:
 	return (error);
 }
 
+/*
+ * Inactivate a batch of vnodes collected by vn_rele_defer_inactive().
+ */
+static void
+vn_rele_batch_task(void *arg)
+{
+	vn_defer_batch_t *vdb = arg;
+	int ix;
+
+	for (ix = 0; ix < vdb->vdb_cnt; ix++)
+		VOP_INACTIVE(vdb->vdb_vp[ix], CRED(), NULL);
+	kmem_free(vdb, sizeof (*vdb));
+}
+
+/*
+ * Park a vnode whose last reference has been released in the local
+ * CPU's deferral cell, pushing the accumulated batch to the
+ * vn_inactive taskq when the cell fills. If memory is too tight to
+ * extract a batch, fall back to inactivating inline.
+ */
+static void
+vn_rele_defer_inactive(vnode_t *vp)
+{
+	vn_defer_cell_t *vdc;
+	vn_defer_batch_t *vdb = NULL;
+
+	vdc = &vn_defer_cell[CPU_SEQID & (VN_DEFER_NCELL - 1)];
+	mutex_enter(&vdc->vdc_lock);
+	if (vdc->vdc_cnt == VN_DEFER_NBATCH) {
+		vdb = kmem_alloc(sizeof (*vdb), KM_NOSLEEP);
+		if (vdb == NULL) {
+			mutex_exit(&vdc->vdc_lock);
+			VOP_INACTIVE(vp, CRED(), NULL);
+			return;
+		}
+		vdb->vdb_cnt = vdc->vdc_cnt;
+		bcopy(vdc->vdc_vp, vdb->vdb_vp,
+		    vdc->vdc_cnt * sizeof (vnode_t *));
+		vdc->vdc_cnt = 0;
+	}
+	vdc->vdc_vp[vdc->vdc_cnt++] = vp;
+	mutex_exit(&vdc->vdc_lock);
+
+	if (vdb != NULL && taskq_dispatch(vn_inactive_taskq,
+	    vn_rele_batch_task, vdb, TQ_NOSLEEP) == TASKQID_INVALID)
+		vn_rele_batch_task(vdb);
+}
+
+/*
+ * Inactivate everything parked in the deferral cells and wait for the
+ * vn_inactive taskq to finish whatever it already has, so no deferred
+ * release can hold a vnode on a file system about to be unmounted.
+ */
+void
+vn_rele_drain(void)
+{
+	vn_defer_cell_t *vdc;
+	vnode_t *vps[VN_DEFER_NBATCH];
+	int cell, cnt, ix;
+
+	for (cell = 0; cell < VN_DEFER_NCELL; cell++) {
+		vdc = &vn_defer_cell[cell];
+		mutex_enter(&vdc->vdc_lock);
+		cnt = vdc->vdc_cnt;
+		bcopy(vdc->vdc_vp, vps, cnt * sizeof (vnode_t *));
+		vdc->vdc_cnt = 0;
+		mutex_exit(&vdc->vdc_lock);
+		for (ix = 0; ix < cnt; ix++)
+			VOP_INACTIVE(vps[ix], CRED(), NULL);
+	}
+	if (vn_inactive_taskq != NULL)
+		taskq_wait(vn_inactive_taskq);
+}
+
 /*
  * Release a vnode.  Call VOP_INACTIVE on last reference or
  * decrement reference count.
@@ -841,6 +953,10 @@ vn_rele(vnode_t *vp)
 	mutex_enter(&vp->v_lock);
 	if (vp->v_count == 1) {
 		mutex_exit(&vp->v_lock);
+		if (vn_rele_defer && vn_inactive_taskq != NULL) {
+			vn_rele_defer_inactive(vp);
+			return;
+		}
 		VOP_INACTIVE(vp, CRED(), NULL);
 		return;
 	}
@@ -2374,6 +2490,10 @@ vn_create_cache(void)
 	vn_cache = kmem_cache_create("vn_cache", sizeof (struct vnode),
 	    VNODE_ALIGN, vn_cache_constructor, vn_cache_destructor, NULL, NULL,
 	    NULL, 0);
+	kmem_cache_set_zone_class(vn_cache, ZONE_KMEM_CLASS_VNODE);
+
+	vn_inactive_taskq = taskq_create("vn_inactive", 4, minclsyspri,
+	    1, INT_MAX, TASKQ_PREPOPULATE);
 }
 
 void
@@ -2584,6 +2704,7 @@ vnevent_support(vnode_t *vp, caller_context_t *ct)
 void
 vnevent_rename_src(vnode_t *vp, vnode_t *dvp, char *name, caller_context_t *ct)
 {
+	pathcache_inval();
 	if (vp == NULL || vp->v_femhead == NULL) {
 		return;
 	}
@@ -2594,6 +2715,7 @@ void
 vnevent_rename_dest(vnode_t *vp, vnode_t *dvp, char *name,
     caller_context_t *ct)
 {
+	pathcache_inval();
 	if (vp == NULL || vp->v_femhead == NULL) {
 		return;
 	}
@@ -2612,6 +2734,7 @@ vnevent_rename_dest_dir(vnode_t *vp, caller_context_t *ct)
 void
 vnevent_remove(vnode_t *vp, vnode_t *dvp, char *name, caller_context_t *ct)
 {
+	pathcache_inval();
 	if (vp == NULL || vp->v_femhead == NULL) {
 		return;
 	}
@@ -2621,6 +2744,7 @@ vnevent_remove(vnode_t *vp, vnode_t *dvp, char *name, caller_context_t *ct)
 void
 vnevent_rmdir(vnode_t *vp, vnode_t *dvp, char *name, caller_context_t *ct)
 {
+	pathcache_inval();
 	if (vp == NULL || vp->v_femhead == NULL) {
 		return;
 	}
@@ -2678,6 +2802,7 @@ vnevent_link(vnode_t *vp, caller_context_t *ct)
 void
 vnevent_mountedover(vnode_t *vp, caller_context_t *ct)
 {
+	pathcache_inval();
 	if (vp == NULL || vp->v_femhead == NULL) {
 		return;
 	}
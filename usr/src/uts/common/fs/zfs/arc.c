@@ -294,6 +294,7 @@
 #include <vm/anon.h>
 #include <sys/fs/swapnode.h>
 #include <sys/dnlc.h>
+#include <sys/lgrp.h>
 #endif
 #include <sys/callb.h>
 #include <sys/kstat.h>
@@ -338,6 +339,20 @@ uint_t arc_reduce_dnlc_percent = 3;
  */
 int zfs_arc_evict_batch_limit = 10;
 
+/*
+ * On large NUMA machines, a single thread walking every multilist sublist
+ * in arc_evict_state() pulls sublist locks and list nodes across sockets.
+ * When this tunable is set (and the machine has more than one lgroup),
+ * the sublists of each arc state are partitioned into one band per
+ * lgroup and eviction runs one taskq thread per band, so each thread
+ * keeps re-acquiring the same small set of sublist locks instead of
+ * bouncing all of them between nodes.
+ */
+int zfs_arc_numa_evict = 0;
+
+static taskq_t		*arc_evict_taskq;
+static int		arc_evict_nbands;
+
 /* number of seconds before growing cache again */
 int arc_grow_retry = 60;
 
@@ -414,6 +429,18 @@ uint_t zfs_arc_pool_dirty_percent = 20;		/* each pool's anon allowance */
 
 boolean_t zfs_compressed_arc_enabled = B_TRUE;
 
+/*
+ * When a buffer ages out of the MFU state, its data may be recompressed
+ * with LZ4 and retained in DRAM while the header sits on the ghost list,
+ * so that a subsequent hit is serviced by decompression rather than a
+ * disk read. This caps the total memory the retained copies may consume;
+ * zero disables the tier.
+ */
+uint64_t zfs_arc_cghost_max = 0;
+
+/* Bytes currently held by the compressed ghost tier. */
+static uint64_t arc_cghost_size = 0;
+
 /* The 6 states: */
 static arc_state_t ARC_anon;
 static arc_state_t ARC_mru;
@@ -448,6 +475,12 @@ arc_stats_t arc_stats = {
 	{ "evict_l2_eligible_mru",	KSTAT_DATA_UINT64 },
 	{ "evict_l2_ineligible",	KSTAT_DATA_UINT64 },
 	{ "evict_l2_skip",		KSTAT_DATA_UINT64 },
+	{ "cghost_size",		KSTAT_DATA_UINT64 },
+	{ "cghost_stashes",		KSTAT_DATA_UINT64 },
+	{ "cghost_stash_skips",		KSTAT_DATA_UINT64 },
+	{ "cghost_hits",		KSTAT_DATA_UINT64 },
+	{ "cghost_frees",		KSTAT_DATA_UINT64 },
+	{ "cghost_restore_ns",		KSTAT_DATA_UINT64 },
 	{ "hash_elements",		KSTAT_DATA_UINT64 },
 	{ "hash_elements_max",		KSTAT_DATA_UINT64 },
 	{ "hash_collisions",		KSTAT_DATA_UINT64 },
@@ -510,6 +543,7 @@ arc_stats_t arc_stats = {
 	{ "l2_log_blk_asize",		KSTAT_DATA_UINT64 },
 	{ "l2_log_blk_count",		KSTAT_DATA_UINT64 },
 	{ "l2_data_to_meta_ratio",	KSTAT_DATA_UINT64 },
+	{ "l2_rebuild_inprogress",	KSTAT_DATA_UINT64 },
 	{ "l2_rebuild_success",		KSTAT_DATA_UINT64 },
 	{ "l2_rebuild_unsupported",	KSTAT_DATA_UINT64 },
 	{ "l2_rebuild_io_errors",	KSTAT_DATA_UINT64 },
@@ -3257,6 +3291,7 @@ arc_hdr_realloc(arc_buf_hdr_t *hdr, kmem_cache_t *old, kmem_cache_t *new)
 		VERIFY(!HDR_L2_WRITING(hdr));
 		VERIFY3P(hdr->b_l1hdr.b_pabd, ==, NULL);
 		ASSERT(!HDR_HAS_RABD(hdr));
+		ASSERT3P(hdr->b_l1hdr.b_cghost_abd, ==, NULL);
 
 #ifdef ZFS_DEBUG
 		if (hdr->b_l1hdr.b_thawed != NULL) {
@@ -3690,6 +3725,7 @@ arc_hdr_destroy(arc_buf_hdr_t *hdr)
 		    hdr->b_l1hdr.b_bufcnt > 0);
 		ASSERT(zfs_refcount_is_zero(&hdr->b_l1hdr.b_refcnt));
 		ASSERT3P(hdr->b_l1hdr.b_state, ==, arc_anon);
+		arc_cghost_free(hdr);
 	}
 	ASSERT(!HDR_IO_IN_PROGRESS(hdr));
 	ASSERT(!HDR_IN_HASH_TABLE(hdr));
@@ -3788,6 +3824,140 @@ arc_buf_destroy(arc_buf_t *buf, void* tag)
 	mutex_exit(hash_lock);
 }
 
+/*
+ * Compressed ghost tier.
+ *
+ * When zfs_arc_cghost_max is set, buffers aging out of the MFU state
+ * keep an LZ4-compressed copy of their data attached to the header
+ * while it sits on the ghost list. A subsequent hit on such a header
+ * is serviced by decompressing the retained copy instead of reading
+ * the block back from disk. Payloads whose headers are accessed,
+ * evicted from the ghost list, or destroyed are freed, so the tier's
+ * footprint ages out together with the ghost lists themselves.
+ */
+
+/* Discard the retained copy attached to a header, if any. */
+static void
+arc_cghost_free(arc_buf_hdr_t *hdr)
+{
+	abd_t *cabd = hdr->b_l1hdr.b_cghost_abd;
+	uint32_t psize = hdr->b_l1hdr.b_cghost_psize;
+
+	if (cabd == NULL)
+		return;
+
+	hdr->b_l1hdr.b_cghost_abd = NULL;
+	hdr->b_l1hdr.b_cghost_psize = 0;
+	abd_free(cabd);
+	atomic_add_64(&arc_cghost_size, -(int64_t)psize);
+	arc_space_return(psize, ARC_SPACE_OTHER);
+	ARCSTAT_BUMP(arcstat_cghost_frees);
+}
+
+/*
+ * Called on the way from the MFU state to its ghost list, while the
+ * header's b_pabd is still attached. If the data is stored compressed
+ * it is retained as-is; uncompressed data is recompressed with LZ4 and
+ * only retained if that actually shrank it.
+ */
+static void
+arc_cghost_stash(arc_buf_hdr_t *hdr)
+{
+	uint64_t size = arc_hdr_size(hdr);
+	uint64_t psize;
+	abd_t *cabd;
+
+	ASSERT3P(hdr->b_l1hdr.b_pabd, !=, NULL);
+	ASSERT3P(hdr->b_l1hdr.b_cghost_abd, ==, NULL);
+
+	if (zfs_arc_cghost_max == 0)
+		return;
+
+	if (hdr->b_l1hdr.b_state != arc_mfu || HDR_PROTECTED(hdr) ||
+	    HDR_HAS_RABD(hdr) ||
+	    arc_cghost_size + size > zfs_arc_cghost_max) {
+		ARCSTAT_BUMP(arcstat_cghost_stash_skips);
+		return;
+	}
+
+	if (arc_hdr_get_compress(hdr) != ZIO_COMPRESS_OFF) {
+		cabd = abd_alloc_linear(size, B_FALSE);
+		abd_copy(cabd, hdr->b_l1hdr.b_pabd, size);
+		psize = size;
+	} else {
+		void *tmp = zio_buf_alloc(size);
+
+		psize = zio_compress_data(ZIO_COMPRESS_LZ4,
+		    hdr->b_l1hdr.b_pabd, tmp, size);
+		if (psize == 0 || psize >= size) {
+			zio_buf_free(tmp, size);
+			ARCSTAT_BUMP(arcstat_cghost_stash_skips);
+			return;
+		}
+		cabd = abd_alloc_linear(psize, B_FALSE);
+		abd_copy_from_buf(cabd, tmp, psize);
+		zio_buf_free(tmp, size);
+	}
+
+	hdr->b_l1hdr.b_cghost_abd = cabd;
+	hdr->b_l1hdr.b_cghost_psize = psize;
+	atomic_add_64(&arc_cghost_size, psize);
+	arc_space_consume(psize, ARC_SPACE_OTHER);
+	ARCSTAT_BUMP(arcstat_cghost_stashes);
+}
+
+/*
+ * Rebuild a ghost header's b_pabd from its retained copy so that the
+ * read can be serviced as an ordinary cache hit.
+ */
+static void
+arc_cghost_restore(arc_buf_hdr_t *hdr, kmutex_t *hash_lock)
+{
+	abd_t *cabd = hdr->b_l1hdr.b_cghost_abd;
+	uint64_t psize = hdr->b_l1hdr.b_cghost_psize;
+	uint64_t size = arc_hdr_size(hdr);
+	hrtime_t start = gethrtime();
+
+	ASSERT(MUTEX_HELD(hash_lock));
+	ASSERT(GHOST_STATE(hdr->b_l1hdr.b_state));
+	ASSERT(!HDR_IO_IN_PROGRESS(hdr));
+	ASSERT3P(hdr->b_l1hdr.b_pabd, ==, NULL);
+
+	/*
+	 * Detach the payload first; arc_access() frees anything still
+	 * attached when a header leaves a ghost state.
+	 */
+	hdr->b_l1hdr.b_cghost_abd = NULL;
+	hdr->b_l1hdr.b_cghost_psize = 0;
+
+	/*
+	 * Ghost states may not carry data, so move the header to a
+	 * resident state before reattaching b_pabd. The second
+	 * arc_access() from the cache-hit path is harmless.
+	 */
+	arc_access(hdr, hash_lock);
+	arc_hdr_alloc_pabd(hdr, ARC_HDR_DO_ADAPT);
+
+	if (arc_hdr_get_compress(hdr) != ZIO_COMPRESS_OFF) {
+		ASSERT3U(psize, ==, size);
+		abd_copy(hdr->b_l1hdr.b_pabd, cabd, size);
+	} else {
+		void *tmp = zio_buf_alloc(size);
+
+		VERIFY0(zio_decompress_data(ZIO_COMPRESS_LZ4, cabd, tmp,
+		    psize, size));
+		abd_copy_from_buf(hdr->b_l1hdr.b_pabd, tmp, size);
+		zio_buf_free(tmp, size);
+	}
+
+	abd_free(cabd);
+	atomic_add_64(&arc_cghost_size, -(int64_t)psize);
+	arc_space_return(psize, ARC_SPACE_OTHER);
+
+	ARCSTAT_BUMP(arcstat_cghost_hits);
+	ARCSTAT_INCR(arcstat_cghost_restore_ns, gethrtime() - start);
+}
+
 /*
  * Evict the arc_buf_hdr that is provided as a parameter. The resultant
  * state of the header is dependent on its state prior to entering this
@@ -3833,6 +4003,8 @@ arc_evict_hdr(arc_buf_hdr_t *hdr, kmutex_t *hash_lock)
 
 		DTRACE_PROBE1(arc__delete, arc_buf_hdr_t *, hdr);
 
+		arc_cghost_free(hdr);
+
 		if (HDR_HAS_L2HDR(hdr)) {
 			ASSERT(hdr->b_l1hdr.b_pabd == NULL);
 			ASSERT(!HDR_HAS_RABD(hdr));
@@ -3916,8 +4088,10 @@ arc_evict_hdr(arc_buf_hdr_t *hdr, kmutex_t *hash_lock)
 		 * This ensures that the accounting is updated correctly
 		 * in arc_free_data_impl().
 		 */
-		if (hdr->b_l1hdr.b_pabd != NULL)
+		if (hdr->b_l1hdr.b_pabd != NULL) {
+			arc_cghost_stash(hdr);
 			arc_hdr_free_pabd(hdr, B_FALSE);
+		}
 
 		if (HDR_HAS_RABD(hdr))
 			arc_hdr_free_pabd(hdr, B_TRUE);
@@ -4043,6 +4217,101 @@ arc_evict_state_impl(multilist_t *ml, int idx, arc_buf_hdr_t *marker,
 	return (bytes_evicted);
 }
 
+/*
+ * Argument to arc_evict_state_band(), describing a contiguous band of
+ * multilist sublists to evict from and how much to evict from it.
+ */
+typedef struct arc_evict_band {
+	multilist_t	*eb_ml;
+	arc_buf_hdr_t	**eb_markers;
+	uint64_t	eb_spa;
+	int64_t		eb_bytes;
+	int		eb_first;
+	int		eb_count;
+	uint64_t	eb_evicted;
+} arc_evict_band_t;
+
+/*
+ * Evict from the band of sublists [eb_first, eb_first + eb_count) until
+ * eb_bytes have been evicted or no further progress can be made.  This
+ * is the per-thread half of arc_evict_state(); with NUMA eviction
+ * enabled each lgroup's taskq thread works a disjoint band, so the
+ * sublist locks a thread takes are always the same ones.
+ */
+static void
+arc_evict_state_band(void *arg)
+{
+	arc_evict_band_t *eb = arg;
+	multilist_t *ml = eb->eb_ml;
+	uint64_t total_evicted = 0;
+
+	/*
+	 * While we haven't hit our target number of bytes to evict, or
+	 * we're evicting all available buffers.
+	 */
+	while (total_evicted < eb->eb_bytes || eb->eb_bytes == ARC_EVICT_ALL) {
+		/*
+		 * Start eviction using a randomly selected sublist,
+		 * this is to try and evenly balance eviction across all
+		 * sublists. Always starting at the same sublist
+		 * (e.g. index 0) would cause evictions to favor certain
+		 * sublists over others.
+		 */
+		int sublist_idx = eb->eb_first +
+		    (multilist_get_random_index(ml) % eb->eb_count);
+		uint64_t scan_evicted = 0;
+
+		for (int i = 0; i < eb->eb_count; i++) {
+			uint64_t bytes_remaining;
+			uint64_t bytes_evicted;
+
+			if (eb->eb_bytes == ARC_EVICT_ALL)
+				bytes_remaining = ARC_EVICT_ALL;
+			else if (total_evicted < eb->eb_bytes)
+				bytes_remaining = eb->eb_bytes - total_evicted;
+			else
+				break;
+
+			bytes_evicted = arc_evict_state_impl(ml, sublist_idx,
+			    eb->eb_markers[sublist_idx], eb->eb_spa,
+			    bytes_remaining);
+
+			scan_evicted += bytes_evicted;
+			total_evicted += bytes_evicted;
+
+			/* we've reached the end, wrap to the beginning */
+			if (++sublist_idx >= eb->eb_first + eb->eb_count)
+				sublist_idx = eb->eb_first;
+		}
+
+		/*
+		 * If we didn't evict anything during this scan, we have
+		 * no reason to believe we'll evict more during another
+		 * scan, so break the loop.
+		 */
+		if (scan_evicted == 0) {
+			/* This isn't possible, let's make that obvious */
+			ASSERT3S(eb->eb_bytes, !=, 0);
+
+			/*
+			 * When eb_bytes is ARC_EVICT_ALL, the only way
+			 * to break the loop is when scan_evicted is
+			 * zero. In that case, we actually have evicted
+			 * enough, so we don't want to increment the
+			 * kstat.
+			 */
+			if (eb->eb_bytes != ARC_EVICT_ALL) {
+				ASSERT3S(total_evicted, <, eb->eb_bytes);
+				ARCSTAT_BUMP(arcstat_evict_not_enough);
+			}
+
+			break;
+		}
+	}
+
+	eb->eb_evicted = total_evicted;
+}
+
 /*
  * Evict buffers from the given arc state, until we've removed the
  * specified number of bytes. Move the removed buffers to the
@@ -4093,64 +4362,56 @@ arc_evict_state(arc_state_t *state, uint64_t spa, int64_t bytes,
 	}
 
 	/*
-	 * While we haven't hit our target number of bytes to evict, or
-	 * we're evicting all available buffers.
-	 */
-	while (total_evicted < bytes || bytes == ARC_EVICT_ALL) {
-		/*
-		 * Start eviction using a randomly selected sublist,
-		 * this is to try and evenly balance eviction across all
-		 * sublists. Always starting at the same sublist
-		 * (e.g. index 0) would cause evictions to favor certain
-		 * sublists over others.
-		 */
-		int sublist_idx = multilist_get_random_index(ml);
-		uint64_t scan_evicted = 0;
-
-		for (int i = 0; i < num_sublists; i++) {
-			uint64_t bytes_remaining;
-			uint64_t bytes_evicted;
-
-			if (bytes == ARC_EVICT_ALL)
-				bytes_remaining = ARC_EVICT_ALL;
-			else if (total_evicted < bytes)
-				bytes_remaining = bytes - total_evicted;
-			else
-				break;
-
-			bytes_evicted = arc_evict_state_impl(ml, sublist_idx,
-			    markers[sublist_idx], spa, bytes_remaining);
-
-			scan_evicted += bytes_evicted;
-			total_evicted += bytes_evicted;
-
-			/* we've reached the end, wrap to the beginning */
-			if (++sublist_idx >= num_sublists)
-				sublist_idx = 0;
+	 * When NUMA eviction is enabled, split the sublists into one
+	 * band per lgroup and evict each band from its own taskq
+	 * thread, each responsible for a proportional share of the
+	 * eviction target.  Otherwise (or when the request is too
+	 * small to be worth splitting), scan all sublists from this
+	 * thread, as we historically did.
+	 */
+	int nbands = 1;
+	if (arc_evict_taskq != NULL && num_sublists >= arc_evict_nbands &&
+	    (bytes == ARC_EVICT_ALL || bytes >= arc_evict_nbands))
+		nbands = arc_evict_nbands;
+
+	if (nbands > 1) {
+		arc_evict_band_t *bands = kmem_zalloc(
+		    sizeof (*bands) * nbands, KM_SLEEP);
+		int per_band = num_sublists / nbands;
+
+		for (int b = 0; b < nbands; b++) {
+			bands[b].eb_ml = ml;
+			bands[b].eb_markers = markers;
+			bands[b].eb_spa = spa;
+			bands[b].eb_first = b * per_band;
+			bands[b].eb_count = (b == nbands - 1) ?
+			    num_sublists - b * per_band : per_band;
+			if (bytes == ARC_EVICT_ALL) {
+				bands[b].eb_bytes = ARC_EVICT_ALL;
+			} else {
+				bands[b].eb_bytes = bytes / nbands +
+				    (b == nbands - 1 ? bytes % nbands : 0);
+			}
+			(void) taskq_dispatch(arc_evict_taskq,
+			    arc_evict_state_band, &bands[b], TQ_SLEEP);
 		}
+		taskq_wait(arc_evict_taskq);
 
-		/*
-		 * If we didn't evict anything during this scan, we have
-		 * no reason to believe we'll evict more during another
-		 * scan, so break the loop.
-		 */
-		if (scan_evicted == 0) {
-			/* This isn't possible, let's make that obvious */
-			ASSERT3S(bytes, !=, 0);
+		for (int b = 0; b < nbands; b++)
+			total_evicted += bands[b].eb_evicted;
+		kmem_free(bands, sizeof (*bands) * nbands);
+	} else {
+		arc_evict_band_t band = { 0 };
 
-			/*
-			 * When bytes is ARC_EVICT_ALL, the only way to
-			 * break the loop is when scan_evicted is zero.
-			 * In that case, we actually have evicted enough,
-			 * so we don't want to increment the kstat.
-			 */
-			if (bytes != ARC_EVICT_ALL) {
-				ASSERT3S(total_evicted, <, bytes);
-				ARCSTAT_BUMP(arcstat_evict_not_enough);
-			}
+		band.eb_ml = ml;
+		band.eb_markers = markers;
+		band.eb_spa = spa;
+		band.eb_bytes = bytes;
+		band.eb_first = 0;
+		band.eb_count = num_sublists;
 
-			break;
-		}
+		arc_evict_state_band(&band);
+		total_evicted = band.eb_evicted;
 	}
 
 	for (int i = 0; i < num_sublists; i++) {
@@ -5142,6 +5403,13 @@ arc_access(arc_buf_hdr_t *hdr, kmutex_t *hash_lock)
 	ASSERT(MUTEX_HELD(hash_lock));
 	ASSERT(HDR_HAS_L1HDR(hdr));
 
+	/*
+	 * Any access moves this header off a ghost list, at which point
+	 * a retained compressed-ghost copy that wasn't used to service
+	 * the access (see arc_cghost_restore()) is of no further use.
+	 */
+	arc_cghost_free(hdr);
+
 	if (hdr->b_l1hdr.b_state == arc_anon) {
 		/*
 		 * This buffer is not in the cache, and does not
@@ -5678,6 +5946,16 @@ top:
 		hdr = buf_hash_find(guid, bp, &hash_lock);
 	}
 
+	/*
+	 * If this block was evicted through the compressed ghost tier,
+	 * rebuild its data from the retained copy now and service the
+	 * read as an ordinary cache hit below.
+	 */
+	if (hdr != NULL && HDR_HAS_L1HDR(hdr) &&
+	    GHOST_STATE(hdr->b_l1hdr.b_state) &&
+	    hdr->b_l1hdr.b_cghost_abd != NULL && !encrypted_read)
+		arc_cghost_restore(hdr, hash_lock);
+
 	/*
 	 * Determine if we have an L1 cache hit or a cache miss. For simplicity
 	 * we maintain encrypted data seperately from compressed / uncompressed
@@ -6925,6 +7203,7 @@ arc_kstat_update(kstat_t *ksp, int rw)
 		ARCSTAT(arcstat_hdr_size) = aggsum_value(&astat_hdr_size);
 		ARCSTAT(arcstat_other_size) = aggsum_value(&astat_other_size);
 		ARCSTAT(arcstat_l2_hdr_size) = aggsum_value(&astat_l2_hdr_size);
+		ARCSTAT(arcstat_cghost_size) = arc_cghost_size;
 	}
 
 	return (0);
@@ -7219,6 +7498,19 @@ arc_init(void)
 	arc_reap_zthr = zthr_create_timer(arc_reap_cb_check,
 	    arc_reap_cb, NULL, SEC2NSEC(1));
 
+#ifdef _KERNEL
+	/*
+	 * With more than one lgroup, evict each lgroup's band of
+	 * sublists from its own thread; see arc_evict_state().
+	 */
+	if (zfs_arc_numa_evict && nlgrpsmax > 1) {
+		arc_evict_nbands = nlgrpsmax;
+		arc_evict_taskq = taskq_create("arc_evict",
+		    arc_evict_nbands, minclsyspri, arc_evict_nbands,
+		    arc_evict_nbands, TASKQ_PREPOPULATE);
+	}
+#endif
+
 	arc_initialized = B_TRUE;
 	arc_warm = B_FALSE;
 
@@ -7257,6 +7549,11 @@ arc_fini(void)
 	(void) zthr_cancel(arc_reap_zthr);
 	zthr_destroy(arc_reap_zthr);
 
+	if (arc_evict_taskq != NULL) {
+		taskq_destroy(arc_evict_taskq);
+		arc_evict_taskq = NULL;
+	}
+
 	mutex_destroy(&arc_adjust_lock);
 	cv_destroy(&arc_adjust_waiters_cv);
 
@@ -9174,7 +9471,9 @@ l2arc_dev_rebuild_start(l2arc_dev_t *dev)
 {
 	VERIFY(!dev->l2ad_rebuild_cancel);
 	VERIFY(dev->l2ad_rebuild);
+	ARCSTAT_BUMP(arcstat_l2_rebuild_inprogress);
 	(void) l2arc_rebuild(dev);
+	ARCSTAT_INCR(arcstat_l2_rebuild_inprogress, -1);
 	mutex_enter(&l2arc_rebuild_thr_lock);
 	dev->l2ad_rebuild_began = B_FALSE;
 	dev->l2ad_rebuild = B_FALSE;
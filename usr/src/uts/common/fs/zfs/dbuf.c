@@ -203,6 +203,69 @@ static dbuf_hash_table_t dbuf_hash_table;
 
 static uint64_t dbuf_hash_count;
 
+/*
+ * Statistics for the dbuf hash table, exported as the "dbufstats"
+ * kstat.  The chain length histogram is maintained at insert time and
+ * counts how many entries were already chained in the destination
+ * bucket, bucketed by powers of two.
+ */
+#define	DBUF_HASH_CHAIN_HIST	8
+
+typedef struct dbuf_hash_stats {
+	kstat_named_t hash_elements;
+	kstat_named_t hash_elements_max;
+	kstat_named_t hash_table_size;
+	kstat_named_t hash_hits;
+	kstat_named_t hash_misses;
+	kstat_named_t hash_collisions;
+	kstat_named_t hash_chain_max;
+	kstat_named_t hash_grows;
+	kstat_named_t hash_chain_hist[DBUF_HASH_CHAIN_HIST];
+} dbuf_hash_stats_t;
+
+static dbuf_hash_stats_t dbuf_hash_stats = {
+	{ "hash_elements",		KSTAT_DATA_UINT64 },
+	{ "hash_elements_max",		KSTAT_DATA_UINT64 },
+	{ "hash_table_size",		KSTAT_DATA_UINT64 },
+	{ "hash_hits",			KSTAT_DATA_UINT64 },
+	{ "hash_misses",		KSTAT_DATA_UINT64 },
+	{ "hash_collisions",		KSTAT_DATA_UINT64 },
+	{ "hash_chain_max",		KSTAT_DATA_UINT64 },
+	{ "hash_grows",			KSTAT_DATA_UINT64 },
+	{
+		{ "hash_chain_len_0",		KSTAT_DATA_UINT64 },
+		{ "hash_chain_len_1",		KSTAT_DATA_UINT64 },
+		{ "hash_chain_len_2_3",		KSTAT_DATA_UINT64 },
+		{ "hash_chain_len_4_7",		KSTAT_DATA_UINT64 },
+		{ "hash_chain_len_8_15",	KSTAT_DATA_UINT64 },
+		{ "hash_chain_len_16_31",	KSTAT_DATA_UINT64 },
+		{ "hash_chain_len_32_63",	KSTAT_DATA_UINT64 },
+		{ "hash_chain_len_64_plus",	KSTAT_DATA_UINT64 },
+	}
+};
+
+#define	DBUF_STAT_BUMP(stat) \
+	atomic_inc_64(&dbuf_hash_stats.stat.value.ui64)
+#define	DBUF_STAT_MAX(stat, val) {				\
+	if ((val) > dbuf_hash_stats.stat.value.ui64)		\
+		dbuf_hash_stats.stat.value.ui64 = (val);	\
+}
+
+static kstat_t *dbuf_hash_ksp;
+
+/*
+ * Grow the hash table (by doubling) once the average chain length
+ * exceeds this many entries.  Set to 0 to disable online growing.
+ * The table is sized at dbuf_init() for one entry per 4K of physical
+ * memory, so growth only kicks in when dbufs substantially outnumber
+ * that estimate (e.g. metadata-heavy pools caching small blocks).
+ */
+int dbuf_hash_grow_factor = 4;
+
+static volatile uint32_t dbuf_hash_growing;
+
+static void dbuf_hash_table_grow(void *arg);
+
 /*
  * We use Cityhash for this. It's fast, and has good hash properties without
  * requiring any large static buffers.
@@ -219,26 +282,45 @@ dbuf_hash(void *os, uint64_t obj, uint8_t lvl, uint64_t blkid)
 	(dbuf)->db_level == (level) &&			\
 	(dbuf)->db_blkid == (blkid))
 
+/*
+ * While an online grow is migrating buckets (see dbuf_hash_table_grow()),
+ * an entry lives in exactly one of the two tables, so lookups probe the
+ * old bucket and then the new one.  Both buckets for a given hash, and
+ * the bucket the migrator is emptying, are covered by the same mutex:
+ * the stripe index depends only on the low log2(DBUF_MUTEXES) bits of
+ * the hash, which both masks preserve.  The stripe mutex is therefore
+ * taken on the hash itself, and the bucket index is computed only once
+ * the mutex is held: the migrator swaps the table and mask under all of
+ * the stripe mutexes, so a mask read before the stripe lock was
+ * acquired may be stale by the time it is.
+ */
 dmu_buf_impl_t *
 dbuf_find(objset_t *os, uint64_t obj, uint8_t level, uint64_t blkid)
 {
 	dbuf_hash_table_t *h = &dbuf_hash_table;
 	uint64_t hv = dbuf_hash(os, obj, level, blkid);
-	uint64_t idx = hv & h->hash_table_mask;
 	dmu_buf_impl_t *db;
 
-	mutex_enter(DBUF_HASH_MUTEX(h, idx));
-	for (db = h->hash_table[idx]; db != NULL; db = db->db_hash_next) {
-		if (DBUF_EQUAL(db, os, obj, level, blkid)) {
-			mutex_enter(&db->db_mtx);
-			if (db->db_state != DB_EVICTING) {
-				mutex_exit(DBUF_HASH_MUTEX(h, idx));
-				return (db);
+	mutex_enter(DBUF_HASH_MUTEX(h, hv));
+	db = h->hash_table[hv & h->hash_table_mask];
+	for (int pass = 0; pass < 2; pass++) {
+		for (; db != NULL; db = db->db_hash_next) {
+			if (DBUF_EQUAL(db, os, obj, level, blkid)) {
+				mutex_enter(&db->db_mtx);
+				if (db->db_state != DB_EVICTING) {
+					mutex_exit(DBUF_HASH_MUTEX(h, hv));
+					DBUF_STAT_BUMP(hash_hits);
+					return (db);
+				}
+				mutex_exit(&db->db_mtx);
 			}
-			mutex_exit(&db->db_mtx);
 		}
+		if (h->hash_table2 == NULL)
+			break;
+		db = h->hash_table2[hv & h->hash_table_mask2];
 	}
-	mutex_exit(DBUF_HASH_MUTEX(h, idx));
+	mutex_exit(DBUF_HASH_MUTEX(h, hv));
+	DBUF_STAT_BUMP(hash_misses);
 	return (NULL);
 }
 
@@ -275,27 +357,55 @@ dbuf_hash_insert(dmu_buf_impl_t *db)
 	int level = db->db_level;
 	uint64_t blkid = db->db_blkid;
 	uint64_t hv = dbuf_hash(os, obj, level, blkid);
-	uint64_t idx = hv & h->hash_table_mask;
-	dmu_buf_impl_t *dbf;
-
-	mutex_enter(DBUF_HASH_MUTEX(h, idx));
-	for (dbf = h->hash_table[idx]; dbf != NULL; dbf = dbf->db_hash_next) {
-		if (DBUF_EQUAL(dbf, os, obj, level, blkid)) {
-			mutex_enter(&dbf->db_mtx);
-			if (dbf->db_state != DB_EVICTING) {
-				mutex_exit(DBUF_HASH_MUTEX(h, idx));
-				return (dbf);
+	dmu_buf_impl_t **bucket, *dbf;
+	uint64_t chain_len = 0;
+
+	mutex_enter(DBUF_HASH_MUTEX(h, hv));
+	bucket = &h->hash_table[hv & h->hash_table_mask];
+	for (int pass = 0; pass < 2; pass++) {
+		for (dbf = *bucket; dbf != NULL; dbf = dbf->db_hash_next) {
+			if (DBUF_EQUAL(dbf, os, obj, level, blkid)) {
+				mutex_enter(&dbf->db_mtx);
+				if (dbf->db_state != DB_EVICTING) {
+					mutex_exit(DBUF_HASH_MUTEX(h, hv));
+					return (dbf);
+				}
+				mutex_exit(&dbf->db_mtx);
 			}
-			mutex_exit(&dbf->db_mtx);
+			chain_len++;
 		}
+		if (pass == 1 || h->hash_table2 == NULL)
+			break;
+		/* new entries go into the new table during a grow */
+		bucket = &h->hash_table2[hv & h->hash_table_mask2];
+		chain_len = 0;
 	}
 
 	mutex_enter(&db->db_mtx);
-	db->db_hash_next = h->hash_table[idx];
-	h->hash_table[idx] = db;
-	mutex_exit(DBUF_HASH_MUTEX(h, idx));
+	db->db_hash_next = *bucket;
+	*bucket = db;
+	mutex_exit(DBUF_HASH_MUTEX(h, hv));
 	atomic_inc_64(&dbuf_hash_count);
 
+	if (chain_len > 0)
+		DBUF_STAT_BUMP(hash_collisions);
+	DBUF_STAT_MAX(hash_chain_max, chain_len);
+	DBUF_STAT_MAX(hash_elements_max, dbuf_hash_count);
+	DBUF_STAT_BUMP(hash_chain_hist[chain_len == 0 ? 0 :
+	    MIN(highbit64(chain_len), DBUF_HASH_CHAIN_HIST - 1)]);
+
+	/*
+	 * Kick off an online grow from the system taskq once the
+	 * average chain length exceeds dbuf_hash_grow_factor.
+	 */
+	if (dbuf_hash_grow_factor != 0 && dbuf_hash_count >
+	    (h->hash_table_mask + 1) * dbuf_hash_grow_factor &&
+	    atomic_cas_32(&dbuf_hash_growing, 0, 1) == 0) {
+		if (taskq_dispatch(system_taskq, dbuf_hash_table_grow,
+		    h, TQ_NOSLEEP) == TASKQID_INVALID)
+			dbuf_hash_growing = 0;
+	}
+
 	return (NULL);
 }
 
@@ -308,7 +418,6 @@ dbuf_hash_remove(dmu_buf_impl_t *db)
 	dbuf_hash_table_t *h = &dbuf_hash_table;
 	uint64_t hv = dbuf_hash(db->db_objset, db->db.db_object,
 	    db->db_level, db->db_blkid);
-	uint64_t idx = hv & h->hash_table_mask;
 	dmu_buf_impl_t *dbf, **dbp;
 
 	/*
@@ -319,18 +428,108 @@ dbuf_hash_remove(dmu_buf_impl_t *db)
 	ASSERT(db->db_state == DB_EVICTING);
 	ASSERT(!MUTEX_HELD(&db->db_mtx));
 
-	mutex_enter(DBUF_HASH_MUTEX(h, idx));
-	dbp = &h->hash_table[idx];
-	while ((dbf = *dbp) != db) {
+	mutex_enter(DBUF_HASH_MUTEX(h, hv));
+	dbp = &h->hash_table[hv & h->hash_table_mask];
+	while ((dbf = *dbp) != db && dbf != NULL)
 		dbp = &dbf->db_hash_next;
-		ASSERT(dbf != NULL);
+	if (dbf == NULL) {
+		/* must have been migrated (or inserted) during a grow */
+		ASSERT3P(h->hash_table2, !=, NULL);
+		dbp = &h->hash_table2[hv & h->hash_table_mask2];
+		while ((dbf = *dbp) != db) {
+			ASSERT(dbf != NULL);
+			dbp = &dbf->db_hash_next;
+		}
 	}
 	*dbp = db->db_hash_next;
 	db->db_hash_next = NULL;
-	mutex_exit(DBUF_HASH_MUTEX(h, idx));
+	mutex_exit(DBUF_HASH_MUTEX(h, hv));
 	atomic_dec_64(&dbuf_hash_count);
 }
 
+/*
+ * Grow the hash table to twice its current size, migrating the buckets
+ * while lookups continue.  The new table is published first; from then
+ * on new dbufs are inserted into it and lookups probe both tables.
+ * Each old bucket is then rehashed under its stripe mutex: with a
+ * power-of-two size, the entries of old bucket i are split between new
+ * buckets i and i + oldsize, and since the stripe index depends only on
+ * the low bits of the hash all three buckets share one mutex.  Once
+ * every bucket has been migrated the new table is swapped into place
+ * (under all of the stripe mutexes, so that the mask and table pointer
+ * change atomically with respect to lookups) and the old one is freed.
+ */
+static void
+dbuf_hash_table_grow(void *arg)
+{
+	dbuf_hash_table_t *h = arg;
+	uint64_t osize = h->hash_table_mask + 1;
+	uint64_t nsize = osize << 1;
+	dmu_buf_impl_t **ntable, **otable;
+	int i;
+
+	ASSERT3P(h->hash_table2, ==, NULL);
+
+	ntable = kmem_zalloc(nsize * sizeof (void *), KM_NOSLEEP);
+	if (ntable == NULL) {
+		/* leave the table alone and try again at the next trigger */
+		dbuf_hash_growing = 0;
+		return;
+	}
+
+	for (i = 0; i < DBUF_MUTEXES; i++)
+		mutex_enter(&h->hash_mutexes[i]);
+	h->hash_table_mask2 = nsize - 1;
+	h->hash_table2 = ntable;
+	for (i = 0; i < DBUF_MUTEXES; i++)
+		mutex_exit(&h->hash_mutexes[i]);
+
+	for (uint64_t b = 0; b < osize; b++) {
+		kmutex_t *mtx = DBUF_HASH_MUTEX(h, b);
+		dmu_buf_impl_t *db;
+
+		mutex_enter(mtx);
+		while ((db = h->hash_table[b]) != NULL) {
+			uint64_t hv = dbuf_hash(db->db_objset,
+			    db->db.db_object, db->db_level, db->db_blkid);
+			uint64_t idx = hv & h->hash_table_mask2;
+
+			h->hash_table[b] = db->db_hash_next;
+			db->db_hash_next = ntable[idx];
+			ntable[idx] = db;
+		}
+		mutex_exit(mtx);
+	}
+
+	for (i = 0; i < DBUF_MUTEXES; i++)
+		mutex_enter(&h->hash_mutexes[i]);
+	otable = h->hash_table;
+	h->hash_table = ntable;
+	h->hash_table_mask = nsize - 1;
+	h->hash_table2 = NULL;
+	h->hash_table_mask2 = 0;
+	for (i = 0; i < DBUF_MUTEXES; i++)
+		mutex_exit(&h->hash_mutexes[i]);
+
+	kmem_free(otable, osize * sizeof (void *));
+	DBUF_STAT_BUMP(hash_grows);
+	dbuf_hash_growing = 0;
+}
+
+/* ARGSUSED */
+static int
+dbuf_hash_kstat_update(kstat_t *ksp, int rw)
+{
+	if (rw == KSTAT_WRITE)
+		return (SET_ERROR(EACCES));
+
+	dbuf_hash_stats.hash_elements.value.ui64 = dbuf_hash_count;
+	dbuf_hash_stats.hash_table_size.value.ui64 =
+	    dbuf_hash_table.hash_table_mask + 1;
+
+	return (0);
+}
+
 typedef enum {
 	DBVU_EVICTING,
 	DBVU_NOT_EVICTING
@@ -679,6 +878,16 @@ retry:
 	cv_init(&dbuf_evict_cv, NULL, CV_DEFAULT, NULL);
 	dbuf_cache_evict_thread = thread_create(NULL, 0, dbuf_evict_thread,
 	    NULL, 0, &p0, TS_RUN, minclsyspri);
+
+	dbuf_hash_ksp = kstat_create("zfs", 0, "dbufstats", "misc",
+	    KSTAT_TYPE_NAMED,
+	    sizeof (dbuf_hash_stats) / sizeof (kstat_named_t),
+	    KSTAT_FLAG_VIRTUAL);
+	if (dbuf_hash_ksp != NULL) {
+		dbuf_hash_ksp->ks_data = &dbuf_hash_stats;
+		dbuf_hash_ksp->ks_update = dbuf_hash_kstat_update;
+		kstat_install(dbuf_hash_ksp);
+	}
 }
 
 void
@@ -687,8 +896,14 @@ dbuf_fini(void)
 	dbuf_hash_table_t *h = &dbuf_hash_table;
 	int i;
 
+	if (dbuf_hash_ksp != NULL) {
+		kstat_delete(dbuf_hash_ksp);
+		dbuf_hash_ksp = NULL;
+	}
+
 	for (i = 0; i < DBUF_MUTEXES; i++)
 		mutex_destroy(&h->hash_mutexes[i]);
+	ASSERT3P(h->hash_table2, ==, NULL);
 	kmem_free(h->hash_table, (h->hash_table_mask + 1) * sizeof (void *));
 	kmem_cache_destroy(dbuf_kmem_cache);
 	taskq_destroy(dbu_evict_taskq);
@@ -2018,7 +2233,7 @@ dbuf_undirty(dmu_buf_impl_t *db, dmu_tx_t *tx)
 
 	ASSERT(db->db.db_size != 0);
 
-	dsl_pool_undirty_space(dmu_objset_pool(dn->dn_objset),
+	dsl_pool_undirty_space(dmu_objset_pool(dn->dn_objset), dn->dn_objset,
 	    dr->dr_accounted, txg);
 
 	*drp = dr->dr_next;
@@ -3852,7 +4067,7 @@ dbuf_write_physdone(zio_t *zio, arc_buf_t *buf, void *arg)
 	 * dsl_pool_undirty_space().
 	 */
 	delta = dr->dr_accounted / zio->io_phys_children;
-	dsl_pool_undirty_space(dp, delta, zio->io_txg);
+	dsl_pool_undirty_space(dp, os, delta, zio->io_txg);
 }
 
 /* ARGSUSED */
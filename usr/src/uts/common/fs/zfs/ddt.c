@@ -43,6 +43,34 @@
  */
 int zfs_dedup_prefetch = 1;
 
+/*
+ * If nonzero, build an in-memory presence (bloom) filter over the
+ * on-disk DDT of each checksum function at pool load, of at most this
+ * many bytes per table, and consult it in ddt_lookup() so that writes
+ * of blocks that have never been seen before skip the on-disk ZAP
+ * lookups entirely.  The filter can only yield false positives (a
+ * "maybe present" answer falls through to the normal ZAP lookup), so
+ * it is always safe; entries removed from the DDT merely leave stale
+ * bits behind until the next load.  Building the filter requires one
+ * walk of the DDT at load time, which is why this is off by default.
+ */
+uint64_t zfs_dedup_bloom_max_size = 0;
+
+typedef struct ddt_kstats {
+	kstat_named_t dds_bloom_skips;
+	kstat_named_t dds_bloom_hits;
+} ddt_kstats_t;
+
+static ddt_kstats_t ddt_kstats = {
+	{ "bloom_skips",	KSTAT_DATA_UINT64 },
+	{ "bloom_hits",		KSTAT_DATA_UINT64 },
+};
+
+#define	DDT_KSTAT_BUMP(stat) \
+	atomic_inc_64(&ddt_kstats.stat.value.ui64)
+
+static kstat_t *ddt_ksp;
+
 static const ddt_ops_t *ddt_ops[DDT_TYPES] = {
 	&ddt_zap_ops,
 };
@@ -716,16 +744,32 @@ ddt_lookup(ddt_t *ddt, const blkptr_t *bp, boolean_t add)
 
 	error = ENOENT;
 
-	for (type = 0; type < DDT_TYPES; type++) {
-		for (class = 0; class < DDT_CLASSES; class++) {
-			error = ddt_object_lookup(ddt, type, class, dde);
-			if (error != ENOENT) {
-				ASSERT0(error);
-				break;
+	/*
+	 * If the presence filter says this key has never been written
+	 * to the on-disk DDT, skip the ZAP lookups entirely; this is
+	 * the common case for unique blocks.  The filter bits are only
+	 * ever set, so a racing reader can at worst take the slow path.
+	 */
+	if (ddt->ddt_bloom != NULL &&
+	    !ddt_bloom_contains(ddt, &dde->dde_key)) {
+		DDT_KSTAT_BUMP(dds_bloom_skips);
+		type = DDT_TYPES;
+		class = DDT_CLASSES;
+	} else {
+		if (ddt->ddt_bloom != NULL)
+			DDT_KSTAT_BUMP(dds_bloom_hits);
+		for (type = 0; type < DDT_TYPES; type++) {
+			for (class = 0; class < DDT_CLASSES; class++) {
+				error = ddt_object_lookup(ddt, type, class,
+				    dde);
+				if (error != ENOENT) {
+					ASSERT0(error);
+					break;
+				}
 			}
+			if (error != ENOENT)
+				break;
 		}
-		if (error != ENOENT)
-			break;
 	}
 
 	ddt_enter(ddt);
@@ -797,6 +841,107 @@ ddt_entry_compare(const void *x1, const void *x2)
 	return (TREE_ISIGN(cmp));
 }
 
+void
+ddt_init(void)
+{
+	ddt_ksp = kstat_create("zfs", 0, "ddtstats", "misc",
+	    KSTAT_TYPE_NAMED, sizeof (ddt_kstats) / sizeof (kstat_named_t),
+	    KSTAT_FLAG_VIRTUAL);
+	if (ddt_ksp != NULL) {
+		ddt_ksp->ks_data = &ddt_kstats;
+		kstat_install(ddt_ksp);
+	}
+}
+
+void
+ddt_fini(void)
+{
+	if (ddt_ksp != NULL) {
+		kstat_delete(ddt_ksp);
+		ddt_ksp = NULL;
+	}
+}
+
+/*
+ * The bloom filter is probed with four independent bit positions taken
+ * directly from the words of the (already strong) dedup checksum, with
+ * the block properties folded into the first, so no additional hashing
+ * is required.
+ */
+static void
+ddt_bloom_add(ddt_t *ddt, const ddt_key_t *ddk)
+{
+	if (ddt->ddt_bloom == NULL)
+		return;
+
+	for (int i = 0; i < 4; i++) {
+		uint64_t bit = (ddk->ddk_cksum.zc_word[i] ^
+		    (i == 0 ? ddk->ddk_prop : 0)) & ddt->ddt_bloom_mask;
+
+		atomic_or_8(&ddt->ddt_bloom[bit >> 3], 1 << (bit & 7));
+	}
+}
+
+static boolean_t
+ddt_bloom_contains(ddt_t *ddt, const ddt_key_t *ddk)
+{
+	for (int i = 0; i < 4; i++) {
+		uint64_t bit = (ddk->ddk_cksum.zc_word[i] ^
+		    (i == 0 ? ddk->ddk_prop : 0)) & ddt->ddt_bloom_mask;
+
+		if (!(ddt->ddt_bloom[bit >> 3] & (1 << (bit & 7))))
+			return (B_FALSE);
+	}
+	return (B_TRUE);
+}
+
+/*
+ * Size the filter for the current on-disk entry count (about ten bits
+ * per entry, so that false positive rates stay in the low percent
+ * range) and seed it with one walk of every table.
+ */
+static int
+ddt_bloom_load(ddt_t *ddt)
+{
+	uint64_t count = 0;
+	uint64_t bits, bytes;
+
+	ASSERT(ddt->ddt_bloom == NULL);
+
+	for (enum ddt_type type = 0; type < DDT_TYPES; type++) {
+		for (enum ddt_class class = 0; class < DDT_CLASSES; class++) {
+			if (ddt_object_exists(ddt, type, class))
+				count += ddt_object_count(ddt, type, class);
+		}
+	}
+
+	bits = MAX(1ULL << 15, 1ULL << (highbit64(count * 10) + 1));
+	bits = MIN(bits, zfs_dedup_bloom_max_size * 8);
+	if (!ISP2(bits))
+		bits = 1ULL << (highbit64(bits) - 1);
+	bytes = bits >> 3;
+	if (bytes == 0)
+		return (0);
+
+	ddt->ddt_bloom = kmem_zalloc(bytes, KM_SLEEP);
+	ddt->ddt_bloom_mask = bits - 1;
+
+	for (enum ddt_type type = 0; type < DDT_TYPES; type++) {
+		for (enum ddt_class class = 0; class < DDT_CLASSES; class++) {
+			uint64_t walk = 0;
+			ddt_entry_t dde;
+
+			if (!ddt_object_exists(ddt, type, class))
+				continue;
+			while (ddt_object_walk(ddt, type, class,
+			    &walk, &dde) == 0)
+				ddt_bloom_add(ddt, &dde.dde_key);
+		}
+	}
+
+	return (0);
+}
+
 static ddt_t *
 ddt_table_alloc(spa_t *spa, enum zio_checksum c)
 {
@@ -824,6 +969,10 @@ ddt_table_free(ddt_t *ddt)
 	avl_destroy(&ddt->ddt_tree);
 	avl_destroy(&ddt->ddt_repair_tree);
 	mutex_destroy(&ddt->ddt_lock);
+	if (ddt->ddt_bloom != NULL) {
+		kmem_free(ddt->ddt_bloom, (ddt->ddt_bloom_mask + 1) >> 3);
+		ddt->ddt_bloom = NULL;
+	}
 	kmem_free(ddt, sizeof (*ddt));
 }
 
@@ -866,6 +1015,12 @@ ddt_load(spa_t *spa)
 		 */
 		bcopy(ddt->ddt_histogram, &ddt->ddt_histogram_cache,
 		    sizeof (ddt->ddt_histogram));
+
+		if (zfs_dedup_bloom_max_size != 0) {
+			error = ddt_bloom_load(ddt);
+			if (error != 0)
+				return (error);
+		}
 	}
 
 	return (0);
@@ -1062,6 +1217,7 @@ ddt_sync_entry(ddt_t *ddt, ddt_entry_t *dde, dmu_tx_t *tx, uint64_t txg)
 		if (!ddt_object_exists(ddt, ntype, nclass))
 			ddt_object_create(ddt, ntype, nclass, tx);
 		VERIFY(ddt_object_update(ddt, ntype, nclass, dde, tx) == 0);
+		ddt_bloom_add(ddt, ddk);
 
 		/*
 		 * If the class changes, the order that we scan this bp
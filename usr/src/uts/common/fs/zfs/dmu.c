@@ -106,7 +106,7 @@ const dmu_object_type_info_t dmu_ot[DMU_OT_NUMTYPES] = {
 	{ DMU_BSWAP_UINT64, TRUE,  FALSE, FALSE, "SPA space map header"	},
 	{ DMU_BSWAP_UINT64, TRUE,  FALSE, FALSE, "SPA space map"	},
 	{ DMU_BSWAP_UINT64, TRUE,  FALSE, TRUE,  "ZIL intent log"	},
-	{ DMU_BSWAP_DNODE,  TRUE,  FALSE, TRUE,  "DMU dnode"	},
+	{ DMU_BSWAP_DNODE,  TRUE,  TRUE,  TRUE,  "DMU dnode"	},
 	{ DMU_BSWAP_OBJSET, TRUE,  TRUE,  FALSE, "DMU objset"	},
 	{ DMU_BSWAP_UINT64, TRUE,  TRUE,  FALSE, "DSL directory"	},
 	{ DMU_BSWAP_ZAP,    TRUE,  TRUE,  FALSE, "DSL directory child map" },
@@ -2602,6 +2602,7 @@ dmu_init(void)
 	sa_cache_init();
 	xuio_stat_init();
 	dmu_objset_init();
+	dmu_tx_stat_init();
 	dnode_init();
 	zfetch_init();
 	l2arc_init();
@@ -2617,6 +2618,7 @@ dmu_fini(void)
 	zfetch_fini();
 	dbuf_fini();
 	dnode_fini();
+	dmu_tx_stat_fini();
 	dmu_objset_fini();
 	xuio_stat_fini();
 	sa_cache_fini();
@@ -57,6 +57,16 @@
 #include <sys/bqueue.h>
 
 int zfs_recv_queue_length = SPA_MAXBLOCKSIZE;
+/*
+ * Number of worker threads used to apply DRR_WRITE records, so that
+ * checksumming and tx assignment for independent writes overlap.  Writes
+ * are hashed by object number, which keeps writes to the same object in
+ * stream order; any other record type acts as a barrier.  Resumable
+ * receives always use a single writer, since the resume protocol
+ * requires records to be applied strictly in stream order.  Set to 1 to
+ * disable the fan-out entirely.
+ */
+int zfs_recv_write_workers = 4;
 
 static char *dmu_recv_tag = "dmu_recv_tag";
 const char *recv_clone_name = "%recv";
@@ -835,6 +845,21 @@ struct receive_writer_arg {
 	uint8_t or_iv[ZIO_DATA_IV_LEN];
 	uint8_t or_mac[ZIO_DATA_MAC_LEN];
 	boolean_t or_byteorder;
+
+	/*
+	 * Single-threaded worker taskqs used to apply DRR_WRITE records,
+	 * selected by object number; NULL when write fan-out is disabled.
+	 */
+	taskq_t **write_taskqs;
+	int write_ntaskqs;
+};
+
+/*
+ * A DRR_WRITE record handed off to a worker taskq by the writer thread.
+ */
+struct receive_write_task {
+	struct receive_writer_arg *rwt_rwa;
+	struct receive_record_arg *rwt_rrd;
 };
 
 struct objlist {
@@ -1475,13 +1500,8 @@ receive_freeobjects(struct receive_writer_arg *rwa,
 }
 
 static int
-receive_write(struct receive_writer_arg *rwa, struct drr_write *drrw,
-    arc_buf_t *abuf)
+receive_write_prologue(struct receive_writer_arg *rwa, struct drr_write *drrw)
 {
-	int err;
-	dmu_tx_t *tx;
-	dnode_t *dn;
-
 	if (drrw->drr_offset + drrw->drr_logical_size < drrw->drr_offset ||
 	    !DMU_OT_IS_VALID(drrw->drr_type))
 		return (SET_ERROR(EINVAL));
@@ -1501,6 +1521,22 @@ receive_write(struct receive_writer_arg *rwa, struct drr_write *drrw,
 	if (rwa->last_object > rwa->max_object)
 		rwa->max_object = rwa->last_object;
 
+	return (0);
+}
+
+/*
+ * Apply a DRR_WRITE record whose prologue checks have already been done.
+ * When write fan-out is enabled this runs on a worker taskq, so it must
+ * not touch the bookkeeping fields updated by receive_write_prologue().
+ */
+static int
+receive_write_impl(struct receive_writer_arg *rwa, struct drr_write *drrw,
+    arc_buf_t *abuf)
+{
+	int err;
+	dmu_tx_t *tx;
+	dnode_t *dn;
+
 	if (dmu_object_info(rwa->os, drrw->drr_object, NULL) != 0)
 		return (SET_ERROR(EINVAL));
 
@@ -1542,6 +1578,17 @@ receive_write(struct receive_writer_arg *rwa, struct drr_write *drrw,
 	return (0);
 }
 
+static int
+receive_write(struct receive_writer_arg *rwa, struct drr_write *drrw,
+    arc_buf_t *abuf)
+{
+	int err = receive_write_prologue(rwa, drrw);
+
+	if (err != 0)
+		return (err);
+	return (receive_write_impl(rwa, drrw, abuf));
+}
+
 /*
  * Handle a DRR_WRITE_BYREF record.  This record is used in dedup'ed
  * streams to refer to a copy of the data that is already on the
@@ -2270,6 +2317,91 @@ receive_process_record(struct receive_writer_arg *rwa,
 	}
 }
 
+/*
+ * Record the first error encountered by a write worker.  Workers run
+ * concurrently with each other and with the writer thread, so unlike the
+ * serial path this must be serialized by the rwa mutex.
+ */
+static void
+receive_writer_seterr(struct receive_writer_arg *rwa, int err)
+{
+	mutex_enter(&rwa->mutex);
+	if (rwa->err == 0)
+		rwa->err = err;
+	mutex_exit(&rwa->mutex);
+}
+
+/*
+ * Apply one dispatched DRR_WRITE record on a worker taskq.
+ */
+static void
+receive_write_task(void *arg)
+{
+	struct receive_write_task *rwt = arg;
+	struct receive_writer_arg *rwa = rwt->rwt_rwa;
+	struct receive_record_arg *rrd = rwt->rwt_rrd;
+	struct drr_write *drrw = &rrd->header.drr_u.drr_write;
+	int err;
+
+	err = receive_write_impl(rwa, drrw, rrd->arc_buf);
+	/* if receive_write_impl() is successful, it consumes the arc_buf */
+	if (err != 0) {
+		dmu_return_arcbuf(rrd->arc_buf);
+		receive_writer_seterr(rwa, err);
+	}
+	kmem_free(rrd, sizeof (*rrd));
+	kmem_free(rwt, sizeof (*rwt));
+}
+
+/*
+ * Hand a DRR_WRITE record off to a worker taskq.  The prologue checks
+ * and bookkeeping still happen here, on the writer thread, so records
+ * are validated in stream order; only the tx assignment and the write
+ * itself run concurrently.  Writes are hashed by object number onto
+ * single-threaded taskqs, which keeps writes to the same object in
+ * stream order.
+ */
+static void
+receive_write_dispatch(struct receive_writer_arg *rwa,
+    struct receive_record_arg *rrd)
+{
+	struct drr_write *drrw = &rrd->header.drr_u.drr_write;
+	struct receive_write_task *rwt;
+	taskq_t *tq;
+	int err;
+
+	/* Processing in order, therefore bytes_read should be increasing. */
+	ASSERT3U(rrd->bytes_read, >=, rwa->bytes_read);
+	rwa->bytes_read = rrd->bytes_read;
+
+	err = receive_write_prologue(rwa, drrw);
+	if (err != 0) {
+		dmu_return_arcbuf(rrd->arc_buf);
+		rrd->arc_buf = NULL;
+		receive_writer_seterr(rwa, err);
+		kmem_free(rrd, sizeof (*rrd));
+		return;
+	}
+
+	rwt = kmem_alloc(sizeof (*rwt), KM_SLEEP);
+	rwt->rwt_rwa = rwa;
+	rwt->rwt_rrd = rrd;
+	tq = rwa->write_taskqs[drrw->drr_object % rwa->write_ntaskqs];
+	VERIFY(taskq_dispatch(tq, receive_write_task, rwt, TQ_SLEEP) !=
+	    TASKQID_INVALID);
+}
+
+/*
+ * Wait for all dispatched writes to complete.  This is a no-op when
+ * write fan-out is disabled.
+ */
+static void
+receive_writer_flush(struct receive_writer_arg *rwa)
+{
+	for (int i = 0; i < rwa->write_ntaskqs; i++)
+		taskq_wait(rwa->write_taskqs[i]);
+}
+
 /*
  * dmu_recv_stream's worker thread; pull records off the queue, and then call
  * receive_process_record  When we're done, signal the main thread and exit.
@@ -2281,6 +2413,18 @@ receive_writer_thread(void *arg)
 	struct receive_record_arg *rrd;
 	for (rrd = bqueue_dequeue(&rwa->q); !rrd->eos_marker;
 	    rrd = bqueue_dequeue(&rwa->q)) {
+		/*
+		 * Fan independent writes out to the worker taskqs; the
+		 * worker frees the record.  Any other record type acts as
+		 * a barrier: all dispatched writes must complete before it
+		 * is processed.
+		 */
+		if (rwa->err == 0 && rwa->write_taskqs != NULL &&
+		    rrd->header.drr_type == DRR_WRITE) {
+			receive_write_dispatch(rwa, rrd);
+			continue;
+		}
+		receive_writer_flush(rwa);
 		/*
 		 * If there's an error, the main thread will stop putting things
 		 * on the queue, but we need to clear everything in it before we
@@ -2299,6 +2443,7 @@ receive_writer_thread(void *arg)
 		kmem_free(rrd, sizeof (*rrd));
 	}
 	kmem_free(rrd, sizeof (*rrd));
+	receive_writer_flush(rwa);
 	mutex_enter(&rwa->mutex);
 	rwa->done = B_TRUE;
 	cv_signal(&rwa->cv);
@@ -2489,6 +2634,20 @@ dmu_recv_stream(dmu_recv_cookie_t *drc, vnode_t *vp, offset_t *voffp,
 	rwa.spill = drc->drc_spill;
 	rwa.os->os_raw_receive = drc->drc_raw;
 
+	/*
+	 * Resumable receives must apply records strictly in stream order
+	 * (see save_resume_state()), so they never use write fan-out.
+	 */
+	if (zfs_recv_write_workers > 1 && !rwa.resumable) {
+		rwa.write_ntaskqs = MIN(zfs_recv_write_workers, max_ncpus);
+		rwa.write_taskqs = kmem_zalloc(rwa.write_ntaskqs *
+		    sizeof (taskq_t *), KM_SLEEP);
+		for (int i = 0; i < rwa.write_ntaskqs; i++) {
+			rwa.write_taskqs[i] = taskq_create("recv_write", 1,
+			    minclsyspri, 1, 1, TASKQ_PREPOPULATE);
+		}
+	}
+
 	(void) thread_create(NULL, 0, receive_writer_thread, &rwa, 0, curproc,
 	    TS_RUN, minclsyspri);
 	/*
@@ -2539,6 +2698,15 @@ dmu_recv_stream(dmu_recv_cookie_t *drc, vnode_t *vp, offset_t *voffp,
 	}
 	mutex_exit(&rwa.mutex);
 
+	/* The writer thread flushed the worker taskqs before signaling. */
+	if (rwa.write_taskqs != NULL) {
+		for (int i = 0; i < rwa.write_ntaskqs; i++)
+			taskq_destroy(rwa.write_taskqs[i]);
+		kmem_free(rwa.write_taskqs,
+		    rwa.write_ntaskqs * sizeof (taskq_t *));
+		rwa.write_taskqs = NULL;
+	}
+
 	/*
 	 * If we are receiving a full stream as a clone, all object IDs which
 	 * are greater than the maximum ID referenced in the stream are
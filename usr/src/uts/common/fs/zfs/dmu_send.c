@@ -59,6 +59,13 @@
 /* Set this tunable to TRUE to replace corrupt data with 0x2f5baddb10c */
 int zfs_send_corrupt_data = B_FALSE;
 int zfs_send_queue_length = SPA_MAXBLOCKSIZE;
+/*
+ * Set this tunable to FALSE to stop the send reader thread from issuing
+ * nonblocking ARC reads ahead of the record-construction stage; with it
+ * enabled, many disk reads are in flight while records are serialized to
+ * the stream.
+ */
+int zfs_send_issue_reads = B_TRUE;
 /* Set this tunable to FALSE to disable setting of DRR_FLAG_FREERECORDS */
 int zfs_send_set_freerecords_bit = B_TRUE;
 /* Set this tunable to FALSE is disable sending unmodified spill blocks. */
@@ -92,6 +99,14 @@ struct send_block_record {
 	bqueue_node_t		ln;
 };
 
+struct send_reader_thread_arg {
+	struct send_thread_arg *srta_sta; /* upstream traverse stage */
+	bqueue_t	srta_q;		/* records with reads in flight */
+	uint64_t	srta_featureflags;
+	spa_t		*srta_spa;
+	boolean_t	srta_cancel;
+};
+
 static int do_dump(dmu_sendarg_t *dsa, struct send_block_record *data);
 
 static int
@@ -721,6 +736,71 @@ send_traverse_thread(void *arg)
 	thread_exit();
 }
 
+/*
+ * Issue a nonblocking read for a block that do_dump() will shortly need,
+ * so that the data is already in the ARC by the time its record is
+ * constructed.  The zio flags must match what do_dump() will ask for, so
+ * that the buffer cached here satisfies its arc_read().
+ */
+static void
+send_issue_read(struct send_reader_thread_arg *srta,
+    struct send_block_record *data)
+{
+	const blkptr_t *bp = &data->bp;
+	const zbookmark_phys_t *zb = &data->zb;
+	dmu_object_type_t type = BP_GET_TYPE(bp);
+	int blksz = data->datablkszsec << SPA_MINBLOCKSHIFT;
+	arc_flags_t aflags = ARC_FLAG_NOWAIT | ARC_FLAG_PREFETCH;
+	enum zio_flag zioflags = ZIO_FLAG_CANFAIL | ZIO_FLAG_SPECULATIVE;
+
+	if (BP_IS_HOLE(bp) || BP_IS_EMBEDDED(bp) ||
+	    zb->zb_level > 0 || type == DMU_OT_OBJSET)
+		return;
+	if (zb->zb_object != DMU_META_DNODE_OBJECT &&
+	    DMU_OBJECT_IS_SPECIAL(zb->zb_object))
+		return;
+
+	if (srta->srta_featureflags & DMU_BACKUP_FEATURE_RAW) {
+		zioflags |= ZIO_FLAG_RAW;
+	} else if (type != DMU_OT_DNODE && type != DMU_OT_SA) {
+		boolean_t split_large_blocks =
+		    blksz > SPA_OLD_MAXBLOCKSIZE &&
+		    !(srta->srta_featureflags & DMU_BACKUP_FEATURE_LARGE_BLOCKS);
+
+		if ((srta->srta_featureflags & DMU_BACKUP_FEATURE_COMPRESSED) &&
+		    !split_large_blocks && !BP_SHOULD_BYTESWAP(bp) &&
+		    !DMU_OT_IS_METADATA(type))
+			zioflags |= ZIO_FLAG_RAW_COMPRESS;
+	}
+
+	(void) arc_read(NULL, srta->srta_spa, bp, NULL, NULL,
+	    ZIO_PRIORITY_ASYNC_READ, zioflags, &aflags, zb);
+}
+
+/*
+ * The reader thread sits between the traverse stage and do_dump(),
+ * issuing reads for upcoming records while do_dump() consumes earlier
+ * ones, so the stream stays many disk reads ahead of record
+ * construction.  The bounded queue limits how far ahead we read.
+ */
+static void
+send_reader_thread(void *arg)
+{
+	struct send_reader_thread_arg *srta = arg;
+	struct send_block_record *data;
+
+	data = bqueue_dequeue(&srta->srta_sta->q);
+	while (!data->eos_marker) {
+		if (!srta->srta_cancel && zfs_send_issue_reads)
+			send_issue_read(srta, data);
+		bqueue_enqueue(&srta->srta_q, data,
+		    data->datablkszsec << SPA_MINBLOCKSHIFT);
+		data = bqueue_dequeue(&srta->srta_sta->q);
+	}
+	bqueue_enqueue(&srta->srta_q, data, 1);
+	thread_exit();
+}
+
 /*
  * This function actually handles figuring out what kind of record needs to be
  * dumped, reading the data (which has hopefully been prefetched), and calling
@@ -962,6 +1042,7 @@ dmu_send_impl(void *tag, dsl_pool_t *dp, dsl_dataset_t *to_ds,
 	uint64_t fromtxg = 0;
 	uint64_t featureflags = 0;
 	struct send_thread_arg to_arg = { 0 };
+	struct send_reader_thread_arg srta = { 0 };
 
 	err = dmu_objset_from_ds(to_ds, &os);
 	if (err != 0) {
@@ -1156,24 +1237,36 @@ dmu_send_impl(void *tag, dsl_pool_t *dp, dsl_dataset_t *to_ds,
 	(void) thread_create(NULL, 0, send_traverse_thread, &to_arg, 0, curproc,
 	    TS_RUN, minclsyspri);
 
+	srta.srta_sta = &to_arg;
+	srta.srta_featureflags = featureflags;
+	srta.srta_spa = dmu_objset_spa(os);
+	srta.srta_cancel = B_FALSE;
+	err = bqueue_init(&srta.srta_q,
+	    MAX(zfs_send_queue_length, 2 * zfs_max_recordsize),
+	    offsetof(struct send_block_record, ln));
+	(void) thread_create(NULL, 0, send_reader_thread, &srta, 0, curproc,
+	    TS_RUN, minclsyspri);
+
 	struct send_block_record *to_data;
-	to_data = bqueue_dequeue(&to_arg.q);
+	to_data = bqueue_dequeue(&srta.srta_q);
 
 	while (!to_data->eos_marker && err == 0) {
 		err = do_dump(dsp, to_data);
-		to_data = get_next_record(&to_arg.q, to_data);
+		to_data = get_next_record(&srta.srta_q, to_data);
 		if (issig(JUSTLOOKING) && issig(FORREAL))
 			err = EINTR;
 	}
 
 	if (err != 0) {
 		to_arg.cancel = B_TRUE;
+		srta.srta_cancel = B_TRUE;
 		while (!to_data->eos_marker) {
-			to_data = get_next_record(&to_arg.q, to_data);
+			to_data = get_next_record(&srta.srta_q, to_data);
 		}
 	}
 	kmem_free(to_data, sizeof (*to_data));
 
+	bqueue_destroy(&srta.srta_q);
 	bqueue_destroy(&to_arg.q);
 
 	if (err == 0 && to_arg.error_code != 0)
@@ -687,6 +687,79 @@ dmu_tx_dirty_buf(dmu_tx_t *tx, dmu_buf_impl_t *db)
 hrtime_t zfs_delay_max_ns = MSEC2NSEC(100);
 int zfs_delay_resolution_ns = 100 * 1000; /* 100 microseconds */
 
+/*
+ * When more than one objset has dirty data outstanding, scale each delayed
+ * transaction's minimum time by its objset's share of the pool's dirty data,
+ * relative to an equal split among the dirty objsets.  Objsets dirtying more
+ * than their equal share are delayed more and light writers less, so a single
+ * heavy writer cannot monopolize the dirty buffer space and starve latency-
+ * sensitive writers to other datasets.
+ */
+boolean_t zfs_delay_fairshare = B_TRUE;
+
+/*
+ * Statistics on transaction delays imposed by dmu_tx_delay(), including a
+ * power-of-two histogram of the delays actually applied.
+ */
+#define	DMU_TX_DELAY_HIST_BUCKETS	16
+
+typedef struct dmu_tx_delay_stats {
+	kstat_named_t dtds_delayed;		/* transactions delayed */
+	kstat_named_t dtds_delay_time_ns;	/* total time spent delayed */
+	kstat_named_t dtds_fairshare_raised;	/* delays raised by fairshare */
+	kstat_named_t dtds_fairshare_lowered;	/* delays cut by fairshare */
+	kstat_named_t dtds_hist[DMU_TX_DELAY_HIST_BUCKETS];
+} dmu_tx_delay_stats_t;
+
+static dmu_tx_delay_stats_t dmu_tx_delay_stats = {
+	{ "delayed",			KSTAT_DATA_UINT64 },
+	{ "delay_time_ns",		KSTAT_DATA_UINT64 },
+	{ "fairshare_raised",		KSTAT_DATA_UINT64 },
+	{ "fairshare_lowered",		KSTAT_DATA_UINT64 },
+	{
+		{ "delay_le_8us",	KSTAT_DATA_UINT64 },
+		{ "delay_le_16us",	KSTAT_DATA_UINT64 },
+		{ "delay_le_32us",	KSTAT_DATA_UINT64 },
+		{ "delay_le_64us",	KSTAT_DATA_UINT64 },
+		{ "delay_le_128us",	KSTAT_DATA_UINT64 },
+		{ "delay_le_256us",	KSTAT_DATA_UINT64 },
+		{ "delay_le_512us",	KSTAT_DATA_UINT64 },
+		{ "delay_le_1ms",	KSTAT_DATA_UINT64 },
+		{ "delay_le_2ms",	KSTAT_DATA_UINT64 },
+		{ "delay_le_4ms",	KSTAT_DATA_UINT64 },
+		{ "delay_le_8ms",	KSTAT_DATA_UINT64 },
+		{ "delay_le_16ms",	KSTAT_DATA_UINT64 },
+		{ "delay_le_32ms",	KSTAT_DATA_UINT64 },
+		{ "delay_le_64ms",	KSTAT_DATA_UINT64 },
+		{ "delay_le_128ms",	KSTAT_DATA_UINT64 },
+		{ "delay_gt_128ms",	KSTAT_DATA_UINT64 },
+	}
+};
+
+#define	DMU_TX_DELAY_STAT_BUMP(stat) \
+	atomic_inc_64(&dmu_tx_delay_stats.stat.value.ui64)
+#define	DMU_TX_DELAY_STAT_INCR(stat, val) \
+	atomic_add_64(&dmu_tx_delay_stats.stat.value.ui64, (val))
+
+static kstat_t *dmu_tx_delay_ksp;
+
+static void
+dmu_tx_delay_record(hrtime_t delay)
+{
+	hrtime_t bound = USEC2NSEC(8);
+	int b;
+
+	for (b = 0; b < DMU_TX_DELAY_HIST_BUCKETS - 1; b++) {
+		if (delay <= bound)
+			break;
+		bound *= 2;
+	}
+
+	DMU_TX_DELAY_STAT_BUMP(dtds_delayed);
+	DMU_TX_DELAY_STAT_INCR(dtds_delay_time_ns, delay);
+	atomic_inc_64(&dmu_tx_delay_stats.dtds_hist[b].value.ui64);
+}
+
 /*
  * We delay transactions when we've determined that the backend storage
  * isn't able to accommodate the rate of incoming writes.
@@ -800,11 +873,44 @@ dmu_tx_delay(dmu_tx_t *tx, uint64_t dirty)
 	now = gethrtime();
 	min_tx_time = zfs_delay_scale *
 	    (dirty - delay_min_bytes) / (zfs_dirty_data_max - dirty);
+	min_tx_time = MIN(min_tx_time, zfs_delay_max_ns);
+
+	/*
+	 * Scale the delay by this objset's share of the pool's dirty data,
+	 * relative to an equal split among the dirty objsets:
+	 *
+	 *	min_tx_time *= os_dirty / (dirty_total / dirty_objsets)
+	 *
+	 * so an objset holding exactly its equal share is unaffected, heavy
+	 * writers wait longer, and light writers get through sooner.  The
+	 * MOS is not tracked (tx_objset is NULL in syncing context) and a
+	 * lone dirty objset has nobody to be fair to.
+	 */
+	if (zfs_delay_fairshare && tx->tx_objset != NULL) {
+		uint64_t os_dirty, nds, total, share;
+
+		mutex_enter(&dp->dp_lock);
+		os_dirty = tx->tx_objset->os_dirty_total;
+		nds = dp->dp_dirty_objsets;
+		total = dp->dp_dirty_total;
+		mutex_exit(&dp->dp_lock);
+
+		if (nds > 1 && (share = total / nds) != 0) {
+			hrtime_t fair_tx_time = (hrtime_t)
+			    MIN((uint64_t)min_tx_time * os_dirty / share,
+			    zfs_delay_max_ns);
+
+			if (fair_tx_time > min_tx_time)
+				DMU_TX_DELAY_STAT_BUMP(dtds_fairshare_raised);
+			else if (fair_tx_time < min_tx_time)
+				DMU_TX_DELAY_STAT_BUMP(dtds_fairshare_lowered);
+			min_tx_time = fair_tx_time;
+		}
+	}
+
 	if (now > tx->tx_start + min_tx_time)
 		return;
 
-	min_tx_time = MIN(min_tx_time, zfs_delay_max_ns);
-
 	DTRACE_PROBE3(delay__mintime, dmu_tx_t *, tx, uint64_t, dirty,
 	    uint64_t, min_tx_time);
 
@@ -814,6 +920,9 @@ dmu_tx_delay(dmu_tx_t *tx, uint64_t dirty)
 	dp->dp_last_wakeup = wakeup;
 	mutex_exit(&dp->dp_lock);
 
+	if (wakeup > now)
+		dmu_tx_delay_record(wakeup - now);
+
 #ifdef _KERNEL
 	mutex_enter(&curthread->t_delay_lock);
 	while (cv_timedwait_hires(&curthread->t_delay_cv,
@@ -1337,3 +1446,25 @@ dmu_tx_hold_sa(dmu_tx_t *tx, sa_handle_t *hdl, boolean_t may_grow)
 		DB_DNODE_EXIT(db);
 	}
 }
+
+void
+dmu_tx_stat_init(void)
+{
+	dmu_tx_delay_ksp = kstat_create("zfs", 0, "dmu_tx_delay", "misc",
+	    KSTAT_TYPE_NAMED, sizeof (dmu_tx_delay_stats) /
+	    sizeof (kstat_named_t), KSTAT_FLAG_VIRTUAL);
+
+	if (dmu_tx_delay_ksp != NULL) {
+		dmu_tx_delay_ksp->ks_data = &dmu_tx_delay_stats;
+		kstat_install(dmu_tx_delay_ksp);
+	}
+}
+
+void
+dmu_tx_stat_fini(void)
+{
+	if (dmu_tx_delay_ksp != NULL) {
+		kstat_delete(dmu_tx_delay_ksp);
+		dmu_tx_delay_ksp = NULL;
+	}
+}
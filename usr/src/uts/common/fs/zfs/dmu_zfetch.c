@@ -54,6 +54,24 @@ uint32_t	zfetch_max_idistance = 64 * 1024 * 1024;
 /* max number of bytes in an array_read in which we allow prefetching (1MB) */
 uint64_t	zfetch_array_rd_sz = 1024 * 1024;
 
+/*
+ * The per-dnode streams above only recognize access patterns within a
+ * single object, so workloads that walk many small files in object
+ * order (e.g. a backup reading a directory's files in inode order) get
+ * no prefetch benefit at all.  The sequential-object detector below
+ * watches the order in which objects of an objset see their first
+ * demand read and, once zfetch_seqobj_min_run objects have been read
+ * in (roughly) ascending object order, prefetches the dnode blocks of
+ * the next zfetch_seqobj_distance objects so that the per-file dnode
+ * read is no longer a synchronous disk access.
+ */
+/* consecutive in-order first reads before object prefetch starts (0=off) */
+uint32_t	zfetch_seqobj_min_run = 4;
+/* number of objects to prefetch ahead of the current one */
+uint32_t	zfetch_seqobj_distance = 32;
+/* max gap between object numbers still considered "in order" */
+uint32_t	zfetch_seqobj_max_gap = 8;
+
 typedef struct zfetch_stats {
 	kstat_named_t zfetchstat_hits;
 	kstat_named_t zfetchstat_misses;
@@ -61,6 +79,8 @@ typedef struct zfetch_stats {
 	kstat_named_t zfetchstat_max_completion_us;
 	kstat_named_t zfetchstat_last_completion_us;
 	kstat_named_t zfetchstat_io_issued;
+	kstat_named_t zfetchstat_seqobj_runs;
+	kstat_named_t zfetchstat_seqobj_prefetches;
 } zfetch_stats_t;
 
 static zfetch_stats_t zfetch_stats = {
@@ -70,6 +90,8 @@ static zfetch_stats_t zfetch_stats = {
 	{ "max_completion_us",		KSTAT_DATA_UINT64 },
 	{ "last_completion_us",		KSTAT_DATA_UINT64 },
 	{ "io_issued",		KSTAT_DATA_UINT64 },
+	{ "seqobj_runs",		KSTAT_DATA_UINT64 },
+	{ "seqobj_prefetches",		KSTAT_DATA_UINT64 },
 };
 
 #define	ZFETCHSTAT_BUMP(stat) \
@@ -258,6 +280,52 @@ dmu_zfetch_stream_done(void *arg, boolean_t io_issued)
 		dmu_zfetch_stream_fini(zs);
 }
 
+/*
+ * Note an object's first demand read in the sequential-object detector
+ * of its objset, and prefetch the dnode blocks of upcoming objects once
+ * an ascending run is established.  We only prefetch the dnodes (via
+ * the meta dnode, so no object hold is needed); prefetching file data
+ * would require a synchronous dnode_hold() here, which is exactly the
+ * latency we are trying to hide.  Per-object state is deliberately not
+ * kept: a run is tracked with three words in the objset.
+ */
+static void
+dmu_zfetch_seqobj(dnode_t *dn)
+{
+	objset_t *os = dn->dn_objset;
+	uint64_t obj = dn->dn_object;
+	uint64_t pf_start = 0, pf_end = 0;
+
+	if (zfetch_seqobj_min_run == 0 || DMU_OBJECT_IS_SPECIAL(obj))
+		return;
+
+	mutex_enter(&os->os_seqobj_lock);
+	if (obj > os->os_seqobj_last &&
+	    obj - os->os_seqobj_last <= zfetch_seqobj_max_gap) {
+		if (os->os_seqobj_run < UINT_MAX)
+			os->os_seqobj_run++;
+	} else if (obj != os->os_seqobj_last) {
+		os->os_seqobj_run = 0;
+		os->os_seqobj_pfed = 0;
+	}
+	os->os_seqobj_last = obj;
+	if (os->os_seqobj_run >= zfetch_seqobj_min_run) {
+		pf_start = MAX(obj + 1, os->os_seqobj_pfed + 1);
+		pf_end = obj + zfetch_seqobj_distance;
+		if (pf_end >= pf_start) {
+			os->os_seqobj_pfed = pf_end;
+			if (os->os_seqobj_run == zfetch_seqobj_min_run)
+				ZFETCHSTAT_BUMP(zfetchstat_seqobj_runs);
+		}
+	}
+	mutex_exit(&os->os_seqobj_lock);
+
+	for (uint64_t o = pf_start; o != 0 && o <= pf_end; o++) {
+		dmu_prefetch(os, o, 0, 0, 0, ZIO_PRIORITY_ASYNC_READ);
+		ZFETCHSTAT_BUMP(zfetchstat_seqobj_prefetches);
+	}
+}
+
 /*
  * This is the predictive prefetch entry point.  It associates dnode access
  * specified with blkid and nblks arguments with prefetch stream, predicts
@@ -292,10 +360,15 @@ dmu_zfetch(zfetch_t *zf, uint64_t blkid, uint64_t nblks, boolean_t fetch_data,
 
 	/*
 	 * As a fast path for small (single-block) files, ignore access
-	 * to the first block.
+	 * to the first block.  It is, however, exactly the access that
+	 * the sequential-object detector cares about: feed it the first
+	 * demand read of each object so that walks of many small files
+	 * get their upcoming dnodes prefetched.
 	 */
-	if (!have_lock && blkid == 0)
+	if (!have_lock && blkid == 0) {
+		dmu_zfetch_seqobj(zf->zf_dnode);
 		return;
+	}
 
 	if (!have_lock)
 		rw_enter(&zf->zf_dnode->dn_struct_rwlock, RW_READER);
@@ -242,12 +242,21 @@ dsl_deadlist_insert(dsl_deadlist_t *dl, const blkptr_t *bp, dmu_tx_t *tx)
 	dl->dl_phys->dl_comp += BP_GET_PSIZE(bp);
 	dl->dl_phys->dl_uncomp += BP_GET_UCSIZE(bp);
 
-	dle_tofind.dle_mintxg = bp->blk_birth;
-	dle = avl_find(&dl->dl_tree, &dle_tofind, &where);
-	if (dle == NULL)
-		dle = avl_nearest(&dl->dl_tree, where, AVL_BEFORE);
-	else
-		dle = AVL_PREV(&dl->dl_tree, dle);
+	/*
+	 * Blocks freed from the live dataset were almost always born
+	 * after the most recent snapshot, so they belong to the last
+	 * entry; check it first so that steady-state frees don't walk
+	 * the tree once per block on a deadlist with many entries.
+	 */
+	dle = avl_last(&dl->dl_tree);
+	if (dle == NULL || dle->dle_mintxg >= bp->blk_birth) {
+		dle_tofind.dle_mintxg = bp->blk_birth;
+		dle = avl_find(&dl->dl_tree, &dle_tofind, &where);
+		if (dle == NULL)
+			dle = avl_nearest(&dl->dl_tree, where, AVL_BEFORE);
+		else
+			dle = AVL_PREV(&dl->dl_tree, dle);
+	}
 	dle_enqueue(dl, dle, bp, tx);
 	mutex_exit(&dl->dl_lock);
 }
@@ -573,6 +573,37 @@ dsl_pool_dirty_delta(dsl_pool_t *dp, int64_t delta)
 		cv_signal(&dp->dp_spaceavail_cv);
 }
 
+/*
+ * Adjust an objset's share of the pool's dirty data.  The per-objset
+ * totals feed the fair-share write throttle in dmu_tx_delay().  The MOS
+ * is not tracked by dmu_objset_willuse_space(), so os may be NULL here.
+ */
+static void
+dsl_pool_dirty_objset(dsl_pool_t *dp, objset_t *os, int64_t delta,
+    uint64_t txg)
+{
+	ASSERT(MUTEX_HELD(&dp->dp_lock));
+
+	if (os == NULL)
+		return;
+
+	/*
+	 * As in dsl_pool_undirty_space(), tolerate undirtying space that
+	 * was never accounted to this objset.
+	 */
+	if (delta < 0 && os->os_dirty_pertxg[txg & TXG_MASK] < -delta)
+		delta = -(int64_t)os->os_dirty_pertxg[txg & TXG_MASK];
+
+	if (os->os_dirty_total == 0 && delta > 0)
+		dp->dp_dirty_objsets++;
+	os->os_dirty_pertxg[txg & TXG_MASK] += delta;
+	os->os_dirty_total += delta;
+	if (os->os_dirty_total == 0 && delta < 0) {
+		ASSERT3U(dp->dp_dirty_objsets, >, 0);
+		dp->dp_dirty_objsets--;
+	}
+}
+
 static boolean_t
 dsl_early_sync_task_verify(dsl_pool_t *dp, uint64_t txg)
 {
@@ -649,7 +680,17 @@ dsl_pool_sync(dsl_pool_t *dp, uint64_t txg)
 	 * rounding error in dbuf_write_physdone).
 	 * Shore up the accounting of any dirtied space now.
 	 */
-	dsl_pool_undirty_space(dp, dp->dp_dirty_pertxg[txg & TXG_MASK], txg);
+	mutex_enter(&dp->dp_lock);
+	for (ds = list_head(&synced_datasets); ds != NULL;
+	    ds = list_next(&synced_datasets, ds)) {
+		objset_t *os = ds->ds_objset;
+
+		dsl_pool_dirty_objset(dp, os,
+		    -(int64_t)os->os_dirty_pertxg[txg & TXG_MASK], txg);
+	}
+	mutex_exit(&dp->dp_lock);
+	dsl_pool_undirty_space(dp, NULL, dp->dp_dirty_pertxg[txg & TXG_MASK],
+	    txg);
 
 	/*
 	 * Update the long range free counter after
@@ -882,18 +923,20 @@ dsl_pool_need_dirty_delay(dsl_pool_t *dp)
 }
 
 void
-dsl_pool_dirty_space(dsl_pool_t *dp, int64_t space, dmu_tx_t *tx)
+dsl_pool_dirty_space(dsl_pool_t *dp, objset_t *os, int64_t space, dmu_tx_t *tx)
 {
 	if (space > 0) {
 		mutex_enter(&dp->dp_lock);
 		dp->dp_dirty_pertxg[tx->tx_txg & TXG_MASK] += space;
+		dsl_pool_dirty_objset(dp, os, space, tx->tx_txg);
 		dsl_pool_dirty_delta(dp, space);
 		mutex_exit(&dp->dp_lock);
 	}
 }
 
 void
-dsl_pool_undirty_space(dsl_pool_t *dp, int64_t space, uint64_t txg)
+dsl_pool_undirty_space(dsl_pool_t *dp, objset_t *os, int64_t space,
+    uint64_t txg)
 {
 	ASSERT3S(space, >=, 0);
 	if (space == 0)
@@ -905,6 +948,7 @@ dsl_pool_undirty_space(dsl_pool_t *dp, int64_t space, uint64_t txg)
 	}
 	ASSERT3U(dp->dp_dirty_pertxg[txg & TXG_MASK], >=, space);
 	dp->dp_dirty_pertxg[txg & TXG_MASK] -= space;
+	dsl_pool_dirty_objset(dp, os, -space, txg);
 	ASSERT3U(dp->dp_dirty_total, >=, space);
 	dsl_pool_dirty_delta(dp, -space);
 	mutex_exit(&dp->dp_lock);
@@ -1271,9 +1315,63 @@ dsl_pool_rele(dsl_pool_t *dp, void *tag)
 	spa_close(dp->dp_spa, tag);
 }
 
+/*
+ * Statistics on dp_config_rwlock acquisition, aggregated across pools.
+ * Read-side enters come overwhelmingly from the ioctl path (via
+ * dsl_pool_hold()); the write side is taken from sync context, so the
+ * write_wait figures put a number on how long txg sync was delayed
+ * waiting for reader (largely ioctl) traffic to drain.
+ */
+typedef struct dsl_pool_config_stats {
+	kstat_named_t dpcs_read_enters;
+	kstat_named_t dpcs_read_wait_ns;
+	kstat_named_t dpcs_write_enters;
+	kstat_named_t dpcs_write_wait_ns;
+	kstat_named_t dpcs_write_wait_max_ns;
+} dsl_pool_config_stats_t;
+
+static dsl_pool_config_stats_t dsl_pool_config_stats = {
+	{ "read_enters",	KSTAT_DATA_UINT64 },
+	{ "read_wait_ns",	KSTAT_DATA_UINT64 },
+	{ "write_enters",	KSTAT_DATA_UINT64 },
+	{ "write_wait_ns",	KSTAT_DATA_UINT64 },
+	{ "write_wait_max_ns",	KSTAT_DATA_UINT64 },
+};
+
+#define	DSL_POOL_CONFIG_STAT_BUMP(stat) \
+	atomic_inc_64(&dsl_pool_config_stats.stat.value.ui64)
+#define	DSL_POOL_CONFIG_STAT_INCR(stat, val) \
+	atomic_add_64(&dsl_pool_config_stats.stat.value.ui64, (val))
+
+static kstat_t *dsl_pool_config_ksp;
+
+void
+dsl_pool_stat_init(void)
+{
+	dsl_pool_config_ksp = kstat_create("zfs", 0, "dsl_pool_config",
+	    "misc", KSTAT_TYPE_NAMED, sizeof (dsl_pool_config_stats) /
+	    sizeof (kstat_named_t), KSTAT_FLAG_VIRTUAL);
+
+	if (dsl_pool_config_ksp != NULL) {
+		dsl_pool_config_ksp->ks_data = &dsl_pool_config_stats;
+		kstat_install(dsl_pool_config_ksp);
+	}
+}
+
+void
+dsl_pool_stat_fini(void)
+{
+	if (dsl_pool_config_ksp != NULL) {
+		kstat_delete(dsl_pool_config_ksp);
+		dsl_pool_config_ksp = NULL;
+	}
+}
+
 void
 dsl_pool_config_enter(dsl_pool_t *dp, void *tag)
 {
+	hrtime_t start;
+
 	/*
 	 * We use a "reentrant" reader-writer lock, but not reentrantly.
 	 *
@@ -1287,14 +1385,45 @@ dsl_pool_config_enter(dsl_pool_t *dp, void *tag)
 	 * if any thread holds it for read, even if this thread doesn't).
 	 */
 	ASSERT(!rrw_held(&dp->dp_config_rwlock, RW_READER));
+	start = gethrtime();
 	rrw_enter(&dp->dp_config_rwlock, RW_READER, tag);
+	DSL_POOL_CONFIG_STAT_BUMP(dpcs_read_enters);
+	DSL_POOL_CONFIG_STAT_INCR(dpcs_read_wait_ns, gethrtime() - start);
 }
 
 void
 dsl_pool_config_enter_prio(dsl_pool_t *dp, void *tag)
 {
+	hrtime_t start;
+
 	ASSERT(!rrw_held(&dp->dp_config_rwlock, RW_READER));
+	start = gethrtime();
 	rrw_enter_read_prio(&dp->dp_config_rwlock, tag);
+	DSL_POOL_CONFIG_STAT_BUMP(dpcs_read_enters);
+	DSL_POOL_CONFIG_STAT_INCR(dpcs_read_wait_ns, gethrtime() - start);
+}
+
+/*
+ * Take the config lock as writer, recording how long the writer had to
+ * wait for the reader traffic to drain.  The write-side users in sync
+ * context go through this wrapper rather than rrw_enter() so the wait
+ * shows up in the dsl_pool_config kstat.  The max update is not
+ * atomic; a race between concurrent writers can only lose one sample,
+ * which is acceptable for observability.
+ */
+void
+dsl_pool_config_enter_write(dsl_pool_t *dp, void *tag)
+{
+	hrtime_t delta;
+
+	delta = gethrtime();
+	rrw_enter(&dp->dp_config_rwlock, RW_WRITER, tag);
+	delta = gethrtime() - delta;
+	DSL_POOL_CONFIG_STAT_BUMP(dpcs_write_enters);
+	DSL_POOL_CONFIG_STAT_INCR(dpcs_write_wait_ns, delta);
+	if (delta > dsl_pool_config_stats.dpcs_write_wait_max_ns.value.ui64)
+		dsl_pool_config_stats.dpcs_write_wait_max_ns.value.ui64 =
+		    delta;
 }
 
 void
@@ -299,6 +299,15 @@ struct dsl_scan_io_queue {
 	avl_tree_t	q_sios_by_addr;
 	uint64_t	q_sio_memused;
 
+	/*
+	 * Elevator state for LBA-ordered issuing. q_issue_cursor marks
+	 * where the current ascending sweep through q_exts_by_addr left
+	 * off; q_last_issued is the offset of the most recently issued
+	 * zio and is used only for the sequentiality statistics.
+	 */
+	uint64_t	q_issue_cursor;
+	uint64_t	q_last_issued;
+
 	/* members for zio rate limiting */
 	uint64_t	q_maxinflight_bytes;
 	uint64_t	q_inflight_bytes;
@@ -338,6 +347,33 @@ static void scan_io_queues_destroy(dsl_scan_t *scn);
 
 static kmem_cache_t *sio_cache[SPA_DVAS_PER_BP];
 
+/*
+ * Pool-wide statistics on how sequentially the sorted scan logic is
+ * managing to issue its zios. A scrub that is working well should see
+ * sios_sequential close to sios_issued; a low ratio means the sorting
+ * queues are being drained before they can accumulate large runs.
+ */
+typedef struct scan_stats {
+	kstat_named_t scanstat_extents_issued;
+	kstat_named_t scanstat_sios_issued;
+	kstat_named_t scanstat_sios_sequential;
+	kstat_named_t scanstat_bytes_issued;
+} scan_stats_t;
+
+static scan_stats_t scan_stats = {
+	{ "extents_issued",	KSTAT_DATA_UINT64 },
+	{ "sios_issued",	KSTAT_DATA_UINT64 },
+	{ "sios_sequential",	KSTAT_DATA_UINT64 },
+	{ "bytes_issued",	KSTAT_DATA_UINT64 },
+};
+
+#define	SCANSTAT_BUMP(stat) \
+	atomic_inc_64(&scan_stats.stat.value.ui64);
+#define	SCANSTAT_INCR(stat, val) \
+	atomic_add_64(&scan_stats.stat.value.ui64, (val));
+
+static kstat_t *scan_ksp;
+
 /* sio->sio_nr_dvas must be set so we know which cache to free from */
 static void
 sio_free(scan_io_t *sio)
@@ -379,11 +415,24 @@ scan_init(void)
 		    (sizeof (scan_io_t) + ((i + 1) * sizeof (dva_t))),
 		    0, NULL, NULL, NULL, NULL, NULL, 0);
 	}
+
+	scan_ksp = kstat_create("zfs", 0, "scan_stats", "misc",
+	    KSTAT_TYPE_NAMED, sizeof (scan_stats) / sizeof (kstat_named_t),
+	    KSTAT_FLAG_VIRTUAL);
+	if (scan_ksp != NULL) {
+		scan_ksp->ks_data = &scan_stats;
+		kstat_install(scan_ksp);
+	}
 }
 
 void
 scan_fini(void)
 {
+	if (scan_ksp != NULL) {
+		kstat_delete(scan_ksp);
+		scan_ksp = NULL;
+	}
+
 	for (int i = 0; i < SPA_DVAS_PER_BP; i++) {
 		kmem_cache_destroy(sio_cache[i]);
 	}
@@ -2732,6 +2781,18 @@ scan_io_queue_issue(dsl_scan_io_queue_t *queue, list_t *io_list)
 
 		sio2bp(sio, &bp);
 		bytes_issued += SIO_GET_ASIZE(sio);
+
+		/*
+		 * An I/O is sequential if it begins at or past the end
+		 * of the previous one we issued from this queue. The
+		 * ratio of sios_sequential to sios_issued measures how
+		 * well the sorting logic is avoiding seeks.
+		 */
+		SCANSTAT_BUMP(scanstat_sios_issued);
+		if (SIO_GET_OFFSET(sio) >= queue->q_last_issued)
+			SCANSTAT_BUMP(scanstat_sios_sequential);
+		queue->q_last_issued = SIO_GET_END_OFFSET(sio);
+
 		scan_exec_io(scn->scn_dp, &bp, sio->sio_flags,
 		    &sio->sio_zb, queue);
 		(void) list_remove_head(io_list);
@@ -2739,6 +2800,7 @@ scan_io_queue_issue(dsl_scan_io_queue_t *queue, list_t *io_list)
 		sio_free(sio);
 	}
 
+	SCANSTAT_INCR(scanstat_bytes_issued, bytes_issued);
 	atomic_add_64(&scn->scn_bytes_pending, -bytes_issued);
 
 	return (suspended);
@@ -2811,11 +2873,39 @@ scan_io_queue_gather(dsl_scan_io_queue_t *queue, range_seg_t *rs, list_t *list)
 		uint64_t rstart = rs_get_start(rs, queue->q_exts_by_addr);
 		uint64_t rend = rs_get_end(rs, queue->q_exts_by_addr);
 		range_tree_remove(queue->q_exts_by_addr, rstart, rend - rstart);
+		SCANSTAT_BUMP(scanstat_extents_issued);
 		return (B_FALSE);
 	}
 }
 
 
+/*
+ * Fetches the next extent of an ascending-LBA sweep across the queue's
+ * extent index. The cursor records how far the current sweep has
+ * progressed; once no extents remain at or above it we wrap around and
+ * begin a new sweep from the lowest extent. This keeps reads strictly
+ * ascending on disk for the duration of each sweep, rather than
+ * restarting the search from the lowest LBA after every extent.
+ */
+static range_seg_t *
+scan_io_queue_lba_fetch(dsl_scan_io_queue_t *queue)
+{
+	range_tree_t *rt = queue->q_exts_by_addr;
+	range_seg_t *rs;
+
+	ASSERT(MUTEX_HELD(&queue->q_vd->vdev_scan_io_queue_lock));
+
+	rs = range_tree_find_gteq(rt, queue->q_issue_cursor);
+	if (rs == NULL) {
+		rs = range_tree_first(rt);
+		if (rs == NULL)
+			return (NULL);
+	}
+	queue->q_issue_cursor = rs_get_start(rs, rt);
+
+	return (rs);
+}
+
 /*
  * This is called from the queue emptying thread and selects the next
  * extent from which we are to issue io's. The behavior of this function
@@ -2839,7 +2929,7 @@ scan_io_queue_fetch_ext(dsl_scan_io_queue_t *queue)
 	/* handle tunable overrides */
 	if (scn->scn_checkpointing || scn->scn_clearing) {
 		if (zfs_scan_issue_strategy == 1) {
-			return (range_tree_first(rt));
+			return (scan_io_queue_lba_fetch(queue));
 		} else if (zfs_scan_issue_strategy == 2) {
 			/*
 			 * We need to get the original entry in the by_addr
@@ -2872,7 +2962,7 @@ scan_io_queue_fetch_ext(dsl_scan_io_queue_t *queue)
 	 * In this case, we instead switch to issuing extents in LBA order.
 	 */
 	if (scn->scn_checkpointing) {
-		return (range_tree_first(rt));
+		return (scan_io_queue_lba_fetch(queue));
 	} else if (scn->scn_clearing) {
 		/*
 		 * We need to get the original entry in the by_addr
@@ -3325,7 +3415,7 @@ dsl_process_async_destroys(dsl_pool_t *dp, dmu_tx_t *tx)
 		 * space to the dp_leak_dir.
 		 */
 		if (dp->dp_leak_dir == NULL) {
-			rrw_enter(&dp->dp_config_rwlock, RW_WRITER, FTAG);
+			dsl_pool_config_enter_write(dp, FTAG);
 			(void) dsl_dir_create_sync(dp, dp->dp_root_dir,
 			    LEAK_DIR_NAME, tx);
 			VERIFY0(dsl_pool_open_special_dir(dp,
@@ -246,7 +246,7 @@ dsl_sync_task_sync(dsl_sync_task_t *dst, dmu_tx_t *tx)
 	/*
 	 * Check for errors by calling checkfunc.
 	 */
-	rrw_enter(&dp->dp_config_rwlock, RW_WRITER, FTAG);
+	dsl_pool_config_enter_write(dp, FTAG);
 	dst->dst_error = dst->dst_checkfunc(dst->dst_arg, tx);
 	if (dst->dst_error == 0)
 		dst->dst_syncfunc(dst->dst_arg, tx);
@@ -212,9 +212,14 @@ int metaslab_unload_delay = 32;
 int metaslab_unload_delay_ms = 10 * 60 * 1000; /* ten minutes */
 
 /*
- * Max number of metaslabs per group to preload.
+ * Minimum number of metaslabs per group to preload.  Under allocation
+ * pressure the preload policy keeps additional metaslabs loaded, up to
+ * metaslab_preload_max, so that enough free space is loaded to cover
+ * metaslab_preload_window txgs of the group's recent allocation rate.
  */
 int metaslab_preload_limit = 10;
+int metaslab_preload_max = 32;
+int metaslab_preload_window = 4;
 
 /*
  * Enable/disable preloading of metaslab.
@@ -320,12 +325,18 @@ typedef struct metaslab_stats {
 	kstat_named_t metaslabstat_trace_over_limit;
 	kstat_named_t metaslabstat_df_find_under_floor;
 	kstat_named_t metaslabstat_reload_tree;
+	kstat_named_t metaslabstat_preload_hits;
+	kstat_named_t metaslabstat_load_stalls;
+	kstat_named_t metaslabstat_preloads_issued;
 } metaslab_stats_t;
 
 static metaslab_stats_t metaslab_stats = {
 	{ "trace_over_limit",		KSTAT_DATA_UINT64 },
 	{ "df_find_under_floor",	KSTAT_DATA_UINT64 },
 	{ "reload_tree",		KSTAT_DATA_UINT64 },
+	{ "preload_hits",		KSTAT_DATA_UINT64 },
+	{ "load_stalls",		KSTAT_DATA_UINT64 },
+	{ "preloads_issued",		KSTAT_DATA_UINT64 },
 };
 
 #define	METASLABSTAT_BUMP(stat) \
@@ -3397,6 +3408,9 @@ metaslab_group_preload(metaslab_group_t *mg)
 
 	mutex_enter(&mg->mg_lock);
 
+	uint64_t need = (uint64_t)mg->mg_alloc_rate * metaslab_preload_window;
+	uint64_t loaded_space = 0;
+
 	/*
 	 * Load the next potential metaslabs
 	 */
@@ -3404,15 +3418,28 @@ metaslab_group_preload(metaslab_group_t *mg)
 		ASSERT3P(msp->ms_group, ==, mg);
 
 		/*
-		 * We preload only the maximum number of metaslabs specified
-		 * by metaslab_preload_limit. If a metaslab is being forced
+		 * We preload at least metaslab_preload_limit metaslabs and,
+		 * under allocation pressure, keep going until the loaded
+		 * free space covers metaslab_preload_window txgs of this
+		 * group's recent allocation rate, never exceeding
+		 * metaslab_preload_max. If a metaslab is being forced
 		 * to condense then we preload it too. This will ensure
 		 * that force condensing happens in the next txg.
 		 */
-		if (++m > metaslab_preload_limit && !msp->ms_condense_wanted) {
+		if (++m > metaslab_preload_limit &&
+		    (loaded_space >= need || m > metaslab_preload_max) &&
+		    !msp->ms_condense_wanted) {
 			continue;
 		}
 
+		/*
+		 * The space map may be updated while we drop ms_lock, but
+		 * this is only an estimate used to size the working set.
+		 */
+		loaded_space += msp->ms_size - (msp->ms_sm == NULL ? 0 :
+		    space_map_allocated(msp->ms_sm));
+
+		METASLABSTAT_BUMP(metaslabstat_preloads_issued);
 		VERIFY(taskq_dispatch(mg->mg_taskq, metaslab_preload,
 		    msp, TQ_SLEEP) != TASKQID_INVALID);
 	}
@@ -4327,6 +4354,16 @@ metaslab_sync_reassess(metaslab_group_t *mg)
 	metaslab_group_alloc_update(mg);
 	mg->mg_fragmentation = metaslab_group_fragmentation(mg);
 
+	/*
+	 * Fold the bytes allocated from this group since the last
+	 * reassessment into a decaying per-txg allocation rate estimate,
+	 * which sizes the preload working set below.
+	 */
+	mutex_enter(&mg->mg_lock);
+	mg->mg_alloc_rate = (mg->mg_alloc_rate + mg->mg_allocated_bytes) / 2;
+	mg->mg_allocated_bytes = 0;
+	mutex_exit(&mg->mg_lock);
+
 	/*
 	 * Preload the next potential metaslabs but only on active
 	 * metaslab groups. We can get into a state where the metaslab
@@ -4744,6 +4781,18 @@ metaslab_group_alloc_normal(metaslab_group_t *mg, zio_alloc_list_t *zal,
 		}
 		mutex_enter(&msp->ms_lock);
 
+		/*
+		 * Account how often the allocator found its metaslab
+		 * already loaded (a preload hit) versus having to pay a
+		 * synchronous space map load below (a load stall).
+		 */
+		if (!was_active) {
+			if (msp->ms_loaded)
+				METASLABSTAT_BUMP(metaslabstat_preload_hits);
+			else
+				METASLABSTAT_BUMP(metaslabstat_load_stalls);
+		}
+
 		metaslab_active_mask_verify(msp);
 
 		/*
@@ -4972,7 +5021,9 @@ metaslab_group_alloc(metaslab_group_t *mg, zio_alloc_list_t *zal,
 	    dva, d, allocator, try_hard);
 
 	mutex_enter(&mg->mg_lock);
-	if (offset == -1ULL) {
+	if (offset != -1ULL) {
+		mg->mg_allocated_bytes += asize;
+	} else {
 		mg->mg_failed_allocations++;
 		metaslab_trace_add(zal, mg, NULL, asize, d,
 		    TRACE_GROUP_FAILURE, allocator);
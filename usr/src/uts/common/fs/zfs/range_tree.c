@@ -631,6 +631,26 @@ range_tree_find_in(range_tree_t *rt, uint64_t start, uint64_t size,
 	return (B_TRUE);
 }
 
+/*
+ * Returns the segment containing the given offset, or if no such segment
+ * exists, the next segment at a higher offset. Returns NULL if no segment
+ * in the tree starts at or after the given offset.
+ */
+range_seg_t *
+range_tree_find_gteq(range_tree_t *rt, uint64_t start)
+{
+	range_seg_max_t rsearch;
+	rs_set_start(&rsearch, rt, start);
+	rs_set_end_raw(&rsearch, rt, rs_get_start_raw(&rsearch, rt) + 1);
+
+	zfs_btree_index_t where;
+	range_seg_t *rs = zfs_btree_find(&rt->rt_root, &rsearch, &where);
+	if (rs != NULL)
+		return (rs);
+
+	return (zfs_btree_next(&rt->rt_root, &where, &where));
+}
+
 /*
  * Ensure that this range is not in the tree, regardless of whether
  * it is currently in the tree.
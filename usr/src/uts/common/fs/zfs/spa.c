@@ -1017,6 +1017,16 @@ spa_taskqs_init(spa_t *spa, zio_type_t t, zio_taskq_type_t q)
 
 		tqs->stqs_taskq[i] = tq;
 	}
+
+	/*
+	 * Interrupt-side dispatches are batched per CPU; see
+	 * zio_taskq_dispatch().
+	 */
+	if (zio_batch_interrupts && (q == ZIO_TASKQ_INTERRUPT ||
+	    q == ZIO_TASKQ_INTERRUPT_HIGH)) {
+		tqs->stqs_batch = kmem_zalloc(max_ncpus *
+		    sizeof (zio_dispatch_batch_t), KM_SLEEP);
+	}
 }
 
 static void
@@ -1036,6 +1046,14 @@ spa_taskqs_fini(spa_t *spa, zio_type_t t, zio_taskq_type_t q)
 
 	kmem_free(tqs->stqs_taskq, tqs->stqs_count * sizeof (taskq_t *));
 	tqs->stqs_taskq = NULL;
+
+	if (tqs->stqs_batch != NULL) {
+		for (uint_t i = 0; i < max_ncpus; i++)
+			ASSERT3P(tqs->stqs_batch[i].zdb_list, ==, NULL);
+		kmem_free(tqs->stqs_batch,
+		    max_ncpus * sizeof (zio_dispatch_batch_t));
+		tqs->stqs_batch = NULL;
+	}
 }
 
 /*
@@ -2591,11 +2609,13 @@ spa_activity_check(spa_t *spa, uberblock_t *ub, nvlist_t *config)
 	uint64_t mmp_config = ub->ub_mmp_config;
 	uint16_t mmp_seq = MMP_SEQ_VALID(ub) ? MMP_SEQ(ub) : 0;
 	uint64_t import_delay;
+	uint64_t mmp_interval_ms;
 	hrtime_t import_expire;
 	nvlist_t *mmp_label = NULL;
 	vdev_t *rvd = spa->spa_root_vdev;
 	kcondvar_t cv;
 	kmutex_t mtx;
+	clock_t sleep_ticks;
 	int error = 0;
 
 	cv_init(&cv, NULL, CV_DEFAULT, NULL);
@@ -2629,6 +2649,17 @@ spa_activity_check(spa_t *spa, uberblock_t *ub, nvlist_t *config)
 
 	import_expire = gethrtime() + import_delay;
 
+	/*
+	 * Poll at half the interval at which an active importer would be
+	 * writing new uberblocks, so that activity is noticed promptly
+	 * when short multihost intervals are in use, but no faster than
+	 * once per tick and no slower than once per second.
+	 */
+	mmp_interval_ms = MMP_INTERVAL_VALID(ub) ? MMP_INTERVAL(ub) :
+	    MMP_INTERVAL_OK(zfs_multihost_interval);
+	sleep_ticks = MAX(1, MIN((clock_t)hz,
+	    MSEC_TO_TICK(mmp_interval_ms / 2)));
+
 	while (gethrtime() < import_expire) {
 		(void) spa_import_progress_set_mmp_check(spa,
 		    NSEC2SEC(import_expire - gethrtime()));
@@ -2653,7 +2684,8 @@ spa_activity_check(spa_t *spa, uberblock_t *ub, nvlist_t *config)
 			mmp_label = NULL;
 		}
 
-		error = cv_timedwait_sig(&cv, &mtx, ddi_get_lbolt() + hz);
+		error = cv_timedwait_sig(&cv, &mtx,
+		    ddi_get_lbolt() + sleep_ticks);
 		if (error != -1) {
 			error = SET_ERROR(EINTR);
 			break;
@@ -2856,6 +2888,7 @@ static int
 spa_ld_open_vdevs(spa_t *spa)
 {
 	int error = 0;
+	hrtime_t start = gethrtime();
 
 	/*
 	 * spa_missing_tvds_allowed defines how many top-level vdevs can be
@@ -2907,6 +2940,9 @@ spa_ld_open_vdevs(spa_t *spa)
 	if (spa->spa_missing_tvds != 0 || error != 0)
 		vdev_dbgmsg_print_tree(spa->spa_root_vdev, 2);
 
+	(void) spa_import_progress_set_phase_ms(spa,
+	    SPA_IMPORT_PHASE_VDEV_OPEN, NSEC2MSEC(gethrtime() - start));
+
 	return (error);
 }
 
@@ -2921,11 +2957,15 @@ spa_ld_validate_vdevs(spa_t *spa)
 {
 	int error = 0;
 	vdev_t *rvd = spa->spa_root_vdev;
+	hrtime_t start = gethrtime();
 
 	spa_config_enter(spa, SCL_ALL, FTAG, RW_WRITER);
 	error = vdev_validate(rvd);
 	spa_config_exit(spa, SCL_ALL, FTAG);
 
+	(void) spa_import_progress_set_phase_ms(spa,
+	    SPA_IMPORT_PHASE_VDEV_VALIDATE, NSEC2MSEC(gethrtime() - start));
+
 	if (error != 0) {
 		spa_load_failed(spa, "vdev_validate failed [error=%d]", error);
 		return (error);
@@ -3726,13 +3766,19 @@ spa_ld_load_vdev_metadata(spa_t *spa)
 	/*
 	 * Load the vdev metadata such as metaslabs, DTLs, spacemap object, etc.
 	 */
+	hrtime_t start = gethrtime();
 	error = vdev_load(rvd);
+	(void) spa_import_progress_set_phase_ms(spa,
+	    SPA_IMPORT_PHASE_VDEV_LOAD, NSEC2MSEC(gethrtime() - start));
 	if (error != 0) {
 		spa_load_failed(spa, "vdev_load failed [error=%d]", error);
 		return (spa_vdev_err(rvd, VDEV_AUX_CORRUPT_DATA, error));
 	}
 
+	start = gethrtime();
 	error = spa_ld_log_spacemaps(spa);
+	(void) spa_import_progress_set_phase_ms(spa,
+	    SPA_IMPORT_PHASE_LOG_SM, NSEC2MSEC(gethrtime() - start));
 	if (error != 0) {
 		spa_load_failed(spa, "spa_ld_log_sm_data failed [error=%d]",
 		    error);
@@ -8241,7 +8287,7 @@ spa_sync_upgrades(spa_t *spa, dmu_tx_t *tx)
 		return;
 
 	dsl_pool_t *dp = spa->spa_dsl_pool;
-	rrw_enter(&dp->dp_config_rwlock, RW_WRITER, FTAG);
+	dsl_pool_config_enter_write(dp, FTAG);
 
 	if (spa->spa_ubsync.ub_version < SPA_VERSION_ORIGIN &&
 	    spa->spa_uberblock.ub_version >= SPA_VERSION_ORIGIN) {
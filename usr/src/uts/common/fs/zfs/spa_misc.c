@@ -60,6 +60,7 @@
 #include <sys/arc.h>
 #include <sys/ddt.h>
 #include "zfs_prop.h"
+#include <zfs_fletcher.h>
 #include <sys/btree.h>
 #include <sys/zfeature.h>
 
@@ -2071,6 +2072,7 @@ typedef struct spa_import_progress {
 	kstat_named_t sip_load_state;
 	kstat_named_t sip_mmp_sec_remaining;	/* MMP activity check */
 	kstat_named_t sip_load_max_txg;		/* rewind txg */
+	kstat_named_t sip_phase_ms[SPA_IMPORT_PHASE_COUNT]; /* phase timing */
 } spa_import_progress_t;
 
 static void
@@ -2137,6 +2139,30 @@ spa_import_progress_set_mmp_check(spa_t *spa, uint64_t mmp_sec_remaining)
 	return (0);
 }
 
+/*
+ * Record how long a load phase took, in milliseconds, so that slow
+ * imports can be broken down from userland while they are running.
+ */
+int
+spa_import_progress_set_phase_ms(spa_t *spa, spa_import_phase_t phase,
+    uint64_t ms)
+{
+	ASSERT3U(phase, <, SPA_IMPORT_PHASE_COUNT);
+
+	if (spa->spa_imp_kstat == NULL)
+		spa_import_progress_add(spa);
+
+	mutex_enter(&spa->spa_imp_kstat_lock);
+	if (spa->spa_imp_kstat != NULL) {
+		spa_import_progress_t *sip = spa->spa_imp_kstat->ks_data;
+		if (sip != NULL)
+			sip->sip_phase_ms[phase].value.ui64 = ms;
+	}
+	mutex_exit(&spa->spa_imp_kstat_lock);
+
+	return (0);
+}
+
 /*
  * A new import is in progress. Add an entry.
  */
@@ -2164,7 +2190,7 @@ spa_import_progress_add(spa_t *spa)
 	    sizeof (spa_import_progress_t) / sizeof (kstat_named_t),
 	    KSTAT_FLAG_VIRTUAL);
 	if (spa->spa_imp_kstat != NULL) {
-		sip = kmem_alloc(sizeof (spa_import_progress_t), KM_SLEEP);
+		sip = kmem_zalloc(sizeof (spa_import_progress_t), KM_SLEEP);
 		spa->spa_imp_kstat->ks_data = sip;
 
 		sip->sip_load_state.value.ui64 = (uint64_t)spa_load_state(spa);
@@ -2175,6 +2201,18 @@ spa_import_progress_add(spa_t *spa)
 		    "mmp_sec_remaining", KSTAT_DATA_UINT64);
 		kstat_named_init(&sip->sip_load_max_txg,
 		    "spa_load_max_txg", KSTAT_DATA_UINT64);
+		kstat_named_init(
+		    &sip->sip_phase_ms[SPA_IMPORT_PHASE_VDEV_OPEN],
+		    "vdev_open_ms", KSTAT_DATA_UINT64);
+		kstat_named_init(
+		    &sip->sip_phase_ms[SPA_IMPORT_PHASE_VDEV_VALIDATE],
+		    "vdev_validate_ms", KSTAT_DATA_UINT64);
+		kstat_named_init(
+		    &sip->sip_phase_ms[SPA_IMPORT_PHASE_VDEV_LOAD],
+		    "vdev_load_ms", KSTAT_DATA_UINT64);
+		kstat_named_init(
+		    &sip->sip_phase_ms[SPA_IMPORT_PHASE_LOG_SM],
+		    "log_spacemap_ms", KSTAT_DATA_UINT64);
 		spa->spa_imp_kstat->ks_lock = &spa->spa_imp_kstat_lock;
 		kstat_install(spa->spa_imp_kstat);
 	}
@@ -2260,12 +2298,17 @@ spa_init(int mode)
 	unique_init();
 	zfs_btree_init();
 	metaslab_stat_init();
+	txg_stat_init();
 	zio_init();
 	dmu_init();
+	dsl_pool_stat_init();
 	zil_init();
+	ddt_init();
 	vdev_cache_stat_init();
+	vdev_queue_stat_init();
 	vdev_mirror_stat_init();
 	vdev_raidz_math_init();
+	fletcher_4_init();
 	zfs_prop_init();
 	zpool_prop_init();
 	zpool_feature_init();
@@ -2283,11 +2326,16 @@ spa_fini(void)
 	spa_evict_all();
 
 	vdev_cache_stat_fini();
+	vdev_queue_stat_fini();
 	vdev_mirror_stat_fini();
 	vdev_raidz_math_fini();
+	fletcher_4_fini();
+	ddt_fini();
 	zil_fini();
+	dsl_pool_stat_fini();
 	dmu_fini();
 	zio_fini();
+	txg_stat_fini();
 	metaslab_stat_fini();
 	zfs_btree_fini();
 	unique_fini();
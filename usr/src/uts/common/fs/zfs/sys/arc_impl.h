@@ -174,6 +174,13 @@ typedef struct l1arc_buf_hdr {
 
 	arc_callback_t		*b_acb;
 	abd_t			*b_pabd;
+
+	/*
+	 * LZ4-compressed copy of the data, retained while this header
+	 * sits on a ghost list; see the compressed ghost tier in arc.c.
+	 */
+	abd_t			*b_cghost_abd;
+	uint32_t		b_cghost_psize;
 } l1arc_buf_hdr_t;
 
 typedef enum l2arc_dev_hdr_flags_t {
@@ -538,6 +545,18 @@ typedef struct arc_stats {
 	kstat_named_t arcstat_evict_l2_eligible_mru;
 	kstat_named_t arcstat_evict_l2_ineligible;
 	kstat_named_t arcstat_evict_l2_skip;
+	/*
+	 * Compressed ghost tier: bytes currently retained, buffers
+	 * stashed at eviction, evictions we declined to stash, ghost
+	 * hits serviced from the tier, retained copies freed unused,
+	 * and cumulative time spent rebuilding data on a hit.
+	 */
+	kstat_named_t arcstat_cghost_size;
+	kstat_named_t arcstat_cghost_stashes;
+	kstat_named_t arcstat_cghost_stash_skips;
+	kstat_named_t arcstat_cghost_hits;
+	kstat_named_t arcstat_cghost_frees;
+	kstat_named_t arcstat_cghost_restore_ns;
 	kstat_named_t arcstat_hash_elements;
 	kstat_named_t arcstat_hash_elements_max;
 	kstat_named_t arcstat_hash_collisions;
@@ -773,6 +792,12 @@ typedef struct arc_stats {
 	 * Updated during L2ARC rebuild and during writing of L2ARC log blocks.
 	 */
 	kstat_named_t arcstat_l2_data_to_meta_ratio;
+	/*
+	 * Number of L2ARC device rebuilds currently in progress.  Together
+	 * with the incrementally updated l2_rebuild_size/bufs/log_blks
+	 * counters below, this shows rebuild progress.
+	 */
+	kstat_named_t arcstat_l2_rebuild_inprogress;
 	/*
 	 * Number of times the L2ARC rebuild was successful for an L2ARC device.
 	 */
@@ -305,6 +305,12 @@ typedef struct dmu_buf_impl {
 typedef struct dbuf_hash_table {
 	uint64_t hash_table_mask;
 	dmu_buf_impl_t **hash_table;
+	/*
+	 * Non-NULL only while an online grow is migrating buckets into
+	 * a table of twice the size; see dbuf_hash_table_grow().
+	 */
+	uint64_t hash_table_mask2;
+	dmu_buf_impl_t **hash_table2;
 	kmutex_t hash_mutexes[DBUF_MUTEXES];
 } dbuf_hash_table_t;
 
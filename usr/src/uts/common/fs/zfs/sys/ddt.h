@@ -139,6 +139,8 @@ struct ddt {
 	objset_t	*ddt_os;
 	uint64_t	ddt_stat_object;
 	uint64_t	ddt_object[DDT_TYPES][DDT_CLASSES];
+	uint8_t		*ddt_bloom;	/* presence filter over disk entries */
+	uint64_t	ddt_bloom_mask;	/* filter size in bits, minus one */
 	ddt_histogram_t	ddt_histogram[DDT_TYPES][DDT_CLASSES];
 	ddt_histogram_t	ddt_histogram_cache[DDT_TYPES][DDT_CLASSES];
 	ddt_object_t	ddt_object_stats[DDT_TYPES][DDT_CLASSES];
@@ -238,6 +240,8 @@ extern void ddt_repair_done(ddt_t *ddt, ddt_entry_t *dde);
 
 extern int ddt_entry_compare(const void *x1, const void *x2);
 
+extern void ddt_init(void);
+extern void ddt_fini(void);
 extern void ddt_create(spa_t *spa);
 extern int ddt_load(spa_t *spa);
 extern void ddt_unload(spa_t *spa);
@@ -156,6 +156,14 @@ struct objset {
 	/* os_phys_buf should be written raw next txg */
 	boolean_t os_next_write_raw[TXG_SIZE];
 
+	/*
+	 * This objset's share of the pool's dirty data, maintained
+	 * alongside dp_dirty_pertxg/dp_dirty_total and protected by
+	 * dp_lock; used by the fair-share write throttle in dmu_tx.c.
+	 */
+	uint64_t os_dirty_pertxg[TXG_SIZE];
+	uint64_t os_dirty_total;
+
 	/* Protected by os_obj_lock */
 	kmutex_t os_obj_lock;
 	uint64_t os_obj_next_chunk;
@@ -164,6 +172,15 @@ struct objset {
 	uint64_t *os_obj_next_percpu;
 	int os_obj_next_percpu_len;
 
+	/*
+	 * Sequential-object prefetch state, protected by os_seqobj_lock;
+	 * see dmu_zfetch_seqobj().
+	 */
+	kmutex_t os_seqobj_lock;
+	uint64_t os_seqobj_last;
+	uint64_t os_seqobj_pfed;
+	uint_t os_seqobj_run;
+
 	/* Protected by os_lock */
 	kmutex_t os_lock;
 	multilist_t *os_dirty_dnodes[TXG_SIZE];
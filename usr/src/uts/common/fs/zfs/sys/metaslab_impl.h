@@ -276,6 +276,8 @@ struct metaslab_group {
 
 	uint64_t		mg_allocations;
 	uint64_t		mg_failed_allocations;
+	uint64_t		mg_allocated_bytes;	/* since last reassess */
+	uint64_t		mg_alloc_rate;		/* decayed bytes/txg */
 	uint64_t		mg_fragmentation;
 	uint64_t		mg_histogram[RANGE_TREE_HISTOGRAM_SIZE];
 
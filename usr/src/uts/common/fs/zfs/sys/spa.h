@@ -904,9 +904,23 @@ typedef struct spa_iostats {
 	kstat_named_t	autotrim_bytes_failed;
 } spa_iostats_t;
 
+/*
+ * Import/load phases whose durations are tracked in the per-pool
+ * import progress kstat.
+ */
+typedef enum spa_import_phase {
+	SPA_IMPORT_PHASE_VDEV_OPEN = 0,
+	SPA_IMPORT_PHASE_VDEV_VALIDATE,
+	SPA_IMPORT_PHASE_VDEV_LOAD,
+	SPA_IMPORT_PHASE_LOG_SM,
+	SPA_IMPORT_PHASE_COUNT
+} spa_import_phase_t;
+
 extern int spa_import_progress_set_state(spa_t *, spa_load_state_t);
 extern int spa_import_progress_set_max_txg(spa_t *, uint64_t);
 extern int spa_import_progress_set_mmp_check(spa_t *, uint64_t);
+extern int spa_import_progress_set_phase_ms(spa_t *, spa_import_phase_t,
+    uint64_t);
 extern void spa_import_progress_add(spa_t *);
 extern void spa_import_progress_remove(spa_t *);
 
@@ -1082,6 +1096,10 @@ extern void spa_get_errlists(spa_t *spa, avl_tree_t *last, avl_tree_t *scrub);
 extern void vdev_cache_stat_init(void);
 extern void vdev_cache_stat_fini(void);
 
+/* vdev queue */
+extern void vdev_queue_stat_init(void);
+extern void vdev_queue_stat_fini(void);
+
 /* vdev mirror */
 extern void vdev_mirror_stat_init(void);
 extern void vdev_mirror_stat_fini(void);
@@ -175,9 +175,20 @@ typedef enum spa_proc_state {
 	SPA_PROC_GONE		/* spa_thread() is exiting, spa_proc = &p0 */
 } spa_proc_state_t;
 
+/*
+ * Per-CPU batching of zio taskq dispatches; see zio_taskq_dispatch().
+ */
+typedef struct zio_dispatch_batch {
+	struct zio *zdb_list;	/* lock-free stack of pending zios */
+	uint32_t zdb_scheduled;	/* drain task dispatched or running */
+	taskq_ent_t zdb_tqent;	/* taskq entry for the drain task */
+	uint64_t zdb_pad[4];	/* reduce false sharing between CPUs */
+} zio_dispatch_batch_t;
+
 typedef struct spa_taskqs {
 	uint_t stqs_count;
 	taskq_t **stqs_taskq;
+	zio_dispatch_batch_t *stqs_batch; /* max_ncpus entries, or NULL */
 } spa_taskqs_t;
 
 typedef enum spa_all_vdev_zap_action {
@@ -68,6 +68,8 @@ struct dsl_pool;
 
 extern void txg_init(struct dsl_pool *dp, uint64_t txg);
 extern void txg_fini(struct dsl_pool *dp);
+extern void txg_stat_init(void);
+extern void txg_stat_fini(void);
 extern void txg_sync_start(struct dsl_pool *dp);
 extern void txg_sync_stop(struct dsl_pool *dp);
 extern uint64_t txg_hold_open(struct dsl_pool *dp, txg_handle_t *txghp);
@@ -141,6 +141,12 @@ typedef struct vdev_queue_class {
 	 * LBA-ordered vs FIFO.
 	 */
 	avl_tree_t	vqc_queued_tree;
+
+	/*
+	 * Queued i/os in arrival order, so deadline scheduling can find
+	 * the oldest i/o in the class regardless of the tree's sort order.
+	 */
+	list_t		vqc_queued_list;
 } vdev_queue_class_t;
 
 struct vdev_queue {
@@ -234,6 +240,7 @@ struct vdev {
 	boolean_t	vdev_reopening;	/* reopen in progress?		*/
 	boolean_t	vdev_nonrot;	/* true if solid state		*/
 	int		vdev_open_error; /* error on last open		*/
+	int		vdev_validate_error; /* error on last validate	*/
 	kthread_t	*vdev_open_thread; /* thread opening children	*/
 	uint64_t	vdev_crtxg;	/* txg when top-level was added */
 
@@ -142,6 +142,9 @@ extern const raidz_impl_ops_t vdev_raidz_ssse3_impl;
 #if defined(__x86)
 extern const raidz_impl_ops_t vdev_raidz_avx2_impl;
 #endif
+#if defined(__x86)
+extern const raidz_impl_ops_t vdev_raidz_avx512bw_impl;
+#endif
 
 /*
  * Commonly used raidz_map helpers
@@ -384,6 +384,18 @@ void zap_cursor_fini(zap_cursor_t *zc);
  */
 int zap_cursor_retrieve(zap_cursor_t *zc, zap_attribute_t *za);
 
+/*
+ * Get up to nza attributes starting at the cursor, advancing the cursor
+ * past those returned; *nretp is set to the number retrieved.  If cookies
+ * is non-NULL, cookies[i] is set to the serialized cursor positioned just
+ * past za[i], allowing iteration to be resumed after any entry.  Returns
+ * ENOENT (with *nretp == 0) if at the end of the attributes.  This
+ * amortizes the per-call locking and leaf block lookups over whole leaf
+ * blocks of entries, and issues readahead for the upcoming leaf blocks.
+ */
+int zap_cursor_retrieve_batch(zap_cursor_t *zc, zap_attribute_t *za,
+    uint64_t *cookies, int nza, int *nretp);
+
 /*
  * Advance the cursor to the next attribute.
  */
@@ -226,6 +226,8 @@ int fzap_length(zap_name_t *zn,
     uint64_t *integer_size, uint64_t *num_integers);
 int fzap_remove(zap_name_t *zn, dmu_tx_t *tx);
 int fzap_cursor_retrieve(zap_t *zap, zap_cursor_t *zc, zap_attribute_t *za);
+int fzap_cursor_retrieve_batch(zap_t *zap, zap_cursor_t *zc,
+    zap_attribute_t *za, uint64_t *cookies, int nza, int *nretp);
 void fzap_get_stats(zap_t *zap, zap_stats_t *zs);
 void zap_put_leaf(struct zap_leaf *l);
 
@@ -201,6 +201,8 @@ typedef struct znode {
 	uint64_t	z_gen;		/* generation (cached) */
 	uint64_t	z_size;		/* file size (cached) */
 	uint64_t	z_atime[2];	/* atime (cached) */
+	uint64_t	z_mtime[2];	/* mtime (cached) */
+	uint64_t	z_ctime[2];	/* ctime (cached) */
 	uint64_t	z_links;	/* file links (cached) */
 	uint64_t	z_pflags;	/* pflags (cached) */
 	uint64_t	z_uid;		/* uid fuid (cached) */
@@ -141,10 +141,28 @@ typedef struct itxs {
 	avl_tree_t	i_async_tree;	/* tree of foids for async itxs */
 } itxs_t;
 
+/*
+ * Per-CPU staging for synchronous itxs.  zil_itx_assign() normally
+ * appends sync itxs to a staging list selected by CPU id, taking only
+ * that stage's lock, so concurrent committing threads stop serializing
+ * on the itxg_lock.  Each itx is stamped with a per-itxg sequence
+ * number when it is assigned, and the issuer merges the stages back
+ * into assignment order before moving them to the commit list; see
+ * zil_itxg_stage_drain().
+ */
+#define	ZIL_ITX_NSTAGES	8
+
+typedef struct itx_stage {
+	kmutex_t	is_lock;	/* protects is_list */
+	list_t		is_list;	/* staged sync itxs */
+} itx_stage_t;
+
 typedef struct itxg {
 	kmutex_t	itxg_lock;	/* lock for this structure */
 	uint64_t	itxg_txg;	/* txg for this chain */
 	itxs_t		*itxg_itxs;	/* sync and async itxs */
+	itx_stage_t	itxg_stage[ZIL_ITX_NSTAGES]; /* per-CPU sync staging */
+	uint64_t	itxg_seq;	/* itx assignment sequence */
 } itxg_t;
 
 /* for async nodes we build up an AVL tree of lists of async itxs per file */
@@ -260,6 +260,7 @@ enum zio_wait_type {
 typedef void zio_done_func_t(zio_t *zio);
 
 extern boolean_t zio_dva_throttle_enabled;
+extern int zio_batch_interrupts;
 extern const char *zio_type_name[ZIO_TYPES];
 
 /*
@@ -470,6 +471,8 @@ struct zio {
 					/* file). */
 	avl_node_t	io_queue_node;
 	avl_node_t	io_offset_node;
+	list_node_t	io_deadline_node; /* vdev queue arrival-order list */
+	hrtime_t	io_deadline;	/* target completion time */
 	avl_node_t	io_alloc_node;
 	zio_alloc_list_t	io_alloc_list;
 
@@ -502,6 +505,7 @@ struct zio {
 
 	/* Taskq dispatching state */
 	taskq_ent_t	io_tqent;
+	zio_t		*io_batch_next;	/* pending dispatch batch linkage */
 };
 
 extern int zio_bookmark_compare(const void *, const void *);
@@ -27,6 +27,7 @@
 #define	_SYS_ZVOL_H
 
 #include <sys/zfs_context.h>
+#include <sys/zfs_rlock.h>
 
 #ifdef	__cplusplus
 extern "C" {
@@ -67,6 +68,16 @@ extern int zvol_get_volume_wce(void *minor_hdl);
 extern void zvol_log_write_minor(void *minor_hdl, dmu_tx_t *tx, offset_t off,
     ssize_t resid, boolean_t sync);
 
+/*
+ * The zvol range lock is sharded by offset; callers lock ranges through
+ * these wrappers rather than calling rangelock_enter() on the exported
+ * handle directly.
+ */
+typedef struct zvol_locked_range zvol_locked_range_t;
+extern zvol_locked_range_t *zvol_rangelock_enter(void *rl_hdl, uint64_t off,
+    uint64_t len, rangelock_type_t type);
+extern void zvol_rangelock_exit(zvol_locked_range_t *zlr);
+
 #endif
 
 #ifdef	__cplusplus
@@ -111,6 +111,69 @@ static void txg_quiesce_thread(void *arg);
 
 int zfs_txg_timeout = 5;	/* max seconds worth of delta per txg */
 
+/*
+ * If set, the sync thread starts quiescing the next open txg as soon as it
+ * begins syncing the current one (when there is enough dirty data
+ * outstanding to warrant another sync, or a caller is waiting on a later
+ * txg), rather than only once it goes looking for more work.  This overlaps
+ * the next txg's quiesce with the current txg's sync, so that a long sync
+ * pass is not followed by a full quiesce wait before the next txg can sync.
+ */
+boolean_t zfs_txg_overlap_quiesce = B_TRUE;
+
+/*
+ * Cumulative statistics on the txg pipeline phases, exposed as the
+ * "txg_stats" kstat.  The handoff wait is time the sync thread spent idle
+ * waiting for a txg to finish quiescing; quiesced_ready counts syncs for
+ * which a quiesced txg was already waiting (i.e. the quiesce was fully
+ * overlapped with the previous sync).
+ */
+typedef struct txg_stats {
+	kstat_named_t txgs_synced;
+	kstat_named_t txgs_quiesce_time_ns;
+	kstat_named_t txgs_sync_time_ns;
+	kstat_named_t txgs_handoff_wait_ns;
+	kstat_named_t txgs_quiesced_ready;
+	kstat_named_t txgs_overlap_kicks;
+} txg_stats_t;
+
+static txg_stats_t txg_stats = {
+	{ "synced",		KSTAT_DATA_UINT64 },
+	{ "quiesce_time_ns",	KSTAT_DATA_UINT64 },
+	{ "sync_time_ns",	KSTAT_DATA_UINT64 },
+	{ "handoff_wait_ns",	KSTAT_DATA_UINT64 },
+	{ "quiesced_ready",	KSTAT_DATA_UINT64 },
+	{ "overlap_kicks",	KSTAT_DATA_UINT64 },
+};
+
+#define	TXGSTAT_BUMP(stat)	atomic_inc_64(&txg_stats.stat.value.ui64)
+#define	TXGSTAT_INCR(stat, val) \
+	atomic_add_64(&txg_stats.stat.value.ui64, (val))
+
+static kstat_t *txg_ksp;
+
+void
+txg_stat_init(void)
+{
+	txg_ksp = kstat_create("zfs", 0, "txg_stats", "misc",
+	    KSTAT_TYPE_NAMED, sizeof (txg_stats) / sizeof (kstat_named_t),
+	    KSTAT_FLAG_VIRTUAL);
+
+	if (txg_ksp != NULL) {
+		txg_ksp->ks_data = &txg_stats;
+		kstat_install(txg_ksp);
+	}
+}
+
+void
+txg_stat_fini(void)
+{
+	if (txg_ksp != NULL) {
+		kstat_delete(txg_ksp);
+		txg_ksp = NULL;
+	}
+}
+
 /*
  * Prepare the txg subsystem.
  */
@@ -484,6 +547,7 @@ txg_sync_thread(void *arg)
 		uint64_t timeout = zfs_txg_timeout * hz;
 		uint64_t timer;
 		uint64_t txg;
+		hrtime_t sync_start;
 		uint64_t dirty_min_bytes =
 		    zfs_dirty_data_max * zfs_dirty_data_sync_pct / 100;
 
@@ -509,11 +573,24 @@ txg_sync_thread(void *arg)
 		 * Wait until the quiesce thread hands off a txg to us,
 		 * prompting it to do so if necessary.
 		 */
-		while (!tx->tx_exiting && !txg_has_quiesced_to_sync(dp)) {
-			if (tx->tx_quiesce_txg_waiting < tx->tx_open_txg+1)
-				tx->tx_quiesce_txg_waiting = tx->tx_open_txg+1;
-			cv_broadcast(&tx->tx_quiesce_more_cv);
-			txg_thread_wait(tx, &cpr, &tx->tx_quiesce_done_cv, 0);
+		if (txg_has_quiesced_to_sync(dp)) {
+			TXGSTAT_BUMP(txgs_quiesced_ready);
+		} else {
+			hrtime_t wait_start = gethrtime();
+
+			while (!tx->tx_exiting &&
+			    !txg_has_quiesced_to_sync(dp)) {
+				if (tx->tx_quiesce_txg_waiting <
+				    tx->tx_open_txg+1) {
+					tx->tx_quiesce_txg_waiting =
+					    tx->tx_open_txg+1;
+				}
+				cv_broadcast(&tx->tx_quiesce_more_cv);
+				txg_thread_wait(tx, &cpr,
+				    &tx->tx_quiesce_done_cv, 0);
+			}
+			TXGSTAT_INCR(txgs_handoff_wait_ns,
+			    gethrtime() - wait_start);
 		}
 
 		if (tx->tx_exiting)
@@ -529,6 +606,21 @@ txg_sync_thread(void *arg)
 		tx->tx_quiesced_txg = 0;
 		tx->tx_syncing_txg = txg;
 		DTRACE_PROBE2(txg__syncing, dsl_pool_t *, dp, uint64_t, txg);
+
+		/*
+		 * If there is already enough dirty data to warrant another
+		 * sync, or someone is waiting on a later txg, ask the
+		 * quiesce thread to start quiescing the next txg now, so
+		 * that its quiesce overlaps our sync and it is ready to
+		 * hand off as soon as we finish.
+		 */
+		if (zfs_txg_overlap_quiesce &&
+		    tx->tx_quiesce_txg_waiting < tx->tx_open_txg+1 &&
+		    (dp->dp_dirty_total >= dirty_min_bytes ||
+		    tx->tx_sync_txg_waiting > txg)) {
+			tx->tx_quiesce_txg_waiting = tx->tx_open_txg+1;
+			TXGSTAT_BUMP(txgs_overlap_kicks);
+		}
 		cv_broadcast(&tx->tx_quiesce_more_cv);
 
 		dprintf("txg=%llu quiesce_txg=%llu sync_txg=%llu\n",
@@ -536,7 +628,10 @@ txg_sync_thread(void *arg)
 		mutex_exit(&tx->tx_sync_lock);
 
 		start = ddi_get_lbolt();
+		sync_start = gethrtime();
 		spa_sync(spa, txg);
+		TXGSTAT_INCR(txgs_sync_time_ns, gethrtime() - sync_start);
+		TXGSTAT_BUMP(txgs_synced);
 		delta = ddi_get_lbolt() - start;
 
 		mutex_enter(&tx->tx_sync_lock);
@@ -563,6 +658,7 @@ txg_quiesce_thread(void *arg)
 
 	for (;;) {
 		uint64_t txg;
+		hrtime_t quiesce_start;
 
 		/*
 		 * We quiesce when there's someone waiting on us.
@@ -586,7 +682,10 @@ txg_quiesce_thread(void *arg)
 		tx->tx_quiescing_txg = txg;
 
 		mutex_exit(&tx->tx_sync_lock);
+		quiesce_start = gethrtime();
 		txg_quiesce(dp, txg);
+		TXGSTAT_INCR(txgs_quiesce_time_ns,
+		    gethrtime() - quiesce_start);
 		mutex_enter(&tx->tx_sync_lock);
 
 		/*
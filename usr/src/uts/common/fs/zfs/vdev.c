@@ -1782,6 +1782,14 @@ vdev_open(vdev_t *vd)
 	return (0);
 }
 
+static void
+vdev_validate_child(void *arg)
+{
+	vdev_t *vd = arg;
+
+	vd->vdev_validate_error = vdev_validate(vd);
+}
+
 /*
  * Called once the vdevs are all opened, this routine validates the label
  * contents. This needs to be done before vdev_load() so that we don't
@@ -1805,10 +1813,42 @@ vdev_validate(vdev_t *vd)
 	if (vdev_validate_skip)
 		return (0);
 
+	/*
+	 * Validate the children of the root vdev in parallel: reading
+	 * the labels of several hundred top-level vdevs one at a time
+	 * dominates import time on large pools.  Interior vdevs deeper
+	 * in the tree have only a handful of children each and are
+	 * validated in place by their top-level vdev's task.
+	 */
+	if (vd == spa->spa_root_vdev && vd->vdev_children > 1 &&
+	    !vdev_uses_zvols(vd)) {
+		int children = vd->vdev_children;
+		taskq_t *tq = taskq_create("vdev_validate", children,
+		    minclsyspri, children, children, TASKQ_PREPOPULATE);
+
+		if (tq != NULL) {
+			for (int c = 0; c < children; c++) {
+				VERIFY(taskq_dispatch(tq, vdev_validate_child,
+				    vd->vdev_child[c], TQ_SLEEP) !=
+				    TASKQID_INVALID);
+			}
+			taskq_destroy(tq);
+
+			for (int c = 0; c < children; c++) {
+				if (vd->vdev_child[c]->vdev_validate_error !=
+				    0)
+					return (SET_ERROR(EBADF));
+			}
+			goto children_validated;
+		}
+	}
+
 	for (uint64_t c = 0; c < vd->vdev_children; c++)
 		if (vdev_validate(vd->vdev_child[c]) != 0)
 			return (SET_ERROR(EBADF));
 
+children_validated:
+
 	/*
 	 * If the device has already failed, or was marked offline, don't do
 	 * any further validation.  Otherwise, label I/O will fail and we will
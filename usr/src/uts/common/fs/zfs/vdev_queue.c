@@ -156,6 +156,27 @@ uint32_t zfs_vdev_initializing_max_active = 1;
 uint32_t zfs_vdev_trim_min_active = 1;
 uint32_t zfs_vdev_trim_max_active = 2;
 
+/*
+ * Deadline scheduling mode.  When zfs_vdev_deadline_enabled is set, each
+ * queued i/o is assigned a target completion time of its arrival time plus
+ * its class's deadline below.  Once every class with queued i/os has its
+ * min_active floor in flight, the queue issues from the class whose oldest
+ * queued i/o has the earliest target completion time, rather than in strict
+ * class-priority order.  Synchronous i/o still goes first in the common case
+ * because its deadlines are much shorter, but a scrub or removal i/o that
+ * has waited out its deadline can no longer be starved indefinitely by a
+ * steady stream of higher-class i/os.
+ */
+int zfs_vdev_deadline_enabled = 0;
+uint32_t zfs_vdev_sync_read_deadline_ms = 10;
+uint32_t zfs_vdev_sync_write_deadline_ms = 10;
+uint32_t zfs_vdev_async_read_deadline_ms = 50;
+uint32_t zfs_vdev_async_write_deadline_ms = 200;
+uint32_t zfs_vdev_scrub_deadline_ms = 2000;
+uint32_t zfs_vdev_removal_deadline_ms = 1000;
+uint32_t zfs_vdev_initializing_deadline_ms = 2000;
+uint32_t zfs_vdev_trim_deadline_ms = 1000;
+
 /*
  * When the pool has less than zfs_vdev_async_write_active_min_dirty_percent
  * dirty data, use zfs_vdev_async_write_min_active.  When it has more than
@@ -208,6 +229,82 @@ int zfs_vdev_def_queue_depth = 32;
  */
 int zfs_vdev_aggregate_trim = 0;
 
+/*
+ * Per-class queue latency histograms (time from vdev queue entry to i/o
+ * completion), exposed in the vdev_queue_stats kstat alongside a bucket
+ * per decade of latency.
+ */
+static hrtime_t vdev_queue_class_deadline(zio_priority_t p);
+
+#define	VDEV_QUEUE_LAT_BUCKETS	5
+
+static const char *vdev_queue_class_names[ZIO_PRIORITY_NUM_QUEUEABLE] = {
+	"sync_read", "sync_write", "async_read", "async_write",
+	"scrub", "removal", "initializing", "trim"
+};
+
+static const char *vdev_queue_lat_bucket_names[VDEV_QUEUE_LAT_BUCKETS] = {
+	"le_1ms", "le_10ms", "le_100ms", "le_1s", "gt_1s"
+};
+
+static kstat_named_t
+    vdev_queue_lat_stats[ZIO_PRIORITY_NUM_QUEUEABLE][VDEV_QUEUE_LAT_BUCKETS];
+static kstat_t *vdev_queue_ksp;
+
+static void
+vdev_queue_lat_update(zio_priority_t p, hrtime_t delta)
+{
+	int b;
+
+	if (vdev_queue_ksp == NULL || p >= ZIO_PRIORITY_NUM_QUEUEABLE)
+		return;
+
+	if (delta <= MSEC2NSEC(1))
+		b = 0;
+	else if (delta <= MSEC2NSEC(10))
+		b = 1;
+	else if (delta <= MSEC2NSEC(100))
+		b = 2;
+	else if (delta <= SEC2NSEC(1))
+		b = 3;
+	else
+		b = 4;
+	atomic_inc_64(&vdev_queue_lat_stats[p][b].value.ui64);
+}
+
+void
+vdev_queue_stat_init(void)
+{
+	vdev_queue_ksp = kstat_create("zfs", 0, "vdev_queue_stats", "misc",
+	    KSTAT_TYPE_NAMED, sizeof (vdev_queue_lat_stats) /
+	    sizeof (kstat_named_t), KSTAT_FLAG_VIRTUAL);
+
+	if (vdev_queue_ksp != NULL) {
+		for (int p = 0; p < ZIO_PRIORITY_NUM_QUEUEABLE; p++) {
+			for (int b = 0; b < VDEV_QUEUE_LAT_BUCKETS; b++) {
+				char name[KSTAT_STRLEN];
+
+				(void) snprintf(name, sizeof (name), "%s_%s",
+				    vdev_queue_class_names[p],
+				    vdev_queue_lat_bucket_names[b]);
+				kstat_named_init(&vdev_queue_lat_stats[p][b],
+				    name, KSTAT_DATA_UINT64);
+			}
+		}
+		vdev_queue_ksp->ks_data = vdev_queue_lat_stats;
+		kstat_install(vdev_queue_ksp);
+	}
+}
+
+void
+vdev_queue_stat_fini(void)
+{
+	if (vdev_queue_ksp != NULL) {
+		kstat_delete(vdev_queue_ksp);
+		vdev_queue_ksp = NULL;
+	}
+}
+
 int
 vdev_queue_offset_compare(const void *x1, const void *x2)
 {
@@ -292,6 +389,8 @@ vdev_queue_init(vdev_t *vd)
 
 		avl_create(vdev_queue_class_tree(vq, p), compfn,
 		    sizeof (zio_t), offsetof(struct zio, io_queue_node));
+		list_create(&vq->vq_class[p].vqc_queued_list,
+		    sizeof (zio_t), offsetof(struct zio, io_deadline_node));
 	}
 
 	vq->vq_last_offset = 0;
@@ -302,8 +401,10 @@ vdev_queue_fini(vdev_t *vd)
 {
 	vdev_queue_t *vq = &vd->vdev_queue;
 
-	for (zio_priority_t p = 0; p < ZIO_PRIORITY_NUM_QUEUEABLE; p++)
+	for (zio_priority_t p = 0; p < ZIO_PRIORITY_NUM_QUEUEABLE; p++) {
 		avl_destroy(vdev_queue_class_tree(vq, p));
+		list_destroy(&vq->vq_class[p].vqc_queued_list);
+	}
 	avl_destroy(&vq->vq_active_tree);
 	avl_destroy(vdev_queue_type_tree(vq, ZIO_TYPE_READ));
 	avl_destroy(vdev_queue_type_tree(vq, ZIO_TYPE_WRITE));
@@ -318,8 +419,11 @@ vdev_queue_io_add(vdev_queue_t *vq, zio_t *zio)
 	spa_t *spa = zio->io_spa;
 
 	ASSERT3U(zio->io_priority, <, ZIO_PRIORITY_NUM_QUEUEABLE);
+	zio->io_deadline = zio->io_timestamp +
+	    vdev_queue_class_deadline(zio->io_priority);
 	avl_add(vdev_queue_class_tree(vq, zio->io_priority), zio);
 	avl_add(vdev_queue_type_tree(vq, zio->io_type), zio);
+	list_insert_tail(&vq->vq_class[zio->io_priority].vqc_queued_list, zio);
 
 	mutex_enter(&spa->spa_iokstat_lock);
 	spa->spa_queue_stats[zio->io_priority].spa_queued++;
@@ -336,6 +440,7 @@ vdev_queue_io_remove(vdev_queue_t *vq, zio_t *zio)
 	ASSERT3U(zio->io_priority, <, ZIO_PRIORITY_NUM_QUEUEABLE);
 	avl_remove(vdev_queue_class_tree(vq, zio->io_priority), zio);
 	avl_remove(vdev_queue_type_tree(vq, zio->io_type), zio);
+	list_remove(&vq->vq_class[zio->io_priority].vqc_queued_list, zio);
 
 	mutex_enter(&spa->spa_iokstat_lock);
 	ASSERT3U(spa->spa_queue_stats[zio->io_priority].spa_queued, >, 0);
@@ -428,6 +533,31 @@ vdev_queue_class_min_active(zio_priority_t p)
 	}
 }
 
+static hrtime_t
+vdev_queue_class_deadline(zio_priority_t p)
+{
+	switch (p) {
+	case ZIO_PRIORITY_SYNC_READ:
+		return (MSEC2NSEC(zfs_vdev_sync_read_deadline_ms));
+	case ZIO_PRIORITY_SYNC_WRITE:
+		return (MSEC2NSEC(zfs_vdev_sync_write_deadline_ms));
+	case ZIO_PRIORITY_ASYNC_READ:
+		return (MSEC2NSEC(zfs_vdev_async_read_deadline_ms));
+	case ZIO_PRIORITY_ASYNC_WRITE:
+		return (MSEC2NSEC(zfs_vdev_async_write_deadline_ms));
+	case ZIO_PRIORITY_SCRUB:
+		return (MSEC2NSEC(zfs_vdev_scrub_deadline_ms));
+	case ZIO_PRIORITY_REMOVAL:
+		return (MSEC2NSEC(zfs_vdev_removal_deadline_ms));
+	case ZIO_PRIORITY_INITIALIZING:
+		return (MSEC2NSEC(zfs_vdev_initializing_deadline_ms));
+	case ZIO_PRIORITY_TRIM:
+		return (MSEC2NSEC(zfs_vdev_trim_deadline_ms));
+	default:
+		panic("invalid priority %u", p);
+	}
+}
+
 static int
 vdev_queue_max_async_writes(spa_t *spa)
 {
@@ -515,17 +645,34 @@ vdev_queue_class_to_issue(vdev_queue_t *vq)
 
 	/*
 	 * If we haven't found a queue, look for one that hasn't reached its
-	 * maximum # outstanding i/os.
+	 * maximum # outstanding i/os.  In deadline mode, choose among the
+	 * eligible classes the one whose oldest queued i/o has the earliest
+	 * target completion time; otherwise take them in class-priority
+	 * order.
 	 */
+	zio_priority_t best = ZIO_PRIORITY_NUM_QUEUEABLE;
+	hrtime_t best_deadline = 0;
 	for (p = 0; p < ZIO_PRIORITY_NUM_QUEUEABLE; p++) {
 		if (avl_numnodes(vdev_queue_class_tree(vq, p)) > 0 &&
 		    vq->vq_class[p].vqc_active <
-		    vdev_queue_class_max_active(spa, p))
-			return (p);
+		    vdev_queue_class_max_active(spa, p)) {
+			zio_t *fio;
+
+			if (!zfs_vdev_deadline_enabled)
+				return (p);
+
+			fio = list_head(&vq->vq_class[p].vqc_queued_list);
+			ASSERT3P(fio, !=, NULL);
+			if (best == ZIO_PRIORITY_NUM_QUEUEABLE ||
+			    fio->io_deadline < best_deadline) {
+				best = p;
+				best_deadline = fio->io_deadline;
+			}
+		}
 	}
 
-	/* No eligible queued i/os */
-	return (ZIO_PRIORITY_NUM_QUEUEABLE);
+	/* ZIO_PRIORITY_NUM_QUEUEABLE here means no eligible queued i/os */
+	return (best);
 }
 
 /*
@@ -831,6 +978,7 @@ vdev_queue_io_done(zio_t *zio)
 
 	zio->io_delta = gethrtime() - zio->io_timestamp;
 	vq->vq_io_complete_ts = gethrtime();
+	vdev_queue_lat_update(zio->io_priority, zio->io_delta);
 
 	while ((nio = vdev_queue_io_to_issue(vq)) != NULL) {
 		mutex_exit(&vq->vq_lock);
@@ -891,8 +1039,20 @@ vdev_queue_change_io_priority(zio_t *zio, zio_priority_t priority)
 		zio_priority_t oldpri = zio->io_priority;
 
 		avl_remove(vdev_queue_class_tree(vq, zio->io_priority), zio);
+		list_remove(&vq->vq_class[zio->io_priority].vqc_queued_list,
+		    zio);
 		zio->io_priority = priority;
+		zio->io_deadline = zio->io_timestamp +
+		    vdev_queue_class_deadline(priority);
 		avl_add(vdev_queue_class_tree(vq, zio->io_priority), zio);
+		/*
+		 * The reprioritized i/o goes to the tail of the new class's
+		 * arrival list even though its timestamp may predate the
+		 * entries ahead of it; priority changes are rare enough
+		 * that the approximation doesn't matter.
+		 */
+		list_insert_tail(&vq->vq_class[zio->io_priority].vqc_queued_list,
+		    zio);
 
 		mutex_enter(&spa->spa_iokstat_lock);
 		ASSERT3U(spa->spa_queue_stats[oldpri].spa_queued, >, 0);
@@ -79,6 +79,16 @@
  */
 boolean_t zap_iterate_prefetch = B_TRUE;
 
+/*
+ * Number of upcoming leaf blocks to prefetch when a batched iteration
+ * (zap_cursor_retrieve_batch()) moves to a new leaf.  This keeps reads
+ * ahead of the consumer when the iteration did not start at the beginning
+ * of the object (e.g. a large readdir resumed from a serialized cursor),
+ * where the whole-object prefetch above does not apply.  Looking up the
+ * upcoming leaves also pulls in their pointer-table blocks.
+ */
+int zap_iterate_readahead = 16;
+
 int fzap_default_block_shift = 14; /* 16k blocksize */
 
 extern inline zap_phys_t *zap_f_phys(zap_t *zap);
@@ -1189,6 +1199,30 @@ zap_increment_int(objset_t *os, uint64_t obj, uint64_t key, int64_t delta,
  * Routines for iterating over the attributes.
  */
 
+/*
+ * Copy the entry at zeh into the caller's zap_attribute_t.
+ */
+static void
+fzap_cursor_fill(zap_t *zap, zap_entry_handle_t *zeh, zap_attribute_t *za)
+{
+	int err;
+
+	za->za_integer_length = zeh->zeh_integer_size;
+	za->za_num_integers = zeh->zeh_num_integers;
+	if (zeh->zeh_num_integers == 0) {
+		za->za_first_integer = 0;
+	} else {
+		err = zap_entry_read(zeh, 8, 1, &za->za_first_integer);
+		ASSERT(err == 0 || err == EOVERFLOW);
+	}
+	err = zap_entry_read_name(zap, zeh,
+	    sizeof (za->za_name), za->za_name);
+	ASSERT(err == 0);
+
+	za->za_normalization_conflict =
+	    zap_entry_normalization_conflict(zeh, NULL, za->za_name, zap);
+}
+
 int
 fzap_cursor_retrieve(zap_t *zap, zap_cursor_t *zc, zap_attribute_t *za)
 {
@@ -1253,23 +1287,127 @@ again:
 	if (err == 0) {
 		zc->zc_hash = zeh.zeh_hash;
 		zc->zc_cd = zeh.zeh_cd;
-		za->za_integer_length = zeh.zeh_integer_size;
-		za->za_num_integers = zeh.zeh_num_integers;
-		if (zeh.zeh_num_integers == 0) {
-			za->za_first_integer = 0;
-		} else {
-			err = zap_entry_read(&zeh, 8, 1, &za->za_first_integer);
-			ASSERT(err == 0 || err == EOVERFLOW);
+		fzap_cursor_fill(zap, &zeh, za);
+	}
+	rw_exit(&zc->zc_leaf->l_rwlock);
+	return (err);
+}
+
+/*
+ * Prefetch the leaf blocks that the iteration will visit next, starting
+ * from the leaf containing the given hash.  Translating the upcoming
+ * pointer-table indices also faults in the relevant ptrtbl blocks.
+ */
+static void
+fzap_cursor_readahead(zap_t *zap, uint64_t hash)
+{
+	uint64_t shift = zap_f_phys(zap)->zap_ptrtbl.zt_shift;
+	uint64_t idx = ZAP_HASH_IDX(hash, shift);
+	uint64_t lastblk = 0;
+	int bs = FZAP_BLOCK_SHIFT(zap);
+	int nblks = 0;
+
+	for (uint64_t i = idx;
+	    i < (1ULL << shift) && nblks < zap_iterate_readahead; i++) {
+		uint64_t blk;
+
+		if (zap_idx_to_blk(zap, i, &blk) != 0)
+			return;
+		if (blk == lastblk)
+			continue;
+		lastblk = blk;
+		dmu_prefetch(zap->zap_objset, zap->zap_object, 0,
+		    blk << bs, 1 << bs, ZIO_PRIORITY_ASYNC_READ);
+		nblks++;
+	}
+}
+
+/*
+ * Batched form of fzap_cursor_retrieve(): retrieve up to nza entries,
+ * holding each leaf locked while all of its entries are copied out rather
+ * than rederefing it once per entry.  See zap_cursor_retrieve_batch() for
+ * the cursor and cookie semantics.
+ */
+int
+fzap_cursor_retrieve_batch(zap_t *zap, zap_cursor_t *zc, zap_attribute_t *za,
+    uint64_t *cookies, int nza, int *nretp)
+{
+	int err = 0;
+	int nret = 0;
+	boolean_t leaf_locked = B_FALSE;
+	zap_entry_handle_t zeh;
+
+	/*
+	 * As in fzap_cursor_retrieve(), prefetch the entire object when
+	 * the iteration starts at the beginning.
+	 */
+	if (zc->zc_hash == 0 && zap_iterate_prefetch &&
+	    zc->zc_prefetch && zap_f_phys(zap)->zap_freeblk > 2) {
+		dmu_prefetch(zc->zc_objset, zc->zc_zapobj, 0, 0,
+		    zap_f_phys(zap)->zap_freeblk << FZAP_BLOCK_SHIFT(zap),
+		    ZIO_PRIORITY_ASYNC_READ);
+	}
+
+	if (zc->zc_leaf &&
+	    (ZAP_HASH_IDX(zc->zc_hash,
+	    zap_leaf_phys(zc->zc_leaf)->l_hdr.lh_prefix_len) !=
+	    zap_leaf_phys(zc->zc_leaf)->l_hdr.lh_prefix)) {
+		rw_enter(&zc->zc_leaf->l_rwlock, RW_READER);
+		zap_put_leaf(zc->zc_leaf);
+		zc->zc_leaf = NULL;
+	}
+
+	while (nret < nza) {
+		zap_leaf_t *l;
+
+		if (zc->zc_leaf == NULL) {
+			err = zap_deref_leaf(zap, zc->zc_hash, NULL, RW_READER,
+			    &zc->zc_leaf);
+			if (err != 0)
+				break;
+			leaf_locked = B_TRUE;
+			if (zc->zc_prefetch && zap_iterate_readahead > 0)
+				fzap_cursor_readahead(zap, zc->zc_hash);
+		} else if (!leaf_locked) {
+			rw_enter(&zc->zc_leaf->l_rwlock, RW_READER);
+			leaf_locked = B_TRUE;
+		}
+		l = zc->zc_leaf;
+
+		err = zap_leaf_lookup_closest(l, zc->zc_hash, zc->zc_cd, &zeh);
+		if (err == ENOENT) {
+			uint64_t nocare = (1ULL <<
+			    (64 - zap_leaf_phys(l)->l_hdr.lh_prefix_len)) - 1;
+
+			zc->zc_hash = (zc->zc_hash & ~nocare) + nocare + 1;
+			zc->zc_cd = 0;
+			if (zap_leaf_phys(l)->l_hdr.lh_prefix_len == 0 ||
+			    zc->zc_hash == 0) {
+				zc->zc_hash = -1ULL;
+				break;
+			}
+			zap_put_leaf(zc->zc_leaf);
+			zc->zc_leaf = NULL;
+			leaf_locked = B_FALSE;
+			continue;
 		}
-		err = zap_entry_read_name(zap, &zeh,
-		    sizeof (za->za_name), za->za_name);
-		ASSERT(err == 0);
+		if (err != 0)
+			break;
 
-		za->za_normalization_conflict =
-		    zap_entry_normalization_conflict(&zeh,
-		    NULL, za->za_name, zap);
+		zc->zc_hash = zeh.zeh_hash;
+		zc->zc_cd = zeh.zeh_cd;
+		fzap_cursor_fill(zap, &zeh, &za[nret]);
+		/* advance the cursor past this entry */
+		zc->zc_cd++;
+		if (cookies != NULL)
+			cookies[nret] = zap_cursor_serialize(zc);
+		nret++;
 	}
-	rw_exit(&zc->zc_leaf->l_rwlock);
+	if (leaf_locked)
+		rw_exit(&zc->zc_leaf->l_rwlock);
+	*nretp = nret;
+	if (nret > 0)
+		err = 0;
 	return (err);
 }
 
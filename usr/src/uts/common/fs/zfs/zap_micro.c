@@ -1460,17 +1460,17 @@ zap_cursor_serialize(zap_cursor_t *zc)
 	    ((uint64_t)zc->zc_cd << zap_hashbits(zc->zc_zap)));
 }
 
-int
-zap_cursor_retrieve(zap_cursor_t *zc, zap_attribute_t *za)
+/*
+ * Lock the cursor's directory for iteration, attaching the cursor to the
+ * zap_t (and applying any serialized position) on first use.  On success
+ * the zap_rwlock is held as reader.
+ */
+static int
+zap_cursor_lockdir(zap_cursor_t *zc)
 {
-	int err;
-
-	if (zc->zc_hash == -1ULL)
-		return (SET_ERROR(ENOENT));
-
 	if (zc->zc_zap == NULL) {
 		int hb;
-		err = zap_lockdir(zc->zc_objset, zc->zc_zapobj, NULL,
+		int err = zap_lockdir(zc->zc_objset, zc->zc_zapobj, NULL,
 		    RW_READER, TRUE, FALSE, NULL, &zc->zc_zap);
 		if (err != 0)
 			return (err);
@@ -1489,6 +1489,20 @@ zap_cursor_retrieve(zap_cursor_t *zc, zap_attribute_t *za)
 	} else {
 		rw_enter(&zc->zc_zap->zap_rwlock, RW_READER);
 	}
+	return (0);
+}
+
+int
+zap_cursor_retrieve(zap_cursor_t *zc, zap_attribute_t *za)
+{
+	int err;
+
+	if (zc->zc_hash == -1ULL)
+		return (SET_ERROR(ENOENT));
+
+	err = zap_cursor_lockdir(zc);
+	if (err != 0)
+		return (err);
 	if (!zc->zc_zap->zap_ismicro) {
 		err = fzap_cursor_retrieve(zc->zc_zap, zc, za);
 	} else {
@@ -1525,6 +1539,79 @@ zap_cursor_retrieve(zap_cursor_t *zc, zap_attribute_t *za)
 	return (err);
 }
 
+/*
+ * Retrieve up to nza entries at the cursor, locking the directory (and,
+ * for fatzaps, each leaf block) once per batch rather than once per
+ * entry.  On return, *nretp is the number of entries filled in and the
+ * cursor has been advanced past the last of them; cookies[i] (if cookies
+ * is non-NULL) is the serialized cursor positioned just past za[i], so a
+ * caller that stops consuming mid-batch can resume from any entry.
+ * Returns 0 if at least one entry was retrieved, ENOENT at the end of
+ * the directory.
+ */
+int
+zap_cursor_retrieve_batch(zap_cursor_t *zc, zap_attribute_t *za,
+    uint64_t *cookies, int nza, int *nretp)
+{
+	int err;
+	int nret = 0;
+
+	ASSERT3S(nza, >, 0);
+
+	*nretp = 0;
+	if (zc->zc_hash == -1ULL)
+		return (SET_ERROR(ENOENT));
+
+	err = zap_cursor_lockdir(zc);
+	if (err != 0)
+		return (err);
+	if (!zc->zc_zap->zap_ismicro) {
+		err = fzap_cursor_retrieve_batch(zc->zc_zap, zc, za, cookies,
+		    nza, &nret);
+	} else {
+		avl_index_t idx;
+		mzap_ent_t mze_tofind;
+
+		mze_tofind.mze_hash = zc->zc_hash;
+		mze_tofind.mze_cd = zc->zc_cd;
+
+		mzap_ent_t *mze =
+		    avl_find(&zc->zc_zap->zap_m.zap_avl, &mze_tofind, &idx);
+		if (mze == NULL) {
+			mze = avl_nearest(&zc->zc_zap->zap_m.zap_avl,
+			    idx, AVL_AFTER);
+		}
+		while (mze != NULL && nret < nza) {
+			mzap_ent_phys_t *mzep = MZE_PHYS(zc->zc_zap, mze);
+			ASSERT3U(mze->mze_cd, ==, mzep->mze_cd);
+			za[nret].za_normalization_conflict =
+			    mzap_normalization_conflict(zc->zc_zap, NULL, mze);
+			za[nret].za_integer_length = 8;
+			za[nret].za_num_integers = 1;
+			za[nret].za_first_integer = mzep->mze_value;
+			(void) strcpy(za[nret].za_name, mzep->mze_name);
+			/* advance the cursor past this entry */
+			zc->zc_hash = mze->mze_hash;
+			zc->zc_cd = mze->mze_cd + 1;
+			if (cookies != NULL)
+				cookies[nret] = zap_cursor_serialize(zc);
+			nret++;
+			mze = AVL_NEXT(&zc->zc_zap->zap_m.zap_avl, mze);
+		}
+		if (mze == NULL && nret < nza) {
+			zc->zc_hash = -1ULL;
+			err = SET_ERROR(ENOENT);
+		} else {
+			err = 0;
+		}
+	}
+	rw_exit(&zc->zc_zap->zap_rwlock);
+	*nretp = nret;
+	if (nret > 0)
+		err = 0;
+	return (err);
+}
+
 void
 zap_cursor_advance(zap_cursor_t *zc)
 {
@@ -1765,6 +1765,78 @@ zfs_ioc_pool_stats(zfs_cmd_t *zc)
 	return (ret);
 }
 
+static void
+zfs_pool_vdev_stats_add(nvlist_t *nvl, vdev_t *vd)
+{
+	nvlist_t *nv;
+	char guidbuf[32];
+	uint64_t c;
+
+	nv = fnvlist_alloc();
+	vdev_config_generate_stats(vd, nv);
+	(void) snprintf(guidbuf, sizeof (guidbuf), "%llu",
+	    (u_longlong_t)vd->vdev_guid);
+	fnvlist_add_nvlist(nvl, guidbuf, nv);
+	fnvlist_free(nv);
+
+	for (c = 0; c < vd->vdev_children; c++)
+		zfs_pool_vdev_stats_add(nvl, vd->vdev_child[c]);
+}
+
+/*
+ * inputs:
+ * zc_name		name of the pool
+ * zc_cookie		config generation the caller's cached config is from
+ *
+ * outputs:
+ * zc_nvlist_dst	nvlist mapping vdev guids (as decimal strings) to
+ *			nvlists of that vdev's stats, in the same form they
+ *			take within the pool config
+ * zc_cookie		current config generation
+ *
+ * Returns ESTALE (with zc_cookie updated) if the pool configuration has
+ * changed since the given generation; the caller is expected to fall back
+ * to ZFS_IOC_POOL_STATS to pick up the new configuration.  This allows
+ * stats consumers such as zpool iostat to refresh per-vdev statistics
+ * without the kernel regenerating, and the caller reparsing, the entire
+ * pool config on every interval.
+ */
+static int
+zfs_ioc_pool_vdev_stats(zfs_cmd_t *zc)
+{
+	spa_t *spa;
+	nvlist_t *nvl;
+	int error;
+	int i;
+
+	if ((error = spa_open(zc->zc_name, &spa, FTAG)) != 0)
+		return (error);
+
+	spa_config_enter(spa, SCL_CONFIG | SCL_STATE, FTAG, RW_READER);
+
+	if (zc->zc_cookie != spa->spa_config_generation) {
+		zc->zc_cookie = spa->spa_config_generation;
+		spa_config_exit(spa, SCL_CONFIG | SCL_STATE, FTAG);
+		spa_close(spa, FTAG);
+		return (SET_ERROR(ESTALE));
+	}
+
+	nvl = fnvlist_alloc();
+	zfs_pool_vdev_stats_add(nvl, spa->spa_root_vdev);
+	for (i = 0; i < spa->spa_l2cache.sav_count; i++)
+		zfs_pool_vdev_stats_add(nvl, spa->spa_l2cache.sav_vdevs[i]);
+	for (i = 0; i < spa->spa_spares.sav_count; i++)
+		zfs_pool_vdev_stats_add(nvl, spa->spa_spares.sav_vdevs[i]);
+
+	spa_config_exit(spa, SCL_CONFIG | SCL_STATE, FTAG);
+
+	error = put_nvlist(zc, nvl);
+	nvlist_free(nvl);
+	spa_close(spa, FTAG);
+
+	return (error);
+}
+
 /*
  * Try to import the given pool, returning pool stats as appropriate so that
  * user land knows which devices are available and overall pool health.
@@ -6891,6 +6963,9 @@ zfs_ioctl_init(void)
 
 	zfs_ioctl_register_pool(ZFS_IOC_POOL_STATS, zfs_ioc_pool_stats,
 	    zfs_secpolicy_read, B_FALSE, POOL_CHECK_NONE);
+	zfs_ioctl_register_pool(ZFS_IOC_POOL_VDEV_STATS,
+	    zfs_ioc_pool_vdev_stats, zfs_secpolicy_read, B_FALSE,
+	    POOL_CHECK_NONE);
 	zfs_ioctl_register_pool(ZFS_IOC_POOL_GET_PROPS, zfs_ioc_pool_get_props,
 	    zfs_secpolicy_read, B_FALSE, POOL_CHECK_NONE);
 
@@ -7432,8 +7507,8 @@ static struct cb_ops zfs_cb_ops = {
 	NULL,		/* streamtab */
 	D_NEW | D_MP | D_64BIT,		/* Driver compatibility flag */
 	CB_REV,		/* version */
-	nodev,		/* async read */
-	nodev,		/* async write */
+	zvol_aread,	/* async read */
+	zvol_awrite,	/* async write */
 };
 
 static struct dev_ops zfs_dev_ops = {
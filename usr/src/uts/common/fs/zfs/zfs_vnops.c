@@ -2334,6 +2334,12 @@ out:
 	return (error);
 }
 
+/*
+ * Number of directory entries fetched from the ZAP per
+ * zap_cursor_retrieve_batch() call in zfs_readdir().
+ */
+int zfs_readdir_batch = 32;
+
 /*
  * Read as many directory entries as will fit into the provided
  * buffer from the given directory cursor position (specified in
@@ -2373,7 +2379,12 @@ zfs_readdir(vnode_t *vp, uio_t *uio, cred_t *cr, int *eofp,
 	caddr_t		outbuf;
 	size_t		bufsize;
 	zap_cursor_t	zc;
-	zap_attribute_t	zap;
+	zap_attribute_t	*zap;
+	zap_attribute_t	*zap_batch;
+	uint64_t	*zap_cookies;
+	int		zap_batch_size;
+	int		zap_nret;
+	int		zap_next;
 	uint_t		bytes_wanted;
 	uint64_t	offset; /* must be unsigned; checks for < 1 */
 	uint64_t	parent;
@@ -2451,6 +2462,18 @@ zfs_readdir(vnode_t *vp, uio_t *uio, cred_t *cr, int *eofp,
 	}
 	eodp = (struct edirent *)odp;
 
+	/*
+	 * Fetch directory entries from the ZAP in batches; each entry's
+	 * cookie is the serialized cursor for the entry after it.
+	 */
+	zap_batch_size = MAX(zfs_readdir_batch, 1);
+	zap_batch = kmem_alloc(zap_batch_size * sizeof (zap_attribute_t),
+	    KM_SLEEP);
+	zap_cookies = kmem_alloc(zap_batch_size * sizeof (uint64_t),
+	    KM_SLEEP);
+	zap_nret = zap_next = 0;
+	zap = &zap_batch[0];
+
 	/*
 	 * If this VFS supports the system attribute view interface; and
 	 * we're looking at an extended attribute directory; and we care
@@ -2474,30 +2497,40 @@ zfs_readdir(vnode_t *vp, uio_t *uio, cred_t *cr, int *eofp,
 		 * Special case `.', `..', and `.zfs'.
 		 */
 		if (offset == 0) {
-			(void) strcpy(zap.za_name, ".");
-			zap.za_normalization_conflict = 0;
+			zap = &zap_batch[0];
+			(void) strcpy(zap->za_name, ".");
+			zap->za_normalization_conflict = 0;
 			objnum = zp->z_id;
 		} else if (offset == 1) {
-			(void) strcpy(zap.za_name, "..");
-			zap.za_normalization_conflict = 0;
+			zap = &zap_batch[0];
+			(void) strcpy(zap->za_name, "..");
+			zap->za_normalization_conflict = 0;
 			objnum = parent;
 		} else if (offset == 2 && zfs_show_ctldir(zp)) {
-			(void) strcpy(zap.za_name, ZFS_CTLDIR_NAME);
-			zap.za_normalization_conflict = 0;
+			zap = &zap_batch[0];
+			(void) strcpy(zap->za_name, ZFS_CTLDIR_NAME);
+			zap->za_normalization_conflict = 0;
 			objnum = ZFSCTL_INO_ROOT;
 		} else {
 			/*
-			 * Grab next entry.
+			 * Grab the next batch of entries if the current
+			 * one has been consumed.
 			 */
-			if (error = zap_cursor_retrieve(&zc, &zap)) {
-				if ((*eofp = (error == ENOENT)) != 0)
-					break;
-				else
-					goto update;
+			if (zap_next == zap_nret) {
+				zap_next = 0;
+				if (error = zap_cursor_retrieve_batch(&zc,
+				    zap_batch, zap_cookies, zap_batch_size,
+				    &zap_nret)) {
+					if ((*eofp = (error == ENOENT)) != 0)
+						break;
+					else
+						goto update;
+				}
 			}
+			zap = &zap_batch[zap_next];
 
-			if (zap.za_integer_length != 8 ||
-			    zap.za_num_integers != 1) {
+			if (zap->za_integer_length != 8 ||
+			    zap->za_num_integers != 1) {
 				cmn_err(CE_WARN, "zap_readdir: bad directory "
 				    "entry, obj = %lld, offset = %lld\n",
 				    (u_longlong_t)zp->z_id,
@@ -2506,15 +2539,16 @@ zfs_readdir(vnode_t *vp, uio_t *uio, cred_t *cr, int *eofp,
 				goto update;
 			}
 
-			objnum = ZFS_DIRENT_OBJ(zap.za_first_integer);
+			objnum = ZFS_DIRENT_OBJ(zap->za_first_integer);
 			/*
 			 * MacOS X can extract the object type here such as:
-			 * uint8_t type = ZFS_DIRENT_TYPE(zap.za_first_integer);
+			 * uint8_t type = ZFS_DIRENT_TYPE(zap->za_first_integer);
 			 */
 
-			if (check_sysattrs && !zap.za_normalization_conflict) {
-				zap.za_normalization_conflict =
-				    xattr_sysattr_casechk(zap.za_name);
+			if (check_sysattrs &&
+			    !zap->za_normalization_conflict) {
+				zap->za_normalization_conflict =
+				    xattr_sysattr_casechk(zap->za_name);
 			}
 		}
 
@@ -2534,9 +2568,9 @@ zfs_readdir(vnode_t *vp, uio_t *uio, cred_t *cr, int *eofp,
 		}
 
 		if (flags & V_RDDIR_ENTFLAGS)
-			reclen = EDIRENT_RECLEN(strlen(zap.za_name));
+			reclen = EDIRENT_RECLEN(strlen(zap->za_name));
 		else
-			reclen = DIRENT64_RECLEN(strlen(zap.za_name));
+			reclen = DIRENT64_RECLEN(strlen(zap->za_name));
 
 		/*
 		 * Will this entry fit in the buffer?
@@ -2559,9 +2593,9 @@ zfs_readdir(vnode_t *vp, uio_t *uio, cred_t *cr, int *eofp,
 			eodp->ed_reclen = reclen;
 			/* NOTE: ed_off is the offset for the *next* entry */
 			next = &(eodp->ed_off);
-			eodp->ed_eflags = zap.za_normalization_conflict ?
+			eodp->ed_eflags = zap->za_normalization_conflict ?
 			    ED_CASE_CONFLICT : 0;
-			(void) strncpy(eodp->ed_name, zap.za_name,
+			(void) strncpy(eodp->ed_name, zap->za_name,
 			    EDIRENT_NAMELEN(reclen));
 			eodp = (edirent_t *)((intptr_t)eodp + reclen);
 		} else {
@@ -2572,7 +2606,7 @@ zfs_readdir(vnode_t *vp, uio_t *uio, cred_t *cr, int *eofp,
 			odp->d_reclen = reclen;
 			/* NOTE: d_off is the offset for the *next* entry */
 			next = &(odp->d_off);
-			(void) strncpy(odp->d_name, zap.za_name,
+			(void) strncpy(odp->d_name, zap->za_name,
 			    DIRENT64_NAMELEN(reclen));
 			odp = (dirent64_t *)((intptr_t)odp + reclen);
 		}
@@ -2590,8 +2624,7 @@ zfs_readdir(vnode_t *vp, uio_t *uio, cred_t *cr, int *eofp,
 		 * Move to the next entry, fill in the previous offset.
 		 */
 		if (offset > 2 || (offset == 2 && !zfs_show_ctldir(zp))) {
-			zap_cursor_advance(&zc);
-			offset = zap_cursor_serialize(&zc);
+			offset = zap_cookies[zap_next++];
 		} else {
 			offset += 1;
 		}
@@ -2613,6 +2646,8 @@ zfs_readdir(vnode_t *vp, uio_t *uio, cred_t *cr, int *eofp,
 
 update:
 	zap_cursor_fini(&zc);
+	kmem_free(zap_batch, zap_batch_size * sizeof (zap_attribute_t));
+	kmem_free(zap_cookies, zap_batch_size * sizeof (uint64_t));
 	if (uio->uio_segflg != UIO_SYSSPACE || uio->uio_iovcnt != 1)
 		kmem_free(outbuf, bufsize);
 
@@ -2680,26 +2715,15 @@ zfs_getattr(vnode_t *vp, vattr_t *vap, int flags, cred_t *cr,
 	zfsvfs_t *zfsvfs = zp->z_zfsvfs;
 	int	error = 0;
 	uint64_t links;
-	uint64_t mtime[2], ctime[2];
 	xvattr_t *xvap = (xvattr_t *)vap;	/* vap may be an xvattr_t * */
 	xoptattr_t *xoap = NULL;
 	boolean_t skipaclchk = (flags & ATTR_NOACLCHECK) ? B_TRUE : B_FALSE;
-	sa_bulk_attr_t bulk[2];
-	int count = 0;
 
 	ZFS_ENTER(zfsvfs);
 	ZFS_VERIFY_ZP(zp);
 
 	zfs_fuid_map_ids(zp, cr, &vap->va_uid, &vap->va_gid);
 
-	SA_ADD_BULK_ATTR(bulk, count, SA_ZPL_MTIME(zfsvfs), NULL, &mtime, 16);
-	SA_ADD_BULK_ATTR(bulk, count, SA_ZPL_CTIME(zfsvfs), NULL, &ctime, 16);
-
-	if ((error = sa_bulk_lookup(zp->z_sa_hdl, bulk, count)) != 0) {
-		ZFS_EXIT(zfsvfs);
-		return (error);
-	}
-
 	/*
 	 * If ACL is trivial don't bother looking for ACE_READ_ATTRIBUTES.
 	 * Also, if we are the owner don't bother, since owner should
@@ -2852,8 +2876,8 @@ zfs_getattr(vnode_t *vp, vattr_t *vap, int flags, cred_t *cr,
 	}
 
 	ZFS_TIME_DECODE(&vap->va_atime, zp->z_atime);
-	ZFS_TIME_DECODE(&vap->va_mtime, mtime);
-	ZFS_TIME_DECODE(&vap->va_ctime, ctime);
+	ZFS_TIME_DECODE(&vap->va_mtime, zp->z_mtime);
+	ZFS_TIME_DECODE(&vap->va_ctime, zp->z_ctime);
 
 	mutex_exit(&zp->z_lock);
 
@@ -3589,6 +3613,8 @@ top:
 
 	if (mask & AT_MTIME) {
 		ZFS_TIME_ENCODE(&vap->va_mtime, mtime);
+		zp->z_mtime[0] = mtime[0];
+		zp->z_mtime[1] = mtime[1];
 		SA_ADD_BULK_ATTR(bulk, count, SA_ZPL_MTIME(zfsvfs), NULL,
 		    mtime, sizeof (mtime));
 	}
@@ -109,6 +109,41 @@ boolean_t zil_nocacheflush = B_FALSE;
  */
 uint64_t zil_slog_bulk = 768 * 1024;
 
+/*
+ * Stage synchronous itxs on per-CPU lists instead of appending them to
+ * the itxg's sync list directly, so that committing threads stop
+ * serializing on the itxg_lock; see the comment above itx_stage_t in
+ * zil_impl.h.  Set to 0 to fall back to the single-list behavior.
+ */
+int zil_itx_stage_sync = 1;
+
+typedef struct zil_stats {
+	kstat_named_t zil_commit_count;
+	kstat_named_t zil_commit_batches;
+	kstat_named_t zil_commit_batch_itxs;
+	kstat_named_t zil_commit_batch_max;
+	kstat_named_t zil_itx_staged;
+} zil_stats_t;
+
+static zil_stats_t zil_stats = {
+	{ "commit_count",	KSTAT_DATA_UINT64 },
+	{ "commit_batches",	KSTAT_DATA_UINT64 },
+	{ "commit_batch_itxs",	KSTAT_DATA_UINT64 },
+	{ "commit_batch_max",	KSTAT_DATA_UINT64 },
+	{ "itx_staged",		KSTAT_DATA_UINT64 },
+};
+
+#define	ZIL_STAT_BUMP(stat) \
+	atomic_inc_64(&zil_stats.stat.value.ui64)
+#define	ZIL_STAT_ADD(stat, val) \
+	atomic_add_64(&zil_stats.stat.value.ui64, val)
+#define	ZIL_STAT_MAX(stat, val) {			\
+	if ((val) > zil_stats.stat.value.ui64)		\
+		zil_stats.stat.value.ui64 = (val);	\
+}
+
+static kstat_t *zil_ksp;
+
 static kmem_cache_t *zil_lwb_cache;
 static kmem_cache_t *zil_zcw_cache;
 
@@ -1794,6 +1829,79 @@ zil_remove_async(zilog_t *zilog, uint64_t oid)
 	list_destroy(&clean_list);
 }
 
+/*
+ * Merge any staged sync itxs into the itxg's sync list, restoring
+ * assignment order.  The stage lists and the sync list are each
+ * individually ordered by itx_seq, so this is a k-way merge.  Called
+ * with the itxg_lock held, from every place that consumes or detaches
+ * the itxg's itxs.
+ */
+static void
+zil_itxg_stage_drain(itxg_t *itxg)
+{
+	list_t *sync_list = &itxg->itxg_itxs->i_sync_list;
+	list_t runs[ZIL_ITX_NSTAGES + 1];
+	int nruns = 0;
+	itx_t *itx;
+
+	ASSERT(MUTEX_HELD(&itxg->itxg_lock));
+
+	/*
+	 * Hold every stage lock across the whole snapshot so that it is
+	 * atomic with respect to zil_itx_assign().  Were the stages
+	 * emptied one lock at a time, a TX_COMMIT itx could be taken
+	 * from a not-yet-drained stage while a concurrent assign
+	 * slipped an earlier write into an already-drained one, and
+	 * zil_commit() would signal completion without having issued
+	 * that write.  With all of the locks held, an itx is either
+	 * fully staged and collected here, or it is assigned its
+	 * itx_seq after the snapshot and so follows everything that
+	 * was collected.
+	 */
+	for (int i = 0; i < ZIL_ITX_NSTAGES; i++)
+		mutex_enter(&itxg->itxg_stage[i].is_lock);
+	for (int i = 0; i < ZIL_ITX_NSTAGES; i++) {
+		itx_stage_t *is = &itxg->itxg_stage[i];
+
+		list_create(&runs[nruns], sizeof (itx_t),
+		    offsetof(itx_t, itx_node));
+		list_move_tail(&runs[nruns], &is->is_list);
+		if (list_is_empty(&runs[nruns]))
+			list_destroy(&runs[nruns]);
+		else
+			nruns++;
+	}
+	for (int i = 0; i < ZIL_ITX_NSTAGES; i++)
+		mutex_exit(&itxg->itxg_stage[i].is_lock);
+	if (nruns == 0)
+		return;
+
+	list_create(&runs[nruns], sizeof (itx_t), offsetof(itx_t, itx_node));
+	list_move_tail(&runs[nruns], sync_list);
+	nruns++;
+
+	for (;;) {
+		list_t *min_run = NULL;
+		itx_t *min_itx = NULL;
+
+		for (int i = 0; i < nruns; i++) {
+			itx = list_head(&runs[i]);
+			if (itx != NULL && (min_itx == NULL ||
+			    itx->itx_seq < min_itx->itx_seq)) {
+				min_itx = itx;
+				min_run = &runs[i];
+			}
+		}
+		if (min_itx == NULL)
+			break;
+		list_remove(min_run, min_itx);
+		list_insert_tail(sync_list, min_itx);
+	}
+
+	for (int i = 0; i < nruns; i++)
+		list_destroy(&runs[i]);
+}
+
 void
 zil_itx_assign(zilog_t *zilog, itx_t *itx, dmu_tx_t *tx)
 {
@@ -1813,6 +1921,33 @@ zil_itx_assign(zilog_t *zilog, itx_t *itx, dmu_tx_t *tx)
 		txg = dmu_tx_get_txg(tx);
 
 	itxg = &zilog->zl_itxg[txg & TXG_MASK];
+
+	/*
+	 * Fast path for sync itxs: stage the itx on a per-CPU list,
+	 * taking only that stage's lock.  The issuer merges the stages
+	 * back into assignment order (by itx_seq) when it collects the
+	 * commit list.  Fall back to the itxg_lock path if this itxg
+	 * hasn't been set up for this txg yet.  The zil is dirtied
+	 * before the itx becomes visible, since the issuer asserts
+	 * that any itx it collects belongs to a dirty txg.
+	 */
+	if (zil_itx_stage_sync && itx->itx_sync) {
+		itx_stage_t *is = &itxg->itxg_stage[CPU_SEQID &
+		    (ZIL_ITX_NSTAGES - 1)];
+
+		zilog_dirty(zilog, dmu_tx_get_txg(tx));
+		mutex_enter(&is->is_lock);
+		if (itxg->itxg_txg == txg) {
+			itx->itx_seq = atomic_inc_64_nv(&itxg->itxg_seq);
+			itx->itx_lr.lrc_txg = dmu_tx_get_txg(tx);
+			list_insert_tail(&is->is_list, itx);
+			mutex_exit(&is->is_lock);
+			ZIL_STAT_BUMP(zil_itx_staged);
+			return;
+		}
+		mutex_exit(&is->is_lock);
+	}
+
 	mutex_enter(&itxg->itxg_lock);
 	itxs = itxg->itxg_itxs;
 	if (itxg->itxg_txg != txg) {
@@ -1824,6 +1959,7 @@ zil_itx_assign(zilog_t *zilog, itx_t *itx, dmu_tx_t *tx)
 			 */
 			zfs_dbgmsg("zil_itx_assign: missed itx cleanup for "
 			    "txg %llu", itxg->itxg_txg);
+			zil_itxg_stage_drain(itxg);
 			clean = itxg->itxg_itxs;
 		}
 		itxg->itxg_txg = txg;
@@ -1836,6 +1972,7 @@ zil_itx_assign(zilog_t *zilog, itx_t *itx, dmu_tx_t *tx)
 		    offsetof(itx_async_node_t, ia_node));
 	}
 	if (itx->itx_sync) {
+		itx->itx_seq = atomic_inc_64_nv(&itxg->itxg_seq);
 		list_insert_tail(&itxs->i_sync_list, itx);
 	} else {
 		avl_tree_t *t = &itxs->i_async_tree;
@@ -1893,6 +2030,7 @@ zil_clean(zilog_t *zilog, uint64_t synced_txg)
 	}
 	ASSERT3U(itxg->itxg_txg, <=, synced_txg);
 	ASSERT3U(itxg->itxg_txg, !=, 0);
+	zil_itxg_stage_drain(itxg);
 	clean_me = itxg->itxg_itxs;
 	itxg->itxg_itxs = NULL;
 	itxg->itxg_txg = 0;
@@ -1952,12 +2090,32 @@ zil_get_commit_list(zilog_t *zilog)
 		 */
 		ASSERT(zilog_is_dirty_in_txg(zilog, txg) ||
 		    spa_freeze_txg(zilog->zl_spa) != UINT64_MAX);
+		zil_itxg_stage_drain(itxg);
 		list_move_tail(commit_list, &itxg->itxg_itxs->i_sync_list);
 
 		mutex_exit(&itxg->itxg_lock);
 	}
 }
 
+/*
+ * Append the itxs on "src" to the itxg's sync list, stamping each with
+ * a fresh sequence number so the sync list remains ordered by itx_seq
+ * (any itx still sitting in a stage was assigned earlier and will sort
+ * before these when the stages are drained).  Called with the
+ * itxg_lock held.
+ */
+static void
+zil_itx_move_sync(itxg_t *itxg, list_t *src)
+{
+	itx_t *itx;
+
+	ASSERT(MUTEX_HELD(&itxg->itxg_lock));
+
+	for (itx = list_head(src); itx != NULL; itx = list_next(src, itx))
+		itx->itx_seq = atomic_inc_64_nv(&itxg->itxg_seq);
+	list_move_tail(&itxg->itxg_itxs->i_sync_list, src);
+}
+
 /*
  * Move the async itxs for a specified object to commit into sync lists.
  */
@@ -1997,15 +2155,13 @@ zil_async_to_sync(zilog_t *zilog, uint64_t foid)
 		if (foid != 0) {
 			ian = avl_find(t, &foid, &where);
 			if (ian != NULL) {
-				list_move_tail(&itxg->itxg_itxs->i_sync_list,
-				    &ian->ia_list);
+				zil_itx_move_sync(itxg, &ian->ia_list);
 			}
 		} else {
 			void *cookie = NULL;
 
 			while ((ian = avl_destroy_nodes(t, &cookie)) != NULL) {
-				list_move_tail(&itxg->itxg_itxs->i_sync_list,
-				    &ian->ia_list);
+				zil_itx_move_sync(itxg, &ian->ia_list);
 				list_destroy(&ian->ia_list);
 				kmem_free(ian, sizeof (itx_async_node_t));
 			}
@@ -2112,6 +2268,8 @@ zil_process_commit_list(zilog_t *zilog)
 	if (list_head(&zilog->zl_itx_commit_list) == NULL)
 		return;
 
+	ZIL_STAT_BUMP(zil_commit_batches);
+
 	list_create(&nolwb_waiters, sizeof (zil_commit_waiter_t),
 	    offsetof(zil_commit_waiter_t, zcw_node));
 
@@ -2124,10 +2282,14 @@ zil_process_commit_list(zilog_t *zilog)
 		ASSERT3S(lwb->lwb_state, !=, LWB_STATE_FLUSH_DONE);
 	}
 
+	uint64_t batch_itxs = 0;
+
 	while (itx = list_head(&zilog->zl_itx_commit_list)) {
 		lr_t *lrc = &itx->itx_lr;
 		uint64_t txg = lrc->lrc_txg;
 
+		batch_itxs++;
+
 		ASSERT3U(txg, !=, 0);
 
 		if (lrc->lrc_txtype == TX_COMMIT) {
@@ -2199,6 +2361,9 @@ zil_process_commit_list(zilog_t *zilog)
 		zil_itx_destroy(itx);
 	}
 
+	ZIL_STAT_ADD(zil_commit_batch_itxs, batch_itxs);
+	ZIL_STAT_MAX(zil_commit_batch_max, batch_itxs);
+
 	if (lwb == NULL) {
 		/*
 		 * This indicates zio_alloc_zil() failed to allocate the
@@ -2757,6 +2922,8 @@ zil_commit(zilog_t *zilog, uint64_t foid)
 	 */
 	ASSERT3B(dmu_objset_is_snapshot(zilog->zl_os), ==, B_FALSE);
 
+	ZIL_STAT_BUMP(zil_commit_count);
+
 	if (zilog->zl_sync == ZFS_SYNC_DISABLED)
 		return;
 
@@ -2944,11 +3111,24 @@ zil_init(void)
 
 	zil_zcw_cache = kmem_cache_create("zil_zcw_cache",
 	    sizeof (zil_commit_waiter_t), 0, NULL, NULL, NULL, NULL, NULL, 0);
+
+	zil_ksp = kstat_create("zfs", 0, "zilstats", "misc",
+	    KSTAT_TYPE_NAMED, sizeof (zil_stats) / sizeof (kstat_named_t),
+	    KSTAT_FLAG_VIRTUAL);
+	if (zil_ksp != NULL) {
+		zil_ksp->ks_data = &zil_stats;
+		kstat_install(zil_ksp);
+	}
 }
 
 void
 zil_fini(void)
 {
+	if (zil_ksp != NULL) {
+		kstat_delete(zil_ksp);
+		zil_ksp = NULL;
+	}
+
 	kmem_cache_destroy(zil_zcw_cache);
 	kmem_cache_destroy(zil_lwb_cache);
 }
@@ -2989,6 +3169,13 @@ zil_alloc(objset_t *os, zil_header_t *zh_phys)
 	for (int i = 0; i < TXG_SIZE; i++) {
 		mutex_init(&zilog->zl_itxg[i].itxg_lock, NULL,
 		    MUTEX_DEFAULT, NULL);
+		for (int j = 0; j < ZIL_ITX_NSTAGES; j++) {
+			itx_stage_t *is = &zilog->zl_itxg[i].itxg_stage[j];
+
+			mutex_init(&is->is_lock, NULL, MUTEX_DEFAULT, NULL);
+			list_create(&is->is_list, sizeof (itx_t),
+			    offsetof(itx_t, itx_node));
+		}
 	}
 
 	list_create(&zilog->zl_lwb_list, sizeof (lwb_t),
@@ -3024,8 +3211,19 @@ zil_free(zilog_t *zilog)
 		 *
 		 * Also free up the ziltest itxs.
 		 */
-		if (zilog->zl_itxg[i].itxg_itxs)
+		if (zilog->zl_itxg[i].itxg_itxs) {
+			mutex_enter(&zilog->zl_itxg[i].itxg_lock);
+			zil_itxg_stage_drain(&zilog->zl_itxg[i]);
+			mutex_exit(&zilog->zl_itxg[i].itxg_lock);
 			zil_itxg_clean(zilog->zl_itxg[i].itxg_itxs);
+		}
+		for (int j = 0; j < ZIL_ITX_NSTAGES; j++) {
+			itx_stage_t *is = &zilog->zl_itxg[i].itxg_stage[j];
+
+			ASSERT(list_is_empty(&is->is_list));
+			list_destroy(&is->is_list);
+			mutex_destroy(&is->is_lock);
+		}
 		mutex_destroy(&zilog->zl_itxg[i].itxg_lock);
 	}
 
@@ -110,6 +110,45 @@ int zfs_sync_pass_rewrite = 2; /* rewrite new bps starting in this pass */
 
 boolean_t	zio_requeue_io_start_cut_in_line = B_TRUE;
 
+/*
+ * Batch interrupt-taskq dispatches on per-CPU lists, so that a burst of
+ * zio completions costs one taskq dispatch instead of one per zio.  The
+ * drain task runs on the same taskq the zios would have been dispatched
+ * to individually, so the pipeline's interrupt-context checks still
+ * apply.  Issue-side dispatches are not batched; spreading CPU-heavy
+ * stages such as checksumming across taskq threads matters more there
+ * than dispatch overhead.
+ */
+int zio_batch_interrupts = B_TRUE;
+
+/*
+ * Observability for dispatch batching, in the zio_batch kstat:
+ * batch_runs counts drain passes, batch_zios the zios they executed
+ * (batch_zios / batch_runs is the average batch size), and batch_max
+ * the largest single batch seen.
+ */
+typedef struct zio_batch_stats {
+	kstat_named_t zbs_batch_runs;
+	kstat_named_t zbs_batch_zios;
+	kstat_named_t zbs_batch_max;
+} zio_batch_stats_t;
+
+static zio_batch_stats_t zio_batch_stats = {
+	{ "batch_runs",		KSTAT_DATA_UINT64 },
+	{ "batch_zios",		KSTAT_DATA_UINT64 },
+	{ "batch_max",		KSTAT_DATA_UINT64 },
+};
+
+#define	ZIO_BATCH_STAT_ADD(stat, val) \
+	atomic_add_64(&zio_batch_stats.zbs_##stat.value.ui64, (val))
+#define	ZIO_BATCH_STAT_MAX(stat, val) { \
+	uint64_t _m = (val); \
+	if (_m > zio_batch_stats.zbs_##stat.value.ui64) \
+		zio_batch_stats.zbs_##stat.value.ui64 = _m; \
+}
+
+static kstat_t *zio_batch_ksp;
+
 #ifdef ZFS_DEBUG
 int zio_buf_debug_limit = 16384;
 #else
@@ -190,6 +229,14 @@ zio_init(void)
 			zio_data_buf_cache[c - 1] = zio_data_buf_cache[c];
 	}
 
+	zio_batch_ksp = kstat_create("zfs", 0, "zio_batch", "misc",
+	    KSTAT_TYPE_NAMED, sizeof (zio_batch_stats) /
+	    sizeof (kstat_named_t), KSTAT_FLAG_VIRTUAL);
+	if (zio_batch_ksp != NULL) {
+		zio_batch_ksp->ks_data = &zio_batch_stats;
+		kstat_install(zio_batch_ksp);
+	}
+
 	zio_inject_init();
 }
 
@@ -217,6 +264,11 @@ zio_fini(void)
 	kmem_cache_destroy(zio_link_cache);
 	kmem_cache_destroy(zio_cache);
 
+	if (zio_batch_ksp != NULL) {
+		kstat_delete(zio_batch_ksp);
+		zio_batch_ksp = NULL;
+	}
+
 	zio_inject_fini();
 }
 
@@ -1671,6 +1723,58 @@ zio_free_bp_init(zio_t *zio)
  * ==========================================================================
  */
 
+/*
+ * Drain one CPU's batch of dispatched zios.  This runs on the taskq the
+ * zios were bound for, so zio_taskq_member() sees the same executor it
+ * would have if each zio had been dispatched individually.
+ */
+static void
+zio_batch_exec(void *arg)
+{
+	zio_dispatch_batch_t *zdb = arg;
+
+	for (;;) {
+		zio_t *zio = atomic_swap_ptr(&zdb->zdb_list, NULL);
+		zio_t *rev = NULL;
+		uint64_t count = 0;
+
+		if (zio == NULL) {
+			/*
+			 * Clear the scheduled flag, then recheck the list:
+			 * a producer may have pushed a zio after our swap
+			 * but seen the flag still set, in which case it did
+			 * not dispatch a new drain task and we must pick
+			 * the zio up ourselves.
+			 */
+			zdb->zdb_scheduled = 0;
+			membar_enter();
+			if (zdb->zdb_list == NULL ||
+			    atomic_cas_32(&zdb->zdb_scheduled, 0, 1) != 0)
+				return;
+			continue;
+		}
+
+		/* The list is pushed LIFO; reverse it to dispatch order. */
+		while (zio != NULL) {
+			zio_t *next = zio->io_batch_next;
+			zio->io_batch_next = rev;
+			rev = zio;
+			zio = next;
+		}
+		while (rev != NULL) {
+			zio_t *next = rev->io_batch_next;
+			rev->io_batch_next = NULL;
+			zio_execute(rev);
+			rev = next;
+			count++;
+		}
+
+		ZIO_BATCH_STAT_ADD(batch_runs, 1);
+		ZIO_BATCH_STAT_ADD(batch_zios, count);
+		ZIO_BATCH_STAT_MAX(batch_max, count);
+	}
+}
+
 static void
 zio_taskq_dispatch(zio_t *zio, zio_taskq_type_t q, boolean_t cutinline)
 {
@@ -1703,6 +1807,29 @@ zio_taskq_dispatch(zio_t *zio, zio_taskq_type_t q, boolean_t cutinline)
 
 	ASSERT3U(q, <, ZIO_TASKQ_TYPES);
 
+	/*
+	 * Push interrupt-side dispatches onto a per-CPU batch, so a burst
+	 * of completions is drained by a single task.  Cut-in-line
+	 * dispatches keep the direct path, since they want TQ_FRONT.
+	 */
+	spa_taskqs_t *tqs = &spa->spa_zio_taskq[t][q];
+	if (!cutinline && tqs->stqs_batch != NULL) {
+		zio_dispatch_batch_t *zdb = &tqs->stqs_batch[CPU_SEQID];
+		zio_t *head;
+
+		ASSERT3P(zio->io_batch_next, ==, NULL);
+		do {
+			head = zdb->zdb_list;
+			zio->io_batch_next = head;
+		} while (atomic_cas_ptr(&zdb->zdb_list, head, zio) != head);
+
+		if (atomic_cas_32(&zdb->zdb_scheduled, 0, 1) == 0) {
+			spa_taskq_dispatch_ent(spa, t, q, zio_batch_exec,
+			    zdb, 0, &zdb->zdb_tqent);
+		}
+		return;
+	}
+
 	/*
 	 * NB: We are assuming that the zio can only be dispatched
 	 * to a single taskq at a time.  It would be a grievous error
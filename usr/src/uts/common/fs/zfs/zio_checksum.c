@@ -120,14 +120,96 @@ abd_fletcher_2_byteswap(abd_t *abd, uint64_t size,
 	    fletcher_2_incremental_byteswap, zcp);
 }
 
+/*
+ * Fletcher-4 over an abd is computed with the selected vectorized
+ * implementation, carrying the multi-lane context from chunk to chunk.
+ * If a chunk ends on an alignment the vector kernels cannot resume
+ * from, the context is folded into a scalar checksum and the remainder
+ * of the iteration continues with the scalar code.
+ */
+typedef struct abd_fletcher_4_data {
+	const fletcher_4_ops_t	*afd_ops;
+	boolean_t		afd_native;
+	fletcher_4_ctx_t	afd_ctx;
+} abd_fletcher_4_data_t;
+
+static void
+abd_fletcher_4_simd_to_scalar(abd_fletcher_4_data_t *afd)
+{
+	zio_cksum_t cksum;
+
+	ASSERT3P(afd->afd_ops, !=, &fletcher_4_scalar_ops);
+
+	if (afd->afd_native)
+		afd->afd_ops->fini_native(&afd->afd_ctx, &cksum);
+	else
+		afd->afd_ops->fini_byteswap(&afd->afd_ctx, &cksum);
+	afd->afd_ctx.scalar = cksum;
+	afd->afd_ops = &fletcher_4_scalar_ops;
+}
+
+static int
+abd_fletcher_4_iter(void *data, size_t size, void *private)
+{
+	abd_fletcher_4_data_t *afd = private;
+	uint64_t asize = P2ALIGN(size, FLETCHER_MIN_SIMD_SIZE);
+
+	ASSERT(IS_P2ALIGNED(size, sizeof (uint32_t)));
+
+	if (afd->afd_ops != &fletcher_4_scalar_ops && asize > 0) {
+		if (afd->afd_native) {
+			afd->afd_ops->compute_native(&afd->afd_ctx,
+			    data, asize);
+		} else {
+			afd->afd_ops->compute_byteswap(&afd->afd_ctx,
+			    data, asize);
+		}
+		data = (char *)data + asize;
+		size -= asize;
+	}
+
+	if (size > 0) {
+		if (afd->afd_ops != &fletcher_4_scalar_ops)
+			abd_fletcher_4_simd_to_scalar(afd);
+		if (afd->afd_native) {
+			(void) fletcher_4_incremental_native(data, size,
+			    &afd->afd_ctx.scalar);
+		} else {
+			(void) fletcher_4_incremental_byteswap(data, size,
+			    &afd->afd_ctx.scalar);
+		}
+	}
+
+	return (0);
+}
+
+static void
+abd_fletcher_4_impl(abd_t *abd, uint64_t size, zio_cksum_t *zcp,
+    boolean_t native)
+{
+	abd_fletcher_4_data_t afd;
+
+	afd.afd_ops = fletcher_4_impl_get();
+	afd.afd_native = native;
+	if (native)
+		afd.afd_ops->init_native(&afd.afd_ctx);
+	else
+		afd.afd_ops->init_byteswap(&afd.afd_ctx);
+
+	(void) abd_iterate_func(abd, 0, size, abd_fletcher_4_iter, &afd);
+
+	if (native)
+		afd.afd_ops->fini_native(&afd.afd_ctx, zcp);
+	else
+		afd.afd_ops->fini_byteswap(&afd.afd_ctx, zcp);
+}
+
 /*ARGSUSED*/
 void
 abd_fletcher_4_native(abd_t *abd, uint64_t size,
     const void *ctx_template, zio_cksum_t *zcp)
 {
-	fletcher_init(zcp);
-	(void) abd_iterate_func(abd, 0, size,
-	    fletcher_4_incremental_native, zcp);
+	abd_fletcher_4_impl(abd, size, zcp, B_TRUE);
 }
 
 /*ARGSUSED*/
@@ -135,9 +217,7 @@ void
 abd_fletcher_4_byteswap(abd_t *abd, uint64_t size,
     const void *ctx_template, zio_cksum_t *zcp)
 {
-	fletcher_init(zcp);
-	(void) abd_iterate_func(abd, 0, size,
-	    fletcher_4_incremental_byteswap, zcp);
+	abd_fletcher_4_impl(abd, size, zcp, B_FALSE);
 }
 
 zio_checksum_info_t zio_checksum_table[ZIO_CHECKSUM_FUNCTIONS] = {
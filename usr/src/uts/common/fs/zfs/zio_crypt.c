@@ -211,6 +211,50 @@ zio_crypt_info_t zio_crypt_table[ZIO_CRYPT_FUNCTIONS] = {
 	{SUN_CKM_AES_GCM,	ZC_TYPE_GCM,	32,	"aes-256-gcm"}
 };
 
+/*
+ * Cached KCF mechanism ids, resolved on first use.  crypto_mech2id() walks
+ * the provider mechanism tables under lock on every call, which is wasted
+ * work in per-block paths such as zio_do_crypt_uio(): the id for a given
+ * mechanism name never changes once a provider for it has been found.
+ */
+static crypto_mech_type_t zio_crypt_mech_cache[ZIO_CRYPT_FUNCTIONS] = {
+	CRYPTO_MECH_INVALID, CRYPTO_MECH_INVALID, CRYPTO_MECH_INVALID,
+	CRYPTO_MECH_INVALID, CRYPTO_MECH_INVALID, CRYPTO_MECH_INVALID,
+	CRYPTO_MECH_INVALID, CRYPTO_MECH_INVALID, CRYPTO_MECH_INVALID
+};
+static crypto_mech_type_t zio_crypt_hmac_mech = CRYPTO_MECH_INVALID;
+
+static crypto_mech_type_t
+zio_crypt_lookup_mech(uint64_t crypt)
+{
+	crypto_mech_type_t mechid;
+
+	ASSERT3U(crypt, <, ZIO_CRYPT_FUNCTIONS);
+
+	mechid = zio_crypt_mech_cache[crypt];
+	if (mechid == CRYPTO_MECH_INVALID) {
+		mechid = crypto_mech2id(zio_crypt_table[crypt].ci_mechname);
+		if (mechid != CRYPTO_MECH_INVALID)
+			zio_crypt_mech_cache[crypt] = mechid;
+	}
+
+	return (mechid);
+}
+
+static crypto_mech_type_t
+zio_crypt_lookup_hmac_mech(void)
+{
+	crypto_mech_type_t mechid = zio_crypt_hmac_mech;
+
+	if (mechid == CRYPTO_MECH_INVALID) {
+		mechid = crypto_mech2id(SUN_CKM_SHA512_HMAC);
+		if (mechid != CRYPTO_MECH_INVALID)
+			zio_crypt_hmac_mech = mechid;
+	}
+
+	return (mechid);
+}
+
 void
 zio_crypt_key_destroy(zio_crypt_key_t *key)
 {
@@ -274,13 +318,13 @@ zio_crypt_key_init(uint64_t crypt, zio_crypt_key_t *key)
 	 * Initialize the crypto templates. It's ok if this fails because
 	 * this is just an optimization.
 	 */
-	mech.cm_type = crypto_mech2id(zio_crypt_table[crypt].ci_mechname);
+	mech.cm_type = zio_crypt_lookup_mech(crypt);
 	ret = crypto_create_ctx_template(&mech, &key->zk_current_key,
 	    &key->zk_current_tmpl, KM_SLEEP);
 	if (ret != CRYPTO_SUCCESS)
 		key->zk_current_tmpl = NULL;
 
-	mech.cm_type = crypto_mech2id(SUN_CKM_SHA512_HMAC);
+	mech.cm_type = zio_crypt_lookup_hmac_mech();
 	ret = crypto_create_ctx_template(&mech, &key->zk_hmac_key,
 	    &key->zk_hmac_tmpl, KM_SLEEP);
 	if (ret != CRYPTO_SUCCESS)
@@ -329,6 +373,7 @@ zio_crypt_key_change_salt(zio_crypt_key_t *key)
 
 	/* destroy the old context template and create the new one */
 	crypto_destroy_ctx_template(key->zk_current_tmpl);
+	mech.cm_type = zio_crypt_lookup_mech(key->zk_crypt);
 	ret = crypto_create_ctx_template(&mech, &key->zk_current_key,
 	    &key->zk_current_tmpl, KM_SLEEP);
 	if (ret != CRYPTO_SUCCESS)
@@ -407,7 +452,7 @@ zio_do_crypt_uio(boolean_t encrypt, uint64_t crypt, crypto_key_t *key,
 	ASSERT(maclen <= ZIO_DATA_MAC_LEN);
 
 	/* setup encryption mechanism (same as crypt) */
-	mech.cm_type = crypto_mech2id(crypt_info.ci_mechname);
+	mech.cm_type = zio_crypt_lookup_mech(crypt);
 
 	/*
 	 * Strangely, the ICP requires that plain_full_len must include
@@ -639,13 +684,13 @@ zio_crypt_key_unwrap(crypto_key_t *cwkey, uint64_t crypt, uint64_t version,
 	 * Initialize the crypto templates. It's ok if this fails because
 	 * this is just an optimization.
 	 */
-	mech.cm_type = crypto_mech2id(zio_crypt_table[crypt].ci_mechname);
+	mech.cm_type = zio_crypt_lookup_mech(crypt);
 	ret = crypto_create_ctx_template(&mech, &key->zk_current_key,
 	    &key->zk_current_tmpl, KM_SLEEP);
 	if (ret != CRYPTO_SUCCESS)
 		key->zk_current_tmpl = NULL;
 
-	mech.cm_type = crypto_mech2id(SUN_CKM_SHA512_HMAC);
+	mech.cm_type = zio_crypt_lookup_hmac_mech();
 	ret = crypto_create_ctx_template(&mech, &key->zk_hmac_key,
 	    &key->zk_hmac_tmpl, KM_SLEEP);
 	if (ret != CRYPTO_SUCCESS)
@@ -692,7 +737,7 @@ zio_crypt_do_hmac(zio_crypt_key_t *key, uint8_t *data, uint_t datalen,
 	ASSERT3U(digestlen, <=, SHA512_DIGEST_LENGTH);
 
 	/* initialize sha512-hmac mechanism and crypto data */
-	mech.cm_type = crypto_mech2id(SUN_CKM_SHA512_HMAC);
+	mech.cm_type = zio_crypt_lookup_hmac_mech();
 	mech.cm_param = NULL;
 	mech.cm_param_len = 0;
 
@@ -1147,7 +1192,7 @@ zio_crypt_do_objset_hmacs(zio_crypt_key_t *key, void *data, uint_t datalen,
 	uint8_t raw_local_mac[SHA512_DIGEST_LENGTH];
 
 	/* initialize HMAC mechanism */
-	mech.cm_type = crypto_mech2id(SUN_CKM_SHA512_HMAC);
+	mech.cm_type = zio_crypt_lookup_hmac_mech();
 	mech.cm_param = NULL;
 	mech.cm_param_len = 0;
 
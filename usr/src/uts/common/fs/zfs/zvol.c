@@ -48,6 +48,7 @@
 #include <sys/errno.h>
 #include <sys/uio.h>
 #include <sys/buf.h>
+#include <sys/aio_req.h>
 #include <sys/modctl.h>
 #include <sys/open.h>
 #include <sys/kmem.h>
@@ -113,6 +114,22 @@ typedef struct zvol_extent {
 	uint64_t	ze_nblks;	/* number of blocks in extent */
 } zvol_extent_t;
 
+/*
+ * The range lock for each volume is sharded by offset so that the
+ * lock's internal mutex does not become a single point of contention
+ * when many threads are doing I/O to one hot volume. A locked range
+ * covers every shard its offsets stripe across, taken in ascending
+ * shard order, so any two overlapping ranges always meet in the shard
+ * containing the overlap.
+ */
+#define	ZVOL_RL_SHARDS		8
+#define	ZVOL_RL_SHARD_SHIFT	26	/* 64MB stripes */
+
+struct zvol_locked_range {
+	locked_range_t	*zlr_locks[ZVOL_RL_SHARDS];
+	int		zlr_count;
+};
+
 /*
  * The in-core state of each volume.
  */
@@ -128,7 +145,7 @@ typedef struct zvol_state {
 	uint32_t	zv_total_opens;	/* total open count */
 	zilog_t		*zv_zilog;	/* ZIL handle */
 	list_t		zv_extents;	/* List of extents for dump */
-	rangelock_t	zv_rangelock;
+	rangelock_t	zv_rangelock[ZVOL_RL_SHARDS];
 	dnode_t		*zv_dn;		/* dnode hold */
 } zvol_state_t;
 
@@ -145,6 +162,39 @@ typedef struct zvol_state {
  */
 int zvol_maxphys = DMU_MAX_ACCESS/2;
 
+/*
+ * zvol block I/O is normally handed off to a set of per-CPU taskqs so
+ * that a single busy volume can make use of every core rather than
+ * being limited by the submission thread. Setting zvol_request_sync
+ * reverts to executing each I/O in the context of the thread that
+ * submitted it.
+ */
+boolean_t zvol_request_sync = B_FALSE;
+
+/*
+ * Maximum number of per-CPU zvol submission queues; the actual number
+ * is the lesser of this and the number of CPUs on the system.
+ */
+#define	ZVOL_MAX_QUEUES		16
+
+typedef struct zvol_queue {
+	taskq_t		*zq_taskq;
+	uint64_t	zq_dispatched;	/* total I/Os handed to this queue */
+	uint64_t	zq_completed;	/* total I/Os finished */
+	uint64_t	zq_lat_ns;	/* cumulative dispatch-to-done time */
+} zvol_queue_t;
+
+typedef struct zvol_task {
+	buf_t		*zt_bp;
+	zvol_queue_t	*zt_queue;
+	hrtime_t	zt_dispatch_time;
+} zvol_task_t;
+
+static zvol_queue_t *zvol_queues;
+static uint_t zvol_nqueues;
+static kstat_t *zvol_queue_ksp;
+static kstat_named_t *zvol_queue_kstat_data;
+
 /*
  * Toggle unmap functionality.
  */
@@ -181,6 +231,47 @@ zvol_size_changed(zvol_state_t *zv, uint64_t volsize)
 	spec_size_invalidate(dev, VCHR);
 }
 
+/*
+ * Lock a range of the volume. The handle is the volume's shard array;
+ * external callers get it from zvol_get_volume_params(). The range is
+ * entered in every shard it stripes across, in ascending shard order
+ * so that concurrent multi-shard lockers cannot deadlock.
+ */
+zvol_locked_range_t *
+zvol_rangelock_enter(void *rl_hdl, uint64_t off, uint64_t len,
+    rangelock_type_t type)
+{
+	rangelock_t *shards = rl_hdl;
+	zvol_locked_range_t *zlr;
+	uint64_t first, nstripes;
+	boolean_t covered[ZVOL_RL_SHARDS] = { B_FALSE };
+
+	zlr = kmem_zalloc(sizeof (*zlr), KM_SLEEP);
+
+	first = off >> ZVOL_RL_SHARD_SHIFT;
+	nstripes = ((off + MAX(len, 1) - 1) >> ZVOL_RL_SHARD_SHIFT) -
+	    first + 1;
+	for (uint64_t i = 0; i < MIN(nstripes, ZVOL_RL_SHARDS); i++)
+		covered[(first + i) % ZVOL_RL_SHARDS] = B_TRUE;
+
+	for (int s = 0; s < ZVOL_RL_SHARDS; s++) {
+		if (covered[s]) {
+			zlr->zlr_locks[zlr->zlr_count++] =
+			    rangelock_enter(&shards[s], off, len, type);
+		}
+	}
+
+	return (zlr);
+}
+
+void
+zvol_rangelock_exit(zvol_locked_range_t *zlr)
+{
+	for (int i = zlr->zlr_count - 1; i >= 0; i--)
+		rangelock_exit(zlr->zlr_locks[i]);
+	kmem_free(zlr, sizeof (*zlr));
+}
+
 int
 zvol_check_volsize(uint64_t volsize, uint64_t blocksize)
 {
@@ -554,7 +645,8 @@ zvol_create_minor(const char *name)
 	zv->zv_objset = os;
 	if (dmu_objset_is_snapshot(os) || !spa_writeable(dmu_objset_spa(os)))
 		zv->zv_flags |= ZVOL_RDONLY;
-	rangelock_init(&zv->zv_rangelock, NULL, NULL);
+	for (int i = 0; i < ZVOL_RL_SHARDS; i++)
+		rangelock_init(&zv->zv_rangelock[i], NULL, NULL);
 	list_create(&zv->zv_extents, sizeof (zvol_extent_t),
 	    offsetof(zvol_extent_t, ze_node));
 	/* get and cache the blocksize */
@@ -597,7 +689,8 @@ zvol_remove_zv(zvol_state_t *zv)
 	(void) snprintf(nmbuf, sizeof (nmbuf), "%u", minor);
 	ddi_remove_minor_node(zfs_dip, nmbuf);
 
-	rangelock_fini(&zv->zv_rangelock);
+	for (int i = 0; i < ZVOL_RL_SHARDS; i++)
+		rangelock_fini(&zv->zv_rangelock[i]);
 
 	kmem_free(zv, sizeof (zvol_state_t));
 
@@ -975,7 +1068,8 @@ zvol_get_done(zgd_t *zgd, int error)
 	if (zgd->zgd_db)
 		dmu_buf_rele(zgd->zgd_db, zgd);
 
-	rangelock_exit(zgd->zgd_lr);
+	/* zgd_lr carries the sharded lock handle; see zvol_get_data() */
+	zvol_rangelock_exit((zvol_locked_range_t *)zgd->zgd_lr);
 
 	kmem_free(zgd, sizeof (zgd_t));
 }
@@ -1007,9 +1101,14 @@ zvol_get_data(void *arg, lr_write_t *lr, char *buf, struct lwb *lwb, zio_t *zio)
 	 * sync the data and get a pointer to it (indirect) so that
 	 * we don't have to write the data twice.
 	 */
+	/*
+	 * The zvol range lock is sharded, so zgd_lr holds a
+	 * zvol_locked_range_t rather than a bare locked_range_t.
+	 * It is only ever dereferenced by zvol_get_done() above.
+	 */
 	if (buf != NULL) { /* immediate write */
-		zgd->zgd_lr = rangelock_enter(&zv->zv_rangelock, offset, size,
-		    RL_READER);
+		zgd->zgd_lr = (locked_range_t *)zvol_rangelock_enter(
+		    zv->zv_rangelock, offset, size, RL_READER);
 		error = dmu_read_by_dnode(zv->zv_dn, offset, size, buf,
 		    DMU_READ_NO_PREFETCH);
 	} else { /* indirect write */
@@ -1021,8 +1120,8 @@ zvol_get_data(void *arg, lr_write_t *lr, char *buf, struct lwb *lwb, zio_t *zio)
 		 */
 		size = zv->zv_volblocksize;
 		offset = P2ALIGN(offset, size);
-		zgd->zgd_lr = rangelock_enter(&zv->zv_rangelock, offset, size,
-		    RL_READER);
+		zgd->zgd_lr = (locked_range_t *)zvol_rangelock_enter(
+		    zv->zv_rangelock, offset, size, RL_READER);
 		error = dmu_buf_hold_by_dnode(zv->zv_dn, offset, zgd, &db,
 		    DMU_READ_NO_PREFETCH);
 		if (error == 0) {
@@ -1170,8 +1269,8 @@ zvol_dumpio(zvol_state_t *zv, void *addr, uint64_t offset, uint64_t size,
 	return (error);
 }
 
-int
-zvol_strategy(buf_t *bp)
+static int
+zvol_strategy_impl(buf_t *bp)
 {
 	zfs_soft_state_t *zs = NULL;
 	zvol_state_t *zv;
@@ -1225,7 +1324,16 @@ zvol_strategy(buf_t *bp)
 	}
 
 	is_dumpified = zv->zv_flags & ZVOL_DUMPIFIED;
-	sync = ((!(bp->b_flags & B_ASYNC) &&
+
+	/*
+	 * B_ASYNC normally indicates a caller (e.g. a filesystem on top
+	 * of the zvol) that manages its own flushing, so such writes only
+	 * go through the ZIL when sync=always.  Raw async I/O from the
+	 * kaio path (zvol_awrite() via aphysio()) carries B_PHYS as well;
+	 * there the caller expects write(2) durability at biodone(), so
+	 * honor the write cache setting just as zvol_write() would.
+	 */
+	sync = (((!(bp->b_flags & B_ASYNC) || (bp->b_flags & B_PHYS)) &&
 	    !(zv->zv_flags & ZVOL_WCE)) ||
 	    (zv->zv_objset->os_sync == ZFS_SYNC_ALWAYS)) &&
 	    !doread && !is_dumpified;
@@ -1236,8 +1344,8 @@ zvol_strategy(buf_t *bp)
 	 * There must be no buffer changes when doing a dmu_sync() because
 	 * we can't change the data whilst calculating the checksum.
 	 */
-	locked_range_t *lr = rangelock_enter(&zv->zv_rangelock, off, resid,
-	    doread ? RL_READER : RL_WRITER);
+	zvol_locked_range_t *zlr = zvol_rangelock_enter(zv->zv_rangelock,
+	    off, resid, doread ? RL_READER : RL_WRITER);
 
 	while (resid != 0 && off < volsize) {
 		size_t size = MIN(resid, zvol_maxphys);
@@ -1270,7 +1378,7 @@ zvol_strategy(buf_t *bp)
 		addr += size;
 		resid -= size;
 	}
-	rangelock_exit(lr);
+	zvol_rangelock_exit(zlr);
 
 	if ((bp->b_resid = resid) == bp->b_bcount)
 		bioerror(bp, off > volsize ? EINVAL : error);
@@ -1284,6 +1392,55 @@ zvol_strategy(buf_t *bp)
 	return (0);
 }
 
+static void
+zvol_strategy_task(void *arg)
+{
+	zvol_task_t *zt = arg;
+	zvol_queue_t *zq = zt->zt_queue;
+	hrtime_t start = zt->zt_dispatch_time;
+
+	(void) zvol_strategy_impl(zt->zt_bp);
+
+	atomic_add_64(&zq->zq_lat_ns, gethrtime() - start);
+	atomic_inc_64(&zq->zq_completed);
+	kmem_free(zt, sizeof (*zt));
+}
+
+int
+zvol_strategy(buf_t *bp)
+{
+	zvol_task_t *zt;
+	zvol_queue_t *zq;
+
+	/*
+	 * Hand the I/O off to one of the per-CPU submission queues so
+	 * that a stream of requests from a single thread can be worked
+	 * on in parallel. Dump I/O (we may be in panic context) and
+	 * anything we can't dispatch is executed inline, exactly as
+	 * all I/O used to be.
+	 */
+	if (zvol_request_sync || zvol_nqueues == 0 || ddi_in_panic())
+		return (zvol_strategy_impl(bp));
+
+	zq = &zvol_queues[CPU->cpu_seqid % zvol_nqueues];
+	zt = kmem_alloc(sizeof (*zt), KM_NOSLEEP);
+	if (zt == NULL)
+		return (zvol_strategy_impl(bp));
+
+	zt->zt_bp = bp;
+	zt->zt_queue = zq;
+	zt->zt_dispatch_time = gethrtime();
+
+	if (taskq_dispatch(zq->zq_taskq, zvol_strategy_task, zt,
+	    TQ_NOSLEEP) == TASKQID_INVALID) {
+		kmem_free(zt, sizeof (*zt));
+		return (zvol_strategy_impl(bp));
+	}
+	atomic_inc_64(&zq->zq_dispatched);
+
+	return (0);
+}
+
 /*
  * Set the buffer count to the zvol maximum transfer.
  * Using our own routine instead of the default minphys()
@@ -1360,7 +1517,7 @@ zvol_read(dev_t dev, uio_t *uio, cred_t *cr)
 
 	smt_begin_unsafe();
 
-	locked_range_t *lr = rangelock_enter(&zv->zv_rangelock,
+	zvol_locked_range_t *zlr = zvol_rangelock_enter(zv->zv_rangelock,
 	    uio->uio_loffset, uio->uio_resid, RL_READER);
 	while (uio->uio_resid > 0 && uio->uio_loffset < volsize) {
 		uint64_t bytes = MIN(uio->uio_resid, DMU_MAX_ACCESS >> 1);
@@ -1369,7 +1526,7 @@ zvol_read(dev_t dev, uio_t *uio, cred_t *cr)
 		if (bytes > volsize - uio->uio_loffset)
 			bytes = volsize - uio->uio_loffset;
 
-		error =  dmu_read_uio(zv->zv_objset, ZVOL_OBJ, uio, bytes);
+		error = dmu_read_uio_dnode(zv->zv_dn, uio, bytes);
 		if (error) {
 			/* convert checksum errors into IO errors */
 			if (error == ECKSUM)
@@ -1377,7 +1534,7 @@ zvol_read(dev_t dev, uio_t *uio, cred_t *cr)
 			break;
 		}
 	}
-	rangelock_exit(lr);
+	zvol_rangelock_exit(zlr);
 
 	smt_end_unsafe();
 
@@ -1414,7 +1571,7 @@ zvol_write(dev_t dev, uio_t *uio, cred_t *cr)
 	sync = !(zv->zv_flags & ZVOL_WCE) ||
 	    (zv->zv_objset->os_sync == ZFS_SYNC_ALWAYS);
 
-	locked_range_t *lr = rangelock_enter(&zv->zv_rangelock,
+	zvol_locked_range_t *zlr = zvol_rangelock_enter(zv->zv_rangelock,
 	    uio->uio_loffset, uio->uio_resid, RL_WRITER);
 	while (uio->uio_resid > 0 && uio->uio_loffset < volsize) {
 		uint64_t bytes = MIN(uio->uio_resid, DMU_MAX_ACCESS >> 1);
@@ -1438,7 +1595,7 @@ zvol_write(dev_t dev, uio_t *uio, cred_t *cr)
 		if (error)
 			break;
 	}
-	rangelock_exit(lr);
+	zvol_rangelock_exit(zlr);
 
 	if (sync)
 		zil_commit(zv->zv_zilog, ZVOL_OBJ);
@@ -1448,6 +1605,58 @@ zvol_write(dev_t dev, uio_t *uio, cred_t *cr)
 	return (error);
 }
 
+/*
+ * Async (kaio) entry points.  aphysio() locks down the caller's buffer
+ * and hands a buf to zvol_strategy(), which queues the I/O and completes
+ * it via biodone(); the aio subsystem then delivers the result, posting
+ * directly to an event port if the request carried one.  This gives
+ * aio_read(3C)/lio_listio(3C) consumers of raw zvols a true in-kernel
+ * async path with no thread per outstanding I/O.
+ */
+/*ARGSUSED*/
+int
+zvol_aread(dev_t dev, struct aio_req *aio, cred_t *cr)
+{
+	minor_t minor = getminor(dev);
+	zvol_state_t *zv;
+	uint64_t volsize;
+	struct uio *uio = aio->aio_uio;
+
+	zv = zfsdev_get_soft_state(minor, ZSST_ZVOL);
+	if (zv == NULL)
+		return (SET_ERROR(ENXIO));
+
+	volsize = zv->zv_volsize;
+	if (uio->uio_resid > 0 &&
+	    (uio->uio_loffset < 0 || uio->uio_loffset >= volsize))
+		return (SET_ERROR(EIO));
+
+	return (aphysio(zvol_strategy, anocancel, dev, B_READ,
+	    zvol_minphys, aio));
+}
+
+/*ARGSUSED*/
+int
+zvol_awrite(dev_t dev, struct aio_req *aio, cred_t *cr)
+{
+	minor_t minor = getminor(dev);
+	zvol_state_t *zv;
+	uint64_t volsize;
+	struct uio *uio = aio->aio_uio;
+
+	zv = zfsdev_get_soft_state(minor, ZSST_ZVOL);
+	if (zv == NULL)
+		return (SET_ERROR(ENXIO));
+
+	volsize = zv->zv_volsize;
+	if (uio->uio_resid > 0 &&
+	    (uio->uio_loffset < 0 || uio->uio_loffset >= volsize))
+		return (SET_ERROR(EIO));
+
+	return (aphysio(zvol_strategy, anocancel, dev, B_WRITE,
+	    zvol_minphys, aio));
+}
+
 int
 zvol_getefi(void *arg, int flag, uint64_t vs, uint8_t bs)
 {
@@ -1533,7 +1742,7 @@ zvol_get_volume_params(minor_t minor, uint64_t *blksize,
 	*minor_hdl = zv;
 	*objset_hdl = zv->zv_objset;
 	*zil_hdl = zv->zv_zilog;
-	*rl_hdl = &zv->zv_rangelock;
+	*rl_hdl = zv->zv_rangelock;
 	*dnode_hdl = zv->zv_dn;
 	return (0);
 }
@@ -1612,7 +1821,7 @@ zvol_ioctl(dev_t dev, int cmd, intptr_t arg, int flag, cred_t *cr, int *rvalp)
 	zvol_state_t *zv;
 	struct dk_callback *dkc;
 	int i, error = 0;
-	locked_range_t *lr;
+	zvol_locked_range_t *lr;
 
 	mutex_enter(&zfsdev_state_lock);
 
@@ -1748,19 +1957,19 @@ zvol_ioctl(dev_t dev, int cmd, intptr_t arg, int flag, cred_t *cr, int *rvalp)
 		break;
 
 	case DKIOCDUMPINIT:
-		lr = rangelock_enter(&zv->zv_rangelock, 0, zv->zv_volsize,
+		lr = zvol_rangelock_enter(zv->zv_rangelock, 0, zv->zv_volsize,
 		    RL_WRITER);
 		error = zvol_dumpify(zv);
-		rangelock_exit(lr);
+		zvol_rangelock_exit(lr);
 		break;
 
 	case DKIOCDUMPFINI:
 		if (!(zv->zv_flags & ZVOL_DUMPIFIED))
 			break;
-		lr = rangelock_enter(&zv->zv_rangelock, 0, zv->zv_volsize,
+		lr = zvol_rangelock_enter(zv->zv_rangelock, 0, zv->zv_volsize,
 		    RL_WRITER);
 		error = zvol_dump_fini(zv);
-		rangelock_exit(lr);
+		zvol_rangelock_exit(lr);
 		break;
 
 	case DKIOCFREE:
@@ -1805,8 +2014,8 @@ zvol_ioctl(dev_t dev, int cmd, intptr_t arg, int flag, cred_t *cr, int *rvalp)
 				length = end - start;
 			}
 
-			lr = rangelock_enter(&zv->zv_rangelock, start, length,
-			    RL_WRITER);
+			lr = zvol_rangelock_enter(zv->zv_rangelock, start,
+			    length, RL_WRITER);
 			tx = dmu_tx_create(zv->zv_objset);
 			error = dmu_tx_assign(tx, TXG_WAIT);
 			if (error != 0) {
@@ -1819,7 +2028,7 @@ zvol_ioctl(dev_t dev, int cmd, intptr_t arg, int flag, cred_t *cr, int *rvalp)
 				    ZVOL_OBJ, start, length);
 			}
 
-			rangelock_exit(lr);
+			zvol_rangelock_exit(lr);
 
 			if (error != 0)
 				break;
@@ -1872,17 +2081,89 @@ zvol_busy(void)
 	return (zvol_minors != 0);
 }
 
+static int
+zvol_queue_kstat_update(kstat_t *ksp, int rw)
+{
+	kstat_named_t *kn = ksp->ks_data;
+
+	if (rw == KSTAT_WRITE)
+		return (EACCES);
+
+	for (uint_t i = 0; i < zvol_nqueues; i++) {
+		zvol_queue_t *zq = &zvol_queues[i];
+		uint64_t done = zq->zq_completed;
+
+		kn[3 * i].value.ui64 = zq->zq_dispatched;
+		kn[3 * i + 1].value.ui64 = zq->zq_dispatched - done;
+		kn[3 * i + 2].value.ui64 = zq->zq_lat_ns;
+	}
+
+	return (0);
+}
+
 void
 zvol_init(void)
 {
 	VERIFY(ddi_soft_state_init(&zfsdev_state, sizeof (zfs_soft_state_t),
 	    1) == 0);
 	mutex_init(&zfsdev_state_lock, NULL, MUTEX_DEFAULT, NULL);
+
+	zvol_nqueues = MIN(max_ncpus, ZVOL_MAX_QUEUES);
+	zvol_queues = kmem_zalloc(zvol_nqueues * sizeof (zvol_queue_t),
+	    KM_SLEEP);
+	for (uint_t i = 0; i < zvol_nqueues; i++) {
+		char name[32];
+
+		(void) snprintf(name, sizeof (name), "zvol_queue_%u", i);
+		zvol_queues[i].zq_taskq = taskq_create(name, 1, minclsyspri,
+		    1, INT_MAX, TASKQ_PREPOPULATE);
+	}
+
+	/*
+	 * Per-queue depth and cumulative latency, so that an unbalanced
+	 * or saturated submission queue can be spotted from userland.
+	 */
+	zvol_queue_kstat_data = kmem_zalloc(3 * zvol_nqueues *
+	    sizeof (kstat_named_t), KM_SLEEP);
+	for (uint_t i = 0; i < zvol_nqueues; i++) {
+		char name[KSTAT_STRLEN];
+
+		(void) snprintf(name, sizeof (name), "queue_%u_dispatched", i);
+		kstat_named_init(&zvol_queue_kstat_data[3 * i], name,
+		    KSTAT_DATA_UINT64);
+		(void) snprintf(name, sizeof (name), "queue_%u_depth", i);
+		kstat_named_init(&zvol_queue_kstat_data[3 * i + 1], name,
+		    KSTAT_DATA_UINT64);
+		(void) snprintf(name, sizeof (name), "queue_%u_lat_ns", i);
+		kstat_named_init(&zvol_queue_kstat_data[3 * i + 2], name,
+		    KSTAT_DATA_UINT64);
+	}
+	zvol_queue_ksp = kstat_create("zfs", 0, "zvol_queues", "misc",
+	    KSTAT_TYPE_NAMED, 3 * zvol_nqueues, KSTAT_FLAG_VIRTUAL);
+	if (zvol_queue_ksp != NULL) {
+		zvol_queue_ksp->ks_data = zvol_queue_kstat_data;
+		zvol_queue_ksp->ks_update = zvol_queue_kstat_update;
+		kstat_install(zvol_queue_ksp);
+	}
 }
 
 void
 zvol_fini(void)
 {
+	if (zvol_queue_ksp != NULL) {
+		kstat_delete(zvol_queue_ksp);
+		zvol_queue_ksp = NULL;
+	}
+	kmem_free(zvol_queue_kstat_data, 3 * zvol_nqueues *
+	    sizeof (kstat_named_t));
+	zvol_queue_kstat_data = NULL;
+
+	for (uint_t i = 0; i < zvol_nqueues; i++)
+		taskq_destroy(zvol_queues[i].zq_taskq);
+	kmem_free(zvol_queues, zvol_nqueues * sizeof (zvol_queue_t));
+	zvol_queues = NULL;
+	zvol_nqueues = 0;
+
 	mutex_destroy(&zfsdev_state_lock);
 	ddi_soft_state_fini(&zfsdev_state);
 }
@@ -0,0 +1,431 @@
+/*
+ * CDDL HEADER START
+ *
+ * The contents of this file are subject to the terms of the
+ * Common Development and Distribution License (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * You can obtain a copy of the license at usr/src/OPENSOLARIS.LICENSE
+ * or http://www.opensolaris.org/os/licensing.
+ * See the License for the specific language governing permissions
+ * and limitations under the License.
+ *
+ * When distributing Covered Code, include this CDDL HEADER in each
+ * file and include the License file at usr/src/OPENSOLARIS.LICENSE.
+ * If applicable, add the following below this CDDL HEADER, with the
+ * fields enclosed by brackets "[]" replaced with your own identifying
+ * information: Portions Copyright [yyyy] [name of copyright owner]
+ *
+ * CDDL HEADER END
+ */
+
+/*
+ * A rate-based, model-driven congestion control algorithm in the spirit
+ * of BBR (Bottleneck Bandwidth and Round-trip propagation time). The
+ * algorithm maintains an explicit model of the path: a windowed-max
+ * filter of the delivery rate observed over recent measurement rounds
+ * and a windowed-min filter of the round-trip time. The product of the
+ * two is the estimated bandwidth-delay product, and the congestion
+ * window tracks that estimate instead of reacting to loss, which makes
+ * it suitable for long-fat networks where loss-based algorithms
+ * (newreno, cubic) collapse the window on stray loss.
+ *
+ * This TCP has no transmit pacing machinery, so unlike reference BBR
+ * the model drives the congestion window only. To keep the lack of
+ * pacing from turning window jumps into line-rate bursts, cwnd is only
+ * ever raised by the number of bytes the current ACK covered (i.e.
+ * growth stays ACK-clocked); reductions take effect immediately. The
+ * steady state cycles a probe gain above and a drain gain below the
+ * measured BDP once per cycle to discover newly available bandwidth,
+ * standing in for reference BBR's pacing-gain cycle.
+ */
+
+#include <sys/errno.h>
+#include <sys/types.h>
+#include <sys/kmem.h>
+#include <sys/ddi.h>
+#include <sys/sunddi.h>
+#include <sys/modctl.h>
+#include <sys/time.h>
+#include <sys/sysmacros.h>
+
+#include <inet/tcp.h>
+#include <inet/tcp_impl.h>
+#include <inet/cc.h>
+#include <inet/cc/cc_module.h>
+
+static struct modlmisc cc_bbr_modlmisc = {
+	&mod_miscops,
+	"BBR Congestion Control"
+};
+
+static struct modlinkage cc_bbr_modlinkage = {
+	MODREV_1,
+	&cc_bbr_modlmisc,
+	NULL
+};
+
+/*
+ * bbr uses the NewReno implementation of ack_received while the pipe is
+ * still being filled, and NewReno's after_idle restart window to avoid
+ * an unpaced burst when transmission resumes.
+ */
+static struct cc_algo *newreno_cc_algo;
+
+static void	bbr_ack_received(struct cc_var *ccv, uint16_t type);
+static void	bbr_after_idle(struct cc_var *ccv);
+static void	bbr_cb_destroy(struct cc_var *ccv);
+static int	bbr_cb_init(struct cc_var *ccv);
+static void	bbr_cong_signal(struct cc_var *ccv, uint32_t type);
+static void	bbr_conn_init(struct cc_var *ccv);
+static void	bbr_post_recovery(struct cc_var *ccv);
+static void	bbr_model_update(struct cc_var *ccv);
+static uint32_t	bbr_target_cwnd(struct cc_var *ccv, uint_t gain);
+
+/* Length of the windowed-max bandwidth filter, in measurement rounds. */
+#define	BBR_BW_WINDOW		10
+
+/* Rounds without 25% bandwidth growth before the pipe counts as full. */
+#define	BBR_FULL_BW_ROUNDS	3
+
+/* Gains are expressed in percent of the estimated BDP. */
+#define	BBR_GAIN_UNIT		100
+
+/*
+ * The steady-state gain cycle: one round probing above the estimated
+ * BDP, one round draining the queue the probe may have built, and six
+ * rounds cruising at the estimate.
+ */
+static const uint_t bbr_gain_cycle[] = {
+	125, 75, 100, 100, 100, 100, 100, 100
+};
+#define	BBR_GAIN_CYCLE_LEN \
+	(sizeof (bbr_gain_cycle) / sizeof (bbr_gain_cycle[0]))
+
+/*
+ * A min RTT sample older than this is considered stale and is replaced
+ * by the next sample regardless of its value, so that the model tracks
+ * route changes.
+ */
+uint_t bbr_minrtt_expiry_sec = 10;
+
+struct bbr {
+	/* Delivery rate samples, bytes per second, one per round. */
+	uint64_t	bw_samples[BBR_BW_WINDOW];
+	/* Windowed-max of bw_samples. */
+	uint64_t	max_bw;
+	/* Minimum observed rtt in nanoseconds. */
+	hrtime_t	min_rtt_nsecs;
+	/* Time the min rtt sample was taken. */
+	hrtime_t	min_rtt_stamp;
+	/* Start of the current measurement round. */
+	hrtime_t	round_start;
+	/* Bytes acked during the current measurement round. */
+	uint64_t	round_bytes;
+	/* Completed measurement rounds. */
+	uint32_t	round_count;
+	/* Bandwidth at the last pipe-full check. */
+	uint64_t	full_bw;
+	/* Rounds since the last 25% bandwidth growth. */
+	uint32_t	full_bw_cnt;
+	/* B_TRUE once bandwidth growth has levelled off. */
+	boolean_t	pipe_filled;
+};
+
+struct cc_algo bbr_cc_algo = {
+	.name = "bbr",
+	.ack_received = bbr_ack_received,
+	.after_idle = bbr_after_idle,
+	.cb_destroy = bbr_cb_destroy,
+	.cb_init = bbr_cb_init,
+	.cong_signal = bbr_cong_signal,
+	.conn_init = bbr_conn_init,
+	.post_recovery = bbr_post_recovery,
+};
+
+int
+_init(void)
+{
+	int err;
+
+	if ((newreno_cc_algo = cc_load_algo("newreno")) == NULL)
+		return (EINVAL);
+
+	if ((err = cc_register_algo(&bbr_cc_algo)) == 0) {
+		if ((err = mod_install(&cc_bbr_modlinkage)) != 0)
+			(void) cc_deregister_algo(&bbr_cc_algo);
+	}
+
+	return (err);
+}
+
+int
+_fini(void)
+{
+	/* XXX Not unloadable for now */
+	return (EBUSY);
+}
+
+int
+_info(struct modinfo *modinfop)
+{
+	return (mod_info(&cc_bbr_modlinkage, modinfop));
+}
+
+static int
+bbr_cb_init(struct cc_var *ccv)
+{
+	struct bbr *bbr_data;
+
+	bbr_data = kmem_zalloc(sizeof (struct bbr), KM_NOSLEEP);
+
+	if (bbr_data == NULL)
+		return (ENOMEM);
+
+	bbr_data->min_rtt_nsecs = TCPTV_SRTTBASE;
+	bbr_data->round_start = gethrtime();
+
+	ccv->cc_data = bbr_data;
+
+	return (0);
+}
+
+static void
+bbr_cb_destroy(struct cc_var *ccv)
+{
+	if (ccv->cc_data != NULL)
+		kmem_free(ccv->cc_data, sizeof (struct bbr));
+}
+
+static void
+bbr_conn_init(struct cc_var *ccv)
+{
+	struct bbr *bbr_data;
+
+	bbr_data = ccv->cc_data;
+	bbr_data->round_start = gethrtime();
+	bbr_data->round_bytes = 0;
+}
+
+/*
+ * Estimated BDP scaled by the given gain, bounded below by four
+ * segments so the ACK clock cannot starve and above by the largest
+ * usable window.
+ */
+static uint32_t
+bbr_target_cwnd(struct cc_var *ccv, uint_t gain)
+{
+	struct bbr *bbr_data;
+	uint64_t bdp;
+	uint32_t mss;
+
+	bbr_data = ccv->cc_data;
+	mss = CCV(ccv, tcp_mss);
+
+	bdp = (bbr_data->max_bw * (uint64_t)bbr_data->min_rtt_nsecs) / NANOSEC;
+	bdp = (bdp * gain) / BBR_GAIN_UNIT;
+
+	bdp = MAX(bdp, 4 * (uint64_t)mss);
+	bdp = MIN(bdp, (uint64_t)TCP_MAXWIN << CCV(ccv, tcp_snd_ws));
+
+	return ((uint32_t)bdp);
+}
+
+/*
+ * Feed the current ACK into the path model: fold the smoothed RTT into
+ * the min filter and, once a full measurement round (one min RTT) has
+ * elapsed, turn the bytes acked during the round into a delivery rate
+ * sample for the windowed-max bandwidth filter.
+ */
+static void
+bbr_model_update(struct cc_var *ccv)
+{
+	struct bbr *bbr_data;
+	hrtime_t now, interval, t_srtt_nsecs;
+	uint64_t sample;
+	uint_t i;
+
+	bbr_data = ccv->cc_data;
+	now = gethrtime();
+
+	if (CCV(ccv, tcp_rtt_update) > 0) {
+		/* tcp_rtt_sa is 8 * smoothed RTT in nanoseconds */
+		t_srtt_nsecs = CCV(ccv, tcp_rtt_sa) >> 3;
+		if (t_srtt_nsecs > 0 &&
+		    (t_srtt_nsecs < bbr_data->min_rtt_nsecs ||
+		    bbr_data->min_rtt_nsecs == TCPTV_SRTTBASE ||
+		    now - bbr_data->min_rtt_stamp >
+		    (hrtime_t)bbr_minrtt_expiry_sec * NANOSEC)) {
+			bbr_data->min_rtt_nsecs = t_srtt_nsecs;
+			bbr_data->min_rtt_stamp = now;
+		}
+	}
+
+	if (bbr_data->min_rtt_nsecs == TCPTV_SRTTBASE)
+		return;
+
+	bbr_data->round_bytes += ccv->bytes_this_ack;
+
+	interval = now - bbr_data->round_start;
+	if (interval < bbr_data->min_rtt_nsecs || interval <= 0)
+		return;
+
+	sample = (bbr_data->round_bytes * NANOSEC) / (uint64_t)interval;
+	bbr_data->bw_samples[bbr_data->round_count % BBR_BW_WINDOW] = sample;
+	bbr_data->round_count++;
+	bbr_data->round_start = now;
+	bbr_data->round_bytes = 0;
+
+	bbr_data->max_bw = 0;
+	for (i = 0; i < BBR_BW_WINDOW; i++) {
+		if (bbr_data->bw_samples[i] > bbr_data->max_bw)
+			bbr_data->max_bw = bbr_data->bw_samples[i];
+	}
+
+	/*
+	 * Startup ends once three consecutive rounds fail to grow the
+	 * bandwidth estimate by at least 25%.
+	 */
+	if (!bbr_data->pipe_filled) {
+		if (sample >= bbr_data->full_bw + (bbr_data->full_bw >> 2)) {
+			bbr_data->full_bw = sample;
+			bbr_data->full_bw_cnt = 0;
+		} else if (++bbr_data->full_bw_cnt >= BBR_FULL_BW_ROUNDS) {
+			bbr_data->pipe_filled = B_TRUE;
+		}
+	}
+}
+
+static void
+bbr_ack_received(struct cc_var *ccv, uint16_t type)
+{
+	struct bbr *bbr_data;
+	uint32_t target;
+	uint_t gain;
+
+	bbr_data = ccv->cc_data;
+	bbr_model_update(ccv);
+
+	if (type != CC_ACK || IN_RECOVERY(ccv->flags) ||
+	    !(ccv->flags & CCF_CWND_LIMITED))
+		return;
+
+	/*
+	 * While the pipe is still being filled (or before the model has
+	 * any bandwidth sample at all), grow the window exponentially
+	 * the way NewReno slow start does; the model runs alongside and
+	 * will take over once bandwidth growth levels off.
+	 */
+	if (!bbr_data->pipe_filled || bbr_data->max_bw == 0) {
+		newreno_cc_algo->ack_received(ccv, type);
+		return;
+	}
+
+	gain = bbr_gain_cycle[bbr_data->round_count % BBR_GAIN_CYCLE_LEN];
+	target = bbr_target_cwnd(ccv, gain);
+
+	/*
+	 * Without pacing, jumping cwnd straight to the target would
+	 * burst at line rate; let growth follow the ACK clock instead.
+	 * Reductions (the drain phase) take effect immediately.
+	 */
+	if (CCV(ccv, tcp_cwnd) < target) {
+		CCV(ccv, tcp_cwnd) = MIN(target,
+		    CCV(ccv, tcp_cwnd) + ccv->bytes_this_ack);
+	} else {
+		CCV(ccv, tcp_cwnd) = target;
+	}
+}
+
+/*
+ * Congestion signals do not invalidate the path model; a window of data
+ * is still in flight and the bandwidth and RTT filters describe the
+ * path better than the loss does. Keep ssthresh at the estimated BDP so
+ * recovery does not collapse the window below what the path sustains.
+ * An RTO means the ACK clock is gone, so fall back to one segment like
+ * the other algorithms and let slow start rebuild against the model.
+ */
+static void
+bbr_cong_signal(struct cc_var *ccv, uint32_t type)
+{
+	struct bbr *bbr_data;
+	uint32_t target, mss;
+
+	bbr_data = ccv->cc_data;
+	mss = CCV(ccv, tcp_mss);
+
+	if (bbr_data->max_bw != 0)
+		target = bbr_target_cwnd(ccv, BBR_GAIN_UNIT);
+	else
+		target = MAX(CCV(ccv, tcp_cwnd) / 2, 2 * mss);
+
+	switch (type) {
+	case CC_NDUPACK:
+		if (!IN_FASTRECOVERY(ccv->flags)) {
+			if (!IN_CONGRECOVERY(ccv->flags)) {
+				CCV(ccv, tcp_cwnd_ssthresh) = target;
+				CCV(ccv, tcp_cwnd) = MIN(CCV(ccv, tcp_cwnd),
+				    target);
+			}
+			ENTER_RECOVERY(ccv->flags);
+		}
+		break;
+
+	case CC_ECN:
+		if (!IN_CONGRECOVERY(ccv->flags)) {
+			CCV(ccv, tcp_cwnd_ssthresh) = target;
+			CCV(ccv, tcp_cwnd) = MIN(CCV(ccv, tcp_cwnd), target);
+			ENTER_CONGRECOVERY(ccv->flags);
+		}
+		break;
+
+	case CC_RTO:
+		CCV(ccv, tcp_cwnd_ssthresh) = target;
+		CCV(ccv, tcp_cwnd) = mss;
+		/* The measurement round was cut short; start a new one. */
+		bbr_data->round_start = gethrtime();
+		bbr_data->round_bytes = 0;
+		break;
+	}
+}
+
+static void
+bbr_post_recovery(struct cc_var *ccv)
+{
+	struct bbr *bbr_data;
+	uint32_t pipe;
+
+	bbr_data = ccv->cc_data;
+
+	if (IN_FASTRECOVERY(ccv->flags)) {
+		/*
+		 * Restart from what is actually in flight, bounded below
+		 * so the window cannot collapse, and let bbr_ack_received
+		 * grow it back to the model's target under ACK clocking.
+		 */
+		pipe = CCV(ccv, tcp_snxt) - CCV(ccv, tcp_suna);
+		CCV(ccv, tcp_cwnd) = MAX(pipe, 2 * CCV(ccv, tcp_mss));
+	}
+
+	/* Recovery interrupted the measurement round; start a new one. */
+	bbr_data->round_start = gethrtime();
+	bbr_data->round_bytes = 0;
+}
+
+static void
+bbr_after_idle(struct cc_var *ccv)
+{
+	struct bbr *bbr_data;
+
+	bbr_data = ccv->cc_data;
+
+	/*
+	 * After an idle period there is no ACK clock to meter growth,
+	 * so restart from NewReno's restart window rather than bursting
+	 * a full BDP. The bandwidth filter is left alone; it ages out
+	 * through the windowed max as new rounds complete.
+	 */
+	newreno_cc_algo->after_idle(ccv);
+	bbr_data->round_start = gethrtime();
+	bbr_data->round_bytes = 0;
+}
@@ -249,6 +249,7 @@ ilb_server_kstat_init(netstackid_t stackid, ilb_rule_t *rule,
 	ilb_server_kstat_t template = {
 		{ "bytes_processed",	KSTAT_DATA_UINT64, 0 },
 		{ "pkt_processed",	KSTAT_DATA_UINT64, 0 },
+		{ "ring_slots",		KSTAT_DATA_UINT64, 0 },
 		{ "ip_address",		KSTAT_DATA_STRING, 0 }
 	};
 	char cname_buf[KSTAT_STRLEN];
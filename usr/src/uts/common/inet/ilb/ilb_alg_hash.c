@@ -70,12 +70,24 @@ typedef struct {
 } hash_server_t;
 
 /*
- * There are two hash tables.  The hash_tbl holds all servers, both enabled
- * and disabled.  The hash_enabled_tbl only holds enabled servers.  Having
- * two tables allows the hash on a client request remains the same even when
- * some servers are disabled.  If a server is disabled and a client's request
- * hashes to it, we will do another hash.  This time the has is on the enabled
- * server table.
+ * Number of slots in the precomputed ring used to map a flow hash to a
+ * server.  The ring is sized when a rule is created, so changing this
+ * tunable only affects rules created afterwards.  A larger ring spreads
+ * the slots more evenly over the servers at the cost of a longer rebuild
+ * when the server set changes.
+ */
+uint_t ilb_hash_ring_size = 256;
+
+/*
+ * There are two tables.  The hash_tbl holds all servers, both enabled and
+ * disabled, and tracks membership.  The hash_ring is a precomputed lookup
+ * table rebuilt whenever the set of enabled servers changes; each slot
+ * holds the enabled server with the highest rendezvous score for that
+ * slot (highest random weight hashing).  A client request is hashed to a
+ * slot and served by the slot's owner.  Since a server's scores do not
+ * depend on which other servers exist, adding or removing a server only
+ * moves the slots that server wins or owned; the rest of the flows keep
+ * their backend.
  */
 typedef struct hash_s {
 	kmutex_t	hash_lock;
@@ -85,11 +97,71 @@ typedef struct hash_s {
 	size_t		hash_enabled_tbl_size;	/* Enabled server table size */
 	hash_server_t	*hash_tbl;
 	hash_server_t	*hash_enabled_tbl;
+	size_t		hash_ring_size;
+	ilb_server_t	**hash_ring;
 	ilb_algo_impl_t	hash_type;
 } hash_t;
 
 static void hash_fini(ilb_alg_data_t **);
 
+/*
+ * Rendezvous score of a server for a ring slot.  Only a function of the
+ * server's identity and the slot, never of the other servers.
+ */
+static uint32_t
+hash_ring_score(const ilb_server_t *server, uint32_t slot)
+{
+	uint32_t buf[3];
+	uint32_t hash;
+
+	buf[0] = server->iser_addr_v6.s6_addr32[0] ^
+	    server->iser_addr_v6.s6_addr32[3];
+	buf[1] = ((uint32_t)server->iser_min_port << 16) |
+	    server->iser_max_port;
+	buf[2] = slot;
+	CRC32(hash, buf, sizeof (buf), -1U, crc32_table);
+	return (hash);
+}
+
+/*
+ * Recompute the ring from the enabled server table.  Called whenever the
+ * set of enabled servers changes; the per packet path only reads the
+ * ring.  Also records in each server's kstat how many slots it owns so
+ * the spread can be observed.
+ */
+static void
+hash_ring_rebuild(hash_t *hash_alg)
+{
+	uint32_t s;
+	size_t i;
+
+	ASSERT(MUTEX_HELD(&hash_alg->hash_lock));
+
+	for (i = 0; i < hash_alg->hash_enabled_servers; i++) {
+		hash_alg->hash_enabled_tbl[i].server->
+		    iser_kstat.ring_slots.value.ui64 = 0;
+	}
+	for (s = 0; s < hash_alg->hash_ring_size; s++) {
+		ilb_server_t *best = NULL;
+		uint32_t best_score = 0;
+
+		for (i = 0; i < hash_alg->hash_enabled_servers; i++) {
+			ilb_server_t *server;
+			uint32_t score;
+
+			server = hash_alg->hash_enabled_tbl[i].server;
+			score = hash_ring_score(server, s);
+			if (best == NULL || score > best_score) {
+				best = server;
+				best_score = score;
+			}
+		}
+		hash_alg->hash_ring[s] = best;
+		if (best != NULL)
+			best->iser_kstat.ring_slots.value.ui64++;
+	}
+}
+
 /* ARGSUSED */
 static boolean_t
 hash_lb(in6_addr_t *saddr, in_port_t sport, in6_addr_t *daddr,
@@ -103,53 +175,27 @@ hash_lb(in6_addr_t *saddr, in_port_t sport, in6_addr_t *daddr,
 
 	mutex_enter(&hash_alg->hash_lock);
 
-	if (hash_alg->hash_servers == 0) {
+	if (hash_alg->hash_enabled_servers == 0) {
 		mutex_exit(&hash_alg->hash_lock);
 		return (B_FALSE);
 	}
 
 	switch (hash_alg->hash_type) {
 	case ILB_ALG_IMPL_HASH_IP:
-		HASH_IP_V6(i, saddr, hash_alg->hash_servers);
+		HASH_IP_V6(i, saddr, hash_alg->hash_ring_size);
 		break;
 	case ILB_ALG_IMPL_HASH_IP_SPORT:
-		HASH_IP_PORT_V6(i, saddr, sport, hash_alg->hash_servers);
+		HASH_IP_PORT_V6(i, saddr, sport, hash_alg->hash_ring_size);
 		break;
 	case ILB_ALG_IMPL_HASH_IP_VIP:
-		HASH_IP_VIP_V6(i, saddr, daddr, hash_alg->hash_servers);
+		HASH_IP_VIP_V6(i, saddr, daddr, hash_alg->hash_ring_size);
 		break;
 	default:
 		mutex_exit(&hash_alg->hash_lock);
 		return (B_FALSE);
 	}
-	if (hash_alg->hash_tbl[i].enabled) {
-		*ret_server = hash_alg->hash_tbl[i].server;
-		mutex_exit(&hash_alg->hash_lock);
-		return (B_TRUE);
-	}
-
-	if (hash_alg->hash_enabled_servers == 0) {
-		mutex_exit(&hash_alg->hash_lock);
-		return (B_FALSE);
-	}
-
-	switch (hash_alg->hash_type) {
-	case ILB_ALG_IMPL_HASH_IP:
-		HASH_IP_V6(i, saddr, hash_alg->hash_enabled_servers);
-		break;
-	case ILB_ALG_IMPL_HASH_IP_SPORT:
-		HASH_IP_PORT_V6(i, saddr, sport,
-		    hash_alg->hash_enabled_servers);
-		break;
-	case ILB_ALG_IMPL_HASH_IP_VIP:
-		HASH_IP_VIP_V6(i, saddr, daddr,
-		    hash_alg->hash_enabled_servers);
-		break;
-	default:
-		ASSERT(0);
-		break;
-	}
-	*ret_server = hash_alg->hash_enabled_tbl[i].server;
+	ASSERT(hash_alg->hash_ring[i] != NULL);
+	*ret_server = hash_alg->hash_ring[i];
 	mutex_exit(&hash_alg->hash_lock);
 	return (B_TRUE);
 }
@@ -194,8 +240,10 @@ hash_server_del(ilb_server_t *host, void *alg_data)
 	/* The server may not be enabled. */
 	ret = del_server(hash_alg->hash_enabled_tbl,
 	    hash_alg->hash_enabled_servers, host);
-	if (ret)
+	if (ret) {
 		hash_alg->hash_enabled_servers--;
+		hash_ring_rebuild(hash_alg);
+	}
 
 	mutex_exit(&hash_alg->hash_lock);
 	ILB_SERVER_REFRELE(host);
@@ -262,6 +310,7 @@ hash_server_add(ilb_server_t *host, void *alg_data)
 	hash_alg->hash_enabled_tbl[hash_alg->hash_enabled_servers].enabled =
 	    B_TRUE;
 	hash_alg->hash_enabled_servers++;
+	hash_ring_rebuild(hash_alg);
 
 	mutex_exit(&hash_alg->hash_lock);
 	ILB_SERVER_REFHOLD(host);
@@ -317,6 +366,7 @@ hash_server_enable(ilb_server_t *host, void *alg_data)
 	alg->hash_enabled_tbl[alg->hash_enabled_servers].server = host;
 	alg->hash_enabled_tbl[alg->hash_enabled_servers].enabled = B_TRUE;
 	alg->hash_enabled_servers++;
+	hash_ring_rebuild(alg);
 
 	mutex_exit(&alg->hash_lock);
 	return (0);
@@ -354,6 +404,7 @@ hash_server_disable(ilb_server_t *host, void *alg_data)
 	    host);
 #endif
 	alg->hash_enabled_servers--;
+	hash_ring_rebuild(alg);
 
 	mutex_exit(&alg->hash_lock);
 	return (0);
@@ -400,9 +451,24 @@ ilb_alg_hash_init(ilb_rule_t *rule, const void *arg)
 	hash_alg->hash_enabled_tbl_size = INIT_HASH_TBL_SIZE;
 	hash_alg->hash_enabled_tbl = kmem_zalloc(sizeof (hash_server_t) *
 	    INIT_HASH_TBL_SIZE, KM_NOSLEEP);
-	if (hash_alg->hash_tbl == NULL) {
+	if (hash_alg->hash_enabled_tbl == NULL) {
+		kmem_free(hash_alg->hash_tbl, INIT_HASH_TBL_SIZE *
+		    sizeof (hash_server_t));
+		kmem_free(hash_alg, sizeof (hash_t));
+		kmem_free(alg, sizeof (ilb_alg_data_t));
+		return (NULL);
+	}
+
+	/* Snapshot the tunable; the ring size is fixed for a rule's life. */
+	hash_alg->hash_ring_size = (ilb_hash_ring_size != 0) ?
+	    ilb_hash_ring_size : 1;
+	hash_alg->hash_ring = kmem_zalloc(sizeof (ilb_server_t *) *
+	    hash_alg->hash_ring_size, KM_NOSLEEP);
+	if (hash_alg->hash_ring == NULL) {
+		kmem_free(hash_alg->hash_enabled_tbl, INIT_HASH_TBL_SIZE *
+		    sizeof (hash_server_t));
 		kmem_free(hash_alg->hash_tbl, INIT_HASH_TBL_SIZE *
-		    sizeof (ilb_server_t *));
+		    sizeof (hash_server_t));
 		kmem_free(hash_alg, sizeof (hash_t));
 		kmem_free(alg, sizeof (ilb_alg_data_t));
 		return (NULL);
@@ -425,6 +491,8 @@ hash_fini(ilb_alg_data_t **alg)
 	    hash_alg->hash_tbl_size);
 	kmem_free(hash_alg->hash_enabled_tbl, sizeof (hash_server_t) *
 	    hash_alg->hash_enabled_tbl_size);
+	kmem_free(hash_alg->hash_ring, sizeof (ilb_server_t *) *
+	    hash_alg->hash_ring_size);
 	kmem_free(hash_alg, sizeof (hash_t));
 	kmem_free(*alg, sizeof (ilb_alg_data_t));
 	*alg = NULL;
@@ -87,6 +87,7 @@ typedef struct ilb_rule_kstat {
 typedef struct ilb_server_kstat {
 	kstat_named_t	bytes_processed; /* Number of bytes processed */
 	kstat_named_t	pkt_processed;	/* Number of packets processed */
+	kstat_named_t	ring_slots;	/* Hash ring slots owned (hash algo) */
 	kstat_named_t	ip_address;	/* IP address of the server */
 } ilb_server_kstat_t;
 
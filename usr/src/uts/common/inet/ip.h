@@ -54,6 +54,7 @@ extern "C" {
 #include <netinet/ip6.h>
 #include <sys/avl.h>
 #include <sys/list.h>
+#include <sys/cpu_uarray.h>
 #include <sys/vmem.h>
 #include <sys/squeue.h>
 #include <net/route.h>
@@ -1600,6 +1601,35 @@ struct ill_lso_capab_s {
 	uint_t	ill_lso_max_tcpv6;	/* maximum size of payload */
 };
 
+/*
+ * Per-CPU interface MIB counters.
+ *
+ * The handful of ipIfStats counters that are updated for every packet are
+ * kept in a per-CPU array (ill_hcstats) instead of in ill_ip_mib itself,
+ * so that CPUs receiving or sending in parallel do not all bounce the
+ * same mib cache lines.  The per-CPU array is the sole home of these
+ * counters; the corresponding ill_ip_mib fields are only written by
+ * ill_hcstat_fold(), which overwrites them with the current per-CPU sums
+ * and is called before the mib is read.  The SNMP and kstat read paths
+ * are otherwise unchanged.  Counters updated only on error or slow paths
+ * stay in ill_ip_mib.
+ */
+typedef enum {
+	ILL_HC_IN_RECEIVES,		/* ipIfStatsHCInReceives */
+	ILL_HC_IN_OCTETS,		/* ipIfStatsHCInOctets */
+	ILL_HC_IN_DELIVERS,		/* ipIfStatsHCInDelivers */
+	ILL_HC_IN_FORW_DATAGRAMS,	/* ipIfStatsHCInForwDatagrams */
+	ILL_HC_OUT_REQUESTS,		/* ipIfStatsHCOutRequests */
+	ILL_HC_OUT_FORW_DATAGRAMS,	/* ipIfStatsHCOutForwDatagrams */
+	ILL_HC_OUT_TRANSMITS,		/* ipIfStatsHCOutTransmits */
+	ILL_HC_OUT_OCTETS,		/* ipIfStatsHCOutOctets */
+	ILL_HC_NSTATS
+} ill_hcstat_idx_t;
+
+#define	ILL_HCSTAT_UPDATE(ill, idx, n)	\
+	(CPU_UARRAY_VAL((ill)->ill_hcstats, CPU->cpu_seqid, (idx)) += (n))
+#define	ILL_HCSTAT_BUMP(ill, idx)	ILL_HCSTAT_UPDATE(ill, idx, 1)
+
 /*
  * IP Lower level Structure.
  * Instance data structure in ip_open when there is a device below us.
@@ -1750,6 +1780,7 @@ typedef struct ill_s {
 	uint32_t	ill_xmit_count;		/* ndp max multicast xmits */
 	mib2_ipIfStatsEntry_t	*ill_ip_mib;	/* ver indep. interface mib */
 	mib2_ipv6IfIcmpEntry_t	*ill_icmp6_mib;	/* Per interface mib */
+	cpu_uarray_t	*ill_hcstats;	/* per-CPU hot mib counters */
 
 	phyint_t		*ill_phyint;
 	uint64_t		ill_flags;
@@ -2081,6 +2112,25 @@ typedef	void	(*ixa_notify_t)(void *, ip_xmit_attr_t *ixa, ixa_notify_type_t,
 
 #define	IAF_MASK		0xf0000000	/* Flags that are common */
 
+/*
+ * Per-ixa destination route cache entry. A small array of these lets an
+ * unconnected endpoint that sends to a working set of destinations skip
+ * the radix tree walk in ire_route_recursive_*() on repeat sends.
+ * Entries hold an ire reference and are validated against ire_generation
+ * on each use; route table changes bump the generations of the affected
+ * ires (see ire_flush_cache_v4/v6) so a stale entry is simply dropped.
+ * An entry with a NULL ixd_ire is unused.
+ */
+typedef struct ixa_dstcache_s {
+	in6_addr_t	ixd_dst;	/* v4-mapped for IPv4 destinations */
+	in6_addr_t	ixd_setsrc;	/* RTF_SETSRC source; else zeroes */
+	ire_t		*ixd_ire;	/* Held (notr); NULL if unused */
+	uint_t		ixd_generation;	/* ire_generation when cached */
+	zoneid_t	ixd_zoneid;	/* ixa_zoneid when cached */
+} ixa_dstcache_t;
+
+#define	IXA_DSTCACHE_SIZE	4
+
 /*
  * Transmit side attributes used between the transport protocols and IP as
  * well as inside IP. It is also used to cache information in the conn_t i.e.
@@ -2205,6 +2255,14 @@ struct ip_xmit_attr_s {
 	void		*ixa_notify_cookie; /* ULP cookie for ixa_notify */
 
 	uint_t		ixa_tcpcleanup;	/* Used by conn_ixa_cleanup */
+
+	/*
+	 * Recently used routes; see ip_select_route(). Only consulted for
+	 * plain unicast lookups. Uses the same single-threaded-use
+	 * assumption as ixa_ire above, hence no lock.
+	 */
+	ixa_dstcache_t	ixa_dstcache[IXA_DSTCACHE_SIZE];
+	uint_t		ixa_dstcache_next;	/* Round-robin replacement */
 };
 
 /*
@@ -3299,6 +3357,7 @@ extern void	ip_rput_notdata(ill_t *, mblk_t *);
 
 extern void	ip_mib2_add_ip_stats(mib2_ipIfStatsEntry_t *,
 		    mib2_ipIfStatsEntry_t *);
+extern void	ill_hcstat_fold(ill_t *);
 extern void	ip_mib2_add_icmp6_stats(mib2_ipv6IfIcmpEntry_t *,
 		    mib2_ipv6IfIcmpEntry_t *);
 extern void	ip_rput_other(ipsq_t *, queue_t *, mblk_t *, void *);
@@ -644,6 +644,9 @@ conn_opt_get(conn_opt_arg_t *coa, t_scalar_t level, t_scalar_t name,
 		case SO_REUSEADDR:
 			*i1 = connp->conn_reuseaddr ? SO_REUSEADDR : 0;
 			break;	/* goto sizeof (int) option return */
+		case SO_REUSEPORT:
+			*i1 = connp->conn_reuseport ? SO_REUSEPORT : 0;
+			break;	/* goto sizeof (int) option return */
 		case SO_TYPE:
 			*i1 = connp->conn_so_type;
 			break;	/* goto sizeof (int) option return */
@@ -1082,6 +1085,15 @@ conn_opt_set_socket(conn_opt_arg_t *coa, t_scalar_t name, uint_t inlen,
 		if (IPCL_IS_BOUND(connp))
 			return (EINVAL);
 		break;
+	case SO_REUSEPORT:
+		/*
+		 * Group membership is checked when the endpoint binds;
+		 * toggling the option afterwards would let the group
+		 * invariant rot, so refuse it on a bound endpoint.
+		 */
+		if (IPCL_IS_BOUND(connp))
+			return (EINVAL);
+		break;
 	case SO_VRRP:
 		if (secpolicy_ip_config(cr, checkonly) != 0)
 			return (EACCES);
@@ -1128,6 +1140,9 @@ conn_opt_set_socket(conn_opt_arg_t *coa, t_scalar_t name, uint_t inlen,
 	case SO_REUSEADDR:
 		connp->conn_reuseaddr = onoff;
 		break;
+	case SO_REUSEPORT:
+		connp->conn_reuseport = onoff;
+		break;
 	case SO_DONTROUTE:
 		if (onoff)
 			ixa->ixa_flags |= IXAF_DONTROUTE;
@@ -4996,7 +4996,7 @@ ip_fanout_proto_conn(conn_t *connp, mblk_t *mp, ipha_t *ipha, ip6_t *ip6h,
 	} else {
 		ill_t *rill = ira->ira_rill;
 
-		BUMP_MIB(ill->ill_ip_mib, ipIfStatsHCInDelivers);
+		ILL_HCSTAT_BUMP(ill, ILL_HC_IN_DELIVERS);
 		ira->ira_ill = ira->ira_rill = NULL;
 		/* Send it upstream */
 		(connp->conn_recv)(connp, mp, NULL, ira);
@@ -5266,7 +5266,7 @@ ip_fanout_udp_conn(conn_t *connp, mblk_t *mp, ipha_t *ipha, ip6_t *ip6h,
 	} else {
 		ill_t *rill = ira->ira_rill;
 
-		BUMP_MIB(ill->ill_ip_mib, ipIfStatsHCInDelivers);
+		ILL_HCSTAT_BUMP(ill, ILL_HC_IN_DELIVERS);
 		ira->ira_ill = ira->ira_rill = NULL;
 		/* Send it upstream */
 		(connp->conn_recv)(connp, mp, NULL, ira);
@@ -9933,6 +9933,7 @@ ip_snmp_get_mib2_ip_traffic_stats(queue_t *q, mblk_t *mpctl, ip_stack_t *ipst,
 		    (ipst->ips_ip_forwarding ? 1 : 2));
 		SET_MIB(ill->ill_ip_mib->ipIfStatsDefaultTTL,
 		    (uint32_t)ipst->ips_ip_def_ttl);
+		ill_hcstat_fold(ill);
 
 		ip_mib2_add_ip_stats(&global_ip_mib, ill->ill_ip_mib);
 		if (!snmp_append_data2(mpctl->b_cont, &mp_tail,
@@ -10859,6 +10860,7 @@ ip_snmp_get_mib2_ip6(queue_t *q, mblk_t *mpctl, ip_stack_t *ipst,
 		    ipst->ips_ipv6_forwarding ? 1 : 2);
 		SET_MIB(ill->ill_ip_mib->ipIfStatsDefaultHopLimit,
 		    ill->ill_max_hops);
+		ill_hcstat_fold(ill);
 
 		/*
 		 * Synchronize 64- and 32-bit counters
@@ -11421,6 +11423,40 @@ ip_mib2_add_ip_stats(mib2_ipIfStatsEntry_t *o1, mib2_ipIfStatsEntry_t *o2)
 	UPDATE_MIB(o1, udpNoPorts, o2->udpNoPorts);
 }
 
+/*
+ * Fold the per-CPU hot interface counters (see ILL_HCSTAT_BUMP()) back
+ * into ill_ip_mib before the mib is read.  The per-CPU array is the sole
+ * home of these counters - nothing else writes the corresponding
+ * ill_ip_mib fields - so overwriting them with the current sums is safe
+ * to do any number of times.
+ */
+void
+ill_hcstat_fold(ill_t *ill)
+{
+	mib2_ipIfStatsEntry_t	*ipmib = ill->ill_ip_mib;
+	cpu_uarray_t		*cua = ill->ill_hcstats;
+
+	if (ipmib == NULL || cua == NULL)
+		return;
+
+	SET_MIB(ipmib->ipIfStatsHCInReceives,
+	    cpu_uarray_sum(cua, ILL_HC_IN_RECEIVES));
+	SET_MIB(ipmib->ipIfStatsHCInOctets,
+	    cpu_uarray_sum(cua, ILL_HC_IN_OCTETS));
+	SET_MIB(ipmib->ipIfStatsHCInDelivers,
+	    cpu_uarray_sum(cua, ILL_HC_IN_DELIVERS));
+	SET_MIB(ipmib->ipIfStatsHCInForwDatagrams,
+	    cpu_uarray_sum(cua, ILL_HC_IN_FORW_DATAGRAMS));
+	SET_MIB(ipmib->ipIfStatsHCOutRequests,
+	    cpu_uarray_sum(cua, ILL_HC_OUT_REQUESTS));
+	SET_MIB(ipmib->ipIfStatsHCOutForwDatagrams,
+	    cpu_uarray_sum(cua, ILL_HC_OUT_FORW_DATAGRAMS));
+	SET_MIB(ipmib->ipIfStatsHCOutTransmits,
+	    cpu_uarray_sum(cua, ILL_HC_OUT_TRANSMITS));
+	SET_MIB(ipmib->ipIfStatsHCOutOctets,
+	    cpu_uarray_sum(cua, ILL_HC_OUT_OCTETS));
+}
+
 void
 ip_mib2_add_icmp6_stats(mib2_ipv6IfIcmpEntry_t *o1, mib2_ipv6IfIcmpEntry_t *o2)
 {
@@ -14149,8 +14185,10 @@ ip_kstat_update(kstat_t *kp, int rw)
 	bcopy(&ipst->ips_ip_mib, &ipmib, sizeof (ipmib));
 	rw_enter(&ipst->ips_ill_g_lock, RW_READER);
 	ill = ILL_START_WALK_V4(&ctx, ipst);
-	for (; ill != NULL; ill = ill_next(&ctx, ill))
+	for (; ill != NULL; ill = ill_next(&ctx, ill)) {
+		ill_hcstat_fold(ill);
 		ip_mib2_add_ip_stats(&ipmib, ill->ill_ip_mib);
+	}
 	rw_exit(&ipst->ips_ill_g_lock);
 
 	ipkp->forwarding.value.ui32 =		ipmib.ipIfStatsForwarding;
@@ -14402,7 +14440,7 @@ ip_fanout_sctp_raw(mblk_t *mp, ipha_t *ipha, ip6_t *ip6h, uint32_t ports,
 	} else {
 		ill_t *rill = ira->ira_rill;
 
-		BUMP_MIB(ill->ill_ip_mib, ipIfStatsHCInDelivers);
+		ILL_HCSTAT_BUMP(ill, ILL_HC_IN_DELIVERS);
 		/* This is the SOCK_RAW, IPPROTO_SCTP case. */
 		ira->ira_ill = ira->ira_rill = NULL;
 		(connp->conn_recv)(connp, mp, NULL, ira);
@@ -14606,8 +14644,8 @@ sendit:
 			 * Return value should be taken into
 			 * account and flow control the TCP.
 			 */
-			BUMP_MIB(ill->ill_ip_mib, ipIfStatsHCOutTransmits);
-			UPDATE_MIB(ill->ill_ip_mib, ipIfStatsHCOutOctets,
+			ILL_HCSTAT_BUMP(ill, ILL_HC_OUT_TRANSMITS);
+			ILL_HCSTAT_UPDATE(ill, ILL_HC_OUT_OCTETS,
 			    pkt_len);
 
 			if (ixaflags & IXAF_NO_DEV_FLOW_CTL) {
@@ -14635,8 +14673,8 @@ sendit:
 				    MBLKL(nce->nce_fp_mp) : 0);
 				return (EWOULDBLOCK);
 			}
-			BUMP_MIB(ill->ill_ip_mib, ipIfStatsHCOutTransmits);
-			UPDATE_MIB(ill->ill_ip_mib, ipIfStatsHCOutOctets,
+			ILL_HCSTAT_BUMP(ill, ILL_HC_OUT_TRANSMITS);
+			ILL_HCSTAT_UPDATE(ill, ILL_HC_OUT_OCTETS,
 			    pkt_len);
 			putnext(wq, mp);
 		}
@@ -340,10 +340,10 @@ ip_input_common_v6(ill_t *ill, ill_rx_ring_t *ip_ring, mblk_t *mp_chain,
 		 * up being dropped later on. Defer counting bytes until
 		 * we have the whole IP header in first mblk.
 		 */
-		BUMP_MIB(ill->ill_ip_mib, ipIfStatsHCInReceives);
+		ILL_HCSTAT_BUMP(ill, ILL_HC_IN_RECEIVES);
 
 		iras.ira_pktlen = ntohs(ip6h->ip6_plen) + IPV6_HDR_LEN;
-		UPDATE_MIB(ill->ill_ip_mib, ipIfStatsHCInOctets,
+		ILL_HCSTAT_UPDATE(ill, ILL_HC_IN_OCTETS,
 		    iras.ira_pktlen);
 
 		/*
@@ -935,7 +935,7 @@ ire_recv_forward_v6(ire_t *ire, mblk_t *mp, void *iph_arg, ip_recv_attr_t *ira)
 	 * will be an attempt to forward the packet, which is why we
 	 * increment after the above condition has been checked.
 	 */
-	BUMP_MIB(ill->ill_ip_mib, ipIfStatsHCInForwDatagrams);
+	ILL_HCSTAT_BUMP(ill, ILL_HC_IN_FORW_DATAGRAMS);
 
 	/* Initiate Read side IPPF processing */
 	if (IPP_ENABLED(IPP_FWD_IN, ipst)) {
@@ -1099,7 +1099,7 @@ ip_forward_xmit_v6(nce_t *nce, mblk_t *mp, ip6_t *ip6h, ip_recv_attr_t *ira,
 
 	pkt_len = ira->ira_pktlen;
 
-	BUMP_MIB(dst_ill->ill_ip_mib, ipIfStatsHCOutForwDatagrams);
+	ILL_HCSTAT_BUMP(dst_ill, ILL_HC_OUT_FORW_DATAGRAMS);
 
 	if (pkt_len > mtu) {
 		BUMP_MIB(dst_ill->ill_ip_mib, ipIfStatsOutFragFails);
@@ -1168,7 +1168,7 @@ ire_recv_noroute_v6(ire_t *ire, mblk_t *mp, void *iph_arg, ip_recv_attr_t *ira)
 	 * will be an attempt to forward the packet, which is why we
 	 * increment after the above condition has been checked.
 	 */
-	BUMP_MIB(ill->ill_ip_mib, ipIfStatsHCInForwDatagrams);
+	ILL_HCSTAT_BUMP(ill, ILL_HC_IN_FORW_DATAGRAMS);
 
 	BUMP_MIB(ill->ill_ip_mib, ipIfStatsInNoRoutes);
 
@@ -2142,7 +2142,7 @@ repeat:
 		    ira, ipst);
 		if (connp == NULL) {
 			/* Send the TH_RST */
-			BUMP_MIB(ill->ill_ip_mib, ipIfStatsHCInDelivers);
+			ILL_HCSTAT_BUMP(ill, ILL_HC_IN_DELIVERS);
 			tcp_xmit_listeners_reset(mp, ira, ipst, NULL);
 			return;
 		}
@@ -2151,7 +2151,7 @@ repeat:
 			CONN_DEC_REF(connp);
 
 			/* Send the TH_RST */
-			BUMP_MIB(ill->ill_ip_mib, ipIfStatsHCInDelivers);
+			ILL_HCSTAT_BUMP(ill, ILL_HC_IN_DELIVERS);
 			tcp_xmit_listeners_reset(mp, ira, ipst, NULL);
 			return;
 		}
@@ -2168,7 +2168,7 @@ repeat:
 			}
 		}
 		/* Found a client; up it goes */
-		BUMP_MIB(ill->ill_ip_mib, ipIfStatsHCInDelivers);
+		ILL_HCSTAT_BUMP(ill, ILL_HC_IN_DELIVERS);
 		ira->ira_ill = ira->ira_rill = NULL;
 		if (!IPCL_IS_TCP(connp)) {
 			/* Not TCP; must be SOCK_RAW, IPPROTO_TCP */
@@ -2272,7 +2272,7 @@ repeat:
 		}
 
 		/* Found a client; up it goes */
-		BUMP_MIB(ill->ill_ip_mib, ipIfStatsHCInDelivers);
+		ILL_HCSTAT_BUMP(ill, ILL_HC_IN_DELIVERS);
 		sctp_input(connp, NULL, ip6h, mp, ira);
 		/* sctp_input does a rele of the sctp_t */
 		return;
@@ -2335,7 +2335,7 @@ repeat:
 
 		/* Found a client; up it goes */
 		IP6_STAT(ipst, ip6_udp_fannorm);
-		BUMP_MIB(ill->ill_ip_mib, ipIfStatsHCInDelivers);
+		ILL_HCSTAT_BUMP(ill, ILL_HC_IN_DELIVERS);
 		ira->ira_ill = ira->ira_rill = NULL;
 		(connp->conn_recv)(connp, mp, NULL, ira);
 		CONN_DEC_REF(connp);
@@ -2395,7 +2395,7 @@ repeat:
 			}
 		}
 
-		BUMP_MIB(ill->ill_ip_mib, ipIfStatsHCInDelivers);
+		ILL_HCSTAT_BUMP(ill, ILL_HC_IN_DELIVERS);
 		mp = icmp_inbound_v6(mp, ira);
 		if (mp == NULL) {
 			/* No need to pass to RAW sockets */
@@ -2650,7 +2650,7 @@ repeat:
 			return;
 		}
 
-		BUMP_MIB(ill->ill_ip_mib, ipIfStatsHCInDelivers);
+		ILL_HCSTAT_BUMP(ill, ILL_HC_IN_DELIVERS);
 		/* select inbound SA and have IPsec process the pkt */
 		if (protocol == IPPROTO_ESP) {
 			esph_t *esph;
@@ -2695,7 +2695,7 @@ repeat:
 	case IPPROTO_NONE:
 		/* All processing is done. Count as "delivered". */
 		freemsg(mp);
-		BUMP_MIB(ill->ill_ip_mib, ipIfStatsHCInDelivers);
+		ILL_HCSTAT_BUMP(ill, ILL_HC_IN_DELIVERS);
 		return;
 
 	case IPPROTO_ENCAP:
@@ -2704,7 +2704,7 @@ repeat:
 		connp = ipcl_classify_v6(mp, protocol, ip_hdr_length,
 		    ira, ipst);
 		if (connp != NULL) {
-			BUMP_MIB(ill->ill_ip_mib, ipIfStatsHCInDelivers);
+			ILL_HCSTAT_BUMP(ill, ILL_HC_IN_DELIVERS);
 			ira->ira_ill = ira->ira_rill = NULL;
 			connp->conn_recv(connp, mp, NULL, ira);
 			CONN_DEC_REF(connp);
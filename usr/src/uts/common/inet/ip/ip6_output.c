@@ -288,7 +288,7 @@ repeat_ire:
 			    ixa->ixa_src_preferences, &src, NULL, NULL);
 		}
 		if (error != 0) {
-			BUMP_MIB(ill->ill_ip_mib, ipIfStatsHCOutRequests);
+			ILL_HCSTAT_BUMP(ill, ILL_HC_OUT_REQUESTS);
 			BUMP_MIB(ill->ill_ip_mib, ipIfStatsOutDiscards);
 			ip_drop_output("ipIfStatsOutDiscards - no source",
 			    mp, ill);
@@ -324,7 +324,7 @@ repeat_ire:
 	}
 
 	if (ill != NULL) {
-		BUMP_MIB(ill->ill_ip_mib, ipIfStatsHCOutRequests);
+		ILL_HCSTAT_BUMP(ill, ILL_HC_OUT_REQUESTS);
 	} else {
 		BUMP_MIB(&ipst->ips_ip_mib, ipIfStatsHCOutRequests);
 	}
@@ -497,8 +497,8 @@ ire_send_local_v6(ire_t *ire, mblk_t *mp, void *iph_arg,
 	iras.ira_pktlen = pktlen;
 
 	ire->ire_ib_pkt_count++;
-	BUMP_MIB(ill->ill_ip_mib, ipIfStatsHCInReceives);
-	UPDATE_MIB(ill->ill_ip_mib, ipIfStatsHCInOctets, pktlen);
+	ILL_HCSTAT_BUMP(ill, ILL_HC_IN_RECEIVES);
+	ILL_HCSTAT_UPDATE(ill, ILL_HC_IN_OCTETS, pktlen);
 
 	/* Destined to ire_zoneid - use that for fanout */
 	iras.ira_zoneid = ire->ire_zoneid;
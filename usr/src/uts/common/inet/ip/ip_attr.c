@@ -877,9 +877,29 @@ conn_get_ixa_exclusive(conn_t *connp)
 	return (ixa);
 }
 
+/*
+ * Drop all of the held routes in the ixa's destination cache.
+ * See ip_select_route() which maintains the cache.
+ */
+static void
+ixa_dstcache_flush(ip_xmit_attr_t *ixa)
+{
+	uint_t	i;
+
+	for (i = 0; i < IXA_DSTCACHE_SIZE; i++) {
+		if (ixa->ixa_dstcache[i].ixd_ire != NULL) {
+			ire_refrele_notr(ixa->ixa_dstcache[i].ixd_ire);
+			ixa->ixa_dstcache[i].ixd_ire = NULL;
+		}
+	}
+	ixa->ixa_dstcache_next = 0;
+}
+
 void
 ixa_safe_copy(ip_xmit_attr_t *src, ip_xmit_attr_t *ixa)
 {
+	uint_t	i;
+
 	bcopy(src, ixa, sizeof (*ixa));
 	ixa->ixa_refcnt = 1;
 	/*
@@ -891,6 +911,11 @@ ixa_safe_copy(ip_xmit_attr_t *src, ip_xmit_attr_t *ixa)
 	ixa->ixa_dce = NULL;
 	ixa->ixa_ire_generation = IRE_GENERATION_VERIFY;
 	ixa->ixa_dce_generation = DCE_GENERATION_VERIFY;
+
+	/* The cached routes' references stay with the source ixa */
+	for (i = 0; i < IXA_DSTCACHE_SIZE; i++)
+		ixa->ixa_dstcache[i].ixd_ire = NULL;
+	ixa->ixa_dstcache_next = 0;
 #ifdef DEBUG
 	ixa->ixa_curthread = NULL;
 #endif
@@ -932,6 +957,7 @@ ip_xmit_attr_t *
 ip_xmit_attr_duplicate(ip_xmit_attr_t *src_ixa)
 {
 	ip_xmit_attr_t *ixa;
+	uint_t i;
 
 	ixa = kmem_alloc(sizeof (*ixa), KM_NOSLEEP);
 	if (ixa == NULL)
@@ -945,6 +971,10 @@ ip_xmit_attr_duplicate(ip_xmit_attr_t *src_ixa)
 		nce_refhold(ixa->ixa_nce);
 	if (ixa->ixa_dce != NULL)
 		dce_refhold_notr(ixa->ixa_dce);
+	for (i = 0; i < IXA_DSTCACHE_SIZE; i++) {
+		if (ixa->ixa_dstcache[i].ixd_ire != NULL)
+			ire_refhold_notr(ixa->ixa_dstcache[i].ixd_ire);
+	}
 
 #ifdef DEBUG
 	ixa->ixa_curthread = NULL;
@@ -1086,6 +1116,7 @@ ixa_cleanup(ip_xmit_attr_t *ixa)
 	}
 	ixa->ixa_ire_generation = IRE_GENERATION_VERIFY;
 	ixa->ixa_dce_generation = DCE_GENERATION_VERIFY;
+	ixa_dstcache_flush(ixa);
 	if (ixa->ixa_flags & IXAF_IPSEC_SECURE) {
 		ipsec_out_release_refs(ixa);
 	}
@@ -1186,6 +1217,12 @@ ixa_cleanup_stale(ip_xmit_attr_t *ixa)
 		ixa->ixa_dce = dce;
 		ixa->ixa_dce_generation = DCE_GENERATION_VERIFY;
 	}
+
+	/*
+	 * The destination cache can also pin deleted ires; just drop it
+	 * rather than picking over the entries.
+	 */
+	ixa_dstcache_flush(ixa);
 }
 
 static mblk_t *
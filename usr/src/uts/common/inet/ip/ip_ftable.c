@@ -1070,12 +1070,16 @@ ip_select_route(const in6_addr_t *v6dst, const in6_addr_t v6src,
 	ip_stack_t	*ipst = ixa->ixa_ipst;
 	ipaddr_t	v4dst;
 	in6_addr_t	v6nexthop;
+	in6_addr_t	v6setsrc = ipv6_all_zeros;
 	iaflags_t	ixaflags = ixa->ixa_flags;
 	nce_t		*nce;
 	boolean_t	preferred_src_aware = B_FALSE;
 	boolean_t	verify_src;
 	boolean_t	isv6 = !(ixa->ixa_flags & IXAF_IS_IPV4);
 	int		src_multihoming = IP_SRC_MULTIHOMING(isv6, ipst);
+	boolean_t	use_dstcache;
+	uint_t		generation = IRE_GENERATION_VERIFY;
+	uint_t		i;
 
 	/*
 	 * We only verify that the src has been configured on a selected
@@ -1186,6 +1190,45 @@ ip_select_route(const in6_addr_t *v6dst, const in6_addr_t v6src,
 		return (ire);
 	}
 
+	/*
+	 * Plain unicast lookups - no interface constraint, no IP_NEXTHOP or
+	 * SO_DONTROUTE, no source-based route selection and no per-message
+	 * label - depend only on the destination and zone, so their results
+	 * can be served from ixa_dstcache. A cached entry is usable as long
+	 * as its ire_generation is unchanged; routing changes bump the
+	 * generations of the affected ires (ire_flush_cache_v4/v6) which
+	 * makes the entry miss and fall through to the full lookup.
+	 */
+	use_dstcache = (ixa->ixa_ifindex == 0 &&
+	    !(ixaflags & (IXAF_SCOPEID_SET|IXAF_NEXTHOP_SET|IXAF_DONTROUTE)) &&
+	    !(src_multihoming != 0 && verify_src) &&
+	    ixa->ixa_tsl == NULL);
+
+	if (use_dstcache) {
+		for (i = 0; i < IXA_DSTCACHE_SIZE; i++) {
+			ixa_dstcache_t *ixd = &ixa->ixa_dstcache[i];
+
+			if (ixd->ixd_ire == NULL ||
+			    ixd->ixd_zoneid != ixa->ixa_zoneid ||
+			    !IN6_ARE_ADDR_EQUAL(&ixd->ixd_dst, v6dst))
+				continue;
+			ire = ixd->ixd_ire;
+			if (ire->ire_generation != ixd->ixd_generation ||
+			    IRE_IS_CONDEMNED(ire)) {
+				/* Route changed; drop the stale entry */
+				ire_refrele_notr(ixd->ixd_ire);
+				ixd->ixd_ire = NULL;
+				continue;
+			}
+			ire_refhold(ire);
+			if (generationp != NULL)
+				*generationp = ixd->ixd_generation;
+			if (setsrcp != NULL)
+				*setsrcp = ixd->ixd_setsrc;
+			goto setup_nce;
+		}
+	}
+
 	/* Now for unicast and broadcast */
 	if (ixa->ixa_ifindex != 0 || (ixaflags & IXAF_SCOPEID_SET)) {
 		if (ixaflags & IXAF_SCOPEID_SET) {
@@ -1279,14 +1322,17 @@ retry:
 		IN6_V4MAPPED_TO_IPADDR(&v6nexthop, v4nexthop);
 		ire = ire_route_recursive_v4(v4nexthop, ire_type, ill,
 		    ixa->ixa_zoneid, ixa->ixa_tsl, match_args, IRR_ALLOCATE,
-		    ixa->ixa_xmit_hint, ipst, &v4setsrc, NULL, generationp);
-		if (setsrcp != NULL)
-			IN6_IPADDR_TO_V4MAPPED(v4setsrc, setsrcp);
+		    ixa->ixa_xmit_hint, ipst, &v4setsrc, NULL, &generation);
+		IN6_IPADDR_TO_V4MAPPED(v4setsrc, &v6setsrc);
 	} else {
 		ire = ire_route_recursive_v6(&v6nexthop, ire_type, ill,
 		    ixa->ixa_zoneid, ixa->ixa_tsl, match_args, IRR_ALLOCATE,
-		    ixa->ixa_xmit_hint, ipst, setsrcp, NULL, generationp);
+		    ixa->ixa_xmit_hint, ipst, &v6setsrc, NULL, &generation);
 	}
+	if (generationp != NULL)
+		*generationp = generation;
+	if (setsrcp != NULL)
+		*setsrcp = v6setsrc;
 
 #ifdef DEBUG
 	if (match_args & MATCH_IRE_TESTHIDDEN) {
@@ -1316,6 +1362,30 @@ retry:
 		return (ire);
 	}
 
+	/*
+	 * Remember the result for subsequent sends to this destination.
+	 * Entries whose generation is IRE_GENERATION_VERIFY (e.g., under
+	 * RTF_MULTIRT) must be revalidated on every use, so caching them
+	 * would be pointless.
+	 */
+	if (use_dstcache && generation != IRE_GENERATION_VERIFY &&
+	    !(ire->ire_flags & RTF_MULTIRT)) {
+		ixa_dstcache_t *ixd;
+
+		ixd = &ixa->ixa_dstcache[ixa->ixa_dstcache_next];
+		ixa->ixa_dstcache_next = (ixa->ixa_dstcache_next + 1) %
+		    IXA_DSTCACHE_SIZE;
+		if (ixd->ixd_ire != NULL)
+			ire_refrele_notr(ixd->ixd_ire);
+		ire_refhold_notr(ire);
+		ixd->ixd_ire = ire;
+		ixd->ixd_generation = generation;
+		ixd->ixd_dst = *v6dst;
+		ixd->ixd_setsrc = v6setsrc;
+		ixd->ixd_zoneid = ixa->ixa_zoneid;
+	}
+
+setup_nce:
 	/* Setup ire_nce_cache if it doesn't exist or is condemned. */
 	mutex_enter(&ire->ire_lock);
 	nce = ire->ire_nce_cache;
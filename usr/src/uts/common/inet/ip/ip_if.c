@@ -321,6 +321,13 @@ ill_allocate_mibs(ill_t *ill)
 		return (B_FALSE);
 	}
 
+	ill->ill_hcstats = cpu_uarray_zalloc(ILL_HC_NSTATS, KM_NOSLEEP);
+	if (ill->ill_hcstats == NULL) {
+		kmem_free(ill->ill_ip_mib, sizeof (*ill->ill_ip_mib));
+		ill->ill_ip_mib = NULL;
+		return (B_FALSE);
+	}
+
 	/* Setup static information */
 	SET_MIB(ill->ill_ip_mib->ipIfStatsEntrySize,
 	    sizeof (mib2_ipIfStatsEntry_t));
@@ -359,6 +366,8 @@ ill_allocate_mibs(ill_t *ill)
 	ill->ill_icmp6_mib = kmem_zalloc(sizeof (*ill->ill_icmp6_mib),
 	    KM_NOSLEEP);
 	if (ill->ill_icmp6_mib == NULL) {
+		cpu_uarray_free(ill->ill_hcstats);
+		ill->ill_hcstats = NULL;
 		kmem_free(ill->ill_ip_mib, sizeof (*ill->ill_ip_mib));
 		ill->ill_ip_mib = NULL;
 		return (B_FALSE);
@@ -656,6 +665,8 @@ ill_free_mib(ill_t *ill)
 	 * MIBs.
 	 */
 	if (ill->ill_ip_mib != NULL) {
+		/* Pull in the per-CPU counters before the mib is summed. */
+		ill_hcstat_fold(ill);
 		if (ill->ill_isv6) {
 			ip_mib2_add_ip_stats(&ipst->ips_ip6_mib,
 			    ill->ill_ip_mib);
@@ -667,6 +678,10 @@ ill_free_mib(ill_t *ill)
 		kmem_free(ill->ill_ip_mib, sizeof (*ill->ill_ip_mib));
 		ill->ill_ip_mib = NULL;
 	}
+	if (ill->ill_hcstats != NULL) {
+		cpu_uarray_free(ill->ill_hcstats);
+		ill->ill_hcstats = NULL;
+	}
 	if (ill->ill_icmp6_mib != NULL) {
 		ip_mib2_add_icmp6_stats(&ipst->ips_icmp6_mib,
 		    ill->ill_icmp6_mib);
@@ -187,6 +187,150 @@ ip_accept_tcp(ill_t *ill, ill_rx_ring_t *ip_ring, squeue_t *target_sqp,
 	    last, cnt));
 }
 
+/*
+ * Software generic receive offload (GRO). When ip_gro_enable is set,
+ * back-to-back in-order TCP segments of the same connection arriving
+ * in one chain are coalesced into a single large segment before IP
+ * processing, so that the classifier, the squeue and tcp_input_data()
+ * run once per burst instead of once per MTU-sized packet. Only
+ * segments whose ULP checksum was already verified by the hardware
+ * are eligible, and coalescing is skipped on ills that may forward
+ * (ILLF_ROUTER) since a coalesced segment could exceed the outgoing
+ * MTU. At most ip_gro_max_coalesce segments are combined into one.
+ */
+boolean_t ip_gro_enable = B_TRUE;
+uint_t ip_gro_max_coalesce = 16;
+
+/*
+ * Check whether a packet is eligible for TCP coalescing: an untagged,
+ * hardware-checksummed, unfragmented IPv4 TCP data segment without IP
+ * options and with no flags other than ACK and PSH, fully contained
+ * in a single mblk. On success return the parsed headers, the total
+ * header length and the payload length.
+ */
+static boolean_t
+ip_gro_parse_v4(mblk_t *mp, ipha_t **iphap, tcpha_t **tcphap,
+    uint_t *hlenp, uint_t *plenp)
+{
+	ipha_t	*ipha;
+	tcpha_t	*tcpha;
+	uint_t	len, hlen, tcp_hlen;
+
+	if (DB_REF(mp) > 1 || mp->b_cont != NULL || !OK_32PTR(mp->b_rptr))
+		return (B_FALSE);
+	if (!(DB_CKSUMFLAGS(mp) & HCK_FULLCKSUM_OK))
+		return (B_FALSE);
+	len = MBLKL(mp);
+	if (len < IP_SIMPLE_HDR_LENGTH + sizeof (tcpha_t))
+		return (B_FALSE);
+	ipha = (ipha_t *)mp->b_rptr;
+	if (ipha->ipha_version_and_hdr_length != IP_SIMPLE_HDR_VERSION ||
+	    ipha->ipha_protocol != IPPROTO_TCP)
+		return (B_FALSE);
+	if (ipha->ipha_fragment_offset_and_flags &
+	    (IPH_MF_HTONS | IPH_OFFSET_HTONS))
+		return (B_FALSE);
+	/* No trailing junk such as ethernet padding */
+	if (len != ntohs(ipha->ipha_length))
+		return (B_FALSE);
+	tcpha = (tcpha_t *)((uchar_t *)ipha + IP_SIMPLE_HDR_LENGTH);
+	tcp_hlen = TCP_HDR_LENGTH(tcpha);
+	hlen = IP_SIMPLE_HDR_LENGTH + tcp_hlen;
+	if (tcp_hlen < sizeof (tcpha_t) || len < hlen)
+		return (B_FALSE);
+	if (tcpha->tha_flags & ~(TH_ACK | TH_PUSH))
+		return (B_FALSE);
+	/* A pure ACK carries state we must not swallow */
+	if (len == hlen)
+		return (B_FALSE);
+	*iphap = ipha;
+	*tcphap = tcpha;
+	*hlenp = hlen;
+	*plenp = len - hlen;
+	return (B_TRUE);
+}
+
+/*
+ * Walk a b_next chain of packets and coalesce runs of consecutive
+ * in-order TCP data segments of the same connection into single
+ * large segments. The payload of a merged segment is linked off the
+ * leading packet via b_cont with its headers trimmed, and the leading
+ * IP header is rewritten for the combined length. Segments are only
+ * merged while the headers agree on everything that matters to
+ * tcp_input_data(): the ack, the window and the option bytes (which
+ * makes back-to-back timestamped segments from one burst eligible,
+ * since they normally carry the same TSval). A segment with PSH set
+ * terminates its aggregate. Returns the possibly shortened chain;
+ * the first packet of the chain is never replaced.
+ */
+static mblk_t *
+ip_input_gro_v4(mblk_t *mp_chain)
+{
+	mblk_t		*agg, *cand, *tail;
+	ipha_t		*aipha, *cipha;
+	tcpha_t		*atcpha, *ctcpha;
+	uint_t		ahlen, chlen, aplen, cplen, cnt;
+
+	for (agg = mp_chain; agg != NULL && agg->b_next != NULL;
+	    agg = agg->b_next) {
+		if (!ip_gro_parse_v4(agg, &aipha, &atcpha, &ahlen, &aplen))
+			continue;
+		tail = agg;
+		cnt = 1;
+		while ((cand = agg->b_next) != NULL &&
+		    cnt < ip_gro_max_coalesce) {
+			if (atcpha->tha_flags & TH_PUSH)
+				break;
+			if (!ip_gro_parse_v4(cand, &cipha, &ctcpha, &chlen,
+			    &cplen))
+				break;
+			if (cipha->ipha_src != aipha->ipha_src ||
+			    cipha->ipha_dst != aipha->ipha_dst ||
+			    ctcpha->tha_lport != atcpha->tha_lport ||
+			    ctcpha->tha_fport != atcpha->tha_fport)
+				break;
+			if (cipha->ipha_type_of_service !=
+			    aipha->ipha_type_of_service ||
+			    cipha->ipha_ttl != aipha->ipha_ttl)
+				break;
+			if (chlen != ahlen ||
+			    ctcpha->tha_ack != atcpha->tha_ack ||
+			    ctcpha->tha_win != atcpha->tha_win)
+				break;
+			if (chlen > IP_SIMPLE_HDR_LENGTH + sizeof (tcpha_t) &&
+			    bcmp(atcpha + 1, ctcpha + 1, chlen -
+			    IP_SIMPLE_HDR_LENGTH - sizeof (tcpha_t)) != 0)
+				break;
+			if (ntohl(ctcpha->tha_seq) !=
+			    ntohl(atcpha->tha_seq) + aplen)
+				break;
+			if (ahlen + aplen + cplen > IP_MAXPACKET)
+				break;
+
+			/*
+			 * Unlink the segment, trim its headers and
+			 * append its payload to the aggregate.
+			 */
+			agg->b_next = cand->b_next;
+			cand->b_next = NULL;
+			cand->b_rptr += chlen;
+			tail->b_cont = cand;
+			tail = cand;
+			aplen += cplen;
+			atcpha->tha_flags |= ctcpha->tha_flags & TH_PUSH;
+			cnt++;
+		}
+		if (cnt > 1) {
+			aipha->ipha_length = htons((uint16_t)(ahlen + aplen));
+			aipha->ipha_hdr_checksum = 0;
+			aipha->ipha_hdr_checksum = ip_csum_hdr(aipha);
+			DTRACE_PROBE2(ip__input__gro, mblk_t *, agg,
+			    uint_t, cnt);
+		}
+	}
+	return (mp_chain);
+}
+
 /*
  * Used by ip_input and ip_accept_tcp
  * The last three arguments are only used by ip_accept_tcp, and mhip is
@@ -253,6 +397,17 @@ ip_input_common_v4(ill_t *ill, ill_rx_ring_t *ip_ring, mblk_t *mp_chain,
 	rtc.rtc_ire = NULL;
 	rtc.rtc_ipaddr = INADDR_ANY;
 
+	/*
+	 * Coalesce TCP segments before per-packet processing. The
+	 * first packet of the chain is never replaced, so mhip stays
+	 * valid. Skipped on forwarding ills since a coalesced segment
+	 * could exceed the outgoing MTU.
+	 */
+	if (ip_gro_enable && mp_chain->b_next != NULL &&
+	    !(chain_flags & (IRAF_L2DST_MULTICAST | IRAF_L2DST_BROADCAST)) &&
+	    !(ill->ill_flags & ILLF_ROUTER))
+		mp_chain = ip_input_gro_v4(mp_chain);
+
 	/* Loop over b_next */
 	for (mp = mp_chain; mp != NULL; mp = mp_chain) {
 		mp_chain = mp->b_next;
@@ -359,10 +514,10 @@ ip_input_common_v4(ill_t *ill, ill_rx_ring_t *ip_ring, mblk_t *mp_chain,
 		 * up being dropped later on. Defer counting bytes until
 		 * we have the whole IP header in first mblk.
 		 */
-		BUMP_MIB(ill->ill_ip_mib, ipIfStatsHCInReceives);
+		ILL_HCSTAT_BUMP(ill, ILL_HC_IN_RECEIVES);
 
 		iras.ira_pktlen = ntohs(ipha->ipha_length);
-		UPDATE_MIB(ill->ill_ip_mib, ipIfStatsHCInOctets,
+		ILL_HCSTAT_UPDATE(ill, ILL_HC_IN_OCTETS,
 		    iras.ira_pktlen);
 
 		/*
@@ -960,7 +1115,7 @@ ire_recv_forward_v4(ire_t *ire, mblk_t *mp, void *iph_arg, ip_recv_attr_t *ira)
 	 * will be an attempt to forward the packet, which is why we
 	 * increment after the above condition has been checked.
 	 */
-	BUMP_MIB(ill->ill_ip_mib, ipIfStatsHCInForwDatagrams);
+	ILL_HCSTAT_BUMP(ill, ILL_HC_IN_FORW_DATAGRAMS);
 
 	/* Initiate Read side IPPF processing */
 	if (IPP_ENABLED(IPP_FWD_IN, ipst)) {
@@ -1174,7 +1329,7 @@ ip_forward_xmit_v4(nce_t *nce, ill_t *ill, mblk_t *mp, ipha_t *ipha,
 
 	pkt_len = ira->ira_pktlen;
 
-	BUMP_MIB(dst_ill->ill_ip_mib, ipIfStatsHCOutForwDatagrams);
+	ILL_HCSTAT_BUMP(dst_ill, ILL_HC_OUT_FORW_DATAGRAMS);
 
 	ixaflags = IXAF_IS_IPV4 | IXAF_NO_DEV_FLOW_CTL;
 
@@ -1264,7 +1419,7 @@ ire_recv_noroute_v4(ire_t *ire, mblk_t *mp, void *iph_arg, ip_recv_attr_t *ira)
 	 * will be an attempt to forward the packet, which is why we
 	 * increment after the above condition has been checked.
 	 */
-	BUMP_MIB(ill->ill_ip_mib, ipIfStatsHCInForwDatagrams);
+	ILL_HCSTAT_BUMP(ill, ILL_HC_IN_FORW_DATAGRAMS);
 
 	BUMP_MIB(ill->ill_ip_mib, ipIfStatsInNoRoutes);
 
@@ -2490,7 +2645,7 @@ ip_fanout_v4(mblk_t *mp, ipha_t *ipha, ip_recv_attr_t *ira)
 		    ira, ipst);
 		if (connp == NULL) {
 			/* Send the TH_RST */
-			BUMP_MIB(ill->ill_ip_mib, ipIfStatsHCInDelivers);
+			ILL_HCSTAT_BUMP(ill, ILL_HC_IN_DELIVERS);
 			tcp_xmit_listeners_reset(mp, ira, ipst, NULL);
 			return;
 		}
@@ -2499,7 +2654,7 @@ ip_fanout_v4(mblk_t *mp, ipha_t *ipha, ip_recv_attr_t *ira)
 			CONN_DEC_REF(connp);
 
 			/* Send the TH_RST */
-			BUMP_MIB(ill->ill_ip_mib, ipIfStatsHCInDelivers);
+			ILL_HCSTAT_BUMP(ill, ILL_HC_IN_DELIVERS);
 			tcp_xmit_listeners_reset(mp, ira, ipst, NULL);
 			return;
 		}
@@ -2516,7 +2671,7 @@ ip_fanout_v4(mblk_t *mp, ipha_t *ipha, ip_recv_attr_t *ira)
 			}
 		}
 		/* Found a client; up it goes */
-		BUMP_MIB(ill->ill_ip_mib, ipIfStatsHCInDelivers);
+		ILL_HCSTAT_BUMP(ill, ILL_HC_IN_DELIVERS);
 		ira->ira_ill = ira->ira_rill = NULL;
 		if (!IPCL_IS_TCP(connp)) {
 			/* Not TCP; must be SOCK_RAW, IPPROTO_TCP */
@@ -2622,7 +2777,7 @@ ip_fanout_v4(mblk_t *mp, ipha_t *ipha, ip_recv_attr_t *ira)
 		}
 
 		/* Found a client; up it goes */
-		BUMP_MIB(ill->ill_ip_mib, ipIfStatsHCInDelivers);
+		ILL_HCSTAT_BUMP(ill, ILL_HC_IN_DELIVERS);
 		sctp_input(connp, ipha, NULL, mp, ira);
 		/* sctp_input does a rele of the sctp_t */
 		return;
@@ -2712,7 +2867,7 @@ ip_fanout_v4(mblk_t *mp, ipha_t *ipha, ip_recv_attr_t *ira)
 		}
 		/* Found a client; up it goes */
 		IP_STAT(ipst, ip_udp_fannorm);
-		BUMP_MIB(ill->ill_ip_mib, ipIfStatsHCInDelivers);
+		ILL_HCSTAT_BUMP(ill, ILL_HC_IN_DELIVERS);
 		ira->ira_ill = ira->ira_rill = NULL;
 		(connp->conn_recv)(connp, mp, NULL, ira);
 		CONN_DEC_REF(connp);
@@ -2773,7 +2928,7 @@ ip_fanout_v4(mblk_t *mp, ipha_t *ipha, ip_recv_attr_t *ira)
 			freemsg(mp);
 			return;
 		}
-		BUMP_MIB(ill->ill_ip_mib, ipIfStatsHCInDelivers);
+		ILL_HCSTAT_BUMP(ill, ILL_HC_IN_DELIVERS);
 		mp = icmp_inbound_v4(mp, ira);
 		if (mp == NULL) {
 			/* No need to pass to RAW sockets */
@@ -2809,7 +2964,7 @@ ip_fanout_v4(mblk_t *mp, ipha_t *ipha, ip_recv_attr_t *ira)
 			return;
 		}
 
-		BUMP_MIB(ill->ill_ip_mib, ipIfStatsHCInDelivers);
+		ILL_HCSTAT_BUMP(ill, ILL_HC_IN_DELIVERS);
 		mp = igmp_input(mp, ira);
 		if (mp == NULL) {
 			/* Bad packet - discarded by igmp_input */
@@ -2834,7 +2989,7 @@ ip_fanout_v4(mblk_t *mp, ipha_t *ipha, ip_recv_attr_t *ira)
 			freemsg(mp);
 			return;
 		}
-		BUMP_MIB(ill->ill_ip_mib, ipIfStatsHCInDelivers);
+		ILL_HCSTAT_BUMP(ill, ILL_HC_IN_DELIVERS);
 
 		/* Checksum is verified in pim_input */
 		mp = pim_input(mp, ira);
@@ -2858,7 +3013,7 @@ ip_fanout_v4(mblk_t *mp, ipha_t *ipha, ip_recv_attr_t *ira)
 			return;
 		}
 
-		BUMP_MIB(ill->ill_ip_mib, ipIfStatsHCInDelivers);
+		ILL_HCSTAT_BUMP(ill, ILL_HC_IN_DELIVERS);
 		/* select inbound SA and have IPsec process the pkt */
 		if (protocol == IPPROTO_ESP) {
 			esph_t *esph;
@@ -3067,7 +3222,7 @@ ip_fanout_v4(mblk_t *mp, ipha_t *ipha, ip_recv_attr_t *ira)
 		connp = ipcl_classify_v4(mp, protocol, ip_hdr_length,
 		    ira, ipst);
 		if (connp != NULL) {
-			BUMP_MIB(ill->ill_ip_mib, ipIfStatsHCInDelivers);
+			ILL_HCSTAT_BUMP(ill, ILL_HC_IN_DELIVERS);
 			ira->ira_ill = ira->ira_rill = NULL;
 			(connp->conn_recv)(connp, mp, NULL, ira);
 			CONN_DEC_REF(connp);
@@ -358,7 +358,7 @@ conn_ip_output(mblk_t *mp, ip_xmit_attr_t *ixa)
 	 * counters on the ill will be incremented in post fragmentation.
 	 */
 	ire->ire_ob_pkt_count++;
-	BUMP_MIB(ill->ill_ip_mib, ipIfStatsHCOutRequests);
+	ILL_HCSTAT_BUMP(ill, ILL_HC_OUT_REQUESTS);
 
 	/*
 	 * Based on ire_type and ire_flags call one of:
@@ -984,7 +984,7 @@ repeat_ire:
 			    &src, NULL, NULL);
 		}
 		if (error != 0) {
-			BUMP_MIB(ill->ill_ip_mib, ipIfStatsHCOutRequests);
+			ILL_HCSTAT_BUMP(ill, ILL_HC_OUT_REQUESTS);
 			BUMP_MIB(ill->ill_ip_mib, ipIfStatsOutDiscards);
 			ip_drop_output("ipIfStatsOutDiscards - no source",
 			    mp, ill);
@@ -1021,7 +1021,7 @@ repeat_ire:
 	}
 
 	if (ill != NULL) {
-		BUMP_MIB(ill->ill_ip_mib, ipIfStatsHCOutRequests);
+		ILL_HCSTAT_BUMP(ill, ILL_HC_OUT_REQUESTS);
 	} else {
 		BUMP_MIB(&ipst->ips_ip_mib, ipIfStatsHCOutRequests);
 	}
@@ -1185,8 +1185,8 @@ ire_send_local_v4(ire_t *ire, mblk_t *mp, void *iph_arg,
 	    int, 1);
 
 	ire->ire_ib_pkt_count++;
-	BUMP_MIB(ill->ill_ip_mib, ipIfStatsHCInReceives);
-	UPDATE_MIB(ill->ill_ip_mib, ipIfStatsHCInOctets, pktlen);
+	ILL_HCSTAT_BUMP(ill, ILL_HC_IN_RECEIVES);
+	ILL_HCSTAT_UPDATE(ill, ILL_HC_IN_OCTETS, pktlen);
 
 	/* Destined to ire_zoneid - use that for fanout */
 	iras.ira_zoneid = ire->ire_zoneid;
@@ -2079,8 +2079,8 @@ ip_postfrag_loopback(mblk_t *mp, nce_t *nce, iaflags_t ixaflags,
 	iras.ira_tsl = NULL;
 	iras.ira_zoneid = ALL_ZONES;
 	iras.ira_pktlen = pkt_len;
-	UPDATE_MIB(ill->ill_ip_mib, ipIfStatsHCInOctets, iras.ira_pktlen);
-	BUMP_MIB(ill->ill_ip_mib, ipIfStatsHCInReceives);
+	ILL_HCSTAT_UPDATE(ill, ILL_HC_IN_OCTETS, iras.ira_pktlen);
+	ILL_HCSTAT_BUMP(ill, ILL_HC_IN_RECEIVES);
 
 	if (ixaflags & IXAF_IS_IPV4)
 		iras.ira_flags |= IRAF_IS_IPV4;
@@ -92,7 +92,9 @@
  *	another CPU.
  *
  * o When the CPU is going online, it creates a new squeue for this CPU if
- *	necessary and binds the squeue worker thread to this CPU.
+ *	necessary and binds the squeue worker thread to this CPU.  Ring
+ *	squeues that were unbound when this CPU went offline are moved back
+ *	and re-bound so that rx ring locality is restored.
  *
  * TUNABLES:
  *
@@ -733,6 +735,34 @@ ip_squeue_set_destroy(cpu_t *cpu)
 	kmem_free(sqs, sizeof (*sqs));
 }
 
+/*
+ * Called when a CPU comes back online. Ring squeues that were unbound
+ * when the CPU went offline still remember it in sq_bind; move them
+ * back from the unbound set and re-bind their workers so that rx ring
+ * locality is restored without waiting for the mac layer to re-assign
+ * the ring.
+ */
+static void
+ip_squeue_set_rebind(cpu_t *cpu)
+{
+	squeue_t *sqp, *next;
+	squeue_set_t *sqs = cpu->cpu_squeue_set;
+	squeue_set_t *unbound;
+
+	ASSERT(MUTEX_HELD(&cpu_lock));
+	ASSERT(sqs != NULL);
+
+	mutex_enter(&sqset_lock);
+	unbound = sqset_global_list[0];
+	for (sqp = unbound->sqs_head; sqp != NULL; sqp = next) {
+		next = sqp->sq_next;
+		if ((sqp->sq_state & SQS_ILL_BOUND) &&
+		    sqp->sq_bind == cpu->cpu_id)
+			ip_squeue_set_move(sqp, sqs);
+	}
+	mutex_exit(&sqset_lock);
+}
+
 /*
  * Reconfiguration callback
  */
@@ -748,8 +778,13 @@ ip_squeue_cpu_setup(cpu_setup_t what, int id, void *arg)
 	case CPU_ON:
 	case CPU_INIT:
 	case CPU_CPUPART_IN:
-		if (CPU_ISON(cp) && cp->cpu_squeue_set == NULL)
-			cp->cpu_squeue_set = ip_squeue_set_create(cp->cpu_id);
+		if (CPU_ISON(cp)) {
+			if (cp->cpu_squeue_set == NULL) {
+				cp->cpu_squeue_set =
+				    ip_squeue_set_create(cp->cpu_id);
+			}
+			ip_squeue_set_rebind(cp);
+		}
 		break;
 	case CPU_UNCONFIG:
 	case CPU_OFF:
@@ -243,6 +243,7 @@
 #include <sys/ddi.h>
 #include <sys/cmn_err.h>
 #include <sys/debug.h>
+#include <sys/kstat.h>
 
 #include <sys/systm.h>
 #include <sys/param.h>
@@ -273,6 +274,7 @@
 
 #include <sys/tsol/tnet.h>
 #include <sys/sockio.h>
+#include <sys/zone.h>
 
 /* Old value for compatibility. Setable in /etc/system */
 uint_t tcp_conn_hash_size = 0;
@@ -340,6 +342,9 @@ static void	rawip_conn_destructor(void *, void *);
 static int	rts_conn_constructor(void *, void *, int);
 static void	rts_conn_destructor(void *, void *);
 
+static conn_t	*ipcl_reuseport_select(connf_t *, conn_t *, uint32_t,
+		    zoneid_t);
+
 /*
  * Global (for all stack instances) init routine
  */
@@ -370,6 +375,136 @@ ipcl_g_init(void)
 	    sizeof (itc_t) + sizeof (rts_t), CACHE_ALIGN_SIZE,
 	    rts_conn_constructor, rts_conn_destructor,
 	    NULL, NULL, NULL, 0);
+
+	kmem_cache_set_zone_class(ip_conn_cache, ZONE_KMEM_CLASS_CONN);
+	kmem_cache_set_zone_class(tcp_conn_cache, ZONE_KMEM_CLASS_CONN);
+	kmem_cache_set_zone_class(udp_conn_cache, ZONE_KMEM_CLASS_CONN);
+	kmem_cache_set_zone_class(rawip_conn_cache, ZONE_KMEM_CLASS_CONN);
+	kmem_cache_set_zone_class(rts_conn_cache, ZONE_KMEM_CLASS_CONN);
+}
+
+/*
+ * Named kstats describing the occupancy of the connection fanout
+ * table: total size, number of connections and a bucket-depth
+ * histogram. These are computed on demand by walking the table, so
+ * the datapath pays nothing for them; operators can use them to tell
+ * when the table is undersized for the connection load and bump
+ * ipcl_conn_hash_size accordingly.
+ */
+typedef struct ipcl_conn_hash_stats {
+	kstat_named_t	ichs_size;
+	kstat_named_t	ichs_conns;
+	kstat_named_t	ichs_maxdepth;
+	kstat_named_t	ichs_depth_0;
+	kstat_named_t	ichs_depth_1;
+	kstat_named_t	ichs_depth_2;
+	kstat_named_t	ichs_depth_3_4;
+	kstat_named_t	ichs_depth_5_8;
+	kstat_named_t	ichs_depth_9_16;
+	kstat_named_t	ichs_depth_gt_16;
+} ipcl_conn_hash_stats_t;
+
+static int
+ipcl_conn_hash_kstat_update(kstat_t *ksp, int rw)
+{
+	netstackid_t	stackid = (netstackid_t)(uintptr_t)ksp->ks_private;
+	netstack_t	*ns;
+	ip_stack_t	*ipst;
+	ipcl_conn_hash_stats_t *stats = ksp->ks_data;
+	uint64_t	conns = 0, maxdepth = 0;
+	uint64_t	hist[7] = { 0 };
+	uint_t		i;
+
+	if (rw == KSTAT_WRITE)
+		return (EACCES);
+
+	ns = netstack_find_by_stackid(stackid);
+	if (ns == NULL)
+		return (-1);
+	ipst = ns->netstack_ip;
+	if (ipst == NULL) {
+		netstack_rele(ns);
+		return (-1);
+	}
+
+	for (i = 0; i < ipst->ips_ipcl_conn_fanout_size; i++) {
+		connf_t	*connfp = &ipst->ips_ipcl_conn_fanout[i];
+		conn_t	*connp;
+		uint64_t depth = 0;
+
+		mutex_enter(&connfp->connf_lock);
+		for (connp = connfp->connf_head; connp != NULL;
+		    connp = connp->conn_next)
+			depth++;
+		mutex_exit(&connfp->connf_lock);
+
+		conns += depth;
+		if (depth > maxdepth)
+			maxdepth = depth;
+		if (depth <= 2)
+			hist[depth]++;
+		else if (depth <= 4)
+			hist[3]++;
+		else if (depth <= 8)
+			hist[4]++;
+		else if (depth <= 16)
+			hist[5]++;
+		else
+			hist[6]++;
+	}
+
+	stats->ichs_size.value.ui64 = ipst->ips_ipcl_conn_fanout_size;
+	stats->ichs_conns.value.ui64 = conns;
+	stats->ichs_maxdepth.value.ui64 = maxdepth;
+	stats->ichs_depth_0.value.ui64 = hist[0];
+	stats->ichs_depth_1.value.ui64 = hist[1];
+	stats->ichs_depth_2.value.ui64 = hist[2];
+	stats->ichs_depth_3_4.value.ui64 = hist[3];
+	stats->ichs_depth_5_8.value.ui64 = hist[4];
+	stats->ichs_depth_9_16.value.ui64 = hist[5];
+	stats->ichs_depth_gt_16.value.ui64 = hist[6];
+
+	netstack_rele(ns);
+	return (0);
+}
+
+static void
+ipcl_conn_hash_kstat_init(ip_stack_t *ipst)
+{
+	static const ipcl_conn_hash_stats_t template = {
+		{ "size",		KSTAT_DATA_UINT64 },
+		{ "conns",		KSTAT_DATA_UINT64 },
+		{ "maxdepth",		KSTAT_DATA_UINT64 },
+		{ "depth_0",		KSTAT_DATA_UINT64 },
+		{ "depth_1",		KSTAT_DATA_UINT64 },
+		{ "depth_2",		KSTAT_DATA_UINT64 },
+		{ "depth_3_4",		KSTAT_DATA_UINT64 },
+		{ "depth_5_8",		KSTAT_DATA_UINT64 },
+		{ "depth_9_16",		KSTAT_DATA_UINT64 },
+		{ "depth_gt_16",	KSTAT_DATA_UINT64 },
+	};
+	netstackid_t	stackid = ipst->ips_netstack->netstack_stackid;
+	kstat_t		*ksp;
+
+	ksp = kstat_create_netstack("ip", stackid, "ipcl_conn_hash", "net",
+	    KSTAT_TYPE_NAMED, sizeof (template) / sizeof (kstat_named_t),
+	    0, stackid);
+	if (ksp == NULL)
+		return;
+
+	bcopy(&template, ksp->ks_data, sizeof (template));
+	ksp->ks_update = ipcl_conn_hash_kstat_update;
+	ksp->ks_private = (void *)(uintptr_t)stackid;
+
+	/*
+	 * If this is an exclusive netstack for a local zone, the global zone
+	 * should still be able to read the kstat.
+	 */
+	if (stackid != GLOBAL_NETSTACKID)
+		kstat_zone_add(ksp, GLOBAL_ZONEID);
+
+	kstat_install(ksp);
+	ipst->ips_ipcl_conn_hash_ksp = ksp;
 }
 
 /*
@@ -479,6 +614,8 @@ ipcl_init(ip_stack_t *ipst)
 		mutex_init(&ipst->ips_ipcl_globalhash_fanout[i].connf_lock,
 		    NULL, MUTEX_DEFAULT, NULL);
 	}
+
+	ipcl_conn_hash_kstat_init(ipst);
 }
 
 void
@@ -500,6 +637,12 @@ ipcl_destroy(ip_stack_t *ipst)
 {
 	int i;
 
+	if (ipst->ips_ipcl_conn_hash_ksp != NULL) {
+		kstat_delete_netstack(ipst->ips_ipcl_conn_hash_ksp,
+		    ipst->ips_netstack->netstack_stackid);
+		ipst->ips_ipcl_conn_hash_ksp = NULL;
+	}
+
 	for (i = 0; i < ipst->ips_ipcl_conn_fanout_size; i++) {
 		ASSERT(ipst->ips_ipcl_conn_fanout[i].connf_head == NULL);
 		mutex_destroy(&ipst->ips_ipcl_conn_fanout[i].connf_lock);
@@ -1549,33 +1692,45 @@ ipcl_classify_v4(mblk_t *mp, uint8_t protocol, uint_t hdr_len,
 		connfp =
 		    &ipst->ips_ipcl_conn_fanout[IPCL_CONN_HASH(ipha->ipha_src,
 		    ports, ipst)];
-		mutex_enter(&connfp->connf_lock);
-		for (connp = connfp->connf_head; connp != NULL;
-		    connp = connp->conn_next) {
-			if (IPCL_CONN_MATCH(connp, protocol,
-			    ipha->ipha_src, ipha->ipha_dst, ports) &&
-			    (connp->conn_zoneid == zoneid ||
-			    connp->conn_allzones ||
-			    ((connp->conn_mac_mode != CONN_MAC_DEFAULT) &&
-			    (ira->ira_flags & IRAF_TX_MAC_EXEMPTABLE) &&
-			    (ira->ira_flags & IRAF_TX_SHARED_ADDR))))
-				break;
-		}
+		/*
+		 * Checking for an empty bucket without the lock is a benign
+		 * race: a connection inserted after we look is
+		 * indistinguishable from one inserted just after
+		 * classification, and any data destined for it causally
+		 * follows the insertion.  A miss here simply falls through
+		 * to the bind fanout below, as it always has.
+		 */
+		if (connfp->connf_head != NULL) {
+			mutex_enter(&connfp->connf_lock);
+			for (connp = connfp->connf_head; connp != NULL;
+			    connp = connp->conn_next) {
+				if (IPCL_CONN_MATCH(connp, protocol,
+				    ipha->ipha_src, ipha->ipha_dst, ports) &&
+				    (connp->conn_zoneid == zoneid ||
+				    connp->conn_allzones ||
+				    ((connp->conn_mac_mode !=
+				    CONN_MAC_DEFAULT) &&
+				    (ira->ira_flags & IRAF_TX_MAC_EXEMPTABLE) &&
+				    (ira->ira_flags & IRAF_TX_SHARED_ADDR))))
+					break;
+			}
+
+			if (connp != NULL) {
+				/*
+				 * We have a fully-bound TCP connection.
+				 *
+				 * For labeled systems, there's no need to
+				 * check the label here.  It's known to be
+				 * good as we checked before allowing the
+				 * connection to become bound.
+				 */
+				CONN_INC_REF(connp);
+				mutex_exit(&connfp->connf_lock);
+				return (connp);
+			}
 
-		if (connp != NULL) {
-			/*
-			 * We have a fully-bound TCP connection.
-			 *
-			 * For labeled systems, there's no need to check the
-			 * label here.  It's known to be good as we checked
-			 * before allowing the connection to become bound.
-			 */
-			CONN_INC_REF(connp);
 			mutex_exit(&connfp->connf_lock);
-			return (connp);
 		}
-
-		mutex_exit(&connfp->connf_lock);
 		lport = up[1];
 		bind_connfp =
 		    &ipst->ips_ipcl_bind_fanout[IPCL_BIND_HASH(lport, ipst)];
@@ -1636,6 +1791,19 @@ ipcl_classify_v4(mblk_t *mp, uint8_t protocol, uint_t hdr_len,
 				break;
 		}
 
+		/*
+		 * An unconnected match with SO_REUSEPORT set is part of a
+		 * load-spreading group; pick the member this flow hashes to.
+		 * Connected endpoints sort ahead of bound ones in the bucket,
+		 * so a flow claimed by connect() is never reassigned here.
+		 */
+		if (connp != NULL && connp->conn_reuseport &&
+		    _IPCL_V4_MATCH_ANY(connp->conn_faddr_v6)) {
+			connp = ipcl_reuseport_select(connfp, connp,
+			    IPCL_REUSEPORT_HASH(ipha->ipha_src,
+			    *(uint32_t *)up), zoneid);
+		}
+
 		if (connp != NULL && (ira->ira_flags & IRAF_SYSTEM_LABELED) &&
 		    !tsol_receive_local(mp, &ipha->ipha_dst, IPV4_VERSION,
 		    ira, connp)) {
@@ -1667,6 +1835,52 @@ ipcl_classify_v4(mblk_t *mp, uint8_t protocol, uint_t hdr_len,
 	return (NULL);
 }
 
+/*
+ * The inbound UDP lookup matched an unconnected endpoint belonging to
+ * a SO_REUSEPORT group; reselect among the group's members using the
+ * caller's flow hash.  All members are bound to the identical local
+ * address and port (enforced at bind time in udp_do_bind()), so any
+ * member visible in the packet's zone is an equally valid destination,
+ * and hashing on the flow keeps each flow on one socket.  "first" is
+ * the member the plain lookup found; it anchors the group and is the
+ * fallback, which also guarantees a non-empty selection set.  Called,
+ * and returns, with connfp's lock held.
+ */
+static conn_t *
+ipcl_reuseport_select(connf_t *connfp, conn_t *first, uint32_t hash,
+    zoneid_t zoneid)
+{
+	conn_t	*connp;
+	uint_t	count = 0, idx;
+
+	ASSERT(MUTEX_HELD(&connfp->connf_lock));
+
+#define	IPCL_REUSEPORT_MEMBER(connp)					\
+	((connp) == first || ((connp)->conn_reuseport &&		\
+	(connp)->conn_lport == first->conn_lport &&			\
+	IN6_ARE_ADDR_EQUAL(&(connp)->conn_laddr_v6,			\
+	    &first->conn_laddr_v6) &&					\
+	IN6_ARE_ADDR_EQUAL(&(connp)->conn_faddr_v6,			\
+	    &first->conn_faddr_v6) &&					\
+	((connp)->conn_zoneid == (zoneid) || (connp)->conn_allzones)))
+
+	for (connp = first; connp != NULL; connp = connp->conn_next) {
+		if (IPCL_REUSEPORT_MEMBER(connp))
+			count++;
+	}
+
+	ASSERT(count >= 1);
+	idx = hash % count;
+
+	for (connp = first; connp != NULL; connp = connp->conn_next) {
+		if (IPCL_REUSEPORT_MEMBER(connp) && idx-- == 0)
+			return (connp);
+	}
+#undef	IPCL_REUSEPORT_MEMBER
+
+	return (first);
+}
+
 conn_t *
 ipcl_classify_v6(mblk_t *mp, uint8_t protocol, uint_t hdr_len,
     ip_recv_attr_t *ira, ip_stack_t *ipst)
@@ -1692,34 +1906,42 @@ ipcl_classify_v6(mblk_t *mp, uint8_t protocol, uint_t hdr_len,
 		connfp =
 		    &ipst->ips_ipcl_conn_fanout[IPCL_CONN_HASH_V6(ip6h->ip6_src,
 		    ports, ipst)];
-		mutex_enter(&connfp->connf_lock);
-		for (connp = connfp->connf_head; connp != NULL;
-		    connp = connp->conn_next) {
-			if (IPCL_CONN_MATCH_V6(connp, protocol,
-			    ip6h->ip6_src, ip6h->ip6_dst, ports) &&
-			    (connp->conn_zoneid == zoneid ||
-			    connp->conn_allzones ||
-			    ((connp->conn_mac_mode != CONN_MAC_DEFAULT) &&
-			    (ira->ira_flags & IRAF_TX_MAC_EXEMPTABLE) &&
-			    (ira->ira_flags & IRAF_TX_SHARED_ADDR))))
-				break;
-		}
+		/*
+		 * As for v4 above, the unlocked emptiness check is a benign
+		 * race; a miss falls through to the bind fanout below.
+		 */
+		if (connfp->connf_head != NULL) {
+			mutex_enter(&connfp->connf_lock);
+			for (connp = connfp->connf_head; connp != NULL;
+			    connp = connp->conn_next) {
+				if (IPCL_CONN_MATCH_V6(connp, protocol,
+				    ip6h->ip6_src, ip6h->ip6_dst, ports) &&
+				    (connp->conn_zoneid == zoneid ||
+				    connp->conn_allzones ||
+				    ((connp->conn_mac_mode !=
+				    CONN_MAC_DEFAULT) &&
+				    (ira->ira_flags & IRAF_TX_MAC_EXEMPTABLE) &&
+				    (ira->ira_flags & IRAF_TX_SHARED_ADDR))))
+					break;
+			}
+
+			if (connp != NULL) {
+				/*
+				 * We have a fully-bound TCP connection.
+				 *
+				 * For labeled systems, there's no need to
+				 * check the label here.  It's known to be
+				 * good as we checked before allowing the
+				 * connection to become bound.
+				 */
+				CONN_INC_REF(connp);
+				mutex_exit(&connfp->connf_lock);
+				return (connp);
+			}
 
-		if (connp != NULL) {
-			/*
-			 * We have a fully-bound TCP connection.
-			 *
-			 * For labeled systems, there's no need to check the
-			 * label here.  It's known to be good as we checked
-			 * before allowing the connection to become bound.
-			 */
-			CONN_INC_REF(connp);
 			mutex_exit(&connfp->connf_lock);
-			return (connp);
 		}
 
-		mutex_exit(&connfp->connf_lock);
-
 		lport = up[1];
 		bind_connfp =
 		    &ipst->ips_ipcl_bind_fanout[IPCL_BIND_HASH(lport, ipst)];
@@ -1773,6 +1995,15 @@ ipcl_classify_v6(mblk_t *mp, uint8_t protocol, uint_t hdr_len,
 				break;
 		}
 
+		/* See the SO_REUSEPORT comment in ipcl_classify_v4(). */
+		if (connp != NULL && connp->conn_reuseport &&
+		    IN6_IS_ADDR_UNSPECIFIED(&connp->conn_faddr_v6)) {
+			connp = ipcl_reuseport_select(connfp, connp,
+			    IPCL_REUSEPORT_HASH(
+			    V4_PART_OF_V6(ip6h->ip6_src),
+			    *(uint32_t *)up), zoneid);
+		}
+
 		if (connp != NULL && (ira->ira_flags & IRAF_SYSTEM_LABELED) &&
 		    !tsol_receive_local(mp, &ip6h->ip6_dst, IPV6_VERSION,
 		    ira, connp)) {
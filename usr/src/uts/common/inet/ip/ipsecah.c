@@ -1554,6 +1554,17 @@ ah_set_usetime(ipsa_t *assoc, boolean_t inbound)
 	netstack_t	*ns = assoc->ipsa_netstack;
 	ipsecah_stack_t	*ahstack = ns->netstack_ipsecah;
 
+	/*
+	 * Use time has one-second granularity, and the peer SA (if any) is
+	 * always stamped in the same pass as this one, so if this SA was
+	 * already stamped during the current second there is nothing to do.
+	 * This keeps the per-packet cost down to an unlocked read instead
+	 * of a peer hash lookup and a pair of mutex acquisitions.
+	 */
+	if (assoc->ipsa_usetime != 0 &&
+	    assoc->ipsa_lastuse == gethrestime_sec())
+		return;
+
 	/* No peer?  No problem! */
 	if (!assoc->ipsa_haspeer) {
 		sadb_set_usetime(assoc);
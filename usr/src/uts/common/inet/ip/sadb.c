@@ -3719,6 +3719,15 @@ sadb_set_usetime(ipsa_t *assoc)
 {
 	time_t snapshot = gethrestime_sec();
 
+	/*
+	 * Use time has one-second granularity, so if this SA was already
+	 * stamped during the current second there is nothing to update
+	 * and we can skip the lock entirely.  The unlocked read is benign;
+	 * at worst a racing thread re-stamps the same second.
+	 */
+	if (assoc->ipsa_usetime != 0 && assoc->ipsa_lastuse == snapshot)
+		return;
+
 	mutex_enter(&assoc->ipsa_lock);
 	assoc->ipsa_lastuse = snapshot;
 	assoc->ipsa_idleexpiretime = snapshot + assoc->ipsa_idletime;
@@ -206,6 +206,7 @@ struct ip_stack {
 	uint_t		ips_ipcl_iptun_fanout_size;
 	struct connf_s	*ips_ipcl_globalhash_fanout;
 	int		ips_conn_g_index;
+	kstat_t		*ips_ipcl_conn_hash_ksp;
 
 /* ip.c */
 	/* Following protected by igmp_timer_lock */
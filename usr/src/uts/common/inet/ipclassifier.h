@@ -299,7 +299,8 @@ struct conn_s {
 		conn_ipv6_recvpathmtu : 1,	/* IPV6_RECVPATHMTU */
 		conn_mcbc_bind : 1,		/* Bound to multi/broadcast */
 
-		conn_pad_to_bit_31 : 12;
+		conn_reuseport : 1,		/* SO_REUSEPORT state */
+		conn_pad_to_bit_31 : 11;
 
 	boolean_t	conn_blocked;		/* conn is flow-controlled */
 
@@ -657,6 +658,15 @@ struct connf_s {
 #define	IPCL_UDP_HASH(lport, ipst)	\
 	IPCL_PORT_HASH(lport, (ipst)->ips_ipcl_udp_fanout_size)
 
+/*
+ * Flow hash used to spread inbound packets across the members of a
+ * SO_REUSEPORT group.  It must depend only on the packet's addresses
+ * and ports so that all packets of one flow land on the same member.
+ */
+#define	IPCL_REUSEPORT_HASH(src, ports)					\
+	((unsigned)(ntohl((src)) ^ ((ports) >> 24) ^ ((ports) >> 16) ^	\
+	((ports) >> 8) ^ (ports)))
+
 #define	CONN_G_HASH_SIZE	1024
 
 /* Raw socket hash function. */
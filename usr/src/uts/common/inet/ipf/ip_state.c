@@ -62,6 +62,7 @@ struct file;
 # include <sys/byteorder.h>
 # ifdef _KERNEL
 #  include <sys/dditypes.h>
+#  include <sys/cpuvar.h>
 # endif
 # include <sys/stream.h>
 # include <sys/kmem.h>
@@ -126,6 +127,7 @@ static int fr_state_flush __P((int, int, ipf_stack_t *));
 static ips_stat_t *fr_statetstats __P((ipf_stack_t *));
 static int fr_state_remove __P((caddr_t, ipf_stack_t *));
 static void fr_ipsmove __P((ipstate_t *, u_int, ipf_stack_t *));
+static void fr_flowcache_purge __P((ipstate_t *, ipf_stack_t *));
 static int fr_tcpstate __P((fr_info_t *, tcphdr_t *, ipstate_t *));
 static int fr_tcpoptions __P((fr_info_t *, tcphdr_t *, tcpdata_t *));
 static ipstate_t *fr_stclone __P((fr_info_t *, tcphdr_t *, ipstate_t *));
@@ -170,6 +172,22 @@ ipf_stack_t *ifs;
 		 ifs->ifs_fr_statesize * sizeof(*ifs->ifs_ips_seed));
 	if (ifs->ifs_ips_seed == NULL)
 		return -2;
+
+	/*
+	 * The per-cpu flow cache is an optimisation and the state code
+	 * works without it, so an allocation failure here just leaves
+	 * it disabled.
+	 */
+#if defined(_KERNEL) && defined(sun)
+	ifs->ifs_ips_flowcpus = max_ncpus;
+#else
+	ifs->ifs_ips_flowcpus = 1;
+#endif
+	KMALLOCS(ifs->ifs_ips_flowcache, ipsflowcache_t *,
+		 ifs->ifs_ips_flowcpus * sizeof(ipsflowcache_t));
+	if (ifs->ifs_ips_flowcache != NULL)
+		bzero((char *)ifs->ifs_ips_flowcache,
+		      ifs->ifs_ips_flowcpus * sizeof(ipsflowcache_t));
 #if defined(NEED_LOCAL_RAND) || !defined(_KERNEL)
 	tv.tv_sec = 0;
 	GETKTIME(&tv);
@@ -321,11 +339,17 @@ ipf_stack_t *ifs;
 	}
 
 	if (ifs->ifs_ips_seed != NULL) {
-		KFREES(ifs->ifs_ips_seed, 
+		KFREES(ifs->ifs_ips_seed,
 		       ifs->ifs_fr_statesize * sizeof(*ifs->ifs_ips_seed));
 		ifs->ifs_ips_seed = NULL;
 	}
 
+	if (ifs->ifs_ips_flowcache != NULL) {
+		KFREES(ifs->ifs_ips_flowcache,
+		       ifs->ifs_ips_flowcpus * sizeof(ipsflowcache_t));
+		ifs->ifs_ips_flowcache = NULL;
+	}
+
 	if (ifs->ifs_ips_stats.iss_bucketlen != NULL) {
 		KFREES(ifs->ifs_ips_stats.iss_bucketlen, 
 		       ifs->ifs_fr_statesize * sizeof(u_long));
@@ -2671,6 +2695,7 @@ ipftq_t **ifqp;
 {
 	u_int hv, hvm, pr, v, tryagain;
 	ipstate_t *is, **isp;
+	ipsflowent_t *fce;
 	u_short dport, sport;
 	i6addr_t src, dst;
 	struct icmp *ic;
@@ -2823,6 +2848,40 @@ icmp6again:
 		oow = 0;
 		tryagain = 0;
 		READ_ENTER(&ifs->ifs_ipf_state);
+
+		/*
+		 * Probe the per-cpu flow cache first: a hit resolves the
+		 * packet without walking the hash bucket.  A cached pointer
+		 * may only be dereferenced with ipf_state held (fr_delstate
+		 * purges the cache before freeing an entry) and is verified
+		 * with the full match functions, so a stale or colliding
+		 * slot simply falls through to the hash table below.
+		 */
+		if (ifs->ifs_ips_flowcache != NULL) {
+#if defined(_KERNEL) && defined(sun)
+			fce = &ifs->ifs_ips_flowcache[CPU->cpu_seqid].
+			    ifc_ent[hv & (IPF_FLOWCACHE_WIDTH - 1)];
+#else
+			fce = &ifs->ifs_ips_flowcache[0].
+			    ifc_ent[hv & (IPF_FLOWCACHE_WIDTH - 1)];
+#endif
+			is = fce->ifce_state;
+			if ((is != NULL) && (fce->ifce_hv == hv) &&
+			    (is->is_p == pr) && (is->is_v == v)) {
+				fin->fin_flx &= ~FI_OOW;
+				is = fr_matchsrcdst(fin, is, &src, &dst,
+						    tcp, FI_CMP);
+				if ((is != NULL) && (pr == IPPROTO_TCP) &&
+				    !fr_tcpstate(fin, tcp, is)) {
+					oow |= fin->fin_flx & FI_OOW;
+					is = NULL;
+				}
+				if (is != NULL)
+					break;
+			}
+			is = NULL;
+		} else
+			fce = NULL;
 retry_tcpudp:
 		hvm = DOUBLE_HASH(hv, ifs);
 		for (isp = &ifs->ifs_ips_table[hvm]; ((is = *isp) != NULL); ) {
@@ -2849,6 +2908,17 @@ retry_tcpudp:
 				fr_ipsmove(is, hv, ifs);
 				MUTEX_DOWNGRADE(&ifs->ifs_ipf_state);
 			}
+			/*
+			 * Remember fully-specified matches so the next
+			 * packet of this flow hits the cache.  Wildcard
+			 * and clone entries stay out as their match is
+			 * not a pure hash comparison.
+			 */
+			if ((fce != NULL) && (tryagain == 0) &&
+			    !(is->is_flags & (SI_CLONE|SI_WILDP|SI_WILDA))) {
+				fce->ifce_hv = hv;
+				fce->ifce_state = is;
+			}
 			break;
 		}
 		RWLOCK_EXIT(&ifs->ifs_ipf_state);
@@ -3285,6 +3355,37 @@ ipf_stack_t *ifs;
 }
 #endif
 
+/* ------------------------------------------------------------------------ */
+/* Function:    fr_flowcache_purge                                          */
+/* Returns:     Nil                                                         */
+/* Parameters:  is(I)  - pointer to state structure being deleted           */
+/*              ifs    - ipf stack instance                                 */
+/* Write Locks: ipf_state/ipf_global                                        */
+/*                                                                          */
+/* Drop any per-cpu flow cache references to a state entry that is about    */
+/* to be deleted.  The write lock held by our caller excludes all lookups,  */
+/* so the scan over every cpu's slots is race-free.                         */
+/* ------------------------------------------------------------------------ */
+static void fr_flowcache_purge(is, ifs)
+ipstate_t *is;
+ipf_stack_t *ifs;
+{
+	ipsflowent_t *fce;
+	int c, i;
+
+	if (ifs->ifs_ips_flowcache == NULL)
+		return;
+
+	for (c = 0; c < ifs->ifs_ips_flowcpus; c++) {
+		fce = ifs->ifs_ips_flowcache[c].ifc_ent;
+		for (i = 0; i < IPF_FLOWCACHE_WIDTH; i++) {
+			if (fce[i].ifce_state == is)
+				fce[i].ifce_state = NULL;
+		}
+	}
+}
+
+
 /* ------------------------------------------------------------------------ */
 /* Function:    fr_delstate                                                 */
 /* Returns:     int - 0 = entry deleted, else ref count on entry            */
@@ -3307,6 +3408,8 @@ ipf_stack_t *ifs;
 	ASSERT(rw_write_held(&ifs->ifs_ipf_global.ipf_lk) == 0 ||
 		rw_write_held(&ifs->ifs_ipf_state.ipf_lk) == 0);
 
+	fr_flowcache_purge(is, ifs);
+
 	/*
 	 * Start by removing the entry from the hash table of state entries
 	 * so it will not be "used" again.
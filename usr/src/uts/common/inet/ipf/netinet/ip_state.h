@@ -160,6 +160,25 @@ typedef	struct	ipstate_save	{
 #define	ips_rule	ips_is.is_rule
 
 
+/*
+ * Per-cpu cache of recently matched state entries, indexed by the state
+ * hash before it is folded through ips_seed.  Entries are only ever
+ * dereferenced with ipf_state held (read) and are purged by fr_delstate
+ * with ipf_state held exclusively, so a non-NULL ifce_state is always a
+ * live state entry.
+ */
+typedef	struct	ipsflowent	{
+	void	*ifce_state;	/* cached ipstate_t */
+	u_int	ifce_hv;	/* unfolded hash of the cached entry */
+} ipsflowent_t;
+
+#define	IPF_FLOWCACHE_WIDTH	64	/* slots per cpu, power of two */
+
+typedef	struct	ipsflowcache	{
+	ipsflowent_t	ifc_ent[IPF_FLOWCACHE_WIDTH];
+} ipsflowcache_t;
+
+
 typedef	struct	ipslog	{
 	U_QUAD_T	isl_pkts[4];
 	U_QUAD_T	isl_bytes[4];
@@ -262,6 +262,8 @@ struct ipf_stack {
 	/* ip_state.c */
 	ipstate_t		**ifs_ips_table;
 	ulong_t			*ifs_ips_seed;
+	ipsflowcache_t		*ifs_ips_flowcache;
+	int			ifs_ips_flowcpus;
 	int			ifs_ips_num;
 	ulong_t			ifs_ips_last_force_flush;
 	uint_t			ifs_state_flush_level_hi;
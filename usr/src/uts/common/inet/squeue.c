@@ -118,6 +118,7 @@
 #include <sys/debug.h>
 #include <sys/kmem.h>
 #include <sys/cpuvar.h>
+#include <sys/cpu.h>
 #include <sys/condvar_impl.h>
 #include <sys/systm.h>
 #include <sys/callb.h>
@@ -144,8 +145,21 @@ kmem_cache_t *squeue_cache;
 
 int squeue_drain_ms = 20;
 
+/*
+ * The time (in microseconds) an idle squeue worker spins on its queue
+ * before going to sleep. With the default of 0 the worker sleeps as
+ * soon as its queue is empty and is woken via cv_signal, which adds a
+ * scheduler round trip to the receive latency of the next packet.
+ * Latency-sensitive deployments can set this to a small busy-poll
+ * window (e.g. 50-100us) to have the bound worker pick up a packet
+ * arriving shortly after a drain without a wakeup, trading CPU for
+ * tail latency.
+ */
+int squeue_busypoll_us = 0;
+
 /* The values above converted to ticks or nano seconds */
 static uint_t squeue_drain_ns = 0;
+static uint_t squeue_busypoll_ns = 0;
 
 uintptr_t squeue_drain_stack_needed = 10240;
 uint_t squeue_drain_stack_toodeep;
@@ -238,6 +252,7 @@ squeue_init(void)
 	    sizeof (squeue_t), 64, NULL, NULL, NULL, NULL, NULL, 0);
 
 	squeue_drain_ns = squeue_drain_ms * SQUEUE_MSEC_TO_NSEC;
+	squeue_busypoll_ns = squeue_busypoll_us * (SQUEUE_MSEC_TO_NSEC / 1000);
 }
 
 squeue_t *
@@ -1217,6 +1232,40 @@ squeue_worker(squeue_t *sqp)
 			    (sqp->sq_state & SQS_WORKER))
 				break;
 
+			/*
+			 * Optionally busy-poll the queue before going
+			 * to sleep, so that a packet arriving right
+			 * after a drain is picked up without paying
+			 * for a cv_signal and a dispatch of this
+			 * thread. The spin is done without sq_lock so
+			 * that enqueueing threads are not slowed down;
+			 * once something is spotted we loop back and
+			 * re-evaluate the wait conditions under the
+			 * lock as usual.
+			 */
+			if (squeue_busypoll_ns != 0) {
+				hrtime_t stop = gethrtime() +
+				    squeue_busypoll_ns;
+				boolean_t found = B_FALSE;
+
+				CALLB_CPR_SAFE_BEGIN(&cprinfo);
+				mutex_exit(lock);
+				do {
+					if (sqp->sq_first != NULL ||
+					    (sqp->sq_state &
+					    (SQS_PROC_HELD |
+					    SQS_WORKER_THR_CONTROL)) != 0) {
+						found = B_TRUE;
+						break;
+					}
+					SMT_PAUSE();
+				} while (gethrtime() < stop);
+				mutex_enter(lock);
+				CALLB_CPR_SAFE_END(&cprinfo, lock);
+				if (found)
+					continue;
+			}
+
 			CALLB_CPR_SAFE_BEGIN(&cprinfo);
 			cv_wait(async, lock);
 			CALLB_CPR_SAFE_END(&cprinfo, lock);
@@ -271,7 +271,8 @@ typedef struct tcp_s {
 #define	tcp_sack_list		tcp_sack_info.tcp_sack_list
 #define	tcp_num_notsack_blk	tcp_sack_info.tcp_num_notsack_blk
 #define	tcp_cnt_notsack_list	tcp_sack_info.tcp_cnt_notsack_list
-#define	tcp_notsack_list	tcp_sack_info.tcp_notsack_list
+#define	tcp_notsack		tcp_sack_info.tcp_notsack
+#define	tcp_notsack_list	tcp_notsack.nsl_head
 
 	mblk_t	*tcp_rcv_list;		/* Queued until push, urgent data, */
 	mblk_t	*tcp_rcv_last_head;	/* optdata, or the count exceeds */
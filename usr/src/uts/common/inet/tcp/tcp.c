@@ -236,6 +236,15 @@ int tcp_squeue_flag;
  */
 uint_t tcp_free_list_max_cnt = 0;
 
+/*
+ * Number of clean connections the time-wait collector leaves on each
+ * squeue's tcp_free_list instead of draining the list completely.  The
+ * retained entries let tcp_input_listener() allocate eagers for a burst
+ * of incoming SYNs without going to kmem under the listener's squeue.
+ * Set to 0 to restore the old drain-everything behaviour.
+ */
+uint_t tcp_free_list_min_cnt = 64;
+
 #define	TIDUSZ	4096	/* transport interface data unit size */
 
 /*
@@ -1389,7 +1398,7 @@ tcp_free(tcp_t *tcp)
 		tcp->tcp_ordrel_mp = NULL;
 	}
 
-	TCP_NOTSACK_REMOVE_ALL(tcp->tcp_notsack_list, tcp);
+	TCP_NOTSACK_REMOVE_ALL(tcp);
 	bzero(&tcp->tcp_sack_info, sizeof (tcp_sack_info_t));
 
 	if (tcp->tcp_hopopts != NULL) {
@@ -1526,9 +1535,11 @@ tcp_get_conn(void *arg, tcp_stack_t *tcps)
 		connp->conn_recv = tcp_input_data;
 		ASSERT(connp->conn_recvicmp == tcp_icmp_input);
 		ASSERT(connp->conn_verifyicmp == tcp_verifyicmp);
+		TCP_G_STAT_INC(tcp_freelist_hit);
 		return (connp);
 	}
 	mutex_exit(&tcp_time_wait->tcp_time_wait_lock);
+	TCP_G_STAT_INC(tcp_freelist_miss);
 	/*
 	 * Pre-allocate the tcp_rsrv_mp. This mblk will not be freed until
 	 * this conn_t/tcp_t is freed at ipcl_conn_destroy().
@@ -2165,7 +2176,7 @@ tcp_reinit_values(tcp_t *tcp)
 	tcp->tcp_ecn_echo_on = B_FALSE;
 	tcp->tcp_is_wnd_shrnk = B_FALSE;
 
-	TCP_NOTSACK_REMOVE_ALL(tcp->tcp_notsack_list, tcp);
+	TCP_NOTSACK_REMOVE_ALL(tcp);
 	bzero(&tcp->tcp_sack_info, sizeof (tcp_sack_info_t));
 
 	tcp->tcp_rcv_ws = 0;
@@ -3733,6 +3744,7 @@ tcp_ddi_g_init(void)
 	ip_squeue_init(tcp_squeue_add);
 
 	tcp_g_kstat = tcp_g_kstat_init(&tcp_g_statistics);
+	tcp_time_wait_stat_init();
 
 	tcp_squeue_flag = tcp_squeue_switch(tcp_squeue_wput);
 
@@ -3869,6 +3881,7 @@ tcp_stack_init(netstackid_t stackid, netstack_t *ns)
 void
 tcp_ddi_g_destroy(void)
 {
+	tcp_time_wait_stat_fini();
 	tcp_g_kstat_fini(tcp_g_kstat);
 	tcp_g_kstat = NULL;
 	bzero(&tcp_g_statistics, sizeof (tcp_g_statistics));
@@ -444,7 +444,7 @@ tcp_parse_options(tcpha_t *tcpha, tcp_opt_t *tcpopt)
 			 * nothing is sack'ed.
 			 */
 			if (tcp->tcp_notsack_list == NULL) {
-				tcp_notsack_update(&(tcp->tcp_notsack_list),
+				tcp_notsack_update(&tcp->tcp_notsack,
 				    tcp->tcp_suna, tcp->tcp_snxt,
 				    &(tcp->tcp_num_notsack_blk),
 				    &(tcp->tcp_cnt_notsack_list));
@@ -483,7 +483,7 @@ tcp_parse_options(tcpha_t *tcpha, tcp_opt_t *tcpopt)
 				    SEQ_GT(sack_end, tcp->tcp_snxt)) {
 					continue;
 				}
-				tcp_notsack_insert(&(tcp->tcp_notsack_list),
+				tcp_notsack_insert(&tcp->tcp_notsack,
 				    sack_begin, sack_end,
 				    &(tcp->tcp_num_notsack_blk),
 				    &(tcp->tcp_cnt_notsack_list));
@@ -4298,7 +4298,7 @@ process_ack:
 	 * blocks that are covered by this ACK.
 	 */
 	if (tcp->tcp_snd_sack_ok && tcp->tcp_notsack_list != NULL) {
-		tcp_notsack_remove(&(tcp->tcp_notsack_list), seg_ack,
+		tcp_notsack_remove(&tcp->tcp_notsack, seg_ack,
 		    &(tcp->tcp_num_notsack_blk), &(tcp->tcp_cnt_notsack_list));
 	}
 
@@ -4322,8 +4322,7 @@ process_ack:
 			 * the next fast retrasnmit/recovery phase.
 			 */
 			if (tcp->tcp_snd_sack_ok) {
-				TCP_NOTSACK_REMOVE_ALL(tcp->tcp_notsack_list,
-				    tcp);
+				TCP_NOTSACK_REMOVE_ALL(tcp);
 			}
 		} else {
 			if (tcp->tcp_snd_sack_ok &&
@@ -544,7 +544,7 @@ done:;
 		if (tcp->tcp_snd_sack_ok && tcp->tcp_notsack_list != NULL) {
 			/* len is a negative value. */
 			tcp->tcp_pipe -= len;
-			tcp_notsack_update(&(tcp->tcp_notsack_list),
+			tcp_notsack_update(&tcp->tcp_notsack,
 			    tcp->tcp_snxt, snxt,
 			    &(tcp->tcp_num_notsack_blk),
 			    &(tcp->tcp_cnt_notsack_list));
@@ -3310,7 +3310,7 @@ tcp_send_rst_chk(tcp_stack_t *tcps)
  * This function handles all retransmissions if SACK is enabled for this
  * connection.  First it calculates how many segments can be retransmitted
  * based on tcp_pipe.  Then it goes thru the notsack list to find eligible
- * segments.  A segment is eligible if sack_cnt for that segment is greater
+ * segments.  A segment is eligible if its dup SACK count is greater
  * than or equal tcp_dupack_fast_retransmit.  After it has retransmitted
  * all eligible segments, it checks to see if TCP can send some new segments
  * (fast recovery).  If it can, set the appropriate flag for tcp_input_data().
@@ -3363,7 +3363,8 @@ tcp_sack_rexmit(tcp_t *tcp, uint_t *flags)
 
 		for (; notsack_blk != NULL; notsack_blk = notsack_blk->next) {
 			if (SEQ_GT(notsack_blk->end, begin) &&
-			    (notsack_blk->sack_cnt >=
+			    (TCP_NOTSACK_SACK_CNT(&tcp->tcp_notsack,
+			    notsack_blk) >=
 			    tcps->tcps_dupack_fast_retransmit)) {
 				end = notsack_blk->end;
 				if (SEQ_LT(begin, notsack_blk->begin)) {
@@ -3640,7 +3641,7 @@ tcp_process_shrunk_swnd(tcp_t *tcp, uint32_t shrunk_count)
 	 * If the SACK option is set, delete the entire list of
 	 * notsack'ed blocks.
 	 */
-	TCP_NOTSACK_REMOVE_ALL(tcp->tcp_notsack_list, tcp);
+	TCP_NOTSACK_REMOVE_ALL(tcp);
 
 	if (tcp->tcp_suna == tcp->tcp_snxt && tcp->tcp_swnd == 0)
 		/*
@@ -25,6 +25,9 @@
 #include <sys/types.h>
 #include <sys/kmem.h>
 #include <sys/debug.h>
+#include <sys/sysmacros.h>
+#include <sys/atomic.h>
+#include <sys/avl.h>
 #include <netinet/tcp.h>
 #include <sys/systm.h>
 #include <sys/stropts.h>
@@ -33,10 +36,70 @@
 #include <inet/common.h>
 #include <inet/ip.h>
 #include <inet/tcp.h>
+#include <inet/tcp_stats.h>
 
 /* kmem cache for notsack_blk_t */
 kmem_cache_t	*tcp_notsack_blk_cache;
 
+/*
+ * AVL comparator for notsack'ed blks, ordered by starting sequence number.
+ * Sequence number comparisons are circular, so this is a valid ordering
+ * only while all the blks on a list fall within a single send window
+ * (less than 2^31 sequence numbers apart), which is always the case for
+ * the scoreboard of one connection.
+ */
+static int
+tcp_notsack_compare(const void *a, const void *b)
+{
+	const notsack_blk_t *na = a;
+	const notsack_blk_t *nb = b;
+
+	if (SEQ_LT(na->begin, nb->begin))
+		return (-1);
+	if (SEQ_GT(na->begin, nb->begin))
+		return (1);
+	return (0);
+}
+
+/*
+ * Allocate a notsack'ed blk, keeping count of the outstanding blks in
+ * the global kstat.
+ */
+static notsack_blk_t *
+tcp_notsack_alloc(void)
+{
+	notsack_blk_t *blk;
+
+	blk = kmem_cache_alloc(tcp_notsack_blk_cache, KM_NOSLEEP);
+	if (blk == NULL) {
+		TCP_G_STAT_INC(tcp_notsack_allocfail);
+		return (NULL);
+	}
+	TCP_G_STAT_INC(tcp_notsack_blks);
+	return (blk);
+}
+
+/*
+ * Unlink a notsack'ed blk, whose list predecessor is prev (NULL if blk is
+ * the head), from both the list and the tree and free it.
+ */
+static void
+tcp_notsack_free(notsack_list_t *nsl, notsack_blk_t *blk, notsack_blk_t *prev)
+{
+	if (prev == NULL) {
+		ASSERT(nsl->nsl_head == blk);
+		nsl->nsl_head = blk->next;
+	} else {
+		ASSERT(prev->next == blk);
+		prev->next = blk->next;
+	}
+	if (nsl->nsl_tail == blk)
+		nsl->nsl_tail = prev;
+	avl_remove(&nsl->nsl_tree, blk);
+	kmem_cache_free(tcp_notsack_blk_cache, blk);
+	TCP_G_STAT_DEC(tcp_notsack_blks);
+}
+
 /*
  * To insert a new blk to the array of SACK blk in receiver.
  *
@@ -179,9 +242,12 @@ tcp_sack_remove(sack_blk_t *head, tcp_seq end, int32_t *num)
  * by the receiver.  The SACK info is a blk which is being selectively
  * acknowledged by the receiver.
  *
+ * Note that trimming a blk (moving its begin or end) never changes its
+ * position relative to its neighbors, so the tree stays ordered even
+ * though begin is the tree key.
+ *
  * Parameters:
- *	notsack_blk_t **head: address of the pointer to the list of notsack'ed
- *		blks.
+ *	notsack_list_t *nsl: the list of notsack'ed blks.
  *	tcp_seq begin: starting seq num of the SACK info.
  *	tcp_seq end: ending seq num of the SACK info.
  *	int32_t *num: (referenced) total num of notsack'ed blk on the list.
@@ -189,57 +255,72 @@ tcp_sack_remove(sack_blk_t *head, tcp_seq end, int32_t *num)
  *		blks.
  */
 void
-tcp_notsack_insert(notsack_blk_t **head, tcp_seq begin, tcp_seq end,
+tcp_notsack_insert(notsack_list_t *nsl, tcp_seq begin, tcp_seq end,
     int32_t *num, uint32_t *sum)
 {
-	notsack_blk_t *prev, *tmp, *new;
-	uint32_t tmp_sum, tmp_num;
+	notsack_blk_t *prev, *tmp, *new, *next;
+	notsack_blk_t key;
+	avl_index_t where;
 
-	if (*head == NULL) {
+	if (nsl->nsl_head == NULL)
 		return;
-	}
 
-	tmp = *head;
-	prev = NULL;
-	/* Find the right place of updating the list. */
-	while ((tmp != NULL) && SEQ_LEQ(tmp->end, begin)) {
-		prev = tmp;
-		(tmp->sack_cnt)++;
-		tmp = tmp->next;
+	/*
+	 * Every blk lying wholly below the SACK'ed range has now been
+	 * passed over by one more SACK.  Rather than walking all of them
+	 * to bump their dup SACK counts, bump the list generation, which
+	 * charges a pass against every blk, and take the pass back from
+	 * the blks at or above the range as they are found below (the
+	 * "uncount" loop).  SACK blks normally describe data at the top
+	 * of the window, so there is usually nothing above to revisit.
+	 */
+	nsl->nsl_gen++;
+
+	/*
+	 * Find the first blk the SACK'ed range can touch, i.e. the first
+	 * blk with end > begin.  The tree is keyed by begin, so look up
+	 * the blk at or just below begin and step forward if it lies
+	 * wholly below the range.
+	 */
+	key.begin = begin;
+	if ((tmp = avl_find(&nsl->nsl_tree, &key, &where)) == NULL) {
+		tmp = avl_nearest(&nsl->nsl_tree, where, AVL_BEFORE);
+		if (tmp == NULL)
+			tmp = nsl->nsl_head;
+		else if (SEQ_LEQ(tmp->end, begin))
+			tmp = tmp->next;
 	}
 
 	/*
 	 * This can happen only when TCP sends new data but the notsack list
-	 * is not updated.
+	 * is not updated.  Every blk was passed over.
 	 */
-	if (tmp == NULL) {
+	if (tmp == NULL)
 		return;
-	}
+
+	prev = AVL_PREV(&nsl->nsl_tree, tmp);
 
 	/*
 	 * This means the new SACK info covers something that is not on
-	 * the list anymore.
+	 * the list anymore.  This blk and those above it were not passed
+	 * over.
 	 */
-	if (SEQ_LEQ(end, tmp->begin)) {
-		return;
-	}
+	if (SEQ_LEQ(end, tmp->begin))
+		goto uncount;
 
 	/* The SACK info covers up to this blk.  So just check for this blk. */
 	if (SEQ_LEQ(end, tmp->end)) {
 		/*
 		 * Only this notsack'ed blk is completely covered.  Delete
-		 * it and return.
+		 * it and uncount the blks above it.
 		 */
 		if (end == tmp->end && SEQ_LEQ(begin, tmp->begin)) {
-			if (prev != NULL) {
-				prev->next = tmp->next;
-			} else {
-				*head = tmp->next;
-			}
 			(*num)--;
 			*sum -= tmp->end - tmp->begin;
-			kmem_cache_free(tcp_notsack_blk_cache, tmp);
-			return;
+			next = tmp->next;
+			tcp_notsack_free(nsl, tmp, prev);
+			tmp = next;
+			goto uncount;
 		}
 		/* This blk is partially covered. */
 		if (SEQ_GEQ(begin, tmp->begin)) {
@@ -247,41 +328,54 @@ tcp_notsack_insert(notsack_blk_t **head, tcp_seq begin, tcp_seq end,
 			if (begin == tmp->begin) {
 				*sum -= end - tmp->begin;
 				tmp->begin = end;
+				/* This blk was not passed over. */
+				goto uncount;
 			} else if (end == tmp->end) {
 				*sum -= tmp->end - begin;
 				tmp->end = begin;
-				(tmp->sack_cnt)++;
+				/*
+				 * This blk was passed over, but the blks
+				 * above it were not.
+				 */
+				tmp = tmp->next;
+				goto uncount;
 			} else {
 				/* Split the notsack blk. */
-				if ((new = kmem_cache_alloc(
-				    tcp_notsack_blk_cache, KM_NOSLEEP)) ==
-				    NULL) {
-					return;
-				}
+				if ((new = tcp_notsack_alloc()) == NULL)
+					goto uncount;
 				new->end = tmp->end;
 				new->begin = end;
 				new->next = tmp->next;
-				new->sack_cnt = 0;
+				new->sack_gen = nsl->nsl_gen;
 				tmp->end = begin;
 				tmp->next = new;
-				(tmp->sack_cnt)++;
+				if (nsl->nsl_tail == tmp)
+					nsl->nsl_tail = new;
+				avl_insert_here(&nsl->nsl_tree, new, tmp,
+				    AVL_AFTER);
 				(*num)++;
 				*sum -= end - begin;
+				/*
+				 * The lower half was passed over; the new
+				 * upper half starts fresh and the blks
+				 * above it were not passed over.
+				 */
+				tmp = new->next;
+				goto uncount;
 			}
 		} else {
 			*sum -= end - tmp->begin;
 			tmp->begin = end;
+			/* This blk was not passed over. */
+			goto uncount;
 		}
-		return;
 	}
 
 	/* Need to check for coverage of this blk and later blks. */
-	tmp_sum = *sum;
-	tmp_num = *num;
 	if (SEQ_LT(tmp->begin, begin)) {
-		tmp_sum -= tmp->end - begin;
+		/* This blk was passed over (the generation bump stands). */
+		*sum -= tmp->end - begin;
 		tmp->end = begin;
-		(tmp->sack_cnt)++;
 		prev = tmp;
 		tmp = tmp->next;
 	}
@@ -293,32 +387,27 @@ tcp_notsack_insert(notsack_blk_t **head, tcp_seq begin, tcp_seq end,
 		} else {
 			/* Is the blk completely or partially covered? */
 			if (SEQ_LEQ(tmp->end, end)) {
-				tmp_num--;
-				tmp_sum -= tmp->end - tmp->begin;
-				if (prev != NULL) {
-					prev->next = tmp->next;
-					kmem_cache_free(tcp_notsack_blk_cache,
-					    tmp);
-					tmp = prev->next;
-				} else {
-					*head = tmp->next;
-					kmem_cache_free(tcp_notsack_blk_cache,
-					    tmp);
-					tmp = *head;
-				}
+				(*num)--;
+				*sum -= tmp->end - tmp->begin;
+				next = tmp->next;
+				tcp_notsack_free(nsl, tmp, prev);
+				tmp = next;
 			} else {
 				/*
 				 * This blk is partially covered.  It also
 				 * means it should be the end of coverage.
 				 */
-				tmp_sum -= end - tmp->begin;
+				*sum -= end - tmp->begin;
 				tmp->begin = end;
 				break;
 			}
 		}
 	}
-	*num = tmp_num;
-	*sum = tmp_sum;
+
+uncount:
+	/* The blks from tmp onwards were not passed over by this SACK. */
+	for (; tmp != NULL; tmp = tmp->next)
+		tmp->sack_gen++;
 }
 
 
@@ -326,25 +415,19 @@ tcp_notsack_insert(notsack_blk_t **head, tcp_seq begin, tcp_seq end,
  * To remove notsack'ed blks.
  *
  * Parameters:
- *	notsack_blk_t **head: address of the pointer to the list of notsack'ed
- *		blks.
+ *	notsack_list_t *nsl: the list of notsack'ed blks.
  *	tcp_seq end: to remove all notsack'ed blk with seq num less than end.
  *	int32_t *num: (referenced) total num of notsack'ed blks.
  *	uint32_t *sum: (referenced) total num of bytes of all the notsack'ed
  *		blks.
  */
 void
-tcp_notsack_remove(notsack_blk_t **head, tcp_seq end, int32_t *num,
+tcp_notsack_remove(notsack_list_t *nsl, tcp_seq end, int32_t *num,
     uint32_t *sum)
 {
-	notsack_blk_t *prev, *tmp;
-	uint32_t tmp_sum = *sum;
-
-	if (*head == NULL)
-		return;
+	notsack_blk_t *tmp, *next;
 
-	prev = NULL;
-	tmp = *head;
+	tmp = nsl->nsl_head;
 	while (tmp != NULL) {
 		/* There is nothing to discard. */
 		if (SEQ_GT(tmp->begin, end)) {
@@ -354,23 +437,16 @@ tcp_notsack_remove(notsack_blk_t **head, tcp_seq end, int32_t *num,
 		/* Is the blk completely or partially covered? */
 		if (SEQ_GEQ(end, tmp->end)) {
 			(*num)--;
-			tmp_sum -= tmp->end - tmp->begin;
-			if (prev == NULL) {
-				*head = tmp->next;
-				kmem_cache_free(tcp_notsack_blk_cache, tmp);
-				tmp = *head;
-			} else {
-				prev->next = tmp->next;
-				kmem_cache_free(tcp_notsack_blk_cache, tmp);
-				tmp = prev->next;
-			}
+			*sum -= tmp->end - tmp->begin;
+			next = tmp->next;
+			tcp_notsack_free(nsl, tmp, NULL);
+			tmp = next;
 		} else {
-			tmp_sum -= end - tmp->begin;
+			*sum -= end - tmp->begin;
 			tmp->begin = end;
 			break;
 		}
 	}
-	*sum = tmp_sum;
 }
 
 
@@ -380,44 +456,45 @@ tcp_notsack_remove(notsack_blk_t **head, tcp_seq end, int32_t *num,
  * Assumption: this should only be called when new notsack blk is to be added.
  *
  * Parameters:
- *	notsack_blk_t **head: address of the pointer to the list of notsack'ed
- *		blks.
+ *	notsack_list_t *nsl: the list of notsack'ed blks.
  *	tcp_seq begin: beginning seq num of new data.
  *	tcp_seq end: ending seq num of new data.
  *	int32_t *num: (referenced) total num of notsack'ed blks.
  *	uint32_t *sum: (referenced) total num of bytes of all the notsack'ed
  *		blks.
  */
-void tcp_notsack_update(notsack_blk_t **head, tcp_seq begin, tcp_seq end,
+void
+tcp_notsack_update(notsack_list_t *nsl, tcp_seq begin, tcp_seq end,
     int32_t *num, uint32_t *sum)
 {
-	notsack_blk_t *tmp;
+	notsack_blk_t *tmp, *new;
 
-	tmp = *head;
 	/* If the list is empty, create a new one. */
-	if (tmp == NULL) {
-		if ((tmp = kmem_cache_alloc(tcp_notsack_blk_cache,
-		    KM_NOSLEEP)) == NULL) {
+	if (nsl->nsl_head == NULL) {
+		if ((tmp = tcp_notsack_alloc()) == NULL)
 			return;
-		}
 		tmp->begin = begin;
 		tmp->end = end;
 		tmp->next = NULL;
-		tmp->sack_cnt = 0;
-		*head = tmp;
+		tmp->sack_gen = nsl->nsl_gen;
+		avl_create(&nsl->nsl_tree, tcp_notsack_compare,
+		    sizeof (notsack_blk_t),
+		    offsetof(notsack_blk_t, tree_node));
+		avl_add(&nsl->nsl_tree, tmp);
+		nsl->nsl_head = tmp;
+		nsl->nsl_tail = tmp;
 		*num = 1;
 		*sum = end - begin;
 		return;
 	}
 
 	/*
-	 * Find the place to add the new blk.  This assumes that new data
-	 * is being sent, so the place to insert the new notsack blk is at
-	 * the end of the list.
+	 * New data is always sent above everything already on the list,
+	 * so the place to insert the new notsack blk is at the end of
+	 * the list.
 	 */
-	while (tmp->next != NULL) {
-		tmp = tmp->next;
-	}
+	tmp = nsl->nsl_tail;
+	ASSERT(tmp->next == NULL);
 
 	/* Does the new blk overlap with old one? */
 	if (SEQ_GEQ(tmp->end, begin)) {
@@ -425,15 +502,56 @@ void tcp_notsack_update(notsack_blk_t **head, tcp_seq begin, tcp_seq end,
 		tmp->end = end;
 	} else {
 		/* No.  Need to create a new notsack blk. */
-		tmp->next = kmem_cache_alloc(tcp_notsack_blk_cache, KM_NOSLEEP);
-		if (tmp->next != NULL) {
+		if ((new = tcp_notsack_alloc()) == NULL)
+			return;
+		new->begin = begin;
+		new->end = end;
+		new->next = NULL;
+		new->sack_gen = nsl->nsl_gen;
+		tmp->next = new;
+		avl_insert_here(&nsl->nsl_tree, new, tmp, AVL_AFTER);
+		nsl->nsl_tail = new;
+		(*num)++;
+		*sum += end - begin;
+	}
+}
+
+
+/*
+ * To remove all the notsack'ed blks on a list.
+ *
+ * Parameters:
+ *	notsack_list_t *nsl: the list of notsack'ed blks.
+ *	int32_t *num: (referenced) total num of notsack'ed blks.
+ *	uint32_t *sum: (referenced) total num of bytes of all the notsack'ed
+ *		blks.
+ */
+void
+tcp_notsack_remove_all(notsack_list_t *nsl, int32_t *num, uint32_t *sum)
+{
+	notsack_blk_t *prev, *tmp;
+
+	if (nsl->nsl_head != NULL) {
+		tmp = nsl->nsl_head;
+		do {
+			prev = tmp;
 			tmp = tmp->next;
-			tmp->begin = begin;
-			tmp->end = end;
-			tmp->next = NULL;
-			tmp->sack_cnt = 0;
-			(*num)++;
-			*sum += end - begin;
-		}
+			kmem_cache_free(tcp_notsack_blk_cache, prev);
+		} while (tmp != NULL);
+		TCP_G_STAT_SUB(tcp_notsack_blks, *num);
+		nsl->nsl_head = NULL;
+		nsl->nsl_tail = NULL;
+		/*
+		 * The tree held the same blks; rather than removing them
+		 * one at a time, reinitialize it.
+		 */
+		avl_create(&nsl->nsl_tree, tcp_notsack_compare,
+		    sizeof (notsack_blk_t),
+		    offsetof(notsack_blk_t, tree_node));
+		*num = 0;
+		*sum = 0;
+	} else {
+		ASSERT(*num == 0);
+		ASSERT(*sum == 0);
 	}
 }
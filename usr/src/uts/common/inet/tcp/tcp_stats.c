@@ -722,6 +722,10 @@ tcp_g_kstat_init(tcp_g_stat_t *tcp_g_statp)
 		{ "tcp_timermp_allocfail",	KSTAT_DATA_UINT64 },
 		{ "tcp_timermp_allocdblfail",	KSTAT_DATA_UINT64 },
 		{ "tcp_freelist_cleanup",	KSTAT_DATA_UINT64 },
+		{ "tcp_freelist_hit",		KSTAT_DATA_UINT64 },
+		{ "tcp_freelist_miss",		KSTAT_DATA_UINT64 },
+		{ "tcp_notsack_blks",		KSTAT_DATA_UINT64 },
+		{ "tcp_notsack_allocfail",	KSTAT_DATA_UINT64 },
 	};
 
 	ksp = kstat_create(TCP_MOD_NAME, 0, "tcpstat_g", "net",
@@ -35,6 +35,8 @@
 #include <sys/squeue_impl.h>
 #include <sys/squeue.h>
 #include <sys/callo.h>
+#include <sys/kstat.h>
+#include <sys/atomic.h>
 
 #include <inet/common.h>
 #include <inet/ip.h>
@@ -49,6 +51,55 @@ static void tcp_time_wait_purge(tcp_t *, tcp_squeue_priv_t *);
 
 #define	TW_BUCKET_NEXT(b)	(((b) + 1) % TCP_TIME_WAIT_BUCKETS)
 
+/*
+ * Global statistics for the TIME_WAIT reclaim machinery.  tw_occupancy
+ * is a gauge tracking the total number of connections currently parked
+ * in TIME_WAIT buckets across all squeues; the rest are cumulative
+ * counters.  All are maintained with atomics since the wheels
+ * themselves are per-squeue.
+ */
+typedef struct tcp_tw_stats {
+	kstat_named_t	tw_occupancy;
+	kstat_named_t	tw_appends;
+	kstat_named_t	tw_batches;
+	kstat_named_t	tw_reclaimed;
+	kstat_named_t	tw_loopback_purged;
+} tcp_tw_stats_t;
+
+static tcp_tw_stats_t tcp_tw_stats = {
+	{ "tw_occupancy",	KSTAT_DATA_UINT64 },
+	{ "tw_appends",		KSTAT_DATA_UINT64 },
+	{ "tw_batches",		KSTAT_DATA_UINT64 },
+	{ "tw_reclaimed",	KSTAT_DATA_UINT64 },
+	{ "tw_loopback_purged",	KSTAT_DATA_UINT64 },
+};
+
+#define	TW_STAT_BUMP(stat)	atomic_inc_64(&tcp_tw_stats.stat.value.ui64)
+#define	TW_STAT_DECR(stat)	atomic_dec_64(&tcp_tw_stats.stat.value.ui64)
+
+static kstat_t *tcp_tw_ksp;
+
+void
+tcp_time_wait_stat_init(void)
+{
+	tcp_tw_ksp = kstat_create(TCP_MOD_NAME, 0, "tcp_time_wait", "net",
+	    KSTAT_TYPE_NAMED,
+	    sizeof (tcp_tw_stats) / sizeof (kstat_named_t),
+	    KSTAT_FLAG_VIRTUAL);
+	if (tcp_tw_ksp != NULL) {
+		tcp_tw_ksp->ks_data = &tcp_tw_stats;
+		kstat_install(tcp_tw_ksp);
+	}
+}
+
+void
+tcp_time_wait_stat_fini(void)
+{
+	if (tcp_tw_ksp != NULL) {
+		kstat_delete(tcp_tw_ksp);
+		tcp_tw_ksp = NULL;
+	}
+}
 
 /*
  * Remove a connection from the list of detached TIME_WAIT connections.
@@ -100,6 +151,7 @@ tcp_time_wait_remove(tcp_t *tcp, tcp_squeue_priv_t *tsp)
 	tcp->tcp_time_wait_prev = NULL;
 	tcp->tcp_time_wait_expire = 0;
 	tsp->tcp_time_wait_cnt--;
+	TW_STAT_DECR(tw_occupancy);
 
 	if (locked)
 		mutex_exit(&tsp->tcp_time_wait_lock);
@@ -165,8 +217,9 @@ tcp_time_wait_append(tcp_t *tcp)
 	 * re-entry for the loopback close operation.
 	 */
 	if (tcp->tcp_loopback) {
-		tcp_time_wait_purge(tcp, tsp);
 		mutex_exit(&tsp->tcp_time_wait_lock);
+		tcp_time_wait_purge(tcp, tsp);
+		TW_STAT_BUMP(tw_loopback_purged);
 		return;
 	}
 
@@ -211,6 +264,8 @@ tcp_time_wait_append(tcp_t *tcp)
 		tcp->tcp_time_wait_next->tcp_time_wait_prev = tcp;
 	}
 	tsp->tcp_time_wait_cnt++;
+	TW_STAT_BUMP(tw_occupancy);
+	TW_STAT_BUMP(tw_appends);
 
 	/*
 	 * Round delay up to the nearest bucket boundary.
@@ -293,6 +348,12 @@ tcp_timewait_close(void *arg, mblk_t *mp, void *arg2, ip_recv_attr_t *dummy)
 }
 
 
+/*
+ * Reclaim a single TIME_WAIT connection.  Called without
+ * tcp_time_wait_lock held; the lock is only taken briefly to insert a
+ * recycled tcp_t into the free list, so a collector reclaiming a large
+ * batch never holds it across the per-connection work.
+ */
 static void
 tcp_time_wait_purge(tcp_t *tcp, tcp_squeue_priv_t *tsp)
 {
@@ -300,7 +361,7 @@ tcp_time_wait_purge(tcp_t *tcp, tcp_squeue_priv_t *tsp)
 	conn_t *connp = tcp->tcp_connp;
 	kmutex_t *lock;
 
-	ASSERT(MUTEX_HELD(&tsp->tcp_time_wait_lock));
+	ASSERT(MUTEX_NOT_HELD(&tsp->tcp_time_wait_lock));
 	ASSERT(connp->conn_fanout != NULL);
 
 	lock = &connp->conn_fanout->connf_lock;
@@ -331,28 +392,37 @@ tcp_time_wait_purge(tcp_t *tcp, tcp_squeue_priv_t *tsp)
 			connp->conn_state_flags |= CONN_CONDEMNED;
 			mutex_exit(&connp->conn_lock);
 			mutex_exit(lock);
+
+			/*
+			 * Clean the connection up for reuse before
+			 * deciding whether the free list has room, so
+			 * that tcp_time_wait_lock is only held for the
+			 * list insertion itself.
+			 */
+			tcp_cleanup(tcp);
+			ASSERT(connp->conn_latch == NULL);
+			ASSERT(connp->conn_policy == NULL);
+			ASSERT(tcp->tcp_tcps == NULL);
+			ASSERT(connp->conn_netstack == NULL);
+
+			mutex_enter(&tsp->tcp_time_wait_lock);
 			if (tsp->tcp_free_list_cnt < tcp_free_list_max_cnt) {
 				/*
 				 * Add to head of tcp_free_list
 				 */
-				tcp_cleanup(tcp);
-				ASSERT(connp->conn_latch == NULL);
-				ASSERT(connp->conn_policy == NULL);
-				ASSERT(tcp->tcp_tcps == NULL);
-				ASSERT(connp->conn_netstack == NULL);
-
 				tcp->tcp_time_wait_next = tsp->tcp_free_list;
 				tcp->tcp_in_free_list = B_TRUE;
 				tsp->tcp_free_list = tcp;
 				tsp->tcp_free_list_cnt++;
+				mutex_exit(&tsp->tcp_time_wait_lock);
 			} else {
 				/*
-				 * Do not add to tcp_free_list
+				 * No room in the free list; dispose of
+				 * the cleaned-up connection the same
+				 * way the collector drains the list.
 				 */
-				tcp_bind_hash_remove(tcp);
-				ixa_cleanup(tcp->tcp_connp->conn_ixa);
-				tcp_ipsec_cleanup(tcp);
-				CONN_DEC_REF(tcp->tcp_connp);
+				mutex_exit(&tsp->tcp_time_wait_lock);
+				CONN_DEC_REF(connp);
 			}
 
 			/*
@@ -387,10 +457,8 @@ tcp_time_wait_purge(tcp_t *tcp, tcp_squeue_priv_t *tsp)
 
 	TCP_DEBUG_GETPCSTACK(tcp->tcmp_stk, 15);
 	mp = &tcp->tcp_closemp;
-	mutex_exit(&tsp->tcp_time_wait_lock);
 	SQUEUE_ENTER_ONE(connp->conn_sqp, mp, tcp_timewait_close, connp, NULL,
 	    SQ_FILL, SQTAG_TCP_TIMEWAIT);
-	mutex_enter(&tsp->tcp_time_wait_lock);
 }
 
 /*
@@ -400,7 +468,7 @@ tcp_time_wait_purge(tcp_t *tcp, tcp_squeue_priv_t *tsp)
 void
 tcp_time_wait_collector(void *arg)
 {
-	tcp_t *tcp;
+	tcp_t *tcp, *twlist;
 	int64_t now, sched_active, sched_cur, sched_new;
 	unsigned int idx;
 
@@ -436,18 +504,21 @@ tcp_time_wait_collector(void *arg)
 	sched_cur = sched_active = tsp->tcp_time_wait_schedule;
 
 	/*
-	 * Purge the free list if necessary
+	 * Trim the free list if necessary.  Up to tcp_free_list_min_cnt
+	 * clean connections are retained across collector runs so that a
+	 * burst of incoming connections can be served from the free list
+	 * instead of allocating eagers under the listener's squeue.
 	 */
-	if (tsp->tcp_free_list != NULL) {
+	if (tsp->tcp_free_list_cnt > tcp_free_list_min_cnt) {
 		TCP_G_STAT(tcp_freelist_cleanup);
-		while ((tcp = tsp->tcp_free_list) != NULL) {
+		while (tsp->tcp_free_list_cnt > tcp_free_list_min_cnt) {
+			tcp = tsp->tcp_free_list;
 			tsp->tcp_free_list = tcp->tcp_time_wait_next;
 			tcp->tcp_time_wait_next = NULL;
 			tsp->tcp_free_list_cnt--;
 			ASSERT(tcp->tcp_tcps == NULL);
 			CONN_DEC_REF(tcp->tcp_connp);
 		}
-		ASSERT(tsp->tcp_free_list_cnt == 0);
 	}
 
 	/*
@@ -469,9 +540,15 @@ retry:
 	 */
 	idx = TW_BUCKET(sched_cur - 1);
 	now = ddi_get_lbolt64() - tsp->tcp_time_wait_offset;
-	tcp = tsp->tcp_time_wait_bucket[idx];
 
-	while (tcp != NULL) {
+	/*
+	 * Claim the whole batch of expired connections under the lock,
+	 * then purge them after dropping it, so the lock is never held
+	 * across the per-connection reclaim work no matter how large
+	 * the bucket has grown.
+	 */
+	twlist = NULL;
+	while ((tcp = tsp->tcp_time_wait_bucket[idx]) != NULL) {
 		/*
 		 * Since the bucket count is sized to prevent wrap-around
 		 * during typical operation and timers are schedule to process
@@ -490,26 +567,34 @@ retry:
 		}
 
 		/*
-		 * Pull the connection out of the bucket.
+		 * Pull the connection out of the bucket.  Removal also
+		 * claims the connection: any concurrent
+		 * tcp_time_wait_remove() will see tcp_time_wait_expire
+		 * cleared and back off.
 		 */
 		VERIFY(tcp_time_wait_remove(tcp, tsp));
+		tcp->tcp_time_wait_next = twlist;
+		twlist = tcp;
+	}
 
+	if (twlist != NULL) {
 		/*
-		 * Purge the connection.
+		 * Purge the claimed connections.
 		 *
-		 * While tcp_time_wait_lock will be temporarily dropped as part
-		 * of the process, there is no risk of the timer being
-		 * (re)scheduled while the collector is running since a value
-		 * corresponding to the past is left in tcp_time_wait_schedule.
+		 * While tcp_time_wait_lock is dropped here, there is no
+		 * risk of the timer being (re)scheduled while the
+		 * collector is running since a value corresponding to
+		 * the past is left in tcp_time_wait_schedule.
 		 */
-		tcp_time_wait_purge(tcp, tsp);
-
-		/*
-		 * Because tcp_time_wait_remove clears the tcp_time_wait_next
-		 * field, the next item must be grabbed directly from the
-		 * bucket itself.
-		 */
-		tcp = tsp->tcp_time_wait_bucket[idx];
+		TW_STAT_BUMP(tw_batches);
+		mutex_exit(&tsp->tcp_time_wait_lock);
+		while ((tcp = twlist) != NULL) {
+			twlist = tcp->tcp_time_wait_next;
+			tcp->tcp_time_wait_next = NULL;
+			tcp_time_wait_purge(tcp, tsp);
+			TW_STAT_BUMP(tw_reclaimed);
+		}
+		mutex_enter(&tsp->tcp_time_wait_lock);
 	}
 
 	if (tsp->tcp_time_wait_cnt == 0) {
@@ -1045,7 +1045,7 @@ timer_rexmit:
 	 * Remove all rexmit SACK blk to start from fresh.
 	 */
 	if (tcp->tcp_snd_sack_ok)
-		TCP_NOTSACK_REMOVE_ALL(tcp->tcp_notsack_list, tcp);
+		TCP_NOTSACK_REMOVE_ALL(tcp);
 	if (mp == NULL) {
 		return;
 	}
@@ -634,6 +634,7 @@ extern uint_t		tcp_max_optsize;
 extern int tcp_squeue_flag;
 
 extern uint_t tcp_free_list_max_cnt;
+extern uint_t tcp_free_list_min_cnt;
 
 /*
  * Functions in tcp.c.
@@ -808,6 +809,8 @@ extern int	tcp_opt_set(conn_t *, uint_t, int, int, uint_t, uchar_t *,
 extern void		tcp_time_wait_append(tcp_t *);
 extern void		tcp_time_wait_collector(void *);
 extern boolean_t	tcp_time_wait_remove(tcp_t *, tcp_squeue_priv_t *);
+extern void		tcp_time_wait_stat_init(void);
+extern void		tcp_time_wait_stat_fini(void);
 extern void		tcp_time_wait_processing(tcp_t *, mblk_t *, uint32_t,
 			    uint32_t, int, tcpha_t *, ip_recv_attr_t *);
 
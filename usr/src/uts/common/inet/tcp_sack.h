@@ -25,6 +25,8 @@
 #ifndef	_INET_TCP_SACK_H
 #define	_INET_TCP_SACK_H
 
+#include <sys/avl.h>
+
 #ifdef	__cplusplus
 extern "C" {
 #endif
@@ -43,11 +45,36 @@ typedef struct sack_blk
 typedef struct notsack_blk
 {
 	struct notsack_blk	*next;
+	avl_node_t		tree_node;
 	tcp_seq			begin;
 	tcp_seq			end;
-	uint32_t		sack_cnt; /* Dup SACK count */
+	uint32_t		sack_gen; /* list generation last not passed */
 } notsack_blk_t;
 
+/*
+ * Sender's list of notsack'ed blks (the SACK scoreboard).  The blks are
+ * kept both on a singly linked list sorted by sequence number, which the
+ * retransmit code walks in order, and on an AVL tree indexed by starting
+ * sequence number, which lets tcp_notsack_insert() find the blks covered
+ * by a SACK without walking the whole list.
+ */
+typedef struct notsack_list
+{
+	notsack_blk_t	*nsl_head;	/* start of the sorted list */
+	notsack_blk_t	*nsl_tail;	/* end of the sorted list */
+	avl_tree_t	nsl_tree;	/* the same blks, keyed by begin */
+	uint32_t	nsl_gen;	/* # of SACK blks processed */
+} notsack_list_t;
+
+/*
+ * The dup SACK count of a notsack'ed blk: the number of SACKs processed
+ * for data above the blk since it was added.  Every SACK processed by
+ * tcp_notsack_insert() advances nsl_gen, charging a pass against every
+ * blk on the list; blks at or above the SACK'ed range are then brought
+ * along by advancing their sack_gen, cancelling the charge.
+ */
+#define	TCP_NOTSACK_SACK_CNT(nsl, blk) \
+	((nsl)->nsl_gen - (blk)->sack_gen)
 
 /* SACK information in the tcp_t structure. */
 typedef struct
@@ -65,45 +92,26 @@ typedef struct
 	/* # of bytes represented in blks in notsack list */
 	uint32_t	tcp_cnt_notsack_list;
 	/* the notsack list */
-	notsack_blk_t	*tcp_notsack_list;
+	notsack_list_t	tcp_notsack;
 } tcp_sack_info_t;
 
 extern void tcp_sack_insert(sack_blk_t *, tcp_seq, tcp_seq, int32_t *);
 extern void tcp_sack_remove(sack_blk_t *, tcp_seq, int32_t *);
-extern void tcp_notsack_insert(notsack_blk_t **, tcp_seq, tcp_seq,
+extern void tcp_notsack_insert(notsack_list_t *, tcp_seq, tcp_seq,
     int32_t *, uint32_t *);
-extern void tcp_notsack_remove(notsack_blk_t **, tcp_seq, int32_t *,
+extern void tcp_notsack_remove(notsack_list_t *, tcp_seq, int32_t *,
     uint32_t *);
-extern void tcp_notsack_update(notsack_blk_t **, tcp_seq, tcp_seq,
+extern void tcp_notsack_update(notsack_list_t *, tcp_seq, tcp_seq,
     int32_t *, uint32_t *);
+extern void tcp_notsack_remove_all(notsack_list_t *, int32_t *, uint32_t *);
 
 /* Defined in tcp_sack.c */
 extern kmem_cache_t	*tcp_notsack_blk_cache;
 
-/*
- * Macro to remove all the notsack'ed blks in sender.
- *
- * Param:
- * notsack_blk_t *head: pointer to the head of the list of notsack'ed blks.
- */
-#define	TCP_NOTSACK_REMOVE_ALL(head, tcp)			\
-{								\
-	if ((head) != NULL) {					\
-		notsack_blk_t *prev, *tmp;			\
-		tmp = (head);					\
-		do  {						\
-			prev = tmp;				\
-			tmp = tmp->next;			\
-			kmem_cache_free(tcp_notsack_blk_cache, prev); \
-		} while (tmp != NULL);				\
-		(head) = NULL;					\
-		(tcp)->tcp_cnt_notsack_list = 0;		\
-		(tcp)->tcp_num_notsack_blk = 0;			\
-	} else {						\
-		ASSERT((tcp)->tcp_cnt_notsack_list == 0);	\
-		ASSERT((tcp)->tcp_num_notsack_blk == 0);	\
-	}							\
-}
+/* Macro to remove all the notsack'ed blks in sender. */
+#define	TCP_NOTSACK_REMOVE_ALL(tcp)				\
+	tcp_notsack_remove_all(&(tcp)->tcp_notsack,		\
+	    &(tcp)->tcp_num_notsack_blk, &(tcp)->tcp_cnt_notsack_list)
 
 #ifdef	__cplusplus
 }
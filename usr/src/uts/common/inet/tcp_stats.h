@@ -197,6 +197,10 @@ typedef struct tcp_g_stat {
 	kstat_named_t	tcp_timermp_allocfail;
 	kstat_named_t	tcp_timermp_allocdblfail;
 	kstat_named_t	tcp_freelist_cleanup;
+	kstat_named_t	tcp_freelist_hit;
+	kstat_named_t	tcp_freelist_miss;
+	kstat_named_t	tcp_notsack_blks;
+	kstat_named_t	tcp_notsack_allocfail;
 } tcp_g_stat_t;
 
 /* Per CPU stats: TCP MIB2, TCP kstat and connection counter. */
@@ -245,6 +249,15 @@ typedef struct tcp_conn_stats {
 
 #define	TCP_G_STAT(x)	(tcp_g_statistics.x.value.ui64++)
 
+/*
+ * For global stats updated from more than one CPU, where the non-atomic
+ * TCP_G_STAT() increment could lose updates.
+ */
+#define	TCP_G_STAT_INC(x)	atomic_inc_64(&(tcp_g_statistics.x.value.ui64))
+#define	TCP_G_STAT_DEC(x)	atomic_dec_64(&(tcp_g_statistics.x.value.ui64))
+#define	TCP_G_STAT_SUB(x, n)	\
+	atomic_add_64(&(tcp_g_statistics.x.value.ui64), -(int64_t)(n))
+
 #define	TCP_STAT(tcps, x)		\
 	((tcps)->tcps_sc[CPU->cpu_seqid]->tcp_sc_stats.x++)
 #define	TCP_STAT_UPDATE(tcps, x, n)	\
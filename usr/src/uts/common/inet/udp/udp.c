@@ -5256,6 +5256,21 @@ udp_do_bind(conn_t *connp, struct sockaddr *sa, socklen_t len, cred_t *cr,
 			    &v6src)) {
 				continue;
 			}
+
+			/*
+			 * SO_REUSEPORT: endpoints that all request it may
+			 * share the identical address and port; inbound
+			 * packets are then spread across the group by
+			 * ipcl_classify_v4()/v6().  Both sides must have
+			 * asked for it, so that a group cannot be joined
+			 * (or hijacked) by a socket that didn't opt in.
+			 */
+			if (connp->conn_reuseport && connp1->conn_reuseport &&
+			    requested_port != 0 &&
+			    IN6_ARE_ADDR_EQUAL(&connp1->conn_bound_addr_v6,
+			    &v6src)) {
+				continue;
+			}
 			break;
 		}
 
@@ -43,6 +43,8 @@
 #include <sys/sdt.h>
 #include <sys/stack.h>
 #include <sys/ddi_impldefs.h>
+#include <sys/kstat.h>
+#include <sys/errno.h>
 #ifdef __xpv
 #include <sys/evtchn_impl.h>
 #endif
@@ -105,6 +107,51 @@ ddi_softint_hdl_impl_t softlevel_hdl[DDI_IPL_10] = {
 ddi_softint_hdl_impl_t softlevel1_hdl =
 	{0, 0, NULL, NULL, 0, NULL, NULL, NULL};
 
+/*
+ * Interrupt auto-tune framework.  When av_autotune_enable is set the
+ * hardware interrupt dispatch paths record, per autovec entry, how many
+ * times the handler has run and the unscaled time spent in it.  A
+ * driver that registers with av_autotune_register() gets a named kstat
+ * exposing the figures and a periodic callback carrying the device's
+ * interrupt arrival rate and mean service latency, from which it can
+ * adapt its coalescing parameters as load shifts between throughput
+ * and latency profiles.
+ */
+int av_autotune_enable = 1;
+
+/*
+ * Seconds between samples of registered devices.  Each sample computes
+ * the arrival rate and mean service latency over the elapsed interval
+ * and invokes the driver's callback with them.
+ */
+int av_autotune_interval = 10;
+
+typedef struct av_autotune {
+	struct av_autotune *avt_next;
+	dev_info_t	*avt_dip;	/* device being sampled */
+	av_autotune_cb_t avt_cb;	/* driver coalescing callback */
+	void		*avt_cbarg;
+	kstat_t		*avt_ksp;
+	uint64_t	avt_dispatches;	/* totals at last sample */
+	uint64_t	avt_cycles;
+	hrtime_t	avt_snap;	/* time of last sample */
+	uint64_t	avt_rate;	/* intrs/sec over last interval */
+	hrtime_t	avt_avg_nsec;	/* mean service time, ditto */
+} av_autotune_t;
+
+typedef struct av_autotune_kstat {
+	kstat_named_t	avtk_dispatches;
+	kstat_named_t	avtk_service_nsec;
+	kstat_named_t	avtk_rate;
+	kstat_named_t	avtk_avg_nsec;
+} av_autotune_kstat_t;
+
+static kmutex_t av_autotune_lock;
+static av_autotune_t *av_autotune_list;
+static timeout_id_t av_autotune_tid;
+
+static void av_autotune_sampler(void *);
+
 /*
  * clear/check softint pending flag corresponding for
  * the current CPU
@@ -676,6 +723,187 @@ siron_poke_cpu(cpuset_t poke)
 	xc_call(0, 0, 0, CPUSET2BV(poke), (xc_func_t)siron_poke_intr);
 }
 
+/*
+ * Sum the dispatch and service-time totals of every handler installed
+ * for the given device.  The PSM may supply its own walk via the
+ * getintrstat hook (apix keeps per-CPU vector tables); otherwise the
+ * common autovect table is scanned.  The walk is lock-free: handlers
+ * added or removed concurrently can make a sample slightly off, which
+ * the consumers tolerate.
+ */
+static void
+av_intr_stats(dev_info_t *dip, uint64_t *dispatchesp, uint64_t *cyclesp)
+{
+	struct autovec *av;
+	int i;
+
+	if (getintrstat != NULL) {
+		(*getintrstat)(dip, dispatchesp, cyclesp);
+		return;
+	}
+
+	*dispatchesp = 0;
+	*cyclesp = 0;
+	for (i = 0; i < MAX_VECT; i++) {
+		for (av = autovect[i].avh_link; av; av = av->av_link) {
+			if (av->av_dip != dip)
+				continue;
+			*dispatchesp += av->av_dispatches;
+			*cyclesp += av->av_cycles;
+		}
+	}
+}
+
+static int
+av_autotune_kstat_update(kstat_t *ksp, int rw)
+{
+	av_autotune_t *avt = ksp->ks_private;
+	av_autotune_kstat_t *avtk = ksp->ks_data;
+	uint64_t dispatches, cycles;
+	hrtime_t nsec;
+
+	if (rw == KSTAT_WRITE)
+		return (EACCES);
+
+	av_intr_stats(avt->avt_dip, &dispatches, &cycles);
+	nsec = (hrtime_t)cycles;
+	scalehrtime(&nsec);
+
+	avtk->avtk_dispatches.value.ui64 = dispatches;
+	avtk->avtk_service_nsec.value.ui64 = (uint64_t)nsec;
+	avtk->avtk_rate.value.ui64 = avt->avt_rate;
+	avtk->avtk_avg_nsec.value.ui64 = (uint64_t)avt->avt_avg_nsec;
+	return (0);
+}
+
+/*ARGSUSED*/
+static void
+av_autotune_sampler(void *arg)
+{
+	av_autotune_t *avt;
+	hrtime_t now = gethrtime();
+
+	mutex_enter(&av_autotune_lock);
+	for (avt = av_autotune_list; avt != NULL; avt = avt->avt_next) {
+		uint64_t dispatches, cycles, delta;
+		hrtime_t elapsed = now - avt->avt_snap;
+		hrtime_t svc;
+
+		av_intr_stats(avt->avt_dip, &dispatches, &cycles);
+		delta = dispatches - avt->avt_dispatches;
+		svc = (hrtime_t)(cycles - avt->avt_cycles);
+		scalehrtime(&svc);
+
+		avt->avt_rate = (elapsed > 0) ?
+		    delta * NANOSEC / (uint64_t)elapsed : 0;
+		avt->avt_avg_nsec = (delta > 0) ?
+		    svc / (hrtime_t)delta : 0;
+		avt->avt_dispatches = dispatches;
+		avt->avt_cycles = cycles;
+		avt->avt_snap = now;
+
+		if (avt->avt_cb != NULL) {
+			(*avt->avt_cb)(avt->avt_cbarg, avt->avt_rate,
+			    avt->avt_avg_nsec);
+		}
+	}
+	if (av_autotune_list != NULL) {
+		av_autotune_tid = timeout(av_autotune_sampler, NULL,
+		    drv_usectohz((clock_t)av_autotune_interval * MICROSEC));
+	} else {
+		av_autotune_tid = 0;
+	}
+	mutex_exit(&av_autotune_lock);
+}
+
+/*
+ * Register a device for interrupt auto-tuning.  The callback (which
+ * may be NULL if only the kstat surface is wanted) is invoked every
+ * av_autotune_interval seconds with the device's interrupt rate and
+ * mean service latency; it runs in callout context, must not block,
+ * and must not call av_autotune_unregister().  Returns 1 on success
+ * and 0 if the device is already registered.
+ */
+int
+av_autotune_register(dev_info_t *dip, av_autotune_cb_t cb, void *arg)
+{
+	av_autotune_t *avt, *p;
+	av_autotune_kstat_t *avtk;
+	kstat_t *ksp;
+
+	avt = kmem_zalloc(sizeof (av_autotune_t), KM_SLEEP);
+	avt->avt_dip = dip;
+	avt->avt_cb = cb;
+	avt->avt_cbarg = arg;
+	av_intr_stats(dip, &avt->avt_dispatches, &avt->avt_cycles);
+	avt->avt_snap = gethrtime();
+
+	ksp = kstat_create("avintr", ddi_get_instance(dip),
+	    (char *)ddi_driver_name(dip), "intr", KSTAT_TYPE_NAMED,
+	    sizeof (av_autotune_kstat_t) / sizeof (kstat_named_t), 0);
+	if (ksp != NULL) {
+		avtk = ksp->ks_data;
+		kstat_named_init(&avtk->avtk_dispatches, "dispatches",
+		    KSTAT_DATA_UINT64);
+		kstat_named_init(&avtk->avtk_service_nsec, "service_nsec",
+		    KSTAT_DATA_UINT64);
+		kstat_named_init(&avtk->avtk_rate, "rate",
+		    KSTAT_DATA_UINT64);
+		kstat_named_init(&avtk->avtk_avg_nsec, "avg_service_nsec",
+		    KSTAT_DATA_UINT64);
+		ksp->ks_update = av_autotune_kstat_update;
+		ksp->ks_private = avt;
+		avt->avt_ksp = ksp;
+	}
+
+	mutex_enter(&av_autotune_lock);
+	for (p = av_autotune_list; p != NULL; p = p->avt_next) {
+		if (p->avt_dip == dip)
+			break;
+	}
+	if (p != NULL) {
+		mutex_exit(&av_autotune_lock);
+		if (avt->avt_ksp != NULL)
+			kstat_delete(avt->avt_ksp);
+		kmem_free(avt, sizeof (av_autotune_t));
+		return (0);
+	}
+	avt->avt_next = av_autotune_list;
+	av_autotune_list = avt;
+	if (av_autotune_tid == 0) {
+		av_autotune_tid = timeout(av_autotune_sampler, NULL,
+		    drv_usectohz((clock_t)av_autotune_interval * MICROSEC));
+	}
+	mutex_exit(&av_autotune_lock);
+
+	if (avt->avt_ksp != NULL)
+		kstat_install(avt->avt_ksp);
+	return (1);
+}
+
+void
+av_autotune_unregister(dev_info_t *dip)
+{
+	av_autotune_t *avt, **prev;
+
+	mutex_enter(&av_autotune_lock);
+	prev = &av_autotune_list;
+	for (avt = av_autotune_list; avt != NULL; avt = avt->avt_next) {
+		if (avt->avt_dip == dip) {
+			*prev = avt->avt_next;
+			break;
+		}
+		prev = &avt->avt_next;
+	}
+	mutex_exit(&av_autotune_lock);
+
+	if (avt == NULL)
+		return;
+	if (avt->avt_ksp != NULL)
+		kstat_delete(avt->avt_ksp);
+	kmem_free(avt, sizeof (av_autotune_t));
+}
+
 /*
  * Walk the autovector table for this vector, invoking each
  * interrupt handler as we go.
@@ -700,6 +928,7 @@ av_dispatch_autovect(uint_t vec)
 			caddr_t arg1 = av->av_intarg1;
 			caddr_t arg2 = av->av_intarg2;
 			dev_info_t *dip = av->av_dip;
+			hrtime_t t0 = 0;
 
 			/*
 			 * We must walk the entire chain.  Removed handlers
@@ -708,11 +937,18 @@ av_dispatch_autovect(uint_t vec)
 			if (intr == NULL)
 				continue;
 
+			if (av_autotune_enable)
+				t0 = gethrtime_unscaled();
 			DTRACE_PROBE4(interrupt__start, dev_info_t *, dip,
 			    void *, intr, caddr_t, arg1, caddr_t, arg2);
 			r = (*intr)(arg1, arg2);
 			DTRACE_PROBE4(interrupt__complete, dev_info_t *, dip,
 			    void *, intr, caddr_t, arg1, uint_t, r);
+			if (av_autotune_enable) {
+				atomic_inc_64(&av->av_dispatches);
+				atomic_add_64(&av->av_cycles,
+				    (uint64_t)(gethrtime_unscaled() - t0));
+			}
 			numcalled++;
 			claimed |= r;
 			if (av->av_ticksp && av->av_prilevel <= LOCK_LEVEL)
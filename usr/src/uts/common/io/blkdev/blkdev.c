@@ -44,6 +44,7 @@
 #include <sys/devops.h>
 #include <sys/list.h>
 #include <sys/sysmacros.h>
+#include <sys/bitmap.h>
 #include <sys/dkio.h>
 #include <sys/dkioc_free_util.h>
 #include <sys/vtoc.h>
@@ -183,6 +184,8 @@ struct bd {
 	kstat_io_t	*d_kiop;
 	kstat_t		*d_errstats;
 	struct bd_errstats *d_kerr;
+	kstat_t		*d_latstats;
+	struct bd_latstats *d_klat;
 
 	boolean_t	d_rdonly;
 	boolean_t	d_ssd;
@@ -223,6 +226,7 @@ struct bd_xfer_impl {
 	uint32_t	i_blkshift;
 	size_t		i_len;
 	size_t		i_resid;
+	hrtime_t	i_start_time;
 };
 
 struct bd_queue {
@@ -233,6 +237,22 @@ struct bd_queue {
 	list_t		q_waitq;
 };
 
+/*
+ * Log-scale I/O latency histograms, exported as the <driver><inst>,lat
+ * named kstat (class "disk_latency").  Bucket b counts completions whose
+ * submit-to-completion latency fell in [2^(b-1), 2^b) microseconds, with
+ * the first and last buckets absorbing the tails; each bucket is named
+ * for its lower bound (e.g. "r_us_1024").  Maintenance is one atomic
+ * increment per completion.
+ */
+#define	BD_LAT_BUCKETS	32
+
+struct bd_latstats {
+	kstat_named_t	bd_lat_rd[BD_LAT_BUCKETS];
+	kstat_named_t	bd_lat_wr[BD_LAT_BUCKETS];
+	kstat_named_t	bd_lat_fl[BD_LAT_BUCKETS];
+};
+
 #define	i_dmah		i_public.x_dmah
 #define	i_dmac		i_public.x_dmac
 #define	i_ndmac		i_public.x_ndmac
@@ -257,6 +277,9 @@ static void bd_destroy_errstats(bd_t *);
 static void bd_errstats_setstr(kstat_named_t *, char *, size_t, char *);
 static void bd_init_errstats(bd_t *, bd_drive_t *);
 static void bd_fini_errstats(bd_t *);
+static void bd_create_latstats(bd_t *, int);
+static void bd_destroy_latstats(bd_t *);
+static void bd_update_latstats(kstat_named_t *, hrtime_t);
 
 static int bd_getinfo(dev_info_t *, ddi_info_cmd_t, void *, void **);
 static int bd_attach(dev_info_t *, ddi_attach_cmd_t);
@@ -550,6 +573,77 @@ bd_destroy_errstats(bd_t *bd)
 	}
 }
 
+static void
+bd_create_latstats(bd_t *bd, int inst)
+{
+	char	ks_name[KSTAT_STRLEN];
+	char	nm[KSTAT_STRLEN];
+	int	ndata = sizeof (struct bd_latstats) / sizeof (kstat_named_t);
+	struct bd_latstats *lsp;
+	int	i;
+
+	(void) snprintf(ks_name, sizeof (ks_name), "%s%d,lat",
+	    ddi_driver_name(bd->d_dip), inst);
+
+	bd->d_latstats = kstat_create(ddi_driver_name(bd->d_dip), inst,
+	    ks_name, "disk_latency", KSTAT_TYPE_NAMED, ndata,
+	    KSTAT_FLAG_PERSISTENT);
+
+	if (bd->d_latstats == NULL) {
+		/*
+		 * As with d_kiop above, fall back to a scratch kstat so
+		 * that the I/O path never has to check for the kstat's
+		 * existence.
+		 */
+		bd->d_klat = kmem_zalloc(sizeof (struct bd_latstats),
+		    KM_SLEEP);
+	} else {
+		bd->d_klat = bd->d_latstats->ks_data;
+	}
+
+	lsp = bd->d_klat;
+	for (i = 0; i < BD_LAT_BUCKETS; i++) {
+		uint64_t lb = (i == 0) ? 0 : (1ULL << (i - 1));
+
+		(void) snprintf(nm, sizeof (nm), "r_us_%llu",
+		    (u_longlong_t)lb);
+		kstat_named_init(&lsp->bd_lat_rd[i], nm, KSTAT_DATA_UINT64);
+		(void) snprintf(nm, sizeof (nm), "w_us_%llu",
+		    (u_longlong_t)lb);
+		kstat_named_init(&lsp->bd_lat_wr[i], nm, KSTAT_DATA_UINT64);
+		(void) snprintf(nm, sizeof (nm), "f_us_%llu",
+		    (u_longlong_t)lb);
+		kstat_named_init(&lsp->bd_lat_fl[i], nm, KSTAT_DATA_UINT64);
+	}
+
+	if (bd->d_latstats != NULL)
+		kstat_install(bd->d_latstats);
+}
+
+static void
+bd_destroy_latstats(bd_t *bd)
+{
+	if (bd->d_latstats != NULL) {
+		kstat_delete(bd->d_latstats);
+		bd->d_latstats = NULL;
+	} else {
+		kmem_free(bd->d_klat, sizeof (struct bd_latstats));
+	}
+	bd->d_klat = NULL;
+}
+
+static void
+bd_update_latstats(kstat_named_t *hist, hrtime_t start)
+{
+	hrtime_t us = (gethrtime() - start) / (NANOSEC / MICROSEC);
+	int b = highbit64((uint64_t)us);
+
+	if (b >= BD_LAT_BUCKETS)
+		b = BD_LAT_BUCKETS - 1;
+
+	atomic_inc_64(&hist[b].value.ui64);
+}
+
 static void
 bd_errstats_setstr(kstat_named_t *k, char *str, size_t len, char *alt)
 {
@@ -747,6 +841,8 @@ bd_attach(dev_info_t *dip, ddi_attach_cmd_t cmd)
 		bd->d_kiop = kmem_zalloc(sizeof (kstat_io_t), KM_SLEEP);
 	}
 
+	bd_create_latstats(bd, inst);
+
 	cmlb_alloc_handle(&bd->d_cmlbh);
 
 	bd->d_state = DKIO_NONE;
@@ -879,6 +975,8 @@ fail_cmlb_attach:
 fail_drive_info:
 	cmlb_free_handle(&bd->d_cmlbh);
 
+	bd_destroy_latstats(bd);
+
 	if (bd->d_ksp != NULL) {
 		kstat_delete(bd->d_ksp);
 		bd->d_ksp = NULL;
@@ -924,6 +1022,7 @@ bd_detach(dev_info_t *dip, ddi_detach_cmd_t cmd)
 		kmem_free(bd->d_kiop, sizeof (kstat_io_t));
 	}
 
+	bd_destroy_latstats(bd);
 	bd_destroy_errstats(bd);
 	cmlb_detach(bd->d_cmlbh, 0);
 	cmlb_free_handle(&bd->d_cmlbh);
@@ -1888,6 +1987,7 @@ bd_submit(bd_t *bd, bd_xfer_impl_t *xi)
 
 	xi->i_bq = bq;
 	xi->i_qnum = q;
+	xi->i_start_time = gethrtime();
 
 	mutex_enter(&bq->q_iomutex);
 
@@ -1920,15 +2020,21 @@ bd_runq_exit(bd_xfer_impl_t *xi, int err)
 	mutex_exit(&bq->q_iomutex);
 
 	if (err == 0) {
+		kstat_named_t	*hist;
+
 		if (bp->b_flags & B_READ) {
 			atomic_inc_uint(&bd->d_kiop->reads);
 			atomic_add_64((uint64_t *)&bd->d_kiop->nread,
 			    bp->b_bcount - xi->i_resid);
+			hist = bd->d_klat->bd_lat_rd;
 		} else {
 			atomic_inc_uint(&bd->d_kiop->writes);
 			atomic_add_64((uint64_t *)&bd->d_kiop->nwritten,
 			    bp->b_bcount - xi->i_resid);
+			hist = (xi->i_func == bd->d_ops.o_sync_cache) ?
+			    bd->d_klat->bd_lat_fl : bd->d_klat->bd_lat_wr;
 		}
+		bd_update_latstats(hist, xi->i_start_time);
 	}
 	bd_sched(bd, bq);
 }
@@ -75,8 +75,8 @@
  *    dmu_tx_abort(tx)
  *    zil_commit()
  *
- *    rangelock_enter()
- *    rangelock_exit()
+ *    zvol_rangelock_enter()
+ *    zvol_rangelock_exit()
  *
  *    zvol_log_write()
  *
@@ -88,7 +88,7 @@
  *    zv_flags		- for WCE
  *    zv_objset		- dmu_tx_create
  *    zv_zilog		- zil_commit
- *    zv_znode		- rangelock_enter
+ *    zv_znode		- zvol_rangelock_enter
  *    zv_dn		- dmu_buf_hold_array_by_bonus, dmu_request_arcbuf
  * GLOBAL DATA
  *    zvol_maxphys
@@ -114,7 +114,7 @@ sbd_zvol_get_volume_params(sbd_lu_t *sl)
 	    &sl->sl_zvol_minor_hdl,	/* minor soft state */
 	    &sl->sl_zvol_objset_hdl,	/* dmu_tx_create */
 	    &sl->sl_zvol_zil_hdl,	/* zil_commit */
-	    &sl->sl_zvol_rl_hdl,	/* locked_range_t */
+	    &sl->sl_zvol_rl_hdl,	/* zvol range lock shards */
 	    &sl->sl_zvol_dn_hdl);	/* dmu_buf_hold_array_by_dnode, */
 					/* dmu_request_arcbuf, */
 					/* dmu_assign_arcbuf */
@@ -154,7 +154,7 @@ int
 sbd_zvol_alloc_read_bufs(sbd_lu_t *sl, stmf_data_buf_t *dbuf)
 {
 	sbd_zvol_io_t	*zvio = dbuf->db_lu_private;
-	locked_range_t	*lr;
+	zvol_locked_range_t *lr;
 	int		numbufs, error;
 	uint64_t	len = dbuf->db_data_size;
 	uint64_t	offset = zvio->zvio_offset;
@@ -170,13 +170,13 @@ sbd_zvol_alloc_read_bufs(sbd_lu_t *sl, stmf_data_buf_t *dbuf)
 	 * The range lock is only held until the dmu buffers read in and
 	 * held; not during the callers use of the data.
 	 */
-	lr = rangelock_enter(sl->sl_zvol_rl_hdl, offset, len, RL_READER);
+	lr = zvol_rangelock_enter(sl->sl_zvol_rl_hdl, offset, len, RL_READER);
 
 	error = dmu_buf_hold_array_by_dnode(sl->sl_zvol_dn_hdl,
 	    offset, len, TRUE, RDTAG, &numbufs, &dbpp,
 	    DMU_READ_PREFETCH);
 
-	rangelock_exit(lr);
+	zvol_rangelock_exit(lr);
 
 	if (error == ECKSUM)
 		error = EIO;
@@ -338,7 +338,7 @@ sbd_zvol_rele_write_bufs(sbd_lu_t *sl, stmf_data_buf_t *dbuf)
 	sbd_zvol_io_t	*zvio = dbuf->db_lu_private;
 	dmu_tx_t	*tx;
 	int		sync, i, error;
-	locked_range_t	*lr;
+	zvol_locked_range_t *lr;
 	arc_buf_t	**abp = zvio->zvio_abp;
 	int		flags = zvio->zvio_flags;
 	uint64_t	toffset, offset = zvio->zvio_offset;
@@ -346,7 +346,7 @@ sbd_zvol_rele_write_bufs(sbd_lu_t *sl, stmf_data_buf_t *dbuf)
 
 	ASSERT(flags == 0 || flags == ZVIO_COMMIT || flags == ZVIO_ABORT);
 
-	lr = rangelock_enter(sl->sl_zvol_rl_hdl, offset, len, RL_WRITER);
+	lr = zvol_rangelock_enter(sl->sl_zvol_rl_hdl, offset, len, RL_WRITER);
 
 	tx = dmu_tx_create(sl->sl_zvol_objset_hdl);
 	dmu_tx_hold_write(tx, ZVOL_OBJ, offset, (int)len);
@@ -354,7 +354,7 @@ sbd_zvol_rele_write_bufs(sbd_lu_t *sl, stmf_data_buf_t *dbuf)
 
 	if (error) {
 		dmu_tx_abort(tx);
-		rangelock_exit(lr);
+		zvol_rangelock_exit(lr);
 		sbd_zvol_rele_write_bufs_abort(sl, dbuf);
 		return (error);
 	}
@@ -378,7 +378,7 @@ sbd_zvol_rele_write_bufs(sbd_lu_t *sl, stmf_data_buf_t *dbuf)
 	zvol_log_write_minor(sl->sl_zvol_minor_hdl, tx, offset,
 	    (ssize_t)len, sync);
 	dmu_tx_commit(tx);
-	rangelock_exit(lr);
+	zvol_rangelock_exit(lr);
 	kmem_free(zvio->zvio_abp,
 	    sizeof (arc_buf_t *) * dbuf->db_sglist_length);
 	zvio->zvio_abp = NULL;
@@ -403,10 +403,10 @@ sbd_zvol_copy_read(sbd_lu_t *sl, uio_t *uio)
 	if (offset + len  > zvol_get_volume_size(sl->sl_zvol_minor_hdl))
 		return (EIO);
 
-	locked_range_t *lr = rangelock_enter(sl->sl_zvol_rl_hdl, offset, len,
-	    RL_READER);
+	zvol_locked_range_t *lr = zvol_rangelock_enter(sl->sl_zvol_rl_hdl,
+	    offset, len, RL_READER);
 	int error = dmu_read_uio_dnode(sl->sl_zvol_dn_hdl, uio, len);
-	rangelock_exit(lr);
+	zvol_rangelock_exit(lr);
 
 	if (error == ECKSUM)
 		error = EIO;
@@ -433,8 +433,8 @@ sbd_zvol_copy_write(sbd_lu_t *sl, uio_t *uio, int flags)
 	if (offset + len  > zvol_get_volume_size(sl->sl_zvol_minor_hdl))
 		return (EIO);
 
-	locked_range_t *lr = rangelock_enter(sl->sl_zvol_rl_hdl, offset, len,
-	    RL_WRITER);
+	zvol_locked_range_t *lr = zvol_rangelock_enter(sl->sl_zvol_rl_hdl,
+	    offset, len, RL_WRITER);
 	sync = !zvol_get_volume_wce(sl->sl_zvol_minor_hdl);
 
 	tx = dmu_tx_create(sl->sl_zvol_objset_hdl);
@@ -450,7 +450,7 @@ sbd_zvol_copy_write(sbd_lu_t *sl, uio_t *uio, int flags)
 		}
 		dmu_tx_commit(tx);
 	}
-	rangelock_exit(lr);
+	zvol_rangelock_exit(lr);
 
 	if (sync && (flags & ZVIO_COMMIT))
 		zil_commit(sl->sl_zvol_zil_hdl, ZVOL_OBJ);
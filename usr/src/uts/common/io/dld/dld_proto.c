@@ -31,6 +31,7 @@
 #include <sys/strsubr.h>
 #include <sys/strsun.h>
 #include <sys/vlan.h>
+#include <netinet/ip.h>
 #include <sys/dld_impl.h>
 #include <sys/mac_client.h>
 #include <sys/mac_client_impl.h>
@@ -1472,6 +1473,19 @@ dld_capab_poll(dld_str_t *dsp, void *data, uint_t flags)
 	return (ENOTSUP);
 }
 
+/*
+ * Advertise LSO to the stack even when the MAC (and ultimately its
+ * provider) lacks the hardware capability.  mac_tx() already emulates
+ * LSO in software via mac_hw_emul() just before handing a chain to a
+ * provider that can't handle it, so the stack may always pass down one
+ * large message; the per-MSS segmentation cost is then paid as late as
+ * possible, or not at all on the MAC-loopback path.  mac_sw_lso() only
+ * handles TCP/IPv4 and relies on the provider to checksum the
+ * resulting segments, so software LSO is only advertised when the MAC
+ * offers full IP and TCP checksum offload.
+ */
+boolean_t dld_sw_lso_enable = B_TRUE;
+
 static int
 dld_capab_lso(dld_str_t *dsp, void *data, uint_t flags)
 {
@@ -1482,6 +1496,7 @@ dld_capab_lso(dld_str_t *dsp, void *data, uint_t flags)
 	switch (flags) {
 	case DLD_ENABLE: {
 		mac_capab_lso_t		mac_lso;
+		uint32_t		hck_txflags = 0;
 
 		/*
 		 * Check if LSO is supported on this MAC & enable LSO
@@ -1505,6 +1520,21 @@ dld_capab_lso(dld_str_t *dsp, void *data, uint_t flags)
 			 */
 			dsp->ds_lso_max = MAX(lso->lso_max_tcpv4,
 			    lso->lso_max_tcpv6);
+		} else if (dld_sw_lso_enable &&
+		    mac_capab_get(dsp->ds_mh, MAC_CAPAB_HCKSUM, &hck_txflags) &&
+		    (hck_txflags & HCKSUM_IPHDRCKSUM) != 0 &&
+		    (hck_txflags & (HCKSUM_INET_FULL_V4 |
+		    HCKSUM_INET_PARTIAL)) != 0) {
+			/*
+			 * No LSO in hardware, but the MAC layer will
+			 * emulate it in software on our behalf; see the
+			 * comment above.
+			 */
+			lso->lso_flags = DLD_LSO_BASIC_TCP_IPV4;
+			lso->lso_max_tcpv4 = IP_MAXPACKET;
+			lso->lso_max_tcpv6 = 0;
+			dsp->ds_lso = B_TRUE;
+			dsp->ds_lso_max = IP_MAXPACKET;
 		} else {
 			dsp->ds_lso = B_FALSE;
 			dsp->ds_lso_max = 0;
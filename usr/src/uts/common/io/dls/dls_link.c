@@ -225,27 +225,32 @@ i_dls_head_hold(mod_hash_key_t key, mod_hash_val_t val)
 	dls_head_t *dhp = (dls_head_t *)val;
 
 	/*
-	 * The lock order is  mod_hash's internal lock -> dh_lock as in the
-	 * call to i_dls_link_rx -> mod_hash_find_cb_rval -> i_dls_head_hold
+	 * We are called with the mod hash's internal lock held, which
+	 * keeps dhp from being freed underneath us.  The hold must become
+	 * globally visible before dh_removing is examined, so that
+	 * dls_link_remove() either observes our reference or we observe
+	 * its dh_removing; the hold and release are otherwise lock-free
+	 * so that concurrent receive threads don't serialize here.
 	 */
-	mutex_enter(&dhp->dh_lock);
+	atomic_inc_32(&dhp->dh_ref);
+	membar_enter();
 	if (dhp->dh_removing) {
-		mutex_exit(&dhp->dh_lock);
+		atomic_dec_32(&dhp->dh_ref);
 		return (-1);
 	}
-	dhp->dh_ref++;
-	mutex_exit(&dhp->dh_lock);
 	return (0);
 }
 
 void
 i_dls_head_rele(dls_head_t *dhp)
 {
-	mutex_enter(&dhp->dh_lock);
-	dhp->dh_ref--;
-	if (dhp->dh_ref == 0 && dhp->dh_removing != 0)
-		cv_broadcast(&dhp->dh_cv);
-	mutex_exit(&dhp->dh_lock);
+	/*
+	 * Order the preceding list walk before the release so that a
+	 * waiting dls_link_remove() cannot proceed while we are still
+	 * using the dh_list.
+	 */
+	membar_exit();
+	atomic_dec_32(&dhp->dh_ref);
 }
 
 static dls_head_t *
@@ -1056,20 +1061,23 @@ dls_link_remove(dls_link_t *dlp, dld_str_t *dsp)
 	 * We set dh_removing here to tell the receive callbacks not to pass
 	 * up packets anymore. Then wait till the current callbacks are done.
 	 * This happens either in the close path or in processing the
-	 * DL_UNBIND_REQ via a taskq thread, and it is ok to cv_wait in either.
+	 * DL_UNBIND_REQ via a taskq thread, and it is ok to block in either.
 	 * The dh_ref ensures there aren't and there won't be any upcalls
 	 * walking or using the dh_list. The mod hash internal lock ensures
 	 * that the insert/remove of the dls_head_t itself synchronizes with
 	 * any i_dls_link_rx trying to locate it. The perimeter ensures that
 	 * there isn't another simultaneous dls_link_add/remove.
+	 *
+	 * Since i_dls_head_hold() and i_dls_head_rele() are lock-free,
+	 * poll for the reference count to drain rather than waiting on a
+	 * condition variable; removal is a rare control operation.
 	 */
 	dhp = dsp->ds_head;
 
-	mutex_enter(&dhp->dh_lock);
 	dhp->dh_removing = B_TRUE;
+	membar_enter();
 	while (dhp->dh_ref != 0)
-		cv_wait(&dhp->dh_cv, &dhp->dh_lock);
-	mutex_exit(&dhp->dh_lock);
+		delay(1);
 
 	/*
 	 * Walk the list and remove the dld_str_t.
@@ -1096,8 +1104,7 @@ dls_link_remove(dls_link_t *dlp, dld_str_t *dsp)
 		ASSERT(dhp == (dls_head_t *)val);
 		i_dls_head_free(dhp);
 	} else {
-		mutex_enter(&dhp->dh_lock);
 		dhp->dh_removing = B_FALSE;
-		mutex_exit(&dhp->dh_lock);
+		membar_producer();
 	}
 }
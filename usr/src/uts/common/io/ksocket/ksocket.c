@@ -35,12 +35,18 @@
 #include <sys/sockio.h>		/* SIOC* ioctls */
 #include <sys/poll_impl.h>
 #include <sys/cmn_err.h>
+#include <sys/cred.h>
+#include <sys/cpuvar.h>
+#include <sys/disp.h>
+#include <sys/taskq_impl.h>
 #include <sys/ksocket.h>
 #include <io/ksocket/ksocket_impl.h>
 #include <fs/sockfs/sockcommon.h>
 
 #define	SOCKETMOD_TCP	"tcp"
 #define	SOCKETMOD_UDP	"udp"
+
+static void ksocket_aio_drain(struct sonode *);
 /*
  * Kernel Sockets
  *
@@ -550,6 +556,10 @@ ksocket_close(ksocket_t ks, struct cred *cr)
 		cv_wait(&so->so_closing_cv, &so->so_lock);
 
 	mutex_exit(&so->so_lock);
+
+	/* Wind down async I/O, completing pending operations */
+	ksocket_aio_drain(so);
+
 	/* Remove callbacks, if any */
 	(void) ksocket_setcallbacks(ks, NULL, NULL, cr);
 
@@ -938,3 +948,299 @@ ksocket_krecv_unblock(ksocket_t ks)
 {
 	return (so_krecv_unblock(KSTOSO(ks)));
 }
+
+/*
+ * Asynchronous I/O.
+ *
+ * Submitted operations are queued per socket and direction, and worker
+ * threads from a shared taskq drive them with non-blocking socket calls,
+ * so a kernel protocol server can keep thousands of connections in
+ * flight without dedicating a thread to each.  The workers are kicked
+ * from so_notify_*() (see KSOCKET_AIO_NOTIFY()) whenever a socket
+ * becomes readable or writable.  At most one worker per direction is
+ * dispatched at a time; the event generation count catches events that
+ * arrive while a worker is between attempts so that no wakeup is lost.
+ */
+
+#define	KSOCKET_AIO_RECVQ	0
+#define	KSOCKET_AIO_SENDQ	1
+
+typedef struct ksocket_aio_state {
+	kmutex_t	kas_lock;
+	kcondvar_t	kas_cv;		/* drain wait */
+	struct sonode	*kas_so;
+	ksocket_aio_t	*kas_head[2];	/* pending ops, FIFO */
+	ksocket_aio_t	*kas_tail[2];
+	uint_t		kas_gen[2];	/* event generation counts */
+	uint_t		kas_sched;	/* bit per dispatched worker */
+	uint_t		kas_busy;	/* # of dispatched workers */
+	boolean_t	kas_draining;
+	taskq_ent_t	kas_tqent[2];
+} ksocket_aio_state_t;
+
+static kmutex_t	ksocket_aio_lock;	/* protects taskq creation */
+static taskq_t	*ksocket_aio_taskq;
+
+void
+ksocket_aio_init(void)
+{
+	mutex_init(&ksocket_aio_lock, NULL, MUTEX_DEFAULT, NULL);
+}
+
+void
+ksocket_aio_fini(void)
+{
+	if (ksocket_aio_taskq != NULL) {
+		taskq_destroy(ksocket_aio_taskq);
+		ksocket_aio_taskq = NULL;
+	}
+	mutex_destroy(&ksocket_aio_lock);
+}
+
+static void
+ksocket_aio_worker(ksocket_aio_state_t *kas, int dir)
+{
+	struct sonode *so = kas->kas_so;
+	ksocket_aio_t *op;
+	uint_t gen;
+	size_t n;
+	int error;
+
+	mutex_enter(&kas->kas_lock);
+	for (;;) {
+		gen = kas->kas_gen[dir];
+		if (kas->kas_draining || (op = kas->kas_head[dir]) == NULL)
+			break;
+		mutex_exit(&kas->kas_lock);
+
+		n = 0;
+		if (dir == KSOCKET_AIO_RECVQ) {
+			error = ksocket_recv(SOTOKS(so),
+			    (char *)op->kaio_buf + op->kaio_count,
+			    op->kaio_size - op->kaio_count,
+			    op->kaio_flags | MSG_DONTWAIT, &n, op->kaio_cred);
+		} else {
+			error = ksocket_send(SOTOKS(so),
+			    (char *)op->kaio_buf + op->kaio_count,
+			    op->kaio_size - op->kaio_count,
+			    op->kaio_flags | MSG_DONTWAIT, &n, op->kaio_cred);
+		}
+		op->kaio_count += n;
+
+		if (error == EWOULDBLOCK || error == EAGAIN) {
+			/*
+			 * Wait for the socket to become ready again; the
+			 * next notification redispatches us.  If an event
+			 * arrived while we were trying, try again now.
+			 */
+			mutex_enter(&kas->kas_lock);
+			if (kas->kas_gen[dir] != gen)
+				continue;
+			break;
+		}
+
+		/* A partially sent operation stays at the head. */
+		if (error == 0 && dir == KSOCKET_AIO_SENDQ && n != 0 &&
+		    op->kaio_count < op->kaio_size) {
+			mutex_enter(&kas->kas_lock);
+			continue;
+		}
+
+		mutex_enter(&kas->kas_lock);
+		ASSERT(kas->kas_head[dir] == op);
+		kas->kas_head[dir] = op->kaio_next;
+		if (kas->kas_head[dir] == NULL)
+			kas->kas_tail[dir] = NULL;
+		mutex_exit(&kas->kas_lock);
+
+		op->kaio_next = NULL;
+		op->kaio_error = error;
+		crfree(op->kaio_cred);
+		op->kaio_cred = NULL;
+		(*op->kaio_done)(SOTOKS(so), op);
+
+		mutex_enter(&kas->kas_lock);
+	}
+	kas->kas_sched &= ~(1U << dir);
+	kas->kas_busy--;
+	if (kas->kas_draining)
+		cv_signal(&kas->kas_cv);
+	mutex_exit(&kas->kas_lock);
+}
+
+static void
+ksocket_aio_recv_task(void *arg)
+{
+	ksocket_aio_worker(arg, KSOCKET_AIO_RECVQ);
+}
+
+static void
+ksocket_aio_send_task(void *arg)
+{
+	ksocket_aio_worker(arg, KSOCKET_AIO_SENDQ);
+}
+
+static void
+ksocket_aio_kick(ksocket_aio_state_t *kas, int dir)
+{
+	ASSERT(MUTEX_HELD(&kas->kas_lock));
+
+	kas->kas_gen[dir]++;
+	if (kas->kas_head[dir] == NULL || (kas->kas_sched & (1U << dir)))
+		return;
+	kas->kas_sched |= 1U << dir;
+	kas->kas_busy++;
+	taskq_dispatch_ent(ksocket_aio_taskq,
+	    dir == KSOCKET_AIO_RECVQ ? ksocket_aio_recv_task :
+	    ksocket_aio_send_task, kas, 0, &kas->kas_tqent[dir]);
+}
+
+/*
+ * Called from so_notify_*() with so_lock held whenever the socket may
+ * have become readable or writable.  Must not block.
+ */
+static void
+ksocket_aio_notify(struct sonode *so, int ev)
+{
+	ksocket_aio_state_t *kas = so->so_kaio;
+
+	ASSERT(MUTEX_HELD(&so->so_lock));
+	ASSERT(kas != NULL);
+
+	mutex_enter(&kas->kas_lock);
+	if (ev & SO_KAIO_RECV)
+		ksocket_aio_kick(kas, KSOCKET_AIO_RECVQ);
+	if (ev & SO_KAIO_SEND)
+		ksocket_aio_kick(kas, KSOCKET_AIO_SENDQ);
+	mutex_exit(&kas->kas_lock);
+}
+
+static ksocket_aio_state_t *
+ksocket_aio_attach(struct sonode *so)
+{
+	ksocket_aio_state_t *kas;
+
+	mutex_enter(&ksocket_aio_lock);
+	if (ksocket_aio_taskq == NULL) {
+		ksocket_aio_taskq = taskq_create("ksocket_aio", ncpus,
+		    minclsyspri, 1, INT_MAX, TASKQ_PREPOPULATE);
+	}
+	mutex_exit(&ksocket_aio_lock);
+
+	kas = kmem_zalloc(sizeof (*kas), KM_SLEEP);
+	mutex_init(&kas->kas_lock, NULL, MUTEX_DEFAULT, NULL);
+	cv_init(&kas->kas_cv, NULL, CV_DEFAULT, NULL);
+	kas->kas_so = so;
+
+	mutex_enter(&so->so_lock);
+	if (so->so_kaio != NULL) {
+		/* Lost the race with another submitter. */
+		mutex_exit(&so->so_lock);
+		cv_destroy(&kas->kas_cv);
+		mutex_destroy(&kas->kas_lock);
+		kmem_free(kas, sizeof (*kas));
+		return (so->so_kaio);
+	}
+	so->so_kaio = kas;
+	so->so_kaio_notify = ksocket_aio_notify;
+	mutex_exit(&so->so_lock);
+
+	return (kas);
+}
+
+/*
+ * Called from ksocket_close() once no other thread is working on the
+ * socket: stop the notifications, wait for the workers to finish and
+ * complete whatever is still queued with ECANCELED.
+ */
+static void
+ksocket_aio_drain(struct sonode *so)
+{
+	ksocket_aio_state_t *kas = so->so_kaio;
+	ksocket_aio_t *op, *next;
+	int dir;
+
+	if (kas == NULL)
+		return;
+
+	mutex_enter(&so->so_lock);
+	so->so_kaio_notify = NULL;
+	mutex_exit(&so->so_lock);
+
+	mutex_enter(&kas->kas_lock);
+	kas->kas_draining = B_TRUE;
+	while (kas->kas_busy != 0)
+		cv_wait(&kas->kas_cv, &kas->kas_lock);
+	mutex_exit(&kas->kas_lock);
+
+	for (dir = 0; dir < 2; dir++) {
+		for (op = kas->kas_head[dir]; op != NULL; op = next) {
+			next = op->kaio_next;
+			op->kaio_next = NULL;
+			op->kaio_error = ECANCELED;
+			crfree(op->kaio_cred);
+			op->kaio_cred = NULL;
+			(*op->kaio_done)(SOTOKS(so), op);
+		}
+	}
+
+	so->so_kaio = NULL;
+	cv_destroy(&kas->kas_cv);
+	mutex_destroy(&kas->kas_lock);
+	kmem_free(kas, sizeof (*kas));
+}
+
+static int
+ksocket_aio_submit(ksocket_t ks, ksocket_aio_t *op, int dir, struct cred *cr)
+{
+	struct sonode *so = KSTOSO(ks);
+	ksocket_aio_state_t *kas;
+
+	/* All Solaris components should pass a cred for this operation. */
+	ASSERT(cr != NULL);
+
+	if (op->kaio_done == NULL || op->kaio_buf == NULL)
+		return (EINVAL);
+
+	if (!KSOCKET_VALID(ks))
+		return (ENOTSOCK);
+
+	if ((kas = so->so_kaio) == NULL)
+		kas = ksocket_aio_attach(so);
+
+	op->kaio_flags &= ~(MSG_WAITALL | MSG_DONTWAIT);
+	op->kaio_count = 0;
+	op->kaio_error = 0;
+	op->kaio_next = NULL;
+	crhold(cr);
+	op->kaio_cred = cr;
+
+	mutex_enter(&kas->kas_lock);
+	if (kas->kas_draining) {
+		mutex_exit(&kas->kas_lock);
+		crfree(cr);
+		op->kaio_cred = NULL;
+		return (ENOTSOCK);
+	}
+	if (kas->kas_tail[dir] == NULL)
+		kas->kas_head[dir] = op;
+	else
+		kas->kas_tail[dir]->kaio_next = op;
+	kas->kas_tail[dir] = op;
+	ksocket_aio_kick(kas, dir);
+	mutex_exit(&kas->kas_lock);
+
+	return (0);
+}
+
+int
+ksocket_aio_recv(ksocket_t ks, ksocket_aio_t *op, struct cred *cr)
+{
+	return (ksocket_aio_submit(ks, op, KSOCKET_AIO_RECVQ, cr));
+}
+
+int
+ksocket_aio_send(ksocket_t ks, ksocket_aio_t *op, struct cred *cr)
+{
+	return (ksocket_aio_submit(ks, op, KSOCKET_AIO_SENDQ, cr));
+}
@@ -57,6 +57,16 @@
 		    __KSOCKET_EV_##cbfn, (so)->so_ksock_cb_arg, (arg));	\
 	}
 
+/*
+ * Kick the async I/O machinery, if it is attached to this socket.  Like
+ * KSOCKET_CALLBACK() this is used with so_lock held; the notify function
+ * does not block.
+ */
+#define	KSOCKET_AIO_NOTIFY(so, ev)					\
+	if ((so)->so_kaio_notify != NULL) {				\
+		(*(so)->so_kaio_notify)((so), (ev));			\
+	}
+
 #define	KSOCKET_FMODE(so)	FREAD|FWRITE|	\
 	((KSTOSO(so)->so_state & (SS_NDELAY|SS_NONBLOCK)) ? FNDELAY : 0)
 
@@ -64,6 +74,10 @@
 	((ks) != NULL && (KSTOSO(ks))->so_mode & SM_KERNEL &&		\
 	    !((KSTOSO(ks))->so_state & SS_CLOSING))
 
+/* Async I/O setup and teardown, called from _init/_fini */
+extern void ksocket_aio_init(void);
+extern void ksocket_aio_fini(void);
+
 #define	SETCALLBACK(so, cb, cbfn, cbflg)			\
 	if ((cb)->ksock_cb_flags & (cbflg)) {			\
 		(so)->so_ksock_callbacks.ksock_cb_##cbfn	\
@@ -41,13 +41,22 @@ static struct modlinkage modlinkage = {
 int
 _init(void)
 {
-	return (mod_install(&modlinkage));
+	int error;
+
+	ksocket_aio_init();
+	if ((error = mod_install(&modlinkage)) != 0)
+		ksocket_aio_fini();
+	return (error);
 }
 
 int
 _fini(void)
 {
-	return (mod_remove(&modlinkage));
+	int error;
+
+	if ((error = mod_remove(&modlinkage)) == 0)
+		ksocket_aio_fini();
+	return (error);
 }
 
 int
@@ -399,6 +399,214 @@ out:
 	return (error);
 }
 
+/*
+ * KSTAT_IOC_READ_BULK: snapshot every kstat matching the requested module
+ * and class (empty strings match anything) in a single chain traversal.
+ * Each matching kstat is updated and snapshotted exactly as in
+ * read_kstat_data() above, then copied out as a sanitized header followed
+ * immediately by its data, successive records padded to KSTAT_BULK_ALIGN.
+ * Individual kstats whose update fails or that can't get memory are
+ * skipped rather than failing the whole call; an undersized caller buffer
+ * fails with ENOMEM after the full traversal, with kb_bufsize set to the
+ * size required so the caller can resize and retry.  This interface is
+ * 64-bit only; 32-bit consumers read kstats one at a time.
+ */
+static int
+read_kstat_bulk(int *rvalp, void *user_arg, int flag)
+{
+	kstat_bulk_t req;
+	kstat_t *ksp, hdr;
+	char *kbuf = NULL;
+	size_t kbufmax = 0, kbufsize;
+	uint64_t off = 0, needed = 0, count = 0, total;
+	kid_t kid = -1;
+	zoneid_t zoneid = getzoneid();
+	int error = 0;
+
+#ifdef _MULTI_DATAMODEL
+	if (ddi_model_convert_from(flag & FMODELS) == DDI_MODEL_ILP32)
+		return (ENOTSUP);
+#endif
+
+	if (copyin(user_arg, &req, sizeof (req)) != 0)
+		return (EFAULT);
+
+	req.kb_module[KSTAT_STRLEN - 1] = '\0';
+	req.kb_class[KSTAT_STRLEN - 1] = '\0';
+
+	while ((ksp = kstat_hold_next(kid, zoneid)) != NULL) {
+		kid = ksp->ks_kid;
+
+		if ((req.kb_module[0] != '\0' &&
+		    strcmp(req.kb_module, ksp->ks_module) != 0) ||
+		    (req.kb_class[0] != '\0' &&
+		    strcmp(req.kb_class, ksp->ks_class) != 0) ||
+		    (ksp->ks_flags & KSTAT_FLAG_INVALID)) {
+			kstat_rele(ksp);
+			continue;
+		}
+
+		/*
+		 * As in read_kstat_data(), a fixed-size kstat must have its
+		 * buffer allocated before we take the data lock, so that
+		 * the allocator's own kstats can be read.
+		 */
+		if (!(ksp->ks_flags &
+		    (KSTAT_FLAG_VAR_SIZE | KSTAT_FLAG_LONGSTRINGS)) &&
+		    ksp->ks_data_size > kbufmax) {
+			if (kbuf != NULL)
+				kmem_free(kbuf, kbufmax + 1);
+			kbufmax = ksp->ks_data_size;
+			kbuf = kmem_alloc(kbufmax + 1, KM_SLEEP);
+		}
+
+		KSTAT_ENTER(ksp);
+
+		if (KSTAT_UPDATE(ksp, KSTAT_READ) != 0) {
+			KSTAT_EXIT(ksp);
+			kstat_rele(ksp);
+			continue;
+		}
+
+		kbufsize = ksp->ks_data_size;
+
+		if (kbufsize > kbufmax) {
+			char *nbuf = kmem_alloc(kbufsize + 1, KM_NOSLEEP);
+
+			if (nbuf == NULL) {
+				KSTAT_EXIT(ksp);
+				kstat_rele(ksp);
+				continue;
+			}
+			if (kbuf != NULL)
+				kmem_free(kbuf, kbufmax + 1);
+			kbuf = nbuf;
+			kbufmax = kbufsize;
+		}
+
+		bzero(kbuf, kbufsize + 1);
+
+		if (KSTAT_SNAPSHOT(ksp, kbuf, KSTAT_READ) != 0) {
+			KSTAT_EXIT(ksp);
+			kstat_rele(ksp);
+			continue;
+		}
+
+		/*
+		 * Build a sanitized header: only the fields that mean
+		 * something in userland survive, and ks_data becomes the
+		 * user address of the data following the header.
+		 */
+		bzero(&hdr, sizeof (hdr));
+		hdr.ks_crtime = ksp->ks_crtime;
+		hdr.ks_kid = ksp->ks_kid;
+		bcopy(ksp->ks_module, hdr.ks_module, KSTAT_STRLEN);
+		hdr.ks_instance = ksp->ks_instance;
+		bcopy(ksp->ks_name, hdr.ks_name, KSTAT_STRLEN);
+		hdr.ks_type = ksp->ks_type;
+		bcopy(ksp->ks_class, hdr.ks_class, KSTAT_STRLEN);
+		hdr.ks_flags = ksp->ks_flags;
+		hdr.ks_ndata = ksp->ks_ndata;
+		hdr.ks_data_size = kbufsize;
+		hdr.ks_snaptime = ksp->ks_snaptime;
+
+		KSTAT_EXIT(ksp);
+		kstat_rele(ksp);
+
+		total = P2ROUNDUP((uint64_t)sizeof (kstat_t) + kbufsize,
+		    KSTAT_BULK_ALIGN);
+		needed += total;
+
+		if (error != 0 || needed > req.kb_bufsize) {
+			/*
+			 * Out of buffer; keep traversing so that we can
+			 * report the total size required.
+			 */
+			error = ENOMEM;
+			continue;
+		}
+
+		hdr.ks_data = (void *)(uintptr_t)(req.kb_buf + off +
+		    sizeof (kstat_t));
+
+		if (hdr.ks_type == KSTAT_TYPE_NAMED) {
+			kstat_named_t *kn = (kstat_named_t *)(void *)kbuf;
+			char *strbuf = (char *)(kn + hdr.ks_ndata);
+			uint_t i;
+
+			for (i = 0; i < hdr.ks_ndata; kn++, i++) {
+				switch (kn->data_type) {
+#ifdef _LP64
+				case KSTAT_DATA_LONG:
+					kn->data_type = KSTAT_DATA_INT64;
+					break;
+				case KSTAT_DATA_ULONG:
+					kn->data_type = KSTAT_DATA_UINT64;
+					break;
+#endif	/* _LP64 */
+				case KSTAT_DATA_STRING:
+					if (KSTAT_NAMED_STR_PTR(kn) == NULL)
+						break;
+					/*
+					 * If the string lies outside of
+					 * kbuf, copy it there and update
+					 * the pointer.
+					 */
+					if (KSTAT_NAMED_STR_PTR(kn) < kbuf ||
+					    KSTAT_NAMED_STR_PTR(kn) +
+					    KSTAT_NAMED_STR_BUFLEN(kn) >
+					    kbuf + kbufsize + 1) {
+						bcopy(KSTAT_NAMED_STR_PTR(kn),
+						    strbuf,
+						    KSTAT_NAMED_STR_BUFLEN(
+						    kn));
+						KSTAT_NAMED_STR_PTR(kn) =
+						    strbuf;
+						strbuf +=
+						    KSTAT_NAMED_STR_BUFLEN(kn);
+						ASSERT(strbuf <=
+						    kbuf + kbufsize + 1);
+					}
+					/*
+					 * Rebase the pointer to the user
+					 * address of this record's data.
+					 */
+					KSTAT_NAMED_STR_PTR(kn) =
+					    (char *)hdr.ks_data +
+					    (KSTAT_NAMED_STR_PTR(kn) - kbuf);
+					break;
+				default:
+					break;
+				}
+			}
+		}
+
+		if (copyout(&hdr, (void *)(uintptr_t)(req.kb_buf + off),
+		    sizeof (kstat_t)) != 0 ||
+		    (kbufsize != 0 && copyout(kbuf, hdr.ks_data,
+		    kbufsize) != 0)) {
+			error = EFAULT;
+			break;
+		}
+
+		off += total;
+		count++;
+	}
+
+	if (kbuf != NULL)
+		kmem_free(kbuf, kbufmax + 1);
+
+	req.kb_bufsize = needed;
+	req.kb_count = count;
+
+	*rvalp = kstat_chain_id;
+
+	if (copyout(&req, user_arg, sizeof (req)) != 0 && error == 0)
+		error = EFAULT;
+
+	return (error);
+}
+
 static int
 write_kstat_data(int *rvalp, void *user_ksp, int flag, cred_t *cred)
 {
@@ -675,6 +883,10 @@ kstat_ioctl(dev_t dev, int cmd, intptr_t data, int flag, cred_t *cr, int *rvalp)
 		rc = read_kstat_data(rvalp, (void *)data, flag);
 		break;
 
+	case KSTAT_IOC_READ_BULK:
+		rc = read_kstat_bulk(rvalp, (void *)data, flag);
+		break;
+
 	case KSTAT_IOC_WRITE:
 		rc = write_kstat_data(rvalp, (void *)data, flag, cr);
 		break;
@@ -467,6 +467,8 @@ mac_init(void)
 	mac_pool_event_reg.pec_func =  mac_pool_event_cb;
 	mac_pool_event_reg.pec_arg = NULL;
 	pool_event_cb_register(&mac_pool_event_reg);
+
+	mac_fanout_autoscale_start();
 }
 
 int
@@ -476,6 +478,7 @@ mac_fini(void)
 	if (i_mac_impl_count > 0 || minor_count > 0)
 		return (EBUSY);
 
+	mac_fanout_autoscale_stop();
 	pool_event_cb_unregister(&mac_pool_event_reg);
 
 	id_space_destroy(minor_ids);
@@ -150,11 +150,49 @@ static krwlock_t mac_srs_g_lock;
 boolean_t mac_srs_thread_bind = B_TRUE;
 
 /*
- * Whether Rx/Tx interrupts should be re-targeted. Disabled by default.
+ * Whether Rx/Tx interrupts should be re-targeted to the CPUs the
+ * corresponding SRS threads are bound to, for drivers that export a
+ * DDI interrupt handle for their rings. Enabled by default so that a
+ * ring's interrupt, poll thread and soft rings share a CPU without
+ * the administrator re-binding interrupts by hand after every boot.
  * dladm command would override this.
  */
-boolean_t mac_tx_intr_retarget = B_FALSE;
-boolean_t mac_rx_intr_retarget = B_FALSE;
+boolean_t mac_tx_intr_retarget = B_TRUE;
+boolean_t mac_rx_intr_retarget = B_TRUE;
+
+/*
+ * When set, the CPUs picked for an Rx SRS beyond the first (the
+ * fanout soft rings, the poll thread and the SRS worker, and through
+ * interrupt re-targeting the device interrupt as well) are taken from
+ * the lgroup of the first CPU selected, so the whole Rx chain of a
+ * ring stays within one locality group instead of straddling them.
+ * If the lgroup runs out of online CPUs the selection falls back to
+ * the plain round-robin.
+ */
+boolean_t mac_srs_bind_lgrp_affine = B_TRUE;
+
+/*
+ * Rx fanout autoscaling. The number of soft rings fanned out under
+ * an Rx SRS is normally sized once, from the link speed, when the
+ * datapath is set up. A flow that becomes hot later stays pinned to
+ * that count while its SRS backlog grows and packets are dropped.
+ * When mac_rx_fanout_autoscale is set, a timer fires every
+ * mac_rx_fanout_autoscale_interval seconds and walks all MAC clients;
+ * a client that dropped at least mac_rx_fanout_autoscale_drops
+ * packets since the last visit earns an extra soft ring (up to the
+ * number of CPUs available for fanout), and a client that has gone
+ * mac_rx_fanout_autoscale_idle consecutive intervals without a drop
+ * gives one back. The reconfiguration reuses the SRS_FANOUT_REINIT
+ * path of mac_fanout_setup() and does not tear the datapath down.
+ * Clients with an administratively configured CPU set are left alone.
+ */
+boolean_t mac_rx_fanout_autoscale = B_TRUE;
+clock_t mac_rx_fanout_autoscale_interval = 10;
+uint64_t mac_rx_fanout_autoscale_drops = 1000;
+uint_t mac_rx_fanout_autoscale_idle = 6;
+
+static timeout_id_t mac_fanout_autoscale_tid;
+static boolean_t mac_fanout_autoscale_armed;
 
 /*
  * If cpu bindings are specified by user, then Tx SRS and its soft
@@ -554,6 +592,56 @@ mac_next_bind_cpu(cpupart_t *cpupart)
 	return (-1);	/* No matching CPU found online */
 }
 
+/*
+ * Return the lgroup the given CPU currently belongs to, or LGRP_NONE
+ * if the CPU is not found.
+ */
+static lgrp_id_t
+mac_cpu_lgrpid(processorid_t cpuid)
+{
+	cpu_t	*cp;
+
+	ASSERT(MUTEX_HELD(&cpu_lock));
+
+	if ((cp = cpu_get(cpuid)) == NULL)
+		return (LGRP_NONE);
+
+	return (cp->cpu_lpl->lpl_lgrpid);
+}
+
+/*
+ * Like mac_next_bind_cpu(), but prefer CPUs belonging to the given
+ * lgroup. Falls back to the plain round-robin if the lgroup has no
+ * other online CPU in the partition, or if lgroup-affine binding is
+ * disabled.
+ */
+static processorid_t
+mac_next_bind_cpu_lgrp(cpupart_t *cpupart, lgrp_id_t lgrpid)
+{
+	static cpu_t		*cp = NULL;
+	cpu_t			*cp_start;
+
+	ASSERT(MUTEX_HELD(&cpu_lock));
+
+	if (!mac_srs_bind_lgrp_affine || lgrpid == LGRP_NONE)
+		return (mac_next_bind_cpu(cpupart));
+
+	if (cp == NULL)
+		cp = cpu_list;
+
+	cp = cp->cpu_next_onln;
+	cp_start = cp;
+
+	do {
+		if (((cpupart == NULL) || (cp->cpu_part == cpupart)) &&
+		    (cp->cpu_lpl->lpl_lgrpid == lgrpid))
+			return (cp->cpu_id);
+
+	} while ((cp = cp->cpu_next_onln) != cp_start);
+
+	return (mac_next_bind_cpu(cpupart));
+}
+
 /* ARGSUSED */
 static int
 mac_srs_cpu_setup(cpu_setup_t what, int id, void *arg)
@@ -1084,6 +1172,7 @@ mac_flow_cpu_init(flow_entry_t *flent, cpupart_t *cpupart)
 {
 	mac_soft_ring_set_t *rx_srs;
 	processorid_t cpuid;
+	lgrp_id_t lgrpid = LGRP_NONE;
 	int i, j, k, srs_cnt, maxcpus, soft_ring_cnt = 0;
 	mac_cpus_t *srs_cpu;
 	mac_resource_props_t *emrp = &flent->fe_effective_props;
@@ -1120,6 +1209,16 @@ mac_flow_cpu_init(flow_entry_t *flent, cpupart_t *cpupart)
 		soft_ring_cnt = 1;
 	}
 
+	/*
+	 * Apply any fanout boost earned from mac_fanout_autoscale()
+	 * on top of the speed-based count, without exceeding the
+	 * CPUs available for fanout.
+	 */
+	if (flent->fe_fanout_boost != 0) {
+		soft_ring_cnt = MIN(soft_ring_cnt + flent->fe_fanout_boost,
+		    maxcpus);
+	}
+
 	emrp->mrp_ncpus = 0;
 	for (srs_cnt = 0; srs_cnt < flent->fe_rx_srs_cnt &&
 	    emrp->mrp_ncpus < MRP_NCPUS; srs_cnt++) {
@@ -1130,12 +1229,23 @@ mac_flow_cpu_init(flow_entry_t *flent, cpupart_t *cpupart)
 		srs_cpu->mc_ncpus = soft_ring_cnt;
 		srs_cpu->mc_rx_fanout_cnt = soft_ring_cnt;
 		mutex_enter(&cpu_lock);
+		/*
+		 * The first CPU is picked round-robin across the
+		 * partition; the rest of this SRS's Rx chain then
+		 * stays in that CPU's lgroup.
+		 */
 		for (j = 0; j < soft_ring_cnt; j++) {
-			cpuid = mac_next_bind_cpu(cpupart);
+			if (j == 0) {
+				cpuid = mac_next_bind_cpu(cpupart);
+				lgrpid = mac_cpu_lgrpid(cpuid);
+			} else {
+				cpuid = mac_next_bind_cpu_lgrp(cpupart,
+				    lgrpid);
+			}
 			srs_cpu->mc_cpus[j] = cpuid;
 			srs_cpu->mc_rx_fanout_cpus[j] = cpuid;
 		}
-		cpuid = mac_next_bind_cpu(cpupart);
+		cpuid = mac_next_bind_cpu_lgrp(cpupart, lgrpid);
 		srs_cpu->mc_rx_pollid = cpuid;
 		srs_cpu->mc_rx_intr_cpu = (mac_rx_intr_retarget ?
 		    srs_cpu->mc_rx_pollid : -1);
@@ -1143,7 +1253,7 @@ mac_flow_cpu_init(flow_entry_t *flent, cpupart_t *cpupart)
 		srs_cpu->mc_ncpus++;
 		srs_cpu->mc_cpus[j++] = cpuid;
 		if (!mac_latency_optimize) {
-			cpuid = mac_next_bind_cpu(cpupart);
+			cpuid = mac_next_bind_cpu_lgrp(cpupart, lgrpid);
 			srs_cpu->mc_ncpus++;
 			srs_cpu->mc_cpus[j++] = cpuid;
 		}
@@ -4108,6 +4218,178 @@ mac_fanout_recompute(mac_impl_t *mip)
 	i_mac_perim_exit(mip);
 }
 
+/*
+ * Total packets dropped so far on the Rx path of a flow: SRS queue
+ * drops plus drops at the individual soft rings.
+ */
+static uint64_t
+mac_flow_rx_drops(flow_entry_t *flent)
+{
+	mac_soft_ring_set_t	*rx_srs;
+	mac_soft_ring_t		*ringp;
+	uint64_t		drops = 0;
+	int			i;
+
+	for (i = 0; i < flent->fe_rx_srs_cnt; i++) {
+		rx_srs = flent->fe_rx_srs[i];
+		drops += rx_srs->srs_rx.sr_stat.mrs_sdrops;
+		for (ringp = rx_srs->srs_soft_ring_head; ringp != NULL;
+		    ringp = ringp->s_ring_next)
+			drops += ringp->s_ring_drops;
+	}
+	return (drops);
+}
+
+/*
+ * Grow or shrink the Rx fanout of a client based on observed load.
+ * A client that dropped packets since the last visit earns an extra
+ * soft ring per interval, up to the number of CPUs available for
+ * fanout; the boost decays again once the drops stop. The heavy
+ * lifting (CPU rebinding, soft ring creation/removal, interrupt
+ * re-targeting) is done by mac_fanout_setup() via the
+ * SRS_FANOUT_REINIT path, which quiesces and restarts the SRS
+ * without tearing the datapath down.
+ */
+static void
+mac_fanout_autoscale_client(mac_client_impl_t *mcip, cpupart_t *cpupart)
+{
+	flow_entry_t *flent = mcip->mci_flent;
+	mac_resource_props_t *mcip_mrp = MCIP_RESOURCE_PROPS(mcip);
+	mac_soft_ring_set_t *rx_srs;
+	uint64_t drops, delta;
+	int maxcpus;
+	boolean_t refanout = B_FALSE;
+
+	ASSERT(MAC_PERIM_HELD((mac_handle_t)mcip->mci_mip));
+
+	/*
+	 * Never override an administratively configured CPU set.
+	 */
+	if (mcip_mrp->mrp_mask & MRP_CPUS_USERSPEC)
+		return;
+
+	if (flent->fe_rx_srs_cnt == 0)
+		return;
+
+	/*
+	 * Soft ring removal discards the per-ring drop counts, so the
+	 * total can go backwards right after a shrink; treat that as
+	 * no new drops.
+	 */
+	drops = mac_flow_rx_drops(flent);
+	delta = (drops >= flent->fe_fanout_drop_mark) ?
+	    drops - flent->fe_fanout_drop_mark : 0;
+	flent->fe_fanout_drop_mark = drops;
+
+	maxcpus = (cpupart != NULL) ? cpupart->cp_ncpus : ncpus;
+	maxcpus = MIN(maxcpus, MRP_NCPUS - 2);
+
+	rx_srs = flent->fe_rx_srs[0];
+	if (delta >= mac_rx_fanout_autoscale_drops) {
+		flent->fe_fanout_idle = 0;
+		if (rx_srs->srs_cpu.mc_rx_fanout_cnt < maxcpus) {
+			flent->fe_fanout_boost++;
+			refanout = B_TRUE;
+		}
+	} else if (delta == 0 && flent->fe_fanout_boost != 0 &&
+	    ++flent->fe_fanout_idle >= mac_rx_fanout_autoscale_idle) {
+		flent->fe_fanout_idle = 0;
+		flent->fe_fanout_boost--;
+		refanout = B_TRUE;
+	}
+
+	if (refanout) {
+		mac_fanout_setup(mcip, flent, mcip_mrp, mac_rx_deliver,
+		    mcip, NULL, cpupart);
+	}
+}
+
+/*
+ * Walk through the list of MAC clients for the MAC and let each
+ * active client grow or shrink its Rx fanout based on the load it
+ * has seen since the last visit. Modelled on mac_fanout_recompute().
+ */
+static void
+mac_fanout_autoscale(mac_impl_t *mip)
+{
+	mac_client_impl_t	*mcip;
+	cpupart_t		*cpupart;
+	boolean_t		use_default;
+	mac_resource_props_t	*mrp;
+
+	i_mac_perim_enter(mip);
+	if ((mip->mi_state_flags & MIS_IS_VNIC) != 0 ||
+	    mip->mi_linkstate != LINK_STATE_UP) {
+		i_mac_perim_exit(mip);
+		return;
+	}
+
+	for (mcip = mip->mi_clients_list; mcip != NULL;
+	    mcip = mcip->mci_client_next) {
+		/* Aggr port clients don't have SRSes. */
+		if ((mcip->mci_state_flags & MCIS_IS_AGGR_PORT) != 0)
+			continue;
+
+		if ((mcip->mci_state_flags & MCIS_SHARE_BOUND) != 0 ||
+		    !MCIP_DATAPATH_SETUP(mcip))
+			continue;
+		mrp = MCIP_RESOURCE_PROPS(mcip);
+		use_default = B_FALSE;
+		pool_lock();
+		cpupart = mac_pset_find(mrp, &use_default);
+		mac_fanout_autoscale_client(mcip, cpupart);
+		pool_unlock();
+	}
+
+	i_mac_perim_exit(mip);
+}
+
+/* modhash walker function to autoscale the Rx fanout of a MAC */
+/* ARGSUSED */
+static uint_t
+i_mac_fanout_autoscale_walker(mod_hash_key_t key, mod_hash_val_t *val,
+    void *arg)
+{
+	mac_fanout_autoscale((mac_impl_t *)val);
+	return (MH_WALK_CONTINUE);
+}
+
+/*
+ * The timer thread that runs every mac_rx_fanout_autoscale_interval
+ * seconds and revisits the Rx fanout of every MAC client.
+ */
+/* ARGSUSED */
+static void
+mac_fanout_autoscale_timer(void *arg)
+{
+	if (!mac_fanout_autoscale_armed)
+		return;
+
+	if (mac_rx_fanout_autoscale) {
+		mod_hash_walk(i_mac_impl_hash, i_mac_fanout_autoscale_walker,
+		    NULL);
+	}
+
+	mac_fanout_autoscale_tid = timeout(mac_fanout_autoscale_timer, NULL,
+	    SEC_TO_TICK(mac_rx_fanout_autoscale_interval));
+}
+
+void
+mac_fanout_autoscale_start(void)
+{
+	mac_fanout_autoscale_armed = B_TRUE;
+	mac_fanout_autoscale_tid = timeout(mac_fanout_autoscale_timer, NULL,
+	    SEC_TO_TICK(mac_rx_fanout_autoscale_interval));
+}
+
+void
+mac_fanout_autoscale_stop(void)
+{
+	mac_fanout_autoscale_armed = B_FALSE;
+	(void) untimeout(mac_fanout_autoscale_tid);
+	mac_fanout_autoscale_tid = NULL;
+}
+
 /*
  * Given a MAC, change the polling state for all its MAC clients.  'enable' is
  * B_TRUE to enable polling or B_FALSE to disable.  Polling is enabled by
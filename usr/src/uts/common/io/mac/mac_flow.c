@@ -358,6 +358,12 @@ mac_flow_add(flow_tab_t *ft, flow_entry_t *flent)
 	FLOW_MARK(flent, FE_FLOW_TAB);
 	ft->ft_flow_count++;
 	rw_exit(&ft->ft_lock);
+
+	/*
+	 * Push the flow into the NIC's steering tables.  This must be
+	 * done without ft_lock held as the driver may block.
+	 */
+	mac_flow_hw_steer(ft, flent);
 	return (0);
 }
 
@@ -476,6 +482,8 @@ mac_flow_remove(flow_tab_t *ft, flow_entry_t *flent, boolean_t temp)
 	if (!(flent->fe_flags & FE_FLOW_TAB))
 		return;
 
+	mac_flow_hw_unsteer(ft, flent);
+
 	rw_enter(&ft->ft_lock, RW_WRITER);
 	/*
 	 * If this is a permanent removal from the flow table, mark it
@@ -1038,6 +1046,68 @@ mac_flow_tab_destroy(flow_tab_t *ft)
 	kmem_cache_free(flow_tab_cache, ft);
 }
 
+/*
+ * Offer a newly added flow to the NIC's hardware steering tables, if the
+ * driver implements MAC_CAPAB_FLOW_STEER and can match all the fields in
+ * the flow's mask.  Failure is not an error: the flow simply remains
+ * software classified.  Hardware steering only pre-sorts packets onto
+ * rings; mac_flow_lookup() still confirms every match, so the software
+ * classifier is the fallback for anything the hardware cannot hold.
+ */
+static void
+mac_flow_hw_steer(flow_tab_t *ft, flow_entry_t *flent)
+{
+	mac_impl_t		*mip = ft->ft_mip;
+	mac_capab_flow_steer_t	cap;
+	uint64_t		cookie;
+
+	if (mip == NULL)
+		return;
+
+	ASSERT(MAC_PERIM_HELD((mac_handle_t)mip));
+
+	if (!i_mac_capab_get((mac_handle_t)mip, MAC_CAPAB_FLOW_STEER, &cap))
+		return;
+
+	if (cap.mfs_insert == NULL ||
+	    (flent->fe_flow_desc.fd_mask & ~cap.mfs_masks) != 0)
+		return;
+
+	if (cap.mfs_insert(mip->mi_driver, &flent->fe_flow_desc,
+	    &cookie) != 0) {
+		DTRACE_PROBE2(hw_steer_failed, flow_tab_t *, ft,
+		    flow_entry_t *, flent);
+		return;
+	}
+	flent->fe_hwflow = B_TRUE;
+	flent->fe_hwflow_cookie = cookie;
+}
+
+/*
+ * Remove a flow from the NIC's hardware steering tables.  This is also
+ * done for temporary removals: the flow descriptor is about to change,
+ * so the programmed filter would go stale.  The flow is offered to the
+ * hardware again when it is re-added.
+ */
+static void
+mac_flow_hw_unsteer(flow_tab_t *ft, flow_entry_t *flent)
+{
+	mac_impl_t		*mip = ft->ft_mip;
+	mac_capab_flow_steer_t	cap;
+
+	if (!flent->fe_hwflow)
+		return;
+
+	ASSERT(mip != NULL);
+	ASSERT(MAC_PERIM_HELD((mac_handle_t)mip));
+
+	if (i_mac_capab_get((mac_handle_t)mip, MAC_CAPAB_FLOW_STEER, &cap) &&
+	    cap.mfs_remove != NULL)
+		cap.mfs_remove(mip->mi_driver, flent->fe_hwflow_cookie);
+	flent->fe_hwflow = B_FALSE;
+	flent->fe_hwflow_cookie = 0;
+}
+
 /*
  * Add a new flow entry to the global flow hash table
  */
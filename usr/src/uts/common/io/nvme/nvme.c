@@ -403,6 +403,16 @@ uint32_t nvme_vendor_specific_admin_cmd_size = 1 << 24;
  */
 uint_t nvme_vendor_specific_admin_cmd_max_timeout = 60;
 
+/*
+ * tunable for how long a thread submitting a read spins polling the
+ * completion queue before falling back to the interrupt, in
+ * microseconds. On devices that complete reads in a few microseconds
+ * the interrupt and taskq wakeup make up a large fraction of I/O
+ * latency, which polling avoids. The default of 0 disables polling;
+ * the "io-poll-usec" property overrides it per controller.
+ */
+uint_t nvme_io_poll_usec = 0;
+
 static int nvme_attach(dev_info_t *, ddi_attach_cmd_t);
 static int nvme_detach(dev_info_t *, ddi_detach_cmd_t);
 static int nvme_quiesce(dev_info_t *);
@@ -424,6 +434,8 @@ static int nvme_submit_io_cmd(nvme_qpair_t *, nvme_cmd_t *);
 static void nvme_submit_cmd_common(nvme_qpair_t *, nvme_cmd_t *);
 static nvme_cmd_t *nvme_unqueue_cmd(nvme_t *, nvme_qpair_t *, int);
 static nvme_cmd_t *nvme_retrieve_cmd(nvme_t *, nvme_qpair_t *);
+static void nvme_update_latency(nvme_t *, nvme_cmd_t *, boolean_t);
+static void nvme_lat_kstat_create(nvme_t *);
 static void nvme_wait_cmd(nvme_cmd_t *, uint_t);
 static void nvme_wakeup_cmd(void *);
 static void nvme_async_event_task(void *);
@@ -1203,6 +1215,7 @@ nvme_submit_cmd_common(nvme_qpair_t *qp, nvme_cmd_t *cmd)
 
 	mutex_enter(&qp->nq_mutex);
 	cmd->nc_completed = B_FALSE;
+	cmd->nc_submit_ts = gethrtime();
 
 	/*
 	 * Now that we hold the queue pair lock, we must check whether or not
@@ -1305,6 +1318,79 @@ nvme_get_completed(nvme_t *nvme, nvme_cq_t *cq)
 	return (cmd);
 }
 
+static int
+nvme_lat_kstat_update(kstat_t *ksp, int rw)
+{
+	nvme_t *nvme = ksp->ks_private;
+	kstat_named_t *knp = ksp->ks_data;
+	int i;
+
+	if (rw == KSTAT_WRITE)
+		return (EACCES);
+
+	for (i = 0; i < NVME_LAT_BUCKETS; i++) {
+		knp[i].value.ui64 = nvme->n_lat_intr[i];
+		knp[NVME_LAT_BUCKETS + i].value.ui64 = nvme->n_lat_poll[i];
+	}
+
+	return (0);
+}
+
+/*
+ * Create the "io_latency" kstat: two power-of-two latency histograms
+ * over all I/O completions, one for the interrupt path and one for
+ * polled completions, named by each bucket's lower bound in
+ * nanoseconds.
+ */
+static void
+nvme_lat_kstat_create(nvme_t *nvme)
+{
+	kstat_t *ksp;
+	kstat_named_t *knp;
+	int i;
+
+	ksp = kstat_create("nvme", ddi_get_instance(nvme->n_dip),
+	    "io_latency", "misc", KSTAT_TYPE_NAMED, 2 * NVME_LAT_BUCKETS, 0);
+	if (ksp == NULL)
+		return;
+
+	knp = ksp->ks_data;
+	for (i = 0; i < NVME_LAT_BUCKETS; i++) {
+		(void) snprintf(knp[i].name, sizeof (knp[i].name),
+		    "intr_ns_%llu", (u_longlong_t)(1ULL << i));
+		knp[i].data_type = KSTAT_DATA_UINT64;
+		(void) snprintf(knp[NVME_LAT_BUCKETS + i].name,
+		    sizeof (knp[i].name), "poll_ns_%llu",
+		    (u_longlong_t)(1ULL << i));
+		knp[NVME_LAT_BUCKETS + i].data_type = KSTAT_DATA_UINT64;
+	}
+
+	ksp->ks_update = nvme_lat_kstat_update;
+	ksp->ks_private = nvme;
+	nvme->n_lat_kstat = ksp;
+	kstat_install(ksp);
+}
+
+/*
+ * Account a completed command to the controller's latency histograms.
+ * Polled and interrupt-driven completions are kept apart so the two
+ * modes can be compared directly from the "io_latency" kstat.
+ */
+static void
+nvme_update_latency(nvme_t *nvme, nvme_cmd_t *cmd, boolean_t polled)
+{
+	uint64_t *hist = polled ? nvme->n_lat_poll : nvme->n_lat_intr;
+	hrtime_t delta = gethrtime() - cmd->nc_submit_ts;
+	int bucket;
+
+	if (delta < 1)
+		delta = 1;
+	bucket = highbit64((uint64_t)delta) - 1;
+	if (bucket >= NVME_LAT_BUCKETS)
+		bucket = NVME_LAT_BUCKETS - 1;
+	atomic_inc_64(&hist[bucket]);
+}
+
 /*
  * Process all completed commands on the io completion queue.
  */
@@ -1323,6 +1409,7 @@ nvme_process_iocq(nvme_t *nvme, nvme_cq_t *cq)
 	mutex_enter(&cq->ncq_mutex);
 
 	while ((cmd = nvme_get_completed(nvme, cq)) != NULL) {
+		nvme_update_latency(nvme, cmd, B_FALSE);
 		taskq_dispatch_ent(cq->ncq_cmd_taskq, cmd->nc_callback, cmd,
 		    TQ_NOSLEEP, &cmd->nc_tqent);
 
@@ -1363,6 +1450,9 @@ nvme_retrieve_cmd(nvme_t *nvme, nvme_qpair_t *qp)
 
 	mutex_exit(&cq->ncq_mutex);
 
+	if (cmd != NULL)
+		nvme_update_latency(nvme, cmd, B_TRUE);
+
 	return (cmd);
 }
 
@@ -3898,6 +3988,10 @@ nvme_attach(dev_info_t *dip, ddi_attach_cmd_t cmd)
 	    DDI_PROP_DONTPASS, "max-submission-queues", -1);
 	nvme->n_completion_queues = ddi_prop_get_int(DDI_DEV_T_ANY, dip,
 	    DDI_PROP_DONTPASS, "max-completion-queues", -1);
+	nvme->n_io_poll_usec = ddi_prop_get_int(DDI_DEV_T_ANY, dip,
+	    DDI_PROP_DONTPASS, "io-poll-usec", nvme_io_poll_usec);
+
+	nvme_lat_kstat_create(nvme);
 
 	if (!ISP2(nvme->n_min_block_size) ||
 	    (nvme->n_min_block_size < NVME_DEFAULT_MIN_BLOCK_SIZE)) {
@@ -4113,6 +4207,11 @@ nvme_detach(dev_info_t *dip, ddi_detach_cmd_t cmd)
 
 	ddi_remove_minor_node(dip, "devctl");
 
+	if (nvme->n_lat_kstat != NULL) {
+		kstat_delete(nvme->n_lat_kstat);
+		nvme->n_lat_kstat = NULL;
+	}
+
 	if (nvme->n_ns) {
 		for (i = 1; i <= nvme->n_namespace_count; i++) {
 			nvme_namespace_t *ns = NVME_NSID2NS(nvme, i);
@@ -4571,7 +4670,7 @@ nvme_bd_cmd(nvme_namespace_t *ns, bd_xfer_t *xfer, uint8_t opc)
 	nvme_t *nvme = ns->ns_nvme;
 	nvme_cmd_t *cmd;
 	nvme_qpair_t *ioq;
-	boolean_t poll;
+	boolean_t poll, spin;
 	int ret;
 
 	if (nvme->n_dead) {
@@ -4593,10 +4692,48 @@ nvme_bd_cmd(nvme_namespace_t *ns, bd_xfer_t *xfer, uint8_t opc)
 	 */
 	poll = (xfer->x_flags & BD_XFER_POLL) != 0;
 
+	/*
+	 * If polled completions are configured, spin for this read's
+	 * completion rather than waiting for the interrupt. Only one
+	 * thread polls a queue pair at a time; this also stops command
+	 * callbacks that submit fresh I/O from polling recursively.
+	 */
+	spin = !poll && nvme->n_io_poll_usec != 0 &&
+	    opc == NVME_OPC_NVM_READ &&
+	    atomic_cas_uint(&ioq->nq_poll_busy, 0, 1) == 0;
+
 	ret = nvme_submit_io_cmd(ioq, cmd);
 
-	if (ret != 0)
+	if (ret != 0) {
+		if (spin)
+			ioq->nq_poll_busy = 0;
 		return (ret);
+	}
+
+	if (spin) {
+		hrtime_t deadline = gethrtime() +
+		    (hrtime_t)nvme->n_io_poll_usec * (NANOSEC / MICROSEC);
+
+		/*
+		 * Completions are reaped in queue order, so the first
+		 * one found is not necessarily ours; anything retrieved
+		 * here skips both the interrupt and the taskq wakeup.
+		 * On timeout the interrupt path finishes the command as
+		 * usual.
+		 */
+		while (gethrtime() < deadline) {
+			cmd = nvme_retrieve_cmd(nvme, ioq);
+			if (cmd != NULL)
+				break;
+			drv_usecwait(1);
+		}
+		while (cmd != NULL) {
+			cmd->nc_callback(cmd);
+			cmd = nvme_retrieve_cmd(nvme, ioq);
+		}
+		ioq->nq_poll_busy = 0;
+		return (0);
+	}
 
 	if (!poll)
 		return (0);
@@ -26,6 +26,7 @@
 #include <sys/blkdev.h>
 #include <sys/taskq_impl.h>
 #include <sys/list.h>
+#include <sys/kstat.h>
 
 /*
  * NVMe driver state
@@ -52,6 +53,12 @@ extern "C" {
 #define	NVME_MIN_ASYNC_EVENT_LIMIT	1
 #define	NVME_DEFAULT_MIN_BLOCK_SIZE	512
 
+/*
+ * Number of power-of-two buckets in the I/O completion latency
+ * histograms; bucket n counts completions taking [2^n, 2^(n+1)) ns.
+ */
+#define	NVME_LAT_BUCKETS		32
+
 
 typedef struct nvme nvme_t;
 typedef struct nvme_namespace nvme_namespace_t;
@@ -88,6 +95,7 @@ struct nvme_cmd {
 	boolean_t nc_completed;
 	boolean_t nc_dontpanic;
 	uint16_t nc_sqid;
+	hrtime_t nc_submit_ts;
 
 	nvme_dma_t *nc_dma;
 	nvme_dma_t *nc_prp; /* DMA for PRP lists */
@@ -135,6 +143,13 @@ struct nvme_qpair {
 
 	kmutex_t nq_mutex;	/* protects shared state */
 	ksema_t nq_sema; /* semaphore to ensure q always has >= 1 empty slot */
+
+	/*
+	 * Set while a thread is spinning on the completion queue in
+	 * nvme_bd_cmd(); keeps a single poller per queue pair and stops
+	 * command callbacks that submit new I/O from polling recursively.
+	 */
+	uint_t nq_poll_busy;
 };
 
 struct nvme {
@@ -178,6 +193,7 @@ struct nvme {
 	boolean_t n_progress_supported;
 	int n_submission_queues;
 	int n_completion_queues;
+	uint_t n_io_poll_usec;
 
 	int n_nssr_supported;
 	int n_doorbell_stride;
@@ -224,6 +240,15 @@ struct nvme {
 	/* state for devctl minor node */
 	nvme_minor_state_t n_minor;
 
+	/*
+	 * I/O completion latency histograms, split by whether the
+	 * completion was reaped by a polling submitter or by the
+	 * interrupt path, exposed through the "io_latency" kstat.
+	 */
+	kstat_t *n_lat_kstat;
+	uint64_t n_lat_intr[NVME_LAT_BUCKETS];
+	uint64_t n_lat_poll[NVME_LAT_BUCKETS];
+
 	/* errors detected by driver */
 	uint32_t n_dma_bind_err;
 	uint32_t n_abort_failed;
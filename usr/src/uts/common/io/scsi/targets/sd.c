@@ -61,6 +61,7 @@
 #include <sys/taskq.h>
 #include <sys/uuid.h>
 #include <sys/byteorder.h>
+#include <sys/bitmap.h>
 #include <sys/sdt.h>
 
 #include "sd_xbuf.h"
@@ -827,6 +828,8 @@ static int  sd_unit_detach(dev_info_t *devi);
 
 static void sd_set_unit_attributes(struct sd_lun *un, dev_info_t *devi);
 static void sd_create_errstats(struct sd_lun *un, int instance);
+static void sd_create_latstats(struct sd_lun *un, int instance);
+static void sd_create_qstats(struct sd_lun *un, int instance);
 static void sd_set_errstats(struct sd_lun *un);
 static void sd_set_pstats(struct sd_lun *un);
 
@@ -7213,6 +7216,9 @@ sd_unit_attach(dev_info_t *devi)
 		    instance);
 	}
 
+	sd_create_latstats(un, instance);
+	sd_create_qstats(un, instance);
+
 	sd_create_errstats(un, instance);
 	if (un->un_errstats == NULL) {
 		goto create_errstats_failed;
@@ -8372,6 +8378,15 @@ sd_unit_detach(dev_info_t *devi)
 		un->un_unmapstats_ks = NULL;
 		un->un_unmapstats = NULL;
 	}
+	if (un->un_latstats != NULL) {
+		kstat_delete(un->un_latstats_ks);
+		un->un_latstats_ks = NULL;
+		un->un_latstats = NULL;
+	}
+	if (un->un_qstats_ks != NULL) {
+		kstat_delete(un->un_qstats_ks);
+		un->un_qstats_ks = NULL;
+	}
 	if (un->un_errstats != NULL) {
 		kstat_delete(un->un_errstats);
 		un->un_errstats = NULL;
@@ -8528,6 +8543,144 @@ sd_create_errstats(struct sd_lun *un, int instance)
 }
 
 
+/*
+ *    Function: sd_create_latstats
+ *
+ * Description: This routine instantiates the device latency histogram
+ *		kstat (sd<instance>,lat, class "disk_latency"), described
+ *		by the sd_latstats_t definition in sddef.h.  Each bucket
+ *		is named for its lower bound in microseconds.
+ *
+ *   Arguments: un - driver soft state (unit) structure
+ *		instance - driver instance
+ *
+ *     Context: Kernel thread context
+ */
+
+static void
+sd_create_latstats(struct sd_lun *un, int instance)
+{
+	struct	sd_latstats	*lsp;
+	char	kstatname[KSTAT_STRLEN];
+	char	bucketname[KSTAT_STRLEN];
+	int	ndata = (sizeof (struct sd_latstats) / sizeof (kstat_named_t));
+	int	i;
+
+	ASSERT(un != NULL);
+
+	if (un->un_latstats != NULL) {
+		return;
+	}
+
+	(void) snprintf(kstatname, sizeof (kstatname),
+	    "%s%d,lat", sd_label, instance);
+
+	un->un_latstats_ks = kstat_create(sd_label, instance, kstatname,
+	    "disk_latency", KSTAT_TYPE_NAMED, ndata, KSTAT_FLAG_PERSISTENT);
+
+	if (un->un_latstats_ks == NULL) {
+		SD_ERROR(SD_LOG_ATTACH_DETACH, un,
+		    "sd_create_latstats: Failed kstat_create\n");
+		return;
+	}
+
+	lsp = (struct sd_latstats *)un->un_latstats_ks->ks_data;
+	for (i = 0; i < SD_LAT_BUCKETS; i++) {
+		uint64_t lb = (i == 0) ? 0 : (1ULL << (i - 1));
+
+		(void) snprintf(bucketname, sizeof (bucketname),
+		    "r_us_%llu", (u_longlong_t)lb);
+		kstat_named_init(&lsp->ls_reads[i], bucketname,
+		    KSTAT_DATA_UINT64);
+		(void) snprintf(bucketname, sizeof (bucketname),
+		    "w_us_%llu", (u_longlong_t)lb);
+		kstat_named_init(&lsp->ls_writes[i], bucketname,
+		    KSTAT_DATA_UINT64);
+	}
+
+	un->un_latstats_ks->ks_private = un;
+	un->un_latstats_ks->ks_update  = nulldev;
+
+	kstat_install(un->un_latstats_ks);
+	un->un_latstats = lsp;
+}
+
+
+static int
+sd_qstats_update(kstat_t *ksp, int rw)
+{
+	struct	sd_lun		*un = ksp->ks_private;
+	sd_qstats_t		*qsp = ksp->ks_data;
+
+	if (rw == KSTAT_WRITE) {
+		return (EACCES);
+	}
+
+	/*
+	 * These are unlocked snapshots; the counters are only ever
+	 * updated under SD_MUTEX and a slightly stale read is fine
+	 * for observability purposes.
+	 */
+	qsp->qs_inflight.value.ui64 = (uint64_t)un->un_ncmds_in_transport;
+	qsp->qs_throttle.value.ui64 = (uint64_t)un->un_throttle;
+	qsp->qs_bypass.value.ui64 = un->un_waitq_bypass;
+	qsp->qs_enqueue.value.ui64 = un->un_waitq_enqueue;
+
+	return (0);
+}
+
+
+/*
+ *    Function: sd_create_qstats
+ *
+ * Description: This routine instantiates the command queue kstat
+ *		(sd<instance>,queue, class "queue"), described by the
+ *		sd_qstats_t definition in sddef.h.
+ *
+ *   Arguments: un - driver soft state (unit) structure
+ *		instance - driver instance
+ *
+ *     Context: Kernel thread context
+ */
+
+static void
+sd_create_qstats(struct sd_lun *un, int instance)
+{
+	sd_qstats_t	*qsp;
+	char		kstatname[KSTAT_STRLEN];
+	int	ndata = (sizeof (sd_qstats_t) / sizeof (kstat_named_t));
+
+	ASSERT(un != NULL);
+
+	if (un->un_qstats_ks != NULL) {
+		return;
+	}
+
+	(void) snprintf(kstatname, sizeof (kstatname),
+	    "%s%d,queue", sd_label, instance);
+
+	un->un_qstats_ks = kstat_create(sd_label, instance, kstatname,
+	    "queue", KSTAT_TYPE_NAMED, ndata, 0);
+
+	if (un->un_qstats_ks == NULL) {
+		SD_ERROR(SD_LOG_ATTACH_DETACH, un,
+		    "sd_create_qstats: Failed kstat_create\n");
+		return;
+	}
+
+	qsp = (sd_qstats_t *)un->un_qstats_ks->ks_data;
+	kstat_named_init(&qsp->qs_inflight, "inflight", KSTAT_DATA_UINT64);
+	kstat_named_init(&qsp->qs_throttle, "throttle", KSTAT_DATA_UINT64);
+	kstat_named_init(&qsp->qs_bypass, "waitq_bypass", KSTAT_DATA_UINT64);
+	kstat_named_init(&qsp->qs_enqueue, "waitq_enqueue", KSTAT_DATA_UINT64);
+
+	un->un_qstats_ks->ks_private = un;
+	un->un_qstats_ks->ks_update  = sd_qstats_update;
+
+	kstat_install(un->un_qstats_ks);
+}
+
+
 /*
  *    Function: sd_set_errstats
  *
@@ -10802,6 +10955,7 @@ sd_xbuf_init(struct sd_lun *un, struct buf *bp, struct sd_xbuf *xp,
 	xp->xb_pktinfo	= pktinfop;
 	xp->xb_private	= bp->b_private;
 	xp->xb_blkno	= (daddr_t)bp->b_blkno;
+	xp->xb_lat_start = gethrtime();
 
 	/*
 	 * Set up the iostart and iodone chain indexes in the xbuf, based
@@ -11660,6 +11814,26 @@ sd_buf_iodone(int index, struct sd_lun *un, struct buf *bp)
 	xp = SD_GET_XBUF(bp);
 	ASSERT(xp != NULL);
 
+	/*
+	 * Record the latency of successful commands, measured from xbuf
+	 * initialization so that it covers time spent in retries.  One
+	 * atomic increment per completion; see sd_create_latstats().
+	 */
+	if ((un->un_latstats != NULL) && ((bp->b_flags & B_ERROR) == 0)) {
+		kstat_named_t	*hist;
+		hrtime_t	us;
+		int		b;
+
+		hist = (bp->b_flags & B_READ) ?
+		    un->un_latstats->ls_reads : un->un_latstats->ls_writes;
+		us = (gethrtime() - xp->xb_lat_start) / (NANOSEC / MICROSEC);
+		b = highbit64((uint64_t)us);
+		if (b >= SD_LAT_BUCKETS) {
+			b = SD_LAT_BUCKETS - 1;
+		}
+		atomic_inc_64(&hist[b].value.ui64);
+	}
+
 	/* xbuf is gone after this */
 	if (ddi_xbuf_done(bp, un->un_xbuf_attr)) {
 		mutex_enter(SD_MUTEX(un));
@@ -12772,11 +12946,29 @@ sd_core_iostart(int index, struct sd_lun *un, struct buf *bp)
 		 * with error recovery actions which we don't want to retry.
 		 */
 		sd_start_cmds(un, bp);
+	} else if ((un->un_waitq_headp == NULL) &&
+	    (un->un_retry_bp == NULL) &&
+	    (un->un_startstop_timeid == NULL) &&
+	    (un->un_direct_priority_timeid == NULL) &&
+	    (un->un_ncmds_in_transport < un->un_throttle) &&
+	    (un->un_state == SD_STATE_NORMAL)) {
+		/*
+		 * Fast path: nothing is queued ahead of this command
+		 * and the device can accept another one now, so hand
+		 * the buf straight to sd_start_cmds() instead of
+		 * cycling it through the (empty) wait queue.  All of
+		 * the conditions the waitq dispatch loop would have
+		 * checked were just verified under SD_MUTEX, which
+		 * remains held until the command is in transport.
+		 */
+		un->un_waitq_bypass++;
+		sd_start_cmds(un, bp);
 	} else {
 		/*
 		 * Normal command -- add it to the wait queue, then start
 		 * transporting commands from the wait queue.
 		 */
+		un->un_waitq_enqueue++;
 		sd_add_buf_to_waitq(un, bp);
 		SD_UPDATE_KSTATS(un, kstat_waitq_enter, bp);
 		sd_start_cmds(un, NULL);
@@ -31178,12 +31370,18 @@ sd_check_bdc_vpd(sd_ssc_t *ssc)
 				} else if (inqb1[5] == 1) {
 					un->un_f_is_rotational = FALSE;
 					un->un_f_is_solid_state = TRUE;
-					/*
-					 * Solid state drives don't need
-					 * disksort.
-					 */
-					un->un_f_disksort_disabled = TRUE;
 				}
+				/*
+				 * Non-rotational media doesn't benefit
+				 * from seek-order sorting, and with deep
+				 * queues the ordered waitq insertion is
+				 * pure overhead, so skip disksort for
+				 * both solid state drives and other
+				 * devices reporting a non-rotating
+				 * medium (e.g. flash-backed arrays).
+				 */
+				if (!un->un_f_is_rotational)
+					un->un_f_disksort_disabled = TRUE;
 			}
 			mutex_exit(SD_MUTEX(un));
 		} else if (rval != 0) {
@@ -48,6 +48,7 @@
 #include <sys/ontrap.h>
 #include <sys/sdt.h>
 #include <sys/strft.h>
+#include <sys/zone.h>
 
 #ifdef DEBUG
 #include <sys/kmem_impl.h>
@@ -172,6 +173,7 @@ static int allocb_tryhard_fails;
 static void frnop_func(void *arg);
 frtn_t frnop = { frnop_func };
 static void bcache_dblk_lastfree(mblk_t *mp, dblk_t *dbp);
+static void mbpool_dblk_lastfree(mblk_t *mp, dblk_t *dbp);
 
 static boolean_t rwnext_enter(queue_t *qp);
 static void rwnext_exit(queue_t *qp);
@@ -390,6 +392,7 @@ streams_msg_init(void)
 		cp = kmem_cache_create(name, tot_size, DBLK_CACHE_ALIGN,
 		    dblk_constructor, dblk_destructor, NULL, (void *)(size),
 		    NULL, dblk_kmem_flags);
+		kmem_cache_set_zone_class(cp, ZONE_KMEM_CLASS_MBLK);
 
 		while (lastsize <= size) {
 			dblk_cache[(lastsize - 1) >> DBLK_SIZE_SHIFT] = cp;
@@ -400,6 +403,7 @@ streams_msg_init(void)
 	dblk_esb_cache = kmem_cache_create("streams_dblk_esb", sizeof (dblk_t),
 	    DBLK_CACHE_ALIGN, dblk_esb_constructor, dblk_destructor, NULL,
 	    (void *)sizeof (dblk_t), NULL, dblk_kmem_flags);
+	kmem_cache_set_zone_class(dblk_esb_cache, ZONE_KMEM_CLASS_MBLK);
 	fthdr_cache = kmem_cache_create("streams_fthdr", sizeof (fthdr_t), 32,
 	    fthdr_constructor, fthdr_destructor, NULL, NULL, NULL, 0);
 	ftblk_cache = kmem_cache_create("streams_ftblk", sizeof (ftblk_t), 32,
@@ -1118,6 +1122,293 @@ out:
 	return (mp);
 }
 
+/*
+ * mblk pool: a pooled buffer allocator for NIC receive.
+ *
+ * This is a bcache with a per-CPU caching layer on top, intended for
+ * drivers that allocate and free large (jumbo frame) receive buffers at
+ * high rates.  The large dblk kmem caches overflow their magazine layer
+ * under that load and every allocb()/freeb() pair turns into depot and
+ * slab transactions on a shared lock.
+ *
+ * Like a bcache, a pool pairs a buffer cache with a dblk cache whose
+ * constructor binds each dblk to a buffer for the dblk's kmem lifetime.
+ * Unlike a bcache, the pool's db_lastfree hook does not return the dblk
+ * to kmem: it pushes the still-constructed mblk/dblk pair onto the
+ * freeing CPU's private list, and mbpool_allocb() pops from the local
+ * CPU's list.  In steady state an rx buffer cycles between a CPU list
+ * and the stack with no kmem transactions at all; kmem is only involved
+ * when a CPU's list is empty (cold start) or full (overflow).  Each
+ * per-CPU list has its own lock, taken only by that CPU except for the
+ * final flush in mbpool_destroy().
+ *
+ * Consumers fill rx descriptor rings from mbpool_allocb() and simply
+ * freemsg() on toss; recycling is automatic, there is no explicit free
+ * interface.  As with a bcache, destroying a pool is deferred until the
+ * last outstanding buffer comes back.
+ */
+
+/* Default per-CPU list limit for mbpool_create(..., cpu_max = 0) */
+uint_t mbpool_cpu_max_default = 256;
+
+typedef struct mbpool_cpu {
+	kmutex_t	mbc_lock;	/* protects the two fields below */
+	mblk_t		*mbc_head;	/* constructed mblks, b_next linked */
+	uint_t		mbc_count;
+	char		mbc_pad[64 - sizeof (kmutex_t) -
+			    sizeof (mblk_t *) - sizeof (uint_t)];
+} mbpool_cpu_t;
+
+struct mbpool {
+	size_t		mbp_size;	/* buffer size */
+	uint_t		mbp_cpu_max;	/* per-CPU list limit */
+	int		mbp_alloc;	/* dblks checked out of kmem */
+	int		mbp_destroy;
+	kmutex_t	mbp_lock;
+	struct kmem_cache *mbp_buffer_cache;
+	struct kmem_cache *mbp_dblk_cache;
+	mbpool_cpu_t	*mbp_cpu;	/* max_ncpus element array */
+};
+
+static int
+mbpool_dblk_constructor(void *buf, void *cdrarg, int kmflags)
+{
+	dblk_t *dbp = buf;
+	mbpool_t *mbp = cdrarg;
+
+	if ((dbp->db_mblk = kmem_cache_alloc(mblk_cache, kmflags)) == NULL)
+		return (-1);
+
+	dbp->db_base = kmem_cache_alloc(mbp->mbp_buffer_cache, kmflags);
+	if (dbp->db_base == NULL) {
+		kmem_cache_free(mblk_cache, dbp->db_mblk);
+		return (-1);
+	}
+
+	dbp->db_mblk->b_datap = dbp;
+	dbp->db_cache = (void *)mbp;
+	dbp->db_lim = dbp->db_base + mbp->mbp_size;
+	dbp->db_free = dbp->db_lastfree = mbpool_dblk_lastfree;
+	dbp->db_frtnp = NULL;
+	dbp->db_fthdr = NULL;
+	dbp->db_credp = NULL;
+	dbp->db_cpid = -1;
+	dbp->db_struioflag = 0;
+	dbp->db_struioun.cksum.flags = 0;
+	return (0);
+}
+
+static void
+mbpool_dblk_destructor(void *buf, void *cdrarg)
+{
+	dblk_t *dbp = buf;
+	mbpool_t *mbp = cdrarg;
+
+	kmem_cache_free(mbp->mbp_buffer_cache, dbp->db_base);
+
+	ASSERT(dbp->db_mblk->b_datap == dbp);
+	ASSERT(dbp->db_struioflag == 0);
+	ASSERT(dbp->db_struioun.cksum.flags == 0);
+
+	kmem_cache_free(mblk_cache, dbp->db_mblk);
+}
+
+/*
+ * Final teardown, once the last outstanding dblk is back in kmem.
+ * Called with mbp_lock held; the lock is destroyed here.
+ */
+static void
+mbpool_free(mbpool_t *mbp)
+{
+	int i;
+
+	ASSERT(MUTEX_HELD(&mbp->mbp_lock));
+	ASSERT(mbp->mbp_alloc == 0 && mbp->mbp_destroy != 0);
+
+	mutex_exit(&mbp->mbp_lock);
+	kmem_cache_destroy(mbp->mbp_dblk_cache);
+	kmem_cache_destroy(mbp->mbp_buffer_cache);
+	for (i = 0; i < max_ncpus; i++)
+		mutex_destroy(&mbp->mbp_cpu[i].mbc_lock);
+	kmem_free(mbp->mbp_cpu, max_ncpus * sizeof (mbpool_cpu_t));
+	mutex_destroy(&mbp->mbp_lock);
+	kmem_free(mbp, sizeof (mbpool_t));
+}
+
+static void
+mbpool_dblk_lastfree(mblk_t *mp, dblk_t *dbp)
+{
+	mbpool_t *mbp = (mbpool_t *)dbp->db_cache;
+	mbpool_cpu_t *mbc;
+
+	ASSERT(dbp->db_mblk == mp);
+	if (dbp->db_fthdr != NULL)
+		str_ftfree(dbp);
+
+	/* set credp and projid to be 'unspecified' before returning to cache */
+	if (dbp->db_credp != NULL) {
+		crfree(dbp->db_credp);
+		dbp->db_credp = NULL;
+	}
+	dbp->db_cpid = -1;
+	dbp->db_struioflag = 0;
+	dbp->db_struioun.cksum.flags = 0;
+
+	/*
+	 * Recycle the constructed mblk onto this CPU's list unless the
+	 * list is full or the pool is being destroyed.  mbp_destroy is
+	 * checked under mbc_lock without mbp_lock: mbpool_destroy() sets
+	 * it and then takes every mbc_lock to flush, so anyone who gets
+	 * an mbc_lock after the flush is guaranteed to see it set.
+	 */
+	mbc = &mbp->mbp_cpu[CPU->cpu_seqid];
+	mutex_enter(&mbc->mbc_lock);
+	if (mbp->mbp_destroy == 0 && mbc->mbc_count < mbp->mbp_cpu_max) {
+		mp->b_next = mbc->mbc_head;
+		mbc->mbc_head = mp;
+		mbc->mbc_count++;
+		mutex_exit(&mbc->mbc_lock);
+		return;
+	}
+	mutex_exit(&mbc->mbc_lock);
+
+	mutex_enter(&mbp->mbp_lock);
+	kmem_cache_free(mbp->mbp_dblk_cache, dbp);
+	mbp->mbp_alloc--;
+
+	if (mbp->mbp_alloc == 0 && mbp->mbp_destroy != 0)
+		mbpool_free(mbp);
+	else
+		mutex_exit(&mbp->mbp_lock);
+}
+
+mbpool_t *
+mbpool_create(char *name, size_t size, uint_t align, uint_t cpu_max)
+{
+	mbpool_t *mbp;
+	char buffer[255];
+	int i;
+
+	ASSERT((align & (align - 1)) == 0);
+
+	if ((mbp = kmem_zalloc(sizeof (mbpool_t), KM_NOSLEEP)) == NULL)
+		return (NULL);
+
+	mbp->mbp_cpu = kmem_zalloc(max_ncpus * sizeof (mbpool_cpu_t),
+	    KM_NOSLEEP);
+	if (mbp->mbp_cpu == NULL) {
+		kmem_free(mbp, sizeof (mbpool_t));
+		return (NULL);
+	}
+
+	mbp->mbp_size = size;
+	mbp->mbp_cpu_max = (cpu_max != 0) ? cpu_max : mbpool_cpu_max_default;
+
+	mutex_init(&mbp->mbp_lock, NULL, MUTEX_DRIVER, NULL);
+	for (i = 0; i < max_ncpus; i++)
+		mutex_init(&mbp->mbp_cpu[i].mbc_lock, NULL, MUTEX_DRIVER, NULL);
+
+	(void) sprintf(buffer, "%s_buffer_cache", name);
+	mbp->mbp_buffer_cache = kmem_cache_create(buffer, size, align, NULL,
+	    NULL, NULL, NULL, NULL, 0);
+	(void) sprintf(buffer, "%s_dblk_cache", name);
+	mbp->mbp_dblk_cache = kmem_cache_create(buffer, sizeof (dblk_t),
+	    DBLK_CACHE_ALIGN, mbpool_dblk_constructor, mbpool_dblk_destructor,
+	    NULL, (void *)mbp, NULL, 0);
+
+	return (mbp);
+}
+
+void
+mbpool_destroy(mbpool_t *mbp)
+{
+	mbpool_cpu_t *mbc;
+	mblk_t *mp;
+	int i;
+
+	ASSERT(mbp != NULL);
+
+	mutex_enter(&mbp->mbp_lock);
+	mbp->mbp_destroy++;
+	mutex_exit(&mbp->mbp_lock);
+
+	/*
+	 * Flush the per-CPU lists.  Buffers still out with the stack
+	 * will bypass the lists in mbpool_dblk_lastfree() from now on,
+	 * and the last one back finishes the destroy.
+	 */
+	for (i = 0; i < max_ncpus; i++) {
+		mbc = &mbp->mbp_cpu[i];
+		mutex_enter(&mbc->mbc_lock);
+		while ((mp = mbc->mbc_head) != NULL) {
+			mbc->mbc_head = mp->b_next;
+			mbc->mbc_count--;
+			mp->b_next = NULL;
+
+			mutex_enter(&mbp->mbp_lock);
+			kmem_cache_free(mbp->mbp_dblk_cache, mp->b_datap);
+			mbp->mbp_alloc--;
+			mutex_exit(&mbp->mbp_lock);
+		}
+		ASSERT(mbc->mbc_count == 0);
+		mutex_exit(&mbc->mbc_lock);
+	}
+
+	mutex_enter(&mbp->mbp_lock);
+	if (mbp->mbp_alloc == 0)
+		mbpool_free(mbp);
+	else
+		mutex_exit(&mbp->mbp_lock);
+}
+
+mblk_t *
+mbpool_allocb(mbpool_t *mbp)
+{
+	mbpool_cpu_t *mbc;
+	dblk_t *dbp;
+	mblk_t *mp;
+
+	ASSERT(mbp != NULL);
+
+	mbc = &mbp->mbp_cpu[CPU->cpu_seqid];
+	mutex_enter(&mbc->mbc_lock);
+	if ((mp = mbc->mbc_head) != NULL) {
+		mbc->mbc_head = mp->b_next;
+		mbc->mbc_count--;
+		mutex_exit(&mbc->mbc_lock);
+		dbp = mp->b_datap;
+	} else {
+		mutex_exit(&mbc->mbc_lock);
+
+		mutex_enter(&mbp->mbp_lock);
+		if (mbp->mbp_destroy != 0) {
+			mutex_exit(&mbp->mbp_lock);
+			mp = NULL;
+			goto out;
+		}
+		if ((dbp = kmem_cache_alloc(mbp->mbp_dblk_cache,
+		    KM_NOSLEEP)) == NULL) {
+			mutex_exit(&mbp->mbp_lock);
+			mp = NULL;
+			goto out;
+		}
+		mbp->mbp_alloc++;
+		mutex_exit(&mbp->mbp_lock);
+		mp = dbp->db_mblk;
+	}
+
+	DBLK_RTFU_WORD(dbp) = DBLK_RTFU(1, M_DATA, 0, 0);
+	mp->b_next = mp->b_prev = mp->b_cont = NULL;
+	mp->b_rptr = mp->b_wptr = dbp->db_base;
+	mp->b_queue = NULL;
+	MBLK_BAND_FLAG_WORD(mp) = 0;
+	STR_FTALLOC(&dbp->db_fthdr, FTEV_BCALLOCB, mbp->mbp_size);
+out:
+	FTRACE_1("mbpool_allocb(): mp=0x%p", (uintptr_t)mp);
+
+	return (mp);
+}
+
 static void
 dblk_lastfree_oversize(mblk_t *mp, dblk_t *dbp)
 {
@@ -4005,11 +4296,17 @@ isuioq(queue_t *q)
 		return (STREAM(q)->sd_struiowrq == q);
 }
 
-#if defined(__sparc)
+/*
+ * Enable per cpu sq_putlocks/sq_putcounts (the "fastput" path in putnext)
+ * for concurrent (SQ_CIPUT) perimeters so that fully MT-safe modules enter
+ * the perimeter via a per cpu counter instead of the global SQLOCK.  This
+ * was historically enabled only on sparc, back when x86 meant small cpu
+ * counts; there is nothing sparc-specific about the mechanism and large
+ * x86 systems see the same SQLOCK contention.  putnext falls back to the
+ * SQLOCK path whenever exclusive access is pending, so qwriter and module
+ * insertion semantics are unchanged.
+ */
 int disable_putlocks = 0;
-#else
-int disable_putlocks = 1;
-#endif
 
 /*
  * called by create_putlock.
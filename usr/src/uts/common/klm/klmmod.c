@@ -71,6 +71,7 @@ void *
 lm_zone_init(zoneid_t zoneid)
 {
 	struct nlm_globals *g;
+	int i;
 
 	g = kmem_zalloc(sizeof (*g), KM_SLEEP);
 
@@ -82,7 +83,8 @@ lm_zone_init(zoneid_t zoneid)
 	    64, mod_hash_null_valdtor);
 
 	TAILQ_INIT(&g->nlm_idle_hosts);
-	TAILQ_INIT(&g->nlm_slocks);
+	for (i = 0; i < NLM_SLOCK_HASH_SIZE; i++)
+		TAILQ_INIT(&g->nlm_slocks[i]);
 
 	mutex_init(&g->lock, NULL, MUTEX_DEFAULT, NULL);
 	cv_init(&g->nlm_gc_sched_cv, NULL, CV_DEFAULT, NULL);
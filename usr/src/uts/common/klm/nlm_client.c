@@ -560,6 +560,7 @@ nlm_safemap(const vnode_t *vp)
 	struct nlm_slock *nslp;
 	struct nlm_globals *g;
 	int safe = 1;
+	int i;
 
 	/* Check active locks at first */
 	llp = flk_active_locks_for_vp(vp);
@@ -579,13 +580,15 @@ nlm_safemap(const vnode_t *vp)
 	/* Then check sleeping locks if any */
 	g = zone_getspecific(nlm_zone_key, curzone);
 	mutex_enter(&g->lock);
-	TAILQ_FOREACH(nslp, &g->nlm_slocks, nsl_link) {
-		if (nslp->nsl_state == NLM_SL_BLOCKED &&
-		    nslp->nsl_vp == vp &&
-		    (nslp->nsl_lock.l_offset != 0 ||
-		    nslp->nsl_lock.l_len != 0)) {
-			safe = 0;
-			break;
+	for (i = 0; safe && i < NLM_SLOCK_HASH_SIZE; i++) {
+		TAILQ_FOREACH(nslp, &g->nlm_slocks[i], nsl_link) {
+			if (nslp->nsl_state == NLM_SL_BLOCKED &&
+			    nslp->nsl_vp == vp &&
+			    (nslp->nsl_lock.l_offset != 0 ||
+			    nslp->nsl_lock.l_len != 0)) {
+				safe = 0;
+				break;
+			}
 		}
 	}
 
@@ -599,14 +602,17 @@ nlm_has_sleep(const vnode_t *vp)
 	struct nlm_globals *g;
 	struct nlm_slock *nslp;
 	int has_slocks = FALSE;
+	int i;
 
 	g = zone_getspecific(nlm_zone_key, curzone);
 	mutex_enter(&g->lock);
-	TAILQ_FOREACH(nslp, &g->nlm_slocks, nsl_link) {
-		if (nslp->nsl_state == NLM_SL_BLOCKED &&
-		    nslp->nsl_vp == vp) {
-			has_slocks = TRUE;
-			break;
+	for (i = 0; !has_slocks && i < NLM_SLOCK_HASH_SIZE; i++) {
+		TAILQ_FOREACH(nslp, &g->nlm_slocks[i], nsl_link) {
+			if (nslp->nsl_state == NLM_SL_BLOCKED &&
+			    nslp->nsl_vp == vp) {
+				has_slocks = TRUE;
+				break;
+			}
 		}
 	}
 
@@ -1419,12 +1419,15 @@ void
 nlm_host_cancel_slocks(struct nlm_globals *g, struct nlm_host *hostp)
 {
 	struct nlm_slock *nslp;
+	int i;
 
 	mutex_enter(&g->lock);
-	TAILQ_FOREACH(nslp, &g->nlm_slocks, nsl_link) {
-		if (nslp->nsl_host == hostp) {
-			nslp->nsl_state = NLM_SL_CANCELLED;
-			cv_broadcast(&nslp->nsl_cond);
+	for (i = 0; i < NLM_SLOCK_HASH_SIZE; i++) {
+		TAILQ_FOREACH(nslp, &g->nlm_slocks[i], nsl_link) {
+			if (nslp->nsl_host == hostp) {
+				nslp->nsl_state = NLM_SL_CANCELLED;
+				cv_broadcast(&nslp->nsl_cond);
+			}
 		}
 	}
 
@@ -1930,6 +1933,25 @@ nlm_host_get_state(struct nlm_host *hostp)
  * NLM client/server sleeping locks
  */
 
+/*
+ * Hash a filehandle to a bucket in nlm_globals->nlm_slocks.
+ * A GRANTED callback carries the filehandle of the lock being
+ * granted, so hashing by filehandle lets the callback handler
+ * scan only the sleeping locks on that file.
+ */
+static uint_t
+nlm_slock_hash(const struct netobj *fh)
+{
+	const uint8_t *cp = (const uint8_t *)fh->n_bytes;
+	uint_t hash = 0;
+	uint_t i;
+
+	for (i = 0; i < fh->n_len; i++)
+		hash = hash * 31 + cp[i];
+
+	return (hash % NLM_SLOCK_HASH_SIZE);
+}
+
 /*
  * Register client side sleeping lock.
  *
@@ -1956,9 +1978,10 @@ nlm_slock_register(
 	nslp->nsl_state = NLM_SL_BLOCKED;
 	nslp->nsl_host = host;
 	nslp->nsl_vp = vp;
+	nslp->nsl_hash = nlm_slock_hash(&nslp->nsl_fh);
 
 	mutex_enter(&g->lock);
-	TAILQ_INSERT_TAIL(&g->nlm_slocks, nslp, nsl_link);
+	TAILQ_INSERT_TAIL(&g->nlm_slocks[nslp->nsl_hash], nslp, nsl_link);
 	mutex_exit(&g->lock);
 
 	return (nslp);
@@ -1971,7 +1994,7 @@ void
 nlm_slock_unregister(struct nlm_globals *g, struct nlm_slock *nslp)
 {
 	mutex_enter(&g->lock);
-	TAILQ_REMOVE(&g->nlm_slocks, nslp, nsl_link);
+	TAILQ_REMOVE(&g->nlm_slocks[nslp->nsl_hash], nslp, nsl_link);
 	mutex_exit(&g->lock);
 
 	kmem_free(nslp->nsl_fh.n_bytes, nslp->nsl_fh.n_len);
@@ -2056,10 +2079,12 @@ nlm_slock_grant(struct nlm_globals *g,
     struct nlm_host *hostp, struct nlm4_lock *alock)
 {
 	struct nlm_slock *nslp;
+	uint_t hash;
 	int error = ENOENT;
 
+	hash = nlm_slock_hash(&alock->fh);
 	mutex_enter(&g->lock);
-	TAILQ_FOREACH(nslp, &g->nlm_slocks, nsl_link) {
+	TAILQ_FOREACH(nslp, &g->nlm_slocks[hash], nsl_link) {
 		if ((nslp->nsl_state != NLM_SL_BLOCKED) ||
 		    (nslp->nsl_host != hostp))
 			continue;
@@ -2445,6 +2470,8 @@ nlm_pool_shutdown(void)
 void
 nlm_svc_stopping(struct nlm_globals *g)
 {
+	int i;
+
 	mutex_enter(&g->lock);
 	ASSERT(g->run_status == NLM_ST_STOPPING);
 
@@ -2518,7 +2545,8 @@ nlm_svc_stopping(struct nlm_globals *g)
 		}
 	}
 
-	ASSERT(TAILQ_EMPTY(&g->nlm_slocks));
+	for (i = 0; i < NLM_SLOCK_HASH_SIZE; i++)
+		ASSERT(TAILQ_EMPTY(&g->nlm_slocks[i]));
 
 	nlm_nsm_fini(&g->nlm_nsm);
 	g->lockd_pid = 0;
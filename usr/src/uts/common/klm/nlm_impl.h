@@ -206,6 +206,13 @@ typedef enum nlm_slock_state {
 	NLM_SL_CANCELLED
 } nlm_slock_state_t;
 
+/*
+ * Number of buckets in the nlm_globals->nlm_slocks hash table.
+ * Sleeping locks are hashed by filehandle so that the GRANTED
+ * callback handler only scans locks on the file being granted.
+ */
+#define	NLM_SLOCK_HASH_SIZE	32
+
 /*
  * A client side sleeping lock request (set by F_SETLKW)
  * stored in nlm_slocks collection of nlm_globals.
@@ -220,7 +227,8 @@ typedef enum nlm_slock_state {
  *   nsl_fh: Filehandle that corresponds to nw_vp
  *   nsl_host: A host owning this sleeping lock
  *   nsl_vp: A vnode sleeping lock is waiting on.
- *   nsl_link: A list node for nlm_globals->nlm_slocks list.
+ *   nsl_hash: Bucket index in nlm_globals->nlm_slocks.
+ *   nsl_link: A list node for an nlm_globals->nlm_slocks bucket.
  */
 struct nlm_slock {
 	nlm_slock_state_t	nsl_state; /* (z) */
@@ -229,6 +237,7 @@ struct nlm_slock {
 	struct netobj		nsl_fh;    /* (c) */
 	struct nlm_host		*nsl_host; /* (c) */
 	struct vnode		*nsl_vp;   /* (c) */
+	uint_t			nsl_hash;  /* (c) */
 	TAILQ_ENTRY(nlm_slock)	nsl_link;  /* (z) */
 };
 TAILQ_HEAD(nlm_slock_list, nlm_slock);
@@ -433,7 +442,8 @@ typedef enum {
  * nlm_hosts_hash: a hash table of all hosts in the given zone
  *                 (used for hosts lookup by sysid)
  * nlm_idle_hosts: a list of all hosts that are idle state (i.e. unused)
- * nlm_slocks: a list of all client-side sleeping locks in the zone
+ * nlm_slocks: all client-side sleeping locks in the zone, hashed
+ *             by filehandle
  * cn_idle_tmo: a value of idle timeout (in seconds) obtained from lockd
  * grace_period: a value of grace period (in seconds) obtained from lockd
  * retrans_tmo: a value of retransmission timeout (in seconds) obtained
@@ -455,7 +465,7 @@ struct nlm_globals {
 	avl_tree_t			nlm_hosts_tree;		/* (z) */
 	mod_hash_t			*nlm_hosts_hash;	/* (z) */
 	struct nlm_host_list		nlm_idle_hosts;		/* (z) */
-	struct nlm_slock_list		nlm_slocks;		/* (z) */
+	struct nlm_slock_list	nlm_slocks[NLM_SLOCK_HASH_SIZE]; /* (z) */
 	int				cn_idle_tmo;		/* (z) */
 	int				grace_period;		/* (z) */
 	int				retrans_tmo;		/* (z) */
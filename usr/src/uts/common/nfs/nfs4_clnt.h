@@ -182,6 +182,8 @@ struct clstat4 {
 	kstat_named_t	referlinks;		/* referrals as symlinks */
 	kstat_named_t	clgets;			/* client handle gets */
 	kstat_named_t	cltoomany;		/* client handle cache misses */
+	kstat_named_t	rddirra;		/* readdir readaheads started */
+	kstat_named_t	rddirrahit;		/* readahead chunks consumed */
 #ifdef DEBUG
 	kstat_named_t	clalloc;		/* number of client handles */
 	kstat_named_t	noresponse;		/* server not responding cnt */
@@ -91,6 +91,7 @@ typedef struct rddir_cache {
 #define	RDDIRWAIT	0x2	/* waiting on readdir in progress */
 #define	RDDIRREQ	0x4	/* a new readdir is required */
 #define	RDDIRCACHED	0x8	/* entry is in the cache */
+#define	RDDIRRA		0x10	/* entry filled by readahead */
 
 #define	HAVE_RDDIR_CACHE(rp)	(avl_numnodes(&(rp)->r_dir) > 0)
 
@@ -93,6 +93,7 @@ typedef struct rddir4_cache {
 	int buflen;		/* size of the buffer used to store entries */
 	int actlen;		/* size of the actual entries (nfsv4 only) */
 	int flags;		/* control flags, see below */
+	int rahead;		/* remaining chained readahead budget */
 	kcondvar_t cv;		/* cv for blocking */
 	int error;		/* error from RPC operation */
 	void *data;		/* private data */
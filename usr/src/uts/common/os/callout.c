@@ -75,6 +75,7 @@ static char *callout_kstat_names[] = {
 	"callout_expirations",
 	"callout_allocations",
 	"callout_cleanups",
+	"callout_queue_inserts",
 };
 
 static hrtime_t	callout_heap_process(callout_table_t *, hrtime_t, int);
@@ -387,6 +388,7 @@ static void
 callout_queue_insert(callout_table_t *ct, callout_list_t *cl)
 {
 	cl->cl_flags |= CALLOUT_LIST_FLAG_QUEUED;
+	ct->ct_queue_inserts++;
 
 	/*
 	 * Add the callout to the callout queue. If it ends up at the head,
@@ -1023,16 +1025,6 @@ timeout_generic(int type, void (*func)(void *), void *arg,
 		mutex_enter(&ct->ct_mutex);
 	}
 
-	if (CALLOUT_CLEANUP(ct)) {
-		/*
-		 * There are too many heap elements pointing to empty callout
-		 * lists. Clean them out. Since cleanup is only done once
-		 * in a while, no need to reprogram the cyclic if the root
-		 * of the heap gets cleaned out.
-		 */
-		(void) callout_heap_process(ct, 0, 0);
-	}
-
 	if ((cp = ct->ct_free) == NULL)
 		cp = callout_alloc(ct);
 	else
@@ -1130,8 +1122,20 @@ again:
 
 		/*
 		 * Check if we have enough space in the heap to insert one
-		 * expiration. If not, expand the heap.
+		 * expiration. If not, try to make room by reaping any empty
+		 * callout lists before expanding the heap. Cleaning out
+		 * empties used to be done in the common arm path above, but
+		 * that walks the whole heap with the table lock held; high
+		 * frequency arm/cancel workloads (e.g. TCP timers) are both
+		 * the main producer of empty lists and the main victim of
+		 * the resulting lock hold times. So, cleanup is left to
+		 * callout_heap_delete() on the expiry side and only done
+		 * here when the heap is actually full.
 		 */
+		if ((ct->ct_heap_num == ct->ct_heap_max) &&
+		    (ct->ct_nreap > 0)) {
+			(void) callout_heap_process(ct, 0, 0);
+		}
 		if (ct->ct_heap_num == ct->ct_heap_max) {
 			if (callout_heap_expand(ct) == 0) {
 				/*
@@ -324,6 +324,20 @@ extern void pageout_deadman(void);
 
 static int lgrp_ticks;		/* counter to schedule lgrp load calcs */
 
+/*
+ * The system-wide runnable thread counts and per-partition statistics
+ * in clock() are gathered by walking every CPU and every partition.
+ * On large machines that walk dominates the cost of the tick, so it is
+ * sampled clock_stats_hz times per second (and always on the one
+ * second rollover, which consumes the results) rather than on every
+ * tick. Each visit still contributes exactly one sample to the
+ * cp_updates/cp_nrunnable_cum pairs, so consumers of their ratio see
+ * unbiased averages regardless of the sampling rate. Setting
+ * clock_stats_hz to hz or more restores per-tick sampling.
+ */
+int clock_stats_hz = 10;
+static int clock_stats_ticks;	/* counter to schedule the stats walk */
+
 /*
  * for tod fault detection
  */
@@ -384,6 +398,7 @@ static int	adj_hist_entry;
 int64_t clock_adj_hist[CLOCK_ADJ_HIST_SIZE];
 
 static void calcloadavg(int, uint64_t *);
+static void lgrp_calcloadavg(void);
 static int genloadavg(struct loadavg_s *);
 static void loadavg_update();
 
@@ -394,92 +409,22 @@ extern clock_t clock_tick_proc_max;
 
 static int64_t deadman_counter = 0;
 
+/*
+ * Count the number of runnable threads and the number waiting for some
+ * form of I/O to complete -- gets added to sysinfo.waiting.  To know
+ * the state of the system, must add wait counts from all CPUs.  Also
+ * add up the per-partition statistics, and update the lgroup load
+ * averages when do_lgrp_load is set.  Historically this ran on every
+ * tick; it is now sampled from clock() at the clock_stats_hz rate.
+ */
 static void
-clock(void)
+clock_cpu_stats(int do_lgrp_load, uint_t *nrunnablep, uint_t *w_iop)
 {
 	kthread_t	*t;
-	uint_t	nrunnable;
-	uint_t	w_io;
+	uint_t	nrunnable = 0;
+	uint_t	w_io = 0;
 	cpu_t	*cp;
 	cpupart_t *cpupart;
-	void	(*funcp)();
-	int32_t ltemp;
-	int64_t lltemp;
-	int s;
-	int do_lgrp_load;
-	int i;
-	clock_t now = LBOLT_NO_ACCOUNT;	/* current tick */
-
-	if (panicstr)
-		return;
-
-	/*
-	 * Make sure that 'freemem' do not drift too far from the truth
-	 */
-	set_freemem();
-
-
-	/*
-	 * Before the section which is repeated is executed, we do
-	 * the time delta processing which occurs every clock tick
-	 *
-	 * There is additional processing which happens every time
-	 * the nanosecond counter rolls over which is described
-	 * below - see the section which begins with : if (one_sec)
-	 *
-	 * This section marks the beginning of the precision-kernel
-	 * code fragment.
-	 *
-	 * First, compute the phase adjustment. If the low-order bits
-	 * (time_phase) of the update overflow, bump the higher order
-	 * bits (time_update).
-	 */
-	time_phase += time_adj;
-	if (time_phase <= -FINEUSEC) {
-		ltemp = -time_phase / SCALE_PHASE;
-		time_phase += ltemp * SCALE_PHASE;
-		s = hr_clock_lock();
-		timedelta -= ltemp * (NANOSEC/MICROSEC);
-		hr_clock_unlock(s);
-	} else if (time_phase >= FINEUSEC) {
-		ltemp = time_phase / SCALE_PHASE;
-		time_phase -= ltemp * SCALE_PHASE;
-		s = hr_clock_lock();
-		timedelta += ltemp * (NANOSEC/MICROSEC);
-		hr_clock_unlock(s);
-	}
-
-	/*
-	 * End of precision-kernel code fragment which is processed
-	 * every timer interrupt.
-	 *
-	 * Continue with the interrupt processing as scheduled.
-	 */
-	/*
-	 * Count the number of runnable threads and the number waiting
-	 * for some form of I/O to complete -- gets added to
-	 * sysinfo.waiting.  To know the state of the system, must add
-	 * wait counts from all CPUs.  Also add up the per-partition
-	 * statistics.
-	 */
-	w_io = 0;
-	nrunnable = 0;
-
-	/*
-	 * keep track of when to update lgrp/part loads
-	 */
-
-	do_lgrp_load = 0;
-	if (lgrp_ticks++ >= hz / 10) {
-		lgrp_ticks = 0;
-		do_lgrp_load = 1;
-	}
-
-	if (one_sec) {
-		loadavg_update();
-		deadman_counter++;
-		pageout_deadman();
-	}
 
 	/*
 	 * First count the threads waiting on kpreempt queues in each
@@ -614,6 +559,105 @@ clock(void)
 		}
 	} while ((cp = cp->cpu_next) != cpu_list);
 
+	*nrunnablep = nrunnable;
+	*w_iop = w_io;
+}
+
+static void
+clock(void)
+{
+	kthread_t	*t;
+	uint_t	nrunnable;
+	uint_t	w_io;
+	cpupart_t *cpupart;
+	void	(*funcp)();
+	int32_t ltemp;
+	int64_t lltemp;
+	int s;
+	int do_lgrp_load;
+	int do_cpu_stats;
+	int i;
+	clock_t now = LBOLT_NO_ACCOUNT;	/* current tick */
+
+	if (panicstr)
+		return;
+
+	/*
+	 * Make sure that 'freemem' do not drift too far from the truth
+	 */
+	set_freemem();
+
+
+	/*
+	 * Before the section which is repeated is executed, we do
+	 * the time delta processing which occurs every clock tick
+	 *
+	 * There is additional processing which happens every time
+	 * the nanosecond counter rolls over which is described
+	 * below - see the section which begins with : if (one_sec)
+	 *
+	 * This section marks the beginning of the precision-kernel
+	 * code fragment.
+	 *
+	 * First, compute the phase adjustment. If the low-order bits
+	 * (time_phase) of the update overflow, bump the higher order
+	 * bits (time_update).
+	 */
+	time_phase += time_adj;
+	if (time_phase <= -FINEUSEC) {
+		ltemp = -time_phase / SCALE_PHASE;
+		time_phase += ltemp * SCALE_PHASE;
+		s = hr_clock_lock();
+		timedelta -= ltemp * (NANOSEC/MICROSEC);
+		hr_clock_unlock(s);
+	} else if (time_phase >= FINEUSEC) {
+		ltemp = time_phase / SCALE_PHASE;
+		time_phase -= ltemp * SCALE_PHASE;
+		s = hr_clock_lock();
+		timedelta += ltemp * (NANOSEC/MICROSEC);
+		hr_clock_unlock(s);
+	}
+
+	/*
+	 * End of precision-kernel code fragment which is processed
+	 * every timer interrupt.
+	 *
+	 * Continue with the interrupt processing as scheduled.
+	 */
+	w_io = 0;
+	nrunnable = 0;
+
+	/*
+	 * keep track of when to update lgrp/part loads
+	 */
+
+	do_lgrp_load = 0;
+	if (lgrp_ticks++ >= hz / 10) {
+		lgrp_ticks = 0;
+		do_lgrp_load = 1;
+	}
+
+	if (one_sec) {
+		loadavg_update();
+		deadman_counter++;
+		pageout_deadman();
+	}
+
+	/*
+	 * The lgrp load update reuses the statistics walk, so sampling
+	 * whenever do_lgrp_load is set keeps the two activities down to
+	 * a single shared walk.
+	 */
+	do_cpu_stats = 0;
+	if (one_sec || do_lgrp_load ||
+	    ++clock_stats_ticks >= hz / MAX(clock_stats_hz, 1)) {
+		clock_stats_ticks = 0;
+		do_cpu_stats = 1;
+	}
+
+	if (do_cpu_stats)
+		clock_cpu_stats(do_lgrp_load, &nrunnable, &w_io);
+
 	clock_tick_schedule(one_sec);
 
 	/*
@@ -906,6 +950,8 @@ clock(void)
 			    cpupart->cp_hp_avenrun);
 		} while ((cpupart = cpupart->cp_next) != cp_list_head);
 
+		lgrp_calcloadavg();
+
 		/*
 		 * Wake up the swapper thread if necessary.
 		 */
@@ -1604,9 +1650,14 @@ clock_tick(kthread_t *t, int pending)
 	 * Enforce CPU resource controls:
 	 *   (a) process.max-cpu-time resource control
 	 *
-	 * Perform the check only if we have accumulated more a second.
+	 * Perform the check only if we have accumulated more a second, and
+	 * only call rctl_test() once the enforced value cached by
+	 * proc_cpu_time_set() has actually been reached; the control is
+	 * infinite for most processes, and the cached comparison spares
+	 * them a walk of the rctl value list every second.
 	 */
-	if ((ticks + pending) >= hz) {
+	if ((ticks + pending) >= hz &&
+	    (pp->p_utime + pp->p_stime)/hz >= pp->p_cpu_time_ctl) {
 		(void) rctl_test(rctlproc_legacy[RLIMIT_CPU], pp->p_rctls, pp,
 		    (pp->p_utime + pp->p_stime)/hz, RCA_UNSAFE_SIGINFO);
 	}
@@ -2412,6 +2463,46 @@ calcloadavg(int nrun, uint64_t *hp_ave)
 	}
 }
 
+/*
+ * Update the per-lgroup load averages published in lgrp_hp_avenrun[]
+ * from the instantaneous leaf lgroup loads that lgrp_loadavg()
+ * maintains.  The per-CPU loads are summed by home lgroup, averaged
+ * over the lgroup's CPUs and rescaled from lgrp_loadavg_max_effect
+ * units into the LGRP_LOADAVG_IN_THREAD_MAX units that calcloadavg()
+ * expects.  Called once per second from clock(); like the rest of
+ * clock() the CPU list is walked without cpu_lock, so a CPU migrating
+ * between lgroups mid-walk merely perturbs a single sample.
+ */
+static void
+lgrp_calcloadavg(void)
+{
+	static uint64_t loads[NLGRPS_MAX];
+	static uint_t lcpus[NLGRPS_MAX];
+	cpu_t *cp;
+	lgrp_id_t lgrpid;
+	int i;
+
+	bzero(loads, sizeof (loads));
+	bzero(lcpus, sizeof (lcpus));
+
+	cp = cpu_list;
+	do {
+		lgrpid = cp->cpu_lpl->lpl_lgrpid;
+		if (lgrpid != LGRP_NONE && lgrpid < NLGRPS_MAX) {
+			loads[lgrpid] += cp->cpu_lpl->lpl_loadavg;
+			lcpus[lgrpid]++;
+		}
+	} while ((cp = cp->cpu_next) != cpu_list);
+
+	for (i = 0; i < NLGRPS_MAX; i++) {
+		if (lcpus[i] == 0)
+			continue;
+		calcloadavg((int)(loads[i] / lcpus[i] *
+		    LGRP_LOADAVG_IN_THREAD_MAX / lgrp_loadavg_max_effect),
+		    lgrp_hp_avenrun[i]);
+	}
+}
+
 /*
  * lbolt_hybrid() is used by ddi_get_lbolt() and ddi_get_lbolt64() to
  * calculate the value of lbolt according to the current mode. In the event
@@ -131,6 +131,14 @@
  * clock_tick_scan
  *	Where to begin the scan for single-threaded mode. In multi-threaded,
  *	the clock_tick_set itself contains a field for this.
+ *
+ * clock_tick_skip_idle
+ *	When set, clock_tick_schedule() avoids picking an idle CPU as the
+ *	target of a tick accounting softint if a non-idle alternative is
+ *	online. Any CPU can account for any set's threads, and idle CPUs
+ *	have nothing of their own to account; waking them hz times per
+ *	second just to scan other CPUs defeats deep idle states and, under
+ *	virtualization, causes guest exits for nothing.
  */
 int			clock_tick_threshold;
 int			clock_tick_ncpus;
@@ -147,6 +155,7 @@ clock_t			clock_tick_proc_max;
 clock_tick_set_t	*clock_tick_set;
 int			clock_tick_nsets;
 int			clock_tick_scan;
+int			clock_tick_skip_idle = 1;
 ulong_t			clock_tick_intr;
 
 static uint_t	clock_tick_execute(caddr_t, caddr_t);
@@ -427,7 +436,7 @@ clock_tick_schedule(int one_sec)
 	ulong_t			active;
 	int			i, end;
 	clock_tick_set_t	*csp;
-	cpu_t			*cp;
+	cpu_t			*cp, *tcp;
 
 	if (clock_cpu_id != CPU->cpu_id)
 		clock_cpu_id = CPU->cpu_id;
@@ -504,7 +513,33 @@ clock_tick_schedule(int one_sec)
 		if (csp->ct_scan >= csp->ct_end)
 			csp->ct_scan = csp->ct_start;
 
-		clock_tick_schedule_one(csp, clock_tick_pending, cp->cpu_id);
+		/*
+		 * If the CPU we picked is idle, look for a non-idle CPU to
+		 * take the softint instead. A busy CPU is already taking
+		 * an interrupt stream, whereas an idle CPU would have to be
+		 * woken out of its idle state just to account for other
+		 * CPUs' threads. If every other online CPU is also idle,
+		 * there is nothing to be gained and we fall back to the
+		 * original choice. The reads of cpu_dispthread are racy,
+		 * but this is only a heuristic; a stale answer merely
+		 * sends one softint to a less than ideal CPU.
+		 */
+		tcp = cp;
+		if (clock_tick_skip_idle &&
+		    tcp->cpu_dispthread == tcp->cpu_idle_thread) {
+			cpu_t	*ncp = tcp->cpu_next_onln;
+
+			while (ncp != tcp) {
+				if (ncp != CPU && ncp->cpu_dispthread !=
+				    ncp->cpu_idle_thread) {
+					tcp = ncp;
+					break;
+				}
+				ncp = ncp->cpu_next_onln;
+			}
+		}
+
+		clock_tick_schedule_one(csp, clock_tick_pending, tcp->cpu_id);
 
 		cp = cp->cpu_next_onln;
 	}
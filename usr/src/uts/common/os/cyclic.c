@@ -592,7 +592,10 @@
  *        correct position in the heap (up or down depending on whether the
  *        new expiration is less than or greater than the old one).
  *    5.  If the cyclic move modified the root of the heap, the backend is
- *        reprogrammed.
+ *        reprogrammed.  If the reprogram came from a CY_HIGH_LEVEL handler
+ *        running out of cyclic_fire(), the backend reprogramming is instead
+ *        left to cyclic_fire(), which reprograms the backend exactly once
+ *        after processing all of the expired cyclics.
  *
  *  Reprogramming can be a frequent event (see the callout subsystem). So,
  *  the serialization used has to be efficient. As with all other cyclic
@@ -967,6 +970,15 @@ cyclic_fire(cpu_t *c)
 		return;
 	}
 
+	/*
+	 * While we process the batch of expired cyclics, a CY_HIGH_LEVEL
+	 * handler may reprogram its own cyclic; note that we're in
+	 * cyclic_fire() so that cyclic_reprogram_cyclic() defers the
+	 * backend reprogramming to the single call below rather than
+	 * reprogramming the clock source once per expired cyclic.
+	 */
+	cpu->cyp_infire = 1;
+
 	for (;;) {
 		cyc_index_t ndx = heap[0];
 
@@ -1036,6 +1048,8 @@ cyclic_fire(cpu_t *c)
 		cyclic_downheap(cpu, 0);
 	}
 
+	cpu->cyp_infire = 0;
+
 	/*
 	 * Now we have a cyclic in the root slot which isn't in the past;
 	 * reprogram the interrupt source.
@@ -2020,9 +2034,14 @@ cyclic_reprogram_cyclic(cyc_cpu_t *cpu, cyc_index_t ndx, hrtime_t expire,
 		reprog = cyclic_upheap(cpu, i);
 	}
 
-	if (reprog && (cpu->cyp_state != CYS_SUSPENDED)) {
+	if (reprog && cpu->cyp_infire == 0 &&
+	    (cpu->cyp_state != CYS_SUSPENDED)) {
 		/*
-		 * The root changed. Reprogram the clock source.
+		 * The root changed.  Reprogram the clock source, unless we
+		 * were called from a CY_HIGH_LEVEL handler running out of
+		 * cyclic_fire(), in which case cyclic_fire() will reprogram
+		 * the clock source once after the entire batch of expired
+		 * cyclics has been processed.
 		 */
 		CYC_TRACE0(cpu, CY_HIGH_LEVEL, "reprog-root");
 		cyclic = &cpu->cyp_cyclics[heap[0]];
@@ -75,6 +75,7 @@
 #include <sys/cpu.h>
 
 #include <bzip2/bzlib.h>
+#include <lz4.h>
 
 #define	ONE_GIG	(1024 * 1024 * 1024UL)
 
@@ -82,19 +83,20 @@
  * Crash dump time is dominated by disk write time.  To reduce this,
  * the stronger compression method bzip2 is applied to reduce the dump
  * size and hence reduce I/O time.  However, bzip2 is much more
- * computationally expensive than the existing lzjb algorithm, so to
- * avoid increasing compression time, CPUs that are otherwise idle
- * during panic are employed to parallelize the compression task.
- * Many helper CPUs are needed to prevent bzip2 from being a
- * bottleneck, and on systems with too few CPUs, the lzjb algorithm is
- * parallelized instead. Lastly, I/O and compression are performed by
- * different CPUs, and are hence overlapped in time, unlike the older
- * serial code.
+ * computationally expensive than lz4, so to avoid increasing
+ * compression time, CPUs that are otherwise idle during panic are
+ * employed to parallelize the compression task.  Many helper CPUs are
+ * needed to prevent bzip2 from being a bottleneck, and on systems
+ * with too few CPUs, the lz4 algorithm is parallelized instead. The
+ * older lzjb algorithm is retained for single-threaded dumps and for
+ * the odd pages that are compressed by the main task. Lastly, I/O and
+ * compression are performed by different CPUs, and are hence
+ * overlapped in time, unlike the older serial code.
  *
  * Another important consideration is the speed of the dump
  * device. Faster disks need less CPUs in order to benefit from
- * parallel lzjb versus parallel bzip2. Therefore, the CPU count
- * threshold for switching from parallel lzjb to paralled bzip2 is
+ * parallel lz4 versus parallel bzip2. Therefore, the CPU count
+ * threshold for switching from parallel lz4 to paralled bzip2 is
  * elevated for faster disks. The dump device speed is adduced from
  * the setting for dumpbuf.iosize, see dump_update_clevel.
  */
@@ -118,7 +120,7 @@ char	    *dump_stack_scratch; /* scratch area for saving stack summary */
  * Tunables for dump compression and parallelism. These can be set via
  * /etc/system.
  *
- * dump_ncpu_low	number of helpers for parallel lzjb
+ * dump_ncpu_low	number of helpers for parallel lz4
  *	This is also the minimum configuration.
  *
  * dump_bzip2_level	bzip2 compression level: 1-9
@@ -133,7 +135,7 @@ char	    *dump_stack_scratch; /* scratch area for saving stack summary */
  *	to savecore via the dump file, and recorded by savecore in
  *	METRICS.txt.
  */
-uint_t dump_ncpu_low = 4;	/* minimum config for parallel lzjb */
+uint_t dump_ncpu_low = 4;	/* minimum config for parallel lz4 */
 uint_t dump_bzip2_level = 1;	/* bzip2 level (1-9) */
 
 /* Use dump_plat_mincpu_default unless this variable is set by /etc/system */
@@ -383,7 +385,8 @@ typedef struct helper {
 	dumpsync_t *ds;			/* pointer to sync vars */
 	size_t used;			/* counts input consumed */
 	char *page;			/* buffer for page copy */
-	char *lzbuf;			/* lzjb output */
+	char *lzbuf;			/* lzjb/lz4 output */
+	char *lz4ctx;			/* lz4 scratch context */
 	bz_stream bzstream;		/* bzip2 state */
 } helper_t;
 
@@ -515,21 +518,23 @@ dumpbuf_resize(void)
  * Live dump (savecore -L) always uses the minimum config.
  *
  * clevel 0 is single threaded lzjb
- * clevel 1 is parallel lzjb
+ * clevel 1 is parallel lzjb (no longer generated; savecore still
+ *	accepts it so that old dumps remain readable)
  * clevel 2 is parallel bzip2
+ * clevel 3 is parallel lz4
  *
  * The ncpu threshold is selected with dump_plat_mincpu.
  * On OPL, set_platform_defaults() overrides the sun4u setting.
  * The actual values are defined via DUMP_PLAT_*_MINCPU macros.
  *
  * Architecture		Threshold	Algorithm
- * sun4u		<  51		parallel lzjb
+ * sun4u		<  51		parallel lz4
  * sun4u		>= 51		parallel bzip2(*)
- * sun4u OPL		<  8		parallel lzjb
+ * sun4u OPL		<  8		parallel lz4
  * sun4u OPL		>= 8		parallel bzip2(*)
- * sun4v		<  128		parallel lzjb
+ * sun4v		<  128		parallel lz4
  * sun4v		>= 128		parallel bzip2(*)
- * x86			< 11		parallel lzjb
+ * x86			< 11		parallel lz4
  * x86			>= 11		parallel bzip2(*)
  * 32-bit		N/A		single-threaded lzjb
  *
@@ -556,7 +561,7 @@ static void
 dump_update_clevel()
 {
 	int tag;
-	size_t bz2size;
+	size_t bz2size, lz4size;
 	helper_t *hp, *hpend;
 	cbuf_t *cp, *cpend;
 	dumpcfg_t *old = &dumpcfg;
@@ -577,6 +582,8 @@ dump_update_clevel()
 				kmem_free(hp->lzbuf, PAGESIZE);
 			if (hp->page != NULL)
 				kmem_free(hp->page, PAGESIZE);
+			if (hp->lz4ctx != NULL)
+				kmem_free(hp->lz4ctx, lz4_compress_ctxlen());
 		}
 		kmem_free(old->helper, old->nhelper * sizeof (helper_t));
 
@@ -627,7 +634,7 @@ dump_update_clevel()
 	} else if ((new->nhelper + 1) >= new->threshold) {
 		new->clevel = DUMP_CLEVEL_BZIP2;
 	} else {
-		new->clevel = DUMP_CLEVEL_LZJB;
+		new->clevel = DUMP_CLEVEL_LZ4;
 	}
 
 	if (new->clevel == 0) {
@@ -643,6 +650,7 @@ dump_update_clevel()
 	 * and also figure the max desired size.
 	 */
 	bz2size = BZ2_bzCompressInitSize(dump_bzip2_level);
+	lz4size = lz4_compress_ctxlen();
 	new->maxsize = 0;
 	new->maxvmsize = 0;
 	new->maxvm = NULL;
@@ -654,12 +662,21 @@ dump_update_clevel()
 		if (hp < &new->helper[MINHELPERS]) {
 			hp->lzbuf = kmem_alloc(PAGESIZE, KM_SLEEP);
 			hp->page = kmem_alloc(PAGESIZE, KM_SLEEP);
-		} else if (new->clevel < DUMP_CLEVEL_BZIP2) {
+			/*
+			 * The lz4 scratch context is preallocated even
+			 * when another clevel is configured so that the
+			 * fallbacks from bzip2 to lz4 at dump time can
+			 * always use the minimum set of helpers.
+			 */
+			hp->lz4ctx = kmem_alloc(lz4size, KM_SLEEP);
+		} else if (new->clevel == DUMP_CLEVEL_LZ4) {
+			new->maxsize += 2 * PAGESIZE + lz4size;
+		} else if (new->clevel != DUMP_CLEVEL_BZIP2) {
 			new->maxsize += 2 * PAGESIZE;
 		} else {
 			new->maxsize += PAGESIZE;
 		}
-		if (new->clevel >= DUMP_CLEVEL_BZIP2)
+		if (new->clevel == DUMP_CLEVEL_BZIP2)
 			new->maxsize += bz2size;
 	}
 
@@ -901,7 +918,7 @@ dumpsys_get_maxmem()
 	cbuf_t *endcp = &cfg->cbuf[cfg->ncbuf];
 	helper_t *endhp = &cfg->helper[cfg->nhelper];
 	pgcnt_t bitnum, end;
-	size_t sz, endsz, bz2size;
+	size_t sz, endsz, bz2size, lz4size;
 	pfn_t pfn, off;
 	cbuf_t *cp;
 	helper_t *hp, *ohp;
@@ -924,8 +941,8 @@ dumpsys_get_maxmem()
 	 */
 	if (cfg->maxsize == 0 || cfg->clevel < DUMP_CLEVEL_LZJB ||
 	    (dump_conflags & DUMP_ALL) != 0) {
-		if (cfg->clevel > DUMP_CLEVEL_LZJB)
-			cfg->clevel = DUMP_CLEVEL_LZJB;
+		if (cfg->clevel == DUMP_CLEVEL_BZIP2)
+			cfg->clevel = DUMP_CLEVEL_LZ4;
 		return;
 	}
 
@@ -1009,10 +1026,10 @@ dumpsys_get_maxmem()
 		}
 	}
 
-	/* Fall back to lzjb if we did not get enough memory for bzip2. */
+	/* Fall back to lz4 if we did not get enough memory for bzip2. */
 	endsz = (cfg->maxsize * cfg->threshold) / cfg->nhelper;
 	if (sz < endsz) {
-		cfg->clevel = DUMP_CLEVEL_LZJB;
+		cfg->clevel = DUMP_CLEVEL_LZ4;
 	}
 
 	/* Allocate memory for as many helpers as we can. */
@@ -1025,6 +1042,9 @@ foundmax:
 	/* Set the size for bzip2 state. Only bzip2 needs it. */
 	bz2size = BZ2_bzCompressInitSize(dump_bzip2_level);
 
+	/* Set the size for the lz4 scratch context. Only lz4 needs it. */
+	lz4size = lz4_compress_ctxlen();
+
 	/* Skip the preallocate output buffers. */
 	cp = &cfg->cbuf[MINCBUFS];
 
@@ -1036,7 +1056,18 @@ foundmax:
 
 		/* Skip preallocated helpers by checking hp->page. */
 		if (hp->page == NULL) {
-			if (cfg->clevel <= DUMP_CLEVEL_LZJB) {
+			if (cfg->clevel == DUMP_CLEVEL_LZ4) {
+				/* lz4 needs 2 1-page buffers and scratch */
+				if ((sz + (2 * PAGESIZE) + lz4size) > endsz)
+					break;
+				hp->page = cfg->maxvm + sz;
+				sz += PAGESIZE;
+				hp->lzbuf = cfg->maxvm + sz;
+				sz += PAGESIZE;
+				hp->lz4ctx = cfg->maxvm + sz;
+				sz += lz4size;
+
+			} else if (cfg->clevel != DUMP_CLEVEL_BZIP2) {
 				/* lzjb needs 2 1-page buffers */
 				if ((sz + (2 * PAGESIZE)) > endsz)
 					break;
@@ -1079,7 +1110,7 @@ foundmax:
 		 * and dumpbzfree callbacks to allocate the memory.
 		 * bzip2 does allocation only at init time.
 		 */
-		if (cfg->clevel >= DUMP_CLEVEL_BZIP2) {
+		if (cfg->clevel == DUMP_CLEVEL_BZIP2) {
 			if ((sz + bz2size) > endsz) {
 				hp->page = NULL;
 				break;
@@ -2187,6 +2218,87 @@ dumpsys_lzjbcompress(helper_t *hp)
 	CQ_CLOSE(mainq);
 }
 
+/*
+ * Compress one page with lz4 into hp->lzbuf.
+ *
+ * lz4_compress_ctx returns the input size when the data did not
+ * shrink to fit the given output limit. The limit is set to
+ * PAGESIZE - 1 so that a successful return is always less than
+ * PAGESIZE; in the incompressible case the page is stored raw, and a
+ * record of exactly PAGESIZE bytes unambiguously denotes a raw page
+ * to savecore. The caller-provided scratch context is used because
+ * helper CPUs must not allocate memory during a panic dump.
+ */
+static size_t
+dumpsys_lz4_page(helper_t *hp)
+{
+	size_t csize;
+
+	csize = lz4_compress_ctx(hp->lz4ctx, hp->page, hp->lzbuf, PAGESIZE,
+	    PAGESIZE - 1, 0);
+	if (csize >= PAGESIZE) {
+		bcopy(hp->page, hp->lzbuf, PAGESIZE);
+		csize = PAGESIZE;
+	}
+	return (csize);
+}
+
+/*
+ * Compress a stream of pages with lz4. The stream block format is the
+ * same as parallel lzjb, so dumpsys_lzjbrun handles the framing; only
+ * the per-page codec differs.
+ */
+static void
+dumpsys_lz4compress(helper_t *hp)
+{
+	dumpsync_t *ds = hp->ds;
+	size_t csize;
+	dumpstreamhdr_t sh;
+
+	(void) strcpy(sh.stream_magic, DUMP_STREAM_MAGIC);
+	sh.stream_pagenum = (pfn_t)-1;
+	sh.stream_npages = 0;
+	hp->cpin = NULL;
+	hp->cpout = NULL;
+	hp->cperr = NULL;
+	hp->in = 0;
+	hp->out = 0;
+
+	/* Bump reference to mainq while we are running */
+	CQ_OPEN(mainq);
+
+	/* Get one page at a time */
+	while (dumpsys_sread(hp)) {
+
+		/* Create a stream header for each new input map */
+		if (sh.stream_pagenum != hp->cpin->pagenum) {
+			sh.stream_pagenum = hp->cpin->pagenum;
+			sh.stream_npages = btop(hp->cpin->used);
+			dumpsys_lzjbrun(hp, 0, &sh, sizeof (sh));
+		}
+
+		/* Compress one page */
+		HRSTART(hp->perpage, compress);
+		csize = dumpsys_lz4_page(hp);
+		HRSTOP(hp->perpage, compress);
+
+		/* Add csize+data to output block */
+		ASSERT(csize > 0 && csize <= PAGESIZE);
+		dumpsys_lzjbrun(hp, csize, hp->lzbuf, csize);
+	}
+
+	/* Done with input, flush any partial buffer */
+	if (sh.stream_pagenum != (pfn_t)-1) {
+		dumpsys_lzjbrun(hp, 0, NULL, 0);
+		dumpsys_errmsg(hp, NULL);
+	}
+
+	ASSERT(hp->cpin == NULL && hp->cpout == NULL && hp->cperr == NULL);
+
+	/* Decrement main queue count, we are done */
+	CQ_CLOSE(mainq);
+}
+
 /*
  * Dump helper called from panic_idle() to compress pages.  CPUs in
  * this path must not call most kernel services.
@@ -2221,10 +2333,12 @@ dumpsys_helper()
 
 				dumpsys_spinunlock(&dumpcfg.helper_lock);
 
-				if (dumpcfg.clevel < DUMP_CLEVEL_BZIP2)
-					dumpsys_lzjbcompress(hp);
-				else
+				if (dumpcfg.clevel == DUMP_CLEVEL_BZIP2)
 					dumpsys_bz2compress(hp);
+				else if (dumpcfg.clevel == DUMP_CLEVEL_LZ4)
+					dumpsys_lz4compress(hp);
+				else
+					dumpsys_lzjbcompress(hp);
 
 				hp->helper = DONEHELPER;
 				return;
@@ -2262,10 +2376,12 @@ dumpsys_live_helper(void *arg)
 	helper_t *hp = arg;
 
 	BT_ATOMIC_SET(dumpcfg.helpermap, CPU->cpu_seqid);
-	if (dumpcfg.clevel < DUMP_CLEVEL_BZIP2)
-		dumpsys_lzjbcompress(hp);
-	else
+	if (dumpcfg.clevel == DUMP_CLEVEL_BZIP2)
 		dumpsys_bz2compress(hp);
+	else if (dumpcfg.clevel == DUMP_CLEVEL_LZ4)
+		dumpsys_lz4compress(hp);
+	else
+		dumpsys_lzjbcompress(hp);
 }
 
 /*
@@ -2606,8 +2722,9 @@ dumpsys_metrics(dumpsync_t *ds, char *buf, size_t size)
 
 	P("Compression level,%d\n", cfg->clevel);
 	P("Compression type,%s %s", cfg->clevel == 0 ? "serial" : "parallel",
-	    cfg->clevel >= DUMP_CLEVEL_BZIP2 ? "bzip2" : "lzjb");
-	if (cfg->clevel >= DUMP_CLEVEL_BZIP2)
+	    cfg->clevel == DUMP_CLEVEL_BZIP2 ? "bzip2" :
+	    cfg->clevel == DUMP_CLEVEL_LZ4 ? "lz4" : "lzjb");
+	if (cfg->clevel == DUMP_CLEVEL_BZIP2)
 		P(" (level %d)\n", dump_bzip2_level);
 	else
 		P("\n");
@@ -2877,8 +2994,8 @@ dumpsys(void)
 	save_dump_clevel = dumpcfg.clevel;
 	if (panicstr)
 		dumpsys_get_maxmem();
-	else if (dumpcfg.clevel >= DUMP_CLEVEL_BZIP2)
-		dumpcfg.clevel = DUMP_CLEVEL_LZJB;
+	else if (dumpcfg.clevel == DUMP_CLEVEL_BZIP2)
+		dumpcfg.clevel = DUMP_CLEVEL_LZ4;
 
 	dumpcfg.nhelper_used = 0;
 	for (hp = dumpcfg.helper; hp != hpend; hp++) {
@@ -2891,7 +3008,7 @@ dumpsys(void)
 		hp->taskqid = 0;
 		hp->ds = ds;
 		bzero(&hp->perpage, sizeof (hp->perpage));
-		if (dumpcfg.clevel >= DUMP_CLEVEL_BZIP2)
+		if (dumpcfg.clevel == DUMP_CLEVEL_BZIP2)
 			(void) BZ2_bzCompressReset(&hp->bzstream);
 	}
 
@@ -1101,47 +1101,60 @@ exacct_commit_callback(ac_info_t *info, void *ubuf, size_t ubufsize,
 	return (error);
 }
 
+/*
+ * Deferred process accounting commitment.  exacct_commit_proc() snapshots
+ * the exiting process's usage while the process is still intact and hands
+ * the snapshot to the exacct task queue; exacct_do_commit_proc() later
+ * assembles and writes the record(s) from taskq context, so that process
+ * exit itself never waits on accounting file I/O.
+ */
+typedef struct exacct_proc_commit {
+	proc_usage_t	epc_usage;	/* snapshot of final usage */
+	zone_t		*epc_zone;	/* held zone of the exited process */
+	char		epc_command[MAXCOMLEN + 1];
+} exacct_proc_commit_t;
+
 static void
-exacct_do_commit_proc(ac_info_t *ac_proc, proc_t *p, int wstat)
+exacct_do_commit_proc(void *arg)
 {
+	exacct_proc_commit_t *epc = arg;
+	zone_t *zone = epc->epc_zone;
+	struct exacct_globals *acg, *gacg;
 	size_t size;
-	proc_usage_t *pu;
-	ulong_t mask[AC_MASK_SZ];
 
-	mutex_enter(&ac_proc->ac_lock);
-	if (ac_proc->ac_state == AC_ON) {
-		bt_copy(&ac_proc->ac_mask[0], mask, AC_MASK_SZ);
-		mutex_exit(&ac_proc->ac_lock);
-	} else {
-		mutex_exit(&ac_proc->ac_lock);
-		return;
+	/*
+	 * The zone may have entered the down state since the snapshot was
+	 * taken, in which case zone_getspecific() can return NULL and the
+	 * record is discarded.  The per-file masks are applied at assembly
+	 * time, so a snapshot taken under one mask setting remains usable
+	 * for both the local and global zone accounting files.
+	 */
+	acg = zone_getspecific(exacct_zone_key, zone);
+	if (acg != NULL) {
+		(void) exacct_assemble_proc_usage(&acg->ac_proc,
+		    &epc->epc_usage, exacct_commit_callback, NULL, 0,
+		    &size, EW_FINAL);
 	}
-
-	mutex_enter(&p->p_lock);
-	size = strlen(p->p_user.u_comm) + 1;
-	mutex_exit(&p->p_lock);
-
-	pu = kmem_alloc(sizeof (proc_usage_t), KM_SLEEP);
-	pu->pu_command = kmem_alloc(size, KM_SLEEP);
-	mutex_enter(&p->p_lock);
-	exacct_calculate_proc_usage(p, pu, mask, EW_FINAL, wstat);
-	mutex_exit(&p->p_lock);
-
-	(void) exacct_assemble_proc_usage(ac_proc, pu,
-	    exacct_commit_callback, NULL, 0, &size, EW_FINAL);
-
-	kmem_free(pu->pu_command, strlen(pu->pu_command) + 1);
-	kmem_free(pu, sizeof (proc_usage_t));
+	if (zone != global_zone) {
+		gacg = zone_getspecific(exacct_zone_key, global_zone);
+		if (gacg != NULL) {
+			(void) exacct_assemble_proc_usage(&gacg->ac_proc,
+			    &epc->epc_usage, exacct_commit_callback,
+			    NULL, 0, &size, EW_FINAL);
+		}
+	}
+	zone_rele(zone);
+	kmem_free(epc, sizeof (exacct_proc_commit_t));
 }
 
 /*
  * void exacct_commit_proc(proc_t *, int)
  *
  * Overview
- *   exacct_commit_proc() calculates the final usage for a process, updating the
- *   task usage if task accounting is active, and writing a process record if
- *   process accounting is active.  exacct_commit_proc() is intended for being
- *   called from proc_exit().
+ *   exacct_commit_proc() calculates the final usage for a process and, if
+ *   process accounting is active, queues it for commitment to the
+ *   appropriate accounting file(s) by the exacct task queue.
+ *   exacct_commit_proc() is intended for being called from proc_exit().
  *
  * Return values
  *   None.
@@ -1153,7 +1166,10 @@ void
 exacct_commit_proc(proc_t *p, int wstat)
 {
 	zone_t *zone = p->p_zone;
-	struct exacct_globals *acg, *gacg = NULL;
+	struct exacct_globals *acg, *gacg;
+	exacct_proc_commit_t *epc;
+	boolean_t commit;
+	ulong_t mask[AC_MASK_SZ];
 
 	if (exacct_zone_key == ZONE_KEY_UNINITIALIZED) {
 		/*
@@ -1169,11 +1185,41 @@ exacct_commit_proc(proc_t *p, int wstat)
 	acg = zone_getspecific(exacct_zone_key, zone);
 	if (acg == NULL)
 		return;
-	exacct_do_commit_proc(&acg->ac_proc, p, wstat);
-	if (zone != global_zone) {
-		gacg = zone_getspecific(exacct_zone_key, global_zone);
-		exacct_do_commit_proc(&gacg->ac_proc, p, wstat);
+
+	/*
+	 * Don't bother snapshotting the usage unless at least one of the
+	 * affected accounting files is accepting records.
+	 */
+	mutex_enter(&acg->ac_proc.ac_lock);
+	commit = (acg->ac_proc.ac_state == AC_ON);
+	mutex_exit(&acg->ac_proc.ac_lock);
+	if (!commit && zone != global_zone &&
+	    (gacg = zone_getspecific(exacct_zone_key, global_zone)) != NULL) {
+		mutex_enter(&gacg->ac_proc.ac_lock);
+		commit = (gacg->ac_proc.ac_state == AC_ON);
+		mutex_exit(&gacg->ac_proc.ac_lock);
 	}
+	if (!commit)
+		return;
+
+	epc = kmem_zalloc(sizeof (exacct_proc_commit_t), KM_SLEEP);
+	epc->epc_usage.pu_command = epc->epc_command;
+
+	/*
+	 * Calculate all of the masked quantities; the individual files'
+	 * masks are applied when the records are assembled for writing.
+	 */
+	bzero(mask, sizeof (mask));
+	BT_SET(mask, AC_PROC_CPU);
+	BT_SET(mask, AC_PROC_TIME);
+	mutex_enter(&p->p_lock);
+	exacct_calculate_proc_usage(p, &epc->epc_usage, mask, EW_FINAL, wstat);
+	mutex_exit(&p->p_lock);
+
+	zone_hold(zone);
+	epc->epc_zone = zone;
+	(void) taskq_dispatch(exacct_queue, exacct_do_commit_proc, epc,
+	    TQ_SLEEP);
 }
 
 static int
@@ -262,6 +262,17 @@ fd_find(uf_info_t *fip, int minfd)
 	ASSERT(MUTEX_HELD(&fip->fi_lock));
 	ASSERT((fip->fi_nfiles & (fip->fi_nfiles + 1)) == 0);
 
+	/*
+	 * Every descriptor below fi_minfd is known to be allocated (see
+	 * fd_reserve()), so there's no point searching below it.  In a
+	 * process with a large, densely-populated descriptor table this
+	 * skips the initial ascent through the full low subtrees, which
+	 * otherwise reads a chain of nodes that every other allocation
+	 * and free is busy writing.
+	 */
+	if (minfd < fip->fi_minfd)
+		minfd = fip->fi_minfd;
+
 	for (fd = minfd; (uint_t)fd < fip->fi_nfiles; fd |= fd + 1) {
 		size = fd ^ (fd | (fd + 1));
 		if (fip->fi_list[fd].uf_alloc == size)
@@ -293,6 +304,22 @@ fd_reserve(uf_info_t *fip, int fd, int incr)
 	for (pfd = fd; pfd >= 0; pfd = (pfd & (pfd + 1)) - 1)
 		fip->fi_list[pfd].uf_alloc += incr;
 
+	/*
+	 * Maintain fi_minfd, a lower bound on the smallest free descriptor:
+	 * everything below it is allocated.  Allocating the bound itself
+	 * pushes it up by one (all lower fds were already allocated); freeing
+	 * anything below it pulls it back down.  After a free the bound is
+	 * exact, so the open/close churn of a busy server usually finds its
+	 * descriptor right at fi_minfd.
+	 */
+	if (incr == 1) {
+		if (fd == fip->fi_minfd)
+			fip->fi_minfd = fd + 1;
+	} else {
+		if (fd < fip->fi_minfd)
+			fip->fi_minfd = fd;
+	}
+
 	ufp->uf_busy += incr;
 }
 
@@ -861,6 +888,7 @@ flist_fork(uf_info_t *pfip, uf_info_t *cfip)
 	 * parent have been held.
 	 */
 	cfip->fi_nfiles = nfiles = flist_minsize(pfip);
+	cfip->fi_minfd = pfip->fi_minfd;
 
 	cfip->fi_list = nfiles == 0 ? NULL :
 	    kmem_zalloc(nfiles * sizeof (uf_entry_t), KM_SLEEP);
@@ -919,6 +947,7 @@ closeall(uf_info_t *fip)
 	kmem_free(fip->fi_list, fip->fi_nfiles * sizeof (uf_entry_t));
 	fip->fi_list = NULL;
 	fip->fi_nfiles = 0;
+	fip->fi_minfd = 0;
 	while (fip->fi_rlist != NULL) {
 		uf_rlist_t *urp = fip->fi_rlist;
 		fip->fi_rlist = urp->ur_next;
@@ -1239,6 +1239,8 @@ getproc(proc_t **cpp, pid_t pid, uint_t flags)
 	 */
 	cp->p_fixalignment = pp->p_fixalignment;
 
+	atomic_inc_32(&zone->zone_forks);
+
 	*cpp = cp;
 	return (0);
 
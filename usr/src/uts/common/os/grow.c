@@ -611,11 +611,20 @@ zmap(struct as *as, caddr_t *addrp, size_t len, uint_t uprot, int flags,
 	 * No need to worry about vac alignment for anonymous
 	 * pages since this is a "clone" object that doesn't
 	 * yet exist.
+	 *
+	 * Once an address is chosen, narrow the whole-address-space
+	 * claim down to just that range so that other threads can
+	 * search for their own addresses while we build the mapping.
 	 */
-	error = choose_addr(as, addrp, len, pos, ADDR_NOVACALIGN, flags);
-	if (error != 0) {
-		return (error);
-	}
+	as_rangelock(as);
+	do {
+		error = choose_addr(as, addrp, len, pos, ADDR_NOVACALIGN,
+		    flags);
+		if (error != 0) {
+			as_rangeunlock(as);
+			return (error);
+		}
+	} while (!as_rangeclaim(as, *addrp, len));
 
 	/*
 	 * Use the seg_vn segment driver; passing in the NULL amp
@@ -632,7 +641,9 @@ zmap(struct as *as, caddr_t *addrp, size_t len, uint_t uprot, int flags,
 	vn_a.szc = 0;
 	vn_a.lgrp_mem_policy_flags = 0;
 
-	return (as_map(as, *addrp, len, segvn_create, &vn_a));
+	error = as_map(as, *addrp, len, segvn_create, &vn_a);
+	as_rangeunclaim(as, *addrp, len);
+	return (error);
 }
 
 #define	RANDOMIZABLE_MAPPING(addr, flags) (((flags & MAP_FIXED) == 0) && \
@@ -718,9 +729,8 @@ smmap_common(caddr_t *addrp, size_t len,
 		/* discard lwpchan mappings, like munmap() */
 		if ((flags & MAP_FIXED) && curproc->p_lcp != NULL)
 			lwpchan_delete_mapping(curproc, *addrp, *addrp + len);
-		as_rangelock(as);
+		/* zmap() does its own range locking */
 		error = zmap(as, addrp, len, uprot, flags, pos);
-		as_rangeunlock(as);
 		/*
 		 * Tell machine specific code that lwp has mapped shared memory
 		 */
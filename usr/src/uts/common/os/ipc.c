@@ -418,6 +418,7 @@
 #include <sys/zone.h>
 #include <sys/task.h>
 #include <sys/modctl.h>
+#include <sys/kstat.h>
 
 #include <c2/audit.h>
 
@@ -633,6 +634,38 @@ ipc_key_compar(const void *a, const void *b)
 	return (0);
 }
 
+/*
+ * Sum the contended lock acquisition counts over the service's slot
+ * table, including any stale arrays left over from table resizes, whose
+ * counters are frozen but still part of the service's history.
+ */
+static int
+ipcs_kstat_update(kstat_t *ksp, int rw)
+{
+	ipc_service_t *service = ksp->ks_private;
+	kstat_named_t *kn = ksp->ks_data;
+	ipc_slot_t *slot, *next;
+	uint64_t total = 0;
+	uint_t tabsz;
+	uint_t i;
+
+	if (rw == KSTAT_WRITE)
+		return (EACCES);
+
+	mutex_enter(&service->ipcs_lock);
+	tabsz = service->ipcs_tabsz;
+	for (slot = service->ipcs_table; slot != NULL; slot = next) {
+		for (i = 0; i < tabsz; i++)
+			total += slot[i].ipct_contended;
+		next = slot[0].ipct_chain;
+		tabsz >>= 1;
+	}
+	mutex_exit(&service->ipcs_lock);
+
+	kn->value.ui64 = total;
+	return (0);
+}
+
 /*
  * Create an ipc service.
  */
@@ -663,6 +696,16 @@ ipcs_create(const char *name, rctl_hndl_t proj_rctl, rctl_hndl_t zone_rctl,
 	list_create(&result->ipcs_usedids, sizeof (kipc_perm_t),
 	    offsetof(kipc_perm_t, ipc_list));
 
+	result->ipcs_kstat = kstat_create("ipc", 0, name, "misc",
+	    KSTAT_TYPE_NAMED, 1, 0);
+	if (result->ipcs_kstat != NULL) {
+		kstat_named_init(result->ipcs_kstat->ks_data,
+		    "lock_contended", KSTAT_DATA_UINT64);
+		result->ipcs_kstat->ks_update = ipcs_kstat_update;
+		result->ipcs_kstat->ks_private = result;
+		kstat_install(result->ipcs_kstat);
+	}
+
 	return (result);
 }
 
@@ -674,6 +717,9 @@ ipcs_destroy(ipc_service_t *service)
 {
 	ipc_slot_t *slot, *next;
 
+	if (service->ipcs_kstat != NULL)
+		kstat_delete(service->ipcs_kstat);
+
 	mutex_enter(&service->ipcs_lock);
 
 	ASSERT(service->ipcs_count == 0);
@@ -725,7 +771,17 @@ ipc_lock_internal(ipc_service_t *service, uint_t id)
 		membar_consumer();
 		index = id & (tabsz - 1);
 		mutex = &service->ipcs_table[index].ipct_lock;
-		mutex_enter(mutex);
+		/*
+		 * Count contended acquisitions so that heavily shared
+		 * ids (e.g. hot semaphore sets) show up in the
+		 * service's kstat.  An uncontended tryenter costs the
+		 * same as a plain mutex_enter.
+		 */
+		if (!mutex_tryenter(mutex)) {
+			atomic_inc_64(&service->ipcs_table[index].
+			    ipct_contended);
+			mutex_enter(mutex);
+		}
 		if (tabsz == service->ipcs_tabsz)
 			break;
 		mutex_exit(mutex);
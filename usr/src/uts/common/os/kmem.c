@@ -861,6 +861,8 @@ struct kmem_cache_kstat {
 	kstat_named_t	kmc_depot_alloc;
 	kstat_named_t	kmc_depot_free;
 	kstat_named_t	kmc_depot_contention;
+	kstat_named_t	kmc_depot_fill_local;	/* refills from home lgroup */
+	kstat_named_t	kmc_depot_fill_remote;	/* cross-lgroup refills */
 	kstat_named_t	kmc_slab_alloc;
 	kstat_named_t	kmc_slab_free;
 	kstat_named_t	kmc_buf_constructed;
@@ -900,6 +902,8 @@ struct kmem_cache_kstat {
 	{ "depot_alloc",	KSTAT_DATA_UINT64 },
 	{ "depot_free",		KSTAT_DATA_UINT64 },
 	{ "depot_contention",	KSTAT_DATA_UINT64 },
+	{ "depot_fill_local",	KSTAT_DATA_UINT64 },
+	{ "depot_fill_remote",	KSTAT_DATA_UINT64 },
 	{ "slab_alloc",		KSTAT_DATA_UINT64 },
 	{ "slab_free",		KSTAT_DATA_UINT64 },
 	{ "buf_constructed",	KSTAT_DATA_UINT64 },
@@ -1019,6 +1023,15 @@ size_t kmem_lite_maxalign = 1024; /* maximum buffer alignment for KMF_LITE */
 int kmem_lite_pcs = 4;		/* number of PCs to store in KMF_LITE mode */
 size_t kmem_maxverify;		/* maximum bytes to inspect in debug routines */
 size_t kmem_minfirewall;	/* hardware-enforced redzone threshold */
+size_t kmem_va_qcache_max;	/* kmem_va quantum caching limit [16 pages] */
+
+/*
+ * Sampling rate for per-zone allocation attribution on caches tagged
+ * with kmem_cache_set_zone_class().  1 bills every allocation; N > 1
+ * bills every Nth allocation (scaled by N) per CPU, trading accuracy
+ * for less counter traffic; 0 disables attribution entirely.
+ */
+int kmem_zone_attr_sample = 1;
 
 #ifdef DEBUG
 int kmem_warn_zerosized = 1;	/* whether to warn on zero-sized KM_SLEEP */
@@ -2119,15 +2132,90 @@ kmem_depot_free(kmem_cache_t *cp, kmem_maglist_t *mlp, kmem_magazine_t *mp)
 	mutex_exit(&cp->cache_depot_lock);
 }
 
+/*
+ * Home lgroup of the executing CPU, used to pick a depot full-magazine
+ * list.  Before the lgroup hierarchy is built everything maps to the
+ * root lgroup.
+ */
+static int
+kmem_depot_lgrp(void)
+{
+	lpl_t *lpl = CPU->cpu_lpl;
+
+	return (lpl == NULL ? LGRP_ROOTID : (int)lpl->lpl_lgrpid);
+}
+
+/*
+ * Allocate a full magazine, preferring the executing CPU's home lgroup.
+ * Full magazines are returned to the depot list of the lgroup whose CPU
+ * freed them, so the home list hands back object memory that was last
+ * touched on this node.  Other lgroups' lists are raided only when the
+ * home list is empty; the cache's kstats report the local/remote split.
+ */
+static kmem_magazine_t *
+kmem_depot_alloc_full(kmem_cache_t *cp)
+{
+	kmem_magazine_t *mp;
+	int home = kmem_depot_lgrp();
+	int lgrp;
+
+	if ((mp = kmem_depot_alloc(cp, &cp->cache_full[home])) != NULL) {
+		atomic_inc_64(&cp->cache_depot_local);
+		return (mp);
+	}
+
+	for (lgrp = 0; lgrp <= lgrp_alloc_max; lgrp++) {
+		if (lgrp == home)
+			continue;
+		if ((mp = kmem_depot_alloc(cp,
+		    &cp->cache_full[lgrp])) != NULL) {
+			atomic_inc_64(&cp->cache_depot_remote);
+			return (mp);
+		}
+	}
+
+	return (NULL);
+}
+
+/*
+ * Free a full magazine to the depot list of the executing CPU's lgroup.
+ */
+static void
+kmem_depot_free_full(kmem_cache_t *cp, kmem_magazine_t *mp)
+{
+	kmem_depot_free(cp, &cp->cache_full[kmem_depot_lgrp()], mp);
+}
+
+/*
+ * Sum of ml_total over all of the depot's full magazine lists.  Like the
+ * old single-list ml_total reads, callers that want only an estimate may
+ * call this without cache_depot_lock.
+ */
+static long
+kmem_depot_full_total(kmem_cache_t *cp)
+{
+	long total = 0;
+	int lgrp;
+
+	for (lgrp = 0; lgrp < NLGRPS_MAX; lgrp++)
+		total += cp->cache_full[lgrp].ml_total;
+
+	return (total);
+}
+
 /*
  * Update the working set statistics for cp's depot.
  */
 static void
 kmem_depot_ws_update(kmem_cache_t *cp)
 {
+	int lgrp;
+
 	mutex_enter(&cp->cache_depot_lock);
-	cp->cache_full.ml_reaplimit = cp->cache_full.ml_min;
-	cp->cache_full.ml_min = cp->cache_full.ml_total;
+	for (lgrp = 0; lgrp < NLGRPS_MAX; lgrp++) {
+		cp->cache_full[lgrp].ml_reaplimit = cp->cache_full[lgrp].ml_min;
+		cp->cache_full[lgrp].ml_min = cp->cache_full[lgrp].ml_total;
+	}
 	cp->cache_empty.ml_reaplimit = cp->cache_empty.ml_min;
 	cp->cache_empty.ml_min = cp->cache_empty.ml_total;
 	mutex_exit(&cp->cache_depot_lock);
@@ -2140,9 +2228,14 @@ kmem_depot_ws_update(kmem_cache_t *cp)
 static void
 kmem_depot_ws_zero(kmem_cache_t *cp)
 {
+	int lgrp;
+
 	mutex_enter(&cp->cache_depot_lock);
-	cp->cache_full.ml_reaplimit = cp->cache_full.ml_total;
-	cp->cache_full.ml_min = cp->cache_full.ml_total;
+	for (lgrp = 0; lgrp < NLGRPS_MAX; lgrp++) {
+		cp->cache_full[lgrp].ml_reaplimit =
+		    cp->cache_full[lgrp].ml_total;
+		cp->cache_full[lgrp].ml_min = cp->cache_full[lgrp].ml_total;
+	}
 	cp->cache_empty.ml_reaplimit = cp->cache_empty.ml_total;
 	cp->cache_empty.ml_min = cp->cache_empty.ml_total;
 	mutex_exit(&cp->cache_depot_lock);
@@ -2164,18 +2257,25 @@ kmem_depot_ws_reap(kmem_cache_t *cp)
 	size_t bytes = 0;
 	long reap;
 	kmem_magazine_t *mp;
+	int lgrp;
 
 	ASSERT(!list_link_active(&cp->cache_link) ||
 	    taskq_member(kmem_taskq, curthread));
 
-	reap = MIN(cp->cache_full.ml_reaplimit, cp->cache_full.ml_min);
-	while (reap-- &&
-	    (mp = kmem_depot_alloc(cp, &cp->cache_full)) != NULL) {
-		kmem_magazine_destroy(cp, mp, cp->cache_magtype->mt_magsize);
-		bytes += cp->cache_magtype->mt_magsize * cp->cache_bufsize;
-		if (bytes > kmem_reap_preempt_bytes) {
-			kpreempt(KPREEMPT_SYNC);
-			bytes = 0;
+	for (lgrp = 0; lgrp < NLGRPS_MAX; lgrp++) {
+		kmem_maglist_t *mlp = &cp->cache_full[lgrp];
+
+		reap = MIN(mlp->ml_reaplimit, mlp->ml_min);
+		while (reap-- &&
+		    (mp = kmem_depot_alloc(cp, mlp)) != NULL) {
+			kmem_magazine_destroy(cp, mp,
+			    cp->cache_magtype->mt_magsize);
+			bytes += cp->cache_magtype->mt_magsize *
+			    cp->cache_bufsize;
+			if (bytes > kmem_reap_preempt_bytes) {
+				kpreempt(KPREEMPT_SYNC);
+				bytes = 0;
+			}
 		}
 	}
 
@@ -2421,6 +2521,26 @@ kmem_cache_free_dump(kmem_cache_t *cp, void *buf)
 	return (1);
 }
 
+/*
+ * Bill an allocation from an attributed cache to the allocating zone.
+ * Called with the CPU cache lock held, which protects the per-CPU
+ * sample counter.
+ */
+static void
+kmem_zone_attribute(kmem_cache_t *cp, kmem_cpu_cache_t *ccp)
+{
+	int sample = kmem_zone_attr_sample;
+
+	if (sample <= 0)
+		return;
+	if (sample > 1) {
+		if (++ccp->cc_zclass_tick < sample)
+			return;
+		ccp->cc_zclass_tick = 0;
+	}
+	zone_kmem_bill(cp->cache_zclass, (uint64_t)sample);
+}
+
 /*
  * Allocate a constructed object from cache cp.
  */
@@ -2432,6 +2552,8 @@ kmem_cache_alloc(kmem_cache_t *cp, int kmflag)
 	void *buf;
 
 	mutex_enter(&ccp->cc_lock);
+	if (cp->cache_zclass != 0)
+		kmem_zone_attribute(cp, ccp);
 	for (;;) {
 		/*
 		 * If there's an object available in the current CPU's
@@ -2494,9 +2616,10 @@ kmem_cache_alloc(kmem_cache_t *cp, int kmflag)
 			break;
 
 		/*
-		 * Try to get a full magazine from the depot.
+		 * Try to get a full magazine from the depot, preferring
+		 * the executing CPU's home lgroup.
 		 */
-		fmp = kmem_depot_alloc(cp, &cp->cache_full);
+		fmp = kmem_depot_alloc_full(cp);
 		if (fmp != NULL) {
 			if (ccp->cc_ploaded != NULL)
 				kmem_depot_free(cp, &cp->cache_empty,
@@ -2606,8 +2729,7 @@ kmem_cpucache_magazine_alloc(kmem_cpu_cache_t *ccp, kmem_cache_t *cp)
 	emp = kmem_depot_alloc(cp, &cp->cache_empty);
 	if (emp != NULL) {
 		if (ccp->cc_ploaded != NULL)
-			kmem_depot_free(cp, &cp->cache_full,
-			    ccp->cc_ploaded);
+			kmem_depot_free_full(cp, ccp->cc_ploaded);
 		kmem_cpu_reload(ccp, emp, 0);
 		return (1);
 	}
@@ -3057,18 +3179,20 @@ kmem_cache_reap(kmem_cache_t *cp)
 	 */
 	if (cp->cache_reclaim != NULL) {
 		long delta;
+		int home = kmem_depot_lgrp();
 
 		/*
 		 * Reclaimed memory should be reapable (not included in the
-		 * depot's working set).
+		 * depot's working set).  The reclaim callback runs on this
+		 * CPU, so the freed magazines land on its home lgroup list.
 		 */
-		delta = cp->cache_full.ml_total;
+		delta = kmem_depot_full_total(cp);
 		cp->cache_reclaim(cp->cache_private);
-		delta = cp->cache_full.ml_total - delta;
+		delta = kmem_depot_full_total(cp) - delta;
 		if (delta > 0) {
 			mutex_enter(&cp->cache_depot_lock);
-			cp->cache_full.ml_reaplimit += delta;
-			cp->cache_full.ml_min += delta;
+			cp->cache_full[home].ml_reaplimit += delta;
+			cp->cache_full[home].ml_min += delta;
 			mutex_exit(&cp->cache_depot_lock);
 		}
 	}
@@ -3402,6 +3526,60 @@ kmem_cache_update(kmem_cache_t *cp)
 
 static void kmem_update(void *);
 
+/*
+ * Predictive memory pressure detection.  kmem_reap() is normally driven
+ * reactively from the page allocation paths: by the time freemem has
+ * fallen below lotsfree, allocation latency has already spiked.  Each
+ * time kmem_update() runs we sample freemem and maintain a smoothed
+ * estimate of the rate at which it is falling.  If the current trend
+ * would take freemem below lotsfree within kmem_pressure_lookahead
+ * update intervals, we start a reap immediately, spreading the reclaim
+ * cost over time instead of paying it all at the throttle point.  The
+ * reap invokes the reclaim callbacks registered by caches (such as the
+ * ZFS ARC) as usual, and remains self-throttled by kmem_reaping, so a
+ * mispredicted reap costs at most one pass over the depot working sets.
+ * Set kmem_pressure_predict to zero to disable prediction entirely.
+ */
+int kmem_pressure_predict = 1;
+int kmem_pressure_lookahead = 4;	/* forecast horizon, in intervals */
+static pgcnt_t kmem_pressure_freemem;	/* freemem at last update */
+static pgcnt_t kmem_pressure_velocity;	/* pages consumed per interval */
+static uint64_t kmem_pressure_reaps;	/* predictive reaps initiated */
+
+static void
+kmem_pressure_update(void)
+{
+	pgcnt_t fmem = freemem;
+	pgcnt_t delta;
+
+	if (kmem_pressure_freemem == 0) {
+		kmem_pressure_freemem = fmem;
+		return;
+	}
+
+	delta = (kmem_pressure_freemem > fmem) ?
+	    kmem_pressure_freemem - fmem : 0;
+	kmem_pressure_freemem = fmem;
+
+	/*
+	 * Exponential moving average with a weight of 1/4: heavy enough
+	 * smoothing that a single allocation burst doesn't trigger a
+	 * reap, light enough to react within a few intervals to a
+	 * sustained downward trend.
+	 */
+	kmem_pressure_velocity =
+	    (3 * kmem_pressure_velocity + delta) / 4;
+
+	if (kmem_pressure_velocity == 0)
+		return;
+
+	if (fmem < lotsfree + needfree +
+	    kmem_pressure_velocity * kmem_pressure_lookahead) {
+		kmem_pressure_reaps++;
+		kmem_reap();
+	}
+}
+
 static void
 kmem_update_timeout(void *dummy)
 {
@@ -3411,6 +3589,9 @@ kmem_update_timeout(void *dummy)
 static void
 kmem_update(void *dummy)
 {
+	if (kmem_pressure_predict)
+		kmem_pressure_update();
+
 	kmem_cache_applyall(kmem_cache_update, NULL, TQ_NOSLEEP);
 
 	/*
@@ -3430,7 +3611,10 @@ kmem_cache_kstat_update(kstat_t *ksp, int rw)
 	kmem_cache_t *cp = ksp->ks_private;
 	uint64_t cpu_buf_avail;
 	uint64_t buf_avail = 0;
+	uint64_t full_alloc;
+	long full_total;
 	int cpu_seqid;
+	int lgrp;
 	long reap;
 
 	ASSERT(MUTEX_HELD(&kmem_cache_kstat_lock));
@@ -3466,21 +3650,32 @@ kmem_cache_kstat_update(kstat_t *ksp, int rw)
 
 	mutex_enter(&cp->cache_depot_lock);
 
-	kmcp->kmc_depot_alloc.value.ui64	= cp->cache_full.ml_alloc;
+	full_alloc = full_total = 0;
+	reap = 0;
+	for (lgrp = 0; lgrp < NLGRPS_MAX; lgrp++) {
+		kmem_maglist_t *mlp = &cp->cache_full[lgrp];
+		long lreap;
+
+		full_alloc += mlp->ml_alloc;
+		full_total += mlp->ml_total;
+		lreap = MIN(mlp->ml_reaplimit, mlp->ml_min);
+		reap += MIN(lreap, mlp->ml_total);
+	}
+
+	kmcp->kmc_depot_alloc.value.ui64	= full_alloc;
 	kmcp->kmc_depot_free.value.ui64		= cp->cache_empty.ml_alloc;
 	kmcp->kmc_depot_contention.value.ui64	= cp->cache_depot_contention;
-	kmcp->kmc_full_magazines.value.ui64	= cp->cache_full.ml_total;
+	kmcp->kmc_depot_fill_local.value.ui64	= cp->cache_depot_local;
+	kmcp->kmc_depot_fill_remote.value.ui64	= cp->cache_depot_remote;
+	kmcp->kmc_full_magazines.value.ui64	= full_total;
 	kmcp->kmc_empty_magazines.value.ui64	= cp->cache_empty.ml_total;
 	kmcp->kmc_magazine_size.value.ui64	=
 	    (cp->cache_flags & KMF_NOMAGAZINE) ?
 	    0 : cp->cache_magtype->mt_magsize;
 
-	kmcp->kmc_alloc.value.ui64		+= cp->cache_full.ml_alloc;
+	kmcp->kmc_alloc.value.ui64		+= full_alloc;
 	kmcp->kmc_free.value.ui64		+= cp->cache_empty.ml_alloc;
-	buf_avail += cp->cache_full.ml_total * cp->cache_magtype->mt_magsize;
-
-	reap = MIN(cp->cache_full.ml_reaplimit, cp->cache_full.ml_min);
-	reap = MIN(reap, cp->cache_full.ml_total);
+	buf_avail += full_total * cp->cache_magtype->mt_magsize;
 
 	mutex_exit(&cp->cache_depot_lock);
 
@@ -4081,6 +4276,22 @@ kmem_cache_set_move(kmem_cache_t *cp,
 	}
 }
 
+/*
+ * Tag a cache so that allocations from it are billed to the allocating
+ * zone's ZONE_KMEM_CLASS_* counter (see zone_kmem_bill()).  Intended
+ * for caches whose consumption is driven directly by tenant workloads;
+ * attribution is by the zone of the allocating thread, which for
+ * interrupt-time allocations may be the zone that happened to be on
+ * CPU.
+ */
+void
+kmem_cache_set_zone_class(kmem_cache_t *cp, uint_t zclass)
+{
+	ASSERT(zclass >= 1 && zclass <= ZONE_KMEM_NCLASSES);
+
+	cp->cache_zclass = zclass;
+}
+
 void
 kmem_cache_destroy(kmem_cache_t *cp)
 {
@@ -4228,10 +4439,22 @@ kmem_cache_init(int pass, int use_large_pages)
 	    kmem_msb_arena, KMC_NOHASH);
 
 	if (pass == 2) {
+		/*
+		 * Quantum caching for kmem_va keeps the most common slab
+		 * sizes out of the kmem_va and heap arena locks.  Cover
+		 * the full range the quantum cache mechanism permits
+		 * (VMEM_NQCACHE_MAX quanta); slab allocations above the
+		 * quantum cache limit serialize on both arena locks,
+		 * which shows up under heavy kmem churn such as ZFS
+		 * metadata workloads.
+		 */
+		if (kmem_va_qcache_max == 0)
+			kmem_va_qcache_max = VMEM_NQCACHE_MAX * PAGESIZE;
+
 		kmem_va_arena = vmem_create("kmem_va",
 		    NULL, 0, PAGESIZE,
 		    vmem_alloc, vmem_free, heap_arena,
-		    8 * PAGESIZE, VM_SLEEP);
+		    kmem_va_qcache_max, VM_SLEEP);
 
 		if (use_large_pages) {
 			kmem_default_arena = vmem_xcreate("kmem_default",
@@ -5326,11 +5549,17 @@ kmem_cache_is_fragmented(kmem_cache_t *cp, boolean_t *doreap)
 	 * have fallen out of the working set.
 	 */
 	if (!fragmented) {
-		long reap;
+		long reap = 0;
+		int lgrp;
 
 		mutex_enter(&cp->cache_depot_lock);
-		reap = MIN(cp->cache_full.ml_reaplimit, cp->cache_full.ml_min);
-		reap = MIN(reap, cp->cache_full.ml_total);
+		for (lgrp = 0; lgrp < NLGRPS_MAX; lgrp++) {
+			kmem_maglist_t *mlp = &cp->cache_full[lgrp];
+			long lreap;
+
+			lreap = MIN(mlp->ml_reaplimit, mlp->ml_min);
+			reap += MIN(lreap, mlp->ml_total);
+		}
 		mutex_exit(&cp->cache_depot_lock);
 
 		nfree += ((uint64_t)reap * cp->cache_magtype->mt_magsize);
@@ -415,6 +415,54 @@ kstat_hold_bykid(kid_t kid, zoneid_t zoneid)
 	return (kstat_hold(&kstat_avl_bykid, &e));
 }
 
+/*
+ * Return (held) the kstat with the smallest KID strictly greater than the
+ * given KID that is visible in the given zone, or NULL if there is none.
+ * This lets the /dev/kstat bulk-read ioctl traverse the entire chain one
+ * kstat at a time without holding kstat_chain_lock across anyone's update
+ * or snapshot routine.
+ */
+kstat_t *
+kstat_hold_next(kid_t kid, zoneid_t zoneid)
+{
+	kstat_t *ksp;
+	ekstat_t template, *e;
+	avl_index_t where;
+
+	template.e_ks.ks_kid = kid;
+	template.e_zone.zoneid = zoneid;
+	template.e_zone.next = NULL;
+
+	mutex_enter(&kstat_chain_lock);
+	for (;;) {
+		ksp = avl_find(&kstat_avl_bykid, &template, &where);
+		if (ksp != NULL)
+			ksp = AVL_NEXT(&kstat_avl_bykid, ksp);
+		else
+			ksp = avl_nearest(&kstat_avl_bykid, where, AVL_AFTER);
+
+		while (ksp != NULL && !kstat_zone_find(ksp, zoneid))
+			ksp = AVL_NEXT(&kstat_avl_bykid, ksp);
+
+		if (ksp == NULL)
+			break;
+
+		e = (ekstat_t *)ksp;
+		if (e->e_owner == NULL) {
+			e->e_owner = curthread;
+			break;
+		}
+
+		/*
+		 * Someone else holds it; wait and then search again from
+		 * the same KID, since the tree may have changed.
+		 */
+		cv_wait(&e->e_cv, &kstat_chain_lock);
+	}
+	mutex_exit(&kstat_chain_lock);
+	return (ksp);
+}
+
 kstat_t *
 kstat_hold_byname(const char *ks_module, int ks_instance, const char *ks_name,
     zoneid_t ks_zoneid)
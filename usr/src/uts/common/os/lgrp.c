@@ -182,6 +182,16 @@ size_t	lgrp_privm_random_thresh = (size_t)(-1);
 	((lgrp_loadavg_max_effect) / (ncpu))
 uint32_t	lgrp_loadavg_max_effect = LGRP_LOADAVG_THREAD_MAX;
 
+/*
+ * Per-lgroup 1, 5 and 15 minute load averages in the same internal
+ * high-precision representation as the system-wide hp_avenrun.  They
+ * are updated once per second by lgrp_calcloadavg() in clock() from
+ * the instantaneous leaf lgroup loads maintained by lgrp_loadavg(),
+ * and exported in FSCALE units through the per-lgroup kstats for
+ * locality-aware placement tools.
+ */
+uint64_t	lgrp_hp_avenrun[NLGRPS_MAX][3];
+
 
 /*
  * Size, in bytes, beyond which random memory allocation policy is applied to
@@ -1761,6 +1771,9 @@ lgrp_kstat_extract(kstat_t *ksp, int rw)
 		ksd[stat + LGRP_NUM_PG_AVAIL].value.i64 = 0;
 		ksd[stat + LGRP_NUM_PG_FREE].value.i64 = 0;
 		ksd[stat + LGRP_LOADAVG].value.i64 = 0;
+		ksd[stat + LGRP_LOADAVG_1MIN].value.i64 = 0;
+		ksd[stat + LGRP_LOADAVG_5MIN].value.i64 = 0;
+		ksd[stat + LGRP_LOADAVG_15MIN].value.i64 = 0;
 	} else if (rw != KSTAT_WRITE) {
 		/*
 		 * Handle counter stats
@@ -1782,6 +1795,12 @@ lgrp_kstat_extract(kstat_t *ksp, int rw)
 		ksd[stat + LGRP_LOADAVG].value.i64 = lgrp_sum_loadavgs(lgrp);
 		ksd[stat + LGRP_LOADAVG_SCALE].value.i64 =
 		    lgrp_loadavg_max_effect;
+		ksd[stat + LGRP_LOADAVG_1MIN].value.i64 =
+		    lgrp_hp_avenrun[lgrpid][0] >> (16 - FSHIFT);
+		ksd[stat + LGRP_LOADAVG_5MIN].value.i64 =
+		    lgrp_hp_avenrun[lgrpid][1] >> (16 - FSHIFT);
+		ksd[stat + LGRP_LOADAVG_15MIN].value.i64 =
+		    lgrp_hp_avenrun[lgrpid][2] >> (16 - FSHIFT);
 	} else {
 		lgrp_kstat_reset(lgrpid);
 	}
@@ -2678,6 +2697,13 @@ lgrp_part_del_cpu(cpu_t *cp)
 	/* don't delete a leaf that isn't there */
 	ASSERT(LGRP_EXISTS(lgrp_leaf));
 
+	/*
+	 * The CPU may be sitting idle when it is rehomed, so make sure it
+	 * doesn't linger in the old leaf's idle CPU set.
+	 */
+	if (bitset_capacity(&leaf_lpl->lpl_idleset) != 0)
+		bitset_atomic_del(&leaf_lpl->lpl_idleset, cp->cpu_seqid);
+
 	/* no double-deletes */
 	ASSERT(lpl->lpl_ncpu);
 	if (--lpl->lpl_ncpu == 0) {
@@ -2849,6 +2875,7 @@ lpl_topo_bootstrap(lpl_t *target, int size)
 	lpl_t	*target_lpl = target;
 	lpl_t	**rset;
 	int	*id2rset;
+	bitset_t idleset;
 	int	sz;
 	int	howmany;
 	int	id;
@@ -2866,18 +2893,21 @@ lpl_topo_bootstrap(lpl_t *target, int size)
 	for (i = 0; i < howmany; i++, lpl++, target_lpl++) {
 		/*
 		 * Copy all fields from lpl, except for the rset,
-		 * lgrp id <=> rset mapping storage,
-		 * and amount of storage
+		 * lgrp id <=> rset mapping storage, amount of storage,
+		 * and the idle CPU set (never allocated for the
+		 * bootstrap lpls)
 		 */
 		rset = target_lpl->lpl_rset;
 		id2rset = target_lpl->lpl_id2rset;
 		sz = target_lpl->lpl_rset_sz;
+		idleset = target_lpl->lpl_idleset;
 
 		*target_lpl = *lpl;
 
 		target_lpl->lpl_rset_sz = sz;
 		target_lpl->lpl_rset = rset;
 		target_lpl->lpl_id2rset = id2rset;
+		target_lpl->lpl_idleset = idleset;
 
 		/*
 		 * Substitute CPU0 lpl pointer with one relative to target.
@@ -672,6 +672,9 @@ main(void)
 	(void) thread_create(NULL, 0, seg_pasync_thread,
 	    NULL, 0, &p0, TS_RUN, minclsyspri);
 
+	(void) thread_create(NULL, 0, page_promote_thread,
+	    NULL, 0, &p0, TS_RUN, minclsyspri);
+
 	pid_setmin();
 
 	/* system is now ready */
@@ -46,6 +46,8 @@
 #include <sys/cmn_err.h>
 #include <vm/as.h>
 #include <vm/page.h>
+#include <vm/hat.h>
+#include <vm/seg_kpm.h>
 
 #include <sys/dcopy.h>
 
@@ -416,6 +418,17 @@ uiodup(uio_t *suio, uio_t *duio, iovec_t *diov, int diov_cnt)
  */
 uioasync_t uioasync = {B_FALSE, 1024};
 
+/*
+ * When set, uioainit() falls back to a software copy path if no
+ * hardware copy channel is available: uioamove() then copies into the
+ * locked-down destination pages through their kpm mappings.  This lets
+ * sodirect consumers move receive data into the application's buffer
+ * from kernel context (e.g. squeue worker threads) on machines without
+ * an offload engine, overlapping the copy with the application's own
+ * work.  Requires kpm; off by default.
+ */
+int uioa_swcopy = 0;
+
 void
 uioa_dcopy_enable()
 {
@@ -492,6 +505,29 @@ uioamove(void *p, size_t n, enum uio_rw rw, uioa_t *uioa)
 			cnt = MIN(cnt, PAGESIZE - doff);
 			/* XXX if next page(s) contiguous could use multipage */
 
+			if (channel == NULL) {
+				pfn_t	pfn;
+				caddr_t	kva;
+
+				/*
+				 * No hardware channel; copy into the
+				 * destination page through its kpm
+				 * mapping.
+				 */
+				if (uioa->uioa_lcur->uioa_pfncnt == 0) {
+					/* Have a (page_t **) */
+					pfn = (*(page_t **)
+					    uioa->uioa_lppp)->p_pagenum;
+				} else {
+					/* Have a (pfn_t *) */
+					pfn = *(pfn_t *)uioa->uioa_lppp;
+				}
+				kva = hat_kpm_mapin_pfn(pfn);
+				bcopy(p, kva + doff, cnt);
+				hat_kpm_mapout_pfn(pfn);
+				goto moved;
+			}
+
 			/*
 			 * if we have an old command, we want to link all
 			 * other commands to the next command we alloced so
@@ -541,6 +577,8 @@ uioamove(void *p, size_t n, enum uio_rw rw, uioa_t *uioa)
 			if (!(uioa->uioa_state & UIOA_POLL))
 				uioa->uioa_state |= UIOA_POLL;
 
+moved:
+
 			/* Update iov, uio, and local pointers/counters */
 			iov->iov_base += cnt;
 			iov->iov_len -= cnt;
@@ -594,14 +632,18 @@ uioainit(uio_t *uiop, uioa_t *uioap)
 	}
 
 	error = dcopy_alloc(DCOPY_NOSLEEP, &channel);
-	if (error == DCOPY_NORESOURCES) {
-		/* Turn off uioa */
-		uioasync.enabled = B_FALSE;
-		return (ENODEV);
-	}
 	if (error != DCOPY_SUCCESS) {
-		/* Alloc failed */
-		return (EIO);
+		if (uioa_swcopy && kpm_enable) {
+			/* No hardware channel; use the software copy path */
+			channel = NULL;
+		} else if (error == DCOPY_NORESOURCES) {
+			/* Turn off uioa */
+			uioasync.enabled = B_FALSE;
+			return (ENODEV);
+		} else {
+			/* Alloc failed */
+			return (EIO);
+		}
 	}
 
 	uioap->uioa_hwst[UIO_DCOPY_CHANNEL] = channel;
@@ -756,7 +798,8 @@ uioafini(uio_t *uiop, uioa_t *uioap)
 		dcopy_cmd_free(&cmd);
 	}
 
-	dcopy_free(&channel);
+	if (channel != NULL)
+		dcopy_free(&channel);
 
 	/* Unlock all page(s) iovec_t by iovec_t */
 	while (iovcnt-- > 0) {
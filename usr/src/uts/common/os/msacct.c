@@ -35,6 +35,7 @@
 #include <sys/msacct.h>
 #include <sys/time.h>
 #include <sys/zone.h>
+#include <sys/syscall_lat.h>
 
 /*
  * Mega-theory block comment:
@@ -85,6 +86,22 @@
  * are also in-sync with microstate data.
  */
 
+/*
+ * Bucket boundaries, in nanoseconds, for the per-zone run queue wait
+ * latency histogram maintained in restore_mstate().  A dispatch wait
+ * is counted in the first bucket whose boundary exceeds it; the final
+ * bucket is unbounded.
+ */
+static const hrtime_t zone_whist_bounds[ZONE_USTATE_WHIST_NBUCKETS - 1] = {
+	10000LL,		/* 10us */
+	100000LL,		/* 100us */
+	1000000LL,		/* 1ms */
+	10000000LL,		/* 10ms */
+	100000000LL,		/* 100ms */
+	1000000000LL,		/* 1s */
+	10000000000LL		/* 10s */
+};
+
 /*
  * Initialize the microstate level and the
  * associated accounting information for an LWP.
@@ -426,9 +443,22 @@ syscall_mstate(int fromms, int toms)
 	if (fromms == LMS_USER) {
 		CPU_UARRAY_VAL(z->zone_ustate, cpu->cpu_id,
 		    ZONE_USTATE_UTIME) += newtime;
+
+		/*
+		 * This is the syscall entry transition; note the start time
+		 * so that the exit transition below can compute the
+		 * wall-clock latency of the call for syscall_lat_record().
+		 */
+		if (toms == LMS_SYSTEM)
+			ms->ms_sysc_start = curtime;
 	} else if (fromms == LMS_SYSTEM) {
 		CPU_UARRAY_VAL(z->zone_ustate, cpu->cpu_id,
 		    ZONE_USTATE_STIME) += newtime;
+
+		if (toms == LMS_USER && syscall_lat_sample != 0) {
+			syscall_lat_record((uint_t)t->t_sysnum, cpu->cpu_id,
+			    curtime - ms->ms_sysc_start);
+		}
 	}
 
 	if ((toms != LMS_USER) && (cpu->cpu_mstate != CMS_SYSTEM)) {
@@ -714,7 +744,9 @@ restore_mstate(kthread_t *t)
 	hrtime_t newtime;
 	hrtime_t oldtime;
 	hrtime_t waittime;
+	hrtime_t scaledwait;
 	zone_t *z;
+	int wbucket;
 
 	/*
 	 * Don't call restore mstate of threads without lwps.  (Kernel threads)
@@ -800,6 +832,19 @@ restore_mstate(kthread_t *t)
 	CPU_UARRAY_VAL(z->zone_ustate, CPU->cpu_id,
 	    ZONE_USTATE_WTIME) += waittime;
 
+	/*
+	 * Count this dispatch wait in the zone's latency histogram.
+	 * The buckets are in nanoseconds, so scale the wait first.
+	 */
+	scaledwait = waittime;
+	scalehrtime(&scaledwait);
+	for (wbucket = 0; wbucket < ZONE_USTATE_WHIST_NBUCKETS - 1; wbucket++) {
+		if (scaledwait < zone_whist_bounds[wbucket])
+			break;
+	}
+	CPU_UARRAY_VAL(z->zone_ustate, CPU->cpu_id,
+	    ZONE_USTATE_WHIST + wbucket) += 1;
+
 	CPU->cpu_waitrq += waittime;
 	ms->ms_state_start = curtime;
 }
@@ -217,6 +217,8 @@
 #include <sys/spl.h>
 #include <sys/lockstat.h>
 #include <sys/atomic.h>
+#include <sys/kmem.h>
+#include <sys/kstat.h>
 #include <sys/cpu.h>
 #include <sys/stack.h>
 #include <sys/archsystm.h>
@@ -335,6 +337,175 @@ uint_t (*mutex_lock_backoff)(uint_t) = default_lock_backoff;
 void (*mutex_lock_delay)(uint_t) = default_lock_delay;
 void (*mutex_delay)(void) = mutex_delay_default;
 
+/*
+ * Sampled adaptive mutex contention statistics.
+ *
+ * lockstat(8) gives exact contention data but is too expensive to leave
+ * enabled on production systems, so chronic contention is usually only
+ * diagnosed after the fact.  As a cheap always-available alternative, the
+ * adaptive mutex slow path can sample 1 in every lock_cont_sample
+ * contention events.  Each sampled event hashes the lock address into a
+ * small fixed per-CPU table and folds the measured spin and block times
+ * into exponentially weighted moving averages for that slot, yielding a
+ * continuous "most contended locks" view at a cost of one per-CPU counter
+ * increment per contention event plus two gethrtime() calls per sampled
+ * event -- and the slow path is, by definition, already slow.
+ *
+ * On a hash collision the incumbent's event count is aged down and the
+ * slot is only taken over once it drains, so a persistently hot lock is
+ * not evicted by one-off contention on a colliding address.  The tables
+ * are per-CPU and updated without locks; a thread that migrates mid-update
+ * can at worst smear one sample, which is acceptable for statistics.
+ *
+ * The tables are exported through the "unix:0:lock_contention" raw kstat
+ * as an array of lock_cont_entry_t, LOCK_CONT_NENT entries per CPU slot.
+ * Consumers (and mdb's ::kgrep) can map lce_lock back to a symbol.
+ *
+ * Sampling is off by default; set lock_cont_sample in /etc/system or with
+ * mdb to enable it.  The tables are allocated on the first sampled event,
+ * so disabled systems pay only the lock_cont_sample test.
+ */
+#define	LOCK_CONT_NENT		64	/* per-CPU table slots (power of 2) */
+#define	LOCK_CONT_EWMA_SHIFT	3	/* EWMA weight: 1/8 new, 7/8 old */
+
+typedef struct lock_cont_entry {
+	uint64_t	lce_lock;	/* lock address */
+	uint64_t	lce_events;	/* sampled events since takeover */
+	int64_t		lce_spin;	/* EWMA of sampled spin time (ns) */
+	int64_t		lce_block;	/* EWMA of sampled block time (ns) */
+} lock_cont_entry_t;
+
+typedef struct lock_cont_cpu {
+	uint64_t		lcc_ctr;	/* sampling countdown */
+	uint64_t		lcc_pad[7];	/* cacheline isolation */
+	lock_cont_entry_t	lcc_ent[LOCK_CONT_NENT];
+} lock_cont_cpu_t;
+
+/*
+ * Sample 1 in every lock_cont_sample adaptive mutex contention events;
+ * zero disables sampling entirely.
+ */
+uint_t lock_cont_sample = 0;
+
+static lock_cont_cpu_t *lock_cont_cpus;	/* max_ncpus tables; lazy */
+static volatile uint_t lock_cont_claim;	/* allocation in progress */
+
+/*
+ * Decide whether to sample this contention event; returns the sample
+ * start time, or zero if the event is not sampled.
+ */
+static hrtime_t
+lock_cont_start(void)
+{
+	lock_cont_cpu_t *lcc;
+
+	if (lock_cont_cpus == NULL) {
+		lock_cont_cpu_t *tbl;
+
+		/*
+		 * First sampled event since enabling: allocate the tables.
+		 * The claim flag both elects a single allocating thread and
+		 * keeps contention on kmem's own locks during the allocation
+		 * from recursing back into the allocator.
+		 */
+		if (atomic_cas_uint(&lock_cont_claim, 0, 1) != 0)
+			return (0);
+		tbl = kmem_zalloc(max_ncpus * sizeof (lock_cont_cpu_t),
+		    KM_NOSLEEP);
+		if (tbl == NULL) {
+			lock_cont_claim = 0;
+			return (0);
+		}
+		lock_cont_cpus = tbl;
+	}
+
+	lcc = &lock_cont_cpus[CPU->cpu_seqid];
+	if (++lcc->lcc_ctr < (uint64_t)lock_cont_sample)
+		return (0);
+	lcc->lcc_ctr = 0;
+
+	return (gethrtime());
+}
+
+/*
+ * Fold a sampled contention event into the current CPU's table.
+ */
+static void
+lock_cont_record(uintptr_t lock, hrtime_t spin, hrtime_t block)
+{
+	lock_cont_entry_t *ent;
+	uint_t h;
+
+	h = (uint_t)(((lock >> 3) ^ (lock >> 9)) & (LOCK_CONT_NENT - 1));
+	ent = &lock_cont_cpus[CPU->cpu_seqid].lcc_ent[h];
+
+	if (ent->lce_lock != (uint64_t)lock) {
+		if (ent->lce_events != 0) {
+			ent->lce_events--;
+			return;
+		}
+		ent->lce_lock = (uint64_t)lock;
+		ent->lce_spin = 0;
+		ent->lce_block = 0;
+	}
+
+	ent->lce_events++;
+	ent->lce_spin += (spin - ent->lce_spin) >> LOCK_CONT_EWMA_SHIFT;
+	ent->lce_block += (block - ent->lce_block) >> LOCK_CONT_EWMA_SHIFT;
+}
+
+static int
+lock_cont_kstat_update(kstat_t *ksp, int rw)
+{
+	if (rw == KSTAT_WRITE)
+		return (EACCES);
+
+	ksp->ks_ndata = max_ncpus * LOCK_CONT_NENT;
+	ksp->ks_data_size = max_ncpus * LOCK_CONT_NENT *
+	    sizeof (lock_cont_entry_t);
+
+	return (0);
+}
+
+static int
+lock_cont_kstat_snapshot(kstat_t *ksp, void *buf, int rw)
+{
+	lock_cont_entry_t *dst = buf;
+	int i;
+
+	if (rw == KSTAT_WRITE)
+		return (EACCES);
+
+	ksp->ks_snaptime = gethrtime();
+
+	if (lock_cont_cpus == NULL) {
+		bzero(buf, ksp->ks_data_size);
+		return (0);
+	}
+
+	for (i = 0; i < max_ncpus; i++) {
+		bcopy(lock_cont_cpus[i].lcc_ent, dst,
+		    sizeof (lock_cont_cpus[i].lcc_ent));
+		dst += LOCK_CONT_NENT;
+	}
+
+	return (0);
+}
+
+void
+lock_cont_init(void)
+{
+	kstat_t *ksp;
+
+	ksp = kstat_create("unix", 0, "lock_contention", "misc",
+	    KSTAT_TYPE_RAW, 0, KSTAT_FLAG_VAR_SIZE | KSTAT_FLAG_VIRTUAL);
+	if (ksp != NULL) {
+		ksp->ks_update = lock_cont_kstat_update;
+		ksp->ks_snapshot = lock_cont_kstat_snapshot;
+		kstat_install(ksp);
+	}
+}
+
 /*
  * mutex_vector_enter() is called from the assembly mutex_enter() routine
  * if the lock is held or is not of type MUTEX_ADAPTIVE.
@@ -346,6 +517,7 @@ mutex_vector_enter(mutex_impl_t *lp)
 	kthread_id_t	lastowner = MUTEX_NO_OWNER; /* track owner changes */
 	hrtime_t	sleep_time = 0;	/* how long we slept */
 	hrtime_t	spin_time = 0;	/* how long we spun */
+	hrtime_t	cont_time = 0;	/* sampled contention start time */
 	cpu_t 		*cpup;
 	turnstile_t	*ts;
 	volatile mutex_impl_t *vlp = (volatile mutex_impl_t *)lp;
@@ -382,6 +554,9 @@ mutex_vector_enter(mutex_impl_t *lp)
 
 	spin_time = LOCKSTAT_START_TIME(LS_MUTEX_ENTER_SPIN);
 
+	if (lock_cont_sample != 0)
+		cont_time = lock_cont_start();
+
 	backoff = mutex_lock_backoff(0);	/* set base backoff */
 	for (;;) {
 		mutex_lock_delay(backoff); /* backoff delay */
@@ -471,6 +646,15 @@ mutex_vector_enter(mutex_impl_t *lp)
 		    spin_time + sleep_time);
 	}
 
+	if (cont_time != 0) {
+		/*
+		 * The sampled spin time is the total elapsed time minus
+		 * the time spent blocked in the turnstile.
+		 */
+		lock_cont_record((uintptr_t)lp,
+		    gethrtime() - cont_time - sleep_time, sleep_time);
+	}
+
 	LOCKSTAT_RECORD0(LS_MUTEX_ENTER_ACQUIRE, lp);
 }
 
@@ -42,6 +42,7 @@
 #include <sys/cpuvar.h>
 #include <sys/cmn_err.h>
 #include <sys/bitmap.h>
+#include <sys/atomic.h>
 #include <sys/debug.h>
 #include <c2/audit.h>
 #include <sys/project.h>
@@ -71,6 +72,26 @@ static int pid_hashsz;		/* number of buckets in the hash table */
 
 #define	HASHPID(pid)	(pidhash[((pid)&(pid_hashsz-1))])
 
+/*
+ * The pid hash chains were historically protected by a single mutex
+ * (pidlinklock), which every pid lookup, pid allocation and pid release
+ * in the system had to pass through.  On machines with many /proc
+ * consumers and a high fork rate that one lock becomes a measurable
+ * point of serialization, so the chains are instead protected by an
+ * array of padded chain locks, selected by the same low-order pid bits
+ * that select the chain itself.  Since pid_nlocks never exceeds
+ * pid_hashsz, every pid on a given chain maps to the same lock, and one
+ * lock simply covers a fixed group of chains.  As with anonhash_lock,
+ * the locks are padded out to coherence granularity so that two CPUs
+ * working under different chain locks don't false-share.
+ */
+#define	PID_NLOCKS_MAX	128
+
+static int pid_nlocks;		/* number of chain locks, a power of two */
+
+#define	PIDLINKLOCK(pid) \
+	(&pid_linklock[(pid) & (pid_nlocks - 1)].pad_mutex)
+
 extern uint_t nproc;
 extern struct kmem_cache *process_cache;
 static void	upcount_init(void);
@@ -90,7 +111,9 @@ struct plock	*proc_lock;	/* persistent array of p_lock's */
  */
 #define	PLOCK_SHIFT	3
 
-static kmutex_t	pidlinklock;
+static pad_mutex_t *pid_linklock;	/* sharded pid hash chain locks */
+static kmutex_t	pid_alloclock;		/* protects mpid */
+static kmutex_t	procentlock;		/* protects procentfree */
 static struct pid **pidhash;
 static pid_t minpid;
 static pid_t mpid = FAMOUS_PIDS;	/* one more than the last famous pid */
@@ -102,7 +125,7 @@ pid_lookup(pid_t pid)
 {
 	struct pid *pidp;
 
-	ASSERT(MUTEX_HELD(&pidlinklock));
+	ASSERT(MUTEX_HELD(PIDLINKLOCK(pid)));
 
 	for (pidp = HASHPID(pid); pidp; pidp = pidp->pid_link) {
 		if (pidp->pid_id == pid) {
@@ -161,42 +184,62 @@ pid_t
 pid_allocate(proc_t *prp, pid_t pid, int flags)
 {
 	struct pid *pidp;
-	union procent *pep;
-	pid_t newpid, startpid;
+	union procent *pep = NULL;
+	kmutex_t *chainlock;
+	pid_t newpid, scanned;
 
 	pidp = kmem_zalloc(sizeof (struct pid), KM_SLEEP);
 
-	mutex_enter(&pidlinklock);
-	pep = procentfree;
-	if ((flags & PID_ALLOC_PROC) && pep == NULL) {
+	if (flags & PID_ALLOC_PROC) {
 		/*
-		 * ran out of /proc directory entries
+		 * Claim a /proc directory entry up front; if there are
+		 * none, the allocation is doomed no matter which pids
+		 * happen to be free.
 		 */
-		goto failed;
+		mutex_enter(&procentlock);
+		pep = procentfree;
+		if (pep == NULL) {
+			mutex_exit(&procentlock);
+			kmem_free(pidp, sizeof (struct pid));
+			return (-1);
+		}
+		procentfree = pep->pe_next;
+		mutex_exit(&procentlock);
 	}
 
 	if (pid != 0) {
 		VERIFY(minpid == 0);
 		VERIFY3P(pid, <, mpid);
-		VERIFY3P(pid_lookup(pid), ==, NULL);
 		newpid = pid;
+		chainlock = PIDLINKLOCK(newpid);
+		mutex_enter(chainlock);
+		VERIFY3P(pid_lookup(pid), ==, NULL);
 	} else {
 		/*
-		 * Allocate a pid
+		 * Allocate a pid.  Candidates are claimed from mpid under
+		 * pid_alloclock, so concurrent allocators always probe
+		 * distinct pids and meet only on that (briefly held)
+		 * counter lock and on individual chain locks.  The search
+		 * is bounded by the size of the pid space; with no
+		 * competing allocators advancing mpid, that is exactly one
+		 * full cycle through it, just as the old wrap test was.
 		 */
-		ASSERT(minpid <= mpid && mpid < maxpid);
+		for (scanned = 0; ; scanned++) {
+			if (scanned > maxpid - minpid)
+				goto failed;
 
-		startpid = mpid;
-		for (;;) {
+			mutex_enter(&pid_alloclock);
+			ASSERT(minpid <= mpid && mpid < maxpid);
 			newpid = mpid;
 			if (++mpid == maxpid)
 				mpid = minpid;
+			mutex_exit(&pid_alloclock);
 
+			chainlock = PIDLINKLOCK(newpid);
+			mutex_enter(chainlock);
 			if (pid_lookup(newpid) == NULL)
 				break;
-
-			if (mpid == startpid)
-				goto failed;
+			mutex_exit(chainlock);
 		}
 	}
 
@@ -209,7 +252,6 @@ pid_allocate(proc_t *prp, pid_t pid, int flags)
 	pidp->pid_id = newpid;
 
 	if (flags & PID_ALLOC_PROC) {
-		procentfree = pep->pe_next;
 		pidp->pid_prslot = pep - procdir;
 		pep->pe_proc = prp;
 		prp->p_pidp = pidp;
@@ -218,12 +260,17 @@ pid_allocate(proc_t *prp, pid_t pid, int flags)
 		pidp->pid_prslot = 0;
 	}
 
-	mutex_exit(&pidlinklock);
+	mutex_exit(chainlock);
 
 	return (newpid);
 
 failed:
-	mutex_exit(&pidlinklock);
+	if (pep != NULL) {
+		mutex_enter(&procentlock);
+		pep->pe_next = procentfree;
+		procentfree = pep;
+		mutex_exit(&procentlock);
+	}
 	kmem_free(pidp, sizeof (struct pid));
 	return (-1);
 }
@@ -234,9 +281,10 @@ failed:
 int
 pid_rele(struct pid *pidp)
 {
+	kmutex_t *chainlock = PIDLINKLOCK(pidp->pid_id);
 	struct pid **pidpp;
 
-	mutex_enter(&pidlinklock);
+	mutex_enter(chainlock);
 	ASSERT(pidp != &pid0);
 
 	pidpp = &HASHPID(pidp->pid_id);
@@ -248,7 +296,7 @@ pid_rele(struct pid *pidp)
 	}
 
 	*pidpp = pidp->pid_link;
-	mutex_exit(&pidlinklock);
+	mutex_exit(chainlock);
 
 	kmem_free(pidp, sizeof (*pidp));
 	return (0);
@@ -257,11 +305,11 @@ pid_rele(struct pid *pidp)
 void
 proc_entry_free(struct pid *pidp)
 {
-	mutex_enter(&pidlinklock);
+	mutex_enter(&procentlock);
 	pidp->pid_prinactive = 1;
 	procdir[pidp->pid_prslot].pe_next = procentfree;
 	procentfree = &procdir[pidp->pid_prslot];
-	mutex_exit(&pidlinklock);
+	mutex_exit(&procentlock);
 }
 
 /*
@@ -318,6 +366,8 @@ pid_exit(proc_t *prp, struct task *tk)
 	tk->tk_proj->kpj_nprocs--;
 	zone->zone_nprocs--;
 	mutex_exit(&zone->zone_nlwps_lock);
+
+	atomic_inc_32(&zone->zone_exits);
 }
 
 /*
@@ -331,9 +381,9 @@ prfind_zone(pid_t pid, zoneid_t zoneid)
 
 	ASSERT(MUTEX_HELD(&pidlock));
 
-	mutex_enter(&pidlinklock);
+	mutex_enter(PIDLINKLOCK(pid));
 	pidp = pid_lookup(pid);
-	mutex_exit(&pidlinklock);
+	mutex_exit(PIDLINKLOCK(pid));
 	if (pidp != NULL && pidp->pid_prinactive == 0) {
 		p = procdir[pidp->pid_prslot].pe_proc;
 		if (zoneid == ALL_ZONES || p->p_zone->zone_id == zoneid)
@@ -367,9 +417,9 @@ pgfind_zone(pid_t pgid, zoneid_t zoneid)
 
 	ASSERT(MUTEX_HELD(&pidlock));
 
-	mutex_enter(&pidlinklock);
+	mutex_enter(PIDLINKLOCK(pgid));
 	pidp = pid_lookup(pgid);
-	mutex_exit(&pidlinklock);
+	mutex_exit(PIDLINKLOCK(pgid));
 	if (pidp != NULL) {
 		proc_t *p = pidp->pid_pglink;
 
@@ -524,10 +574,25 @@ sprunlock(proc_t *p)
 void
 pid_init(void)
 {
+	caddr_t tmp;
 	int i;
 
 	pid_hashsz = 1 << highbit(v.v_proc / pid_hashlen);
 
+	/*
+	 * One chain lock per bucket would be overkill; cap the number of
+	 * locks but never exceed the number of buckets, so that all pids
+	 * on a chain share one lock.  As with anonhash_lock, align the
+	 * array so each padded lock gets its own coherence granule.
+	 */
+	pid_nlocks = MIN(pid_hashsz, PID_NLOCKS_MAX);
+	tmp = kmem_zalloc(pid_nlocks * sizeof (pad_mutex_t) + 63, KM_SLEEP);
+	pid_linklock = (pad_mutex_t *)P2ROUNDUP((uintptr_t)tmp, 64);
+	for (i = 0; i < pid_nlocks; i++) {
+		mutex_init(&pid_linklock[i].pad_mutex, NULL, MUTEX_DEFAULT,
+		    NULL);
+	}
+
 	pidhash = kmem_zalloc(sizeof (struct pid *) * pid_hashsz, KM_SLEEP);
 	procdir = kmem_alloc(sizeof (union procent) * v.v_proc, KM_SLEEP);
 	pr_pid_cv = kmem_zalloc(sizeof (kcondvar_t) * v.v_proc, KM_SLEEP);
@@ -578,13 +643,13 @@ signal(pid_t pgid, int sig)
 	proc_t *prp;
 
 	mutex_enter(&pidlock);
-	mutex_enter(&pidlinklock);
+	mutex_enter(PIDLINKLOCK(pgid));
 	if (pgid == 0 || (pidp = pid_lookup(pgid)) == NULL) {
-		mutex_exit(&pidlinklock);
+		mutex_exit(PIDLINKLOCK(pgid));
 		mutex_exit(&pidlock);
 		return;
 	}
-	mutex_exit(&pidlinklock);
+	mutex_exit(PIDLINKLOCK(pgid));
 	for (prp = pidp->pid_pglink; prp; prp = prp->p_pglink) {
 		mutex_enter(&prp->p_lock);
 		sigtoproc(prp, NULL, sig);
@@ -418,7 +418,14 @@ priv_policy_ap(const cred_t *cr, int priv, boolean_t allzone, int err,
 		if ((allzone || priv == PRIV_ALL ||
 		    !PRIV_ISASSERT(priv_basic, priv)) &&
 		    !servicing_interrupt()) {
-			PTOU(curproc)->u_acflag |= ASU; /* Needed for SVVS */
+			/*
+			 * ASU is sticky for the life of the process; test
+			 * before setting so that the many threads of a
+			 * file-serving process repeatedly exercising DAC
+			 * overrides don't all write the shared u-area.
+			 */
+			if ((PTOU(curproc)->u_acflag & ASU) == 0)
+				PTOU(curproc)->u_acflag |= ASU; /* For SVVS */
 			if (AU_AUDITING())
 				audit_priv(priv,
 				    allzone ? ZONEPRIVS(cr) : NULL, 1);
@@ -70,6 +70,24 @@ rctl_hndl_t rc_process_sigqueue;
 /*
  * process.max-cpu-time / RLIMIT_CPU
  */
+/*ARGSUSED*/
+static int
+proc_cpu_time_set(rctl_t *rctl, struct proc *p, rctl_entity_p_t *e,
+    rctl_qty_t nv)
+{
+	/*
+	 * Cache the value at the cursor so that the tick accounting code
+	 * can cheaply determine whether the process is anywhere near its
+	 * CPU time limit without calling rctl_test().  The cache is
+	 * refreshed whenever the control is modified and whenever the
+	 * cursor advances after an action fires.
+	 */
+	ASSERT(e->rcep_t == RCENTITY_PROCESS);
+	e->rcep_p.proc->p_cpu_time_ctl = nv;
+
+	return (0);
+}
+
 /*ARGSUSED*/
 static int
 proc_cpu_time_test(struct rctl *rctl, struct proc *p, rctl_entity_p_t *e,
@@ -81,7 +99,7 @@ proc_cpu_time_test(struct rctl *rctl, struct proc *p, rctl_entity_p_t *e,
 static rctl_ops_t proc_cpu_time_ops = {
 	rcop_no_action,
 	rcop_no_usage,
-	rcop_no_set,
+	proc_cpu_time_set,
 	proc_cpu_time_test
 };
 
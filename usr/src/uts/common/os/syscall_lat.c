@@ -0,0 +1,154 @@
+/*
+ * This file and its contents are supplied under the terms of the
+ * Common Development and Distribution License ("CDDL"), version 1.0.
+ * You may only use this file in accordance with the terms of version
+ * 1.0 of the CDDL.
+ *
+ * A full copy of the text of the CDDL should have accompanied this
+ * source.  A copy of the CDDL is also available via the Internet at
+ * http://www.illumos.org/license/CDDL.
+ */
+
+/*
+ * Copyright 2026 Oxide Computer Company
+ */
+
+/*
+ * Sampled per-syscall latency histograms.
+ *
+ * Permanently enabled DTrace scripts are the usual way to watch syscall
+ * latency in production, but they tax every system call on every CPU.
+ * This file provides a cheap compile-in alternative: when the
+ * syscall_lat_sample tunable is set to N > 0, every Nth syscall return on
+ * each CPU records the wall-clock latency of that call into a per-CPU
+ * power-of-two histogram indexed by syscall number.  The timestamps come
+ * for free: syscall_mstate() already reads gethrtime_unscaled() on every
+ * syscall entry and exit for microstate accounting, so an unsampled call
+ * pays only for a per-CPU counter increment, and a disabled system (the
+ * default, syscall_lat_sample of zero) pays only for a test of the
+ * tunable.
+ *
+ * Storage is a cpu_uarray_t, allocated on the first sampled call after
+ * enabling, so that CPUs never share cache lines when recording and a
+ * system that never enables sampling never pays for the buffers.  Slot
+ * zero of each CPU's array holds the sampling countdown; the rest holds
+ * NSYSCALL histograms of SYSCALL_LAT_BUCKETS buckets each.  Latency for
+ * bucket b is in the range [2^(SYSCALL_LAT_SHIFT + b - 1),
+ * 2^(SYSCALL_LAT_SHIFT + b)) nanoseconds, with the first and last buckets
+ * absorbing the tails.  The histograms, summed across CPUs, are exported
+ * as the unix:0:syscall_lat raw kstat: NSYSCALL rows of
+ * SYSCALL_LAT_BUCKETS uint64_t counters in syscall number order.
+ */
+
+#include <sys/types.h>
+#include <sys/systm.h>
+#include <sys/sysmacros.h>
+#include <sys/time.h>
+#include <sys/atomic.h>
+#include <sys/kmem.h>
+#include <sys/kstat.h>
+#include <sys/cpuvar.h>
+#include <sys/cpu_uarray.h>
+#include <sys/syscall_lat.h>
+
+/*
+ * Sample one of every syscall_lat_sample syscall returns per CPU; zero
+ * disables sampling entirely.  May be set in /etc/system or at run time.
+ */
+uint_t syscall_lat_sample = 0;
+
+static cpu_uarray_t *syscall_lat_data;
+
+#define	SYSCALL_LAT_CTR		0	/* per-CPU sampling countdown */
+#define	SYSCALL_LAT_IDX(code, b) \
+	(1 + (code) * SYSCALL_LAT_BUCKETS + (b))
+#define	SYSCALL_LAT_NITEMS	SYSCALL_LAT_IDX(NSYSCALL, 0)
+
+/*
+ * Called from syscall_mstate() on the LMS_SYSTEM to LMS_USER transition
+ * with kernel preemption disabled; delta is the unscaled wall-clock time
+ * since the syscall entry transition.
+ */
+void
+syscall_lat_record(uint_t code, processorid_t cpuid, hrtime_t delta)
+{
+	cpu_uarray_t *cua = syscall_lat_data;
+	uint64_t *ctr;
+	int b;
+
+	if (code >= NSYSCALL)
+		return;
+
+	if (cua == NULL) {
+		/*
+		 * First sampled call since boot: allocate the buffers.  We
+		 * cannot sleep here, so on failure just try again on the
+		 * next sampled call.
+		 */
+		cua = cpu_uarray_zalloc(SYSCALL_LAT_NITEMS, KM_NOSLEEP);
+
+		if (cua == NULL)
+			return;
+
+		if (atomic_cas_ptr(&syscall_lat_data, NULL, cua) != NULL) {
+			cpu_uarray_free(cua);
+			cua = syscall_lat_data;
+		}
+	}
+
+	ctr = &CPU_UARRAY_VAL(cua, cpuid, SYSCALL_LAT_CTR);
+
+	if (++*ctr < (uint64_t)syscall_lat_sample)
+		return;
+
+	*ctr = 0;
+
+	scalehrtime(&delta);
+
+	b = highbit64((uint64_t)delta) - SYSCALL_LAT_SHIFT;
+
+	if (b < 0)
+		b = 0;
+	else if (b >= SYSCALL_LAT_BUCKETS)
+		b = SYSCALL_LAT_BUCKETS - 1;
+
+	CPU_UARRAY_VAL(cua, cpuid, SYSCALL_LAT_IDX(code, b))++;
+}
+
+static int
+syscall_lat_kstat_snapshot(kstat_t *ksp, void *buf, int rw)
+{
+	cpu_uarray_t *cua = syscall_lat_data;
+	uint64_t *out = buf;
+	size_t i;
+
+	if (rw == KSTAT_WRITE)
+		return (EACCES);
+
+	ksp->ks_snaptime = gethrtime();
+
+	if (cua == NULL) {
+		bzero(buf, ksp->ks_data_size);
+		return (0);
+	}
+
+	for (i = 0; i < NSYSCALL * SYSCALL_LAT_BUCKETS; i++)
+		out[i] = cpu_uarray_sum(cua, 1 + i);
+
+	return (0);
+}
+
+void
+syscall_lat_init(void)
+{
+	kstat_t *ksp;
+
+	ksp = kstat_create("unix", 0, "syscall_lat", "misc", KSTAT_TYPE_RAW,
+	    NSYSCALL * SYSCALL_LAT_BUCKETS * sizeof (uint64_t),
+	    KSTAT_FLAG_VIRTUAL);
+
+	if (ksp != NULL) {
+		ksp->ks_snapshot = syscall_lat_kstat_snapshot;
+		kstat_install(ksp);
+	}
+}
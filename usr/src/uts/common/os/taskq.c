@@ -383,6 +383,13 @@
  * itself. The thread sleep time is controlled by a tunable variable
  * `taskq_thread_timeout'.
  *
+ * Tasks that overflow to the backing queue are serviced by a single thread,
+ * so a burst of overflows can backlog behind that thread while per-entry
+ * threads sit idle. To drain such backlogs in parallel, an idle per-entry
+ * thread steals a task from the backing queue (taskq_d_steal()) before going
+ * to sleep, marking itself busy in its bucket for the duration. The number
+ * of stolen tasks is reported by the "steals" kstat.
+ *
  * There are various statistics kept in the bucket which allows for later
  * analysis of taskq usage patterns. Also, a global copy of taskq creation and
  * death statistics is kept in the global taskq data structure. Since thread
@@ -588,6 +595,7 @@ static void taskq_ent_free(taskq_t *, taskq_ent_t *);
 static int taskq_ent_exists(taskq_t *, task_func_t, void *);
 static taskq_ent_t *taskq_bucket_dispatch(taskq_bucket_t *, task_func_t,
     void *);
+static int taskq_d_steal(taskq_bucket_t *, taskq_ent_t *);
 
 /*
  * Task queues kstats.
@@ -632,6 +640,7 @@ struct taskq_d_kstat {
 	kstat_named_t	tqd_maxthreads;
 	kstat_named_t	tqd_nomem;
 	kstat_named_t	tqd_disptcreates;
+	kstat_named_t	tqd_steals;
 	kstat_named_t	tqd_totaltime;
 	kstat_named_t	tqd_nalloc;
 	kstat_named_t	tqd_nfree;
@@ -651,6 +660,7 @@ struct taskq_d_kstat {
 	{ "maxthreads",		KSTAT_DATA_UINT64 },
 	{ "nomem",		KSTAT_DATA_UINT64 },
 	{ "disptcreates",	KSTAT_DATA_UINT64 },
+	{ "steals",		KSTAT_DATA_UINT64 },
 	{ "totaltime",		KSTAT_DATA_UINT64 },
 	{ "nalloc",		KSTAT_DATA_UINT64 },
 	{ "nfree",		KSTAT_DATA_UINT64 },
@@ -1693,6 +1703,95 @@ taskq_thread(void *arg)
 	}
 }
 
+/*
+ * Steal a task from the backing queue and execute it.
+ *
+ * Tasks overflow to the backing queue when dispatch can't find a free entry,
+ * and only one thread services that queue, so a burst of overflows backlogs
+ * behind it while per-entry threads are idle. An idle per-entry thread calls
+ * this before going to sleep to help drain the backlog. The thread takes its
+ * own entry off the bucket free list for the duration so that dispatchers
+ * see it as busy and taskq_destroy() can't reap it mid-task.
+ *
+ * Assumes: bucket lock is held, the entry is on the bucket free list with
+ *	    no task scheduled in it. The lock is dropped while the stolen
+ *	    task runs and is reacquired before return.
+ *
+ * Returns: 1 if a task was stolen and executed, 0 if the backing queue was
+ *	    empty or the taskq is suspended.
+ */
+static int
+taskq_d_steal(taskq_bucket_t *bucket, taskq_ent_t *tqe)
+{
+	taskq_t *tq = bucket->tqbucket_taskq;
+	taskq_ent_t *stqe;
+	hrtime_t start, end;
+
+	ASSERT(MUTEX_HELD(&bucket->tqbucket_lock));
+	ASSERT(tqe->tqent_func == NULL);
+
+	/*
+	 * Peek at the backing queue without the lock first; the common
+	 * idle case should stay cheap.
+	 */
+	if (tq->tq_task.tqent_next == &tq->tq_task)
+		return (0);
+
+	/*
+	 * The lock order here (bucket lock, then tq_lock) is the one
+	 * documented in the theory statement above.
+	 */
+	mutex_enter(&tq->tq_lock);
+	stqe = tq->tq_task.tqent_next;
+	if ((stqe == &tq->tq_task) || (tq->tq_flags & TASKQ_SUSPENDED)) {
+		mutex_exit(&tq->tq_lock);
+		return (0);
+	}
+	stqe->tqent_prev->tqent_next = stqe->tqent_next;
+	stqe->tqent_next->tqent_prev = stqe->tqent_prev;
+	tq->tq_active++;
+	mutex_exit(&tq->tq_lock);
+
+	/*
+	 * Mark ourselves busy in the bucket while the stolen task runs.
+	 */
+	tqe->tqent_prev->tqent_next = tqe->tqent_next;
+	tqe->tqent_next->tqent_prev = tqe->tqent_prev;
+	bucket->tqbucket_nalloc++;
+	bucket->tqbucket_nfree--;
+	TQ_STAT(bucket, tqs_steals);
+	DTRACE_PROBE2(taskq__d__steal, taskq_bucket_t *, bucket,
+	    taskq_ent_t *, stqe);
+	mutex_exit(&bucket->tqbucket_lock);
+
+	rw_enter(&tq->tq_threadlock, RW_READER);
+	start = gethrtime();
+	DTRACE_PROBE2(taskq__exec__start, taskq_t *, tq, taskq_ent_t *, stqe);
+	stqe->tqent_func(stqe->tqent_arg);
+	DTRACE_PROBE2(taskq__exec__end, taskq_t *, tq, taskq_ent_t *, stqe);
+	end = gethrtime();
+	rw_exit(&tq->tq_threadlock);
+
+	mutex_enter(&tq->tq_lock);
+	tq->tq_totaltime += end - start;
+	tq->tq_executed++;
+	if (--tq->tq_active == 0)
+		cv_broadcast(&tq->tq_wait_cv);
+	taskq_ent_free(tq, stqe);
+	mutex_exit(&tq->tq_lock);
+
+	/*
+	 * Return our entry to the bucket free list.
+	 */
+	mutex_enter(&bucket->tqbucket_lock);
+	TQ_APPEND(bucket->tqbucket_freelist, tqe);
+	bucket->tqbucket_nalloc--;
+	bucket->tqbucket_nfree++;
+	cv_signal(&bucket->tqbucket_cv);
+
+	return (1);
+}
+
 /*
  * Worker per-entry thread for dynamic dispatches.
  */
@@ -1764,6 +1863,19 @@ taskq_d_thread(taskq_ent_t *tqe)
 		 * finished executing a task and put itself on the free list.
 		 */
 		ASSERT(bucket->tqbucket_nfree > 0);
+
+		/*
+		 * Before going idle, help drain any tasks that have
+		 * overflowed to the backing queue. The entry stays off
+		 * the free list while a stolen task runs, so no task
+		 * can be scheduled into it until we are done helping.
+		 */
+		if (!(bucket->tqbucket_flags &
+		    (TQBUCKET_CLOSE | TQBUCKET_SUSPEND))) {
+			while (taskq_d_steal(bucket, tqe))
+				continue;
+		}
+
 		/*
 		 * Go to sleep unless we are closing.
 		 * If a thread is sleeping too long, it dies.
@@ -2320,6 +2432,7 @@ taskq_d_kstat_update(kstat_t *ksp, int rw)
 	tqsp->tqd_maxthreads.value.ui64 = 0;
 	tqsp->tqd_nomem.value.ui64 = 0;
 	tqsp->tqd_disptcreates.value.ui64 = 0;
+	tqsp->tqd_steals.value.ui64 = 0;
 	tqsp->tqd_totaltime.value.ui64 = 0;
 	tqsp->tqd_nalloc.value.ui64 = 0;
 	tqsp->tqd_nfree.value.ui64 = 0;
@@ -2334,6 +2447,7 @@ taskq_d_kstat_update(kstat_t *ksp, int rw)
 		    b->tqbucket_stat.tqs_maxthreads;
 		tqsp->tqd_disptcreates.value.ui64 +=
 		    b->tqbucket_stat.tqs_disptcreates;
+		tqsp->tqd_steals.value.ui64 += b->tqbucket_stat.tqs_steals;
 		tqsp->tqd_totaltime.value.ui64 += b->tqbucket_totaltime;
 		tqsp->tqd_nalloc.value.ui64 += b->tqbucket_nalloc;
 		tqsp->tqd_nfree.value.ui64 += b->tqbucket_nfree;
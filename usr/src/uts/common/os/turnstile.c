@@ -127,6 +127,9 @@
 #include <sys/sobject.h>
 #include <sys/cmn_err.h>
 #include <sys/sysmacros.h>
+#include <sys/bitmap.h>
+#include <sys/atomic.h>
+#include <sys/kstat.h>
 #include <sys/lockstat.h>
 #include <sys/lwp_upimutex_impl.h>
 #include <sys/schedctl.h>
@@ -157,8 +160,16 @@ extern upib_t upimutextab[UPIMUTEX_TABSIZE];
  * Therefore, to prevent deadlock in turnstile_pi_waive(), we must ensure
  * that upimutextab[] locks *always* hash to lower addresses than any
  * other locks.  You think this is cheesy?  Let's see you do better.
+ *
+ * The table is scaled with the platform's maximum CPU count, as with
+ * AH_LOCK_SIZE, since secondary contention on the chain locks grows with
+ * the number of CPUs that can block concurrently.  It cannot be sized at
+ * boot time: once a synchronization object's waiters bit has been set
+ * under a given chain lock, the object is wedded to that chain forever,
+ * so the hash must never change.  turnstile_hash_size exists so that
+ * debuggers need not bake in the size.
  */
-#define	TURNSTILE_HASH_SIZE	128		/* must be power of 2 */
+#define	TURNSTILE_HASH_SIZE	MAX(128, 2 << NCPU_LOG2)
 #define	TURNSTILE_HASH_MASK	(TURNSTILE_HASH_SIZE - 1)
 #define	TURNSTILE_SOBJ_HASH(sobj)	\
 	((((ulong_t)sobj >> 2) + ((ulong_t)sobj >> 9)) & TURNSTILE_HASH_MASK)
@@ -169,12 +180,93 @@ extern upib_t upimutextab[UPIMUTEX_TABSIZE];
 typedef struct turnstile_chain {
 	turnstile_t	*tc_first;	/* first turnstile on hash chain */
 	disp_lock_t	tc_lock;	/* lock for this hash chain */
+	uint_t		tc_count;	/* active turnstiles on hash chain */
 } turnstile_chain_t;
 
 turnstile_chain_t	turnstile_table[2 * TURNSTILE_HASH_SIZE];
 
+int	turnstile_hash_size = TURNSTILE_HASH_SIZE;	/* for debuggers */
+
 static	lock_t	turnstile_loser_lock;
 
+/*
+ * When the owner of a synchronization object is running unblocked at a
+ * priority at least that of the blocking thread, willing our priority to
+ * it is a no-op, so turnstile_block() skips the priority inheritance
+ * dance (and the turnstile_interlock() ordering protocol it requires)
+ * entirely.  Clear this to force the full walk for every block.
+ */
+int	turnstile_pi_fastpath = 1;
+
+/*
+ * Telemetry for contended synchronization objects, exposed as the
+ * unix:0:turnstile kstat.  "blocks" counts trips through
+ * turnstile_block(), "pi_fastpath" counts blocks that skipped the
+ * priority inheritance walk, "max_chain_depth" is the deepest any hash
+ * chain has ever been, and the block_ns_* entries form a power-of-two
+ * histogram of time spent blocked, so hot mutexes stand out without a
+ * lockstat run.
+ */
+#define	TURNSTILE_HIST_SHIFT	10	/* first bucket: < 2^10 ns */
+#define	TURNSTILE_HIST_BUCKETS	16
+
+typedef struct turnstile_kstat {
+	kstat_named_t	tsk_blocks;
+	kstat_named_t	tsk_pi_fastpath;
+	kstat_named_t	tsk_max_chain_depth;
+	kstat_named_t	tsk_hist[TURNSTILE_HIST_BUCKETS];
+} turnstile_kstat_t;
+
+static turnstile_kstat_t turnstile_kstat;
+
+static void
+turnstile_block_record(hrtime_t delta)
+{
+	int b = highbit64((uint64_t)delta) - TURNSTILE_HIST_SHIFT;
+
+	if (b < 0)
+		b = 0;
+	else if (b >= TURNSTILE_HIST_BUCKETS)
+		b = TURNSTILE_HIST_BUCKETS - 1;
+
+	atomic_inc_64(&turnstile_kstat.tsk_hist[b].value.ui64);
+	atomic_inc_64(&turnstile_kstat.tsk_blocks.value.ui64);
+}
+
+void
+turnstile_init(void)
+{
+	turnstile_kstat_t *tsk = &turnstile_kstat;
+	kstat_t *ksp;
+	char name[KSTAT_STRLEN];
+	int i;
+
+	kstat_named_init(&tsk->tsk_blocks, "blocks", KSTAT_DATA_UINT64);
+	kstat_named_init(&tsk->tsk_pi_fastpath, "pi_fastpath",
+	    KSTAT_DATA_UINT64);
+	kstat_named_init(&tsk->tsk_max_chain_depth, "max_chain_depth",
+	    KSTAT_DATA_UINT32);
+
+	for (i = 0; i < TURNSTILE_HIST_BUCKETS; i++) {
+		if (i < TURNSTILE_HIST_BUCKETS - 1) {
+			(void) snprintf(name, sizeof (name), "block_ns_lt_%llu",
+			    1ULL << (TURNSTILE_HIST_SHIFT + i));
+		} else {
+			(void) snprintf(name, sizeof (name), "block_ns_ge_%llu",
+			    1ULL << (TURNSTILE_HIST_SHIFT + i - 1));
+		}
+		kstat_named_init(&tsk->tsk_hist[i], name, KSTAT_DATA_UINT64);
+	}
+
+	ksp = kstat_create("unix", 0, "turnstile", "misc", KSTAT_TYPE_NAMED,
+	    sizeof (turnstile_kstat) / sizeof (kstat_named_t),
+	    KSTAT_FLAG_VIRTUAL);
+	if (ksp != NULL) {
+		ksp->ks_data = tsk;
+		kstat_install(ksp);
+	}
+}
+
 /*
  * Make 'inheritor' inherit priority from this turnstile.
  */
@@ -430,6 +522,11 @@ turnstile_block(turnstile_t *ts, int qnum, void *sobj, sobj_ops_t *sobj_ops,
 		ts->ts_next = tc->tc_first;
 		tc->tc_first = ts;
 		ASSERT(ts->ts_waiters == 0);
+		if (++tc->tc_count >
+		    turnstile_kstat.tsk_max_chain_depth.value.ui32) {
+			turnstile_kstat.tsk_max_chain_depth.value.ui32 =
+			    tc->tc_count;
+		}
 	} else {
 		/*
 		 * Another thread has already donated its turnstile
@@ -523,6 +620,25 @@ turnstile_block(turnstile_t *ts, int qnum, void *sobj, sobj_ops_t *sobj_ops,
 			lwp->lwp_sysabort = 0;
 			return (EDEADLK);
 		}
+		/*
+		 * If the owner isn't itself blocked and is already running
+		 * at a priority at least that of 't', willing t's priority
+		 * to it would be a no-op, so skip the interlock dance
+		 * entirely.  Both reads of the owner are done without its
+		 * thread lock, but the races are benign: if the owner's
+		 * priority drops an instant after we look, we're no worse
+		 * off than if turnstile_pi_inherit() had declined to link
+		 * us in just before the drop, and if the owner blocks just
+		 * after we look, its own walk of the blocking chain will
+		 * both apply inheritance and detect any cycle through us.
+		 */
+		if (turnstile_pi_fastpath &&
+		    SOBJ_TYPE(sobj_ops) != SOBJ_USER_PI &&
+		    owner->t_sobj_ops == NULL && DISP_PRIO(t) <= owner->t_pri) {
+			atomic_inc_64(
+			    &turnstile_kstat.tsk_pi_fastpath.value.ui64);
+			break;
+		}
 		if (!turnstile_interlock(t->t_lockp, &owner->t_lockp)) {
 			/*
 			 * If we failed to grab the owner's thread lock,
@@ -610,6 +726,7 @@ turnstile_block(turnstile_t *ts, int qnum, void *sobj, sobj_ops_t *sobj_ops,
 		int timedwait = 0;
 		uint_t imm_timeout = 0;
 		clock_t tim = -1;
+		hrtime_t sleep_start;
 
 		thread_unlock_high(t);
 		if (lwptp->lwpt_id != 0) {
@@ -628,7 +745,9 @@ turnstile_block(turnstile_t *ts, int qnum, void *sobj, sobj_ops_t *sobj_ops,
 		if (ISSIG(curthread, JUSTLOOKING) ||
 		    MUSTRETURN(p, curthread) || imm_timeout)
 			setrun(curthread);
+		sleep_start = gethrtime();
 		swtch();
+		turnstile_block_record(gethrtime() - sleep_start);
 		curthread->t_flag &= ~T_WAKEABLE;
 		if (timedwait)
 			tim = lwp_timer_dequeue(lwptp);
@@ -641,8 +760,11 @@ turnstile_block(turnstile_t *ts, int qnum, void *sobj, sobj_ops_t *sobj_ops,
 		lwp->lwp_sysabort = 0;
 		lwp->lwp_asleep = 0;
 	} else {
+		hrtime_t sleep_start = gethrtime();
+
 		thread_unlock_nopreempt(t);
 		swtch();
+		turnstile_block_record(gethrtime() - sleep_start);
 	}
 
 	return (error);
@@ -681,6 +803,8 @@ turnstile_dequeue(kthread_t *t)
 		 * chain has to be updated.
 		 */
 		ASSERT(ts->ts_waiters == 1);
+		ASSERT(tc->tc_count > 0);
+		tc->tc_count--;
 		if (ts->ts_inheritor != NULL) {
 			(void) turnstile_pi_tsdelete(ts, ts->ts_inheritor);
 			/*
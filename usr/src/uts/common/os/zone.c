@@ -1914,6 +1914,7 @@ zone_misc_kstat_update(kstat_t *ksp, int rw)
 	zone_misc_kstat_t *zmp = ksp->ks_data;
 	hrtime_t hrtime;
 	uint64_t tmp;
+	int i;
 
 	if (rw == KSTAT_WRITE)
 		return (EACCES);
@@ -1942,14 +1943,90 @@ zone_misc_kstat_update(kstat_t *ksp, int rw)
 	zmp->zm_ffnomem.value.ui32 = zone->zone_ffnomem;
 	zmp->zm_ffmisc.value.ui32 = zone->zone_ffmisc;
 
+	zmp->zm_forks.value.ui32 = zone->zone_forks;
+	zmp->zm_exits.value.ui32 = zone->zone_exits;
+
 	zmp->zm_nested_intp.value.ui32 = zone->zone_nested_intp;
 
 	zmp->zm_init_pid.value.ui32 = zone->zone_proc_initpid;
 	zmp->zm_boot_time.value.ui64 = (uint64_t)zone->zone_boot_time;
 
+	zmp->zm_hw_util.value.ui64 = zone->zone_hw_util;
+
+	for (i = 0; i < ZONE_USTATE_WHIST_NBUCKETS; i++) {
+		zmp->zm_wait_hist[i].value.ui64 =
+		    cpu_uarray_sum(zone->zone_ustate, ZONE_USTATE_WHIST + i);
+	}
+
+	return (0);
+}
+
+/*
+ * Bill a kernel memory allocation from an attributed kmem cache (see
+ * kmem_cache_set_zone_class()) to the allocating zone.
+ */
+void
+zone_kmem_bill(uint_t zclass, uint64_t count)
+{
+	ASSERT(zclass >= 1 && zclass <= ZONE_KMEM_NCLASSES);
+
+	atomic_add_64(&curzone->zone_kmem_allocs[zclass - 1], count);
+}
+
+static int
+zone_kmem_kstat_update(kstat_t *ksp, int rw)
+{
+	zone_t *zone = ksp->ks_private;
+	zone_kmem_kstat_t *zkp = ksp->ks_data;
+	int i;
+
+	if (rw == KSTAT_WRITE)
+		return (EACCES);
+
+	for (i = 0; i < ZONE_KMEM_NCLASSES; i++)
+		zkp->zm_allocs[i].value.ui64 = zone->zone_kmem_allocs[i];
+
 	return (0);
 }
 
+static kstat_t *
+zone_kmem_kstat_create(zone_t *zone)
+{
+	kstat_t *ksp;
+	zone_kmem_kstat_t *zkp;
+
+	if ((ksp = kstat_create_zone("zones", zone->zone_id,
+	    zone->zone_name, "zone_kmem", KSTAT_TYPE_NAMED,
+	    sizeof (zone_kmem_kstat_t) / sizeof (kstat_named_t),
+	    KSTAT_FLAG_VIRTUAL, zone->zone_id)) == NULL)
+		return (NULL);
+
+	if (zone->zone_id != GLOBAL_ZONEID)
+		kstat_zone_add(ksp, GLOBAL_ZONEID);
+
+	zkp = ksp->ks_data = kmem_zalloc(sizeof (zone_kmem_kstat_t), KM_SLEEP);
+	ksp->ks_data_size += strlen(zone->zone_name) + 1;
+	zone->zone_kmem_stats = zkp;
+
+	/* The kstat "name" field is not large enough for a full zonename */
+	kstat_named_init(&zkp->zm_zonename, "zonename", KSTAT_DATA_STRING);
+	kstat_named_setstr(&zkp->zm_zonename, zone->zone_name);
+	kstat_named_init(&zkp->zm_allocs[ZONE_KMEM_CLASS_CONN - 1],
+	    "conn_allocs", KSTAT_DATA_UINT64);
+	kstat_named_init(&zkp->zm_allocs[ZONE_KMEM_CLASS_VNODE - 1],
+	    "vnode_allocs", KSTAT_DATA_UINT64);
+	kstat_named_init(&zkp->zm_allocs[ZONE_KMEM_CLASS_ZNODE - 1],
+	    "znode_allocs", KSTAT_DATA_UINT64);
+	kstat_named_init(&zkp->zm_allocs[ZONE_KMEM_CLASS_MBLK - 1],
+	    "mblk_allocs", KSTAT_DATA_UINT64);
+
+	ksp->ks_update = zone_kmem_kstat_update;
+	ksp->ks_private = zone;
+
+	kstat_install(ksp);
+	return (ksp);
+}
+
 static kstat_t *
 zone_misc_kstat_create(zone_t *zone)
 {
@@ -1985,10 +2062,29 @@ zone_misc_kstat_create(zone_t *zone)
 	    KSTAT_DATA_UINT32);
 	kstat_named_init(&zmp->zm_ffnomem, "forkfail_nomem", KSTAT_DATA_UINT32);
 	kstat_named_init(&zmp->zm_ffmisc, "forkfail_misc", KSTAT_DATA_UINT32);
+	kstat_named_init(&zmp->zm_forks, "forks", KSTAT_DATA_UINT32);
+	kstat_named_init(&zmp->zm_exits, "exits", KSTAT_DATA_UINT32);
 	kstat_named_init(&zmp->zm_nested_intp, "nested_interp",
 	    KSTAT_DATA_UINT32);
 	kstat_named_init(&zmp->zm_init_pid, "init_pid", KSTAT_DATA_UINT32);
 	kstat_named_init(&zmp->zm_boot_time, "boot_time", KSTAT_DATA_UINT64);
+	kstat_named_init(&zmp->zm_hw_util, "hw_util", KSTAT_DATA_UINT64);
+	kstat_named_init(&zmp->zm_wait_hist[0], "waitrq_10us",
+	    KSTAT_DATA_UINT64);
+	kstat_named_init(&zmp->zm_wait_hist[1], "waitrq_100us",
+	    KSTAT_DATA_UINT64);
+	kstat_named_init(&zmp->zm_wait_hist[2], "waitrq_1ms",
+	    KSTAT_DATA_UINT64);
+	kstat_named_init(&zmp->zm_wait_hist[3], "waitrq_10ms",
+	    KSTAT_DATA_UINT64);
+	kstat_named_init(&zmp->zm_wait_hist[4], "waitrq_100ms",
+	    KSTAT_DATA_UINT64);
+	kstat_named_init(&zmp->zm_wait_hist[5], "waitrq_1s",
+	    KSTAT_DATA_UINT64);
+	kstat_named_init(&zmp->zm_wait_hist[6], "waitrq_10s",
+	    KSTAT_DATA_UINT64);
+	kstat_named_init(&zmp->zm_wait_hist[7], "waitrq_over",
+	    KSTAT_DATA_UINT64);
 
 	ksp->ks_update = zone_misc_kstat_update;
 	ksp->ks_private = zone;
@@ -2016,6 +2112,11 @@ zone_kstat_create(zone_t *zone)
 		zone->zone_misc_stats = kmem_zalloc(
 		    sizeof (zone_misc_kstat_t), KM_SLEEP);
 	}
+
+	if ((zone->zone_kmem_ksp = zone_kmem_kstat_create(zone)) == NULL) {
+		zone->zone_kmem_stats = kmem_zalloc(
+		    sizeof (zone_kmem_kstat_t), KM_SLEEP);
+	}
 }
 
 static void
@@ -2044,6 +2145,8 @@ zone_kstat_delete(zone_t *zone)
 	    sizeof (zone_mcap_kstat_t));
 	zone_kstat_delete_common(&zone->zone_misc_ksp,
 	    sizeof (zone_misc_kstat_t));
+	zone_kstat_delete_common(&zone->zone_kmem_ksp,
+	    sizeof (zone_kmem_kstat_t));
 }
 
 /*
@@ -3242,7 +3345,15 @@ zone_loadavg_update(void)
 		 */
 		lavg = &zp->zone_loadavg;
 
-		tmp = cpu_uarray_sum_all(zp->zone_ustate);
+		/*
+		 * Sum only the time-valued slots; the wait histogram
+		 * slots hold event counts, not time.
+		 */
+		tmp = cpu_uarray_sum(zp->zone_ustate, ZONE_USTATE_STIME);
+		tmp = UINT64_OVERFLOW_ADD(tmp,
+		    cpu_uarray_sum(zp->zone_ustate, ZONE_USTATE_UTIME));
+		tmp = UINT64_OVERFLOW_ADD(tmp,
+		    cpu_uarray_sum(zp->zone_ustate, ZONE_USTATE_WTIME));
 		zone_total = UINT64_OVERFLOW_TO_INT64(tmp);
 
 		scalehrtime(&zone_total);
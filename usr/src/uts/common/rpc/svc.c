@@ -207,6 +207,7 @@
 #include <sys/callb.h>
 #include <sys/vtrace.h>
 #include <sys/zone.h>
+#include <sys/kstat.h>
 #include <nfs/nfs.h>
 #include <sys/tsol/label_macro.h>
 
@@ -292,6 +293,41 @@ int rdma_check = 0;
  */
 volatile int svc_flowcontrol_disable = 0;
 
+/*
+ * Target queue wait in microseconds for latency-driven thread creation.
+ * The queue wait - the time a request sits on a transport queue before
+ * a service thread picks it up - is sampled (one in-flight sample per
+ * pool, so the common enqueue/dequeue paths pay a stamp and a subtract,
+ * not a per-request history) and smoothed into a moving average. When
+ * the average exceeds this target and the pool is below its maxthreads
+ * limit, the thread creator is signaled even though threads appear
+ * available, since the wakeup heuristics alone are evidently not
+ * keeping up. Zero disables the latency trigger. The sampled wait
+ * distribution is exported through each pool's `svc_pool' kstat.
+ */
+volatile uint_t svc_qwait_target = 1000;
+
+/*
+ * Per-pool queue wait kstats; see svc_qwait_update().
+ */
+typedef struct svc_pool_kstat {
+	kstat_named_t	pks_qwait_avg;		/* smoothed wait, usec */
+	kstat_named_t	pks_qwait_lt100us;	/* samples under 100us */
+	kstat_named_t	pks_qwait_lt1ms;	/* samples under 1ms */
+	kstat_named_t	pks_qwait_lt10ms;	/* samples under 10ms */
+	kstat_named_t	pks_qwait_ge10ms;	/* samples of 10ms or more */
+	kstat_named_t	pks_qwait_threads;	/* latency-driven creates */
+} svc_pool_kstat_t;
+
+static const svc_pool_kstat_t svc_pool_kstat_template = {
+	{ "qwait_avg_usec",	KSTAT_DATA_UINT64 },
+	{ "qwait_lt100us",	KSTAT_DATA_UINT64 },
+	{ "qwait_lt1ms",	KSTAT_DATA_UINT64 },
+	{ "qwait_lt10ms",	KSTAT_DATA_UINT64 },
+	{ "qwait_ge10ms",	KSTAT_DATA_UINT64 },
+	{ "qwait_threads",	KSTAT_DATA_UINT64 },
+};
+
 /*
  * Authentication parameters list.
  */
@@ -372,6 +408,32 @@ svc_init()
 	svc_clts_init();
 }
 
+/*
+ * Fold a sampled queue wait (nanoseconds) into the pool's moving
+ * average and wait distribution. Called with the pool's request lock
+ * held, from the dequeue path in svc_run().
+ */
+static void
+svc_qwait_update(SVCPOOL *pool, hrtime_t wait)
+{
+	svc_pool_kstat_t *pks = pool->p_qwstats;
+
+	ASSERT(MUTEX_HELD(&pool->p_req_lock));
+
+	pool->p_qwait_ewma = (3 * pool->p_qwait_ewma + wait) / 4;
+	if (pks == NULL)
+		return;
+	pks->pks_qwait_avg.value.ui64 = pool->p_qwait_ewma / 1000;
+	if (wait < 100 * (NANOSEC / MICROSEC))
+		pks->pks_qwait_lt100us.value.ui64++;
+	else if (wait < NANOSEC / MILLISEC)
+		pks->pks_qwait_lt1ms.value.ui64++;
+	else if (wait < 10 * (NANOSEC / MILLISEC))
+		pks->pks_qwait_lt10ms.value.ui64++;
+	else
+		pks->pks_qwait_ge10ms.value.ui64++;
+}
+
 /*
  * Destroy the SVCPOOL structure.
  */
@@ -390,6 +452,12 @@ svc_pool_cleanup(SVCPOOL *pool)
 	if (pool->p_shutdown != NULL)
 		(pool->p_shutdown)();
 
+	/* Remove the queue wait statistics */
+	if (pool->p_kstat != NULL)
+		kstat_delete(pool->p_kstat);
+	if (pool->p_qwstats != NULL)
+		kmem_free(pool->p_qwstats, sizeof (svc_pool_kstat_t));
+
 	/* Destroy `xprt-ready' queue */
 	svc_xprt_qdestroy(pool);
 
@@ -570,6 +638,19 @@ svc_pool_register(struct svc_globals *svc, SVCPOOL *pool, int id)
 	svc->svc_pools = pool;
 
 	mutex_exit(&svc->svc_plock);
+
+	/* Export the queue wait statistics for this pool */
+	pool->p_qwstats = kmem_alloc(sizeof (svc_pool_kstat_t), KM_SLEEP);
+	bcopy(&svc_pool_kstat_template, pool->p_qwstats,
+	    sizeof (svc_pool_kstat_t));
+	pool->p_kstat = kstat_create_zone("unix", id, "svc_pool", "rpc",
+	    KSTAT_TYPE_NAMED,
+	    sizeof (svc_pool_kstat_t) / sizeof (kstat_named_t),
+	    KSTAT_FLAG_VIRTUAL, getzoneid());
+	if (pool->p_kstat != NULL) {
+		pool->p_kstat->ks_data = pool->p_qwstats;
+		kstat_install(pool->p_kstat);
+	}
 }
 
 /*
@@ -2277,6 +2358,11 @@ svc_run(SVCPOOL *pool)
 		if (pool->p_reqs == 0)
 			pool->p_qoverflow = FALSE;
 		pool->p_size -= size;
+		if (pool->p_qwait_stamp != 0) {
+			svc_qwait_update(pool,
+			    gethrtime() - pool->p_qwait_stamp);
+			pool->p_qwait_stamp = 0;
+		}
 		mutex_exit(&pool->p_req_lock);
 
 		next->xp_reqs--;
@@ -2341,6 +2427,22 @@ svc_run(SVCPOOL *pool)
 		    pool->p_threads + pool->p_detached_threads <
 		    pool->p_maxthreads)
 			svc_creator_signal(pool);
+		else if (svc_qwait_target != 0 && !pool->p_creator_signaled &&
+		    pool->p_qwait_ewma > (hrtime_t)svc_qwait_target *
+		    (NANOSEC / MICROSEC) &&
+		    pool->p_threads + pool->p_detached_threads <
+		    pool->p_maxthreads) {
+			/*
+			 * Threads appear available, but requests are
+			 * still waiting longer than the target; grow
+			 * the pool anyway. The unlocked checks are as
+			 * advisory as the ones above.
+			 */
+			if (pool->p_qwstats != NULL)
+				pool->p_qwstats->
+				    pks_qwait_threads.value.ui64++;
+			svc_creator_signal(pool);
+		}
 
 		/*
 		 * Process the request.
@@ -2547,6 +2649,10 @@ svc_queuereq(queue_t *q, mblk_t *mp, bool_t flowcontrol)
 	xprt->xp_size += size;
 	pool->p_size += size;
 
+	/* Sample the queue wait: stamp one in-flight request at a time */
+	if (pool->p_qwait_stamp == 0)
+		pool->p_qwait_stamp = gethrtime();
+
 	/* Handle flow control */
 	if (flowcontrol)
 		svc_flowcontrol(xprt);
@@ -368,6 +368,15 @@ struct __svcpool {
 	void		(*p_shutdown)();	/* callout for shutdown */
 
 	size_t		p_size;			/* Total size of queued msgs */
+
+	/*
+	 * Queue wait tracking (see svc_qwait_update()).
+	 * p_qwait_stamp and p_qwait_ewma are protected by p_req_lock.
+	 */
+	hrtime_t	p_qwait_stamp;		/* sampled enqueue time */
+	hrtime_t	p_qwait_ewma;		/* smoothed queue wait, nsec */
+	struct kstat	*p_kstat;		/* pool kstat */
+	struct svc_pool_kstat *p_qwstats;	/* queue wait kstat data */
 };
 
 /*
@@ -755,28 +755,43 @@ svc_clts_kfreeres(SVCXPRT *clone_xprt)
 #define	MAXDUPREQS	8192
 
 /*
- * This should be appropriately scaled to MAXDUPREQS.  To produce as less as
- * possible collisions it is suggested to set this to a prime.
+ * The cache is split into DRNSHARDS shards, each with its own lock,
+ * hash table and lru list, selected by the low bits of the xid.  This
+ * keeps concurrent requests from different clients (which draw their
+ * xids independently) from serializing on a single cache lock.
+ * DRNSHARDS must be a power of two.
  */
-#define	DRHASHSZ	2053
+#define	DRNSHARDS	16
 
-#define	XIDHASH(xid)	((xid) % DRHASHSZ)
+/*
+ * This is the number of hash buckets per shard and should be
+ * appropriately scaled to MAXDUPREQS / DRNSHARDS.  To produce as less
+ * as possible collisions it is suggested to set this to a prime.
+ */
+#define	DRHASHSZ	257
+
+#define	XIDSHARD(xid)	((xid) & (DRNSHARDS - 1))
+#define	XIDHASH(xid)	(((xid) / DRNSHARDS) % DRHASHSZ)
 #define	DRHASH(dr)	XIDHASH((dr)->dr_xid)
 #define	REQTOXID(req)	((req)->rq_xprt->xp_xid)
 
-static int	ndupreqs = 0;
 int	maxdupreqs = MAXDUPREQS;
-static kmutex_t dupreq_lock;
-static struct dupreq *drhashtbl[DRHASHSZ];
-static int	drhashstat[DRHASHSZ];
-
-static void unhash(struct dupreq *);
 
 /*
- * drmru points to the head of a circular linked list in lru order.
- * drmru->dr_next == drlru
+ * dc_mru points to the head of a circular linked list in lru order.
+ * dc_mru->dr_next is the least recently used entry of the shard.
  */
-struct dupreq *drmru;
+typedef struct clts_drcache {
+	kmutex_t	dc_lock;
+	int		dc_ndupreqs;
+	struct dupreq	*dc_mru;
+	struct dupreq	*dc_hashtbl[DRHASHSZ];
+	int		dc_hashstat[DRHASHSZ];
+} clts_drcache_t;
+
+static clts_drcache_t drcache[DRNSHARDS];
+
+static void unhash(clts_drcache_t *, struct dupreq *);
 
 /*
  * PSARC 2003/523 Contract Private Interface
@@ -800,18 +815,20 @@ svc_clts_kdup(struct svc_req *req, caddr_t res, int size, struct dupreq **drpp,
     bool_t *dupcachedp)
 {
 	struct rpc_clts_server *stats = CLONE2STATS(req->rq_xprt);
+	clts_drcache_t *dc;
 	struct dupreq *dr;
 	uint32_t xid;
 	uint32_t drhash;
 	int status;
 
 	xid = REQTOXID(req);
-	mutex_enter(&dupreq_lock);
+	dc = &drcache[XIDSHARD(xid)];
+	mutex_enter(&dc->dc_lock);
 	RSSTAT_INCR(stats, rsdupchecks);
 	/*
 	 * Check to see whether an entry already exists in the cache.
 	 */
-	dr = drhashtbl[XIDHASH(xid)];
+	dr = dc->dc_hashtbl[XIDHASH(xid)];
 	while (dr != NULL) {
 		if (dr->dr_xid == xid &&
 		    dr->dr_proc == req->rq_proc &&
@@ -830,7 +847,7 @@ svc_clts_kdup(struct svc_req *req, caddr_t res, int size, struct dupreq **drpp,
 				*drpp = dr;
 			}
 			RSSTAT_INCR(stats, rsdupreqs);
-			mutex_exit(&dupreq_lock);
+			mutex_exit(&dc->dc_lock);
 			return (status);
 		}
 		dr = dr->dr_chain;
@@ -840,40 +857,40 @@ svc_clts_kdup(struct svc_req *req, caddr_t res, int size, struct dupreq **drpp,
 	 * There wasn't an entry, either allocate a new one or recycle
 	 * an old one.
 	 */
-	if (ndupreqs < maxdupreqs) {
+	if (dc->dc_ndupreqs < maxdupreqs / DRNSHARDS) {
 		dr = kmem_alloc(sizeof (*dr), KM_NOSLEEP);
 		if (dr == NULL) {
-			mutex_exit(&dupreq_lock);
+			mutex_exit(&dc->dc_lock);
 			return (DUP_ERROR);
 		}
 		dr->dr_resp.buf = NULL;
 		dr->dr_resp.maxlen = 0;
 		dr->dr_addr.buf = NULL;
 		dr->dr_addr.maxlen = 0;
-		if (drmru) {
-			dr->dr_next = drmru->dr_next;
-			drmru->dr_next = dr;
+		if (dc->dc_mru) {
+			dr->dr_next = dc->dc_mru->dr_next;
+			dc->dc_mru->dr_next = dr;
 		} else {
 			dr->dr_next = dr;
 		}
-		ndupreqs++;
+		dc->dc_ndupreqs++;
 	} else {
-		dr = drmru->dr_next;
+		dr = dc->dc_mru->dr_next;
 		while (dr->dr_status == DUP_INPROGRESS) {
 			dr = dr->dr_next;
-			if (dr == drmru->dr_next) {
+			if (dr == dc->dc_mru->dr_next) {
 				cmn_err(CE_WARN, "svc_clts_kdup no slots free");
-				mutex_exit(&dupreq_lock);
+				mutex_exit(&dc->dc_lock);
 				return (DUP_ERROR);
 			}
 		}
-		unhash(dr);
+		unhash(dc, dr);
 		if (dr->dr_resfree) {
 			(*dr->dr_resfree)(dr->dr_resp.buf);
 		}
 	}
 	dr->dr_resfree = NULL;
-	drmru = dr;
+	dc->dc_mru = dr;
 
 	dr->dr_xid = REQTOXID(req);
 	dr->dr_prog = req->rq_prog;
@@ -888,7 +905,7 @@ svc_clts_kdup(struct svc_req *req, caddr_t res, int size, struct dupreq **drpp,
 		if (dr->dr_addr.buf == NULL) {
 			dr->dr_addr.maxlen = 0;
 			dr->dr_status = DUP_DROP;
-			mutex_exit(&dupreq_lock);
+			mutex_exit(&dc->dc_lock);
 			return (DUP_ERROR);
 		}
 	}
@@ -902,17 +919,17 @@ svc_clts_kdup(struct svc_req *req, caddr_t res, int size, struct dupreq **drpp,
 		if (dr->dr_resp.buf == NULL) {
 			dr->dr_resp.maxlen = 0;
 			dr->dr_status = DUP_DROP;
-			mutex_exit(&dupreq_lock);
+			mutex_exit(&dc->dc_lock);
 			return (DUP_ERROR);
 		}
 	}
 	dr->dr_status = DUP_INPROGRESS;
 
 	drhash = (uint32_t)DRHASH(dr);
-	dr->dr_chain = drhashtbl[drhash];
-	drhashtbl[drhash] = dr;
-	drhashstat[drhash]++;
-	mutex_exit(&dupreq_lock);
+	dr->dr_chain = dc->dc_hashtbl[drhash];
+	dc->dc_hashtbl[drhash] = dr;
+	dc->dc_hashstat[drhash]++;
+	mutex_exit(&dc->dc_lock);
 	*drpp = dr;
 	return (DUP_NEW);
 }
@@ -940,24 +957,24 @@ svc_clts_kdupdone(struct dupreq *dr, caddr_t res, void (*dis_resfree)(),
 }
 
 /*
- * This routine expects that the mutex, dupreq_lock, is already held.
+ * This routine expects that the shard's lock, dc->dc_lock, is already held.
  */
 static void
-unhash(struct dupreq *dr)
+unhash(clts_drcache_t *dc, struct dupreq *dr)
 {
 	struct dupreq *drt;
 	struct dupreq *drtprev = NULL;
 	uint32_t drhash;
 
-	ASSERT(MUTEX_HELD(&dupreq_lock));
+	ASSERT(MUTEX_HELD(&dc->dc_lock));
 
 	drhash = (uint32_t)DRHASH(dr);
-	drt = drhashtbl[drhash];
+	drt = dc->dc_hashtbl[drhash];
 	while (drt != NULL) {
 		if (drt == dr) {
-			drhashstat[drhash]--;
+			dc->dc_hashstat[drhash]--;
 			if (drtprev == NULL) {
-				drhashtbl[drhash] = drt->dr_chain;
+				dc->dc_hashtbl[drhash] = drt->dr_chain;
 			} else {
 				drtprev->dr_chain = drt->dr_chain;
 			}
@@ -1001,6 +1018,8 @@ svc_clts_stats_fini(zoneid_t zoneid, struct rpc_clts_server **statsp)
 void
 svc_clts_init()
 {
+	int i;
+
 	/*
 	 * Check to make sure that the clts private data will fit into
 	 * the stack buffer allocated by svc_run.  The compiler should
@@ -1010,5 +1029,6 @@ svc_clts_init()
 	/*CONSTANTCONDITION*/
 	ASSERT(sizeof (struct udp_data) <= SVC_P2LEN);
 
-	mutex_init(&dupreq_lock, NULL, MUTEX_DEFAULT, NULL);
+	for (i = 0; i < DRNSHARDS; i++)
+		mutex_init(&drcache[i].dc_lock, NULL, MUTEX_DEFAULT, NULL);
 }
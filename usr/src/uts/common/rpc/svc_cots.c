@@ -721,28 +721,43 @@ svc_cots_kfreeres(SVCXPRT *clone_xprt)
 #define	MAXDUPREQS	8192
 
 /*
- * This should be appropriately scaled to MAXDUPREQS.  To produce as less as
- * possible collisions it is suggested to set this to a prime.
+ * The cache is split into DRNSHARDS shards, each with its own lock,
+ * hash table and lru list, selected by the low bits of the xid.  This
+ * keeps concurrent requests from different clients (which draw their
+ * xids independently) from serializing on a single cache lock.
+ * DRNSHARDS must be a power of two.
  */
-#define	DRHASHSZ	2053
+#define	DRNSHARDS	16
 
-#define	XIDHASH(xid)	((xid) % DRHASHSZ)
+/*
+ * This is the number of hash buckets per shard and should be
+ * appropriately scaled to MAXDUPREQS / DRNSHARDS.  To produce as less
+ * as possible collisions it is suggested to set this to a prime.
+ */
+#define	DRHASHSZ	257
+
+#define	XIDSHARD(xid)	((xid) & (DRNSHARDS - 1))
+#define	XIDHASH(xid)	(((xid) / DRNSHARDS) % DRHASHSZ)
 #define	DRHASH(dr)	XIDHASH((dr)->dr_xid)
 #define	REQTOXID(req)	((req)->rq_xprt->xp_xid)
 
-static int	cotsndupreqs = 0;
 int	cotsmaxdupreqs = MAXDUPREQS;
-static kmutex_t cotsdupreq_lock;
-static struct dupreq *cotsdrhashtbl[DRHASHSZ];
-static int	cotsdrhashstat[DRHASHSZ];
-
-static void unhash(struct dupreq *);
 
 /*
- * cotsdrmru points to the head of a circular linked list in lru order.
- * cotsdrmru->dr_next == drlru
+ * dc_mru points to the head of a circular linked list in lru order.
+ * dc_mru->dr_next is the least recently used entry of the shard.
  */
-struct dupreq *cotsdrmru;
+typedef struct cots_drcache {
+	kmutex_t	dc_lock;
+	int		dc_ndupreqs;
+	struct dupreq	*dc_mru;
+	struct dupreq	*dc_hashtbl[DRHASHSZ];
+	int		dc_hashstat[DRHASHSZ];
+} cots_drcache_t;
+
+static cots_drcache_t cotsdrcache[DRNSHARDS];
+
+static void unhash(cots_drcache_t *, struct dupreq *);
 
 /*
  * PSARC 2003/523 Contract Private Interface
@@ -766,18 +781,20 @@ svc_cots_kdup(struct svc_req *req, caddr_t res, int size, struct dupreq **drpp,
     bool_t *dupcachedp)
 {
 	struct rpc_cots_server *stats = CLONE2STATS(req->rq_xprt);
+	cots_drcache_t *dc;
 	struct dupreq *dr;
 	uint32_t xid;
 	uint32_t drhash;
 	int status;
 
 	xid = REQTOXID(req);
-	mutex_enter(&cotsdupreq_lock);
+	dc = &cotsdrcache[XIDSHARD(xid)];
+	mutex_enter(&dc->dc_lock);
 	RSSTAT_INCR(stats, rsdupchecks);
 	/*
 	 * Check to see whether an entry already exists in the cache.
 	 */
-	dr = cotsdrhashtbl[XIDHASH(xid)];
+	dr = dc->dc_hashtbl[XIDHASH(xid)];
 	while (dr != NULL) {
 		if (dr->dr_xid == xid &&
 		    dr->dr_proc == req->rq_proc &&
@@ -802,7 +819,7 @@ svc_cots_kdup(struct svc_req *req, caddr_t res, int size, struct dupreq **drpp,
 				    "svc_cots_kdup: DUP_INPROGRESS");
 			}
 			RSSTAT_INCR(stats, rsdupreqs);
-			mutex_exit(&cotsdupreq_lock);
+			mutex_exit(&dc->dc_lock);
 			return (status);
 		}
 		dr = dr->dr_chain;
@@ -812,40 +829,40 @@ svc_cots_kdup(struct svc_req *req, caddr_t res, int size, struct dupreq **drpp,
 	 * There wasn't an entry, either allocate a new one or recycle
 	 * an old one.
 	 */
-	if (cotsndupreqs < cotsmaxdupreqs) {
+	if (dc->dc_ndupreqs < cotsmaxdupreqs / DRNSHARDS) {
 		dr = kmem_alloc(sizeof (*dr), KM_NOSLEEP);
 		if (dr == NULL) {
-			mutex_exit(&cotsdupreq_lock);
+			mutex_exit(&dc->dc_lock);
 			return (DUP_ERROR);
 		}
 		dr->dr_resp.buf = NULL;
 		dr->dr_resp.maxlen = 0;
 		dr->dr_addr.buf = NULL;
 		dr->dr_addr.maxlen = 0;
-		if (cotsdrmru) {
-			dr->dr_next = cotsdrmru->dr_next;
-			cotsdrmru->dr_next = dr;
+		if (dc->dc_mru) {
+			dr->dr_next = dc->dc_mru->dr_next;
+			dc->dc_mru->dr_next = dr;
 		} else {
 			dr->dr_next = dr;
 		}
-		cotsndupreqs++;
+		dc->dc_ndupreqs++;
 	} else {
-		dr = cotsdrmru->dr_next;
+		dr = dc->dc_mru->dr_next;
 		while (dr->dr_status == DUP_INPROGRESS) {
 			dr = dr->dr_next;
-			if (dr == cotsdrmru->dr_next) {
+			if (dr == dc->dc_mru->dr_next) {
 				cmn_err(CE_WARN, "svc_cots_kdup no slots free");
-				mutex_exit(&cotsdupreq_lock);
+				mutex_exit(&dc->dc_lock);
 				return (DUP_ERROR);
 			}
 		}
-		unhash(dr);
+		unhash(dc, dr);
 		if (dr->dr_resfree) {
 			(*dr->dr_resfree)(dr->dr_resp.buf);
 		}
 	}
 	dr->dr_resfree = NULL;
-	cotsdrmru = dr;
+	dc->dc_mru = dr;
 
 	dr->dr_xid = REQTOXID(req);
 	dr->dr_prog = req->rq_prog;
@@ -859,7 +876,7 @@ svc_cots_kdup(struct svc_req *req, caddr_t res, int size, struct dupreq **drpp,
 		if (dr->dr_addr.buf == NULL) {
 			dr->dr_addr.maxlen = 0;
 			dr->dr_status = DUP_DROP;
-			mutex_exit(&cotsdupreq_lock);
+			mutex_exit(&dc->dc_lock);
 			return (DUP_ERROR);
 		}
 	}
@@ -873,17 +890,17 @@ svc_cots_kdup(struct svc_req *req, caddr_t res, int size, struct dupreq **drpp,
 		if (dr->dr_resp.buf == NULL) {
 			dr->dr_resp.maxlen = 0;
 			dr->dr_status = DUP_DROP;
-			mutex_exit(&cotsdupreq_lock);
+			mutex_exit(&dc->dc_lock);
 			return (DUP_ERROR);
 		}
 	}
 	dr->dr_status = DUP_INPROGRESS;
 
 	drhash = (uint32_t)DRHASH(dr);
-	dr->dr_chain = cotsdrhashtbl[drhash];
-	cotsdrhashtbl[drhash] = dr;
-	cotsdrhashstat[drhash]++;
-	mutex_exit(&cotsdupreq_lock);
+	dr->dr_chain = dc->dc_hashtbl[drhash];
+	dc->dc_hashtbl[drhash] = dr;
+	dc->dc_hashstat[drhash]++;
+	mutex_exit(&dc->dc_lock);
 	*drpp = dr;
 	return (DUP_NEW);
 }
@@ -910,24 +927,24 @@ svc_cots_kdupdone(struct dupreq *dr, caddr_t res, void (*dis_resfree)(),
 }
 
 /*
- * This routine expects that the mutex, cotsdupreq_lock, is already held.
+ * This routine expects that the shard's lock, dc->dc_lock, is already held.
  */
 static void
-unhash(struct dupreq *dr)
+unhash(cots_drcache_t *dc, struct dupreq *dr)
 {
 	struct dupreq *drt;
 	struct dupreq *drtprev = NULL;
 	uint32_t drhash;
 
-	ASSERT(MUTEX_HELD(&cotsdupreq_lock));
+	ASSERT(MUTEX_HELD(&dc->dc_lock));
 
 	drhash = (uint32_t)DRHASH(dr);
-	drt = cotsdrhashtbl[drhash];
+	drt = dc->dc_hashtbl[drhash];
 	while (drt != NULL) {
 		if (drt == dr) {
-			cotsdrhashstat[drhash]--;
+			dc->dc_hashstat[drhash]--;
 			if (drtprev == NULL) {
-				cotsdrhashtbl[drhash] = drt->dr_chain;
+				dc->dc_hashtbl[drhash] = drt->dr_chain;
 			} else {
 				drtprev->dr_chain = drt->dr_chain;
 			}
@@ -956,6 +973,8 @@ svc_cots_stats_fini(zoneid_t zoneid, struct rpc_cots_server **statsp)
 void
 svc_cots_init(void)
 {
+	int i;
+
 	/*
 	 * Check to make sure that the cots private data will fit into
 	 * the stack buffer allocated by svc_run.  The ASSERT is a safety
@@ -965,5 +984,6 @@ svc_cots_init(void)
 	ASSERT(sizeof (cots_data_t) <= SVC_P2LEN);
 
 	mutex_init(&cots_kcreate_lock, NULL, MUTEX_DEFAULT, NULL);
-	mutex_init(&cotsdupreq_lock, NULL, MUTEX_DEFAULT, NULL);
+	for (i = 0; i < DRNSHARDS; i++)
+		mutex_init(&cotsdrcache[i].dc_lock, NULL, MUTEX_DEFAULT, NULL);
 }
@@ -650,6 +650,8 @@ int smb_session_send(smb_session_t *, uint8_t type, mbuf_chain_t *);
 int smb_session_xprt_gethdr(smb_session_t *, smb_xprt_t *);
 boolean_t smb_session_oplocks_enable(smb_session_t *);
 boolean_t smb_session_levelII_oplocks(smb_session_t *);
+void smb_session_disp_request(smb_request_t *, task_func_t);
+void smb_session_disp_release(smb_request_t *);
 
 #define	SMB_SESSION_GET_ID(s)	((s)->s_kid)
 
@@ -787,6 +789,7 @@ int smb_xa_complete(smb_xa_t *xa);
 smb_xa_t *smb_xa_find(smb_session_t *session, uint32_t pid, uint16_t mid);
 
 struct mbuf *smb_mbuf_get(uchar_t *buf, int nbytes);
+struct mbuf *smb_mbuf_alloc_chain(int len);
 struct mbuf *smb_mbuf_allocate(struct uio *uio);
 void smb_mbuf_trim(struct mbuf *mhead, int nbytes);
 
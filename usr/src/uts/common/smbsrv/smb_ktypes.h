@@ -953,6 +953,12 @@ typedef struct smb_session {
 
 	ksocket_t		sock;
 
+	/* Per-session limit on worker pool usage. */
+	kmutex_t		s_tq_mutex;
+	uint32_t		s_tq_active;
+	uint32_t		s_tq_waiting;
+	list_t			s_tq_waitq;
+
 	smb_slist_t		s_req_list;
 	smb_llist_t		s_xa_list;
 	smb_llist_t		s_user_list;
@@ -1823,6 +1829,11 @@ typedef struct smb_request {
 
 	list_node_t		sr_waiters;	/* smb_notify.c */
 
+	/* Per-session worker limit.  See smb_session_disp_request. */
+	list_node_t		sr_tq_lnd;	/* session->s_tq_waitq */
+	task_func_t		*sr_tq_func;
+	boolean_t		sr_tq_counted;	/* holds an s_tq_active slot */
+
 	/* Info from session service header */
 	uint32_t		sr_req_length; /* Excluding NBT header */
 
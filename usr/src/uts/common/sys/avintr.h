@@ -67,6 +67,15 @@ struct autovec {
 	dev_info_t *av_dip;
 	ushort_t	av_flags;	/* pending flags */
 	struct autovec *av_ipl_link;	/* pointer to next on ipl chain */
+
+	/*
+	 * Interrupt auto-tune accounting, maintained by the dispatch
+	 * paths when av_autotune_enable is set: number of times the
+	 * handler has run and the unscaled (gethrtime_unscaled) time
+	 * spent in it.
+	 */
+	uint64_t	av_dispatches;
+	uint64_t	av_cycles;
 };
 
 #define	AV_PENTRY_VECTMASK	0xff	/* low 8 bit used for irqno */
@@ -102,6 +111,22 @@ extern void rem_avintr(void *intr_id, int lvl, avfunc xxintr, int vect);
 extern void wait_till_seen(int ipl);
 extern uint_t softlevel1(caddr_t, caddr_t);
 
+/*
+ * Interrupt auto-tune framework.  When enabled, the hardware interrupt
+ * dispatch paths sample per-handler service latency and arrival rate.
+ * A driver that can trade interrupt coalescing against latency may
+ * register a callback; it is invoked periodically with the device's
+ * aggregate interrupt rate (per second) and mean service latency (in
+ * nanoseconds) over the last sampling interval, and may adjust the
+ * device's coalescing parameters in response.  The callback runs in
+ * callout context and must not block.
+ */
+typedef void (*av_autotune_cb_t)(void *, uint64_t, hrtime_t);
+
+extern int av_autotune_enable;
+extern int av_autotune_register(dev_info_t *, av_autotune_cb_t, void *);
+extern void av_autotune_unregister(dev_info_t *);
+
 #endif	/* _KERNEL */
 
 #ifdef	__cplusplus
@@ -296,6 +296,9 @@ typedef struct callout_heap {
  *	Number of callout structures allocated.
  * CALLOUT_CLEANUPS
  *	Number of times a callout table is cleaned up.
+ * CALLOUT_QUEUE_INSERTS
+ *	Number of callout lists that could not be accommodated in the heap
+ *	and fell back to the sorted overflow queue.
  */
 typedef enum callout_stat_type {
 	CALLOUT_TIMEOUTS,
@@ -306,6 +309,7 @@ typedef enum callout_stat_type {
 	CALLOUT_EXPIRATIONS,
 	CALLOUT_ALLOCATIONS,
 	CALLOUT_CLEANUPS,
+	CALLOUT_QUEUE_INSERTS,
 	CALLOUT_NUM_STATS
 } callout_stat_type_t;
 
@@ -404,6 +408,8 @@ typedef struct callout_table {
 		ct_kstat_data[CALLOUT_ALLOCATIONS].value.ui64
 #define	ct_cleanups							\
 		ct_kstat_data[CALLOUT_CLEANUPS].value.ui64
+#define	ct_queue_inserts						\
+		ct_kstat_data[CALLOUT_QUEUE_INSERTS].value.ui64
 
 /*
  * CALLOUT_CHUNK is the minimum initial size of each heap, and the amount
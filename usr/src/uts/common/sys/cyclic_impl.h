@@ -500,6 +500,7 @@ typedef struct cyc_cpu {
 	ksema_t cyp_modify_wait;
 	uint32_t cyp_modify_levels;
 	uint32_t cyp_rpend;
+	uint32_t cyp_infire;
 #ifdef CYCLIC_TRACE
 	cyc_tracebuf_t cyp_trace[CY_LEVELS];
 #endif
@@ -65,12 +65,10 @@ struct dls_link_s {				/* Protected by */
 };
 
 typedef struct dls_head_s {
-	kmutex_t		dh_lock;
 	struct dld_str_s	*dh_list;		/* dh_ref */
-	uint_t			dh_ref;			/* dh_lock */
+	uint_t			dh_ref;			/* atomic */
 	mod_hash_key_t		dh_key;			/* SL */
-	kcondvar_t		dh_cv;			/* dh_lock */
-	uint_t			dh_removing;		/* dh_lock */
+	uint_t			dh_removing;		/* see dls_link.c */
 } dls_head_t;
 
 extern mod_hash_t	*i_dls_link_hash;
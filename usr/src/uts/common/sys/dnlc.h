@@ -81,6 +81,7 @@ typedef struct ncache {
 	struct vnode *vp;		/* vnode the name refers to */
 	struct vnode *dp;		/* vnode of parent of name */
 	int hash;			/* hash signature */
+	time_t negtime;			/* when a negative entry was cached */
 	uchar_t namlen;			/* length of name */
 	char name[];			/* segment name */
 } ncache_t;
@@ -96,7 +97,7 @@ typedef struct ncache {
 typedef struct nc_hash	{
 	ncache_t *hash_next;
 	ncache_t *hash_prev;
-	kmutex_t hash_lock;
+	krwlock_t hash_lock;
 } nc_hash_t;
 
 /*
@@ -153,6 +154,10 @@ struct nc_stats {
 	kstat_named_t ncs_dir_finipurg;	/* fini purges */
 	kstat_named_t ncs_dir_rec_last;	/* reclaim last */
 	kstat_named_t ncs_dir_recl_any;	/* reclaim any */
+
+	/* negative entry aging */
+
+	kstat_named_t ncs_neg_expired;	/* negative entries aged out */
 };
 
 /*
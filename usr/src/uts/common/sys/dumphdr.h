@@ -163,9 +163,10 @@ typedef struct dumpdatahdr {
 
 #define	DUMP_DATAHDR_MAGIC	('d' << 24 | 'h' << 16 | 'd' << 8 | 'r')
 
-#define	DUMP_DATAHDR_VERSION	1
+#define	DUMP_DATAHDR_VERSION	2
 #define	DUMP_CLEVEL_LZJB	1	/* parallel lzjb compression */
 #define	DUMP_CLEVEL_BZIP2	2	/* parallel bzip2 level 1 */
+#define	DUMP_CLEVEL_LZ4		3	/* parallel lz4 */
 
 #ifdef _KERNEL
 
@@ -225,6 +225,8 @@ extern int execclose(int fd);
 extern void setregs(uarg_t *);
 extern void exec_set_sp(size_t);
 
+struct vfs;
+
 /*
  * Utility functions for branded process executing
  */
@@ -239,6 +241,9 @@ extern int mapexec_brand(vnode_t *, uarg_t *, Ehdr *, Addr *,
     intptr_t *, caddr_t, int *, caddr_t *, caddr_t *, size_t *, uintptr_t *);
 extern int elfreadhdr(vnode_t *, cred_t *, Ehdr *, uint_t *, caddr_t *,
     size_t *);
+extern void elf_hdr_cache_init(void);
+extern void elf_hdr_cache_fini(void);
+extern void elf_hdr_cache_purge_vfsp(struct vfs *);
 #endif /* !_ELF32_COMPAT */
 
 #if defined(_LP64)
@@ -248,6 +253,9 @@ extern int mapexec32_brand(vnode_t *, uarg_t *, Elf32_Ehdr *, Elf32_Addr *,
     intptr_t *, caddr_t, int *, caddr_t *, caddr_t *, size_t *, uintptr_t *);
 extern int elf32readhdr(vnode_t *, cred_t *, Elf32_Ehdr *, uint_t *, caddr_t *,
     size_t *);
+extern void elf32_hdr_cache_init(void);
+extern void elf32_hdr_cache_fini(void);
+extern void elf32_hdr_cache_purge_vfsp(struct vfs *);
 #endif  /* _LP64 */
 
 /*
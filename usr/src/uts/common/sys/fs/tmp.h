@@ -36,7 +36,9 @@ extern "C" {
 /*
  * tmpfs per-mount data structure.
  *
- * All fields are protected by tm_contents.
+ * All fields are protected by tm_contents, except tm_anonmem which is
+ * maintained atomically so page reservations don't serialize on the
+ * mount-wide lock.
  * File renames on a particular file system are protected tm_renamelck.
  */
 struct tmount {
@@ -104,6 +106,7 @@ extern	void	tdirinit(struct tmpnode *, struct tmpnode *);
 extern	void	tdirtrunc(struct tmpnode *);
 extern	void	*tmp_memalloc(size_t, int);
 extern	void	tmp_memfree(void *, size_t);
+extern	size_t	tmp_kmem_inuse(void);
 extern	int	tmp_resv(struct tmount *, struct tmpnode *, size_t, int);
 extern	int	tmp_taccess(void *, int, struct cred *);
 extern	int	tmp_sticky_remove_access(struct tmpnode *, struct tmpnode *,
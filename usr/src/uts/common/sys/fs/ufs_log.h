@@ -220,6 +220,11 @@ typedef struct ml_unit {
 	cirbuf_t	un_rdbuf;	/* read buffer space */
 	cirbuf_t	un_wrbuf;	/* write buffer space */
 
+	/*
+	 * Log occupancy kstat (for tuning logsize)
+	 */
+	struct kstat	*un_occ_ksp;
+
 	/*
 	 * Ondisk state
 	 */
@@ -128,6 +128,7 @@ typedef struct fssproc {
 	pri_t	fss_scpri;	/* remembered priority, for schedctl	*/
 	int	fss_nice;	/* nice value for compatibility with ts	*/
 	fsspri_t fss_fsspri;	/* internal fair share priority		*/
+	uint32_t fss_updgen;	/* last update pass applied to fsspri	*/
 	int	fss_runnable;	/* to indicate runnable/sleeping thread	*/
 	struct fssproc *fss_next; /* pointer to next fssproc_t struct	*/
 	struct fssproc *fss_prev; /* pointer to prev fssproc_t sturct	*/
@@ -177,7 +177,9 @@ typedef struct ipc_slot {
 	kipc_perm_t	*ipct_data;	/* data			*/
 	uint_t		ipct_seq;	/* sequence number	*/
 	struct ipc_slot	*ipct_chain;	/* for stale arrays	*/
-	char		ipct_pad[64 - sizeof (kmutex_t) - 3 * sizeof (void *)];
+	uint64_t	ipct_contended;	/* # contended lock acquisitions */
+	char		ipct_pad[64 - sizeof (kmutex_t) - 3 * sizeof (void *) -
+			    sizeof (uint64_t)];
 } ipc_slot_t;
 
 typedef void(ipc_func_t)(kipc_perm_t *);
@@ -197,6 +199,7 @@ typedef struct ipc_service {
 	ipc_func_t	*ipcs_rmid;	/* object removal		*/
 	list_t		ipcs_usedids;	/* list of allocated ids	*/
 	int		ipcs_atype;	/* audit type (see c2/audit.h)	*/
+	struct kstat	*ipcs_kstat;	/* lock contention kstat	*/
 } ipc_service_t;
 
 int ipcperm_access(kipc_perm_t *, int, cred_t *);
@@ -143,6 +143,7 @@ typedef struct _klwp {
 		hrtime_t ms_term;		/* lwp termination time */
 		hrtime_t ms_state_start;	/* start time of this mstate */
 		hrtime_t ms_acct[NMSTATES];	/* per mstate accounting */
+		hrtime_t ms_sysc_start;		/* start of current syscall */
 	} lwp_mstate;
 
 	/*
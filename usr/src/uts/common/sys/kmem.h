@@ -126,6 +126,7 @@ extern kmem_cache_t *kmem_cache_create(char *, size_t, size_t,
 	void (*)(void *), void *, vmem_t *, int);
 extern void kmem_cache_set_move(kmem_cache_t *,
 	kmem_cbrc_t (*)(void *, void *, size_t, void *));
+extern void kmem_cache_set_zone_class(kmem_cache_t *, uint_t);
 extern void kmem_cache_destroy(kmem_cache_t *);
 extern void *kmem_cache_alloc(kmem_cache_t *, int);
 extern void kmem_cache_free(kmem_cache_t *, void *);
@@ -34,6 +34,7 @@
 #include <sys/time.h>
 #include <sys/kstat.h>
 #include <sys/cpuvar.h>
+#include <sys/lgrp.h>
 #include <sys/systm.h>
 #include <vm/page.h>
 #include <sys/avl.h>
@@ -258,7 +259,7 @@ typedef struct kmem_magtype {
 #define	KMEM_CPU_CACHE_SIZE	64	/* must be power of 2 */
 #define	KMEM_CPU_PAD		(KMEM_CPU_CACHE_SIZE - sizeof (kmutex_t) - \
 	2 * sizeof (uint64_t) - 2 * sizeof (void *) - sizeof (int) - \
-	5 * sizeof (short))
+	6 * sizeof (short))
 #define	KMEM_CACHE_SIZE(ncpus)	\
 	((size_t)(&((kmem_cache_t *)0)->cache_cpu[ncpus]))
 
@@ -279,6 +280,7 @@ typedef struct kmem_cpu_cache {
 	short		cc_magsize;	/* number of rounds in a full mag */
 	short		cc_dump_rounds;	/* dump time copy of cc_rounds */
 	short		cc_dump_prounds; /* dump time copy of cc_prounds */
+	short		cc_zclass_tick;	/* zone attribution sample counter */
 	char		cc_pad[KMEM_CPU_PAD]; /* for nice alignment */
 } kmem_cpu_cache_t;
 
@@ -370,7 +372,7 @@ struct kmem_cache {
 	int		cache_cflags;		/* cache creation flags */
 	int		cache_flags;		/* various cache state info */
 	uint32_t	cache_mtbf;		/* induced alloc failure rate */
-	uint32_t	cache_pad1;		/* compiler padding */
+	uint32_t	cache_zclass;		/* zone attribution class */
 	kstat_t		*cache_kstat;		/* exported statistics */
 	list_node_t	cache_link;		/* cache linkage */
 
@@ -400,11 +402,19 @@ struct kmem_cache {
 
 	/*
 	 * Depot layer
+	 *
+	 * Full magazines are kept on per-lgroup lists: a magazine is
+	 * returned to the list of the lgroup whose CPU freed it, and
+	 * refills prefer the executing CPU's home list so that the
+	 * objects handed back are likely to be node-local.  Empty
+	 * magazines carry no object memory, so a single list suffices.
 	 */
 	kmutex_t	cache_depot_lock;	/* protects depot */
 	kmem_magtype_t	*cache_magtype;		/* magazine type */
-	kmem_maglist_t	cache_full;		/* full magazines */
+	kmem_maglist_t	cache_full[NLGRPS_MAX];	/* full magazines, by lgroup */
 	kmem_maglist_t	cache_empty;		/* empty magazines */
+	uint64_t	cache_depot_local;	/* refills from home lgroup */
+	uint64_t	cache_depot_remote;	/* refills from other lgroups */
 	kmem_dump_t	cache_dump;		/* used during crash dump */
 
 	/*
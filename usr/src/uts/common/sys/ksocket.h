@@ -149,6 +149,46 @@ typedef boolean_t (*ksocket_krecv_f)(ksocket_t, struct msgb *, size_t, int,
 extern int	ksocket_krecv_set(ksocket_t, ksocket_krecv_f, void *);
 extern void	ksocket_krecv_unblock(ksocket_t);
 
+/*
+ * Asynchronous (completion based) kernel socket I/O.
+ *
+ * The caller allocates a ksocket_aio_t, fills in kaio_buf, kaio_size,
+ * kaio_flags, kaio_done and (optionally) kaio_arg, and submits it with
+ * ksocket_aio_recv() or ksocket_aio_send(). If the submission returns
+ * zero, the operation will complete exactly once by calling kaio_done
+ * from a worker thread, with kaio_error and kaio_count filled in; the
+ * structure belongs to ksocket until then. A receive completes as soon
+ * as any data (or EOF, with kaio_count of zero) is available; a send
+ * completes when the whole buffer has been queued. Submissions on the
+ * same socket and direction complete in order.
+ *
+ * The completion callback may submit new operations, but must not call
+ * ksocket_close(), as close waits for the completion workers to drain.
+ * When the socket is closed with operations outstanding, they complete
+ * with ECANCELED. MSG_WAITALL and MSG_DONTWAIT are ignored.
+ */
+typedef struct ksocket_aio ksocket_aio_t;
+typedef void (*ksocket_aio_done_f)(ksocket_t, ksocket_aio_t *);
+
+struct ksocket_aio {
+	void			*kaio_buf;	/* caller's buffer */
+	size_t			kaio_size;	/* bytes to transfer */
+	int			kaio_flags;	/* MSG_* flags */
+	ksocket_aio_done_f	kaio_done;	/* completion upcall */
+	void			*kaio_arg;	/* for the caller's use */
+
+	/* Set on completion */
+	size_t			kaio_count;	/* bytes transferred */
+	int			kaio_error;
+
+	/* Private to ksocket */
+	struct ksocket_aio	*kaio_next;
+	struct cred		*kaio_cred;
+};
+
+extern int	ksocket_aio_recv(ksocket_t, ksocket_aio_t *, struct cred *);
+extern int	ksocket_aio_send(ksocket_t, ksocket_aio_t *, struct cred *);
+
 #ifdef	__cplusplus
 }
 #endif
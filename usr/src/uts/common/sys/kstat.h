@@ -50,6 +50,7 @@ typedef int	kid_t;		/* unique kstat id */
 #define	KSTAT_IOC_CHAIN_ID	KSTAT_IOC_BASE | 0x01
 #define	KSTAT_IOC_READ		KSTAT_IOC_BASE | 0x02
 #define	KSTAT_IOC_WRITE		KSTAT_IOC_BASE | 0x03
+#define	KSTAT_IOC_READ_BULK	KSTAT_IOC_BASE | 0x04
 
 /*
  * /dev/kstat ioctl usage (kd denotes /dev/kstat descriptor):
@@ -57,10 +58,33 @@ typedef int	kid_t;		/* unique kstat id */
  *	kcid = ioctl(kd, KSTAT_IOC_CHAIN_ID, NULL);
  *	kcid = ioctl(kd, KSTAT_IOC_READ, kstat_t *);
  *	kcid = ioctl(kd, KSTAT_IOC_WRITE, kstat_t *);
+ *	kcid = ioctl(kd, KSTAT_IOC_READ_BULK, kstat_bulk_t *);
  */
 
 #define	KSTAT_STRLEN	31	/* 30 chars + NULL; must be 16 * n - 1 */
 
+/*
+ * Argument to KSTAT_IOC_READ_BULK, which snapshots every kstat matching
+ * the given module and class (an empty string matches anything) with a
+ * single ioctl.  On success, kb_buf holds kb_count consecutive records,
+ * each a kstat_t header immediately followed by its snapshot data and
+ * padded to KSTAT_BULK_ALIGN; in each header, ks_data holds the user
+ * address of that record's data and kb_bufsize is updated to the number
+ * of bytes used.  If the buffer is too small the ioctl fails with ENOMEM
+ * and kb_bufsize is set to the size required.  Only 64-bit consumers are
+ * supported; 32-bit callers get ENOTSUP and must read kstats one at a
+ * time.
+ */
+typedef struct kstat_bulk {
+	char		kb_module[KSTAT_STRLEN]; /* module to match; ""=any */
+	char		kb_class[KSTAT_STRLEN];	/* class to match; "" = any */
+	uint64_t	kb_buf;		/* pointer to output buffer */
+	uint64_t	kb_bufsize;	/* in: capacity; out: bytes needed */
+	uint64_t	kb_count;	/* out: number of kstats returned */
+} kstat_bulk_t;
+
+#define	KSTAT_BULK_ALIGN	8
+
 /*
  * The generic kstat header
  */
@@ -816,6 +840,7 @@ extern void kstat_zone_remove(kstat_t *, zoneid_t);
 extern int kstat_zone_find(kstat_t *, zoneid_t);
 
 extern kstat_t *kstat_hold_bykid(kid_t kid, zoneid_t);
+extern kstat_t *kstat_hold_next(kid_t kid, zoneid_t);
 extern kstat_t *kstat_hold_byname(const char *, int, const char *, zoneid_t);
 extern void kstat_rele(kstat_t *);
 
@@ -48,6 +48,7 @@ typedef struct lgrp_mem_policy_info { int opaque[2]; }	lgrp_mem_policy_info_t;
 #if defined(_KERNEL) || defined(_FAKE_KERNEL) || defined(_KMEMUSER)
 #include <sys/cpuvar.h>
 #include <sys/bitmap.h>
+#include <sys/bitset.h>
 #include <sys/vnode.h>
 #include <vm/anon.h>
 #include <vm/seg.h>
@@ -166,6 +167,9 @@ typedef enum lgrp_snap_stat_types {
 	LGRP_NUM_PG_INSTALL,	/* # of installed physical pages */
 	LGRP_LOADAVG,		/* unscaled load average of this lgrp */
 	LGRP_LOADAVG_SCALE,	/* load unit of one CPU bound thread */
+	LGRP_LOADAVG_1MIN,	/* 1 minute load average, FSCALE units */
+	LGRP_LOADAVG_5MIN,	/* 5 minute load average, FSCALE units */
+	LGRP_LOADAVG_15MIN,	/* 15 minute load average, FSCALE units */
 	LGRP_NUM_SNAPSHOT_STATS	/* always last */
 } lgrp_snap_stat_t;
 
@@ -195,7 +199,10 @@ static char *lgrp_kstat_names[] = {	\
 	"pages avail",			\
 	"pages installed",		\
 	"load average",			\
-	"loadscale"			\
+	"loadscale",			\
+	"load average 1min",		\
+	"load average 5min",		\
+	"load average 15min"		\
 }
 
 #define	LGRP_NUM_STATS	((int)LGRP_NUM_COUNTER_STATS +			\
@@ -269,6 +276,8 @@ typedef struct lgrp_ld {
 	struct lgrp_ld	**lpl_rset;	/* leaf lpls for lgrp */
 					/* contains ptr to self for leaf lgrp */
 	int		*lpl_id2rset;	/* mapping of lgrpid to rset index */
+	bitset_t	lpl_idleset;	/* idle CPUs (by sequence id); only */
+					/* maintained for leaf lgrps */
 } lpl_t;
 
 /*
@@ -631,6 +640,7 @@ extern pgcnt_t		lgrp_mem_free_thresh;
 extern uint32_t		lgrp_loadavg_tolerance;
 extern uint32_t		lgrp_loadavg_max_effect;
 extern uint32_t		lgrp_load_thresh;
+extern uint64_t		lgrp_hp_avenrun[NLGRPS_MAX][3];
 extern lgrp_mem_policy_t lgrp_mem_policy_root;
 
 #endif	/* _KERNEL || _FAKE_KERNEL || _KMEMUSER */
@@ -276,6 +276,10 @@ struct flow_entry_s {					/* Protected by */
 	void 			*fe_cb_arg1;		/* fe_lock */
 	void			*fe_cb_arg2;		/* fe_lock */
 
+	/* Hardware flow steering state (see MAC_CAPAB_FLOW_STEER) */
+	boolean_t		fe_hwflow;		/* SL */
+	uint64_t		fe_hwflow_cookie;	/* SL */
+
 	void			*fe_client_cookie;	/* WO */
 	void			*fe_rx_ring_group;	/* SL */
 	void			*fe_rx_srs[MAX_RINGS_PER_GROUP]; /* fe_lock */
@@ -323,6 +327,16 @@ struct flow_entry_s {					/* Protected by */
 
 	boolean_t		fe_desc_logged;
 	uint64_t		fe_nic_speed;
+
+	/*
+	 * Rx fanout autoscaling state, maintained by
+	 * mac_fanout_autoscale() under the mac perimeter.
+	 * fe_fanout_boost is the number of soft rings added on top
+	 * of the speed-based count computed by mac_flow_cpu_init().
+	 */
+	uint_t			fe_fanout_boost;
+	uint_t			fe_fanout_idle;
+	uint64_t		fe_fanout_drop_mark;
 };
 
 /*
@@ -774,6 +774,12 @@ extern void mac_link_flow_clean(mac_client_handle_t, flow_entry_t *);
 extern void mac_fanout_recompute_client(mac_client_impl_t *, cpupart_t *);
 extern void mac_fanout_recompute(mac_impl_t *);
 
+/*
+ * Periodic Rx fanout autoscaling based on observed SRS load.
+ */
+extern void mac_fanout_autoscale_start(void);
+extern void mac_fanout_autoscale_stop(void);
+
 /*
  * The following functions are used internally by the MAC layer to
  * add/remove/update flows associated with a mac_impl_t. They should
@@ -111,7 +111,8 @@ typedef enum {
 	MAC_CAPAB_VRRP		= 0x00400000, /* data is mac_capab_vrrp_t */
 	MAC_CAPAB_OVERLAY	= 0x00800000, /* boolean only, no data */
 	MAC_CAPAB_TRANSCEIVER	= 0x01000000, /* mac_capab_transceiver_t */
-	MAC_CAPAB_LED		= 0x02000000  /* data is mac_capab_led_t */
+	MAC_CAPAB_LED		= 0x02000000, /* data is mac_capab_led_t */
+	MAC_CAPAB_FLOW_STEER	= 0x04000000  /* mac_capab_flow_steer_t */
 } mac_capab_t;
 
 /*
@@ -536,6 +537,34 @@ typedef struct mac_capab_led {
 	int		(*mcl_set)(void *, mac_led_mode_t, uint_t);
 } mac_capab_led_t;
 
+/*
+ * Hardware flow steering capability
+ *
+ * A driver implementing this capability exposes its flow director style
+ * filter table.  MAC pushes the flow descriptors of administratively
+ * created flows down to the driver (see mac_flow_add()), so matching
+ * packets arrive pre-sorted on a ring of the driver's choosing.  The
+ * software classifier still confirms every match, and remains the sole
+ * classifier for flows the hardware cannot hold: a failed mfs_insert
+ * (e.g. ENOSPC, ENOTSUP) simply leaves the flow software classified.
+ *
+ * mfs_masks is the set of flow_desc_t fields (FLOW_LINK_*, FLOW_IP_*,
+ * FLOW_ULP_*) the hardware can match on; flows whose mask is not a
+ * subset of it are never offered to the driver.  mfs_insert programs a
+ * filter for the given descriptor and returns a cookie, which is later
+ * passed to mfs_remove when the flow is torn down.  Both entry points
+ * are called with the mac perimeter held and receive the driver handle
+ * as their first argument.
+ */
+typedef struct mac_capab_flow_steer {
+	uint_t		mfs_flags;
+	flow_mask_t	mfs_masks;	/* matchable flow_desc_t fields */
+	uint_t		mfs_nfilters;	/* hardware table capacity */
+	int		(*mfs_insert)(void *, const flow_desc_t *,
+			    uint64_t *);
+	void		(*mfs_remove)(void *, uint64_t);
+} mac_capab_flow_steer_t;
+
 /*
  * MAC registration interface
  */
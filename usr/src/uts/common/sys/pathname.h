@@ -93,6 +93,9 @@ extern int lookuppnat(struct pathname *, struct pathname *, int follow,
 		vnode_t **, vnode_t **, vnode_t *);
 extern int lookuppnatcred(struct pathname *, struct pathname *, int follow,
 		vnode_t **, vnode_t **, vnode_t *, cred_t *);
+extern void pathcache_init(void);
+extern void pathcache_inval(void);
+extern void pathcache_purge(void);
 
 extern int lookuppnvp(struct pathname *, struct pathname *, int follow,
 		vnode_t **, vnode_t **, vnode_t *, vnode_t *, cred_t *);
@@ -61,6 +61,7 @@ extern "C" {
 #define	PORT_GETN	6	/* receive list of objects with events */
 #define	PORT_ALERT	7	/* set port in alert mode */
 #define	PORT_DISPATCH	8	/* dispatch object with events */
+#define	PORT_COALESCE	9	/* configure timed event coalescing */
 
 #define	PORT_SYS_NOPORT		0x100	/* system call without port-id */
 #define	PORT_SYS_NOSHARE	0x200	/* non shareable event */
@@ -112,6 +113,8 @@ typedef struct port_queue {
 	kmutex_t	portq_source_mutex;
 	port_source_t	**portq_scache;
 	port_alert_t	portq_alert;	/* alert event data	*/
+	uint_t		portq_coal_events; /* batching target, 0 = off */
+	uint64_t	portq_coal_slack;  /* max extra wait in nsec */
 } port_queue_t;
 
 /* defines for portq_flags */
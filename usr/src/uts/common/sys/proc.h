@@ -331,6 +331,7 @@ typedef struct	proc {
 	rlim64_t	p_fsz_ctl;	/* currently enforced file size */
 	rlim64_t	p_vmem_ctl;	/* currently enforced addr-space size */
 	rlim64_t	p_fno_ctl;	/* currently enforced file-desc limit */
+	rlim64_t	p_cpu_time_ctl; /* currently enforced CPU time (secs) */
 	pid_t		p_ancpid;	/* ancestor pid, used by exacct */
 	struct itimerval p_realitimer;	/* real interval timer */
 	timeout_id_t	p_itimerid;	/* real interval timer's timeout id */
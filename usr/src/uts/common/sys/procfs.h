@@ -644,6 +644,19 @@ typedef struct prheader {
 	long	pr_entsize;	/* size of each entry, in bytes */
 } prheader_t;
 
+/*
+ * Entry in /proc/psinfo.  The file begins with a prheader_t, followed by
+ * pr_nent entries of pr_entsize bytes each, one per process visible where
+ * /proc was mounted, combining the contents of the process's psinfo and
+ * usage files.  The whole file is a single snapshot; consumers that
+ * periodically sample every process (e.g. prstat(8)) can read it instead
+ * of opening one psinfo and usage file per process per interval.
+ */
+typedef struct prbulkpsinfo {
+	psinfo_t	pr_psinfo;	/* process ps(1) information */
+	prusage_t	pr_usage;	/* process usage information */
+} prbulkpsinfo_t;
+
 /*
  * Macros for manipulating sets of flags.
  * sp must be a pointer to one of sigset_t, fltset_t, or sysset_t.
@@ -979,6 +992,12 @@ typedef struct prheader32 {
 	int32_t	pr_entsize;	/* size of each entry, in bytes */
 } prheader32_t;
 
+/* _ILP32 entry in /proc/psinfo */
+typedef struct prbulkpsinfo32 {
+	psinfo32_t	pr_psinfo;	/* process ps(1) information */
+	prusage32_t	pr_usage;	/* process usage information */
+} prbulkpsinfo32_t;
+
 #endif	/* _SYSCALL32 */
 
 #endif	/* !_KERNEL && _STRUCTURED_PROC == 0 */
@@ -247,6 +247,33 @@ typedef struct sd_unmapstats {
 	kstat_named_t	us_bytes;
 } sd_unmapstats_t;
 
+/*
+ * Log-scale I/O latency histograms, exported as the sd<inst>,lat named
+ * kstat (class "disk_latency").  Bucket b counts buf(9S) completions
+ * whose latency fell in [2^(b-1), 2^b) microseconds, with the first and
+ * last buckets absorbing the tails; each bucket is named for its lower
+ * bound (e.g. "r_us_1024").
+ */
+#define	SD_LAT_BUCKETS	32
+
+typedef struct sd_latstats {
+	kstat_named_t	ls_reads[SD_LAT_BUCKETS];
+	kstat_named_t	ls_writes[SD_LAT_BUCKETS];
+} sd_latstats_t;
+
+/*
+ * Command queue statistics, exported as the sd<inst>,queue named kstat
+ * (class "queue"): a snapshot of the commands currently in transport
+ * and the throttle bounding them, plus counters of how many bufs were
+ * dispatched straight to the HBA versus cycled through the wait queue.
+ */
+typedef struct sd_qstats {
+	kstat_named_t	qs_inflight;	/* cmds in transport now */
+	kstat_named_t	qs_throttle;	/* current throttle limit */
+	kstat_named_t	qs_bypass;	/* bufs that bypassed the waitq */
+	kstat_named_t	qs_enqueue;	/* bufs queued on the waitq */
+} sd_qstats_t;
+
 /*
  * sd_lun: The main data structure for a scsi logical unit.
  * Stored as the softstate structure for each device.
@@ -278,6 +305,10 @@ struct sd_lun {
 	struct buf	*un_waitq_headp;
 	struct buf	*un_waitq_tailp;
 
+	/* Waitq-bypass vs. enqueue dispatch counts (under SD_MUTEX) */
+	uint64_t	un_waitq_bypass;
+	uint64_t	un_waitq_enqueue;
+
 	/* Ptr to the buf currently being retried (NULL if none) */
 	struct buf	*un_retry_bp;
 
@@ -385,6 +416,10 @@ struct sd_lun {
 	struct	kstat	*un_stats;		/* disk statistics */
 	sd_unmapstats_t	*un_unmapstats;		/* UNMAP stats structure */
 	struct	kstat	*un_unmapstats_ks;	/* UNMAP kstat */
+
+	sd_latstats_t	*un_latstats;		/* latency histograms */
+	struct	kstat	*un_latstats_ks;	/* latency kstat */
+	struct	kstat	*un_qstats_ks;		/* queue kstat */
 	kstat_t		*un_errstats;		/* for error statistics */
 	uint64_t	un_exclopen;		/* exclusive open bitmask */
 	ddi_devid_t	un_devid;		/* device id */
@@ -1409,6 +1444,7 @@ struct sd_xbuf {
 	short	xb_victim_retry_count;
 	short	xb_ua_retry_count;	/* unit_attention retry counter */
 	short	xb_nr_retry_count;	/* not ready retry counter */
+	hrtime_t xb_lat_start;		/* gethrtime() at xbuf init */
 
 	/*
 	 * Various status and data used when a RQS command is run on
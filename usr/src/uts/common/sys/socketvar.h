@@ -251,8 +251,20 @@ struct sonode {
 	/* Kernel direct receive callbacks */
 	so_krecv_f		so_krecv_cb;		/* recv callback */
 	void			*so_krecv_arg;		/* recv cb arg */
+
+	/*
+	 * Kernel async I/O (ksocket).  so_kaio_notify is called from the
+	 * so_notify_* functions with so_lock held and must not block.
+	 * Both fields are set together under so_lock.
+	 */
+	void			(*so_kaio_notify)(sonode_t *, int);
+	void			*so_kaio;		/* aio state */
 };
 
+/* Events passed to so_kaio_notify() */
+#define	SO_KAIO_RECV		0x1	/* receive progress possible */
+#define	SO_KAIO_SEND		0x2	/* send progress possible */
+
 #define	SO_HAVE_DATA(so)						\
 	/*								\
 	 * For the (tid == 0) case we must check so_rcv_{q_,}head	\
@@ -617,6 +629,7 @@ struct sendfile_stats {
 	uint32_t ss_full_waits;
 	uint32_t ss_empty_waits;
 	uint32_t ss_file_segmap;
+	uint32_t ss_file_cached_async;
 };
 
 /*
@@ -654,7 +667,8 @@ struct sendfile_queue {
 	int		snfq_req_cnt;		/* Number of requests */
 };
 
-#define	READ_OP			1
+#define	READ_OP			1	/* Read with direct I/O */
+#define	READ_OP_CACHED		2	/* Read through the page cache */
 #define	SNFQ_TIMEOUT		(60 * 5 * hz)	/* 5 minutes */
 
 /* Socket network operations switch */
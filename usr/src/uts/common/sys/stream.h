@@ -408,6 +408,12 @@ typedef	struct	bcache {
 	uint_t			align;
 } bcache_t;
 
+/*
+ * mblk pool descriptor, opaque to consumers (see mbpool_create() in
+ * io/stream.c).
+ */
+typedef struct mbpool mbpool_t;
+
 /*
  * db_flags values (all implementation private!)
  */
@@ -781,6 +787,9 @@ extern mblk_t *esballoc(unsigned char *, size_t, uint_t, frtn_t *);
 extern bcache_t *bcache_create(char *, size_t, uint_t);
 extern void bcache_destroy(bcache_t *);
 extern mblk_t *bcache_allocb(bcache_t *, uint_t);
+extern mbpool_t *mbpool_create(char *, size_t, uint_t, uint_t);
+extern void mbpool_destroy(mbpool_t *);
+extern mblk_t *mbpool_allocb(mbpool_t *);
 extern mblk_t *mkiocb(uint_t);
 extern int testb(size_t, uint_t);
 extern bufcall_id_t bufcall(size_t, uint_t, void (*)(void *), void *);
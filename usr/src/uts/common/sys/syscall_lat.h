@@ -0,0 +1,45 @@
+/*
+ * This file and its contents are supplied under the terms of the
+ * Common Development and Distribution License ("CDDL"), version 1.0.
+ * You may only use this file in accordance with the terms of version
+ * 1.0 of the CDDL.
+ *
+ * A full copy of the text of the CDDL should have accompanied this
+ * source.  A copy of the CDDL is also available via the Internet at
+ * http://www.illumos.org/license/CDDL.
+ */
+
+/*
+ * Copyright 2026 Oxide Computer Company
+ */
+
+#ifndef _SYS_SYSCALL_LAT_H
+#define	_SYS_SYSCALL_LAT_H
+
+/*
+ * Sampled per-syscall latency histograms; see os/syscall_lat.c.
+ */
+
+#include <sys/types.h>
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#ifdef	_KERNEL
+
+#define	SYSCALL_LAT_SHIFT	10	/* first bucket: < 2^10 ns */
+#define	SYSCALL_LAT_BUCKETS	24
+
+extern uint_t syscall_lat_sample;
+
+extern void syscall_lat_init(void);
+extern void syscall_lat_record(uint_t, processorid_t, hrtime_t);
+
+#endif	/* _KERNEL */
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* _SYS_SYSCALL_LAT_H */
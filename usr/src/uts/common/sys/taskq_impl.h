@@ -70,6 +70,7 @@ typedef struct tqstat {
 	uint_t		tqs_tdeaths;	/* threads died		*/
 	uint_t		tqs_maxthreads;	/* max # of alive threads */
 	uint_t		tqs_disptcreates;
+	uint_t		tqs_steals;	/* backing queue tasks stolen */
 } tqstat_t;
 
 /*
@@ -60,6 +60,7 @@ struct turnstile {
 
 #ifdef	_KERNEL
 
+extern void turnstile_init(void);
 extern turnstile_t *turnstile_lookup(void *);
 extern void turnstile_exit(void *);
 extern int turnstile_block(turnstile_t *, int, void *, struct _sobj_ops *,
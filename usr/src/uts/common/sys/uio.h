@@ -251,6 +251,7 @@ int	uioamove(void *, size_t, enum uio_rw, uioa_t *);
 int	uioainit(uio_t *, uioa_t *);
 int	uioafini(uio_t *, uioa_t *);
 extern	uioasync_t uioasync;
+extern	int uioa_swcopy;
 
 #else	/* defined(_KERNEL) */
 
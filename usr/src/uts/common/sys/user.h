@@ -138,6 +138,7 @@ typedef struct uf_info {
 	int		fi_badfd;	/* bad file descriptor # */
 	int		fi_action;	/* action to take on bad fd use */
 	int		fi_nfiles;	/* number of entries in fi_list[] */
+	int		fi_minfd;	/* all fds below this are allocated */
 	uf_entry_t *volatile fi_list;	/* current file list */
 	uf_rlist_t	*fi_rlist;	/* retired file lists */
 } uf_info_t;
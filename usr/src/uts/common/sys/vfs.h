@@ -475,6 +475,7 @@ int	rootconf(void);
 int	domount(char *, struct mounta *, vnode_t *, struct cred *,
 	    struct vfs **);
 int	dounmount(struct vfs *, int, cred_t *);
+extern void (*elf_hdr_cache_purge_hook)(struct vfs *);
 int	vfs_lock(struct vfs *);
 int	vfs_rlock(struct vfs *);
 void	vfs_lock_wait(struct vfs *);
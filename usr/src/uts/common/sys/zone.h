@@ -343,7 +343,15 @@ typedef struct zone_net_data {
 #define	ZONE_USTATE_STIME (0)
 #define	ZONE_USTATE_UTIME (1)
 #define	ZONE_USTATE_WTIME (2)
-#define	ZONE_USTATE_MAX (3)
+
+/*
+ * Run queue wait latency histogram: counts of dispatch waits bucketed
+ * by decade from 10us up to 10s, with the final bucket unbounded.
+ * Maintained by restore_mstate(), exported via the zone_misc kstat.
+ */
+#define	ZONE_USTATE_WHIST (3)
+#define	ZONE_USTATE_WHIST_NBUCKETS (8)
+#define	ZONE_USTATE_MAX (ZONE_USTATE_WHIST + ZONE_USTATE_WHIST_NBUCKETS)
 
 struct pool;
 struct brand;
@@ -408,6 +416,22 @@ typedef struct {
 	kstat_named_t	zm_anon_alloc_fail;
 } zone_mcap_kstat_t;
 
+/*
+ * Kernel memory attribution classes.  Caches tagged with
+ * kmem_cache_set_zone_class() bill each allocation to the allocating
+ * zone's counter for the class, exported via the zone_kmem kstat.
+ */
+#define	ZONE_KMEM_CLASS_CONN	1	/* ip conn_t caches */
+#define	ZONE_KMEM_CLASS_VNODE	2	/* vn_cache */
+#define	ZONE_KMEM_CLASS_ZNODE	3	/* zfs_znode_cache */
+#define	ZONE_KMEM_CLASS_MBLK	4	/* streams_dblk_* caches */
+#define	ZONE_KMEM_NCLASSES	4
+
+typedef struct {
+	kstat_named_t	zm_zonename;
+	kstat_named_t	zm_allocs[ZONE_KMEM_NCLASSES];
+} zone_kmem_kstat_t;
+
 typedef struct {
 	kstat_named_t	zm_zonename;	/* full name, kstat truncates name */
 	kstat_named_t	zm_utime;
@@ -420,9 +444,13 @@ typedef struct {
 	kstat_named_t	zm_ffnoproc;
 	kstat_named_t	zm_ffnomem;
 	kstat_named_t	zm_ffmisc;
+	kstat_named_t	zm_forks;
+	kstat_named_t	zm_exits;
 	kstat_named_t	zm_nested_intp;
 	kstat_named_t	zm_init_pid;
 	kstat_named_t	zm_boot_time;
+	kstat_named_t	zm_hw_util;
+	kstat_named_t	zm_wait_hist[ZONE_USTATE_WHIST_NBUCKETS];
 } zone_misc_kstat_t;
 
 typedef struct zone {
@@ -605,6 +633,10 @@ typedef struct zone {
 	kmutex_t	zone_misc_lock;		/* protects misc statistics */
 	kstat_t		*zone_misc_ksp;
 	zone_misc_kstat_t *zone_misc_stats;
+	/* kernel memory attribution, billed from kmem_cache_alloc() */
+	kstat_t		*zone_kmem_ksp;
+	zone_kmem_kstat_t *zone_kmem_stats;
+	uint64_t	zone_kmem_allocs[ZONE_KMEM_NCLASSES];
 	/* Accumulated microstate for all threads in this zone. */
 	cpu_uarray_t	*zone_ustate;
 	/* fork-fail kstat tracking */
@@ -612,9 +644,19 @@ typedef struct zone {
 	uint32_t	zone_ffnoproc;		/* get proc/lwp error */
 	uint32_t	zone_ffnomem;		/* as_dup/memory error */
 	uint32_t	zone_ffmisc;		/* misc. other error */
+	/* fork/exit rate kstat tracking */
+	uint32_t	zone_forks;		/* successful forks */
+	uint32_t	zone_exits;		/* process exits */
 
 	uint32_t	zone_nested_intp;	/* nested interp. kstat */
 
+	/*
+	 * Hardware utilization events (from the capacity/utilization
+	 * CPC counters) attributed to this zone by statistical sampling;
+	 * see cu_cpu_update_stats() in cap_util.c.
+	 */
+	uint64_t	zone_hw_util;
+
 	struct loadavg_s zone_loadavg;		/* loadavg for this zone */
 	uint64_t	zone_hp_avenrun[3];	/* high-precision avenrun */
 	int		zone_avenrun[3];	/* FSCALED avg. run queue len */
@@ -653,6 +695,7 @@ extern rctl_hndl_t rc_zone_nprocs;
 extern long zone(int, void *, void *, void *, void *);
 extern void zone_zsd_init(void);
 extern void zone_init(void);
+extern void zone_kmem_bill(uint_t, uint64_t);
 extern void zone_hold(zone_t *);
 extern void zone_rele(zone_t *);
 extern void zone_init_ref(zone_ref_t *);
@@ -781,6 +781,12 @@ pollwakeup(pollhead_t *php, short events_arg)
 		struct plist *next;
 		};
 	struct plist *plhead = NULL, *pltail = NULL;
+	struct dlist {
+		pollcache_t *pcp;
+		int	fd;
+		struct dlist *next;
+		};
+	struct dlist *dlhead = NULL;
 
 retry:
 	PH_ENTER(php);
@@ -847,50 +853,40 @@ retry:
 			/*
 			 * Try to grab the lock for this thread. If
 			 * we don't get it then we may deadlock so
-			 * back out and restart all over again. Note
-			 * that the failure rate is very very low.
+			 * defer the notification.
 			 */
 			if (mutex_tryenter(&pcp->pc_lock)) {
 				pollnotify(pcp, pdp->pd_fd);
 				mutex_exit(&pcp->pc_lock);
 			} else {
 				/*
-				 * We are here because:
-				 *	1) This thread has been woke up
-				 *	   and is trying to get out of poll().
-				 *	2) Some other thread is also here
-				 *	   but with a different pollhead lock.
-				 *
-				 * So, we need to drop the lock on pollhead
-				 * because of (1) but we want to prevent
-				 * that thread from doing lwp_exit() or
-				 * devpoll close. We want to ensure that
-				 * the pollcache pointer is still invalid.
-				 *
-				 * Solution: Grab the pcp->pc_no_exit lock,
-				 * increment the pc_busy counter, drop every
-				 * lock in sight. Get out of the way and wait
-				 * for type (2) threads to finish.
+				 * The pollcache lock is held by another
+				 * thread - typically one scanning the cache
+				 * or on its way out of poll(). We must not
+				 * block on it while holding the pollhead
+				 * lock; dropping the pollhead lock to wait
+				 * and then rescanning the whole list (as
+				 * this code used to) made wakeups against
+				 * busy pollcaches quadratic in the number
+				 * of pollers. Instead remember the pollcache
+				 * and fd and deliver the notification after
+				 * the list walk, once the pollhead lock has
+				 * been dropped. The pc_busy reference keeps
+				 * the pollcache from being freed by
+				 * lwp_exit() or devpoll close until then.
 				 */
+				struct dlist *d;
 
 				mutex_enter(&pcp->pc_no_exit);
 				pcp->pc_busy++;	/* prevents exit()'s */
 				mutex_exit(&pcp->pc_no_exit);
 
-				PH_EXIT(php);
-				mutex_enter(&pcp->pc_lock);
-				mutex_exit(&pcp->pc_lock);
-				mutex_enter(&pcp->pc_no_exit);
-				pcp->pc_busy--;
-				if (pcp->pc_busy == 0) {
-					/*
-					 * Wakeup the thread waiting in
-					 * thread_exit().
-					 */
-					cv_signal(&pcp->pc_busy_cv);
-				}
-				mutex_exit(&pcp->pc_no_exit);
-				goto retry;
+				d = kmem_zalloc(sizeof (struct dlist),
+				    KM_SLEEP);
+				d->pcp = pcp;
+				d->fd = pdp->pd_fd;
+				d->next = dlhead;
+				dlhead = d;
 			}
 		}
 	}
@@ -923,6 +919,34 @@ retry:
 		events = plhead->pevents;
 		goto retry;
 	}
+
+	/*
+	 * Deliver the notifications deferred above. No pollhead lock is
+	 * held anymore, so it is safe to block on the pollcache locks.
+	 * The fd is revalidated under the lock since the cached entry may
+	 * have been removed while the notification was pending; in that
+	 * case nobody is interested in the event anymore.
+	 */
+	while (dlhead != NULL) {
+		struct dlist	*d = dlhead;
+		pollcache_t	*pcp = d->pcp;
+
+		dlhead = d->next;
+		mutex_enter(&pcp->pc_lock);
+		if (d->fd < pcp->pc_mapsize &&
+		    pcache_lookup_fd(pcp, d->fd) != NULL)
+			pollnotify(pcp, d->fd);
+		mutex_exit(&pcp->pc_lock);
+
+		mutex_enter(&pcp->pc_no_exit);
+		pcp->pc_busy--;
+		if (pcp->pc_busy == 0) {
+			/* Wakeup the thread waiting in thread_exit(). */
+			cv_signal(&pcp->pc_busy_cv);
+		}
+		mutex_exit(&pcp->pc_no_exit);
+		kmem_free(d, sizeof (struct dlist));
+	}
 }
 
 /*
@@ -71,6 +71,10 @@ extern int sosendfile64(file_t *, file_t *, const struct ksendfilevec64 *,
 		ssize32_t *);
 extern int snf_segmap(file_t *, vnode_t *, u_offset_t, u_offset_t, ssize_t *,
 		boolean_t);
+extern int snf_direct_io(file_t *, file_t *, u_offset_t, u_offset_t, int,
+		ssize_t *);
+extern off64_t sendfile_async_size;
+extern struct sendfile_stats sf_stats;
 extern sotpi_info_t *sotpi_sototpi(struct sonode *);
 
 #define	SEND_MAX_CHUNK	16
@@ -989,6 +993,27 @@ sendvec_chunk(file_t *fp, u_offset_t *fileoff, struct sendfilevec *sfv,
 				continue;
 			}
 
+			if (vp->v_type == VSOCK && sendfile_async_size > 0 &&
+			    sfv_len >= sendfile_async_size) {
+				/*
+				 * Large copy-mode transfer; overlap the
+				 * cached reads with the transmit instead of
+				 * doing them in lock step. The reader thread
+				 * takes the vnode lock itself.
+				 */
+				VOP_RWUNLOCK(readvp, V_WRITELOCK_FALSE, NULL);
+				sf_stats.ss_file_cached_async++;
+				error = snf_direct_io(fp, ffp, sfv_off,
+				    (u_offset_t)sfv_len, READ_OP_CACHED,
+				    (ssize_t *)&cnt);
+				releasef(sfv->sfv_fd);
+				*count += cnt;
+				if (error)
+					return (error);
+				sfv++;
+				continue;
+			}
+
 			while (sfv_len > 0) {
 				size_t	iov_len;
 
@@ -127,6 +127,7 @@ struct as {
 	struct as_callback *a_callbacks; /* callback list */
 	proc_t	*a_proc;	/* back pointer to proc */
 	size_t	a_resvsize;	/* size of reserved part of address space */
+	struct as_claim *a_claims; /* in-flight mapping range claims */
 };
 
 #define	AS_PAGLCK		0x80
@@ -263,6 +264,8 @@ void	as_avlinit(struct as *);
 struct	seg *as_segat(struct as *as, caddr_t addr);
 void	as_rangelock(struct as *as);
 void	as_rangeunlock(struct as *as);
+int	as_rangeclaim(struct as *as, caddr_t addr, size_t size);
+void	as_rangeunclaim(struct as *as, caddr_t addr, size_t size);
 struct	as *as_alloc();
 void	as_free(struct as *as);
 int	as_dup(struct as *as, struct proc *forkedproc);
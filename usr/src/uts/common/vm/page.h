@@ -742,6 +742,7 @@ int	page_chk_freelist(uint_t);
 void	page_list_add(page_t *, int);
 void	page_boot_demote(page_t *);
 void	page_promote_size(page_t *, uint_t);
+void	page_promote_thread(void);
 void	page_list_add_pages(page_t *, int);
 void	page_list_sub(page_t *, int);
 void	page_list_sub_pages(page_t *, uint_t);
@@ -50,6 +50,9 @@
 #include <sys/policy.h>
 #include <sys/project.h>
 #include <sys/zone.h>
+#include <sys/taskq.h>
+#include <sys/cpuvar.h>
+#include <sys/disp.h>
 
 #define	SEGSPTADDR	(caddr_t)0x0
 
@@ -64,6 +67,33 @@ size_t	spt_used;
 pgcnt_t segspt_minfree = 0;
 size_t segspt_minfree_clamp = (1UL << 30); /* 1GB in bytes */
 
+/*
+ * Asynchronous pre-fault support for DISM segments.  Faulting a large DISM
+ * segment in on first touch serializes the faulting threads behind page
+ * allocation, so madvise(MADV_WILLNEED) on a DISM mapping now carves the
+ * advised range into spt_prefault_chunk-sized pieces and populates them
+ * from a taskq instead of doing nothing.  The workers go through
+ * spt_anon_getpages(), so they take the same 128-way partitioned anon
+ * array locks as regular faults and can proceed in parallel on disjoint
+ * ranges; page placement is unchanged since it is governed by the
+ * segment's lgroup memory allocation policy, not by the faulting thread.
+ * A subsequent shmctl(SHM_LOCK) then only needs to lock pages that are
+ * already present.  spt_prefault_nthreads of zero sizes the taskq to half
+ * the online CPUs.
+ */
+size_t	spt_prefault_chunk = 32 * 1024 * 1024;	/* bytes populated per task */
+uint_t	spt_prefault_nthreads = 0;
+static taskq_t *spt_prefault_taskq;
+static kmutex_t spt_prefault_lock;
+
+typedef struct segspt_prefault_args {
+	struct seg	*spa_seg;	/* shm attach segment (held) */
+	caddr_t		spa_addr;	/* sptseg address of chunk */
+	size_t		spa_len;	/* chunk length */
+} segspt_prefault_args_t;
+
+static void segspt_prefault_task(void *arg);
+
 static int segspt_create(struct seg **segpp, void *argsp);
 static int segspt_unmap(struct seg *seg, caddr_t raddr, size_t ssize);
 static void segspt_free(struct seg *seg);
@@ -2379,10 +2409,73 @@ segspt_shmfault(struct hat *hat, struct seg *seg, caddr_t addr,
 	}
 }
 
-/*ARGSUSED*/
+/*
+ * Fault-ahead, called from as_faulta() once per page of the advised range
+ * on madvise(MADV_WILLNEED).  For DISM segments we dispatch one population
+ * task per spt_prefault_chunk of the range; the per-page calls within a
+ * chunk return immediately.  ISM segments are fully populated and locked
+ * at creation time, so there is nothing to fault ahead.
+ */
 static faultcode_t
 segspt_shmfaulta(struct seg *seg, caddr_t addr)
 {
+	struct shm_data	*shmd = (struct shm_data *)seg->s_data;
+	struct seg	*sptseg = shmd->shm_sptseg;
+	struct spt_data	*sptd = sptseg->s_data;
+	segspt_prefault_args_t *spa;
+	size_t		pgsz, chunk, len;
+	u_offset_t	offset;
+
+	ASSERT(seg->s_as && AS_LOCK_HELD(seg->s_as));
+
+	if ((sptd->spt_flags & SHM_PAGEABLE) == 0 || spt_prefault_chunk == 0)
+		return (0);
+
+	pgsz = page_get_pagesize(sptseg->s_szc);
+	chunk = P2ROUNDUP(spt_prefault_chunk, pgsz);
+	offset = (uintptr_t)addr - (uintptr_t)seg->s_base;
+
+	if (P2PHASE(offset, (u_offset_t)chunk) != 0)
+		return (0);
+
+	if (offset >= sptd->spt_realsize)
+		return (0);
+
+	/*
+	 * Only populate whole large pages; anything left over at the end
+	 * of the segment is faulted in on demand as usual.
+	 */
+	len = MIN(chunk, P2ALIGN(sptd->spt_realsize - offset, pgsz));
+	if (len == 0)
+		return (0);
+
+	if (spt_prefault_taskq == NULL) {
+		mutex_enter(&spt_prefault_lock);
+		if (spt_prefault_taskq == NULL) {
+			uint_t nthreads = spt_prefault_nthreads;
+
+			if (nthreads == 0)
+				nthreads = MAX(ncpus_online / 2, 1);
+			spt_prefault_taskq = taskq_create("spt_prefault",
+			    nthreads, minclsyspri, 1, INT_MAX,
+			    TASKQ_PREPOPULATE);
+		}
+		mutex_exit(&spt_prefault_lock);
+	}
+
+	spa = kmem_alloc(sizeof (*spa), KM_SLEEP);
+	spa->spa_seg = seg;
+	spa->spa_addr = sptseg->s_base + (uintptr_t)offset;
+	spa->spa_len = len;
+
+	/*
+	 * Bump shm_softlockcnt to keep the segment from being unmapped
+	 * underneath the worker; it is dropped in segspt_prefault_task().
+	 */
+	atomic_inc_ulong((ulong_t *)(&(shmd->shm_softlockcnt)));
+	(void) taskq_dispatch(spt_prefault_taskq, segspt_prefault_task,
+	    spa, TQ_SLEEP);
+
 	return (0);
 }
 
@@ -2600,6 +2693,47 @@ lpgs_err:
 	return (err);
 }
 
+/*
+ * Taskq worker for DISM fault-ahead: populate one chunk of the segment
+ * and immediately drop the page locks.  Errors are ignored; this is
+ * purely advisory and any page we fail to create here will be created
+ * by the fault that eventually touches it.
+ */
+static void
+segspt_prefault_task(void *arg)
+{
+	segspt_prefault_args_t *spa = arg;
+	struct seg	*seg = spa->spa_seg;
+	struct shm_data	*shmd = (struct shm_data *)seg->s_data;
+	struct seg	*sptseg = shmd->shm_sptseg;
+	struct as	*as = seg->s_as;
+	pgcnt_t		npages = btop(spa->spa_len);
+	page_t		**ppa;
+	pgcnt_t		i;
+
+	ppa = kmem_zalloc(npages * sizeof (page_t *), KM_SLEEP);
+	if (spt_anon_getpages(sptseg, spa->spa_addr, spa->spa_len, ppa) == 0) {
+		for (i = 0; i < npages; i++)
+			page_unlock(ppa[i]);
+	}
+	kmem_free(ppa, npages * sizeof (page_t *));
+	kmem_free(spa, sizeof (*spa));
+
+	/*
+	 * Drop the hold taken in segspt_shmfaulta().  An unmap may be
+	 * blocked waiting for shm_softlockcnt to drain, so do the
+	 * decrement and the wakeup under a_contents; nothing in the
+	 * segment may be referenced once the count is dropped.
+	 */
+	mutex_enter(&as->a_contents);
+	atomic_dec_ulong((ulong_t *)(&(shmd->shm_softlockcnt)));
+	if (shmd->shm_softlockcnt == 0 && AS_ISUNMAPWAIT(as)) {
+		AS_CLRUNMAPWAIT(as);
+		cv_broadcast(&as->a_cv);
+	}
+	mutex_exit(&as->a_contents);
+}
+
 /*
  * count the number of bytes in a set of spt pages that are currently not
  * locked
@@ -1724,6 +1724,19 @@ retry:
 					goto out;
 				}
 			} else {	/* common case */
+				ulong_t aidx = svd->anon_index;
+
+				/*
+				 * If the parent never wrote to this mapping
+				 * there are no anon pages to share copy-on-
+				 * write and no writable anon translations
+				 * to demote, so the per-page walks can be
+				 * skipped entirely.
+				 */
+				if (anon_get_next_ptr(amp->ahp, &aidx) ==
+				    NULL || aidx >= svd->anon_index + npages)
+					goto noanon;
+
 				if (seg->s_szc != 0) {
 					/*
 					 * If at least one of anon slots of a
@@ -1746,6 +1759,7 @@ retry:
 			}
 		}
 	}
+noanon:
 	/*
 	 * If necessary, create a vpage structure for the new segment.
 	 * Do not copy any page lock indications.
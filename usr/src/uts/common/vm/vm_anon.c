@@ -127,6 +127,21 @@ struct vnode *anon_vp;
 
 int anon_debug;
 
+/*
+ * Historically a failed large page allocation in anon_map_createpages()
+ * permanently lowered the page size used for the remainder of the range,
+ * on the theory that further attempts at that size would fail too.  On a
+ * long-running system whose memory has fragmented this turns large page
+ * coverage of big ISM segments into a lottery: a single transient
+ * freelist shortfall demotes everything that follows, even though later
+ * chunks could have been satisfied.  With anon_lpg_nodemote set (the
+ * default) every suitably aligned chunk retries the full segment page
+ * size, bounding the extra cost to one freelist probe per page size per
+ * chunk and making coverage a function of free memory rather than of
+ * allocation order.  Set to 0 to restore the sticky demotion.
+ */
+int anon_lpg_nodemote = 1;
+
 kmutex_t	anoninfo_lock;
 struct		k_anoninfo k_anoninfo;
 ani_free_t	*ani_free_pool;
@@ -1335,40 +1350,76 @@ anon_decref_pages(
  * This code assumes that procedure calling this one has already used
  * hat_chgprot() to disable write access to the range of addresses that
  * that *old actually refers to.
+ *
+ * This is the bulk of the per-page work done at fork() time for dense
+ * anon segments, so rather than paying a full anon array lookup for
+ * every slot we walk the old array a chunk at a time and skip empty
+ * chunks wholesale.
  */
 void
 anon_dup(struct anon_hdr *old, ulong_t old_idx, struct anon_hdr *new,
     ulong_t new_idx, size_t size)
 {
-	spgcnt_t npages;
 	kmutex_t *ahm;
 	struct anon *ap;
-	ulong_t off;
+	struct anon **app;
 	ulong_t index;
+	ulong_t eidx;
+	ulong_t j;
 
-	npages = btopr(size);
-	while (npages > 0) {
-		index = old_idx;
-		if ((ap = anon_get_next_ptr(old, &index)) == NULL)
-			break;
+	index = old_idx;
+	eidx = old_idx + btopr(size);
+	ASSERT(eidx <= old->size);
 
-		ASSERT(!ANON_ISBUSY(anon_get_slot(old, index)));
-		off = index - old_idx;
-		npages -= off;
-		if (npages <= 0)
-			break;
+	if ((old->size <= ANON_CHUNK_SIZE) || (old->flags & ANON_ALLOC_FORCE)) {
+		/*
+		 * 1 level case
+		 */
+		for (; index < eidx; index++) {
+			ap = (struct anon *)
+			    ((uintptr_t)old->array_chunk[index] & ANON_PTRMASK);
+			if (ap == NULL)
+				continue;
 
-		(void) anon_set_ptr(new, new_idx + off, ap, ANON_SLEEP);
-		ahm = AH_MUTEX(ap->an_vp, ap->an_off);
+			ASSERT(!ANON_ISBUSY(anon_get_slot(old, index)));
+			(void) anon_set_ptr(new, new_idx + (index - old_idx),
+			    ap, ANON_SLEEP);
+			ahm = AH_MUTEX(ap->an_vp, ap->an_off);
 
-		mutex_enter(ahm);
-		ap->an_refcnt++;
-		mutex_exit(ahm);
+			mutex_enter(ahm);
+			ap->an_refcnt++;
+			mutex_exit(ahm);
+		}
+	} else {
+		/*
+		 * 2 level case
+		 */
+		while (index < eidx) {
+			app = old->array_chunk[index >> ANON_CHUNK_SHIFT];
+			if (app == NULL) {
+				index = (index + ANON_CHUNK_SIZE) &
+				    ~ANON_CHUNK_OFF;
+				continue;
+			}
+			for (j = index & ANON_CHUNK_OFF;
+			    j < ANON_CHUNK_SIZE && index < eidx; j++, index++) {
+				ap = (struct anon *)
+				    ((uintptr_t)app[j] & ANON_PTRMASK);
+				if (ap == NULL)
+					continue;
 
-		off++;
-		new_idx += off;
-		old_idx += off;
-		npages--;
+				ASSERT(!ANON_ISBUSY(
+				    anon_get_slot(old, index)));
+				(void) anon_set_ptr(new,
+				    new_idx + (index - old_idx), ap,
+				    ANON_SLEEP);
+				ahm = AH_MUTEX(ap->an_vp, ap->an_off);
+
+				mutex_enter(ahm);
+				ap->an_refcnt++;
+				mutex_exit(ahm);
+			}
+		}
 	}
 }
 
@@ -2970,11 +3021,15 @@ anon_map_createpages(
 
 				/*
 				 * If a request for a page of size
-				 * larger than PAGESIZE failed
-				 * then don't try that size anymore.
+				 * larger than PAGESIZE failed then
+				 * don't try that size anymore, unless
+				 * anon_lpg_nodemote says each chunk
+				 * should get its own shot at the full
+				 * segment page size.
 				 */
 				if (pplist == NULL) {
-					l_szc = szc - 1;
+					if (anon_lpg_nodemote == 0)
+						l_szc = szc - 1;
 				} else {
 					break;
 				}
@@ -544,12 +544,39 @@ as_segat(struct as *as, caddr_t addr)
  * prevent two or more threads from allocating the same virtual
  * address range.  The address space must not be "read/write"
  * locked by the caller since we may block.
+ *
+ * A thread that has chosen its range may narrow the whole-address-space
+ * claim down to just that range with as_rangeclaim(), letting other
+ * threads start their own searches while it goes on to build the
+ * mapping.  Claimed ranges are tracked on a_claims, under a_contents;
+ * a whole-address-space claim waits for all range claims to drain
+ * since a new search must not hand out an address inside one.
  */
+struct as_claim {
+	struct as_claim	*ac_next;	/* next claim on this as */
+	caddr_t		ac_base;	/* base of claimed range */
+	size_t		ac_size;	/* size of claimed range */
+};
+
+static int
+as_claim_overlap(struct as *as, caddr_t base, size_t size)
+{
+	struct as_claim *ac;
+
+	ASSERT(MUTEX_HELD(&as->a_contents));
+	for (ac = as->a_claims; ac != NULL; ac = ac->ac_next) {
+		if (base < ac->ac_base + ac->ac_size &&
+		    ac->ac_base < base + size)
+			return (1);
+	}
+	return (0);
+}
+
 void
 as_rangelock(struct as *as)
 {
 	mutex_enter(&as->a_contents);
-	while (AS_ISCLAIMGAP(as))
+	while (AS_ISCLAIMGAP(as) || as->a_claims != NULL)
 		cv_wait(&as->a_cv, &as->a_contents);
 	AS_SETCLAIMGAP(as);
 	mutex_exit(&as->a_contents);
@@ -563,8 +590,67 @@ as_rangeunlock(struct as *as)
 {
 	mutex_enter(&as->a_contents);
 	AS_CLRCLAIMGAP(as);
-	cv_signal(&as->a_cv);
+	cv_broadcast(&as->a_cv);
+	mutex_exit(&as->a_contents);
+}
+
+/*
+ * Narrow a whole-address-space claim taken with as_rangelock() down to
+ * [addr, addr + size), releasing the whole-space claim so that other
+ * threads may search for and claim non-overlapping ranges.  Returns 0,
+ * with the whole-space claim still held, if the chosen range overlaps
+ * a claim taken by another thread whose mapping was not yet entered
+ * when we searched; the caller must then choose its address again.
+ * On success the claim must be released with as_rangeunclaim().
+ */
+int
+as_rangeclaim(struct as *as, caddr_t addr, size_t size)
+{
+	struct as_claim *ac;
+	caddr_t base = (caddr_t)((uintptr_t)addr & (uintptr_t)PAGEMASK);
+	size_t rsize = (((uintptr_t)(addr + size) + PAGEOFFSET) &
+	    (uintptr_t)PAGEMASK) - (uintptr_t)base;
+
+	ac = kmem_alloc(sizeof (*ac), KM_SLEEP);
+	ac->ac_base = base;
+	ac->ac_size = rsize;
+
+	mutex_enter(&as->a_contents);
+	ASSERT(AS_ISCLAIMGAP(as));
+	if (as_claim_overlap(as, base, rsize)) {
+		/*
+		 * Wait for the conflicting claims to change before
+		 * letting the caller search again.
+		 */
+		cv_wait(&as->a_cv, &as->a_contents);
+		mutex_exit(&as->a_contents);
+		kmem_free(ac, sizeof (*ac));
+		return (0);
+	}
+	ac->ac_next = as->a_claims;
+	as->a_claims = ac;
+	AS_CLRCLAIMGAP(as);
+	cv_broadcast(&as->a_cv);
+	mutex_exit(&as->a_contents);
+	return (1);
+}
+
+void
+as_rangeunclaim(struct as *as, caddr_t addr, size_t size)
+{
+	struct as_claim *ac, **prev;
+	caddr_t base = (caddr_t)((uintptr_t)addr & (uintptr_t)PAGEMASK);
+
+	mutex_enter(&as->a_contents);
+	for (prev = &as->a_claims; (ac = *prev) != NULL; prev = &ac->ac_next) {
+		if (ac->ac_base == base)
+			break;
+	}
+	ASSERT(ac != NULL);
+	*prev = ac->ac_next;
+	cv_broadcast(&as->a_cv);
 	mutex_exit(&as->a_contents);
+	kmem_free(ac, sizeof (*ac));
 }
 
 /*
@@ -652,6 +738,7 @@ as_alloc(void)
 	as->a_lastgaphl		= NULL;
 	as->a_callbacks		= NULL;
 	as->a_proc		= NULL;
+	as->a_claims		= NULL;
 
 	AS_LOCK_ENTER(as, RW_WRITER);
 	as->a_hat = hat_alloc(as);	/* create hat for default system mmu */
@@ -1511,6 +1511,14 @@ page_create_throttle(pgcnt_t npages, int flags)
 
 	cv_signal(&proc_pageout->p_cv);
 
+	/*
+	 * Pageout alone may not be able to free enough memory if most
+	 * of it is tied up in kmem caches, so also start the caches'
+	 * reclaim callbacks before we block.  kmem_reap() just queues
+	 * the work to a taskq, so it is safe to call from here.
+	 */
+	kmem_reap();
+
 	for (;;) {
 		fm = 0;
 		pcf_acquire_all();
@@ -64,6 +64,7 @@
 #include <sys/sdt.h>
 #include <sys/dumphdr.h>
 #include <sys/swap.h>
+#include <sys/kstat.h>
 
 extern uint_t	vac_colors;
 
@@ -2260,6 +2261,91 @@ page_demote(int mnode, pfn_t pfnum, pfn_t pfnmax, uchar_t cur_szc,
 
 int mpss_coalesce_disable = 0;
 
+/*
+ * Background large page promotion.  fsflush opportunistically coalesces
+ * free pages as it scans (page_promote_size()), but once memory pressure
+ * has fragmented physmem that trickle can lag demand indefinitely: a
+ * process which loses its large mappings keeps faulting small pages and
+ * never gets the large ones back.  The promotion thread watches for
+ * page_get_freelist() failures at szc > 0 and responds by coalescing the
+ * free lists wholesale, so that the next large page fault (or
+ * memcntl(MC_HAT_ADVISE) request) finds fully assembled frames.
+ * Statistics are exported via the unix::page_promote kstat.
+ */
+int page_promote_daemon_enable = 1;
+int page_promote_interval = 10;		/* seconds between demand checks */
+
+static kmutex_t page_promote_mtx;
+static kcondvar_t page_promote_cv;
+
+static struct page_promote_kstat {
+	kstat_named_t	ppk_lpfails;	/* large page allocation failures */
+	kstat_named_t	ppk_runs;	/* coalesce passes performed */
+} page_promote_kstat = {
+	{ "lp_alloc_fails",	KSTAT_DATA_UINT64 },
+	{ "coalesce_runs",	KSTAT_DATA_UINT64 },
+};
+
+/*
+ * Note a failed freelist allocation at szc > 0; accumulated demand is
+ * what gates the promotion thread's coalesce passes.
+ */
+static void
+page_promote_demand_fail(void)
+{
+	atomic_inc_64(&page_promote_kstat.ppk_lpfails.value.ui64);
+}
+
+/*
+ * Run as a background thread and rebuild free large pages whenever
+ * large page demand has gone unmet since the previous pass.
+ */
+void
+page_promote_thread(void)
+{
+	callb_cpr_t cpr_info;
+	uint64_t lpfails, last_lpfails = 0;
+	kstat_t *ksp;
+
+	ksp = kstat_create("unix", 0, "page_promote", "vm",
+	    KSTAT_TYPE_NAMED,
+	    sizeof (page_promote_kstat) / sizeof (kstat_named_t),
+	    KSTAT_FLAG_VIRTUAL);
+	if (ksp != NULL) {
+		ksp->ks_data = &page_promote_kstat;
+		kstat_install(ksp);
+	}
+
+	CALLB_CPR_INIT(&cpr_info, &page_promote_mtx, callb_generic_cpr,
+	    "page_promote");
+
+	mutex_enter(&page_promote_mtx);
+	for (;;) {
+		CALLB_CPR_SAFE_BEGIN(&cpr_info);
+		(void) cv_reltimedwait(&page_promote_cv, &page_promote_mtx,
+		    page_promote_interval * hz, TR_CLOCK_TICK);
+		CALLB_CPR_SAFE_END(&cpr_info, &page_promote_mtx);
+
+		if (page_promote_daemon_enable == 0 || mpss_coalesce_disable)
+			continue;
+
+		/*
+		 * Only burn cycles walking the page counters when large
+		 * page demand has actually gone unmet since our last pass.
+		 */
+		lpfails = page_promote_kstat.ppk_lpfails.value.ui64;
+		if (lpfails == last_lpfails)
+			continue;
+		last_lpfails = lpfails;
+		mutex_exit(&page_promote_mtx);
+
+		page_freelist_coalesce_all(-1);
+		page_promote_kstat.ppk_runs.value.ui64++;
+
+		mutex_enter(&page_promote_mtx);
+	}
+}
+
 /*
  * Coalesce free pages into a page of the given szc and color if possible.
  * Return the pointer to the page created, otherwise, return NULL.
@@ -3671,6 +3757,53 @@ page_chk_freelist(uint_t szc)
 }
 #endif
 
+/*
+ * When a thread's home lgroup runs dry and allocation falls back to
+ * remote freelists, visit the remote memory nodes at each level of the
+ * lgroup hierarchy in order of decreasing free page count rather than at
+ * a random starting offset, so that a drained node refills
+ * proportionally from its best-stocked peers instead of repeatedly
+ * draining whichever node the traversal happens to visit first.  Nodes
+ * at nearer hierarchy levels are still preferred over more distant ones.
+ * Clear this to restore the old traversal order.
+ */
+int pg_steal_proportional = 1;
+
+/*
+ * Drain the given mnode cookie into 'mnodes', keeping the hierarchy
+ * levels in the order the cookie yields them but sorting the mnodes
+ * within each level by free page count, fullest first (or leaving them
+ * in cookie order if pg_steal_proportional is clear).  Returns the
+ * number of mnodes collected.  The counts are unlocked snapshots; they
+ * only guide the search order, so staleness is harmless.
+ */
+static int
+page_get_steal_order(lgrp_mnode_cookie_t *cookie, int *mnodes)
+{
+	pgcnt_t	cnt[MAX_MEM_NODES];
+	lgrp_t	*level_lgrp = NULL;
+	int	nmnodes = 0;
+	int	base = 0;
+	int	mnode, i;
+
+	while ((mnode = lgrp_memnode_choose(cookie)) >= 0) {
+		pgcnt_t pgs = pg_steal_proportional ? MNODE_PGCNT(mnode) : 0;
+
+		if (cookie->lmc_lgrp != level_lgrp) {
+			level_lgrp = cookie->lmc_lgrp;
+			base = nmnodes;
+		}
+		for (i = nmnodes; i > base && cnt[i - 1] < pgs; i--) {
+			mnodes[i] = mnodes[i - 1];
+			cnt[i] = cnt[i - 1];
+		}
+		mnodes[i] = mnode;
+		cnt[i] = pgs;
+		nmnodes++;
+	}
+	return (nmnodes);
+}
+
 /*
  * Find the `best' page on the freelist for this (vp,off) (as,vaddr) pair.
  *
@@ -3775,11 +3908,17 @@ pgretry:
 	lgrp_stat_add(lgrp->lgrp_id, LGRP_NUM_ALLOC_FAIL, 1);
 
 	if (!(flags & PG_LOCAL)) {
+		int	mnodes[MAX_MEM_NODES];
+		int	nmnodes, i;
+
 		/*
-		 * Try to get a non-local freelist page.
+		 * Try to get a non-local freelist page, stealing from the
+		 * best-stocked mnode at each level of the hierarchy first.
 		 */
 		LGRP_MNODE_COOKIE_UPGRADE(lgrp_cookie);
-		while ((mnode = lgrp_memnode_choose(&lgrp_cookie)) >= 0) {
+		nmnodes = page_get_steal_order(&lgrp_cookie, mnodes);
+		for (i = 0; i < nmnodes; i++) {
+			mnode = mnodes[i];
 			pp = page_get_func(mnode, bin, mtype, szc, flags);
 			if (pp != NULL) {
 				DTRACE_PROBE4(page__get,
@@ -3816,6 +3955,8 @@ pgretry:
 		SETPGCPFAILCNT(szc);
 
 	VM_STAT_ADD(vmm_vmstats.pgf_allocfailed[szc]);
+	if (szc > 0)
+		page_promote_demand_fail();
 	return (NULL);
 }
 
@@ -350,6 +350,7 @@ apix_init()
 	do_interrupt_common = apix_do_interrupt;
 	addintr = apix_add_avintr;
 	remintr = apix_rem_avintr;
+	getintrstat = apix_intr_stats;
 	get_pending_spl = apix_get_pending_spl;
 	get_intr_handler = apix_get_intr_handler;
 	psm_get_localapicid = apic_get_localapicid;
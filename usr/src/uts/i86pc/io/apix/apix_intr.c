@@ -195,6 +195,7 @@ apix_dispatch_pending_autovect(uint_t ipl)
 		caddr_t arg2 = av->av_intarg2;
 		dev_info_t *dip = av->av_dip;
 		uchar_t vector = av->av_flags & AV_PENTRY_VECTMASK;
+		hrtime_t t0 = 0;
 
 		if (intr == NULL)
 			continue;
@@ -203,11 +204,18 @@ apix_dispatch_pending_autovect(uint_t ipl)
 		if (ipl != XC_HI_PIL)
 			sti();
 
+		if (av_autotune_enable)
+			t0 = gethrtime_unscaled();
 		DTRACE_PROBE4(interrupt__start, dev_info_t *, dip,
 		    void *, intr, caddr_t, arg1, caddr_t, arg2);
 		r = (*intr)(arg1, arg2);
 		DTRACE_PROBE4(interrupt__complete, dev_info_t *, dip,
 		    void *, intr, caddr_t, arg1, uint_t, r);
+		if (av_autotune_enable) {
+			atomic_inc_64(&av->av_dispatches);
+			atomic_add_64(&av->av_cycles,
+			    (uint64_t)(gethrtime_unscaled() - t0));
+		}
 
 		if (av->av_ticksp && av->av_prilevel <= LOCK_LEVEL)
 			atomic_add_64(av->av_ticksp, intr_get_time());
@@ -842,6 +850,7 @@ apix_dispatch_by_vector(uint_t vector)
 	uint_t r, (*intr)();
 	caddr_t arg1, arg2;
 	dev_info_t *dip;
+	hrtime_t t0 = 0;
 
 	if (vecp == NULL ||
 	    (avp = vecp->v_autovect) == NULL || avp->av_vector == NULL)
@@ -856,11 +865,18 @@ apix_dispatch_by_vector(uint_t vector)
 	if (avp->av_prilevel != XC_HI_PIL)
 		sti();
 
+	if (av_autotune_enable)
+		t0 = gethrtime_unscaled();
 	DTRACE_PROBE4(interrupt__start, dev_info_t *, dip,
 	    void *, intr, caddr_t, arg1, caddr_t, arg2);
 	r = (*intr)(arg1, arg2);
 	DTRACE_PROBE4(interrupt__complete, dev_info_t *, dip,
 	    void *, intr, caddr_t, arg1, uint_t, r);
+	if (av_autotune_enable) {
+		atomic_inc_64(&avp->av_dispatches);
+		atomic_add_64(&avp->av_cycles,
+		    (uint64_t)(gethrtime_unscaled() - t0));
+	}
 
 	cli();
 	avp->av_flags &= ~AV_PENTRY_ONPROC;
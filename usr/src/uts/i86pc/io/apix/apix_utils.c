@@ -968,6 +968,45 @@ apix_find_vector_by_avintr(void *intr_id, avfunc f)
 	return (NULL);
 }
 
+/*
+ * Sum the auto-tune dispatch and service-time totals of every handler
+ * installed for the given device, across all CPUs' vector tables.
+ * Installed as the getintrstat hook so the common auto-tune framework
+ * can find apix-managed handlers; the walk is lock-free, so a rebind
+ * racing with a sample can make it slightly off, which the framework
+ * tolerates.
+ */
+void
+apix_intr_stats(dev_info_t *dip, uint64_t *dispatchesp, uint64_t *cyclesp)
+{
+	apix_vector_t *vecp;
+	struct autovec *avp;
+	processorid_t n;
+	int v;
+
+	*dispatchesp = 0;
+	*cyclesp = 0;
+	for (n = 0; n < apic_nproc; n++) {
+		if (!apix_is_cpu_enabled(n))
+			continue;
+
+		for (v = APIX_AVINTR_MIN; v <= APIX_AVINTR_MAX; v++) {
+			vecp = xv_vector(n, v);
+			if (vecp == NULL ||
+			    vecp->v_state <= APIX_STATE_OBSOLETED)
+				continue;
+
+			for (avp = vecp->v_autovect; avp != NULL;
+			    avp = avp->av_link) {
+				if (avp->av_dip != dip)
+					continue;
+				*dispatchesp += avp->av_dispatches;
+				*cyclesp += avp->av_cycles;
+			}
+		}
+	}
+}
+
 /*
  * Add interrupt service routine.
  *
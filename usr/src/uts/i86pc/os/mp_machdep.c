@@ -128,6 +128,7 @@ int (*get_pending_spl)(void)	= (int (*)(void))return_instr;
 int (*addintr)(void *, int, avfunc, char *, int, caddr_t, caddr_t,
     uint64_t *, dev_info_t *) = NULL;
 void (*remintr)(void *, int, avfunc, int) = NULL;
+void (*getintrstat)(dev_info_t *, uint64_t *, uint64_t *) = NULL;
 void (*kdisetsoftint)(int, struct av_softinfo *)=
 	(void (*)(int, struct av_softinfo *))return_instr;
 void (*setsoftint)(int, struct av_softinfo *)=
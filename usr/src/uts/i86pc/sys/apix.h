@@ -303,6 +303,8 @@ extern int apix_add_avintr(void *intr_id, int ipl, avfunc xxintr, char *name,
     int vector, caddr_t arg1, caddr_t arg2, uint64_t *ticksp, dev_info_t *dip);
 extern void apix_rem_avintr(void *intr_id, int ipl, avfunc xxintr,
     int virt_vect);
+extern void apix_intr_stats(dev_info_t *dip, uint64_t *dispatchesp,
+    uint64_t *cyclesp);
 
 extern uint32_t apix_bind_cpu_locked(dev_info_t *dip);
 extern apix_vector_t *apix_rebind(apix_vector_t *vecp, processorid_t tocpu,
@@ -89,6 +89,9 @@ extern int (*addintr)(void *, int, avfunc, char *, int, caddr_t, caddr_t,
     uint64_t *, dev_info_t *);	/* replacement of add_avintr */
 extern void (*remintr)(void *, int, avfunc, int); /* replace of rem_avintr */
 
+/* sum a device's autovec intr stats; NULL means walk autovect[] */
+extern void (*getintrstat)(dev_info_t *, uint64_t *, uint64_t *);
+
 /* trigger a software intr */
 extern void (*setsoftint)(int, struct av_softinfo *);
 
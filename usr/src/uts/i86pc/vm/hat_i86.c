@@ -2431,15 +2431,20 @@ hat_unlock_region(struct hat *hat, caddr_t addr, size_t len,
 
 #if !defined(__xpv)
 /*
- * Cross call service routine to demap a range of virtual
+ * Cross call service routine to demap ranges of virtual
  * pages on the current CPU or flush all mappings in TLB.
+ *
+ * A single cross call may carry a batch of ranges (a2 points at an
+ * array of a3 ranges) so that a caller invalidating several
+ * discontiguous ranges pays for only one round of cross call traffic.
  */
 static int
 hati_demap_func(xc_arg_t a1, xc_arg_t a2, xc_arg_t a3)
 {
-	_NOTE(ARGUNUSED(a3));
 	hat_t		*hat = (hat_t *)a1;
 	tlb_range_t	*range = (tlb_range_t *)a2;
+	uint_t		cnt = (uint_t)a3;
+	uint_t		i;
 
 	/*
 	 * If the target hat isn't the kernel and this CPU isn't operating
@@ -2448,22 +2453,26 @@ hati_demap_func(xc_arg_t a1, xc_arg_t a2, xc_arg_t a3)
 	if (hat != kas.a_hat && hat != CPU->cpu_current_hat)
 		return (0);
 
-	if (range->tr_va != DEMAP_ALL_ADDR) {
-		mmu_flush_tlb(FLUSH_TLB_RANGE, range);
-		return (0);
-	}
+	for (i = 0; i < cnt; i++) {
+		if (range[i].tr_va != DEMAP_ALL_ADDR) {
+			mmu_flush_tlb(FLUSH_TLB_RANGE, &range[i]);
+			continue;
+		}
 
-	/*
-	 * We are flushing all of userspace.
-	 *
-	 * When using PCP, we first need to update this CPU's idea of the PCP
-	 * PTEs.
-	 */
-	if (hat->hat_flags & HAT_COPIED) {
-		hat_pcp_update(CPU, hat);
-	}
+		/*
+		 * We are flushing all of userspace, which covers any
+		 * remaining ranges as well.
+		 *
+		 * When using PCP, we first need to update this CPU's idea
+		 * of the PCP PTEs.
+		 */
+		if (hat->hat_flags & HAT_COPIED) {
+			hat_pcp_update(CPU, hat);
+		}
 
-	mmu_flush_tlb(FLUSH_TLB_NONGLOBAL, NULL);
+		mmu_flush_tlb(FLUSH_TLB_NONGLOBAL, NULL);
+		break;
+	}
 	return (0);
 }
 
@@ -2514,22 +2523,35 @@ tlb_service(void)
 #endif /* !__xpv */
 
 /*
- * Internal routine to do cross calls to invalidate a range of pages on
- * all CPUs using a given hat.
+ * Maximum number of ranges accumulated before a TLB shootdown is issued.
+ * This bounds both the on-stack range array in hat_unload_callback() and
+ * the size of a cross call batch in hat_tlb_inval_ranges().
+ */
+#define	MAX_UNLOAD_CNT (8)
+
+/*
+ * Internal routine to do cross calls to invalidate ranges of pages on
+ * all CPUs using a given hat. The ranges are batched into a single
+ * cross call, so callers with several discontiguous ranges to flush
+ * (hat_unload_callback() in particular) only interrupt the other CPUs
+ * once.
  */
 void
-hat_tlb_inval_range(hat_t *hat, tlb_range_t *in_range)
+hat_tlb_inval_ranges(hat_t *hat, tlb_range_t *in_range, uint_t cnt)
 {
 	extern int	flushes_require_xcalls;	/* from mp_startup.c */
 	cpuset_t	justme;
 	cpuset_t	cpus_to_shootdown;
-	tlb_range_t	range = *in_range;
+	tlb_range_t	range[MAX_UNLOAD_CNT];
+	uint_t		r;
 #ifndef __xpv
 	cpuset_t	check_cpus;
 	cpu_t		*cpup;
 	int		c;
 #endif
 
+	ASSERT(cnt >= 1 && cnt <= MAX_UNLOAD_CNT);
+
 	/*
 	 * If the hat is being destroyed, there are no more users, so
 	 * demap need not do anything.
@@ -2537,6 +2559,9 @@ hat_tlb_inval_range(hat_t *hat, tlb_range_t *in_range)
 	if (hat->hat_flags & HAT_FREEING)
 		return;
 
+	for (r = 0; r < cnt; r++)
+		range[r] = in_range[r];
+
 	/*
 	 * If demapping from a shared pagetable, we best demap the
 	 * entire set of user TLBs, since we don't know what addresses
@@ -2544,7 +2569,8 @@ hat_tlb_inval_range(hat_t *hat, tlb_range_t *in_range)
 	 */
 	if (hat->hat_flags & HAT_SHARED) {
 		hat = kas.a_hat;
-		range.tr_va = DEMAP_ALL_ADDR;
+		range[0].tr_va = DEMAP_ALL_ADDR;
+		cnt = 1;
 	}
 
 	/*
@@ -2552,16 +2578,19 @@ hat_tlb_inval_range(hat_t *hat, tlb_range_t *in_range)
 	 */
 	if (panicstr || !flushes_require_xcalls) {
 #ifdef __xpv
-		if (range.tr_va == DEMAP_ALL_ADDR) {
-			xen_flush_tlb();
-		} else {
-			for (size_t i = 0; i < TLB_RANGE_LEN(&range);
+		for (r = 0; r < cnt; r++) {
+			if (range[r].tr_va == DEMAP_ALL_ADDR) {
+				xen_flush_tlb();
+				break;
+			}
+			for (size_t i = 0; i < TLB_RANGE_LEN(&range[r]);
 			    i += MMU_PAGESIZE) {
-				xen_flush_va((caddr_t)(range.tr_va + i));
+				xen_flush_va((caddr_t)(range[r].tr_va + i));
 			}
 		}
 #else
-		(void) hati_demap_func((xc_arg_t)hat, (xc_arg_t)&range, 0);
+		(void) hati_demap_func((xc_arg_t)hat, (xc_arg_t)range,
+		    (xc_arg_t)cnt);
 #endif
 		return;
 	}
@@ -2612,33 +2641,40 @@ hat_tlb_inval_range(hat_t *hat, tlb_range_t *in_range)
 	    CPUSET_ISEQUAL(cpus_to_shootdown, justme)) {
 
 #ifdef __xpv
-		if (range.tr_va == DEMAP_ALL_ADDR) {
-			xen_flush_tlb();
-		} else {
-			for (size_t i = 0; i < TLB_RANGE_LEN(&range);
+		for (r = 0; r < cnt; r++) {
+			if (range[r].tr_va == DEMAP_ALL_ADDR) {
+				xen_flush_tlb();
+				break;
+			}
+			for (size_t i = 0; i < TLB_RANGE_LEN(&range[r]);
 			    i += MMU_PAGESIZE) {
-				xen_flush_va((caddr_t)(range.tr_va + i));
+				xen_flush_va((caddr_t)(range[r].tr_va + i));
 			}
 		}
 #else
-		(void) hati_demap_func((xc_arg_t)hat, (xc_arg_t)&range, 0);
+		(void) hati_demap_func((xc_arg_t)hat, (xc_arg_t)range,
+		    (xc_arg_t)cnt);
 #endif
 
 	} else {
 
 		CPUSET_ADD(cpus_to_shootdown, CPU->cpu_id);
 #ifdef __xpv
-		if (range.tr_va == DEMAP_ALL_ADDR) {
-			xen_gflush_tlb(cpus_to_shootdown);
-		} else {
-			for (size_t i = 0; i < TLB_RANGE_LEN(&range);
+		for (r = 0; r < cnt; r++) {
+			if (range[r].tr_va == DEMAP_ALL_ADDR) {
+				xen_gflush_tlb(cpus_to_shootdown);
+				break;
+			}
+			for (size_t i = 0; i < TLB_RANGE_LEN(&range[r]);
 			    i += MMU_PAGESIZE) {
-				xen_gflush_va((caddr_t)(range.tr_va + i),
+				xen_gflush_va((caddr_t)(range[r].tr_va + i),
 				    cpus_to_shootdown);
 			}
 		}
 #else
-		xc_call((xc_arg_t)hat, (xc_arg_t)&range, 0,
+		HATSTAT_INC(hs_tlb_shootdowns);
+		HATSTAT_ADD(hs_tlb_shootdown_ranges, cnt);
+		xc_call((xc_arg_t)hat, (xc_arg_t)range, (xc_arg_t)cnt,
 		    CPUSET2BV(cpus_to_shootdown), hati_demap_func);
 #endif
 
@@ -2646,6 +2682,12 @@ hat_tlb_inval_range(hat_t *hat, tlb_range_t *in_range)
 	kpreempt_enable();
 }
 
+void
+hat_tlb_inval_range(hat_t *hat, tlb_range_t *in_range)
+{
+	hat_tlb_inval_ranges(hat, in_range, 1);
+}
+
 void
 hat_tlb_inval(hat_t *hat, uintptr_t va)
 {
@@ -2825,14 +2867,16 @@ hat_unload(hat_t *hat, caddr_t addr, size_t len, uint_t flags)
 
 /*
  * Invalidate the TLB, and perform the callback to the upper level VM system,
- * for the specified ranges of contiguous pages.
+ * for the specified ranges of contiguous pages. All the ranges are flushed
+ * with a single batched shootdown rather than one cross call apiece.
  */
 static void
 handle_ranges(hat_t *hat, hat_callback_t *cb, uint_t cnt, tlb_range_t *range)
 {
+	hat_tlb_inval_ranges(hat, range, cnt);
+
 	while (cnt > 0) {
 		--cnt;
-		hat_tlb_inval_range(hat, &range[cnt]);
 
 		if (cb != NULL) {
 			cb->hcb_start_addr = (caddr_t)range[cnt].tr_va;
@@ -2854,7 +2898,6 @@ handle_ranges(hat_t *hat, hat_callback_t *cb, uint_t cnt, tlb_range_t *range)
  * define	HAT_UNLOAD_OTHER	0x08 - not used
  * define	HAT_UNLOAD_UNMAP	0x10 - same as HAT_UNLOAD
  */
-#define	MAX_UNLOAD_CNT (8)
 void
 hat_unload_callback(
 	hat_t		*hat,
@@ -2923,9 +2966,9 @@ hat_unload_callback(
 		 * Unload one mapping (for a single page) from the page tables.
 		 * Note that we do not remove the mapping from the TLB yet,
 		 * as indicated by the tlb=FALSE argument to hat_pte_unmap().
-		 * handle_ranges() will clear the TLB entries with one call to
-		 * hat_tlb_inval_range() per contiguous range.  This is
-		 * safe because the page can not be reused until the
+		 * handle_ranges() will clear the TLB entries with a single
+		 * batched shootdown covering all the contiguous ranges.
+		 * This is safe because the page can not be reused until the
 		 * callback is made (or we return).
 		 */
 		entry = htable_va2entry(vaddr, ht);
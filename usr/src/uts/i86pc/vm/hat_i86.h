@@ -171,6 +171,8 @@ struct hatstats {
 	ulong_t	hs_hm_steals;
 	ulong_t	hs_hm_steal_exam;
 	ulong_t hs_tlb_inval_delayed;
+	ulong_t hs_tlb_shootdowns;	/* cross call TLB shootdowns sent */
+	ulong_t hs_tlb_shootdown_ranges; /* ranges carried by shootdowns */
 	ulong_t hs_hat_copied64;
 	ulong_t hs_hat_copied32;
 	ulong_t hs_hat_normal64;
@@ -178,8 +180,10 @@ struct hatstats {
 extern struct hatstats hatstat;
 #ifdef DEBUG
 #define	HATSTAT_INC(x)	(++hatstat.x)
+#define	HATSTAT_ADD(x, cnt)	(hatstat.x += (cnt))
 #else
 #define	HATSTAT_INC(x)	(0)
+#define	HATSTAT_ADD(x, cnt)	(0)
 #endif
 
 #if defined(_KERNEL)
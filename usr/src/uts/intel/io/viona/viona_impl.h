@@ -89,6 +89,8 @@ typedef struct viona_vring {
 	uint16_t	vr_state_flags;
 	uint_t		vr_xfer_outstanding;
 	kthread_t	*vr_worker_thread;
+	processorid_t	vr_worker_cpuid;	/* requested affinity or -1 */
+	boolean_t	vr_worker_bound;	/* current worker is bound */
 	vmm_lease_t	*vr_lease;
 
 	/* ring-sized resources for TX activity */
@@ -112,7 +114,7 @@ typedef struct viona_vring {
 	void		**vr_map_pages;
 	vmm_page_t	*vr_map_hold;
 
-	/* Per-ring error condition statistics */
+	/* Per-ring error condition and activity statistics */
 	struct viona_ring_stats {
 		uint64_t	rs_ndesc_too_high;
 		uint64_t	rs_bad_idx;
@@ -137,6 +139,10 @@ typedef struct viona_vring {
 		uint64_t	rs_too_short;
 		uint64_t	rs_tx_absent;
 
+		/* TX packets copied out of the ring vs. loaned from it */
+		uint64_t	rs_tx_copied;
+		uint64_t	rs_tx_loaned;
+
 		uint64_t	rs_rx_hookdrop;
 		uint64_t	rs_tx_hookdrop;
 	} vr_stats;
@@ -301,6 +307,7 @@ int viona_ring_init(viona_link_t *, uint16_t, const struct viona_ring_params *);
 boolean_t viona_ring_lease_renew(viona_vring_t *);
 bool vring_need_bail(const viona_vring_t *);
 int viona_ring_pause(viona_vring_t *);
+int viona_ring_set_affinity(viona_link_t *, uint16_t, processorid_t);
 
 int vq_popchain(viona_vring_t *, struct iovec *, uint_t, uint16_t *,
     vmm_page_t **);
@@ -300,6 +300,7 @@ static int viona_ioc_ring_reset(viona_link_t *, uint_t);
 static int viona_ioc_ring_kick(viona_link_t *, uint_t);
 static int viona_ioc_ring_pause(viona_link_t *, uint_t);
 static int viona_ioc_ring_set_msi(viona_link_t *, void *, int);
+static int viona_ioc_ring_set_affinity(viona_link_t *, void *, int);
 static int viona_ioc_ring_intr_clear(viona_link_t *, uint_t);
 static int viona_ioc_intr_poll(viona_link_t *, void *, int, int *);
 
@@ -601,6 +602,9 @@ viona_ioctl(dev_t dev, int cmd, intptr_t data, int md, cred_t *cr, int *rv)
 	case VNA_IOC_RING_PAUSE:
 		err = viona_ioc_ring_pause(link, (uint_t)data);
 		break;
+	case VNA_IOC_RING_SET_AFFINITY:
+		err = viona_ioc_ring_set_affinity(link, dptr, md);
+		break;
 
 	case VNA_IOC_INTR_POLL:
 		err = viona_ioc_intr_poll(link, dptr, md, rv);
@@ -1017,6 +1021,19 @@ viona_ioc_ring_set_msi(viona_link_t *link, void *data, int md)
 	return (0);
 }
 
+static int
+viona_ioc_ring_set_affinity(viona_link_t *link, void *data, int md)
+{
+	vioc_ring_affinity_t vra;
+
+	if (ddi_copyin(data, &vra, sizeof (vra), md) != 0) {
+		return (EFAULT);
+	}
+
+	return (viona_ring_set_affinity(link, vra.ra_index,
+	    (processorid_t)vra.ra_cpuid));
+}
+
 static int
 viona_notify_iop(void *arg, bool in, uint16_t port, uint8_t bytes,
     uint32_t *val)
@@ -40,6 +40,7 @@
 
 
 #include <sys/disp.h>
+#include <sys/cpuvar.h>
 
 #include "viona_impl.h"
 
@@ -98,6 +99,7 @@ typedef struct vq_held_region vq_held_region_t;
 static boolean_t viona_ring_map(viona_vring_t *);
 static void viona_ring_unmap(viona_vring_t *);
 static kthread_t *viona_create_worker(viona_vring_t *);
+static void viona_ring_worker_rebind(viona_vring_t *);
 
 static vmm_page_t *
 vq_page_hold(viona_vring_t *ring, uint64_t gpa, bool writable)
@@ -256,6 +258,8 @@ void
 viona_ring_alloc(viona_link_t *link, viona_vring_t *ring)
 {
 	ring->vr_link = link;
+	ring->vr_worker_cpuid = -1;
+	ring->vr_worker_bound = B_FALSE;
 	mutex_init(&ring->vr_lock, NULL, MUTEX_DRIVER, NULL);
 	cv_init(&ring->vr_cv, NULL, CV_DRIVER, NULL);
 	mutex_init(&ring->vr_a_mutex, NULL, MUTEX_DRIVER, NULL);
@@ -347,6 +351,9 @@ viona_ring_init(viona_link_t *link, uint16_t idx,
 	ring->vr_state = VRS_SETUP;
 	cv_broadcast(&ring->vr_cv);
 	mutex_exit(&ring->vr_lock);
+
+	/* Apply any affinity configured before this (re)init of the ring */
+	viona_ring_worker_rebind(ring);
 	return (0);
 
 fail:
@@ -634,6 +641,84 @@ viona_ring_pause(viona_vring_t *ring)
 	/* NOTREACHED */
 }
 
+/*
+ * Configure (or clear, with a cpuid of -1) CPU affinity for the worker
+ * thread of a ring.  The request is recorded on the ring so it survives
+ * worker teardown: a worker created by a later ring (re)init is bound to
+ * the same CPU.  Binding follows the same approach mac(9E) takes for its
+ * soft ring workers; note that a bound worker will prevent its CPU from
+ * being offlined until the binding is cleared or the ring is reset.
+ */
+int
+viona_ring_set_affinity(viona_link_t *link, uint16_t idx, processorid_t cpuid)
+{
+	viona_vring_t *ring;
+	int err = 0;
+
+	if (idx >= VIONA_VQ_MAX) {
+		return (EINVAL);
+	}
+
+	ring = &link->l_vrings[idx];
+	mutex_enter(&cpu_lock);
+	mutex_enter(&ring->vr_lock);
+
+	if (cpuid == -1) {
+		if (ring->vr_worker_bound) {
+			thread_affinity_clear(ring->vr_worker_thread);
+			ring->vr_worker_bound = B_FALSE;
+		}
+		ring->vr_worker_cpuid = -1;
+	} else {
+		const cpu_t *cp = cpu_get(cpuid);
+
+		if (cp == NULL || !cpu_is_online(cp)) {
+			err = EINVAL;
+		} else {
+			if (ring->vr_worker_bound) {
+				thread_affinity_clear(ring->vr_worker_thread);
+				ring->vr_worker_bound = B_FALSE;
+			}
+			ring->vr_worker_cpuid = cpuid;
+			if (ring->vr_worker_thread != NULL) {
+				thread_affinity_set(ring->vr_worker_thread,
+				    cpuid);
+				ring->vr_worker_bound = B_TRUE;
+			}
+		}
+	}
+
+	mutex_exit(&ring->vr_lock);
+	mutex_exit(&cpu_lock);
+	return (err);
+}
+
+/*
+ * Apply any recorded worker affinity to a freshly created worker thread.
+ * The CPU may have gone offline since the affinity was configured, in
+ * which case the worker is simply left unbound.
+ */
+static void
+viona_ring_worker_rebind(viona_vring_t *ring)
+{
+	mutex_enter(&cpu_lock);
+	mutex_enter(&ring->vr_lock);
+
+	if (ring->vr_worker_thread != NULL && !ring->vr_worker_bound &&
+	    ring->vr_worker_cpuid != -1) {
+		const cpu_t *cp = cpu_get(ring->vr_worker_cpuid);
+
+		if (cp != NULL && cpu_is_online(cp)) {
+			thread_affinity_set(ring->vr_worker_thread,
+			    ring->vr_worker_cpuid);
+			ring->vr_worker_bound = B_TRUE;
+		}
+	}
+
+	mutex_exit(&ring->vr_lock);
+	mutex_exit(&cpu_lock);
+}
+
 static void
 viona_worker(void *arg)
 {
@@ -718,6 +803,7 @@ ring_reset:
 	ring->vr_state = VRS_RESET;
 	ring->vr_state_flags = 0;
 	ring->vr_worker_thread = NULL;
+	ring->vr_worker_bound = B_FALSE;	/* affinity dies with worker */
 	cv_broadcast(&ring->vr_cv);
 	mutex_exit(&ring->vr_lock);
 
@@ -73,7 +73,22 @@ struct viona_desb {
 	vmm_page_t		*d_pages;
 };
 
-static void viona_tx(viona_link_t *, viona_vring_t *);
+#define	TX_BURST_THRESH	32
+
+/*
+ * Completions for packets which were copied out of the ring (along with
+ * dropped packets) are accumulated by the TX worker and posted to the 'used'
+ * ring in batches, saving doorbell and interrupt traffic.  Packets which loan
+ * guest buffers to the networking stack cannot be batched this way: they are
+ * completed asynchronously from viona_desb_release() when the stack frees the
+ * referencing mblks.
+ */
+typedef struct viona_tx_used {
+	uint_t		vtu_count;
+	used_elem_t	vtu_elem[TX_BURST_THRESH];
+} viona_tx_used_t;
+
+static void viona_tx(viona_link_t *, viona_vring_t *, viona_tx_used_t *);
 static void viona_desb_release(viona_desb_t *);
 
 
@@ -179,16 +194,44 @@ viona_tx_done(viona_vring_t *ring, uint32_t len, uint16_t cookie)
 	viona_intr_ring(ring, B_FALSE);
 }
 
-#define	TX_BURST_THRESH	32
+static void
+viona_tx_used_flush(viona_vring_t *ring, viona_tx_used_t *vtu)
+{
+	if (vtu->vtu_count == 0) {
+		return;
+	}
+
+	vq_pushchain_many(ring, vtu->vtu_count, vtu->vtu_elem);
+	vtu->vtu_count = 0;
+
+	membar_enter();
+	viona_intr_ring(ring, B_FALSE);
+}
+
+static void
+viona_tx_used_add(viona_vring_t *ring, viona_tx_used_t *vtu, uint32_t len,
+    uint16_t cookie)
+{
+	vtu->vtu_elem[vtu->vtu_count].id = cookie;
+	vtu->vtu_elem[vtu->vtu_count].len = len;
+	vtu->vtu_count++;
+
+	if (vtu->vtu_count == TX_BURST_THRESH) {
+		viona_tx_used_flush(ring, vtu);
+	}
+}
 
 void
 viona_worker_tx(viona_vring_t *ring, viona_link_t *link)
 {
+	viona_tx_used_t vtu;
+
 	(void) thread_vsetname(curthread, "viona_tx_%p", ring);
 
 	ASSERT(MUTEX_HELD(&ring->vr_lock));
 	ASSERT3U(ring->vr_state, ==, VRS_RUN);
 
+	vtu.vtu_count = 0;
 	mutex_exit(&ring->vr_lock);
 
 	for (;;) {
@@ -196,7 +239,7 @@ viona_worker_tx(viona_vring_t *ring, viona_link_t *link)
 
 		viona_ring_disable_notify(ring);
 		while (viona_ring_num_avail(ring) != 0) {
-			viona_tx(link, ring);
+			viona_tx(link, ring, &vtu);
 			ntx++;
 			burst++;
 
@@ -217,6 +260,9 @@ viona_worker_tx(viona_vring_t *ring, viona_link_t *link)
 			}
 		}
 
+		/* Post any accumulated copy-path completions as one batch */
+		viona_tx_used_flush(ring, &vtu);
+
 		VIONA_PROBE2(tx, viona_link_t *, link, uint_t, ntx);
 
 		/*
@@ -492,7 +538,7 @@ viona_tx_csum(viona_vring_t *ring, const struct virtio_net_hdr *hdr,
 }
 
 static void
-viona_tx(viona_link_t *link, viona_vring_t *ring)
+viona_tx(viona_link_t *link, viona_vring_t *ring, viona_tx_used_t *vtu)
 {
 	struct iovec		*iov = ring->vr_txiov;
 	const uint_t		max_segs = ring->vr_size;
@@ -695,6 +741,7 @@ viona_tx(viona_link_t *link, viona_vring_t *ring)
 		mutex_enter(&ring->vr_lock);
 		ring->vr_xfer_outstanding++;
 		mutex_exit(&ring->vr_lock);
+		VIONA_RING_STAT_INCR(ring, tx_loaned);
 	} else {
 		/*
 		 * If the data was cloned out of the ring, the descriptors can
@@ -702,7 +749,8 @@ viona_tx(viona_link_t *link, viona_vring_t *ring)
 		 * until after successful packet transmission.
 		 */
 		vmm_drv_page_release_chain(pages);
-		viona_tx_done(ring, len, cookie);
+		viona_tx_used_add(ring, vtu, len, cookie);
+		VIONA_RING_STAT_INCR(ring, tx_copied);
 	}
 
 	/*
@@ -759,5 +807,5 @@ drop_hook:
 	VIONA_PROBE3(tx_drop, viona_vring_t *, ring, uint32_t, len,
 	    uint16_t, cookie);
 	vmm_drv_page_release_chain(pages);
-	viona_tx_done(ring, len, cookie);
+	viona_tx_used_add(ring, vtu, len, cookie);
 }
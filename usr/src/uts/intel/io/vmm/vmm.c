@@ -981,6 +981,23 @@ vm_munmap_memseg(struct vm *vm, vm_paddr_t gpa, size_t len)
 	return (EINVAL);
 }
 
+/*
+ * Make a GPA range resident in the nested page tables ahead of guest access,
+ * sparing the guest the demand faults it would otherwise take on first touch.
+ * The range must lie within a single established memory mapping.
+ */
+int
+vm_populate_memseg(struct vm *vm, vm_paddr_t gpa, size_t len)
+{
+	if (((gpa | len) & PAGE_MASK) != 0 || len == 0 || (gpa + len) < gpa)
+		return (EINVAL);
+
+	if (vmspace_populate(vm->vmspace, gpa, gpa + len) != 0)
+		return (EFAULT);
+
+	return (0);
+}
+
 int
 vm_mmap_getnext(struct vm *vm, vm_paddr_t *gpa, int *segid,
     vm_ooffset_t *segoff, size_t *len, int *prot, int *flags)
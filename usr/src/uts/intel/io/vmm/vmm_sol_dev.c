@@ -504,6 +504,7 @@ vmmdev_do_ioctl(vmm_softc_t *sc, int cmd, intptr_t arg, int md,
 	case VM_PPTDEV_DISABLE_MSIX:
 	case VM_DEVMEM_GETOFFSET:
 	case VM_TRACK_DIRTY_PAGES:
+	case VM_POPULATE_MEMSEG:
 		vmm_read_lock(sc);
 		lock_type = LOCK_READ_HOLD;
 		break;
@@ -1002,6 +1003,16 @@ vmmdev_do_ioctl(vmm_softc_t *sc, int cmd, intptr_t arg, int md,
 		error = vm_munmap_memseg(sc->vmm_vm, mu.gpa, mu.len);
 		break;
 	}
+	case VM_POPULATE_MEMSEG: {
+		struct vm_populate vp;
+
+		if (ddi_copyin(datap, &vp, sizeof (vp), md)) {
+			error = EFAULT;
+			break;
+		}
+		error = vm_populate_memseg(sc->vmm_vm, vp.gpa, vp.len);
+		break;
+	}
 	case VM_ALLOC_MEMSEG: {
 		struct vm_memseg vmseg;
 
@@ -207,6 +207,16 @@ struct vm_page {
 	int		vmp_prot;
 };
 
+/*
+ * Size (in pages) of the naturally-aligned run mapped into the guest page
+ * tables when a fault is taken against an unpopulated page.  Mapping ahead of
+ * the faulting page cuts down on the number of faults incurred by a guest
+ * touching its memory for the first time, since a linear scan faults only
+ * once per run.  Expected to be a power of two; capped at 512 pages (2MB).
+ * A value of 0 or 1 disables the behavior.
+ */
+uint_t vmspace_fault_ahead_pages = 16;
+
 static vmspace_mapping_t *vm_mapping_find(vmspace_t *, uintptr_t, size_t);
 static void vmspace_hold_enter(vmspace_t *);
 static void vmspace_hold_exit(vmspace_t *, bool);
@@ -716,9 +726,55 @@ vmspace_unmap(vmspace_t *vms, uintptr_t start, uintptr_t end)
 	return (0);
 }
 
+/*
+ * Map the remainder of the naturally-aligned run of pages surrounding a
+ * faulting `gpa`, clamped to the containing mapping.  Concurrent faulters are
+ * harmless: vmm_gpt_map() atomically installs each leaf entry and reports
+ * whether this caller was the one to do so.
+ */
+static void
+vmspace_fault_ahead(vmspace_t *vms, vmspace_mapping_t *vmsm, uintptr_t gpa)
+{
+	vmm_gpt_t *gpt = vms->vms_gpt;
+	vm_object_t *vmo = vmsm->vmsm_object;
+	const uintptr_t seg_end = vmsm->vmsm_addr + vmsm->vmsm_len;
+	uint_t pages = vmspace_fault_ahead_pages;
+	size_t mapped = 0;
+
+	if (pages <= 1) {
+		return;
+	}
+	if (!ISP2(pages)) {
+		pages = 1U << (highbit(pages) - 1);
+	}
+	pages = MIN(pages, 512);
+
+	const size_t run = (size_t)pages * PAGESIZE;
+	const uintptr_t start = MAX(P2ALIGN(gpa, run), vmsm->vmsm_addr);
+	const uintptr_t end = MIN(P2ALIGN(gpa, run) + run, seg_end);
+
+	for (uintptr_t pos = start; pos < end; pos += PAGESIZE) {
+		if (pos == gpa) {
+			/* The faulting page itself was already mapped */
+			continue;
+		}
+
+		const pfn_t pfn = vm_object_pfn(vmo, VMSM_OFFSET(vmsm, pos));
+		VERIFY(pfn != PFN_INVALID);
+
+		if (vmm_gpt_map(gpt, pos, pfn, vmsm->vmsm_prot,
+		    vmo->vmo_attr)) {
+			mapped++;
+		}
+	}
+	if (mapped != 0) {
+		atomic_add_64(&vms->vms_pages_mapped, mapped);
+	}
+}
+
 static int
-vmspace_lookup_map(vmspace_t *vms, uintptr_t gpa, int req_prot, pfn_t *pfnp,
-    uint64_t **ptepp)
+vmspace_lookup_map(vmspace_t *vms, uintptr_t gpa, int req_prot,
+    bool fault_ahead, pfn_t *pfnp, uint64_t **ptepp)
 {
 	vmm_gpt_t *gpt = vms->vms_gpt;
 	uint64_t *entries[MAX_GPT_LEVEL], *leaf;
@@ -763,6 +819,10 @@ vmspace_lookup_map(vmspace_t *vms, uintptr_t gpa, int req_prot, pfn_t *pfnp,
 		    vmo->vmo_attr)) {
 			atomic_inc_64(&vms->vms_pages_mapped);
 		}
+
+		if (fault_ahead) {
+			vmspace_fault_ahead(vms, vmsm, gpa);
+		}
 	}
 
 	ASSERT(pfn != PFN_INVALID && leaf != NULL);
@@ -1128,7 +1188,7 @@ vmc_hold(vm_client_t *vmc, uintptr_t gpa, int prot)
 		return (NULL);
 	}
 
-	if (vmspace_lookup_map(vms, gpa, prot, &pfn, &ptep) != 0) {
+	if (vmspace_lookup_map(vms, gpa, prot, false, &pfn, &ptep) != 0) {
 		vmc_deactivate(vmc);
 		kmem_free(vmp, sizeof (*vmp));
 		return (NULL);
@@ -1156,7 +1216,8 @@ vmc_fault(vm_client_t *vmc, uintptr_t gpa, int prot)
 
 	err = vmc_activate(vmc);
 	if (err == 0) {
-		err = vmspace_lookup_map(vms, gpa & PAGEMASK, prot, NULL, NULL);
+		err = vmspace_lookup_map(vms, gpa & PAGEMASK, prot, true,
+		    NULL, NULL);
 		vmc_deactivate(vmc);
 	}
 
@@ -31,6 +31,7 @@
 #define	VNA_IOC_RING_SET_STATE	(VNA_IOC | 0x15)
 #define	VNA_IOC_RING_GET_STATE	(VNA_IOC | 0x16)
 #define	VNA_IOC_RING_PAUSE	(VNA_IOC | 0x17)
+#define	VNA_IOC_RING_SET_AFFINITY	(VNA_IOC | 0x18)
 
 #define	VNA_IOC_INTR_POLL	(VNA_IOC | 0x20)
 #define	VNA_IOC_SET_FEATURES	(VNA_IOC | 0x21)
@@ -52,7 +53,7 @@
  * change when the version is modified.  It follows no rules like semver.
  *
  */
-#define	VIONA_CURRENT_INTERFACE_VERSION	1
+#define	VIONA_CURRENT_INTERFACE_VERSION	2
 
 typedef struct vioc_create {
 	datalink_id_t	c_linkid;
@@ -79,6 +80,17 @@ typedef struct vioc_ring_msi {
 	uint64_t	rm_msg;
 } vioc_ring_msi_t;
 
+/*
+ * Affinitize the worker thread of a ring to a specific host CPU, so the
+ * device model can place ring processing near the vCPU it services.  An
+ * ra_cpuid of -1 clears any existing affinity.
+ */
+typedef struct vioc_ring_affinity {
+	uint16_t	ra_index;
+	uint16_t	ra_pad;
+	int32_t		ra_cpuid;
+} vioc_ring_affinity_t;
+
 enum viona_vq_id {
 	VIONA_VQ_RX = 0,
 	VIONA_VQ_TX = 1,
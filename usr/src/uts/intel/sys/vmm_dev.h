@@ -77,6 +77,11 @@ struct vm_munmap {
 	size_t		len;
 };
 
+struct vm_populate {
+	vm_paddr_t	gpa;
+	size_t		len;
+};
+
 #define	VM_MEMSEG_NAME(m)	((m)->name[0] != '\0' ? (m)->name : NULL)
 struct vm_memseg {
 	int		segid;
@@ -402,7 +407,7 @@ struct vm_legacy_cpuid {
  * best-effort activity.  Nothing is to be inferred about the magnitude of a
  * change when the version is modified.  It follows no rules like semver.
  */
-#define	VMM_CURRENT_INTERFACE_VERSION	8
+#define	VMM_CURRENT_INTERFACE_VERSION	9
 
 
 #define	VMMCTL_IOC_BASE		(('V' << 16) | ('M' << 8))
@@ -520,6 +525,8 @@ struct vm_legacy_cpuid {
 #define	VM_DESTROY_SELF			(VMM_IOC_BASE | 0x25)
 #define	VM_DESTROY_PENDING		(VMM_IOC_BASE | 0x26)
 
+#define	VM_POPULATE_MEMSEG		(VMM_IOC_BASE | 0x27)
+
 #define	VM_DEVMEM_GETOFFSET		(VMM_IOC_BASE | 0xff)
 
 #define	VMM_CTL_DEV		"/dev/vmmctl"